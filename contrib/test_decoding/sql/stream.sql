@@ -0,0 +1,48 @@
+-- logical_decoding_work_mem is 64kB in logical.conf, so that the transactions below are streamed
+CREATE TABLE stream_test(id int, data text);
+SELECT 'init' FROM pg_create_logical_replication_slot('regression_slot', 'test_decoding');
+-- a transaction over the budget is streamed in blocks before its commit
+BEGIN;
+INSERT INTO stream_test SELECT i, repeat('a', 1000) FROM generate_series(1, 200) i;
+COMMIT;
+SELECT sum(CASE WHEN data LIKE 'streaming change%' OR data LIKE 'table %' THEN 1 ELSE 0 END) AS changes,
+    sum(CASE WHEN data LIKE 'opening a streamed block%' THEN 1 ELSE 0 END) > 0 AS streamed,
+    sum(CASE WHEN data LIKE 'committing streamed transaction%' THEN 1 ELSE 0 END) AS stream_commits,
+    sum(CASE WHEN data LIKE 'aborting streamed%' THEN 1 ELSE 0 END) AS stream_aborts,
+    sum(CASE WHEN data = 'COMMIT' THEN 1 ELSE 0 END) AS commits
+FROM pg_logical_slot_get_changes('regression_slot', NULL, NULL, 'include-xids', '0', 'skip-empty-xacts', '1', 'stream-changes', '1');
+-- without stream-changes the same transaction is spilled to disk and decoded at commit
+BEGIN;
+INSERT INTO stream_test SELECT i, repeat('b', 1000) FROM generate_series(1, 200) i;
+COMMIT;
+SELECT sum(CASE WHEN data LIKE 'streaming change%' OR data LIKE 'table %' THEN 1 ELSE 0 END) AS changes,
+    sum(CASE WHEN data LIKE 'opening a streamed block%' THEN 1 ELSE 0 END) > 0 AS streamed,
+    sum(CASE WHEN data = 'COMMIT' THEN 1 ELSE 0 END) AS commits
+FROM pg_logical_slot_get_changes('regression_slot', NULL, NULL, 'include-xids', '0', 'skip-empty-xacts', '1');
+-- the subtransaction goes over the budget before any assignment record ties it to
+-- its parent, so it is streamed as a transaction of its own and committed with it
+BEGIN;
+INSERT INTO stream_test VALUES (0, 'parent');
+SAVEPOINT s1;
+INSERT INTO stream_test SELECT i, repeat('c', 1000) FROM generate_series(1, 200) i;
+RELEASE SAVEPOINT s1;
+COMMIT;
+SELECT sum(CASE WHEN data LIKE 'streaming change%' OR data LIKE 'table %' THEN 1 ELSE 0 END) AS changes,
+    sum(CASE WHEN data LIKE 'opening a streamed block%' THEN 1 ELSE 0 END) > 0 AS streamed,
+    sum(CASE WHEN data LIKE 'committing streamed transaction%' THEN 1 ELSE 0 END) AS stream_commits,
+    sum(CASE WHEN data LIKE 'aborting streamed%' THEN 1 ELSE 0 END) AS stream_aborts,
+    sum(CASE WHEN data = 'COMMIT' THEN 1 ELSE 0 END) AS commits
+FROM pg_logical_slot_get_changes('regression_slot', NULL, NULL, 'include-xids', '0', 'skip-empty-xacts', '1', 'stream-changes', '1');
+-- an aborted streamed transaction only tells the plugin to discard what it was sent
+BEGIN;
+INSERT INTO stream_test SELECT i, repeat('d', 1000) FROM generate_series(1, 200) i;
+ROLLBACK;
+SELECT sum(CASE WHEN data LIKE 'streaming change%' THEN 1 ELSE 0 END) > 0 AS streamed_changes,
+    sum(CASE WHEN data LIKE 'table %' THEN 1 ELSE 0 END) AS changes,
+    sum(CASE WHEN data LIKE 'committing streamed transaction%' THEN 1 ELSE 0 END) AS stream_commits,
+    sum(CASE WHEN data LIKE 'aborting streamed%' THEN 1 ELSE 0 END) AS stream_aborts,
+    sum(CASE WHEN data = 'COMMIT' THEN 1 ELSE 0 END) AS commits
+FROM pg_logical_slot_get_changes('regression_slot', NULL, NULL, 'include-xids', '0', 'skip-empty-xacts', '1', 'stream-changes', '1');
+SELECT count(*) FROM stream_test;
+DROP TABLE stream_test;
+SELECT 'stop' FROM pg_drop_replication_slot('regression_slot');
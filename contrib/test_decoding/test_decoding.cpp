@@ -43,6 +43,7 @@ typedef struct {
     bool skip_empty_xacts;
     bool xact_wrote_changes;
     bool only_local;
+    bool stream_changes;
 } TestDecodingData;
 
 static void pg_decode_startup(LogicalDecodingContext* ctx, OutputPluginOptions* opt, bool is_init);
@@ -54,6 +55,12 @@ static void pg_decode_commit_txn(LogicalDecodingContext* ctx, ReorderBufferTXN*
 static void pg_decode_change(
     LogicalDecodingContext* ctx, ReorderBufferTXN* txn, Relation rel, ReorderBufferChange* change);
 static bool pg_decode_filter(LogicalDecodingContext* ctx, RepOriginId origin_id);
+static void pg_decode_stream_start(LogicalDecodingContext* ctx, ReorderBufferTXN* txn);
+static void pg_decode_stream_stop(LogicalDecodingContext* ctx, ReorderBufferTXN* txn);
+static void pg_decode_stream_abort(LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr abort_lsn);
+static void pg_decode_stream_commit(LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
+static void pg_decode_stream_change(
+    LogicalDecodingContext* ctx, ReorderBufferTXN* txn, Relation relation, ReorderBufferChange* change);
 
 void _PG_init(void)
 {
@@ -71,6 +78,11 @@ void _PG_output_plugin_init(OutputPluginCallbacks* cb)
     cb->commit_cb = pg_decode_commit_txn;
     cb->filter_by_origin_cb = pg_decode_filter;
     cb->shutdown_cb = pg_decode_shutdown;
+    cb->stream_start_cb = pg_decode_stream_start;
+    cb->stream_stop_cb = pg_decode_stream_stop;
+    cb->stream_abort_cb = pg_decode_stream_abort;
+    cb->stream_commit_cb = pg_decode_stream_commit;
+    cb->stream_change_cb = pg_decode_stream_change;
 }
 
 /* initialize this plugin */
@@ -89,6 +101,7 @@ static void pg_decode_startup(LogicalDecodingContext* ctx, OutputPluginOptions*
     data->include_timestamp = false;
     data->skip_empty_xacts = false;
     data->only_local = true;
+    data->stream_changes = false;
 
     ctx->output_plugin_private = data;
 
@@ -142,6 +155,14 @@ static void pg_decode_startup(LogicalDecodingContext* ctx, OutputPluginOptions*
                 ereport(ERROR,
                     (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
                         errmsg("could not parse value \"%s\" for parameter \"%s\"", strVal(elem->arg), elem->defname)));
+        } else if (strcmp(elem->defname, "stream-changes") == 0) {
+
+            if (elem->arg == NULL)
+                data->stream_changes = true;
+            else if (!parse_bool(strVal(elem->arg), &data->stream_changes))
+                ereport(ERROR,
+                    (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                        errmsg("could not parse value \"%s\" for parameter \"%s\"", strVal(elem->arg), elem->defname)));
         } else {
             ereport(ERROR,
                 (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
@@ -149,6 +170,9 @@ static void pg_decode_startup(LogicalDecodingContext* ctx, OutputPluginOptions*
                         "option \"%s\" = \"%s\" is unknown", elem->defname, elem->arg ? strVal(elem->arg) : "(null)")));
         }
     }
+
+    /* in-progress transactions are streamed only when asked for */
+    ctx->streaming = ctx->streaming && data->stream_changes;
 }
 
 /* cleanup this plugin's resources */
@@ -212,6 +236,79 @@ static bool pg_decode_filter(LogicalDecodingContext* ctx, RepOriginId origin_id)
     return false;
 }
 
+/* STREAM START callback */
+static void pg_decode_stream_start(LogicalDecodingContext* ctx, ReorderBufferTXN* txn)
+{
+    TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
+
+    OutputPluginPrepareWrite(ctx, true);
+    if (data->include_xids)
+        appendStringInfo(ctx->out, "opening a streamed block for transaction TXN %lu", txn->xid);
+    else
+        appendStringInfoString(ctx->out, "opening a streamed block for transaction");
+    OutputPluginWrite(ctx, true);
+}
+
+/* STREAM STOP callback */
+static void pg_decode_stream_stop(LogicalDecodingContext* ctx, ReorderBufferTXN* txn)
+{
+    TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
+
+    OutputPluginPrepareWrite(ctx, true);
+    if (data->include_xids)
+        appendStringInfo(ctx->out, "closing a streamed block for transaction TXN %lu", txn->xid);
+    else
+        appendStringInfoString(ctx->out, "closing a streamed block for transaction");
+    OutputPluginWrite(ctx, true);
+}
+
+/* STREAM ABORT callback */
+static void pg_decode_stream_abort(LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr abort_lsn)
+{
+    TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
+
+    OutputPluginPrepareWrite(ctx, true);
+    if (data->include_xids)
+        appendStringInfo(ctx->out, "aborting streamed (sub)transaction TXN %lu", txn->xid);
+    else
+        appendStringInfoString(ctx->out, "aborting streamed (sub)transaction");
+    OutputPluginWrite(ctx, true);
+}
+
+/* STREAM COMMIT callback */
+static void pg_decode_stream_commit(LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr commit_lsn)
+{
+    TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
+
+    OutputPluginPrepareWrite(ctx, true);
+    if (data->include_xids)
+        appendStringInfo(ctx->out, "committing streamed transaction TXN %lu", txn->xid);
+    else
+        appendStringInfoString(ctx->out, "committing streamed transaction");
+
+    if (data->include_timestamp)
+        appendStringInfo(ctx->out, " (at %s)", timestamptz_to_str(txn->commit_time));
+
+    OutputPluginWrite(ctx, true);
+}
+
+/*
+ * STREAM CHANGE callback. The contents of the change are not printed, as
+ * where a transaction is streamed depends on logical_decoding_work_mem.
+ */
+static void pg_decode_stream_change(
+    LogicalDecodingContext* ctx, ReorderBufferTXN* txn, Relation relation, ReorderBufferChange* change)
+{
+    TestDecodingData* data = (TestDecodingData*)ctx->output_plugin_private;
+
+    OutputPluginPrepareWrite(ctx, true);
+    if (data->include_xids)
+        appendStringInfo(ctx->out, "streaming change for TXN %lu", txn->xid);
+    else
+        appendStringInfoString(ctx->out, "streaming change for transaction");
+    OutputPluginWrite(ctx, true);
+}
+
 /*
  * Print literal `outputstr' already represented as string of type `typid'
  * into stringbuf `s'.
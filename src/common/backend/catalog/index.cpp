@@ -54,6 +54,7 @@
 #include "nodes/nodeFuncs.h"
 #include "optimizer/cost.h"
 #include "optimizer/clauses.h"
+#include "optimizer/planner.h"
 #include "optimizer/var.h"
 #include "parser/parser.h"
 #include "storage/bufmgr.h"
@@ -2550,6 +2551,21 @@ void index_build(Relation heapRelation, Partition heapPartition, Relation indexR
     hasbucket = (partitionType == INDEX_CREATE_NONE_PARTITION && RELATION_CREATE_BUCKET(heapRelation)) ||
                 (partitionType != INDEX_CREATE_NONE_PARTITION && RELATION_OWN_BUCKETKEY(heapRelation));
 
+    /*
+     * Determine worker thread details for parallel CREATE INDEX.  Currently,
+     * only btree has support for parallel builds, and only on a plain row
+     * table: partitions, hash-bucket tables and system catalogs are built
+     * serially.
+     *
+     * Note that planner considers parallel safety for us.
+     */
+    if (partitionType == INDEX_CREATE_NONE_PARTITION && !hasbucket && IsNormalProcessingMode() &&
+        !IsInParallelMode() && indexRelation->rd_rel->relam == BTREE_AM_OID && RelationIsRowFormat(heapRelation) &&
+        !IsSystemRelation(heapRelation)) {
+        indexInfo->ii_ParallelWorkers =
+            plan_create_index_workers(RelationGetRelid(heapRelation), RelationGetRelid(indexRelation));
+    }
+
     IndexBuildResult* stats = NULL;
     if (hasbucket) {
         stats = index_build_storage_for_bucket(heapRelation,
@@ -2703,13 +2719,17 @@ void index_build(Relation heapRelation, Partition heapPartition, Relation indexR
  * any RECENTLY_DEAD or DELETE_IN_PROGRESS entries in a HOT chain, without
  * trying very hard to detect whether they're really incompatible with the
  * chain tip.
+ *
+ * A parallel index build passes the scan of its participant, which was
+ * begun by heap_beginscan_parallel() with the snapshot the leader chose,
+ * and which is ended here like a scan of our own.
  */
 double IndexBuildHeapScan(Relation heapRelation, Relation indexRelation, IndexInfo* indexInfo, bool allow_sync,
-    IndexBuildCallback callback, void* callback_state)
+    IndexBuildCallback callback, void* callback_state, HeapScanDesc scan)
 {
     bool is_system_catalog = false;
     bool checking_uniqueness = false;
-    HeapScanDesc scan;
+    bool need_unregister_snapshot = false;
     HeapTuple heapTuple;
     Datum values[INDEX_MAX_KEYS];
     bool isnull[INDEX_MAX_KEYS];
@@ -2755,24 +2775,38 @@ double IndexBuildHeapScan(Relation heapRelation, Relation indexRelation, IndexIn
      * concurrent build, we take a regular MVCC snapshot and index whatever's
      * live according to that.	During bootstrap we just use SnapshotNow.
      */
-    if (IsBootstrapProcessingMode()) {
-        snapshot = SnapshotNow;
-        OldestXmin = InvalidTransactionId; /* not used */
-    } else if (indexInfo->ii_Concurrent) {
-        snapshot = RegisterSnapshot(GetTransactionSnapshot());
-        OldestXmin = InvalidTransactionId; /* not used */
+    if (scan != NULL) {
+        /* Parallel index build: the leader already chose the snapshot */
+        Assert(allow_sync);
+        Assert(!IsBootstrapProcessingMode());
+        snapshot = scan->rs_snapshot;
+        if (snapshot == SnapshotAny) {
+            /* okay to ignore lazy VACUUMs here */
+            OldestXmin = GetOldestXmin(heapRelation);
+        } else {
+            OldestXmin = InvalidTransactionId; /* not used */
+        }
     } else {
-        snapshot = SnapshotAny;
-        /* okay to ignore lazy VACUUMs here */
-        OldestXmin = GetOldestXmin(heapRelation);
-    }
+        if (IsBootstrapProcessingMode()) {
+            snapshot = SnapshotNow;
+            OldestXmin = InvalidTransactionId; /* not used */
+        } else if (indexInfo->ii_Concurrent) {
+            snapshot = RegisterSnapshot(GetTransactionSnapshot());
+            need_unregister_snapshot = true;
+            OldestXmin = InvalidTransactionId; /* not used */
+        } else {
+            snapshot = SnapshotAny;
+            /* okay to ignore lazy VACUUMs here */
+            OldestXmin = GetOldestXmin(heapRelation);
+        }
 
-    scan = heap_beginscan_strat(heapRelation, /* relation */
-        snapshot,                             /* snapshot */
-        0,                                    /* number of keys */
-        NULL,                                 /* scan key */
-        true,                                 /* buffer access strategy OK */
-        allow_sync);                          /* syncscan OK? */
+        scan = heap_beginscan_strat(heapRelation, /* relation */
+            snapshot,                             /* snapshot */
+            0,                                    /* number of keys */
+            NULL,                                 /* scan key */
+            true,                                 /* buffer access strategy OK */
+            allow_sync);                          /* syncscan OK? */
+    }
 
     reltuples = 0;
 
@@ -3053,7 +3087,7 @@ double IndexBuildHeapScan(Relation heapRelation, Relation indexRelation, IndexIn
     heap_endscan(scan);
 
     /* we can now forget our snapshot, if set */
-    if (indexInfo->ii_Concurrent)
+    if (need_unregister_snapshot)
         UnregisterSnapshot(snapshot);
 
     ExecDropSingleTupleTableSlot(slot);
@@ -4219,4 +4219,30 @@ LANGUAGE 'plpgsql';
 CREATE VIEW DBE_PERF.global_threadpool_status AS
   SELECT * FROM DBE_PERF.global_threadpool_status();
 
+CREATE VIEW DBE_PERF.local_threadpool_queue_wait_history AS
+  SELECT * FROM threadpool_queue_wait_history();
+
+CREATE OR REPLACE FUNCTION DBE_PERF.global_threadpool_queue_wait_history()
+RETURNS SETOF DBE_PERF.local_threadpool_queue_wait_history
+AS $$
+DECLARE
+  ROW_DATA DBE_PERF.local_threadpool_queue_wait_history%ROWTYPE;
+  ROW_NAME RECORD;
+  QUERY_STR TEXT;
+  QUERY_STR_NODES TEXT;
+BEGIN
+  QUERY_STR_NODES := 'select * from DBE_PERF.node_name';
+  FOR ROW_NAME IN EXECUTE(QUERY_STR_NODES) LOOP
+    QUERY_STR := 'SELECT * FROM DBE_PERF.local_threadpool_queue_wait_history';
+    FOR ROW_DATA IN EXECUTE(QUERY_STR) LOOP
+      RETURN NEXT ROW_DATA;
+    END LOOP;
+  END LOOP;
+  RETURN;
+END; $$
+LANGUAGE 'plpgsql';
+
+CREATE VIEW DBE_PERF.global_threadpool_queue_wait_history AS
+  SELECT * FROM DBE_PERF.global_threadpool_queue_wait_history();
+
 grant select on all tables in schema dbe_perf to public;
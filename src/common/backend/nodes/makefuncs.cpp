@@ -671,6 +671,7 @@ IndexInfo* makeIndexInfo(int numattrs, List* expressions, List* predicates, bool
 
     /* initialize index-build state to default */
     n->ii_BrokenHotChain = false;
+    n->ii_ParallelWorkers = 0;
     n->ii_PgClassAttrId = 0;
 
     return n;
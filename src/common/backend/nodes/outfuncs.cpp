@@ -1523,6 +1523,7 @@ static void _outAgg(StringInfo str, Agg* node)
     WRITE_BOOL_FIELD(is_sonichash);
     WRITE_BOOL_FIELD(is_dummy);
     WRITE_UINT_FIELD(skew_optimize);
+    WRITE_ENUM_FIELD(parallel_stage, AggParallelStage);
 }
 
 static void _outWindowAgg(StringInfo str, WindowAgg* node)
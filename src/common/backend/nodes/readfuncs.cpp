@@ -2796,6 +2796,9 @@ static Agg* _readAgg(Agg* local_node)
     READ_BOOL_FIELD(is_sonichash);
     READ_BOOL_FIELD(is_dummy);
     READ_UINT_FIELD(skew_optimize);
+    IF_EXIST(parallel_stage) {
+        READ_ENUM_FIELD(parallel_stage, AggParallelStage);
+    }
 
     READ_DONE();
 }
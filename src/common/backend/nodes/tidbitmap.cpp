@@ -44,6 +44,7 @@
 #include "access/htup.h"
 #include "nodes/bitmapset.h"
 #include "nodes/tidbitmap.h"
+#include "storage/spin.h"
 #include "utils/hsearch.h"
 
 /*
@@ -134,6 +135,20 @@ typedef enum {
     TBM_HASH      /* pagetable is valid, entry1 is not */
 } TBMStatus;
 
+/*
+ * For a parallel bitmap heap scan, the sorted page lists are copied out of
+ * the (backend-private) hashtable into memory that every participant of the
+ * scan can address.  One such copy may be shared by several iterator states,
+ * e.g. the main and the prefetch iterator of one scan.
+ */
+typedef struct TBMSharedPagetable {
+    int refcount;            /* number of TBMSharedIteratorStates using it */
+    int npages;              /* number of exact entries in spages */
+    int nchunks;             /* number of lossy entries in schunks */
+    PagetableEntry* spages;  /* sorted exact-page entries */
+    PagetableEntry* schunks; /* sorted lossy-chunk entries */
+} TBMSharedPagetable;
+
 /*
  * Here is the representation for a whole TIDBitMap:
  */
@@ -152,6 +167,7 @@ struct TIDBitmap {
     /* these are valid when iterating is true: */
     PagetableEntry** spages;  /* sorted exact-page list, or NULL */
     PagetableEntry** schunks; /* sorted lossy-chunk list, or NULL */
+    TBMSharedPagetable* sptable; /* shared copy of the lists, or NULL */
 };
 
 /*
@@ -168,6 +184,28 @@ struct TBMIterator {
     TBMIterateResult output; /* MUST BE LAST (because variable-size) */
 };
 
+/*
+ * Shared iteration state of a parallel bitmap heap scan.  The participants
+ * advance the positions under the spinlock, so each page is returned to
+ * exactly one of them.
+ */
+struct TBMSharedIteratorState {
+    slock_t mutex;               /* protects the positions below */
+    TBMSharedPagetable* ptable;  /* the pages being iterated over */
+    int spageptr;                /* next spages index */
+    int schunkptr;               /* next schunks index */
+    int schunkbit;               /* next bit to check in current schunk */
+};
+
+/*
+ * Backend-private handle on a TBMSharedIteratorState; it only holds the
+ * output area for the page most recently returned to this participant.
+ */
+struct TBMSharedIterator {
+    TBMSharedIteratorState* state; /* shared iteration state */
+    TBMIterateResult output;       /* MUST BE LAST (because variable-size) */
+};
+
 /* Local function prototypes */
 static void tbm_union_page(TIDBitmap* a, const PagetableEntry* bpage);
 static bool tbm_intersect_page(TIDBitmap* a, PagetableEntry* apage, const TIDBitmap* b);
@@ -177,6 +215,9 @@ static bool tbm_page_is_lossy(const TIDBitmap* tbm, PagetableEntryNode pageNode)
 static void tbm_mark_page_lossy(TIDBitmap* tbm, PagetableEntryNode pageNode);
 static void tbm_lossify(TIDBitmap* tbm);
 static int tbm_comparator(const void* left, const void* right);
+static void tbm_sort_pages(TIDBitmap* tbm);
+static void tbm_advance_schunkbit(const PagetableEntry* chunk, int* schunkbitp);
+static int tbm_extract_page_tuple(const PagetableEntry* page, TBMIterateResult* output);
 
 /*
  * tbm_create - create an initially-empty bitmap
@@ -564,12 +605,20 @@ TBMIterator* tbm_begin_iterate(TIDBitmap* tbm)
     iterator->schunkptr = 0;
     iterator->schunkbit = 0;
 
-    /*
-     * If we have a hashtable, create and fill the sorted page lists, unless
-     * we already did that for a previous iterator.  Note that the lists are
-     * attached to the bitmap not the iterator, so they can be used by more
-     * than one iterator.
-     */
+    tbm_sort_pages(tbm);
+    tbm->iterating = true;
+
+    return iterator;
+}
+
+/*
+ * tbm_sort_pages - fill the sorted page lists of a bitmap in hashtable mode
+ *
+ * Note that the lists are attached to the bitmap not the iterator, so they
+ * can be used by more than one iterator; they are built only once.
+ */
+static void tbm_sort_pages(TIDBitmap* tbm)
+{
     if (tbm->status == TBM_HASH && !tbm->iterating) {
         HASH_SEQ_STATUS status;
         PagetableEntry* page = NULL;
@@ -601,10 +650,6 @@ TBMIterator* tbm_begin_iterate(TIDBitmap* tbm)
             qsort(tbm->schunks, nchunks, sizeof(PagetableEntry*), tbm_comparator);
         }
     }
-
-    tbm->iterating = true;
-
-    return iterator;
 }
 
 /*
@@ -634,15 +679,7 @@ TBMIterateResult* tbm_iterate(TBMIterator* iterator)
         PagetableEntry* chunk = tbm->schunks[iterator->schunkptr];
         int schunkbit = iterator->schunkbit;
 
-        while (schunkbit < PAGES_PER_CHUNK) {
-            int wordnum = WORDNUM(schunkbit);
-            int bitnum = BITNUM(schunkbit);
-
-            if ((chunk->words[wordnum] & ((bitmapword)1 << (unsigned int)bitnum)) != 0) {
-                break;
-            }
-            schunkbit++;
-        }
+        tbm_advance_schunkbit(chunk, &schunkbit);
         if (schunkbit < PAGES_PER_CHUNK) {
             iterator->schunkbit = schunkbit;
             break;
@@ -675,8 +712,6 @@ TBMIterateResult* tbm_iterate(TBMIterator* iterator)
 
     if (iterator->spageptr < tbm->npages) {
         PagetableEntry* page = NULL;
-        int ntuples;
-        int wordnum;
 
         /* In ONE_PAGE state, we don't allocate an spages[] array */
         if (tbm->status == TBM_ONE_PAGE) {
@@ -685,26 +720,9 @@ TBMIterateResult* tbm_iterate(TBMIterator* iterator)
             page = tbm->spages[iterator->spageptr];
         }
 
-        /* scan bitmap to extract individual offset numbers */
-        ntuples = 0;
-        for (wordnum = 0; wordnum < WORDS_PER_PAGE; wordnum++) {
-            bitmapword w = page->words[wordnum];
-
-            if (w != 0) {
-                int off = wordnum * BITS_PER_BITMAPWORD + 1;
-
-                while (w != 0) {
-                    if (w & 1) {
-                        output->offsets[ntuples++] = (OffsetNumber)off;
-                    }
-                    off++;
-                    w >>= 1;
-                }
-            }
-        }
+        output->ntuples = tbm_extract_page_tuple(page, output);
         output->blockno = page->entryNode.blockNo;
         output->partitionOid = page->entryNode.partitionOid;
-        output->ntuples = ntuples;
         output->recheck = page->recheck;
         iterator->spageptr++;
         return output;
@@ -714,6 +732,57 @@ TBMIterateResult* tbm_iterate(TBMIterator* iterator)
     return NULL;
 }
 
+/*
+ * tbm_advance_schunkbit - advance *schunkbitp to the next page set in chunk
+ *
+ * *schunkbitp is left at PAGES_PER_CHUNK if no further bit is set.
+ */
+static void tbm_advance_schunkbit(const PagetableEntry* chunk, int* schunkbitp)
+{
+    int schunkbit = *schunkbitp;
+
+    while (schunkbit < PAGES_PER_CHUNK) {
+        int wordnum = WORDNUM(schunkbit);
+        int bitnum = BITNUM(schunkbit);
+
+        if ((chunk->words[wordnum] & ((bitmapword)1 << (unsigned int)bitnum)) != 0) {
+            break;
+        }
+        schunkbit++;
+    }
+
+    *schunkbitp = schunkbit;
+}
+
+/*
+ * tbm_extract_page_tuple - scan an exact page's bitmap into output->offsets
+ *
+ * Returns the number of offsets stored.
+ */
+static int tbm_extract_page_tuple(const PagetableEntry* page, TBMIterateResult* output)
+{
+    int ntuples = 0;
+    int wordnum;
+
+    for (wordnum = 0; wordnum < WORDS_PER_PAGE; wordnum++) {
+        bitmapword w = page->words[wordnum];
+
+        if (w != 0) {
+            int off = wordnum * BITS_PER_BITMAPWORD + 1;
+
+            while (w != 0) {
+                if (w & 1) {
+                    output->offsets[ntuples++] = (OffsetNumber)off;
+                }
+                off++;
+                w >>= 1;
+            }
+        }
+    }
+
+    return ntuples;
+}
+
 /*
  * tbm_end_iterate - finish an iteration over a TIDBitmap
  *
@@ -726,6 +795,183 @@ void tbm_end_iterate(TBMIterator* iterator)
     pfree_ext(iterator);
 }
 
+/*
+ * tbm_prepare_shared_iterate - prepare a TIDBitmap for a parallel scan
+ *
+ * The sorted page lists are copied into memory context cxt, which must be
+ * one that all participants of the parallel scan can address, and a new
+ * shared iteration state positioned at the start of the bitmap is returned.
+ * The copy is made only once per bitmap, so calling this again (say for a
+ * prefetch iterator) is cheap.  The bitmap itself stays private to the
+ * caller and may be freed once the iteration states have been set up.
+ *
+ * NB: after this is called, it is no longer allowed to modify the contents
+ * of the bitmap.
+ */
+TBMSharedIteratorState* tbm_prepare_shared_iterate(TIDBitmap* tbm, MemoryContext cxt)
+{
+    TBMSharedIteratorState* istate = NULL;
+
+    if (tbm->sptable == NULL) {
+        TBMSharedPagetable* ptable = NULL;
+        Size headersize = MAXALIGN(sizeof(TBMSharedPagetable));
+        int i;
+
+        tbm_sort_pages(tbm);
+        tbm->iterating = true;
+
+        ptable = (TBMSharedPagetable*)MemoryContextAllocZero(
+            cxt, headersize + (Size)(tbm->npages + tbm->nchunks) * sizeof(PagetableEntry));
+        ptable->npages = tbm->npages;
+        ptable->nchunks = tbm->nchunks;
+        ptable->spages = (PagetableEntry*)((char*)ptable + headersize);
+        ptable->schunks = ptable->spages + tbm->npages;
+
+        /* In ONE_PAGE state, there is no spages[] array to copy from */
+        if (tbm->status == TBM_ONE_PAGE) {
+            ptable->spages[0] = tbm->entry1;
+        } else {
+            for (i = 0; i < tbm->npages; i++) {
+                ptable->spages[i] = *tbm->spages[i];
+            }
+            for (i = 0; i < tbm->nchunks; i++) {
+                ptable->schunks[i] = *tbm->schunks[i];
+            }
+        }
+        tbm->sptable = ptable;
+    }
+
+    istate = (TBMSharedIteratorState*)MemoryContextAllocZero(cxt, sizeof(TBMSharedIteratorState));
+    SpinLockInit(&istate->mutex);
+    istate->ptable = tbm->sptable;
+    istate->ptable->refcount++;
+
+    return istate;
+}
+
+/*
+ * tbm_free_shared_area - release a shared iteration state
+ *
+ * The shared page lists go away with the last state referencing them.  No
+ * participant may still be attached to istate.
+ */
+void tbm_free_shared_area(TBMSharedIteratorState* istate)
+{
+    TBMSharedPagetable* ptable = istate->ptable;
+
+    Assert(ptable->refcount > 0);
+    if (--ptable->refcount == 0) {
+        pfree_ext(ptable);
+    }
+    pfree_ext(istate);
+}
+
+/*
+ * tbm_attach_shared_iterate - attach to a shared iteration state
+ *
+ * The TBMSharedIterator is created in the caller's memory context and is
+ * used to iterate with tbm_shared_iterate.
+ */
+TBMSharedIterator* tbm_attach_shared_iterate(TBMSharedIteratorState* istate)
+{
+    TBMSharedIterator* iterator = NULL;
+
+    /* Leave enough trailing space to serve the needs of the output sub-struct */
+    iterator = (TBMSharedIterator*)palloc0(sizeof(TBMSharedIterator) + MAX_TUPLES_PER_PAGE * sizeof(OffsetNumber));
+    iterator->state = istate;
+
+    return iterator;
+}
+
+/*
+ * tbm_shared_iterate - scan through next page of a shared TIDBitmap
+ *
+ * As tbm_iterate, except that the pages are handed out among all the
+ * participants attached to the same TBMSharedIteratorState; each page is
+ * returned to only one of them.  Pages are still claimed in numerical order,
+ * so the pages one participant sees are ascending as well.
+ */
+TBMIterateResult* tbm_shared_iterate(TBMSharedIterator* iterator)
+{
+    TBMSharedIteratorState* istate = iterator->state;
+    TBMSharedPagetable* ptable = istate->ptable;
+    TBMIterateResult* output = &(iterator->output);
+    PagetableEntry* page = NULL;
+
+    SpinLockAcquire(&istate->mutex);
+
+    /*
+     * If lossy chunk pages remain, make sure we've advanced schunkptr/
+     * schunkbit to the next set bit.
+     */
+    while (istate->schunkptr < ptable->nchunks) {
+        PagetableEntry* chunk = &ptable->schunks[istate->schunkptr];
+        int schunkbit = istate->schunkbit;
+
+        tbm_advance_schunkbit(chunk, &schunkbit);
+        if (schunkbit < PAGES_PER_CHUNK) {
+            istate->schunkbit = schunkbit;
+            break;
+        }
+        /* advance to next chunk */
+        istate->schunkptr++;
+        istate->schunkbit = 0;
+    }
+
+    /*
+     * If both chunk and per-page data remain, must output the numerically
+     * earlier page.
+     */
+    if (istate->schunkptr < ptable->nchunks) {
+        PagetableEntry* chunk = &ptable->schunks[istate->schunkptr];
+        PagetableEntryNode pnode;
+        pnode.blockNo = chunk->entryNode.blockNo + istate->schunkbit;
+        pnode.partitionOid = chunk->entryNode.partitionOid;
+        if (istate->spageptr >= ptable->npages ||
+            IS_CHUNK_BEFORE_PAGE(pnode, ptable->spages[istate->spageptr].entryNode)) {
+            /* Return a lossy page indicator from the chunk */
+            istate->schunkbit++;
+            SpinLockRelease(&istate->mutex);
+
+            output->blockno = pnode.blockNo;
+            output->partitionOid = pnode.partitionOid;
+            output->ntuples = -1;
+            output->recheck = true;
+            return output;
+        }
+    }
+
+    if (istate->spageptr < ptable->npages) {
+        page = &ptable->spages[istate->spageptr];
+        istate->spageptr++;
+    }
+
+    SpinLockRelease(&istate->mutex);
+
+    if (page == NULL) {
+        /* Nothing more in the bitmap */
+        return NULL;
+    }
+
+    /* The entries are read-only now, so no need to hold the lock for this */
+    output->ntuples = tbm_extract_page_tuple(page, output);
+    output->blockno = page->entryNode.blockNo;
+    output->partitionOid = page->entryNode.partitionOid;
+    output->recheck = page->recheck;
+    return output;
+}
+
+/*
+ * tbm_end_shared_iterate - finish a shared iteration over a TIDBitmap
+ *
+ * This releases only the backend-private part; the shared state is released
+ * by tbm_free_shared_area.
+ */
+void tbm_end_shared_iterate(TBMSharedIterator* iterator)
+{
+    pfree_ext(iterator);
+}
+
 /*
  * tbm_find_pageentry - find a PagetableEntry for the pageno
  *
@@ -11902,6 +11902,54 @@ Datum local_bgwriter_stat(PG_FUNCTION_ARGS)
     PG_RETURN_DATUM(HeapTupleGetDatum(tuple));
 }
 
+Datum local_buffer_partition_stat(PG_FUNCTION_ARGS)
+{
+#define BUFFER_PARTITION_STAT_ATTR_NUM 8
+    FuncCallContext* func_ctx = NULL;
+
+    if (SRF_IS_FIRSTCALL()) {
+        func_ctx = SRF_FIRSTCALL_INIT();
+        MemoryContext old_context = MemoryContextSwitchTo(func_ctx->multi_call_memory_ctx);
+
+        TupleDesc tup_desc = CreateTemplateTupleDesc(BUFFER_PARTITION_STAT_ATTR_NUM, false);
+        TupleDescInitEntry(tup_desc, (AttrNumber)1, "node_name", TEXTOID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber)2, "partition_id", INT4OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber)3, "buf_id_start", INT4OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber)4, "buffers", INT4OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber)5, "complete_passes", INT8OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber)6, "candidate_allocs", INT8OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber)7, "sweep_allocs", INT8OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber)8, "stolen_allocs", INT8OID, -1, 0);
+        func_ctx->tuple_desc = BlessTupleDesc(tup_desc);
+
+        BufferStrategyPartitionStat* stats = NULL;
+        func_ctx->max_calls = (uint32)StrategyGetPartitionStats(&stats);
+        func_ctx->user_fctx = stats;
+
+        (void)MemoryContextSwitchTo(old_context);
+    }
+
+    func_ctx = SRF_PERCALL_SETUP();
+    if (func_ctx->call_cntr < func_ctx->max_calls) {
+        BufferStrategyPartitionStat* stat = (BufferStrategyPartitionStat*)func_ctx->user_fctx + func_ctx->call_cntr;
+        Datum values[BUFFER_PARTITION_STAT_ATTR_NUM];
+        bool nulls[BUFFER_PARTITION_STAT_ATTR_NUM] = {false};
+
+        values[0] = CStringGetTextDatum(g_instance.attr.attr_common.PGXCNodeName);
+        values[1] = Int32GetDatum(stat->partition_id);
+        values[2] = Int32GetDatum(stat->buf_id_start);
+        values[3] = Int32GetDatum(stat->num_buffers);
+        values[4] = Int64GetDatum((int64)stat->complete_passes);
+        values[5] = Int64GetDatum((int64)stat->candidate_allocs);
+        values[6] = Int64GetDatum((int64)stat->sweep_allocs);
+        values[7] = Int64GetDatum((int64)stat->stolen_allocs);
+
+        HeapTuple tuple = heap_form_tuple(func_ctx->tuple_desc, values, nulls);
+        SRF_RETURN_NEXT(func_ctx, HeapTupleGetDatum(tuple));
+    }
+    SRF_RETURN_DONE(func_ctx);
+}
+
 void xc_stat_view(FuncCallContext* funcctx, int col_num, FuncName name)
 {
     MemoryContext old_context = NULL;
@@ -12374,6 +12422,93 @@ Datum gs_threadpool_status(PG_FUNCTION_ARGS)
     }
 }
 
+/*
+ * @@GaussDB@@
+ * Brief		: Get the queue wait samples the thread pool scheduler sized groups by
+ * Description	:
+ * Notes		:
+ */
+Datum gs_threadpool_queue_wait_history(PG_FUNCTION_ARGS)
+{
+    FuncCallContext* func_ctx = NULL;
+    QueueWaitSample* entry = NULL;
+    MemoryContext old_context = NULL;
+
+    /* stuff done only on the first call of the function */
+    if (SRF_IS_FIRSTCALL()) {
+        TupleDesc tup_desc = NULL;
+
+        /* create a function context for cross-call persistence */
+        func_ctx = SRF_FIRSTCALL_INIT();
+
+        /*
+         * switch to memory context appropriate for multiple function
+         * calls
+         */
+        old_context = MemoryContextSwitchTo(func_ctx->multi_call_memory_ctx);
+
+        tup_desc = CreateTemplateTupleDesc(NUM_QUEUE_WAIT_HISTORY_ELEM, false);
+
+        TupleDescInitEntry(tup_desc, (AttrNumber)1, "node_name", TEXTOID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber)2, "group_id", INT4OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber)3, "sample_time", TIMESTAMPTZOID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber)4, "sessions", INT8OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber)5, "queue_wait_p95", INT8OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber)6, "expect_workers", INT4OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber)7, "action", TEXTOID, -1, 0);
+
+        /* complete descriptor of the tupledesc */
+        func_ctx->tuple_desc = BlessTupleDesc(tup_desc);
+
+        /* total number of tuples to be returned */
+        if (ENABLE_THREAD_POOL) {
+            func_ctx->user_fctx = (void*)g_threadPoolControler->GetQueueWaitHistory(&(func_ctx->max_calls));
+        } else {
+            func_ctx->max_calls = 0;
+        }
+
+        (void)MemoryContextSwitchTo(old_context);
+    }
+
+    /* stuff done on every call of the function */
+    func_ctx = SRF_PERCALL_SETUP();
+    entry = (QueueWaitSample*)func_ctx->user_fctx;
+
+    if (func_ctx->call_cntr < func_ctx->max_calls) {
+        /* do when there is more left to send */
+        Datum values[NUM_QUEUE_WAIT_HISTORY_ELEM];
+        bool nulls[NUM_QUEUE_WAIT_HISTORY_ELEM] = {false};
+        HeapTuple tuple = NULL;
+
+        errno_t rc = 0;
+        rc = memset_s(values, sizeof(values), 0, sizeof(values));
+        securec_check(rc, "\0", "\0");
+        rc = memset_s(nulls, sizeof(nulls), 0, sizeof(nulls));
+        securec_check(rc, "\0", "\0");
+
+        entry += func_ctx->call_cntr;
+
+        values[0] = CStringGetTextDatum(g_instance.attr.attr_common.PGXCNodeName);
+        values[1] = Int32GetDatum(entry->groupId);
+        values[2] = TimestampTzGetDatum(entry->sampleTime);
+        values[3] = Int64GetDatum((int64)entry->sessions);
+        values[4] = Int64GetDatum(entry->waitPercentile);
+        values[5] = Int32GetDatum(entry->expectWorkerNum);
+        values[6] = CStringGetTextDatum(entry->action);
+
+        /* no session was picked up during this pass */
+        if (entry->waitPercentile < 0) {
+            nulls[4] = true;
+        }
+
+        tuple = heap_form_tuple(func_ctx->tuple_desc, values, nulls);
+        SRF_RETURN_NEXT(func_ctx, HeapTupleGetDatum(tuple));
+    } else {
+        /* do when there is no more left */
+        SRF_RETURN_DONE(func_ctx);
+    }
+}
+
 Datum gs_globalplancache_status(PG_FUNCTION_ARGS)
 {
 #ifndef ENABLE_MULTIPLE_NODES
@@ -931,6 +931,13 @@ static const struct config_enum_entry plan_cache_mode_options[] = {
     {NULL, 0, false}
 };
 
+static const struct config_enum_entry vector_engine_strategy_options[] = {
+    {"off", OFF_VECTOR_ENGINE, false},
+    {"force", FORCE_VECTOR_ENGINE, false},
+    {"optimal", OPT_VECTOR_ENGINE, false},
+    {NULL, 0, false}
+};
+
 /*
  * define insert mode for dfs_insert
  */
@@ -1320,6 +1327,20 @@ static void init_configure_names_bool()
             NULL,
             NULL
         },
+        {
+            {
+                "enable_scan_runtime_filter",
+                PGC_USERSET,
+                QUERY_TUNING_METHOD,
+                gettext_noop("Enable pushing hash join bloom filters down into row and column store scans."),
+                NULL
+            },
+            &u_sess->attr.attr_sql.enable_scan_runtime_filter,
+            false,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "enable_codegen",
@@ -1657,6 +1678,20 @@ static void init_configure_names_bool()
             NULL,
             NULL
         },
+        {
+            {
+                "enable_parallel_hash",
+                PGC_USERSET,
+                QUERY_TUNING_METHOD,
+                gettext_noop("Enables the planner's use of parallel hash plans."),
+                NULL
+            },
+            &u_sess->attr.attr_sql.enable_parallel_hash,
+            true,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "enable_index_nestloop",
@@ -7365,6 +7400,24 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
+        {
+            {
+                "min_parallel_index_scan_size",
+                PGC_USERSET,
+                QUERY_TUNING_COST,
+                gettext_noop("Sets the minimum amount of index data for a parallel scan."),
+                gettext_noop("If the planner estimates that it will read a number of index "
+                    "pages too small to reach this limit, a parallel scan will not be considered."),
+                GUC_UNIT_BLOCKS,
+            },
+            &u_sess->attr.attr_sql.min_parallel_index_scan_size,
+            (512 * 1024) / BLCKSZ,
+            0,
+            INT_MAX / 3,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             /* Can't be set in postgresql.conf */
             {
@@ -8993,6 +9046,24 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
+        {
+            {
+                "logical_decoding_work_mem",
+                PGC_SIGHUP,
+                UNGROUPED,
+                gettext_noop("Sets the maximum memory to be used by logical decoding, before evicting transactions "
+                             "to disk or streaming them."),
+                NULL,
+                GUC_UNIT_KB
+            },
+            &g_instance.attr.attr_common.logical_decoding_work_mem,
+            65536,
+            64,
+            MAX_KILOBYTES,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "table_skewness_warning_rows",
@@ -9294,6 +9365,39 @@ static void init_configure_names_int()
             NULL,
             NULL
         },
+        {
+            {
+                "max_parallel_maintenance_workers",
+                PGC_USERSET,
+                RESOURCES_ASYNCHRONOUS,
+                gettext_noop("Sets the maximum number of parallel processes per maintenance operation."),
+                NULL
+            },
+            &u_sess->attr.attr_sql.max_parallel_maintenance_workers,
+            2,
+            0,
+            MAX_PARALLEL_WORKER_LIMIT,
+            NULL,
+            NULL,
+            NULL
+        },
+        {
+            {
+                "thread_pool_queue_wait_target",
+                PGC_SIGHUP,
+                CLIENT_CONN,
+                gettext_noop("Sets the 95th percentile queue wait of sessions the thread pool groups are sized for."),
+                gettext_noop("Zero leaves group sizing to hang detection."),
+                GUC_UNIT_MS
+            },
+            &g_instance.attr.attr_common.thread_pool_queue_wait_target,
+            0,
+            0,
+            INT_MAX / 1000,
+            NULL,
+            NULL,
+            NULL
+        },
         /* End-of-list marker */
         {
             {
@@ -11947,6 +12051,24 @@ static void init_configure_names_enum()
             NULL,
             NULL
         },
+        {
+            {
+                "try_vector_engine_strategy",
+                PGC_USERSET,
+                QUERY_TUNING_METHOD,
+                gettext_noop("Sets the strategy of running plans over row relations in the vector engine."),
+                gettext_noop("With force, scans of row relations are fed to the vector engine through a "
+                    "Vector Adapter, so that their quals and the operators above them are evaluated a "
+                    "batch of rows at a time.  With optimal, this is only done for plans that aggregate "
+                    "many rows.")
+            },
+            &u_sess->attr.attr_sql.vector_engine_strategy,
+            OFF_VECTOR_ENGINE,
+            vector_engine_strategy_options,
+            NULL,
+            NULL,
+            NULL
+        },
         {
             {
                 "opfusion_debug_mode",
@@ -12505,6 +12627,7 @@ static void init_single_node_unsupport_guc()
         g_instance.attr.attr_sql.max_resource_package = 0;
         g_instance.attr.attr_common.max_cached_tuplebufs = 8192;
         g_instance.attr.attr_common.max_changes_in_memory = 4096;
+        g_instance.attr.attr_common.logical_decoding_work_mem = 65536;
     }
 
     return;
@@ -59,6 +59,18 @@
  * of releasing many blocks followed by re-using many blocks, due to
  * tuplesort.c's "preread" behavior.
  *
+ * A tape set can also be shared between the participants of a parallel sort
+ * (see tuplesort.c).  A worker writes its single output tape to a BufFile
+ * of its own in a SharedFileSet, perfectly sequentially and without any
+ * indirect blocks, and freezes it with LogicalTapeFreeze() so that its
+ * extent can be described by a TapeShare.  The leader then creates a tape
+ * set whose first tapes are imported from those files: the worker BufFiles
+ * are concatenated into the leader's own BufFile with BufFileAppend(), and
+ * each imported tape is read as a run of consecutive blocks beginning at its
+ * offset within the concatenated file.  Imported tapes can only be read
+ * once, front to back, which is all the leader's final on-the-fly merge
+ * needs.
+ *
  * Since all the bookkeeping and buffer memory is allocated with palloc(),
  * and the underlying file(s) are made with OpenTemporaryFile, all resources
  * for a logical tape set are certain to be cleaned up even if processing
@@ -133,6 +145,14 @@ typedef struct LogicalTape {
     long curBlockNumber; /* this block's logical blk# within tape */
     int pos;             /* next read/write position in buffer */
     int nbytes;          /* total # of valid bytes in buffer */
+
+    /*
+     * A tape imported from a parallel sort worker has no indirect blocks;
+     * its data blocks are consecutive in the underlying file, starting at
+     * offsetBlockNumber.
+     */
+    bool imported;          /* T if tape was written by a worker */
+    long offsetBlockNumber; /* first block of an imported tape */
 } LogicalTape;
 
 /*
@@ -164,6 +184,13 @@ struct LogicalTapeSet {
     int nFreeBlocks;      /* # of currently free blocks */
     int freeBlocksLen;    /* current allocated length of freeBlocks[] */
 
+    /*
+     * worker is the participant number of a parallel sort worker writing
+     * its output tape to a shared file, or -1 for the leader and for serial
+     * sorts.
+     */
+    int worker;
+
     /*
      * tapes[] is declared size 1 since C wants a fixed size, but actually it
      * is of length nTapes.
@@ -182,6 +209,8 @@ static long ltsRewindFrozenIndirectBlock(LogicalTapeSet* lts, IndirectBlock* ind
 static long ltsRecallNextBlockNum(LogicalTapeSet* lts, IndirectBlock* indirect, bool frozen);
 static long ltsRecallPrevBlockNum(LogicalTapeSet* lts, IndirectBlock* indirect);
 static void ltsDumpBuffer(LogicalTapeSet* lts, LogicalTape* lt);
+static void ltsConcatWorkerTapes(LogicalTapeSet* lts, TapeShare* shared, SharedFileSet* fileset);
+static long ltsImportedBlockNum(LogicalTape* lt, long blocknum);
 
 /*
  * Write a block-sized buffer to the specified block of the underlying file.
@@ -468,9 +497,20 @@ static long ltsRecallPrevBlockNum(LogicalTapeSet* lts, IndirectBlock* indirect)
 /*
  * Create a set of logical tapes in a temporary underlying file.
  *
- * Each tape is initialized in write state.
+ * Each tape is initialized in write state.  Serial sorts should pass NULL
+ * for shared and fileset, and -1 for worker.
+ *
+ * A parallel sort worker passes its fileset and worker number, and gets a
+ * set of ntapes (which must be 1) whose tape is written to a shared file
+ * named after the worker number.
+ *
+ * The leader passes the array of TapeShare that its workers filled in when
+ * freezing their output tapes, and a worker number of -1.  The first
+ * ntapes - 1 tapes of the set are then the frozen worker tapes, ready to be
+ * rewound for reading; the last tape is an ordinary tape that cannot be
+ * written to, since the underlying file is read-only.
  */
-LogicalTapeSet* LogicalTapeSetCreate(int ntapes)
+LogicalTapeSet* LogicalTapeSetCreate(int ntapes, TapeShare* shared, SharedFileSet* fileset, int worker)
 {
     LogicalTapeSet* lts = NULL;
     LogicalTape* lt = NULL;
@@ -482,13 +522,14 @@ LogicalTapeSet* LogicalTapeSetCreate(int ntapes)
      */
     Assert(ntapes > 0);
     lts = (LogicalTapeSet*)palloc(sizeof(LogicalTapeSet) + ((size_t)ntapes - 1) * sizeof(LogicalTape));
-    lts->pfile = BufFileCreateTemp(false);
+    lts->pfile = NULL;
     lts->nFileBlocks = 0L;
     lts->forgetFreeSpace = false;
     lts->blocksSorted = true; /* a zero-length array is sorted ... */
     lts->freeBlocksLen = 32;  /* reasonable initial guess */
     lts->freeBlocks = (long*)palloc((size_t)lts->freeBlocksLen * sizeof(long));
     lts->nFreeBlocks = 0;
+    lts->worker = worker;
     lts->nTapes = ntapes;
 
     /*
@@ -509,10 +550,83 @@ LogicalTapeSet* LogicalTapeSetCreate(int ntapes)
         lt->curBlockNumber = 0L;
         lt->pos = 0;
         lt->nbytes = 0;
+        lt->imported = false;
+        lt->offsetBlockNumber = 0L;
+    }
+
+    if (shared != NULL) {
+        /* Leader: import the workers' output tapes */
+        Assert(fileset != NULL && worker == -1);
+        ltsConcatWorkerTapes(lts, shared, fileset);
+    } else if (fileset != NULL) {
+        /* Worker: a single output tape in a file the leader can find */
+        char filename[MAXPGPATH];
+        errno_t rc;
+
+        Assert(ntapes == 1 && worker >= 0);
+        rc = snprintf_s(filename, MAXPGPATH, MAXPGPATH - 1, "%d", worker);
+        securec_check_ss(rc, "\0", "\0");
+        lts->pfile = BufFileCreateShared(fileset, filename);
+    } else {
+        lts->pfile = BufFileCreateTemp(false);
     }
+
     return lts;
 }
 
+/*
+ * Claim ownership of the set of worker output files, concatenating them
+ * into the leader's BufFile, and set up the first nTapes - 1 tapes to read
+ * them.
+ *
+ * Each worker file begins at a MAX_PHYSICAL_FILESIZE boundary of the
+ * concatenated file, so the blocks between the end of one worker's data and
+ * the start of the next one's are holes that are never read.
+ */
+static void ltsConcatWorkerTapes(LogicalTapeSet* lts, TapeShare* shared, SharedFileSet* fileset)
+{
+    LogicalTape* lt = NULL;
+    BufFile* file = NULL;
+    char filename[MAXPGPATH];
+    errno_t rc;
+    int i;
+
+    for (i = 0; i < lts->nTapes - 1; i++) {
+        lt = &lts->tapes[i];
+
+        rc = snprintf_s(filename, MAXPGPATH, MAXPGPATH - 1, "%d", i);
+        securec_check_ss(rc, "\0", "\0");
+        file = BufFileOpenShared(fileset, filename);
+
+        if (i == 0) {
+            lts->pfile = file;
+            lt->offsetBlockNumber = 0L;
+        } else {
+            lt->offsetBlockNumber = BufFileAppend(lts->pfile, file);
+        }
+
+        lt->imported = true;
+        lt->writing = false;
+        lt->frozen = true;
+        lt->numFullBlocks = shared[i].numFullBlocks;
+        lt->lastBlockBytes = shared[i].lastBlockBytes;
+        lt->buffer = (char*)palloc(BLCKSZ);
+
+        lts->nFileBlocks = lt->offsetBlockNumber + lt->numFullBlocks + 1;
+    }
+}
+
+/*
+ * Map a logical block number of an imported tape to its block in the
+ * underlying file, or return -1 at end of tape.
+ */
+static long ltsImportedBlockNum(LogicalTape* lt, long blocknum)
+{
+    if (blocknum > lt->numFullBlocks || (blocknum == lt->numFullBlocks && lt->lastBlockBytes == 0))
+        return -1L;
+    return lt->offsetBlockNumber + blocknum;
+}
+
 /*
  * Close a logical tape set and release all resources.
  */
@@ -560,7 +674,9 @@ static void ltsDumpBuffer(LogicalTapeSet* lts, LogicalTape* lt)
 
     Assert(lt->dirty);
     ltsWriteBlock(lts, datablock, (void*)lt->buffer);
-    ltsRecordBlockNum(lts, lt->indirect, datablock);
+    /* A worker's output tape is contiguous and needs no indirect blocks */
+    if (lts->worker < 0)
+        ltsRecordBlockNum(lts, lt->indirect, datablock);
     lt->dirty = false;
     /* Caller must do other state update as needed */
 }
@@ -578,6 +694,7 @@ void LogicalTapeWrite(LogicalTapeSet* lts, int tapenum, void* ptr, size_t size)
     Assert(tapenum >= 0 && tapenum < lts->nTapes);
     lt = &lts->tapes[tapenum];
     Assert(lt->writing);
+    Assert(!lt->imported);
 
     /* Allocate data buffer and first indirect block on first write */
     if (lt->buffer == NULL)
@@ -652,7 +769,10 @@ void LogicalTapeRewind(LogicalTapeSet* lts, int tapenum, bool forWrite)
              * pass.
              */
             Assert(lt->frozen);
-            datablocknum = ltsRewindFrozenIndirectBlock(lts, lt->indirect);
+            if (lt->imported)
+                datablocknum = ltsImportedBlockNum(lt, 0L);
+            else
+                datablocknum = ltsRewindFrozenIndirectBlock(lts, lt->indirect);
         }
         /* Read the first block, or reset if tape is empty */
         lt->curBlockNumber = 0L;
@@ -714,7 +834,12 @@ size_t LogicalTapeRead(LogicalTapeSet* lts, int tapenum, void* ptr, size_t size)
     while (size > 0) {
         if (lt->pos >= lt->nbytes) {
             /* Try to load more data into buffer. */
-            long datablocknum = ltsRecallNextBlockNum(lts, lt->indirect, lt->frozen);
+            long datablocknum;
+
+            if (lt->imported)
+                datablocknum = ltsImportedBlockNum(lt, lt->curBlockNumber + 1);
+            else
+                datablocknum = ltsRecallNextBlockNum(lts, lt->indirect, lt->frozen);
 
             if (datablocknum == -1L)
                 break; /* EOF */
@@ -755,8 +880,12 @@ size_t LogicalTapeRead(LogicalTapeSet* lts, int tapenum, void* ptr, size_t size)
  * tape is rewound (after rewind is too late!).  It performs a rewind
  * and switch to read mode "for free".	An immediately following rewind-
  * for-read call is OK but not necessary.
+ *
+ * A parallel sort worker passes share to export its output tape instead:
+ * the extent of the tape is recorded there for the leader, and the shared
+ * file is made read-only.  The worker cannot read the tape afterwards.
  */
-void LogicalTapeFreeze(LogicalTapeSet* lts, int tapenum)
+void LogicalTapeFreeze(LogicalTapeSet* lts, int tapenum, TapeShare* share)
 {
     LogicalTape* lt = NULL;
     long datablocknum;
@@ -764,6 +893,7 @@ void LogicalTapeFreeze(LogicalTapeSet* lts, int tapenum)
     Assert(tapenum >= 0 && tapenum < lts->nTapes);
     lt = &lts->tapes[tapenum];
     Assert(lt->writing);
+    Assert(share == NULL || lts->worker >= 0);
 
     /*
      * Completion of a write phase.  Flush last partial data block, flush any
@@ -774,6 +904,14 @@ void LogicalTapeFreeze(LogicalTapeSet* lts, int tapenum)
     lt->lastBlockBytes = lt->nbytes;
     lt->writing = false;
     lt->frozen = true;
+
+    if (share != NULL) {
+        share->numFullBlocks = lt->numFullBlocks;
+        share->lastBlockBytes = lt->lastBlockBytes;
+        BufFileExportShared(lts->pfile);
+        return;
+    }
+
     datablocknum = ltsRewindIndirectBlock(lts, lt->indirect, true);
     /* Read the first block, or reset if tape is empty */
     lt->curBlockNumber = 0L;
@@ -804,7 +942,7 @@ bool LogicalTapeBackspace(LogicalTapeSet* lts, int tapenum, size_t size)
 
     Assert(tapenum >= 0 && tapenum < lts->nTapes);
     lt = &lts->tapes[tapenum];
-    Assert(lt->frozen);
+    Assert(lt->frozen && !lt->imported);
 
     /*
      * Easy case for seek within current block.
@@ -862,7 +1000,7 @@ bool LogicalTapeSeek(LogicalTapeSet* lts, int tapenum, long blocknum, int offset
 
     Assert(tapenum >= 0 && tapenum < lts->nTapes);
     lt = &lts->tapes[tapenum];
-    Assert(lt->frozen);
+    Assert(lt->frozen && !lt->imported);
     Assert(offset >= 0 && offset <= BLCKSZ);
 
     /*
@@ -86,6 +86,16 @@
  * we preread from a tape, so as to maintain the locality of access described
  * above.  Nonetheless, with large workMem we can have many tapes.
  *
+ * Parallel sorts are coordinated between a leader and any number of worker
+ * participants, which are all threads sharing a parallel context.  Each
+ * worker sorts its share of the input exactly as a serial sort would, then
+ * copies its sorted output onto a single tape in a file of a SharedFileSet
+ * (see logtape.c).  The leader does not sort any tuples itself; it imports
+ * the workers' tapes into a tape set of its own, each holding one run, and
+ * merges them with the same on-the-fly final merge that a serial sort uses
+ * for its last pass.  The leader may additionally take part in the sort as
+ * one of the worker participants, using a separate Tuplesortstate.
+ *
  *
  * Portions Copyright (c) 1996-2012, PostgreSQL Global Development Group
  * Portions Copyright (c) 1994, Regents of the University of California
@@ -125,6 +135,7 @@
 #include "utils/memprot.h"
 #include "pgstat.h"
 #include "pgxc/pgxc.h"
+#include "storage/spin.h"
 
 /* sort-type codes for sort__start probes */
 #define HEAP_SORT 0
@@ -207,6 +218,38 @@ typedef enum {
 
 typedef int (*SortTupleComparator)(const SortTuple* a, const SortTuple* b, Tuplesortstate* state);
 
+/*
+ * Private mutable state of tuplesort-parallel-operation.  This is allocated
+ * in the memory shared by the participants of the parallel context.
+ */
+struct SharedSort {
+    /* mutex protects all fields prior to tapes */
+    slock_t mutex;
+
+    /*
+     * currentWorker generates ordinal identifier numbers for parallel sort
+     * workers.  These start from 0, and are always gapless.
+     *
+     * Workers increment workersFinished to indicate having finished.  If
+     * this is equal to state.nParticipants within the leader, leader is
+     * ready to merge worker runs.
+     */
+    int currentWorker;
+    int workersFinished;
+
+    /* Temporary file space */
+    SharedFileSet fileset;
+
+    /* Size of tapes flexible array */
+    int nTapes;
+
+    /*
+     * Tapes array used by workers to report back information needed by the
+     * leader to concatenate all worker tapes into one for merging
+     */
+    TapeShare tapes[FLEXIBLE_ARRAY_MEMBER];
+};
+
 /*
  * Private state of a Tuplesort operation.
  */
@@ -424,8 +467,26 @@ struct Tuplesortstate {
 #endif
 
     int64 spill_size;
+
+    /*
+     * Parallel sort state.  shared is NULL for a serial sort.  worker is
+     * this participant's ordinal number within a worker, or -1 in the leader
+     * and in serial sorts.  nParticipants is the number of worker tuplesorts
+     * whose output the leader merges, or -1 outside the leader.
+     */
+    SharedSort* shared;
+    int worker;
+    int nParticipants;
 };
 
+/*
+ * Is the given tuplesort for a serial sort, a parallel sort worker, or the
+ * leader of a parallel sort?
+ */
+#define SERIAL(state) ((state)->shared == NULL)
+#define WORKER(state) ((state)->shared && (state)->worker != -1)
+#define LEADER(state) ((state)->shared && (state)->worker == -1)
+
 #define COMPARETUP(state, a, b) ((*(state)->comparetup)(a, b, state))
 #define COPYTUP(state, stup, tup) ((*(state)->copytup)(state, stup, tup))
 #define WRITETUP(state, tape, stup) ((*(state)->writetup)(state, tape, stup))
@@ -552,7 +613,7 @@ static bool AutoSpreadMem(Tuplesortstate* state, double* growRatio)
                 (errmodule(MOD_EXECUTOR), (errcode(ERRCODE_FILE_READ_FAILED), errmsg("unexpected end of data")))); \
     } while (0)
 
-static Tuplesortstate* tuplesort_begin_common(int64 workMem, bool randomAccess);
+static Tuplesortstate* tuplesort_begin_common(int64 workMem, bool randomAccess, SortCoordinate coordinate = NULL);
 static void puttuple_common(Tuplesortstate* state, SortTuple* tuple);
 static bool consider_abort_common(Tuplesortstate* state);
 static void inittapes(Tuplesortstate* state);
@@ -591,6 +652,9 @@ static void writetup_datum(Tuplesortstate* state, int tapenum, SortTuple* stup);
 static void readtup_datum(Tuplesortstate* state, SortTuple* stup, int tapenum, unsigned int len);
 static void reversedirection_datum(Tuplesortstate* state);
 static void free_sort_tuple(Tuplesortstate* state, SortTuple* stup);
+static int worker_get_identifier(Tuplesortstate* state);
+static void worker_freeze_result_tape(Tuplesortstate* state);
+static void leader_takeover_tapes(Tuplesortstate* state);
 
 /*
  * Special versions of qsort just for SortTuple objects.  qsort_tuple() sorts
@@ -639,9 +703,12 @@ void sort_count(Tuplesortstate* state)
  * (The normal value of this parameter is u_sess->attr.attr_memory.work_mem, but some callers use
  * other values.)  Each variant also has a randomAccess parameter specifying
  * whether the caller needs non-sequential access to the sort result.
+ *
+ * The index_btree variant also accepts a coordinate, which is NULL for a
+ * serial sort; see tuplesort.h for how parallel sorts use it.
  */
 
-static Tuplesortstate* tuplesort_begin_common(int64 workMem, bool randomAccess)
+static Tuplesortstate* tuplesort_begin_common(int64 workMem, bool randomAccess, SortCoordinate coordinate)
 {
     Tuplesortstate* state = NULL;
     MemoryContext sortcontext;
@@ -704,6 +771,23 @@ static Tuplesortstate* tuplesort_begin_common(int64 workMem, bool randomAccess)
     state->result_tape = -1; /* flag that result tape has not been formed */
     state->peakMemorySize = 0;
 
+    /* Parallel sorts never return their result out of order */
+    Assert(coordinate == NULL || !randomAccess);
+    if (coordinate == NULL) {
+        state->shared = NULL;
+        state->worker = -1;
+        state->nParticipants = -1;
+    } else if (coordinate->isWorker) {
+        state->shared = coordinate->sharedsort;
+        state->worker = worker_get_identifier(state);
+        state->nParticipants = -1;
+    } else {
+        Assert(coordinate->nParticipants > 0);
+        state->shared = coordinate->sharedsort;
+        state->worker = -1;
+        state->nParticipants = coordinate->nParticipants;
+    }
+
     (void)MemoryContextSwitchTo(oldcontext);
 
     return state;
@@ -863,9 +947,9 @@ Tuplesortstate* tuplesort_begin_cluster(
 }
 
 Tuplesortstate* tuplesort_begin_index_btree(
-    Relation indexRel, bool enforceUnique, int workMem, bool randomAccess, int maxMem)
+    Relation indexRel, bool enforceUnique, int workMem, bool randomAccess, int maxMem, SortCoordinate coordinate)
 {
-    Tuplesortstate* state = tuplesort_begin_common(workMem, randomAccess);
+    Tuplesortstate* state = tuplesort_begin_common(workMem, randomAccess, coordinate);
     MemoryContext oldcontext;
 
     oldcontext = MemoryContextSwitchTo(state->sortcontext);
@@ -1111,6 +1195,54 @@ void tuplesort_end(Tuplesortstate* state)
     MemoryContextDelete(state->sortcontext);
 }
 
+/*
+ * tuplesort_estimate_shared - estimate required shared memory allocation
+ *
+ * nWorkers is an estimate of the number of workers (it's the number that
+ * will be requested).
+ */
+Size tuplesort_estimate_shared(int nWorkers)
+{
+    Size tapesSize;
+
+    Assert(nWorkers > 0);
+
+    /* Make sure that BufFile shared state is MAXALIGN'd */
+    tapesSize = mul_size(sizeof(TapeShare), nWorkers);
+    tapesSize = MAXALIGN(add_size(tapesSize, offsetof(SharedSort, tapes)));
+
+    return tapesSize;
+}
+
+/*
+ * tuplesort_initialize_shared - initialize shared tuplesort state
+ *
+ * Must be called from leader thread before workers are launched, to
+ * establish state needed up-front for worker tuplesortstates.  nWorkers
+ * should match the argument passed to tuplesort_estimate_shared().
+ *
+ * The temporary files of the sort belong to the parallel context seg, and
+ * are removed when the leader detaches from it.  Workers are threads that
+ * exit before the leader detaches, so they use the fileset without
+ * attaching to it themselves.
+ */
+void tuplesort_initialize_shared(SharedSort* shared, int nWorkers, void* seg)
+{
+    int i;
+
+    Assert(nWorkers > 0);
+
+    SpinLockInit(&shared->mutex);
+    shared->currentWorker = 0;
+    shared->workersFinished = 0;
+    SharedFileSetInit(&shared->fileset, seg);
+    shared->nTapes = nWorkers;
+    for (i = 0; i < nWorkers; i++) {
+        shared->tapes[i].numFullBlocks = 0L;
+        shared->tapes[i].lastBlockBytes = 0;
+    }
+}
+
 /*
  * Grow the memtuples[] array, if possible within our memory constraint.
  * Return TRUE if we were able to enlarge the array, FALSE if not.
@@ -1616,6 +1748,20 @@ void tuplesort_performsort(Tuplesortstate* state)
 
     switch (state->status) {
         case TSS_INITIAL:
+            if (LEADER(state)) {
+                /*
+                 * The leader is never given any tuples of its own.  Take
+                 * over the workers' sorted output, and prepare to merge it
+                 * on-the-fly.
+                 */
+                leader_takeover_tapes(state);
+                mergeruns(state);
+                state->eof_reached = false;
+                state->markpos_block = 0L;
+                state->markpos_offset = 0;
+                state->markpos_eof = false;
+                break;
+            }
 
             /*
              * We were able to accumulate all the tuples within the allowed
@@ -1635,6 +1781,8 @@ void tuplesort_performsort(Tuplesortstate* state)
             state->markpos_offset = 0;
             state->markpos_eof = false;
             state->status = TSS_SORTEDINMEM;
+            if (WORKER(state))
+                worker_freeze_result_tape(state);
             break;
 
         case TSS_BOUNDED:
@@ -1666,6 +1814,8 @@ void tuplesort_performsort(Tuplesortstate* state)
             state->markpos_block = 0L;
             state->markpos_offset = 0;
             state->markpos_eof = false;
+            if (WORKER(state))
+                worker_freeze_result_tape(state);
             break;
 
         default:
@@ -2258,9 +2408,10 @@ static void mergeruns(Tuplesortstate* state)
      * If we produced only one initial run (quite likely if the total data
      * volume is between 1X and 2X workMem), we can just use that tape as the
      * finished output, rather than doing a useless merge.	(This obvious
-     * optimization is not in Knuth's algorithm.)
+     * optimization is not in Knuth's algorithm.)  A leader's runs are on
+     * imported tapes that are already frozen, so it always merges.
      */
-    if (state->currentRun == 1) {
+    if (state->currentRun == 1 && !LEADER(state)) {
         state->result_tape = state->tp_tapenum[state->destTape];
         /* must freeze and rewind the finished output tape */
         LogicalTapeFreeze(state->tapeset, state->result_tape);
@@ -3850,6 +4001,169 @@ static void reversedirection_datum(Tuplesortstate* state)
 /*
  * Convenience routine to free a tuple previously loaded into sort memory
  */
+/*
+ * worker_get_identifier - Assign and return ordinal identifier for worker
+ *
+ * The order in which these are assigned is not well defined, and should not
+ * matter; worker numbers across parallel sort participants need only be
+ * distinct and gapless.  logtape.c requires this.
+ */
+static int worker_get_identifier(Tuplesortstate* state)
+{
+    SharedSort* shared = state->shared;
+    int worker;
+
+    SpinLockAcquire(&shared->mutex);
+    worker = shared->currentWorker++;
+    SpinLockRelease(&shared->mutex);
+
+    if (worker >= shared->nTapes)
+        ereport(ERROR,
+            (errmodule(MOD_EXECUTOR),
+                (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+                    errmsg("too many participants in parallel sort: %d", worker + 1))));
+
+    return worker;
+}
+
+/*
+ * worker_freeze_result_tape - freeze worker's result tape for leader
+ *
+ * This is called by workers just after the result of their sort has been
+ * determined, however it is represented.  The sorted output is copied onto
+ * the single tape of a tape set in the shared fileset, which is frozen and
+ * described in shared memory for the leader to import.  The worker's own
+ * tapes, if any, are released.  The worker must not fetch tuples from the
+ * sort afterwards.
+ *
+ * writetup and readtup always work against state->tapeset, so it is pointed
+ * at the result tape set only while writing each tuple.
+ */
+static void worker_freeze_result_tape(Tuplesortstate* state)
+{
+    SharedSort* shared = state->shared;
+    LogicalTapeSet* sortset = state->tapeset;
+    LogicalTapeSet* resultset = NULL;
+    TapeShare output;
+    SortTuple stup;
+    bool should_free = false;
+
+    Assert(WORKER(state));
+
+    PrepareTempTablespaces();
+    resultset = LogicalTapeSetCreate(1, NULL, &shared->fileset, state->worker);
+
+    while (tuplesort_gettuple_common(state, true, &stup, &should_free)) {
+        /*
+         * Tuples handed out by the final merge are no longer counted in our
+         * memory space, but WRITETUP releases the space of what it writes.
+         */
+        if (state->status == TSS_FINALMERGE && stup.tuple != NULL)
+            USEMEM(state, GetMemoryChunkSpace(stup.tuple));
+
+        state->tapeset = resultset;
+        WRITETUP(state, 0, &stup);
+        state->tapeset = sortset;
+    }
+
+    state->tapeset = resultset;
+    markrunend(state, 0);
+    LogicalTapeFreeze(resultset, 0, &output);
+
+    if (sortset != NULL)
+        LogicalTapeSetClose(sortset);
+    state->memtupcount = 0;
+    state->result_tape = 0;
+    state->status = TSS_SORTEDONTAPE;
+
+    /* Store properties of output tape, and update finished worker count */
+    SpinLockAcquire(&shared->mutex);
+    shared->tapes[state->worker] = output;
+    shared->workersFinished++;
+    SpinLockRelease(&shared->mutex);
+}
+
+/*
+ * leader_takeover_tapes - create tapeset for leader from worker tapes
+ *
+ * So far, leader Tuplesortstate has performed no actual sorting.  By now, all
+ * sorting has occurred in workers, all of which must have already returned
+ * from tuplesort_performsort().
+ *
+ * When this returns, leader process is left in a state that is virtually
+ * indistinguishable from it having generated runs as a serial external sort
+ * might have, with one run on each of the first nParticipants tapes and an
+ * empty output tape after them.
+ */
+static void leader_takeover_tapes(Tuplesortstate* state)
+{
+    SharedSort* shared = state->shared;
+    int nParticipants = state->nParticipants;
+    int workersFinished;
+    int maxTapes;
+    int j;
+
+    Assert(LEADER(state));
+    Assert(nParticipants >= 1);
+
+    SpinLockAcquire(&shared->mutex);
+    workersFinished = shared->workersFinished;
+    SpinLockRelease(&shared->mutex);
+
+    if (nParticipants != workersFinished)
+        ereport(ERROR,
+            (errmodule(MOD_EXECUTOR),
+                (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+                    errmsg("cannot take over tapes before all workers finish"))));
+
+    maxTapes = nParticipants + 1;
+    state->maxTapes = maxTapes;
+    state->tapeRange = nParticipants;
+
+#ifdef TRACE_SORT
+    if (u_sess->attr.attr_common.trace_sort) {
+        elog(LOG, "merging sorted output of %d workers: %s", nParticipants, pg_rusage_show(&state->ru_start));
+    }
+#endif
+
+    USEMEM(state, (long)maxTapes * TAPE_BUFFER_OVERHEAD);
+
+    /*
+     * Create the tape set from the workers' tapes, and allocate the per-tape
+     * data arrays.
+     */
+    state->tapeset = LogicalTapeSetCreate(maxTapes, shared->tapes, &shared->fileset, -1);
+
+    state->mergeactive = (bool*)palloc0(maxTapes * sizeof(bool));
+    state->mergenext = (int*)palloc0(maxTapes * sizeof(int));
+    state->mergelast = (int*)palloc0(maxTapes * sizeof(int));
+    state->mergeavailslots = (int*)palloc0(maxTapes * sizeof(int));
+    state->mergeavailmem = (long*)palloc0(maxTapes * sizeof(long));
+    state->tp_fib = (int*)palloc0(maxTapes * sizeof(int));
+    state->tp_runs = (int*)palloc0(maxTapes * sizeof(int));
+    state->tp_dummy = (int*)palloc0(maxTapes * sizeof(int));
+    state->tp_tapenum = (int*)palloc0(maxTapes * sizeof(int));
+
+    /*
+     * Set up the Algorithm D variables as if each worker's output were a
+     * run that we wrote to the corresponding tape ourselves.
+     */
+    state->currentRun = nParticipants;
+    for (j = 0; j < maxTapes; j++) {
+        state->tp_fib[j] = 1;
+        state->tp_runs[j] = 1;
+        state->tp_dummy[j] = 0;
+        state->tp_tapenum[j] = j;
+    }
+    state->tp_fib[state->tapeRange] = 0;
+    state->tp_runs[state->tapeRange] = 0;
+
+    state->Level = 1;
+    state->destTape = 0;
+
+    state->status = TSS_BUILDRUNS;
+}
+
 static void free_sort_tuple(Tuplesortstate* state, SortTuple* stup)
 {
     FREEMEM(state, GetMemoryChunkSpace(stup->tuple));
@@ -0,0 +1,68 @@
+/* -------------------------------------------------------------------------
+ *
+ * pg_cpu_features.cpp
+ *	  Runtime detection of the vector instruction sets of the CPU.
+ *
+ * Portions Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ *
+ * IDENTIFICATION
+ *    src/common/port/pg_cpu_features.cpp
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "c.h"
+
+#include "port/pg_cpu_features.h"
+
+#ifdef USE_X86_CPU_FEATURES
+
+#include <cpuid.h>
+
+#define CPUID1_ECX_OSXSAVE (1 << 27)
+#define CPUID7_EBX_AVX2 (1 << 5)
+#define CPUID7_EBX_AVX512F (1 << 16)
+
+#define XCR0_YMM_STATE 0x06 /* SSE and AVX state */
+#define XCR0_ZMM_STATE 0xE6 /* ymm state plus opmask and zmm state */
+
+/*
+ * Check that the CPU supports the leaf 7 feature and that the OS saves the
+ * register state it needs (XCR0) across context switches.
+ */
+static bool pg_cpu_has_leaf7_feature(uint32 leaf7EbxBit, uint32 xcr0Mask)
+{
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    unsigned int xcr0Low = 0;
+    unsigned int xcr0High = 0;
+
+    if (__get_cpuid_max(0, NULL) < 7) {
+        return false;
+    }
+    __cpuid(1, eax, ebx, ecx, edx);
+    if ((ecx & CPUID1_ECX_OSXSAVE) == 0) {
+        return false;
+    }
+    __asm__ __volatile__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+    if ((xcr0Low & xcr0Mask) != xcr0Mask) {
+        return false;
+    }
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx & leaf7EbxBit) != 0;
+}
+
+bool pg_cpu_has_avx2(void)
+{
+    return pg_cpu_has_leaf7_feature(CPUID7_EBX_AVX2, XCR0_YMM_STATE);
+}
+
+bool pg_cpu_has_avx512f(void)
+{
+    return pg_cpu_has_leaf7_feature(CPUID7_EBX_AVX512F, XCR0_ZMM_STATE);
+}
+
+#endif /* USE_X86_CPU_FEATURES */
@@ -8,8 +8,11 @@
 # this directory and SUBDIRS to subdirectories containing more things
 # to build.
 
-# append include directory about zlib1.2.7, lz4
+# append include directory about zlib1.2.7, lz4, and zstd with --with-zstd
 override CPPFLAGS += -I$(ZLIB_INCLUDE_PATH) -I$(LZ4_INCLUDE_PATH)
+ifeq ($(with_zstd), yes)
+override CPPFLAGS += -I$(ZSTD_INCLUDE_PATH)
+endif
 
 ifdef PARTIAL_LINKING
 # old style: linking using SUBSYS.o
@@ -1579,6 +1579,8 @@ static double copy_heap_data_internal(Relation OldHeap, Relation OldIndex, Relat
         ADIO_RUN()
         {
             SeqScan_Init((AbsTblScanDesc)heapScan, &scanaccessor);
+            /* let heapgetpage() adapt the prefetch distance of this scan */
+            heapScan->rs_ss_accessor = &scanaccessor;
         }
         ADIO_END();
     }
@@ -1797,6 +1797,11 @@ static void ExplainNode(
                 if (plan->parallel_aware) {
                     appendStringInfoString(es->str, "Parallel ");
                 }
+                if (IsA(plan, Agg) && ((Agg*)plan)->parallel_stage == AGG_PARALLEL_PARTIAL) {
+                    appendStringInfoString(es->str, "Partial ");
+                } else if (IsA(plan, Agg) && ((Agg*)plan)->parallel_stage == AGG_PARALLEL_FINAL) {
+                    appendStringInfoString(es->str, "Finalize ");
+                }
                 appendStringInfoString(es->str, pname);
 
                 es->indent++;
@@ -1815,6 +1820,11 @@ static void ExplainNode(
         if (plan->parallel_aware) {
             ExplainPropertyText("Parallel Aware", "true", es);
         }
+        if (IsA(plan, Agg) && ((Agg*)plan)->parallel_stage == AGG_PARALLEL_PARTIAL) {
+            ExplainPropertyText("Partial Mode", "Partial", es);
+        } else if (IsA(plan, Agg) && ((Agg*)plan)->parallel_stage == AGG_PARALLEL_FINAL) {
+            ExplainPropertyText("Partial Mode", "Finalize", es);
+        }
     }
 
     switch (nodeTag(plan)) {
@@ -2387,6 +2397,7 @@ static void ExplainNode(
             show_scan_qual(plan->qual, "Filter", planstate, ancestors, es);
             if (plan->qual)
                 show_instrumentation_count("Rows Removed by Filter", 1, planstate, es);
+            show_bloomfilter<false>(plan, planstate, ancestors, es);
             show_llvm_info(planstate, es);
             break;
         case T_Gather: {
@@ -2531,6 +2542,7 @@ static void ExplainNode(
             show_upper_qual(plan->qual, "Filter", planstate, ancestors, es);
             if (plan->qual)
                 show_instrumentation_count("Rows Removed by Filter", 2, planstate, es);
+            show_bloomfilter<true>(plan, planstate, ancestors, es);
             show_skew_optimization(planstate, es);
         } break;
         case T_VecHashJoin: {
@@ -876,12 +876,13 @@ static List* AddDefaultOptionsIfNeed(List* options, const char relkind, int8 rel
                 pg_strcasecmp(defGetString(def), COMPRESSION_YES) != 0 &&
                 pg_strcasecmp(defGetString(def), COMPRESSION_LOW) != 0 &&
                 pg_strcasecmp(defGetString(def), COMPRESSION_MIDDLE) != 0 &&
-                pg_strcasecmp(defGetString(def), COMPRESSION_HIGH) != 0) {
+                pg_strcasecmp(defGetString(def), COMPRESSION_HIGH) != 0 &&
+                pg_strcasecmp(defGetString(def), COMPRESSION_ZSTD) != 0) {
                 ereport(ERROR,
                     (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
                         errmsg("Invalid string for  \"COMPRESSION\" option"),
-                        errdetail(
-                            "Valid string are \"no\", \"yes\", \"low\", \"middle\", \"high\" for non-dfs table.")));
+                        errdetail("Valid string are \"no\", \"yes\", \"low\", \"middle\", \"high\", \"zstd\" for "
+                                  "non-dfs table.")));
             }
             hasCompression = true;
         } else if (pg_strcasecmp(def->defname, "version") == 0) {
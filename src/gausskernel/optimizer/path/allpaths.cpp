@@ -742,12 +742,95 @@ static void set_plain_rel_size(PlannerInfo* root, RelOptInfo* rel, RangeTblEntry
 /*
  * create_parallel_paths
  *	  Build parallel access paths for a plain relation
+ *
+ * A partitioned table is scanned by a parallel PartIterator instead: the
+ * participants claim whole partitions, or chunks of the big ones, and each
+ * runs an ordinary seq scan on what it got.
  */
 static void create_parallel_paths(PlannerInfo* root, RelOptInfo* rel)
 {
-    int parallel_threshold = u_sess->attr.attr_sql.min_parallel_table_scan_size;
-    int parallel_degree = 1;
-    int max_parallel_degree = u_sess->attr.attr_sql.max_parallel_workers_per_gather;
+    int parallel_degree = compute_parallel_worker(rel, rel->pages, -1, u_sess->attr.attr_sql.max_parallel_workers_per_gather);
+
+    /* Too small to be worth a parallel scan */
+    if (parallel_degree <= 0) {
+        return;
+    }
+
+    if (rel->isPartitionedTable) {
+        PartIteratorPath* itrpath = NULL;
+
+        /* Partitions of a hash-bucket table are scanned bucket by bucket */
+        if (rel->bucketInfo != NULL || rel->partItrs <= 0) {
+            return;
+        }
+
+        itrpath = makeNode(PartIteratorPath);
+        itrpath->subPath = create_seqscan_path(root, rel, NULL);
+        itrpath->path.pathtype = T_PartIterator;
+        itrpath->path.parent = rel;
+        itrpath->path.param_info = NULL;
+        itrpath->path.pathkeys = NIL;
+        itrpath->path.dop = 1;
+        itrpath->path.parallel_aware = true;
+        itrpath->path.parallel_safe = rel->consider_parallel;
+        itrpath->path.parallel_degree = parallel_degree;
+        itrpath->itrs = rel->partItrs;
+        itrpath->direction = ForwardScanDirection;
+        cost_parallel_partiterator(itrpath);
+
+        add_partial_path(rel, (Path*)itrpath);
+        return;
+    }
+
+    /* Add an unordered partial path based on a parallel sequential scan. */
+    add_partial_path(rel, create_seqscan_path(root, rel, NULL, 1, parallel_degree));
+}
+
+/*
+ * create_partial_bitmap_paths
+ *	  Build partial bitmap heap path for the relation
+ *
+ * The bitmap itself is built by a single participant, so only the heap
+ * pages it covers count towards the number of workers.
+ */
+void create_partial_bitmap_paths(PlannerInfo* root, RelOptInfo* rel, Path* bitmapqual)
+{
+    int parallel_degree;
+    double pages_fetched;
+
+    /* Compute heap pages for bitmap heap scan */
+    pages_fetched = compute_bitmap_pages(root, rel, bitmapqual, 1.0, NULL, NULL);
+
+    parallel_degree = compute_parallel_worker(
+        rel, pages_fetched, -1, u_sess->attr.attr_sql.max_parallel_workers_per_gather);
+    if (parallel_degree <= 0) {
+        return;
+    }
+
+    add_partial_path(rel, (Path*)create_bitmap_heap_path(root, rel, bitmapqual, NULL, 1.0, parallel_degree));
+}
+
+/*
+ * compute_parallel_worker
+ *	  Compute the number of parallel workers that should be used to scan a
+ *	  relation.  We compute the parallel workers based on the size of the heap
+ *	  to be scanned and the size of the index to be scanned, then choose a
+ *	  minimum of those.
+ *
+ * "heap_pages" is the number of pages from the table that we expect to scan,
+ * or -1 if we don't expect to scan any.
+ *
+ * "index_pages" is the number of pages from the index that we expect to scan,
+ * or -1 if we don't expect to scan any.
+ *
+ * "max_workers" is caller's limit on the number of workers.  This typically
+ * comes from a GUC.
+ */
+int compute_parallel_worker(RelOptInfo* rel, double heap_pages, double index_pages, int max_workers)
+{
+    int parallel_degree = 0;
+    int max_parallel_degree = max_workers;
+
     /*
      * If this relation is too small to be worth a parallel scan, just return
      * without doing anything ... unless it's an inheritance child.  In that case,
@@ -755,8 +838,10 @@ static void create_parallel_paths(PlannerInfo* root, RelOptInfo* rel)
      * just for this relation, but when combined with all of its inheritance siblings
      * it may well pay off.
      */
-    if (rel->pages < parallel_threshold && rel->reloptkind == RELOPT_BASEREL) {
-        return;
+    if (rel->reloptkind == RELOPT_BASEREL &&
+        ((heap_pages >= 0 && heap_pages < u_sess->attr.attr_sql.min_parallel_table_scan_size) ||
+            (index_pages >= 0 && index_pages < u_sess->attr.attr_sql.min_parallel_index_scan_size))) {
+        return 0;
     }
 
     /*
@@ -764,28 +849,41 @@ static void create_parallel_paths(PlannerInfo* root, RelOptInfo* rel)
      * relation.  This probably needs to be a good deal more sophisticated, but we
      * need something here for now.
      */
-    while (rel->pages > parallel_threshold * 3 && parallel_degree < max_parallel_degree) {
-        parallel_degree++;
-        parallel_threshold *= 3;
-        if (parallel_threshold >= PG_INT32_MAX / 3)
-            break;
+    if (heap_pages >= 0) {
+        int heap_parallel_threshold = u_sess->attr.attr_sql.min_parallel_table_scan_size;
+        int heap_parallel_degree = 1;
+
+        while (heap_pages > heap_parallel_threshold * 3.0 && heap_parallel_degree < max_parallel_degree) {
+            heap_parallel_degree++;
+            heap_parallel_threshold *= 3;
+            if (heap_parallel_threshold >= PG_INT32_MAX / 3)
+                break;
+        }
+
+        parallel_degree = heap_parallel_degree;
     }
 
-    /* Add an unordered partial path based on a parallel sequential scan. */
-    add_partial_path(rel, create_seqscan_path(root, rel, NULL, 1, parallel_degree));
+    if (index_pages >= 0) {
+        int index_parallel_threshold = u_sess->attr.attr_sql.min_parallel_index_scan_size;
+        int index_parallel_degree = 1;
 
-    /*
-     * If this is a baserel, consider gathering any partial paths we may have
-     * just created.  If we gathered an inheritance child, we could end up
-     * with a very large number of gather nodes, each trying to grab its own
-     * pool of workers, so don't do this in that case.  Instead, we'll
-     * consider gathering partial paths for the appendrel.
-     */
-    if (rel->reloptkind == RELOPT_BASEREL) {
-        generate_gather_paths(root, rel);
+        while (index_pages > index_parallel_threshold * 3.0 && index_parallel_degree < max_parallel_degree) {
+            index_parallel_degree++;
+            index_parallel_threshold *= 3;
+            if (index_parallel_threshold >= PG_INT32_MAX / 3)
+                break;
+        }
+
+        /* The degree is limited by whichever of the two is smaller. */
+        if (parallel_degree > 0) {
+            parallel_degree = Min(parallel_degree, index_parallel_degree);
+        } else {
+            parallel_degree = index_parallel_degree;
+        }
     }
-}
 
+    return parallel_degree;
+}
 
 /*
  * Description: Set size estimates for a sampled relation.
@@ -936,7 +1034,7 @@ static void set_plain_rel_pathlist(PlannerInfo* root, RelOptInfo* rel, RangeTblE
                     add_path(root, rel, create_seqscan_path(root, rel, NULL, u_sess->opt_cxt.query_dop));
                 }
 
-                /* Consider parallel sequential scan */
+                /* Consider parallel sequential scan; parallel index scans come below */
                 if (rel->consider_parallel) {
                     create_parallel_paths(root, rel);
                 }
@@ -963,6 +1061,18 @@ static void set_plain_rel_pathlist(PlannerInfo* root, RelOptInfo* rel, RangeTblE
             if (rel->orientation == REL_ROW_ORIENTED)
                 create_tidscan_paths(root, rel);
         }
+
+        /*
+         * If this is a baserel, consider gathering any partial paths we may have
+         * created for it, now that both the parallel seq scan and the parallel
+         * index scans are in.  If we gathered an inheritance child, we could end
+         * up with a very large number of gather nodes, each trying to grab its own
+         * pool of workers, so don't do this in that case.  Instead, we'll consider
+         * gathering partial paths for the appendrel.
+         */
+        if (rel->reloptkind == RELOPT_BASEREL) {
+            generate_gather_paths(root, rel);
+        }
 #ifdef PGXC
     } else {
         Oid relId = rte->relid;
@@ -1034,8 +1144,8 @@ static void set_rel_consider_parallel(PlannerInfo *root, RelOptInfo *rel, RangeT
             if (get_rel_persistence(rte->relid) == RELPERSISTENCE_TEMP)
                 return;
 
-            /* Don't support parallel for partitioned table. */
-            if (rte->ispartrel) {
+            /* Only row partitioned tables can be scanned by a parallel PartIterator. */
+            if (rte->ispartrel && rte->orientation != REL_ROW_ORIENTED) {
                 return;
             }
 
@@ -3111,6 +3221,11 @@ static void try_add_partiterator(PlannerInfo* root, RelOptInfo* rel, RangeTblEnt
         ListCell* ctPathCell = NULL;
         ListCell* cpPathCell = NULL;
 
+        /* Gather sits on top of a parallel PartIterator already */
+        if (T_Gather == path->pathtype) {
+            continue;
+        }
+
         /* do not handle inlist2join path for Partition Table */
         if (path->parent->base_rel && T_SubqueryScan == path->pathtype) {
             Assert(path->parent->base_rel->alternatives != NIL);
@@ -1027,6 +1027,7 @@ void cost_index(IndexPath* path, PlannerInfo* root, double loop_count)
     Cost min_IO_cost, max_IO_cost;
     QualCost qpqual_cost;
     Cost cpu_per_tuple = 0.0;
+    Cost cpu_run_cost = 0.0;
     double tuples_fetched;
     double pages_fetched;
     bool ispartitionedindex = path->indexinfo->rel->isPartitionedTable;
@@ -1217,7 +1218,21 @@ void cost_index(IndexPath* path, PlannerInfo* root, double loop_count)
     else
         cpu_per_tuple = u_sess->attr.attr_sql.cpu_tuple_cost + qpqual_cost.per_tuple;
 
-    run_cost += cpu_per_tuple * tuples_fetched;
+    cpu_run_cost = cpu_per_tuple * tuples_fetched;
+
+    /*
+     * Adjust costing for parallelism, if used.  Workers share out the leaf
+     * pages, so the CPU cost and the row count are divided among them; the
+     * disk cost is not, since heap fetches stay random per participant.
+     */
+    if (path->path.parallel_degree > 0) {
+        double parallel_divisor = get_parallel_divisor(&path->path);
+
+        path->path.rows = clamp_row_est(path->path.rows / parallel_divisor);
+        cpu_run_cost /= parallel_divisor;
+    }
+
+    run_cost += cpu_run_cost;
 
     path->path.startup_cost = startup_cost;
     path->path.total_cost = startup_cost + run_cost;
@@ -1391,9 +1406,9 @@ void cost_bitmap_heap_scan(
     Cost startup_cost = 0;
     Cost run_cost = 0;
     Cost indexTotalCost;
-    Selectivity indexSelectivity;
     QualCost qpqual_cost;
     Cost cpu_per_tuple = 0.0;
+    Cost cpu_run_cost = 0.0;
     Cost cost_per_page;
     double tuples_fetched;
     double pages_fetched;
@@ -1440,52 +1455,14 @@ void cost_bitmap_heap_scan(
         startup_cost += g_instance.cost_cxt.disable_cost;
     }
 
-    /*
-     * Fetch total cost of obtaining the bitmap, as well as its total
-     * selectivity.
-     */
-    cost_bitmap_tree_node(bitmapqual, &indexTotalCost, &indexSelectivity);
+    pages_fetched = compute_bitmap_pages(root, baserel, bitmapqual, loop_count, &indexTotalCost, &tuples_fetched);
 
     startup_cost += indexTotalCost;
+    T = (baserel->pages > 1) ? (double)baserel->pages : 1.0;
 
     /* Fetch estimated page costs for tablespace containing table. */
     get_tablespace_page_costs(baserel->reltablespace, &spc_random_page_cost, &spc_seq_page_cost);
 
-    /*
-     * Estimate number of main-table pages fetched.
-     */
-    tuples_fetched = clamp_row_est(indexSelectivity * RELOPTINFO_LOCAL_FIELD(root, baserel, tuples));
-
-    T = (baserel->pages > 1) ? (double)baserel->pages : 1.0;
-
-    if (loop_count > 1) {
-        /*
-         * For repeated bitmap scans, scale up the number of tuples fetched in
-         * the Mackert and Lohman formula by the number of scans, so that we
-         * estimate the number of pages fetched by all the scans. Then
-         * pro-rate for one scan.
-         */
-        pages_fetched = index_pages_fetched(tuples_fetched * loop_count,
-            (BlockNumber)baserel->pages,
-            get_indexpath_pages(bitmapqual),
-            root,
-            ispartitionedindex);
-
-        pages_fetched /= loop_count;
-    } else {
-        /*
-         * For a single scan, the number of heap pages that need to be fetched
-         * is the same as the Mackert and Lohman formula for the case T <= b
-         * (ie, no re-reads needed).
-         */
-        pages_fetched = (2.0 * T * tuples_fetched) / (2.0 * T + tuples_fetched);
-    }
-    if (pages_fetched >= T) {
-        pages_fetched = T;
-    } else {
-        pages_fetched = ceil(pages_fetched);
-    }
-
     /*
      * For small numbers of pages we should charge spc_random_page_cost
      * apiece, while if nearly all the table's pages are being read, it's more
@@ -1513,8 +1490,22 @@ void cost_bitmap_heap_scan(
 
     startup_cost += qpqual_cost.startup;
     cpu_per_tuple = u_sess->attr.attr_sql.cpu_tuple_cost + qpqual_cost.per_tuple;
+    cpu_run_cost = cpu_per_tuple * tuples_fetched;
 
-    run_cost += cpu_per_tuple * tuples_fetched;
+    /*
+     * Adjust costing for parallelism, if used.  The heap pages are shared
+     * out among the workers, so the CPU cost and the row count are divided;
+     * the bitmap is built only once, and the page fetches stay random, so
+     * the disk cost is left alone.
+     */
+    if (path->parallel_degree > 0) {
+        double parallel_divisor = get_parallel_divisor(path);
+
+        path->rows = clamp_row_est(path->rows / parallel_divisor);
+        cpu_run_cost /= parallel_divisor;
+    }
+
+    run_cost += cpu_run_cost;
 
     path->startup_cost = startup_cost;
     path->total_cost = startup_cost + run_cost;
@@ -1525,6 +1516,74 @@ void cost_bitmap_heap_scan(
             (g_instance.cost_cxt.disable_cost_enlarge_factor * g_instance.cost_cxt.disable_cost_enlarge_factor);
 }
 
+/*
+ * compute_bitmap_pages
+ *	  Estimate the number of heap pages a bitmap heap scan fetches.
+ *
+ * If cost or tuple is not NULL, the total cost of obtaining the bitmap and
+ * the number of tuples fetched are returned there too.
+ */
+double compute_bitmap_pages(
+    PlannerInfo* root, RelOptInfo* baserel, Path* bitmapqual, double loop_count, Cost* cost, double* tuple)
+{
+    Cost indexTotalCost;
+    Selectivity indexSelectivity;
+    double tuples_fetched;
+    double pages_fetched;
+    double T;
+    bool ispartitionedindex = baserel->isPartitionedTable;
+
+    /*
+     * Fetch total cost of obtaining the bitmap, as well as its total
+     * selectivity.
+     */
+    cost_bitmap_tree_node(bitmapqual, &indexTotalCost, &indexSelectivity);
+
+    /*
+     * Estimate number of main-table pages fetched.
+     */
+    tuples_fetched = clamp_row_est(indexSelectivity * RELOPTINFO_LOCAL_FIELD(root, baserel, tuples));
+
+    T = (baserel->pages > 1) ? (double)baserel->pages : 1.0;
+
+    if (loop_count > 1) {
+        /*
+         * For repeated bitmap scans, scale up the number of tuples fetched in
+         * the Mackert and Lohman formula by the number of scans, so that we
+         * estimate the number of pages fetched by all the scans. Then
+         * pro-rate for one scan.
+         */
+        pages_fetched = index_pages_fetched(tuples_fetched * loop_count,
+            (BlockNumber)baserel->pages,
+            get_indexpath_pages(bitmapqual),
+            root,
+            ispartitionedindex);
+
+        pages_fetched /= loop_count;
+    } else {
+        /*
+         * For a single scan, the number of heap pages that need to be fetched
+         * is the same as the Mackert and Lohman formula for the case T <= b
+         * (ie, no re-reads needed).
+         */
+        pages_fetched = (2.0 * T * tuples_fetched) / (2.0 * T + tuples_fetched);
+    }
+    if (pages_fetched >= T) {
+        pages_fetched = T;
+    } else {
+        pages_fetched = ceil(pages_fetched);
+    }
+
+    if (cost != NULL) {
+        *cost = indexTotalCost;
+    }
+    if (tuple != NULL) {
+        *tuple = tuples_fetched;
+    }
+
+    return pages_fetched;
+}
+
 /*
  * cost_bitmap_tree_node
  *		Extract cost and selectivity from a bitmap tree node (index/and/or)
@@ -1739,6 +1798,26 @@ void cost_tidscan(Path* path, PlannerInfo* root, RelOptInfo* baserel, List* tidq
             (g_instance.cost_cxt.disable_cost_enlarge_factor * g_instance.cost_cxt.disable_cost_enlarge_factor);
 }
 
+/*
+ * cost_parallel_partiterator
+ *	  Determines and returns the cost of a parallel PartIterator.
+ *
+ * The participants share out the partitions the serial subpath scans one
+ * after another, so each of them does its share of the subpath's run cost
+ * and returns its share of the rows.
+ */
+void cost_parallel_partiterator(PartIteratorPath* path)
+{
+    Path* subpath = path->subPath;
+    double parallel_divisor = get_parallel_divisor(&path->path);
+
+    Assert(path->path.parallel_degree > 0);
+
+    path->path.startup_cost = subpath->startup_cost;
+    path->path.total_cost = subpath->startup_cost + (subpath->total_cost - subpath->startup_cost) / parallel_divisor;
+    set_path_rows(&path->path, clamp_row_est(subpath->rows / parallel_divisor), subpath->multiple);
+}
+
 /*
  * cost_subqueryscan
  *	  Determines and returns the cost of scanning a subquery RTE.
@@ -96,6 +96,7 @@ static void get_join_index_paths(PlannerInfo* root, RelOptInfo* rel, IndexOptInf
     List** considered_relids);
 static bool eclass_already_used(EquivalenceClass* parent_ec, Relids oldrelids, List* indexjoinclauses);
 static bool bms_equal_any(Relids relids, List* relids_list);
+static inline bool index_relation_has_bucket(IndexOptInfo* index);
 static void get_index_paths(
     PlannerInfo* root, RelOptInfo* rel, IndexOptInfo* index, IndexClauseSet* clauses, List** bitindexpaths);
 static List* build_index_paths(PlannerInfo* root, RelOptInfo* rel, IndexOptInfo* index, IndexClauseSet* clauses,
@@ -281,6 +282,17 @@ void create_index_paths(PlannerInfo* root, RelOptInfo* rel)
         bitmapqual = choose_bitmap_and(root, rel, bitindexpaths);
         bpath = create_bitmap_heap_path(root, rel, bitmapqual, NULL, 1.0);
         add_path(root, rel, (Path*)bpath);
+
+        /*
+         * Consider a parallel bitmap heap scan too.  Bucketed relations scan
+         * the bitmap bucket by bucket, which the shared iteration does not
+         * handle, so they are left to the serial scan.  So are partitioned
+         * relations, which go parallel through the PartIterator.
+         */
+        if (rel->consider_parallel && rel->orientation == REL_ROW_ORIENTED && !rel->isPartitionedTable &&
+            !index_relation_has_bucket((IndexOptInfo*)linitial(rel->indexlist))) {
+            create_partial_bitmap_paths(root, rel, bitmapqual);
+        }
     }
 
     /*
@@ -741,6 +753,7 @@ static List* build_index_paths(PlannerInfo* root, RelOptInfo* rel, IndexOptInfo*
     List* index_pathkeys = NIL;
     List* useful_pathkeys = NIL;
     bool found_clause = false;
+    bool found_saop_clause = false;
     bool found_lower_saop_clause = false;
     bool pathkeys_possibly_useful = false;
     bool index_is_ordered = false;
@@ -806,6 +819,7 @@ static List* build_index_paths(PlannerInfo* root, RelOptInfo* rel, IndexOptInfo*
                 if (saop_control == SAOP_PER_AM && !index->amsearcharray)
                     continue;
                 found_clause = true;
+                found_saop_clause = true;
                 if (indexcol > 0)
                     found_lower_saop_clause = true;
             } else {
@@ -898,6 +912,37 @@ static List* build_index_paths(PlannerInfo* root, RelOptInfo* rel, IndexOptInfo*
             outer_relids,
             loop_count);
         result = lappend(result, ipath);
+
+        /*
+         * If appropriate, consider parallel index scan.  Only unparameterized
+         * forward scans over plain row tables are shared among workers, and
+         * array keys would need the participants to advance them in lockstep,
+         * so ScalarArrayOpExpr quals are left to the serial scan.  We don't
+         * allow parallel index scan for bitmap index scans, nor for
+         * partitioned relations.
+         */
+        if (index->amcanparallel && rel->consider_parallel && outer_relids == NULL && scantype != ST_BITMAPSCAN &&
+            rel->orientation == REL_ROW_ORIENTED && !rel->isPartitionedTable && !relHasbkt && !index->isGlobal &&
+            !found_saop_clause) {
+            int parallel_degree =
+                compute_parallel_worker(rel, -1, index->pages, u_sess->attr.attr_sql.max_parallel_workers_per_gather);
+
+            if (parallel_degree > 0) {
+                ipath = create_index_path(root,
+                    index,
+                    index_clauses,
+                    clause_columns,
+                    orderbyclauses,
+                    orderbyclausecols,
+                    NIL,
+                    index_is_ordered ? ForwardScanDirection : NoMovementScanDirection,
+                    index_only_scan,
+                    outer_relids,
+                    loop_count,
+                    parallel_degree);
+                add_partial_path(rel, (Path*)ipath);
+            }
+        }
     }
 
     /*
@@ -870,9 +870,13 @@ static void try_hashjoin_path(PlannerInfo* root, RelOptInfo* joinrel, JoinType j
  * try_partial_hashjoin_path
  *	  Consider a partial hashjoin join path; if it appears useful, push it into
  *	  the joinrel's partial_pathlist via add_partial_path().
+ *
+ * If parallel_hash is true, inner_path is partial as well and the participants
+ * build one shared hash table from it instead of each hashing the whole inner
+ * relation.
  */
 static void try_partial_hashjoin_path(PlannerInfo* root, RelOptInfo* joinrel, Path* outer_path, Path* inner_path,
-    List* hashclauses, JoinType jointype, JoinPathExtraData* extra)
+    List* hashclauses, JoinType jointype, JoinPathExtraData* extra, bool parallel_hash)
 {
     JoinCostWorkspace workspace;
 
@@ -900,6 +904,16 @@ static void try_partial_hashjoin_path(PlannerInfo* root, RelOptInfo* joinrel, Pa
         return;
     }
 
+    /*
+     * The shared hash table is never split into batches, so only use it when
+     * the inner relation is expected to fit.  Since the inner path is partial,
+     * the estimate above compared one participant's share of the inner rows
+     * with one participant's work_mem.
+     */
+    if (parallel_hash && workspace.numbatches > 1) {
+        return;
+    }
+
     /* Might be good enough to be worth trying, so let's try it. */
     add_partial_path(joinrel,
         (Path*)create_hashjoin_path(root,
@@ -912,7 +926,9 @@ static void try_partial_hashjoin_path(PlannerInfo* root, RelOptInfo* joinrel, Pa
             inner_path,
             extra->restrictlist,
             NULL,
-            hashclauses));
+            hashclauses,
+            1,
+            parallel_hash));
 }
 
 /*
@@ -1834,8 +1850,38 @@ static void hash_inner_and_outer(PlannerInfo* root, RelOptInfo* joinrel, RelOptI
                     }
 
                     if (cheapest_safe_inner != NULL) {
-                        try_partial_hashjoin_path(
-                            root, joinrel, cheapest_partial_outer, cheapest_safe_inner, hashclauses, jointype, extra);
+                        try_partial_hashjoin_path(root,
+                            joinrel,
+                            cheapest_partial_outer,
+                            cheapest_safe_inner,
+                            hashclauses,
+                            jointype,
+                            extra,
+                            false);
+                    }
+
+                    /*
+                     * If the inner rel has a partial path too, consider a
+                     * parallel-aware hash join, where the participants split
+                     * the work of building one shared hash table.  Join types
+                     * that need to track or remove matched inner tuples are
+                     * not supported by the shared table, and neither is
+                     * unique-ifying the partial inner side.
+                     */
+                    if (u_sess->attr.attr_sql.enable_parallel_hash && innerrel->partial_pathlist != NIL &&
+                        save_jointype != JOIN_UNIQUE_INNER &&
+                        (jointype == JOIN_INNER || jointype == JOIN_LEFT || jointype == JOIN_SEMI ||
+                            jointype == JOIN_ANTI || jointype == JOIN_LEFT_ANTI_FULL)) {
+                        Path* cheapest_partial_inner = (Path*)linitial(innerrel->partial_pathlist);
+
+                        try_partial_hashjoin_path(root,
+                            joinrel,
+                            cheapest_partial_outer,
+                            cheapest_partial_inner,
+                            hashclauses,
+                            jointype,
+                            extra,
+                            true);
                     }
                 }
             }
@@ -57,6 +57,7 @@
 #include "parser/parse_expr.h"
 #include "parser/parse_relation.h"
 #include "parser/parsetree.h"
+#include "utils/bloom_filter.h"
 #include "utils/guc.h"
 #include "utils/lsyscache.h"
 #include "utils/selfuncs.h"
@@ -4308,6 +4309,11 @@ static void search_var_and_mark_bloomfilter(PlannerInfo* root, Expr* expr, Plan*
     switch (nodeTag(plan)) {
         case T_ForeignScan:
         case T_DfsScan: {
+            /* Readers of HDFS/OBS files only get filters in stream plans. */
+            if (!IS_STREAM_PLAN) {
+                return;
+            }
+
             if (IsA(plan, ForeignScan)) {
                 ForeignScan* splan = (VecForeignScan*)plan;
 
@@ -4332,6 +4338,29 @@ static void search_var_and_mark_bloomfilter(PlannerInfo* root, Expr* expr, Plan*
 
             break;
         }
+        case T_SeqScan:
+        case T_CStoreScan: {
+            /*
+             * Row and column store scans probe the filter with the scanned datum as is,
+             * so only mark user columns of a type that allows that.
+             */
+            if (!u_sess->attr.attr_sql.enable_scan_runtime_filter || !IsA(expr, Var) || ((Var*)expr)->varattno <= 0 ||
+                !SATISFY_RUNTIME_FILTER(((Var*)expr)->vartype)) {
+                return;
+            }
+
+            if (find_var_from_targetlist(expr, plan->targetlist)) {
+                if (context->add_index) {
+                    context->bloomfilter_index++;
+                    context->add_index = false;
+                }
+
+                plan->var_list = lappend(plan->var_list, copyObject(expr));
+                plan->filterIndexList = lappend_int(plan->filterIndexList, context->bloomfilter_index);
+            }
+
+            break;
+        }
         case T_NestLoop:
         case T_MergeJoin:
         case T_HashJoin: {
@@ -4692,9 +4721,15 @@ static HashJoin* create_hashjoin_plan(PlannerInfo* root, HashPath* best_path, Pl
     join_plan->join.plan.dop = best_path->jpath.path.dop;
     hash_plan->plan.dop = best_path->jpath.path.dop;
 
+    /* A parallel-aware hash join builds a shared table through its Hash node */
+    if (best_path->jpath.path.parallel_aware) {
+        hash_plan->plan.parallel_aware = true;
+    }
+
     join_plan->isSonicHash = u_sess->attr.attr_sql.enable_sonic_hashjoin && isSonicHashJoinEnable(join_plan);
 
-    if (IS_STREAM_PLAN && u_sess->attr.attr_sql.enable_bloom_filter) {
+    if (u_sess->attr.attr_sql.enable_bloom_filter &&
+        (IS_STREAM_PLAN || u_sess->attr.attr_sql.enable_scan_runtime_filter)) {
         left_relids = best_path->jpath.outerjoinpath->parent->relids;
         set_bloomfilter(root, left_relids, join_plan);
     }
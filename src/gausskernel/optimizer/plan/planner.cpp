@@ -19,12 +19,15 @@
 #include <limits.h>
 #include <math.h>
 
+#include "access/genam.h"
 #include "access/parallel.h"
 #include "access/transam.h"
 #include "catalog/indexing.h"
+#include "catalog/pg_aggregate.h"
 #include "catalog/pg_cast.h"
 #include "catalog/pg_operator.h"
 #include "catalog/pg_constraint.h"
+#include "catalog/pg_type.h"
 #include "catalog/pgxc_group.h"
 #include "catalog/pgxc_node.h"
 #include "executor/executor.h"
@@ -186,15 +189,20 @@ static Plan* mark_agg_stream(PlannerInfo* root, List* tlist, Plan* plan, List* g
 static Plan* mark_top_agg(
     PlannerInfo* root, List* tlist, Plan* agg_plan, Plan* sub_plan, AggOrientation agg_orientation);
 static Plan* mark_group_stream(PlannerInfo* root, List* tlist, Plan* result_plan);
+static bool aggref_supports_partial(Aggref* aggref);
+static Plan* make_parallel_agg(PlannerInfo* root, Agg* agg, const AggClauseCosts* aggcosts, Size hash_entry_size);
 static List* append_distribute_var_list(List* varlist, Node* tlist_node);
 static Plan* mark_distinct_stream(
     PlannerInfo* root, List* tlist, Plan* plan, List* groupcls, Index query_level, List* current_pathkeys);
 static List* get_optimal_distribute_key(PlannerInfo* root, List* groupClause, Plan* plan, double* multiple);
 static bool vector_engine_expression_walker(Node* node, DenseRank_context* context);
-static bool vector_engine_walker(Plan* result_plan, bool check_rescan);
+static bool vector_engine_walker(Plan* result_plan, bool check_rescan, bool allow_row_scan);
 static Plan* fallback_plan(Plan* result_plan);
-static Plan* vectorize_plan(Plan* result_plan, bool ignore_remotequery);
+static Plan* vectorize_plan(Plan* result_plan, bool ignore_remotequery, bool allow_row_scan);
 static Plan* build_vector_plan(Plan* plan);
+static bool row_scan_vectorizable(Plan* plan, bool allow_row_scan);
+static bool row_plan_prefer_vector_engine(Plan* top_plan, bool allow_row_scan);
+static Plan* vectorize_row_scan(Plan* scan);
 static Plan* mark_windowagg_stream(
     PlannerInfo* root, Plan* plan, List* tlist, WindowClause* wc, List* pathkeys, WindowLists* wflists);
 static uint32 get_hashagg_skew(AggSkewInfo* skew_info, List* distribute_keys);
@@ -3059,6 +3067,9 @@ static Plan* grouping_planner(PlannerInfo* root, double tuple_fraction)
                             false,
                             hash_entry_size);
 
+                        /* Aggregate in the workers if the input comes from a Gather */
+                        result_plan = make_parallel_agg(root, (Agg*)result_plan, &agg_costs, hash_entry_size);
+
                         next_is_second_level_group = true;
                     }
 
@@ -3326,6 +3337,9 @@ static Plan* grouping_planner(PlannerInfo* root, double tuple_fraction)
                         NIL,
                         0,
                         true);
+
+                    /* Aggregate in the workers if the input comes from a Gather */
+                    result_plan = make_parallel_agg(root, (Agg*)result_plan, &agg_costs, 0);
                 }
                 next_is_second_level_group = true;
 
@@ -7080,6 +7094,101 @@ bool plan_cluster_use_sort(Oid tableOid, Oid indexOid)
     return (seqScanAndSortPath.total_cost < indexScanPath->path.total_cost);
 }
 
+/*
+ * plan_create_index_workers
+ *		Use the planner to decide how many parallel worker threads CREATE
+ *		INDEX should request for use
+ *
+ * tableOid is the table on which the index is to be built.  indexOid is the
+ * OID of an index to be created or reindexed (which must be a btree index).
+ *
+ * Return value is the number of parallel workers to request.  It may be
+ * unsafe to proceed if this is 0.  Note that this does not include the
+ * leader participating as a worker (value is always a number of parallel
+ * worker threads).
+ *
+ * Note: caller had better already hold some type of lock on the table and
+ * index.
+ */
+int plan_create_index_workers(Oid tableOid, Oid indexOid)
+{
+    PlannerInfo* root = NULL;
+    Query* query = NULL;
+    PlannerGlobal* glob = NULL;
+    RangeTblEntry* rte = NULL;
+    Relation heap;
+    Relation index;
+    RelOptInfo* rel = NULL;
+    int parallel_workers = 0;
+    int64 sortmem = u_sess->attr.attr_memory.maintenance_work_mem;
+
+    /* Return immediately when parallelism disabled */
+    if (u_sess->attr.attr_sql.max_parallel_maintenance_workers == 0)
+        return 0;
+
+    heap = heap_open(tableOid, NoLock);
+    index = index_open(indexOid, NoLock);
+
+    /*
+     * Determine if it's safe to proceed.
+     *
+     * Currently, parallel workers can't access the leader's temporary tables.
+     * Furthermore, any index predicate or index expressions must be parallel
+     * safe, since the workers evaluate them.
+     */
+    if (!RelationUsesLocalBuffers(heap) &&
+        !has_parallel_hazard((Node*)RelationGetIndexExpressions(index), false) &&
+        !has_parallel_hazard((Node*)RelationGetIndexPredicate(index), false)) {
+        /* Set up mostly-dummy planner state */
+        query = makeNode(Query);
+        query->commandType = CMD_SELECT;
+
+        glob = makeNode(PlannerGlobal);
+
+        root = makeNode(PlannerInfo);
+        root->parse = query;
+        root->glob = glob;
+        root->query_level = 1;
+        root->planner_cxt = CurrentMemoryContext;
+        root->wt_param_id = -1;
+
+        /* Build a minimal RTE for the rel */
+        rte = makeNode(RangeTblEntry);
+        rte->rtekind = RTE_RELATION;
+        rte->relid = tableOid;
+        rte->relkind = RELKIND_RELATION;
+        rte->inh = false;
+        rte->inFromCl = true;
+        query->rtable = list_make1(rte);
+
+        /* Set up RTE/RelOptInfo arrays, and build RelOptInfo */
+        setup_simple_rel_arrays(root);
+        rel = build_simple_rel(root, 1, RELOPT_BASEREL);
+
+        /* Determine number of workers to scan the heap relation using generic model */
+        parallel_workers =
+            compute_parallel_worker(rel, rel->pages, -1, u_sess->attr.attr_sql.max_parallel_maintenance_workers);
+
+        /*
+         * Cap workers based on available maintenance_work_mem as needed.
+         *
+         * Note that each tuplesort participant receives an even share of the
+         * total maintenance_work_mem budget.  Aim to leave participants
+         * (including the leader as a participant) with no less than 32MB of
+         * memory.  This leaves cases where maintenance_work_mem is set to
+         * 64MB immediately past the threshold of being capable of launching
+         * a single parallel worker to sort.
+         */
+        while (parallel_workers > 0 && sortmem / (parallel_workers + 1) < 32768L)
+            parallel_workers--;
+    }
+
+    index_close(index, NoLock);
+    heap_close(heap, NoLock);
+
+    return parallel_workers;
+}
+
 /*
  * @@GaussDB@@
  * Target       : data partition
@@ -7392,6 +7501,202 @@ static Plan* mark_agg_stream(PlannerInfo* root, List* tlist, Plan* plan, List* g
     return mark_top_agg(root, tlist, plan, streamplan, agg_orientation);
 }
 
+/*
+ * aggref_supports_partial
+ *	  Can this aggregate be split into a Partial and a Finalize step?
+ *
+ * The Finalize Agg combines the participants' transition values with the
+ * aggregate's collection function, and the values travel from the workers
+ * in ordinary tuples, so the transition type must be a concrete SQL type.
+ */
+static bool aggref_supports_partial(Aggref* aggref)
+{
+    if (aggref->aggdistinct != NIL || aggref->aggorder != NIL || aggref->aggdirectargs != NIL) {
+        return false;
+    }
+
+    if (aggref->aggkind != AGGKIND_NORMAL || aggref->aggstage != 0 || !aggref->agghas_collectfn) {
+        return false;
+    }
+
+    if (aggref->aggtrantype == INTERNALOID || IsPolymorphicType(aggref->aggtrantype)) {
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * make_parallel_agg
+ *	  Try to split an Agg that sits directly on a Gather into a Partial Agg
+ *	  below the Gather and a Finalize Agg above it.
+ *
+ * Each participant then aggregates its own share of the input, and only
+ * one row per group and participant has to cross the Gather, instead of
+ * every input row.  The Partial Agg returns the aggregates' transition
+ * values (see set_parallel_agg_references for how the Finalize Agg finds
+ * them).  Returns the Finalize Agg if the split is possible and cheaper,
+ * otherwise the original Agg.
+ */
+static Plan* make_parallel_agg(PlannerInfo* root, Agg* agg, const AggClauseCosts* aggcosts, Size hash_entry_size)
+{
+    Plan* plan = (Plan*)agg;
+    Gather* gather = NULL;
+    Gather* partial_gather = NULL;
+    Plan* subplan = NULL;
+    List* aggs_n_vars = NIL;
+    List* group_exprs = NIL;
+    List* group_vars = NIL;
+    List* partial_tlist = NIL;
+    AttrNumber* grpColIdx = NULL;
+    Agg* partial_agg = NULL;
+    Agg* final_agg = NULL;
+    ListCell* lc = NULL;
+    double gather_rows;
+    int i;
+    errno_t rc = EOK;
+
+    if (plan->lefttree == NULL || !IsA(plan->lefttree, Gather) || agg->groupingSets != NIL) {
+        return plan;
+    }
+    if (agg->aggstrategy != AGG_PLAIN && agg->aggstrategy != AGG_HASHED) {
+        return plan;
+    }
+
+    gather = (Gather*)plan->lefttree;
+    subplan = gather->plan.lefttree;
+    if (gather->single_copy || !is_projection_capable_plan(subplan)) {
+        return plan;
+    }
+
+    /*
+     * Build the Partial Agg's targetlist: the grouping columns, any Vars the
+     * Finalize Agg uses outside of aggregates, and the aggregates themselves,
+     * returning their transition type.
+     */
+    grpColIdx = (AttrNumber*)palloc(sizeof(AttrNumber) * agg->numCols);
+    for (i = 0; i < agg->numCols; i++) {
+        TargetEntry* tle = get_tle_by_resno(gather->plan.targetlist, agg->grpColIdx[i]);
+        TargetEntry* partial_tle = NULL;
+
+        AssertEreport(tle != NULL, MOD_OPT, "grouping column not found in the targetlist of Gather");
+        partial_tle = tlist_member((Node*)tle->expr, partial_tlist);
+        if (partial_tle == NULL) {
+            partial_tle =
+                makeTargetEntry((Expr*)copyObject(tle->expr), list_length(partial_tlist) + 1, NULL, false);
+            partial_tle->ressortgroupref = tle->ressortgroupref;
+            partial_tlist = lappend(partial_tlist, partial_tle);
+        }
+        grpColIdx[i] = partial_tle->resno;
+        group_exprs = lappend(group_exprs, tle->expr);
+    }
+    group_vars = pull_var_clause((Node*)group_exprs, PVC_REJECT_AGGREGATES, PVC_INCLUDE_PLACEHOLDERS);
+
+    aggs_n_vars = pull_var_clause((Node*)list_concat(list_copy(plan->targetlist), list_copy(plan->qual)),
+        PVC_INCLUDE_AGGREGATES,
+        PVC_INCLUDE_PLACEHOLDERS);
+    foreach (lc, aggs_n_vars) {
+        Node* node = (Node*)lfirst(lc);
+
+        if (IsA(node, Aggref)) {
+            Aggref* partial_aggref = NULL;
+
+            if (!aggref_supports_partial((Aggref*)node)) {
+                return plan;
+            }
+            partial_aggref = (Aggref*)copyObject(node);
+            partial_aggref->aggtype = partial_aggref->aggtrantype;
+            node = (Node*)partial_aggref;
+        } else if (!IsA(node, Var) && !IsA(node, PlaceHolderVar)) {
+            /* GROUPING() and the like are not supported */
+            return plan;
+        } else if (list_member(group_vars, node)) {
+            /* computed from a grouping column above the Gather */
+            continue;
+        }
+
+        if (tlist_member(node, partial_tlist) == NULL) {
+            partial_tlist = lappend(
+                partial_tlist, makeTargetEntry((Expr*)copyObject(node), list_length(partial_tlist) + 1, NULL, false));
+        }
+    }
+
+    /* The Partial Agg runs in the workers, so it must be safe to run there. */
+    if (has_parallel_hazard((Node*)partial_tlist, false) || expression_returns_set((Node*)partial_tlist)) {
+        return plan;
+    }
+
+    partial_agg = make_agg(root,
+        partial_tlist,
+        NIL,
+        agg->aggstrategy,
+        aggcosts,
+        agg->numCols,
+        agg->grpColIdx,
+        agg->grpOperators,
+        agg->numGroups,
+        subplan,
+        NULL,
+        false,
+        true,
+        NIL,
+        hash_entry_size,
+        true);
+    partial_agg->parallel_stage = AGG_PARALLEL_PARTIAL;
+
+    /*
+     * Gather the partial results instead, costed the same way cost_gather
+     * does, assuming every participant returns all of its groups.
+     */
+    gather_rows = clamp_row_est(partial_agg->plan.plan_rows * (gather->num_workers + 1));
+
+    partial_gather = makeNode(Gather);
+    rc = memcpy_s(partial_gather, sizeof(Gather), gather, sizeof(Gather));
+    securec_check(rc, "\0", "\0");
+    partial_gather->plan.targetlist = (List*)copyObject(partial_tlist);
+    partial_gather->plan.lefttree = (Plan*)partial_agg;
+    set_plan_rows(&partial_gather->plan, gather_rows, gather->plan.multiple);
+    partial_gather->plan.plan_width = partial_agg->plan.plan_width;
+    partial_gather->plan.startup_cost =
+        partial_agg->plan.startup_cost + u_sess->attr.attr_sql.parallel_setup_cost;
+    partial_gather->plan.total_cost = partial_agg->plan.total_cost + u_sess->attr.attr_sql.parallel_setup_cost +
+                                      u_sess->attr.attr_sql.parallel_tuple_cost * gather_rows;
+
+    final_agg = make_agg(root,
+        plan->targetlist,
+        (List*)copyObject(plan->qual),
+        agg->aggstrategy,
+        aggcosts,
+        agg->numCols,
+        grpColIdx,
+        agg->grpOperators,
+        agg->numGroups,
+        (Plan*)partial_gather,
+        NULL,
+        false,
+        true,
+        NIL,
+        hash_entry_size,
+        false);
+    final_agg->plan.plan_width = plan->plan_width;
+    final_agg->is_final = true;
+    final_agg->parallel_stage = AGG_PARALLEL_FINAL;
+
+    if (final_agg->plan.total_cost >= plan->total_cost) {
+        return plan;
+    }
+
+    /*
+     * The Partial Agg's grouping column indexes refer to the Gather's
+     * targetlist, so let the Gather's child project it.
+     */
+    if (!equal(subplan->targetlist, gather->plan.targetlist)) {
+        subplan->targetlist = gather->plan.targetlist;
+    }
+
+    return (Plan*)final_agg;
+}
+
 static Plan* mark_group_stream(PlannerInfo* root, List* tlist, Plan* result_plan)
 {
     Plan* streamplan = NULL;
@@ -7992,6 +8297,124 @@ static bool has_column_store_relation(Plan* top_plan)
     return false;
 }
 
+/*
+ * Input rows above which an aggregation over row relations is run in the
+ * vector engine when try_vector_engine_strategy is optimal.
+ */
+#define VECTOR_ENGINE_OPT_AGG_ROWS 100000
+
+/*
+ * @Description: Check if the plan aggregates enough rows for the vector engine
+ *               to pay off the cost of converting them into batches
+ *
+ * @param[IN] plan:  current plan node
+ * @return: bool, true if there is such an aggregation
+ */
+static bool has_large_aggregation(Plan* plan)
+{
+    if (plan == NULL)
+        return false;
+
+    if (IsA(plan, Agg) && plan->lefttree != NULL && plan->lefttree->plan_rows >= VECTOR_ENGINE_OPT_AGG_ROWS)
+        return true;
+
+    switch (nodeTag(plan)) {
+        case T_Append: {
+            ListCell* lc = NULL;
+            foreach (lc, ((Append*)plan)->appendplans) {
+                if (has_large_aggregation((Plan*)lfirst(lc)))
+                    return true;
+            }
+        } break;
+        case T_ModifyTable: {
+            ListCell* lc = NULL;
+            foreach (lc, ((ModifyTable*)plan)->plans) {
+                if (has_large_aggregation((Plan*)lfirst(lc)))
+                    return true;
+            }
+        } break;
+        case T_SubqueryScan:
+            return has_large_aggregation(((SubqueryScan*)plan)->subplan);
+        default:
+            break;
+    }
+
+    return has_large_aggregation(plan->lefttree) || has_large_aggregation(plan->righttree);
+}
+
+/*
+ * @Description: Check if a plan without column store relation should try the
+ *               vector engine, according to try_vector_engine_strategy
+ *
+ * @param[IN] top_plan:  current plan node
+ * @param[IN] allow_row_scan:  if row scans may feed the vector engine
+ * @return: bool, true if the plan should be vectorized
+ */
+static bool row_plan_prefer_vector_engine(Plan* top_plan, bool allow_row_scan)
+{
+    if (!allow_row_scan)
+        return false;
+
+    switch (u_sess->attr.attr_sql.vector_engine_strategy) {
+        case FORCE_VECTOR_ENGINE:
+            return true;
+        case OPT_VECTOR_ENGINE:
+            return has_large_aggregation(top_plan);
+        default:
+            return false;
+    }
+}
+
+/*
+ * @Description: Check if a row SeqScan can feed the vector engine
+ *
+ * @param[IN] plan:  SeqScan plan node
+ * @param[IN] allow_row_scan:  if row scans may feed the vector engine
+ * @return: bool, true if a Vector Adapter can be put on top of it
+ */
+static bool row_scan_vectorizable(Plan* plan, bool allow_row_scan)
+{
+    Scan* scan = (Scan*)plan;
+
+    Assert(IsA(plan, SeqScan));
+    if (!allow_row_scan ||
+        u_sess->attr.attr_sql.vector_engine_strategy == OFF_VECTOR_ENGINE)
+        return false;
+
+    /* the partition iterator drives partitioned scans directly, and sampling is not batched */
+    return !scan->isPartTbl && scan->tablesample == NULL;
+}
+
+/*
+ * @Description: Put a row SeqScan under the vector engine.  Its quals are
+ *               lifted into a Vector Result above the Vector Adapter, so that
+ *               they are evaluated over whole batches, and the scan returns
+ *               the columns those quals need.
+ *
+ * @param[IN] scan:  SeqScan plan node
+ * @return: Plan*, vectorized plan
+ */
+static Plan* vectorize_row_scan(Plan* scan)
+{
+    List* tlist = scan->targetlist;
+    List* qual = scan->qual;
+    Plan* result_plan = NULL;
+
+    /* keep quals referring to params or subplans where the row engine evaluates them */
+    if (qual == NIL || contain_subplans((Node*)qual) || !bms_is_empty(scan->allParam)) {
+        make_dummy_targetlist(scan);
+        return (Plan*)make_rowtovec(scan);
+    }
+
+    List* qual_vars = pull_var_clause((Node*)qual, PVC_REJECT_AGGREGATES, PVC_INCLUDE_PLACEHOLDERS);
+    scan->targetlist = add_to_flat_tlist((List*)copyObject(tlist), qual_vars);
+    scan->qual = NIL;
+    list_free_ext(qual_vars);
+
+    result_plan = (Plan*)make_result(NULL, tlist, NULL, (Plan*)make_rowtovec(scan), qual);
+    return build_vector_plan(result_plan);
+}
+
 /*
  * @Description: Check if it is vetor scan
  *
@@ -8072,15 +8495,25 @@ bool vector_engine_unsupport_expression_walker(Node* node)
  */
 Plan* try_vectorize_plan(Plan* top_plan, Query* parse, bool from_subplan, PlannerInfo* subroot)
 {
-    /* If has no column store relation, just leave unchanged */
-    if (!has_column_store_relation(top_plan))
+    /*
+     * try_vector_engine_strategy only applies to plain queries.  The ctid junk
+     * columns and row marks of UPDATE, DELETE and SELECT FOR UPDATE/SHARE, and
+     * their EvalPlanQual recheck, are left to the row engine.
+     */
+    bool allow_row_scan = (parse->commandType == CMD_SELECT && parse->rowMarks == NIL);
+
+    /*
+     * If has no column store relation, just leave unchanged, unless
+     * try_vector_engine_strategy asks to run the row relations in the vector engine.
+     */
+    if (!has_column_store_relation(top_plan) && !row_plan_prefer_vector_engine(top_plan, allow_row_scan))
         return top_plan;
 
     /*
      * Fallback to original non-vectorized plan, if either the GUC 'enable_vector_engine'
      * is turned off or the plan cannot go through vector_engine_walker.
      */
-    if (!u_sess->attr.attr_sql.enable_vector_engine || vector_engine_walker(top_plan, from_subplan) ||
+    if (!u_sess->attr.attr_sql.enable_vector_engine || vector_engine_walker(top_plan, from_subplan, allow_row_scan) ||
         (subroot != NULL && subroot->is_under_recursive_tree)) {
         /*
          * Distributed Recursive CTE Support
@@ -8098,7 +8531,7 @@ Plan* try_vectorize_plan(Plan* top_plan, Query* parse, bool from_subplan, Planne
          */
         top_plan = fallback_plan(top_plan);
     } else {
-        top_plan = vectorize_plan(top_plan, from_subplan);
+        top_plan = vectorize_plan(top_plan, from_subplan, allow_row_scan);
 
         if (from_subplan && !IsVecOutput(top_plan))
             top_plan = fallback_plan(top_plan);
@@ -8188,9 +8621,10 @@ static bool vector_engine_setfunc_walker(Node* node, DenseRank_context* context)
  *
  * @param[IN] result_plan:  current plan node
  * @param[IN] check_rescan:  if need check rescan
+ * @param[IN] allow_row_scan:  if row scans may feed the vector engine
  * @return: bool, true means unsupported, false means supported
  */
-static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
+static bool vector_engine_walker(Plan* result_plan, bool check_rescan, bool allow_row_scan)
 {
     if (result_plan == NULL)
         return false;
@@ -8208,7 +8642,7 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
     switch (nodeTag(result_plan)) {
         /* Operators below cannot be vectorized */
         case T_SeqScan:
-            if (result_plan->isDeltaTable) {
+            if (result_plan->isDeltaTable || row_scan_vectorizable(result_plan, allow_row_scan)) {
                 return false;
             }
         case T_IndexScan:
@@ -8227,7 +8661,7 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
             if (check_rescan)
                 return true;
 
-            if (vector_engine_walker(result_plan->lefttree, check_rescan))
+            if (vector_engine_walker(result_plan->lefttree, check_rescan, allow_row_scan))
                 return true;
             break;
 
@@ -8236,7 +8670,7 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
             Stream* sj = (Stream*)result_plan;
             if (vector_engine_unsupport_expression_walker((Node*)sj->distribute_keys))
                 return true;
-            if (vector_engine_walker(result_plan->lefttree, check_rescan))
+            if (vector_engine_walker(result_plan->lefttree, check_rescan, allow_row_scan))
                 return true;
         } break;
         case T_Limit: {
@@ -8245,14 +8679,14 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
                 return true;
             if (vector_engine_unsupport_expression_walker((Node*)lm->limitOffset))
                 return true;
-            if (vector_engine_walker(result_plan->lefttree, check_rescan))
+            if (vector_engine_walker(result_plan->lefttree, check_rescan, allow_row_scan))
                 return true;
         } break;
         case T_BaseResult: {
             BaseResult* br = (BaseResult*)result_plan;
             if (vector_engine_unsupport_expression_walker((Node*)br->resconstantqual))
                 return true;
-            if (vector_engine_walker(result_plan->lefttree, check_rescan))
+            if (vector_engine_walker(result_plan->lefttree, check_rescan, allow_row_scan))
                 return true;
         } break;
         case T_PartIterator:
@@ -8265,7 +8699,7 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
         case T_Material:
         case T_Hash:
         case T_Sort:
-            if (vector_engine_walker(result_plan->lefttree, check_rescan))
+            if (vector_engine_walker(result_plan->lefttree, check_rescan, allow_row_scan))
                 return true;
             break;
 
@@ -8278,7 +8712,7 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
             if (vector_engine_expression_walker((Node*)(result_plan->qual), NULL))
                 return true;
 
-            if (vector_engine_walker(result_plan->lefttree, check_rescan))
+            if (vector_engine_walker(result_plan->lefttree, check_rescan, allow_row_scan))
                 return true;
 
             /* Check if contains array operator, not support distrtribute on ARRAY type now */
@@ -8314,7 +8748,7 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
             if (vector_engine_unsupport_expression_walker((Node*)wa->endOffset))
                 return true;
 
-            if (vector_engine_walker(result_plan->lefttree, check_rescan))
+            if (vector_engine_walker(result_plan->lefttree, check_rescan, allow_row_scan))
                 return true;
         } break;
 
@@ -8328,9 +8762,9 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
             if (vector_engine_unsupport_expression_walker((Node*)mj->join.nulleqqual))
                 return true;
 
-            if (vector_engine_walker(result_plan->lefttree, check_rescan))
+            if (vector_engine_walker(result_plan->lefttree, check_rescan, allow_row_scan))
                 return true;
-            if (vector_engine_walker(result_plan->righttree, check_rescan))
+            if (vector_engine_walker(result_plan->righttree, check_rescan, allow_row_scan))
                 return true;
         } break;
 
@@ -8342,13 +8776,13 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
             if (vector_engine_unsupport_expression_walker((Node*)nl->join.nulleqqual))
                 return true;
 
-            if (vector_engine_walker(result_plan->lefttree, check_rescan))
+            if (vector_engine_walker(result_plan->lefttree, check_rescan, allow_row_scan))
                 return true;
             if (IsA(result_plan->righttree, Material) && result_plan->righttree->allParam == NULL)
                 check_rescan = false;
             else
                 check_rescan = true;
-            if (vector_engine_walker(result_plan->righttree, check_rescan))
+            if (vector_engine_walker(result_plan->righttree, check_rescan, allow_row_scan))
                 return true;
         } break;
 
@@ -8368,9 +8802,9 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
             if (vector_engine_unsupport_expression_walker((Node*)hj->join.nulleqqual))
                 return true;
 
-            if (vector_engine_walker(result_plan->lefttree, check_rescan))
+            if (vector_engine_walker(result_plan->lefttree, check_rescan, allow_row_scan))
                 return true;
-            if (vector_engine_walker(result_plan->righttree, check_rescan))
+            if (vector_engine_walker(result_plan->righttree, check_rescan, allow_row_scan))
                 return true;
         } break;
 
@@ -8380,7 +8814,7 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
             foreach (lc, append->appendplans) {
                 Plan* plan = (Plan*)lfirst(lc);
 
-                if (vector_engine_walker(plan, check_rescan))
+                if (vector_engine_walker(plan, check_rescan, allow_row_scan))
                     return true;
             }
         } break;
@@ -8390,7 +8824,7 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
             ListCell* lc = NULL;
             foreach (lc, mt->plans) {
                 Plan* plan = (Plan*)lfirst(lc);
-                if (vector_engine_walker(plan, check_rescan))
+                if (vector_engine_walker(plan, check_rescan, allow_row_scan))
                     return true;
             }
         } break;
@@ -8398,7 +8832,7 @@ static bool vector_engine_walker(Plan* result_plan, bool check_rescan)
         case T_SubqueryScan: {
             SubqueryScan* ss = (SubqueryScan*)result_plan;
 
-            if (ss->subplan && vector_engine_walker(ss->subplan, check_rescan))
+            if (ss->subplan && vector_engine_walker(ss->subplan, check_rescan, allow_row_scan))
                 return true;
         } break;
 
@@ -8537,9 +8971,10 @@ static Plan* fallback_plan(Plan* result_plan)
  *
  * @param[IN] result_plan:  current plan node
  * @param[IN] ignore_remotequery:  if ignore RemoteQuery node
+ * @param[IN] allow_row_scan:  if row scans may feed the vector engine
  * @return: Plan*, vectorized plan
  */
-Plan* vectorize_plan(Plan* result_plan, bool ignore_remotequery)
+Plan* vectorize_plan(Plan* result_plan, bool ignore_remotequery, bool allow_row_scan)
 {
     if (result_plan == NULL)
         return NULL;
@@ -8564,6 +8999,8 @@ Plan* vectorize_plan(Plan* result_plan, bool ignore_remotequery)
         case T_SeqScan: {
             if (result_plan->isDeltaTable) {
                 result_plan = (Plan*)make_rowtovec(result_plan);
+            } else if (row_scan_vectorizable(result_plan, allow_row_scan)) {
+                result_plan = vectorize_row_scan(result_plan);
             }
             break;
         }
@@ -8587,7 +9024,7 @@ Plan* vectorize_plan(Plan* result_plan, bool ignore_remotequery)
         case T_Stream:
         case T_Material:
         case T_WindowAgg:
-            result_plan->lefttree = vectorize_plan(result_plan->lefttree, ignore_remotequery);
+            result_plan->lefttree = vectorize_plan(result_plan->lefttree, ignore_remotequery, allow_row_scan);
             if (result_plan->lefttree && IsVecOutput(result_plan->lefttree))
                 return build_vector_plan(result_plan);
             else if ((result_plan->lefttree && !IsVecOutput(result_plan->lefttree)) &&
@@ -8603,8 +9040,8 @@ Plan* vectorize_plan(Plan* result_plan, bool ignore_remotequery)
 
         case T_MergeJoin:
         case T_NestLoop:
-            result_plan->lefttree = vectorize_plan(result_plan->lefttree, ignore_remotequery);
-            result_plan->righttree = vectorize_plan(result_plan->righttree, ignore_remotequery);
+            result_plan->lefttree = vectorize_plan(result_plan->lefttree, ignore_remotequery, allow_row_scan);
+            result_plan->righttree = vectorize_plan(result_plan->righttree, ignore_remotequery, allow_row_scan);
 
             if (IsVecOutput(result_plan->lefttree) && IsVecOutput(result_plan->righttree)) {
                 return build_vector_plan(result_plan);
@@ -8630,7 +9067,7 @@ Plan* vectorize_plan(Plan* result_plan, bool ignore_remotequery)
         case T_Hash:
             break;
         case T_Agg: {
-            result_plan->lefttree = vectorize_plan(result_plan->lefttree, ignore_remotequery);
+            result_plan->lefttree = vectorize_plan(result_plan->lefttree, ignore_remotequery, allow_row_scan);
             if (IsVecOutput(result_plan->lefttree))
                 return build_vector_plan(result_plan);
         } break;
@@ -8639,8 +9076,8 @@ Plan* vectorize_plan(Plan* result_plan, bool ignore_remotequery)
          */
         case T_HashJoin: {
             /* HashJoin supports vector right now */
-            result_plan->lefttree = vectorize_plan(result_plan->lefttree, ignore_remotequery);
-            result_plan->righttree->lefttree = vectorize_plan(result_plan->righttree->lefttree, ignore_remotequery);
+            result_plan->lefttree = vectorize_plan(result_plan->lefttree, ignore_remotequery, allow_row_scan);
+            result_plan->righttree->lefttree = vectorize_plan(result_plan->righttree->lefttree, ignore_remotequery, allow_row_scan);
 
             if (IsVecOutput(result_plan->lefttree) && IsVecOutput(result_plan->righttree->lefttree)) {
                 /* Remove hash node */
@@ -8661,7 +9098,7 @@ Plan* vectorize_plan(Plan* result_plan, bool ignore_remotequery)
             bool isVec = true;
             foreach (lc, append->appendplans) {
                 Plan* plan = (Plan*)lfirst(lc);
-                plan = vectorize_plan(plan, ignore_remotequery);
+                plan = vectorize_plan(plan, ignore_remotequery, allow_row_scan);
                 lfirst(lc) = plan;
                 if (!IsVecOutput(plan)) {
                     if (u_sess->attr.attr_sql.enable_force_vector_engine)
@@ -8691,7 +9128,7 @@ Plan* vectorize_plan(Plan* result_plan, bool ignore_remotequery)
 
                 foreach (lc, mt->plans) {
                     Plan* plan = (Plan*)lfirst(lc);
-                    lfirst(lc) = vectorize_plan(plan, ignore_remotequery);
+                    lfirst(lc) = vectorize_plan(plan, ignore_remotequery, allow_row_scan);
                     if (IsVecOutput(result_plan) &&
                         !IsVecOutput(plan)) { // If we support vectorize ModifyTable, please remove it
                         if (IsA(plan, ForeignScan)) {
@@ -8715,7 +9152,7 @@ Plan* vectorize_plan(Plan* result_plan, bool ignore_remotequery)
             {
                 SubqueryScan* ss = (SubqueryScan*)result_plan;
                 if (ss->subplan)
-                    ss->subplan = vectorize_plan(ss->subplan, ignore_remotequery);
+                    ss->subplan = vectorize_plan(ss->subplan, ignore_remotequery, allow_row_scan);
                 if (IsVecOutput(ss->subplan)) {  // If we support vectorize ModifyTable, please remove it
                     build_vector_plan(result_plan);
                 }
@@ -113,6 +113,7 @@ static Node* fix_scan_expr_mutator(Node* node, fix_scan_expr_context* context);
 static bool fix_scan_expr_walker(Node* node, fix_scan_expr_context* context);
 static void set_join_references(PlannerInfo* root, Join* join, int rtoffset);
 static void set_upper_references(PlannerInfo* root, Plan* plan, int rtoffset);
+static void set_parallel_agg_references(Agg* aggplan);
 static void set_dummy_tlist_references(Plan* plan, int rtoffset);
 static indexed_tlist* build_tlist_index(List* tlist);
 static Var* search_indexed_tlist_for_var(Var* var, indexed_tlist* itlist, Index newvarno, int rtoffset);
@@ -310,6 +311,7 @@ static Plan* set_plan_refs(PlannerInfo* root, Plan* plan, int rtoffset)
             splan->scanrelid += rtoffset;
             splan->plan.targetlist = fix_scan_list(root, splan->plan.targetlist, rtoffset);
             splan->plan.qual = fix_scan_list(root, splan->plan.qual, rtoffset);
+            splan->plan.var_list = fix_scan_list(root, splan->plan.var_list, rtoffset);
             if (splan->plan.distributed_keys != NIL) {
                 splan->plan.distributed_keys = fix_scan_list(root, splan->plan.distributed_keys, rtoffset);
             }
@@ -640,6 +642,12 @@ static Plan* set_plan_refs(PlannerInfo* root, Plan* plan, int rtoffset)
         } break;
         case T_Agg:
         case T_VecAgg:
+            /* A Finalize Agg reads the transition values of the Partial Agg */
+            if (((Agg*)plan)->parallel_stage == AGG_PARALLEL_FINAL) {
+                set_parallel_agg_references((Agg*)plan);
+                set_upper_references(root, plan, rtoffset);
+                break;
+            }
 #ifdef PGXC
             /* If the lower plan is RemoteQuery plan, adjust the aggregates */
             if (IS_STREAM_PLAN) {
@@ -2496,6 +2504,54 @@ static void fix_skew_quals(PlannerInfo* root, Plan* plan, indexed_tlist* subplan
     }
 }
 
+/*
+ * set_parallel_agg_references
+ *	  Point the aggregates of a Finalize Agg at the Partial Agg below it.
+ *
+ * The Partial Agg (seen here through the Gather's targetlist) returns each
+ * aggregate with its aggtype switched to the transition type.  Make that
+ * partial Aggref the only argument of the matching Aggref in the Finalize
+ * Agg, so that set_upper_references turns it into a reference to the
+ * transition value and the executor feeds it to the collection function.
+ */
+static void set_parallel_agg_references(Agg* aggplan)
+{
+    Plan* subplan = aggplan->plan.lefttree;
+    List* nodes_to_modify = NIL;
+    List* aggs_n_vars = NIL;
+    ListCell* lc = NULL;
+
+    nodes_to_modify = list_copy(aggplan->plan.targetlist);
+    nodes_to_modify = list_concat(nodes_to_modify, list_copy(aggplan->plan.qual));
+    aggs_n_vars = pull_var_clause((Node*)nodes_to_modify, PVC_INCLUDE_AGGREGATES, PVC_RECURSE_PLACEHOLDERS);
+
+    foreach (lc, aggs_n_vars) {
+        Aggref* aggref = (Aggref*)lfirst(lc);
+        Aggref* partial_aggref = NULL;
+        TargetEntry* tle = NULL;
+
+        if (!IsA(aggref, Aggref)) {
+            continue;
+        }
+
+        partial_aggref = (Aggref*)copyObject(aggref);
+        partial_aggref->aggtype = partial_aggref->aggtrantype;
+        tle = tlist_member((Node*)partial_aggref, subplan->targetlist);
+        if (tle == NULL) {
+            ereport(ERROR,
+                (errmodule(MOD_OPT),
+                    errcode(ERRCODE_OPTIMIZER_INCONSISTENT_STATE),
+                    (errmsg("could not find the partial aggregate below a Finalize Agg"))));
+        }
+
+        aggref->args = list_make1(makeTargetEntry((Expr*)copyObject(tle->expr), 1, NULL, false));
+        aggref->aggstage = partial_aggref->aggstage + 1;
+    }
+
+    list_free_ext(aggs_n_vars);
+    list_free_ext(nodes_to_modify);
+}
+
 #ifdef PGXC
 /*
  * For Agg plans, if the lower scan plan is a RemoteQuery node, adjust the
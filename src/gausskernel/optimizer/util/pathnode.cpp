@@ -1969,12 +1969,14 @@ bool is_pwj_path(Path* pwjpath)
  * 'required_outer' is the set of outer relids for a parameterized path.
  * 'loop_count' is the number of repetitions of the indexscan to factor into
  *		estimates of caching behavior.
+ * 'parallel_degree' is the number of workers for a partial (parallel-aware)
+ *		path, or 0 for an ordinary one.
  *
  * Returns the new path node.
  */
 IndexPath* create_index_path(PlannerInfo* root, IndexOptInfo* index, List* indexclauses, List* indexclausecols,
     List* indexorderbys, List* indexorderbycols, List* pathkeys, ScanDirection indexscandir, bool indexonly,
-    Relids required_outer, double loop_count)
+    Relids required_outer, double loop_count, int parallel_degree)
 {
     IndexPath* pathnode = makeNode(IndexPath);
     RelOptInfo* rel = index->rel;
@@ -1985,6 +1987,11 @@ IndexPath* create_index_path(PlannerInfo* root, IndexOptInfo* index, List* index
     pathnode->path.parent = rel;
     pathnode->path.param_info = get_baserel_parampathinfo(root, rel, required_outer);
     pathnode->path.pathkeys = pathkeys;
+    if (parallel_degree > 0) {
+        pathnode->path.parallel_aware = true;
+        pathnode->path.parallel_safe = rel->consider_parallel;
+        pathnode->path.parallel_degree = parallel_degree;
+    }
 
     /* Convert clauses to indexquals the executor can handle */
     expand_indexqual_conditions(index, indexclauses, indexclausecols, &indexquals, &indexqualcols);
@@ -2022,12 +2029,14 @@ IndexPath* create_index_path(PlannerInfo* root, IndexOptInfo* index, List* index
  * 'required_outer' is the set of outer relids for a parameterized path.
  * 'loop_count' is the number of repetitions of the indexscan to factor into
  *		estimates of caching behavior.
+ * 'parallel_degree' is the number of workers for a partial (parallel-aware)
+ *		path, or 0 for an ordinary one.
  *
  * loop_count should match the value used when creating the component
  * IndexPaths.
  */
-BitmapHeapPath* create_bitmap_heap_path(
-    PlannerInfo* root, RelOptInfo* rel, Path* bitmapqual, Relids required_outer, double loop_count)
+BitmapHeapPath* create_bitmap_heap_path(PlannerInfo* root, RelOptInfo* rel, Path* bitmapqual, Relids required_outer,
+    double loop_count, int parallel_degree)
 {
     BitmapHeapPath* pathnode = makeNode(BitmapHeapPath);
 
@@ -2035,6 +2044,11 @@ BitmapHeapPath* create_bitmap_heap_path(
     pathnode->path.parent = rel;
     pathnode->path.param_info = get_baserel_parampathinfo(root, rel, required_outer);
     pathnode->path.pathkeys = NIL; /* always unordered */
+    if (parallel_degree > 0) {
+        pathnode->path.parallel_aware = true;
+        pathnode->path.parallel_safe = rel->consider_parallel;
+        pathnode->path.parallel_degree = parallel_degree;
+    }
 
     pathnode->bitmapqual = bitmapqual;
 
@@ -3775,10 +3789,12 @@ MergePath* create_mergejoin_path(PlannerInfo* root, RelOptInfo* joinrel, JoinTyp
  * 'required_outer' is the set of required outer rels
  * 'hashclauses' are the RestrictInfo nodes to use as hash clauses
  *		(this should be a subset of the restrict_clauses list)
+ * 'parallel_hash' to build one hash table shared by all participants from
+ *		a partial inner path
  */
 HashPath* create_hashjoin_path(PlannerInfo* root, RelOptInfo* joinrel, JoinType jointype, JoinCostWorkspace* workspace,
     SpecialJoinInfo* sjinfo, SemiAntiJoinFactors* semifactors, Path* outer_path, Path* inner_path,
-    List* restrict_clauses, Relids required_outer, List* hashclauses, int dop)
+    List* restrict_clauses, Relids required_outer, List* hashclauses, int dop, bool parallel_hash)
 {
     HashPath* pathnode = makeNode(HashPath);
     bool try_eq_related_indirectly = false;
@@ -3788,7 +3804,7 @@ HashPath* create_hashjoin_path(PlannerInfo* root, RelOptInfo* joinrel, JoinType
     pathnode->jpath.path.param_info =
         get_joinrel_parampathinfo(root, joinrel, outer_path, inner_path, sjinfo, required_outer, &restrict_clauses);
 
-    pathnode->jpath.path.parallel_aware = false;
+    pathnode->jpath.path.parallel_aware = joinrel->consider_parallel && parallel_hash;
     pathnode->jpath.path.parallel_safe =
         joinrel->consider_parallel && outer_path->parallel_safe && inner_path->parallel_safe;
     /* This is a foolish way to estimate parallel_degree, but for now... */
@@ -285,6 +285,8 @@ void get_relation_info(PlannerInfo* root, Oid relationObjectId, bool inhparent,
             info->amsearchnulls = indexRelation->rd_am->amsearchnulls;
             info->amhasgettuple = OidIsValid(indexRelation->rd_am->amgettuple);
             info->amhasgetbitmap = OidIsValid(indexRelation->rd_am->amgetbitmap);
+            /* only btree knows how to share a scan among parallel workers */
+            info->amcanparallel = (info->relam == BTREE_AM_OID);
 
             /*
              * Fetch the ordering information for the index, if any.
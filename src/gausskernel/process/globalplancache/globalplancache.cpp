@@ -33,6 +33,7 @@
 #include "optimizer/nodegroups.h"
 #include "pgxc/groupmgr.h"
 #include "pgxc/pgxcnode.h"
+#include "storage/barrier.h"
 #include "utils/dynahash.h"
 #include "utils/globalplancache.h"
 #include "utils/memutils.h"
@@ -99,6 +100,7 @@ GPCEnv *GlobalPlanCache::EnvCreate()
     environment->env_signature2 = 0;
     environment->globalplancacheentry = NULL;
     environment->plansource = NULL;
+    environment->read_node = NULL;
     environment->context = env_context;
     environment->memory_size = 0;
 
@@ -182,6 +184,7 @@ static void GPCFillEnvSignatures(GPCEnv *env)
     env->env_signature_pgxc |= u_sess->attr.attr_sql.enable_random_datanode << 10;
     env->env_signature_pgxc |= u_sess->attr.attr_sql.enable_fstream << 11;
 #endif
+    env->env_signature_pgxc |= u_sess->attr.attr_sql.vector_engine_strategy << 12;
 #endif
     GPCFillClassicEnvSignatures(env);
     env->env_signature2 = 0;
@@ -435,6 +438,14 @@ void GlobalPlanCache::PlanInit()
     }
 
     m_gpc_invalid_plansource = NULL;
+    m_gpc_retired_nodes = NULL;
+    m_gpc_retired_envs = NULL;
+
+    m_read_epoch = 0;
+    for (int i = 0; i < 2; i++) {
+        m_read_slots[i] = (GPCReaderSlot*) MemoryContextAllocZero(g_instance.cache_cxt.global_cache_mem,
+                                                                 sizeof(GPCReaderSlot) * GPC_NUM_OF_READER_SLOTS);
+    }
 }
 
 /* Get the HTAB Bucket index based on the hashvalue. 
@@ -502,8 +513,11 @@ void GlobalPlanCache::PlanStore(CachedPlanSource *plansource)
     * Append the new CachedEnvironment to the entry's List. 
     * But make sure there is only one thread inserting into the List.
     */
-    while (!gs_compare_and_swap_32(&entry->CAS_flag, FALSE, TRUE))
-        pg_usleep(CAS_SLEEP_DURATION); // microseconds.
+    if (!gs_compare_and_swap_32(&entry->CAS_flag, FALSE, TRUE)) {
+        (void)gs_atomic_add_64(&m_gpc_bucket_info_array[gpc_bucket_index].contentions, 1);
+        while (!gs_compare_and_swap_32(&entry->CAS_flag, FALSE, TRUE))
+            pg_usleep(CAS_SLEEP_DURATION); // microseconds.
+    }
 
     MemoryContext oldcontext = MemoryContextSwitchTo(m_gpc_bucket_info_array[gpc_bucket_index].context);
     entry->cachedPlans = dlappend(entry->cachedPlans, plansource->gpc.env);
@@ -517,9 +531,131 @@ void GlobalPlanCache::PlanStore(CachedPlanSource *plansource)
     Assert (plansource->gplan->is_share == true);
     Assert (plansource->gplan->context->parent == g_instance.cache_cxt.global_cache_mem);
 
+    /* only now that the plan is marked shared may PlanFetch find it */
+    ReadPublish(plansource->gpc.env, hashCode, gpc_bucket_index);
+
     LWLockRelease(GetMainLWLockByIndex(partitionLock));
 }
 
+/*
+ * Readers of the lock-free lookup index announce themselves on a counter of the
+ * current epoch parity. Each thread keeps to one counter slot so that readers
+ * of different threads rarely share a cache line.
+ */
+static THR_LOCAL uint32 gpc_reader_slot = 0;
+static volatile uint32 gpc_reader_slot_seq = 0;
+
+uint32 GlobalPlanCache::ReadBegin()
+{
+    if (gpc_reader_slot == 0) {
+        gpc_reader_slot = pg_atomic_add_fetch_u32(&gpc_reader_slot_seq, 1) % GPC_NUM_OF_READER_SLOTS + 1;
+    }
+
+    uint32 epoch = pg_atomic_read_u32(&m_read_epoch) & 1;
+    /* the atomic add is a full barrier: the list is read only after we are counted */
+    (void)pg_atomic_fetch_add_u32(&m_read_slots[epoch][gpc_reader_slot - 1].count, 1);
+
+    return epoch;
+}
+
+void GlobalPlanCache::ReadEnd(uint32 epoch)
+{
+    (void)pg_atomic_fetch_sub_u32(&m_read_slots[epoch][gpc_reader_slot - 1].count, 1);
+}
+
+/*
+ * Wait until every PlanFetch that might still see a node unlinked before this
+ * call has finished. We flip the epoch parity and wait for the readers counted
+ * on the old parity to drain, twice, so that a reader which sampled the parity
+ * just before a flip is waited for too. The caller must hold GPCClearLock
+ * exclusively, which serializes the flips. Returns whether we had to wait.
+ */
+bool GlobalPlanCache::Synchronize()
+{
+    bool waited = false;
+
+    pg_memory_barrier();
+    for (int round = 0; round < 2; round++) {
+        uint32 old_epoch = pg_atomic_read_u32(&m_read_epoch) & 1;
+        (void)pg_atomic_fetch_add_u32(&m_read_epoch, 1);
+
+        for (;;) {
+            uint32 readers = 0;
+            for (int i = 0; i < GPC_NUM_OF_READER_SLOTS; i++) {
+                readers += pg_atomic_read_u32(&m_read_slots[old_epoch][i].count);
+            }
+            if (readers == 0) {
+                break;
+            }
+            waited = true;
+            pg_usleep(CAS_SLEEP_DURATION); // microseconds.
+        }
+    }
+
+    return waited;
+}
+
+/*
+ * Link a new node for env at the head of its bucket's lookup list. The node is
+ * filled before it is published, so a reader never sees a half built node.
+ * The caller must hold the bucket's mapping lock exclusively.
+ */
+void GlobalPlanCache::ReadPublish(GPCEnv *env, uint32 hash_code, uint32 bucket_index)
+{
+    GPCBucketInfo *bucket = &m_gpc_bucket_info_array[bucket_index];
+    CachedPlanSource *plansource = env->plansource;
+
+    MemoryContext oldcontext = MemoryContextSwitchTo(bucket->context);
+    GPCReadNode *node = (GPCReadNode *) palloc(sizeof(GPCReadNode));
+    node->hash_code = hash_code;
+    node->query_length = strlen(plansource->query_string);
+    node->num_params = env->num_params;
+    node->env = env;
+    node->query_string = pnstrdup(plansource->query_string, node->query_length);
+    node->next = bucket->read_list;
+    MemoryContextSwitchTo(oldcontext);
+
+    pg_write_barrier();
+    bucket->read_list = node;
+    env->read_node = node;
+}
+
+/*
+ * Unlink env's node from its bucket's lookup list. The node is not freed: the
+ * caller retires it to InvalidPlanDrop, which frees it after a grace period.
+ * The caller must hold the bucket's mapping lock exclusively.
+ */
+void GlobalPlanCache::ReadUnpublish(GPCEnv *env, uint32 bucket_index)
+{
+    GPCBucketInfo *bucket = &m_gpc_bucket_info_array[bucket_index];
+    GPCReadNode *node = env->read_node;
+
+    if (node == NULL) {
+        return;
+    }
+
+    if (bucket->read_list == node) {
+        bucket->read_list = node->next;
+    } else {
+        GPCReadNode *prev = bucket->read_list;
+        while (prev != NULL && prev->next != node) {
+            prev = prev->next;
+        }
+        Assert(prev != NULL);
+        if (prev != NULL) {
+            prev->next = node->next;
+        }
+    }
+}
+
+/*
+ * Look up a shared plan for the query. This takes no lock: the bucket's lookup
+ * list is walked inside a read-side section, and writers wait for it in
+ * Synchronize before they free anything a reader could reach. The plansource
+ * found is pinned before the section ends, so it stays valid after it: the
+ * caller hands the pin over to a prepared statement or drops it with
+ * RefcountSub.
+ */
 GPCEnv* GlobalPlanCache::PlanFetch(const char *query_string, uint32 query_len, int num_params)
 {
     GPCKey key;
@@ -528,52 +664,75 @@ GPCEnv* GlobalPlanCache::PlanFetch(const char *query_string, uint32 query_len, i
     uint32 hashCode = GPCHashFunc((const void *) &key, sizeof(key));
 
     uint32 gpc_bucket_index = GetBucket(hashCode);
-    int partitionLock = (int) (FirstGPCMappingLock + gpc_bucket_index);
-    Assert ((int) partitionLock >= FirstGPCMappingLock);
-    Assert ((int) partitionLock < FirstGPCMappingLock + GPC_NUM_OF_BUCKETS);
+    GPCBucketInfo *bucket = &m_gpc_bucket_info_array[gpc_bucket_index];
 
-    LWLockAcquire(GetMainLWLockByIndex(partitionLock), LW_SHARED);
+    GPCEnv *gpc_env = NULL;
+    uint32 epoch = ReadBegin();
 
-    bool foundCachedEntry = false;
-    GPCEntry *cachedEntry = (GPCEntry *) hash_search_with_hash_value(m_global_plan_cache,
-                                                                     (const void*)(&key),
-                                                                     hashCode,
-                                                                     HASH_FIND,
-                                                                     &foundCachedEntry);
+    for (GPCReadNode *node = bucket->read_list; node != NULL; node = node->next) {
+        if (node->hash_code != hashCode || node->query_length != query_len || node->num_params != num_params ||
+            memcmp(node->query_string, query_string, query_len) != 0) {
+            continue;
+        }
 
-    if (cachedEntry == NULL || cachedEntry->cachedPlans == NULL) {
-        LWLockRelease(GetMainLWLockByIndex(partitionLock));
-        return NULL;
+        GPCEnv *curr = node->env;
+        if (GPCCompareEnvSignature(curr) == false && curr->plansource->gpc.is_share == true) {
+            Assert (curr->plansource->gplan != NULL);
+            Assert (curr->plansource->gplan->is_share == true);
+            Assert (curr->plansource->gplan->context->parent == g_instance.cache_cxt.global_cache_mem);
+            RefcountAdd(curr->plansource);
+            gpc_env = curr;
+            break;
+        }
     }
 
-    GPCEnv *gpc_env = NULL;
-    int numCachedPlans = cachedEntry->cachedPlans->length;
-    DListCell *cell = cachedEntry->cachedPlans->head;
+    ReadEnd(epoch);
 
-    for (int i = 0; i < numCachedPlans; i++) {
-        Assert(cell != NULL);
-
-        gpc_env = (GPCEnv *) cell->data.ptr_value;
-        if (gpc_env != NULL && num_params == gpc_env->num_params &&
-            GPCCompareEnvSignature(gpc_env) == false) {
-            if (gpc_env->plansource->gpc.is_share == true) {
-                Assert (gpc_env->plansource->gplan != NULL);
-                Assert (gpc_env->plansource->gplan->is_share == true);
-                Assert (gpc_env->plansource->gplan->context->parent == g_instance.cache_cxt.global_cache_mem);
-                break;
-            }
-        }
-        gpc_env = NULL;
-        cell = cell->next;
+    if (gpc_env != NULL) {
+        (void)gs_atomic_add_64(&bucket->fetch_hits, 1);
+    } else {
+        (void)gs_atomic_add_64(&bucket->fetch_misses, 1);
     }
 
-    LWLockRelease(GetMainLWLockByIndex(partitionLock));
-
     return gpc_env;
 }
 
+/*
+ * Free what PlanDrop and PlanClean have unlinked from the lookup lists. One
+ * grace period covers everything retired since the last call, so however many
+ * envs were dropped we wait at most once. Invalid plansources are freed once
+ * no prepared statement pins them. The caller must hold GPCClearLock
+ * exclusively.
+ */
 void GlobalPlanCache::InvalidPlanDrop()
 {
+    if (m_gpc_retired_nodes != NULL || m_gpc_retired_envs != NULL) {
+        bool waited = Synchronize();
+
+        if (m_gpc_retired_nodes != NULL) {
+            for (DListCell *cell = m_gpc_retired_nodes->head; cell != NULL; cell = cell->next) {
+                GPCReadNode *node = (GPCReadNode *)cell->data.ptr_value;
+                if (waited) {
+                    (void)gs_atomic_add_64(&m_gpc_bucket_info_array[GetBucket(node->hash_code)].contentions, 1);
+                }
+                pfree(node->query_string);
+                pfree(node);
+            }
+            dlist_free(m_gpc_retired_nodes, false);
+            m_gpc_retired_nodes = NULL;
+        }
+
+        if (m_gpc_retired_envs != NULL) {
+            for (DListCell *cell = m_gpc_retired_envs->head; cell != NULL; cell = cell->next) {
+                GPCEnv *env = (GPCEnv *)cell->data.ptr_value;
+                env->plansource = NULL;
+                MemoryContextDelete(env->context);
+            }
+            dlist_free(m_gpc_retired_envs, false);
+            m_gpc_retired_envs = NULL;
+        }
+    }
+
     if (m_gpc_invalid_plansource != NULL) {
         DListCell *cell = m_gpc_invalid_plansource->head;
 
@@ -598,6 +757,12 @@ void GlobalPlanCache::InvalidPlanDrop()
     }
 }
 
+/*
+ * Invalidate a shared plan. The env is unlinked from its bucket's lookup list
+ * at once, but PlanFetch may still be looking at it, so it is only freed by
+ * the next InvalidPlanDrop. The caller must hold the bucket's mapping lock
+ * exclusively.
+ */
 void GlobalPlanCache::PlanDrop(GPCEnv *cachedenv)
 {
     LWLockAcquire(GPCClearLock, LW_EXCLUSIVE);
@@ -614,6 +779,16 @@ void GlobalPlanCache::PlanDrop(GPCEnv *cachedenv)
     GPCEntry *entry = cachedenv->globalplancacheentry;
     Assert (entry->cachedPlans != NULL);
 
+    MemoryContext oldcontext = MemoryContextSwitchTo(g_instance.cache_cxt.global_cache_mem);
+
+    uint32 gpc_bucket_index = (uint32)(entry->lockId - FirstGPCMappingLock);
+    GPCReadNode *read_node = cachedenv->read_node;
+    if (read_node != NULL) {
+        ReadUnpublish(cachedenv, gpc_bucket_index);
+        cachedenv->read_node = NULL;
+        m_gpc_retired_nodes = dlappend(m_gpc_retired_nodes, read_node);
+    }
+
     int numCachedPlans = entry->cachedPlans->length;
     Assert(numCachedPlans <= entry->refcount);
     DListCell *cell = entry->cachedPlans->head;
@@ -631,22 +806,18 @@ void GlobalPlanCache::PlanDrop(GPCEnv *cachedenv)
                 bool found = false;
                 hash_search(m_global_plan_cache, (void *) &(entry->key), HASH_REMOVE, &found);
                 Assert(true == found);
-                uint32 gpc_bucket_index = (uint32)(entry->lockId - FirstGPCMappingLock);
                 m_gpc_bucket_info_array[gpc_bucket_index].entries_count--;
 
                 entry->magic = 0;
                 pfree((void *)entry->key.query_string);
 
-                cachedenv->plansource = NULL;
-                MemoryContextDelete(cachedenv->context);
+                m_gpc_retired_envs = dlappend(m_gpc_retired_envs, cachedenv);
             }
 
             break;
         }
         cell = cell->next;
     }
-    InvalidPlanDrop();
-    MemoryContext oldcontext = MemoryContextSwitchTo(g_instance.cache_cxt.global_cache_mem);
     m_gpc_invalid_plansource = dlappend(m_gpc_invalid_plansource, plansource);
     MemoryContextSwitchTo(oldcontext);
     
@@ -966,11 +1137,17 @@ void GlobalPlanCache::CheckTimeline(uint32 timeline)
     LWLockRelease(GPCTimelineLock);
 }
 
+/*
+ * Point the session's prepared statement of plansource to share_plansource,
+ * which the caller has pinned with PlanFetch.
+ */
 void GlobalPlanCache::PrepareUpdate(CachedPlanSource *plansource, CachedPlanSource *share_plansource, bool throwError)
 {
     PreparedStatement *entry = NULL;
     entry = PrepareFetch(plansource->stmt_name, false);
     if (entry == NULL) {
+        /* nobody takes over the pin PlanFetch took */
+        RefcountSub(share_plansource);
         if (throwError == true) {
             ereport(ERROR,
                     (errcode(ERRCODE_UNDEFINED_PSTATEMENT),
@@ -980,8 +1157,8 @@ void GlobalPlanCache::PrepareUpdate(CachedPlanSource *plansource, CachedPlanSour
         return;
     }
 
+    /* the prepared statement takes over the pin PlanFetch took */
     entry->plansource = share_plansource;
-    RefcountAdd(share_plansource);
 }
 
 /*
@@ -29,9 +29,12 @@
 #include "access/xact.h"
 #include "catalog/pgxc_node.h"
 #include "commands/prepare.h"
+#include "funcapi.h"
 #include "optimizer/nodegroups.h"
 #include "pgxc/groupmgr.h"
 #include "pgxc/pgxcnode.h"
+#include "threadpool/threadpool.h"
+#include "utils/builtins.h"
 #include "utils/dynahash.h"
 #include "utils/globalplancache.h"
 #include "utils/memutils.h"
@@ -213,6 +216,45 @@ void *GlobalPlanCache::GetPrepareStatus(uint32 *num)
     return stat_array;
 }
 
+/*
+* @Description: get the lock-free lookup counters of every non-idle bucket
+* @in num: the number of buckets returned
+* @return - void
+*/
+void *GlobalPlanCache::GetFetchStats(uint32 *num)
+{
+    GPCFetchStats *stat_array = (GPCFetchStats*) palloc0(GPC_NUM_OF_BUCKETS * sizeof(GPCFetchStats));
+    uint32 index = 0;
+
+    /* the counters are only ever added to, reading them without a lock is fine */
+    for (uint32 i = 0; i < GPC_NUM_OF_BUCKETS; i++) {
+        GPCBucketInfo *bucket = &m_gpc_bucket_info_array[i];
+        int64 hits = gs_atomic_add_64(&bucket->fetch_hits, 0);
+        int64 misses = gs_atomic_add_64(&bucket->fetch_misses, 0);
+        int64 contentions = gs_atomic_add_64(&bucket->contentions, 0);
+        int entries = gs_atomic_add_32(&bucket->entries_count, 0);
+
+        if (hits == 0 && misses == 0 && contentions == 0 && entries == 0) {
+            continue;
+        }
+
+        stat_array[index].bucket_id = i;
+        stat_array[index].entries_count = entries;
+        stat_array[index].fetch_hits = hits;
+        stat_array[index].fetch_misses = misses;
+        stat_array[index].contentions = contentions;
+        index++;
+    }
+
+    *num = index;
+    if (index == 0) {
+        pfree(stat_array);
+        return NULL;
+    }
+
+    return stat_array;
+}
+
 /*
  * @Description: Clean all the global plancaches which refcount is 0.
  * This function only be called when user call the global_plancache_clean() by themselves.
@@ -224,6 +266,8 @@ void *GlobalPlanCache::GetPrepareStatus(uint32 *num)
 Datum GlobalPlanCache::PlanClean()
 {
     DListCell *cell = NULL;
+    List *dropped_envs = NIL;
+    ListCell *lc = NULL;
 
     for (uint32 currBucket = 0; currBucket < GPC_NUM_OF_BUCKETS; currBucket++) {
         int bucketEntriesCount = gs_atomic_add_32(&(m_gpc_bucket_info_array[currBucket].entries_count), 0);
@@ -258,8 +302,9 @@ Datum GlobalPlanCache::PlanClean()
                 if (env->plansource->gpc.refcount == 0) {
                     env->globalplancacheentry->cachedPlans = dlist_delete_cell(env->globalplancacheentry->cachedPlans, 
                                                                                cell, false);
-                    env->plansource = NULL;
-                    MemoryContextDelete(env->context);
+                    /* PlanFetch may still be looking at env, free it after the grace period below */
+                    ReadUnpublish(env, currBucket);
+                    dropped_envs = lappend(dropped_envs, env);
                     (void)gs_atomic_add_32(&entry->refcount, -1);
                 }
                 cell = next_cell;
@@ -284,22 +329,20 @@ Datum GlobalPlanCache::PlanClean()
         LWLockRelease(GetMainLWLockByIndex(partitionLock));
     }
     LWLockAcquire(GPCClearLock, LW_EXCLUSIVE);
-    if (m_gpc_invalid_plansource != NULL) {
-        cell = m_gpc_invalid_plansource->head;
-        while (cell != NULL) {
-            CachedPlanSource *curr = (CachedPlanSource *)cell->data.ptr_value;
-            if (curr->gpc.refcount == 0) {
-                DListCell *next = cell->next;
-                m_gpc_invalid_plansource = dlist_delete_cell(m_gpc_invalid_plansource, cell, false);
-                DropCachedPlanInternal(curr);
-                curr->magic = 0;
-                MemoryContextDelete(curr->context);
-                cell = next;
-            } else {
-                cell = cell->next;
+    if (dropped_envs != NIL) {
+        MemoryContext oldcontext = MemoryContextSwitchTo(g_instance.cache_cxt.global_cache_mem);
+        foreach (lc, dropped_envs) {
+            GPCEnv *env = (GPCEnv *)lfirst(lc);
+            if (env->read_node != NULL) {
+                m_gpc_retired_nodes = dlappend(m_gpc_retired_nodes, env->read_node);
+                env->read_node = NULL;
             }
+            m_gpc_retired_envs = dlappend(m_gpc_retired_envs, env);
         }
+        MemoryContextSwitchTo(oldcontext);
+        list_free(dropped_envs);
     }
+    InvalidPlanDrop();
     LWLockRelease(GPCClearLock);
 
     PG_RETURN_BOOL(true);
@@ -320,3 +363,61 @@ Datum GPCPlanClean(PG_FUNCTION_ARGS)
 
     PG_RETURN_BOOL(true);
 }
+
+/*
+ * @Description: System function plancache_fetch_status() entry
+ * @in num: PG_FUNCTION_ARGS, expected NULL
+ * @return - DATUM
+ */
+Datum GPCFetchStatus(PG_FUNCTION_ARGS)
+{
+#ifndef ENABLE_MULTIPLE_NODES
+    DISTRIBUTED_FEATURE_NOT_SUPPORTED();
+#endif
+
+    FuncCallContext *func_ctx = NULL;
+
+    if (SRF_IS_FIRSTCALL()) {
+        func_ctx = SRF_FIRSTCALL_INIT();
+        MemoryContext old_context = MemoryContextSwitchTo(func_ctx->multi_call_memory_ctx);
+
+#define GPC_FETCH_TUPLES_ATTR_NUM 6
+
+        TupleDesc tup_desc = CreateTemplateTupleDesc(GPC_FETCH_TUPLES_ATTR_NUM, false);
+        TupleDescInitEntry(tup_desc, (AttrNumber) 1, "nodename", TEXTOID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber) 2, "bucket_id", INT4OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber) 3, "entries", INT4OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber) 4, "fetch_hits", INT8OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber) 5, "fetch_misses", INT8OID, -1, 0);
+        TupleDescInitEntry(tup_desc, (AttrNumber) 6, "contentions", INT8OID, -1, 0);
+        func_ctx->tuple_desc = BlessTupleDesc(tup_desc);
+
+        if (ENABLE_THREAD_POOL && ENABLE_DN_GPC) {
+            func_ctx->user_fctx = GPC->GetFetchStats(&(func_ctx->max_calls));
+        } else {
+            func_ctx->max_calls = 0;
+        }
+
+        (void)MemoryContextSwitchTo(old_context);
+    }
+
+    func_ctx = SRF_PERCALL_SETUP();
+
+    if (func_ctx->call_cntr < func_ctx->max_calls) {
+        GPCFetchStats *entry = (GPCFetchStats *)func_ctx->user_fctx + func_ctx->call_cntr;
+        Datum values[GPC_FETCH_TUPLES_ATTR_NUM];
+        bool nulls[GPC_FETCH_TUPLES_ATTR_NUM] = {false};
+
+        values[0] = CStringGetTextDatum(g_instance.attr.attr_common.PGXCNodeName);
+        values[1] = Int32GetDatum((int32)entry->bucket_id);
+        values[2] = Int32GetDatum(entry->entries_count);
+        values[3] = Int64GetDatum(entry->fetch_hits);
+        values[4] = Int64GetDatum(entry->fetch_misses);
+        values[5] = Int64GetDatum(entry->contentions);
+
+        HeapTuple tuple = heap_form_tuple(func_ctx->tuple_desc, values, nulls);
+        SRF_RETURN_NEXT(func_ctx, HeapTupleGetDatum(tuple));
+    }
+
+    SRF_RETURN_DONE(func_ctx);
+}
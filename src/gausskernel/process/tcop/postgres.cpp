@@ -2993,8 +2993,17 @@ void exec_parse_message(const char* query_string,        /* string to execute */
             GPCEnv *env = GPC->PlanFetch(query_string, strlen(query_string), numParams);
 
             if (env != NULL) {
-                GPC->PrepareStore(stmt_name, env->plansource, false);
-                GPC->RefcountAdd(env->plansource);
+                /* the prepared statement takes over the pin PlanFetch took */
+                PG_TRY();
+                {
+                    GPC->PrepareStore(stmt_name, env->plansource, false);
+                }
+                PG_CATCH();
+                {
+                    GPC->RefcountSub(env->plansource);
+                    PG_RE_THROW();
+                }
+                PG_END_TRY();
                 goto pass_parsing;
             }
         }
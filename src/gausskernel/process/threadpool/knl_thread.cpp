@@ -1154,6 +1154,7 @@ static void knl_t_storage_init(knl_t_storage_context* storage_cxt)
     storage_cxt->smoothed_alloc = 0;
     storage_cxt->smoothed_density = 10.0;
     storage_cxt->StrategyControl = NULL;
+    storage_cxt->StrategyHomePartition = -1;
     storage_cxt->CacheBlockInProgressIO = CACHE_BLOCK_INVALID_IDX;
     storage_cxt->CacheBlockInProgressUncompress = CACHE_BLOCK_INVALID_IDX;
     storage_cxt->MetaBlockInProgressIO = CACHE_BLOCK_INVALID_IDX;
@@ -139,6 +139,7 @@ void ThreadPoolControler::Init(bool enableNumaDistribute)
 
     for (int i = 0; i < m_groupNum; i++) {
         m_groups[i]->WaitReady();
+        m_groups[i]->InitStealOrder(m_groups, m_groupNum);
     }
 
 #ifdef __USE_NUMA
@@ -579,6 +580,11 @@ ThreadPoolStat* ThreadPoolControler::GetThreadPoolStat(uint32* num)
     return result;
 }
 
+QueueWaitSample* ThreadPoolControler::GetQueueWaitHistory(uint32* num)
+{
+    return m_scheduler->GetQueueWaitHistory(num);
+}
+
 void ThreadPoolControler::CloseAllSessions()
 {
     m_sessCtrl->MarkAllSessionClose();
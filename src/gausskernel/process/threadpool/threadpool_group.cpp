@@ -23,6 +23,9 @@
  * ---------------------------------------------------------------------------------------
  */
 
+#ifdef __USE_NUMA
+#include <numa.h>
+#endif
 #include "postgres.h"
 #include "knl/knl_variable.h"
 
@@ -68,11 +71,15 @@ ThreadPoolGroup::ThreadPoolGroup(int maxWorkerNum, int expectWorkerNum,
       m_sessionCount(0),
       m_waitServeSessionCount(0),
       m_processTaskCount(0),
+      m_stealSessionCount(0),
+      m_stolenSessionCount(0),
       m_groupId(groupId),
       m_numaId(numaId),
       m_groupCpuNum(cpuNum),
       m_groupCpuArr(cpuArr),
       m_workers(NULL),
+      m_stealGroups(NULL),
+      m_stealGroupNum(0),
       m_enableNumaDistribute(false)
 {
     m_context = AllocSetContextCreate(g_instance.instance_context,
@@ -83,6 +90,9 @@ ThreadPoolGroup::ThreadPoolGroup(int maxWorkerNum, int expectWorkerNum,
         SHARED_CONTEXT);
     pthread_mutex_init(&m_mutex, NULL);
     CPU_ZERO(&m_nodeCpuSet);
+    for (int i = 0; i < QUEUE_WAIT_BUCKETS; i++) {
+        m_queueWaitHist[i] = 0;
+    }
 }
 
 ThreadPoolGroup::~ThreadPoolGroup()
@@ -91,6 +101,7 @@ ThreadPoolGroup::~ThreadPoolGroup()
     m_listener = NULL;
     m_groupCpuArr = NULL;
     m_workers = NULL;
+    m_stealGroups = NULL;
 }
 
 void ThreadPoolGroup::init(bool enableNumaDistribute)
@@ -180,18 +191,18 @@ void ThreadPoolGroup::GetThreadPoolGroupStat(ThreadPoolStat* stat)
     stat->listenerNum = m_listenerNum;
 
     int rc = sprintf_s(stat->workerInfo, STATUS_INFO_SIZE,
-        "default: %d new: %d expect: %d actual: %d idle: %d pending: %d",
+        "default: %d new: %d expect: %d actual: %d idle: %d pending: %d steal: %lu",
         m_defaultWorkerNum, m_expectWorkerNum - m_defaultWorkerNum, m_expectWorkerNum,
-        m_workerNum, m_idleWorkerNum, m_pendingWorkerNum);
+        m_workerNum, m_idleWorkerNum, m_pendingWorkerNum, m_stealSessionCount);
     securec_check_ss(rc, "\0", "\0");
 
     int run_session_num = m_workerNum - m_idleWorkerNum;
     int idle_session_num = m_sessionCount - m_waitServeSessionCount - run_session_num;
     idle_session_num = (idle_session_num < 0) ? 0 : idle_session_num;
     rc = sprintf_s(stat->sessionInfo, STATUS_INFO_SIZE,
-        "total: %d waiting: %d running:%d idle: %d",
+        "total: %d waiting: %d running:%d idle: %d stolen: %lu",
         m_sessionCount, m_waitServeSessionCount,
-        run_session_num, idle_session_num);
+        run_session_num, idle_session_num, m_stolenSessionCount);
     securec_check_ss(rc, "\0", "\0");
 }
 
@@ -328,6 +339,133 @@ bool ThreadPoolGroup::IsGroupHang()
     return is_hang;
 }
 
+/*
+ * Decide in which order an idle worker of this group looks at the other
+ * groups for ready sessions: nearest numa node first, and among groups at
+ * the same distance, starting after our own group id so that the idle
+ * workers of different groups don't all go after the same victim.
+ */
+void ThreadPoolGroup::InitStealOrder(ThreadPoolGroup** groups, int groupNum)
+{
+    m_stealGroups = (ThreadPoolGroup**)MemoryContextAllocZero(m_context, sizeof(ThreadPoolGroup*) * groupNum);
+    m_stealGroupNum = 0;
+
+    for (int i = 1; i < groupNum; i++) {
+        ThreadPoolGroup* group = groups[(m_groupId + i) % groupNum];
+        int distance = GetNumaDistance(group);
+        int j = m_stealGroupNum;
+
+        /* insertion sort, keeping the rotated order among equal distances */
+        while (j > 0 && GetNumaDistance(m_stealGroups[j - 1]) > distance) {
+            m_stealGroups[j] = m_stealGroups[j - 1];
+            j--;
+        }
+        m_stealGroups[j] = group;
+        m_stealGroupNum++;
+    }
+}
+
+/*
+ * Called by an idle worker of this group that found no ready session of its
+ * own.  Take a ready session from the nearest group that has one waiting.
+ * The session still belongs to the group it was taken from: the worker gives
+ * it back to that group's listener when it detaches.
+ */
+bool ThreadPoolGroup::StealSession(ThreadPoolWorker* worker)
+{
+    for (int i = 0; i < m_stealGroupNum; i++) {
+        ThreadPoolGroup* victim = m_stealGroups[i];
+        knl_session_context* session = NULL;
+
+        if (victim->m_waitServeSessionCount <= 0) {
+            continue;
+        }
+
+        session = victim->GetListener()->HandOverSession();
+        if (session != NULL) {
+            worker->SetSession(session, victim);
+            pg_atomic_fetch_add_u32((volatile uint32*)&m_processTaskCount, 1);
+            pg_atomic_fetch_add_u64((volatile uint64*)&m_stealSessionCount, 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Called by our listener when a session became ready while none of our
+ * workers was free.  Idle workers only steal before they go to sleep, so
+ * wake up one of the nearest group that has any, rather than leaving the
+ * session to wait for one of our own workers.
+ */
+void ThreadPoolGroup::WakeUpStealer()
+{
+    for (int i = 0; i < m_stealGroupNum; i++) {
+        ThreadPoolGroup* group = m_stealGroups[i];
+
+        if (group->m_idleWorkerNum <= 0) {
+            continue;
+        }
+
+        if (group->GetListener()->WakeUpIdleWorker()) {
+            return;
+        }
+    }
+}
+
+/*
+ * Count how long a session of ours waited between the listener seeing it
+ * become ready and a worker picking it up.
+ */
+void ThreadPoolGroup::RecordQueueWait(TimestampTz queueTime)
+{
+    TimestampTz now = GetCurrentTimestamp();
+    uint64 val = ((now > queueTime) ? (uint64)(now - queueTime) : 0) + 1;
+    int bucket = 0;
+
+    /* bucket i holds the waits in [2^i - 1, 2^(i+1) - 1) us */
+    while (val > 1 && bucket < QUEUE_WAIT_BUCKETS - 1) {
+        val >>= 1;
+        bucket++;
+    }
+    pg_atomic_fetch_add_u32(&m_queueWaitHist[bucket], 1);
+}
+
+/*
+ * Return the given percentile of the queue waits counted since the last call,
+ * in microseconds, and start counting afresh.  The result is the upper bound
+ * of the bucket the percentile falls into; *samples is set to the number of
+ * waits it is based on, and -1 is returned if there were none.
+ */
+int64 ThreadPoolGroup::ConsumeQueueWaitPercentile(double percentile, uint64* samples)
+{
+    uint32 hist[QUEUE_WAIT_BUCKETS];
+    uint64 total = 0;
+    uint64 rank;
+    uint64 seen = 0;
+
+    for (int i = 0; i < QUEUE_WAIT_BUCKETS; i++) {
+        hist[i] = pg_atomic_exchange_u32(&m_queueWaitHist[i], 0);
+        total += hist[i];
+    }
+
+    *samples = total;
+    if (total == 0) {
+        return -1;
+    }
+
+    /* the number of waits at or below the percentile, rounded up */
+    rank = total - (uint64)((1.0 - percentile) * total);
+    for (int i = 0; i < QUEUE_WAIT_BUCKETS; i++) {
+        seen += hist[i];
+        if (seen >= rank) {
+            return ((int64)1 << (i + 1)) - 1;
+        }
+    }
+    return ((int64)1 << QUEUE_WAIT_BUCKETS) - 1;
+}
+
 void ThreadPoolGroup::AttachThreadToCPU(ThreadId thread, int cpu)
 {
     cpu_set_t cpu_set;
@@ -347,3 +485,13 @@ void ThreadPoolGroup::AttachThreadToNodeLevel(ThreadId thread) const
     if (ret != 0)
         ereport(WARNING, (errmsg("Fail to attach thread %lu to numa node %d", thread, m_numaId)));
 }
+
+int ThreadPoolGroup::GetNumaDistance(const ThreadPoolGroup* other) const
+{
+#ifdef __USE_NUMA
+    if (m_numaId >= 0 && other->m_numaId >= 0 && numa_available() >= 0) {
+        return numa_distance(m_numaId, other->m_numaId);
+    }
+#endif
+    return 0;
+}
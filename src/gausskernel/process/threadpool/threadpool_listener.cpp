@@ -169,10 +169,13 @@ bool ThreadPoolListener::TryFeedWorker(ThreadPoolWorker* worker)
 {
     Dlelem* sc = m_readySessionList->RemoveHead();
     if (sc != NULL) {
-        worker->SetSession((knl_session_context*)sc->dle_val);
+        worker->SetSession((knl_session_context*)sc->dle_val, m_group);
         pg_atomic_fetch_sub_u32((volatile uint32*)&m_group->m_waitServeSessionCount, 1);
         pg_atomic_fetch_add_u32((volatile uint32*)&m_group->m_processTaskCount, 1);
         return true;
+    } else if (m_group->StealSession(worker)) {
+        /* Nothing to do here, but some other group had sessions waiting. */
+        return true;
     } else {
         m_freeWorkerList->AddTail(&worker->m_elem);
         pg_atomic_fetch_add_u32((volatile uint32*)&m_group->m_idleWorkerNum, 1);
@@ -180,6 +183,40 @@ bool ThreadPoolListener::TryFeedWorker(ThreadPoolWorker* worker)
     }
 }
 
+/*
+ * Hand one of our ready sessions over to an idle worker of another group.
+ * Returns NULL if our workers have caught up in the meantime.
+ */
+knl_session_context* ThreadPoolListener::HandOverSession()
+{
+    Dlelem* sc = m_readySessionList->RemoveHead();
+    if (sc == NULL) {
+        return NULL;
+    }
+
+    /* the task is counted by the group whose worker runs it, see StealSession */
+    pg_atomic_fetch_sub_u32((volatile uint32*)&m_group->m_waitServeSessionCount, 1);
+    pg_atomic_fetch_add_u64((volatile uint64*)&m_group->m_stolenSessionCount, 1);
+    return (knl_session_context*)sc->dle_val;
+}
+
+/*
+ * Wake up one of our idle workers so that it steals a ready session of
+ * another group.  Returns false if none of our workers is idle.
+ */
+bool ThreadPoolListener::WakeUpIdleWorker()
+{
+    while (true) {
+        Dlelem* sc = m_freeWorkerList->RemoveHead();
+        if (sc == NULL) {
+            return false;
+        }
+        if (((ThreadPoolWorker*)DLE_VAL(sc))->WakeUpToSteal()) {
+            return true;
+        }
+    }
+}
+
 void ThreadPoolListener::AddNewSession(knl_session_context* session)
 {
     AddEpoll(session);
@@ -286,6 +323,8 @@ knl_session_context* ThreadPoolListener::GetSessionBaseOnEvent(struct epoll_even
 void ThreadPoolListener::DispatchSession(knl_session_context* session)
 {
     m_idleSessionList->Remove(&session->elem);
+    /* The queue wait ends when a worker picks the session up, see WaitNextSession */
+    session->queue_wait_start = GetCurrentTimestamp();
     while (true) {
         Dlelem* sc = m_freeWorkerList->RemoveHead();
         if (sc != NULL) {
@@ -296,6 +335,7 @@ void ThreadPoolListener::DispatchSession(knl_session_context* session)
         } else {
             m_readySessionList->AddTail(&session->elem);
             pg_atomic_fetch_add_u32((volatile uint32*)&m_group->m_waitServeSessionCount, 1);
+            m_group->WakeUpStealer();
             break;
         }
     }
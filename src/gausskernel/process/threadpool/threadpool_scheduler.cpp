@@ -16,6 +16,13 @@
  * threadpool_scheduler.cpp
  *    Scheduler thread is used to manage thread num in thread pool.
  *
+ *    Every second the scheduler looks at how long the sessions of each group
+ *    waited between the listener seeing them become ready and a worker picking
+ *    them up.  With thread_pool_queue_wait_target set, a group whose 95th
+ *    percentile wait exceeds the target is enlarged, and a group is only
+ *    reduced after a long enough stretch within the target.  A group that
+ *    processes nothing with all of its workers blocked is enlarged as well.
+ *
  * IDENTIFICATION
  *    src/gausskernel/process/threadpool/threadpool_scheduler.cpp
  *
@@ -46,6 +53,8 @@
 #define MAX_HANG_TIME 100
 #define REDUCE_THREAD_TIME 100
 #define SHUTDOWN_THREAD_TIME 1000
+#define QUEUE_WAIT_PERCENTILE 0.95
+#define MIN_QUEUE_WAIT_SAMPLES 20
 
 void TpoolSchedulerMain(ThreadPoolScheduler *scheduler)
 {
@@ -63,6 +72,10 @@ ThreadPoolScheduler::ThreadPoolScheduler(int groupNum, ThreadPoolGroup** groups)
     m_tid = 0;
     m_hangTestCount = (uint *)palloc0(sizeof(uint) * groupNum);
     m_freeTestCount = (uint *)palloc0(sizeof(uint) * groupNum);
+    m_history = (QueueWaitSample *)palloc0(sizeof(QueueWaitSample) * QUEUE_WAIT_HISTORY_SIZE);
+    m_historyNext = 0;
+    m_historyNum = 0;
+    pthread_mutex_init(&m_historyLock, NULL);
 }
 
 int ThreadPoolScheduler::StartUp()
@@ -78,19 +91,87 @@ void ThreadPoolScheduler::DynamicAdjustThreadPool()
     for (int i = 0; i < m_groupNum; i++) {
         group = m_groups[i];
 
+        uint64 samples = 0;
+        int64 wait_percentile = group->ConsumeQueueWaitPercentile(QUEUE_WAIT_PERCENTILE, &samples);
+        int old_expect_num = group->m_expectWorkerNum;
+
         if (pmState == PM_RUN) {
             /* When no idle worker and no task has been processed, the system may hang. */
             if (group->IsGroupHang()) {
                 m_hangTestCount[i]++;
                 m_freeTestCount[i] = 0;
                 EnlargeWorkerIfNecessage(i);
+            } else if (QueueWaitOverTarget(wait_percentile, samples)) {
+                /* Sessions wait too long for a worker, add some right away. */
+                m_hangTestCount[i] = 0;
+                m_freeTestCount[i] = 0;
+                (void)group->EnlargeWorkers(THREAD_SCHEDULER_STEP);
             } else {
                 m_hangTestCount[i] = 0;
                 m_freeTestCount[i]++;
                 ReduceWorkerIfNecessary(i);
             }
         }
+
+        if (samples > 0 || group->m_expectWorkerNum != old_expect_num) {
+            AddQueueWaitSample(group, samples, wait_percentile, old_expect_num);
+        }
+    }
+}
+
+bool ThreadPoolScheduler::QueueWaitOverTarget(int64 waitPercentile, uint64 samples) const
+{
+    int target = g_instance.attr.attr_common.thread_pool_queue_wait_target;
+
+    /* A handful of sessions tells nothing about the percentile */
+    if (target <= 0 || samples < MIN_QUEUE_WAIT_SAMPLES) {
+        return false;
+    }
+
+    return waitPercentile > (int64)target * 1000;
+}
+
+void ThreadPoolScheduler::AddQueueWaitSample(
+    ThreadPoolGroup* group, uint64 samples, int64 waitPercentile, int oldExpectNum)
+{
+    QueueWaitSample* sample = NULL;
+
+    pthread_mutex_lock(&m_historyLock);
+    sample = &m_history[m_historyNext];
+    sample->sampleTime = GetCurrentTimestamp();
+    sample->groupId = group->GetGroupId();
+    sample->sessions = samples;
+    sample->waitPercentile = waitPercentile;
+    sample->expectWorkerNum = group->m_expectWorkerNum;
+    if (group->m_expectWorkerNum > oldExpectNum) {
+        sample->action = "enlarge";
+    } else if (group->m_expectWorkerNum < oldExpectNum) {
+        sample->action = "reduce";
+    } else {
+        sample->action = "none";
+    }
+    m_historyNext = (m_historyNext + 1) % QUEUE_WAIT_HISTORY_SIZE;
+    m_historyNum = Min(m_historyNum + 1, QUEUE_WAIT_HISTORY_SIZE);
+    pthread_mutex_unlock(&m_historyLock);
+}
+
+/*
+ * Copy out the queue wait history, oldest pass first.
+ */
+QueueWaitSample* ThreadPoolScheduler::GetQueueWaitHistory(uint32* num)
+{
+    QueueWaitSample* result = (QueueWaitSample*)palloc0(sizeof(QueueWaitSample) * QUEUE_WAIT_HISTORY_SIZE);
+    uint32 start;
+
+    pthread_mutex_lock(&m_historyLock);
+    start = (m_historyNext + QUEUE_WAIT_HISTORY_SIZE - m_historyNum) % QUEUE_WAIT_HISTORY_SIZE;
+    for (uint32 i = 0; i < m_historyNum; i++) {
+        result[i] = m_history[(start + i) % QUEUE_WAIT_HISTORY_SIZE];
     }
+    *num = m_historyNum;
+    pthread_mutex_unlock(&m_historyLock);
+
+    return result;
 }
 
 void ThreadPoolScheduler::EnlargeWorkerIfNecessage(int groupIdx)
@@ -77,6 +77,8 @@ ThreadPoolWorker::ThreadPoolWorker(uint idx, ThreadPoolGroup* group, pthread_mut
 {
     m_idx = idx;
     m_group = group;
+    m_sessionGroup = group;
+    m_wakeUpToSteal = false;
     m_tid = InvalidTid;
     m_threadStatus = THREAD_UNINIT;
     m_currentSession = NULL;
@@ -90,6 +92,7 @@ ThreadPoolWorker::~ThreadPoolWorker()
 {
     m_currentSession = NULL;
     m_group = NULL;
+    m_sessionGroup = NULL;
     m_mutex = NULL;
     m_cond = NULL;
 }
@@ -201,6 +204,25 @@ bool ThreadPoolWorker::WakeUpToWork(knl_session_context* session)
     pthread_mutex_lock(m_mutex);
     if (likely(m_threadStatus != THREAD_EXIT)) {
         m_currentSession = session;
+        m_sessionGroup = m_group;
+        pthread_cond_signal(m_cond);
+    } else {
+        succ = false;
+    }
+    pthread_mutex_unlock(m_mutex);
+    return succ;
+}
+
+/*
+ * Wake up an idle worker without giving it a session, so that it looks for
+ * ready sessions of the other groups, see ThreadPoolGroup::WakeUpStealer.
+ */
+bool ThreadPoolWorker::WakeUpToSteal()
+{
+    bool succ = true;
+    pthread_mutex_lock(m_mutex);
+    if (likely(m_threadStatus != THREAD_EXIT)) {
+        m_wakeUpToSteal = true;
         pthread_cond_signal(m_cond);
     } else {
         succ = false;
@@ -333,6 +355,10 @@ void ThreadPoolWorker::WaitNextSession()
         } else if (unlikely(m_threadStatus == THREAD_EXIT)) {
             ShutDownIfNecessary();
         } else if (m_currentSession != NULL) {
+            if (m_currentSession->queue_wait_start != 0) {
+                m_sessionGroup->RecordQueueWait(m_currentSession->queue_wait_start);
+                m_currentSession->queue_wait_start = 0;
+            }
             break;
         }
     
@@ -343,12 +369,13 @@ void ThreadPoolWorker::WaitNextSession()
             WaitState oldStatus = pgstat_report_waitstatus(STATE_WAIT_COMM);
 
             pthread_mutex_lock(m_mutex);
-            while (!m_currentSession) {
+            while (!m_currentSession && !m_wakeUpToSteal) {
                 if (unlikely(m_threadStatus == THREAD_PENDING || m_threadStatus == THREAD_EXIT)) {
                     break;
                 }
                 pthread_cond_wait(m_cond, m_mutex);
             }
+            m_wakeUpToSteal = false;
             pthread_mutex_unlock(m_mutex);
             m_group->GetListener()->RemoveWorkerFromList(this);
             pg_atomic_fetch_sub_u32((volatile uint32*)&m_group->m_idleWorkerNum, 1);
@@ -449,7 +476,7 @@ void ThreadPoolWorker::DetachSessionFromThread()
     m_currentSession->attachPid = (ThreadId)-1;
 
     /* should restore the data before return to listener. */
-    m_group->GetListener()->AddEpoll(m_currentSession);
+    m_sessionGroup->GetListener()->AddEpoll(m_currentSession);
     m_currentSession = NULL;
     u_sess = NULL;
 }
@@ -561,7 +588,7 @@ void ThreadPoolWorker::CleanUpSession(bool threadexit)
         }
 
         /* Close Session. */
-        m_group->GetListener()->DelSessionFromEpoll(m_currentSession);
+        m_sessionGroup->GetListener()->DelSessionFromEpoll(m_currentSession);
 
         /*
          * Record this state in case we reenter this function because
@@ -25,6 +25,12 @@
 
 #include "executor/execParallel.h"
 #include "executor/executor.h"
+#include "executor/hashjoin.h"
+#include "executor/nodeBitmapHeapscan.h"
+#include "executor/nodeHashjoin.h"
+#include "executor/nodeIndexonlyscan.h"
+#include "executor/nodeIndexscan.h"
+#include "executor/nodePartIterator.h"
 #include "executor/nodeSeqscan.h"
 #include "executor/tqueue.h"
 #include "nodes/nodeFuncs.h"
@@ -149,6 +155,12 @@ static bool ExecParallelEstimate(PlanState *planstate, ExecParallelEstimateConte
             case T_SeqScanState:
                 ExecSeqScanEstimate((SeqScanState *)planstate, e->pcxt);
                 break;
+            case T_IndexScanState:
+                ExecIndexScanEstimate((IndexScanState *)planstate, e->pcxt);
+                break;
+            case T_IndexOnlyScanState:
+                ExecIndexOnlyScanEstimate((IndexOnlyScanState *)planstate, e->pcxt);
+                break;
             default:
                 break;
         }
@@ -190,6 +202,29 @@ static bool ExecParallelInitializeDSM(PlanState *planstate, ExecParallelInitiali
                 ExecSeqScanInitializeDSM((SeqScanState *)planstate, d->pcxt, cxt->pwCtx->queryInfo.pscan_num);
                 cxt->pwCtx->queryInfo.pscan_num++;
                 break;
+            case T_IndexScanState:
+                ExecIndexScanInitializeDSM((IndexScanState *)planstate, d->pcxt, cxt->pwCtx->queryInfo.piscan_num);
+                cxt->pwCtx->queryInfo.piscan_num++;
+                break;
+            case T_IndexOnlyScanState:
+                ExecIndexOnlyScanInitializeDSM(
+                    (IndexOnlyScanState *)planstate, d->pcxt, cxt->pwCtx->queryInfo.piscan_num);
+                cxt->pwCtx->queryInfo.piscan_num++;
+                break;
+            case T_HashJoinState:
+                ExecHashJoinInitializeDSM((HashJoinState *)planstate, d->pcxt, cxt->pwCtx->queryInfo.phjstate_num);
+                cxt->pwCtx->queryInfo.phjstate_num++;
+                break;
+            case T_BitmapHeapScanState:
+                ExecBitmapHeapInitializeDSM(
+                    (BitmapHeapScanState *)planstate, d->pcxt, cxt->pwCtx->queryInfo.pbmscan_num);
+                cxt->pwCtx->queryInfo.pbmscan_num++;
+                break;
+            case T_PartIteratorState:
+                ExecPartIteratorInitializeDSM(
+                    (PartIteratorState *)planstate, d->pcxt, cxt->pwCtx->queryInfo.ppiterator_num);
+                cxt->pwCtx->queryInfo.ppiterator_num++;
+                break;
             default:
                 break;
         }
@@ -198,6 +233,40 @@ static bool ExecParallelInitializeDSM(PlanState *planstate, ExecParallelInitiali
     return planstate_tree_walker(planstate, (bool (*)())ExecParallelInitializeDSM, d);
 }
 
+/*
+ * Give parallel-aware plan nodes a chance to reset the shared state they set
+ * up in ExecParallelInitializeDSM, before the workers are relaunched.
+ */
+static bool ExecParallelReInitializeDSM(PlanState *planstate, ParallelContext *pcxt)
+{
+    if (planstate == NULL)
+        return false;
+
+    if (planstate->plan->parallel_aware) {
+        switch (nodeTag(planstate)) {
+            case T_IndexScanState:
+                ExecIndexScanReInitializeDSM((IndexScanState *)planstate, pcxt);
+                break;
+            case T_IndexOnlyScanState:
+                ExecIndexOnlyScanReInitializeDSM((IndexOnlyScanState *)planstate, pcxt);
+                break;
+            case T_HashJoinState:
+                ExecHashJoinReInitializeDSM((HashJoinState *)planstate, pcxt);
+                break;
+            case T_BitmapHeapScanState:
+                ExecBitmapHeapReInitializeDSM((BitmapHeapScanState *)planstate, pcxt);
+                break;
+            case T_PartIteratorState:
+                ExecPartIteratorReInitializeDSM((PartIteratorState *)planstate, pcxt);
+                break;
+            default:
+                break;
+        }
+    }
+
+    return planstate_tree_walker(planstate, (bool (*)())ExecParallelReInitializeDSM, pcxt);
+}
+
 /*
  * It sets up the response queues for backend workers to return tuples
  * to the main backend and start the workers.
@@ -261,6 +330,7 @@ void ExecParallelReinitialize(ParallelExecutorInfo *pei)
 {
     ReinitializeParallelDSM(pei->pcxt);
     pei->tqueue = ExecParallelSetupTupleQueues(pei->pcxt, true);
+    (void)ExecParallelReInitializeDSM(pei->planstate, pei->pcxt);
     pei->reader = NULL;
     pei->finished = false;
 }
@@ -356,6 +426,10 @@ ParallelExecutorInfo *ExecInitParallelPlan(PlanState *planstate, EState *estate,
     }
 
     queryInfo.pscan = (ParallelHeapScanDesc *)palloc0(sizeof(ParallelHeapScanDesc) * e.nnodes);
+    queryInfo.piscan = (ParallelIndexScanDesc *)palloc0(sizeof(ParallelIndexScanDesc) * e.nnodes);
+    queryInfo.phjstate = (ParallelHashJoinState **)palloc0(sizeof(ParallelHashJoinState *) * e.nnodes);
+    queryInfo.pbmscan = (ParallelBitmapHeapState **)palloc0(sizeof(ParallelBitmapHeapState *) * e.nnodes);
+    queryInfo.ppiterator = (ParallelPartIteratorState **)palloc0(sizeof(ParallelPartIteratorState *) * e.nnodes);
 
     /*
      * Give parallel-aware nodes a chance to initialize their shared data.
@@ -591,6 +665,21 @@ static bool ExecParallelInitializeWorker(PlanState *planstate, void *context)
             case T_SeqScanState:
                 ExecSeqScanInitializeWorker((SeqScanState *)planstate, context);
                 break;
+            case T_IndexScanState:
+                ExecIndexScanInitializeWorker((IndexScanState *)planstate, context);
+                break;
+            case T_IndexOnlyScanState:
+                ExecIndexOnlyScanInitializeWorker((IndexOnlyScanState *)planstate, context);
+                break;
+            case T_HashJoinState:
+                ExecHashJoinInitializeWorker((HashJoinState *)planstate, context);
+                break;
+            case T_BitmapHeapScanState:
+                ExecBitmapHeapInitializeWorker((BitmapHeapScanState *)planstate, context);
+                break;
+            case T_PartIteratorState:
+                ExecPartIteratorInitializeWorker((PartIteratorState *)planstate, context);
+                break;
             default:
                 break;
         }
@@ -595,6 +595,30 @@ List* GetAccessedVarnoList(List* targetList, List* qual)
     return list_concat(tmp_pi.pi_acessedVarNumbers, tmp_pi.pi_lateAceessVarNumbers);
 }
 
+/*
+ * @Description: Get the runtime bloom filter a hash join has published for a scan column.
+ * @in estate: Executor state holding the bloom filter array.
+ * @in var: Scan column the filter was planned on (plan->var_list member).
+ * @in idx: Filter slot of this column (plan->filterIndexList member).
+ * @return: The filter, or NULL if the join has not built it (yet) or it can not be
+ *          probed with the column's datums directly.
+ */
+filter::BloomFilter* ExecGetRuntimeFilter(EState* estate, Var* var, int idx)
+{
+    filter::BloomFilter* bf = NULL;
+
+    if (idx < 0 || idx >= estate->es_bloom_filter.array_size) {
+        return NULL;
+    }
+
+    bf = estate->es_bloom_filter.bfarray[idx];
+    if (bf == NULL || bf->getDataType() != var->vartype || !SATISFY_RUNTIME_FILTER(var->vartype)) {
+        return NULL;
+    }
+
+    return bf;
+}
+
 ProjectionInfo* ExecBuildVecProjectionInfo(
     List* targetList, List* nt_qual, ExprContext* econtext, TupleTableSlot* slot, TupleDesc inputDesc)
 {
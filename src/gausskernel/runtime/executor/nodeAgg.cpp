@@ -57,6 +57,12 @@
  *	  The node's regular econtext (aggstate->ss.ps.ps_ExprContext) is used to
  *	  run finalize functions and compute the output tuple; this context can be
  *	  reset once per output tuple.
+ *
+ *	  For parallel aggregation the work is split across two Agg nodes.  The
+ *	  Partial Agg below a Gather stops after the transition step and returns
+ *	  the transvalues; the Finalize Agg above it feeds them to the collection
+ *	  function (the same path used to combine Datanode results in PGXC) and
+ *	  then applies the finalfunc.
 
  *
  *	  The executor's AggState node is passed as the fmgr "context" value in
@@ -2283,6 +2289,13 @@ AggState* ExecInitAgg(Agg* node, EState* estate, int eflags)
             }
         }
 #endif /* PGXC */
+        /*
+         * A Partial Agg below a Gather returns transition values; the final
+         * functions are applied by the Finalize Agg above the Gather.
+         */
+        if (node->parallel_stage == AGG_PARALLEL_PARTIAL) {
+            peraggstate->finalfn_oid = finalfn_oid = InvalidOid;
+        }
         /* Check that aggregate owner has permission to call component fns */
         {
             HeapTuple procTuple;
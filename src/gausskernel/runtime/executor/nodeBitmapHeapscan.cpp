@@ -32,6 +32,9 @@
  *		ExecInitBitmapHeapScan		creates and initializes state info.
  *		ExecReScanBitmapHeapScan	prepares to rescan the plan.
  *		ExecEndBitmapHeapScan		releases all storage.
+ *		ExecBitmapHeapInitializeDSM	initialize DSM for parallel bitmap heap scan
+ *		ExecBitmapHeapReInitializeDSM reinitialize DSM for fresh scan
+ *		ExecBitmapHeapInitializeWorker attach to DSM info in parallel worker
  */
 #include "postgres.h"
 #include "knl/knl_variable.h"
@@ -44,6 +47,7 @@
 #include "pgstat.h"
 #include "storage/bufmgr.h"
 #include "storage/predicate.h"
+#include "storage/spin.h"
 #include "utils/memutils.h"
 #include "utils/rel.h"
 #include "utils/rel_gs.h"
@@ -55,10 +59,16 @@
 static TupleTableSlot* BitmapHbucketTblNext(BitmapHeapScanState* node);
 static TupleTableSlot* BitmapHeapTblNext(BitmapHeapScanState* node);
 static void bitgetpage(HeapScanDesc scan, TBMIterateResult* tbmres);
+static inline int BitmapHeapPrefetchMax(BitmapHeapScanState* node);
 static void ExecInitPartitionForBitmapHeapScan(BitmapHeapScanState* scanstate, EState* estate);
 static void ExecInitNextPartitionForBitmapHeapScan(BitmapHeapScanState* node);
 static void BitmapHeapPrefetchNext(
     BitmapHeapScanState* node, HeapScanDesc scan, const TIDBitmap* tbm, TBMIterator** prefetch_iterator);
+static bool BitmapShouldInitializeSharedState(ParallelBitmapHeapState* pstate);
+static void BitmapDoneInitializingSharedState(ParallelBitmapHeapState* pstate);
+static void BitmapHeapSharedAdjustPrefetchIterator(BitmapHeapScanState* node);
+static void BitmapHeapSharedAdjustPrefetchTarget(ParallelBitmapHeapState* pstate);
+static void BitmapHeapSharedPrefetchNext(BitmapHeapScanState* node, HeapScanDesc scan);
 
 /* This struct is used for partition switch while prefetch pages */
 typedef struct PrefetchNode {
@@ -76,11 +86,20 @@ void BitmapHeapFree(BitmapHeapScanState* node)
         tbm_end_iterate(node->prefetch_iterator);
         node->prefetch_iterator = NULL;
     }
+    if (node->shared_tbmiterator != NULL) {
+        tbm_end_shared_iterate(node->shared_tbmiterator);
+        node->shared_tbmiterator = NULL;
+    }
+    if (node->shared_prefetch_iterator != NULL) {
+        tbm_end_shared_iterate(node->shared_prefetch_iterator);
+        node->shared_prefetch_iterator = NULL;
+    }
     if (node->tbm != NULL) {
         tbm_free(node->tbm);
         node->tbm = NULL;
     }
     node->tbmres = NULL;
+    node->initialized = false;
 }
 static TupleTableSlot* BitmapHbucketTblNext(BitmapHeapScanState* node)
 {
@@ -146,28 +165,58 @@ static TupleTableSlot* BitmapHeapTblNext(BitmapHeapScanState* node)
      * GUC-controlled maximum, target_prefetch_pages.  This is to avoid doing
      * a lot of prefetching in a scan that stops after a few tuples because of
      * a LIMIT.
+     *
+     * In a parallel scan only one participant runs the index scans; it
+     * publishes the bitmap through shared iterators, to which all the
+     * participants then attach.
      */
-    if (tbm == NULL) {
-        tbm = (TIDBitmap*)MultiExecProcNode(outerPlanState(node));
-
-        if (tbm == NULL || !IsA(tbm, TIDBitmap)) {
-            ereport(ERROR,
-                (errcode(ERRCODE_UNRECOGNIZED_NODE_TYPE),
-                    errmodule(MOD_EXECUTOR),
-                    errmsg("unrecognized result from subplan for BitmapHeapScan.")));
+    if (!node->initialized) {
+        if (node->pstate == NULL || BitmapShouldInitializeSharedState(node->pstate)) {
+            tbm = (TIDBitmap*)MultiExecProcNode(outerPlanState(node));
+
+            if (tbm == NULL || !IsA(tbm, TIDBitmap)) {
+                ereport(ERROR,
+                    (errcode(ERRCODE_UNRECOGNIZED_NODE_TYPE),
+                        errmodule(MOD_EXECUTOR),
+                        errmsg("unrecognized result from subplan for BitmapHeapScan.")));
+            }
+
+            node->tbm = tbm;
         }
 
-        node->tbm = tbm;
-        node->tbmiterator = tbmiterator = tbm_begin_iterate(tbm);
-        node->tbmres = tbmres = NULL;
+        if (node->pstate == NULL) {
+            node->tbmiterator = tbmiterator = tbm_begin_iterate(tbm);
 
 #ifdef USE_PREFETCH
-        if (u_sess->storage_cxt.target_prefetch_pages > 0) {
-            node->prefetch_iterator = prefetch_iterator = tbm_begin_iterate(tbm);
-            node->prefetch_pages = 0;
-            node->prefetch_target = -1;
-        }
+            if (u_sess->storage_cxt.target_prefetch_pages > 0) {
+                node->prefetch_iterator = prefetch_iterator = tbm_begin_iterate(tbm);
+                node->prefetch_pages = 0;
+                node->prefetch_target = -1;
+            }
 #endif
+        } else {
+            ParallelBitmapHeapState* pstate = node->pstate;
+
+            if (tbm != NULL) {
+                pstate->tbmiterator = tbm_prepare_shared_iterate(tbm, pstate->cxt);
+#ifdef USE_PREFETCH
+                if (u_sess->storage_cxt.target_prefetch_pages > 0) {
+                    pstate->prefetch_iterator = tbm_prepare_shared_iterate(tbm, pstate->cxt);
+                    pstate->prefetch_pages = 0;
+                    pstate->prefetch_target = -1;
+                }
+#endif
+                BitmapDoneInitializingSharedState(pstate);
+            }
+
+            node->shared_tbmiterator = tbm_attach_shared_iterate(pstate->tbmiterator);
+            if (pstate->prefetch_iterator != NULL) {
+                node->shared_prefetch_iterator = tbm_attach_shared_iterate(pstate->prefetch_iterator);
+            }
+        }
+
+        node->tbmres = tbmres = NULL;
+        node->initialized = true;
     }
 
     for (;;) {
@@ -178,14 +227,21 @@ static TupleTableSlot* BitmapHeapTblNext(BitmapHeapScanState* node)
          * Get next page of results if needed
          */
         if (tbmres == NULL) {
-            node->tbmres = tbmres = tbm_iterate(tbmiterator);
+            if (node->pstate == NULL) {
+                node->tbmres = tbmres = tbm_iterate(tbmiterator);
+            } else {
+                node->tbmres = tbmres = tbm_shared_iterate(node->shared_tbmiterator);
+            }
             if (tbmres == NULL) {
                 /* no more entries in the bitmap */
                 break;
             }
 
 #ifdef USE_PREFETCH
-            if (node->prefetch_pages > 0) {
+            if (node->pstate != NULL) {
+                /* Other participants move the shared prefetch iterator too */
+                BitmapHeapSharedAdjustPrefetchIterator(node);
+            } else if (node->prefetch_pages > 0) {
                 /* The main iterator has closed the distance by one page */
                 node->prefetch_pages--;
             } else if (prefetch_iterator != NULL) {
@@ -228,9 +284,25 @@ static TupleTableSlot* BitmapHeapTblNext(BitmapHeapScanState* node)
             }
 
             /*
-             * Fetch the current heap page and identify candidate tuples.
+             * Fetch the current heap page and identify candidate tuples.  With
+             * ADIO the read is timed, so that the prefetch distance follows
+             * how long the reads still have to wait for the device.
              */
-            bitgetpage(scan, tbmres);
+            ADIO_RUN()
+            {
+                if (node->pstate == NULL) {
+                    PrefetchDistanceReadStart(&node->prefetch_distance);
+                    bitgetpage(scan, tbmres);
+                    PrefetchDistanceReadDone(&node->prefetch_distance);
+                } else {
+                    bitgetpage(scan, tbmres);
+                }
+            }
+            ADIO_ELSE()
+            {
+                bitgetpage(scan, tbmres);
+            }
+            ADIO_END();
 
             /* In single mode and hot standby, we may get a null buffer if index
              * replayed before the tid replayed. This is acceptable, so we skip
@@ -256,14 +328,21 @@ static TupleTableSlot* BitmapHeapTblNext(BitmapHeapScanState* node)
              * page/tuple, then to one after the second tuple is fetched, then
              * it doubles as later pages are fetched.
              */
-            if (node->prefetch_target >= u_sess->storage_cxt.target_prefetch_pages)
-                /* don't increase any further */;
-            else if (node->prefetch_target >= u_sess->storage_cxt.target_prefetch_pages / 2)
-                node->prefetch_target = u_sess->storage_cxt.target_prefetch_pages;
-            else if (node->prefetch_target > 0)
-                node->prefetch_target *= 2;
-            else
-                node->prefetch_target++;
+            if (node->pstate != NULL) {
+                BitmapHeapSharedAdjustPrefetchTarget(node->pstate);
+            } else {
+                int prefetch_max = BitmapHeapPrefetchMax(node);
+
+                if (node->prefetch_target >= prefetch_max)
+                    /* don't increase any further, and follow a shrunk distance */
+                    node->prefetch_target = prefetch_max;
+                else if (node->prefetch_target >= prefetch_max / 2)
+                    node->prefetch_target = prefetch_max;
+                else if (node->prefetch_target > 0)
+                    node->prefetch_target *= 2;
+                else
+                    node->prefetch_target++;
+            }
 #endif /* USE_PREFETCH */
         } else {
             /*
@@ -275,9 +354,10 @@ static TupleTableSlot* BitmapHeapTblNext(BitmapHeapScanState* node)
 
             /*
              * Try to prefetch at least a few pages even before we get to the
-             * second page if we don't stop reading after the first tuple.
+             * second page if we don't stop reading after the first tuple.  A
+             * parallel scan only ramps up the shared target on new pages.
              */
-            if (node->prefetch_target < u_sess->storage_cxt.target_prefetch_pages)
+            if (node->pstate == NULL && node->prefetch_target < BitmapHeapPrefetchMax(node))
                 node->prefetch_target++;
 #endif /* USE_PREFETCH */
         }
@@ -291,7 +371,11 @@ static TupleTableSlot* BitmapHeapTblNext(BitmapHeapScanState* node)
         }
 
 #ifdef USE_PREFETCH
-        BitmapHeapPrefetchNext(node, scan, tbm, &prefetch_iterator);
+        if (node->pstate != NULL) {
+            BitmapHeapSharedPrefetchNext(node, scan);
+        } else {
+            BitmapHeapPrefetchNext(node, scan, tbm, &prefetch_iterator);
+        }
 #endif /* USE_PREFETCH */
 
         /*
@@ -621,6 +705,13 @@ BitmapHeapScanState* ExecInitBitmapHeapScan(BitmapHeapScan* node, EState* estate
     scanstate->prefetch_iterator = NULL;
     scanstate->prefetch_pages = 0;
     scanstate->prefetch_target = 0;
+    PrefetchDistanceInit(&scanstate->prefetch_distance,
+        Max(u_sess->storage_cxt.target_prefetch_pages,
+            Min(u_sess->attr.attr_storage.prefetch_quantity, g_instance.attr.attr_storage.NBuffers / 4)));
+    scanstate->initialized = false;
+    scanstate->pstate = NULL;
+    scanstate->shared_tbmiterator = NULL;
+    scanstate->shared_prefetch_iterator = NULL;
     scanstate->ss.isPartTbl = node->scan.isPartTbl;
     scanstate->ss.currentSlot = 0;
     scanstate->ss.partScanDirection = node->scan.partScanDirection;
@@ -795,6 +886,23 @@ static void ExecInitPartitionForBitmapHeapScan(BitmapHeapScanState* scanstate, E
     }
 }
 
+/*
+ * Ceiling of the prefetch target of a non-parallel scan.  Without ADIO this
+ * is the GUC-controlled target_prefetch_pages.  With ADIO the list prefetch
+ * is cheap enough to run further ahead, so the ceiling is the adaptive
+ * distance, which grows while page reads still stall on I/O.
+ */
+static inline int BitmapHeapPrefetchMax(BitmapHeapScanState* node)
+{
+    ADIO_RUN()
+    {
+        return node->prefetch_distance.distance;
+    }
+    ADIO_END();
+
+    return u_sess->storage_cxt.target_prefetch_pages;
+}
+
 /*
  * We issue prefetch requests *after* fetching the current page to try
  * to avoid having prefetching interfere with the main I/O. Also, this
@@ -918,3 +1026,232 @@ void BitmapHeapPrefetchNext(
     }
     ADIO_END();
 }
+
+/*
+ * BitmapShouldInitializeSharedState
+ *
+ * The first participant to come here builds the bitmap and returns true.
+ * Any other participant waits until the bitmap has been published and
+ * returns false.
+ */
+static bool BitmapShouldInitializeSharedState(ParallelBitmapHeapState* pstate)
+{
+    SharedBitmapState state;
+
+    for (;;) {
+        SpinLockAcquire(&pstate->mutex);
+        state = pstate->state;
+        if (pstate->state == BM_INITIAL) {
+            pstate->state = BM_INPROGRESS;
+        }
+        SpinLockRelease(&pstate->mutex);
+
+        /* Exit if the bitmap is done, or if we are the one to build it */
+        if (state != BM_INPROGRESS) {
+            break;
+        }
+
+        /* Wait for the participant building the bitmap */
+        ConditionVariableSleep(&pstate->cv);
+    }
+    ConditionVariableCancelSleep();
+
+    return (state == BM_INITIAL);
+}
+
+/*
+ * BitmapDoneInitializingSharedState
+ *
+ * Mark the shared iterators as ready and wake up the waiting participants.
+ */
+static void BitmapDoneInitializingSharedState(ParallelBitmapHeapState* pstate)
+{
+    SpinLockAcquire(&pstate->mutex);
+    pstate->state = BM_FINISHED;
+    SpinLockRelease(&pstate->mutex);
+    ConditionVariableBroadcast(&pstate->cv);
+}
+
+/*
+ * BitmapHeapSharedAdjustPrefetchIterator
+ *
+ * Parallel counterpart of keeping the prefetch iterator ahead of the main
+ * one.  Pages claimed by other participants move the shared iterators too,
+ * so the two cannot be compared block by block as in the serial scan.
+ */
+static void BitmapHeapSharedAdjustPrefetchIterator(BitmapHeapScanState* node)
+{
+    ParallelBitmapHeapState* pstate = node->pstate;
+
+    if (node->shared_prefetch_iterator == NULL) {
+        return;
+    }
+
+    SpinLockAcquire(&pstate->mutex);
+    if (pstate->prefetch_pages > 0) {
+        /* The main iterator has closed the distance by one page */
+        pstate->prefetch_pages--;
+        SpinLockRelease(&pstate->mutex);
+    } else {
+        SpinLockRelease(&pstate->mutex);
+
+        /* Do not let the prefetch iterator get behind the main one */
+        (void)tbm_shared_iterate(node->shared_prefetch_iterator);
+    }
+}
+
+/*
+ * BitmapHeapSharedAdjustPrefetchTarget
+ *
+ * Ramp up the shared prefetch distance as in the serial scan.
+ */
+static void BitmapHeapSharedAdjustPrefetchTarget(ParallelBitmapHeapState* pstate)
+{
+    int target_prefetch_pages = u_sess->storage_cxt.target_prefetch_pages;
+
+    /* Check without the lock first; the target never decreases during a scan */
+    if (pstate->prefetch_target >= target_prefetch_pages) {
+        return;
+    }
+
+    SpinLockAcquire(&pstate->mutex);
+    if (pstate->prefetch_target >= target_prefetch_pages)
+        /* don't increase any further */;
+    else if (pstate->prefetch_target >= target_prefetch_pages / 2)
+        pstate->prefetch_target = target_prefetch_pages;
+    else if (pstate->prefetch_target > 0)
+        pstate->prefetch_target *= 2;
+    else
+        pstate->prefetch_target++;
+    SpinLockRelease(&pstate->mutex);
+}
+
+/*
+ * BitmapHeapSharedPrefetchNext
+ *
+ * Parallel counterpart of BitmapHeapPrefetchNext.  Each page is counted
+ * against the shared prefetch distance before it is taken from the shared
+ * prefetch iterator, so the participants together never run further ahead
+ * than prefetch_target pages.
+ */
+static void BitmapHeapSharedPrefetchNext(BitmapHeapScanState* node, HeapScanDesc scan)
+{
+    ParallelBitmapHeapState* pstate = node->pstate;
+
+    if (node->shared_prefetch_iterator == NULL || pstate->prefetch_pages >= pstate->prefetch_target) {
+        return;
+    }
+
+    for (;;) {
+        TBMIterateResult* tbmpre = NULL;
+        bool do_prefetch = false;
+
+        /* Another participant may have got ahead of us, so recheck */
+        SpinLockAcquire(&pstate->mutex);
+        if (pstate->prefetch_pages < pstate->prefetch_target) {
+            pstate->prefetch_pages++;
+            do_prefetch = true;
+        }
+        SpinLockRelease(&pstate->mutex);
+
+        if (!do_prefetch) {
+            break;
+        }
+
+        tbmpre = tbm_shared_iterate(node->shared_prefetch_iterator);
+        if (tbmpre == NULL) {
+            /* No more pages to prefetch */
+            tbm_end_shared_iterate(node->shared_prefetch_iterator);
+            node->shared_prefetch_iterator = NULL;
+            break;
+        }
+
+        ADIO_RUN()
+        {
+            PageListPrefetch(scan->rs_rd, MAIN_FORKNUM, &tbmpre->blockno, 1, 0, 0);
+        }
+        ADIO_ELSE()
+        {
+            PrefetchBuffer(scan->rs_rd, MAIN_FORKNUM, tbmpre->blockno);
+        }
+        ADIO_END();
+    }
+}
+
+/* ----------------------------------------------------------------
+ *		ExecBitmapHeapInitializeDSM
+ *
+ *		Set up the shared state for a parallel bitmap heap scan.
+ * ----------------------------------------------------------------
+ */
+void ExecBitmapHeapInitializeDSM(BitmapHeapScanState* node, ParallelContext* pcxt, int nodeid)
+{
+    knl_u_parallel_context* cxt = (knl_u_parallel_context*)pcxt->seg;
+    ParallelBitmapHeapState* pstate = NULL;
+
+    /* Here we can't use palloc, cause we have switch to old memctx in ExecInitParallelPlan */
+    pstate = (ParallelBitmapHeapState*)MemoryContextAllocZero(cxt->memCtx, sizeof(ParallelBitmapHeapState));
+    pstate->plan_node_id = node->ss.ps.plan->plan_node_id;
+    pstate->cxt = cxt->memCtx;
+    pstate->tbmiterator = NULL;
+    pstate->prefetch_iterator = NULL;
+    SpinLockInit(&pstate->mutex);
+    pstate->prefetch_pages = 0;
+    pstate->prefetch_target = 0;
+    pstate->state = BM_INITIAL;
+    ConditionVariableInit(&pstate->cv);
+
+    cxt->pwCtx->queryInfo.pbmscan[nodeid] = pstate;
+    node->pstate = pstate;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecBitmapHeapReInitializeDSM
+ *
+ *		Reset the shared state before beginning a fresh scan.  The
+ *		workers of the previous scan are gone, so nobody else can be
+ *		attached to the shared iterators.
+ * ----------------------------------------------------------------
+ */
+void ExecBitmapHeapReInitializeDSM(BitmapHeapScanState* node, ParallelContext* pcxt)
+{
+    ParallelBitmapHeapState* pstate = node->pstate;
+
+    if (pstate->tbmiterator != NULL) {
+        tbm_free_shared_area(pstate->tbmiterator);
+        pstate->tbmiterator = NULL;
+    }
+    if (pstate->prefetch_iterator != NULL) {
+        tbm_free_shared_area(pstate->prefetch_iterator);
+        pstate->prefetch_iterator = NULL;
+    }
+
+    pstate->prefetch_pages = 0;
+    pstate->prefetch_target = 0;
+    pstate->state = BM_INITIAL;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecBitmapHeapInitializeWorker
+ *
+ *		Attach to the shared state set up by the leader.
+ * ----------------------------------------------------------------
+ */
+void ExecBitmapHeapInitializeWorker(BitmapHeapScanState* node, void* context)
+{
+    knl_u_parallel_context* cxt = (knl_u_parallel_context*)context;
+    ParallelBitmapHeapState* pstate = NULL;
+
+    for (int i = 0; i < cxt->pwCtx->queryInfo.pbmscan_num; i++) {
+        if (node->ss.ps.plan->plan_node_id == cxt->pwCtx->queryInfo.pbmscan[i]->plan_node_id) {
+            pstate = cxt->pwCtx->queryInfo.pbmscan[i];
+            break;
+        }
+    }
+
+    if (pstate == NULL) {
+        ereport(ERROR, (errmsg("could not find plan info, plan node id:%d", node->ss.ps.plan->plan_node_id)));
+    }
+
+    node->pstate = pstate;
+}
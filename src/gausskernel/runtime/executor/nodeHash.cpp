@@ -17,6 +17,10 @@
  *		MultiExecHash	- generate an in-memory hash table of the relation
  *		ExecInitHash	- initialize node and subnodes
  *		ExecEndHash		- shutdown node and subnodes
+ *
+ *		A parallel-aware Hash node builds, together with the other
+ *		participants, a single hash table shared through the parallel
+ *		context; see ParallelHashJoinState in executor/hashjoin.h.
  */
 #include "postgres.h"
 #include "knl/knl_variable.h"
@@ -37,6 +41,7 @@
 #include "pgstat.h"
 #include "pgxc/pgxc.h"
 #include "utils/anls_opt.h"
+#include "utils/atomic.h"
 #include "utils/dynahash.h"
 #include "utils/lsyscache.h"
 #include "utils/memprot.h"
@@ -53,8 +58,17 @@ static void ExecHashBuildSkewHash(HashJoinTable hashtable, Hash* node, int mcvsT
 static void ExecHashSkewTableInsert(HashJoinTable hashtable, TupleTableSlot* slot, uint32 hashvalue, int bucketNumber);
 static void ExecHashRemoveNextSkewBucket(HashJoinTable hashtable);
 static void ExecHashIncreaseBuckets(HashJoinTable hashtable);
+static void MultiExecParallelHash(HashState* node);
+static void ExecParallelHashTableInsert(HashJoinTable hashtable, TupleTableSlot* slot, uint32 hashvalue);
 
 static void* dense_alloc(HashJoinTable hashtable, Size size);
+static void* parallel_dense_alloc(HashJoinTable hashtable, Size size);
+static filter::BloomFilter** ExecHashCreateRuntimeFilters(HashState* node);
+static void ExecHashAddRuntimeFilters(HashState* node, filter::BloomFilter** filters, TupleTableSlot* slot);
+static void ExecHashPublishRuntimeFilters(HashState* node, filter::BloomFilter** filters);
+
+/* same bound as the vectorized hash join puts on its runtime bloom filters */
+#define HASH_RUNTIME_FILTER_MAX_ROWS (DEFAULT_ORC_BLOOM_FILTER_ENTRIES * 5)
 /* ----------------------------------------------------------------
  *		ExecHash
  *
@@ -85,6 +99,8 @@ Node* MultiExecHash(HashState* node)
     TupleTableSlot* slot = NULL;
     ExprContext* econtext = NULL;
     uint32 hashvalue;
+    filter::BloomFilter** filters = NULL;
+    double filterRows = 0;
 
     /* must provide our own instrumentation support */
     if (node->ps.instrument) {
@@ -94,6 +110,12 @@ Node* MultiExecHash(HashState* node)
         node->hashtable->spill_size = &node->spill_size;
     }
 
+    /* a shared hash table is built by all participants together */
+    if (node->parallel_state != NULL) {
+        MultiExecParallelHash(node);
+        return NULL;
+    }
+
     /*
      * get state info from node
      */
@@ -105,6 +127,7 @@ Node* MultiExecHash(HashState* node)
      */
     hashkeys = node->hashkeys;
     econtext = node->ps.ps_ExprContext;
+    filters = ExecHashCreateRuntimeFilters(node);
 
     /*
      * get all inner tuples and insert into the hash table (or temp files)
@@ -134,9 +157,20 @@ Node* MultiExecHash(HashState* node)
             }
             hashtable->totalTuples += 1;
         }
+
+        if (filters != NULL) {
+            /* Too many inner rows for the filters to prune anything, give them up. */
+            if (++filterRows > HASH_RUNTIME_FILTER_MAX_ROWS) {
+                filters = NULL;
+            } else {
+                ExecHashAddRuntimeFilters(node, filters, slot);
+            }
+        }
     }
     (void)pgstat_report_waitstatus(oldStatus);
 
+    ExecHashPublishRuntimeFilters(node, filters);
+
     /* analysis hash table information created in memory */
     if (anls_opt_is_on(ANLS_HASH_CONFLICT))
         ExecHashTableStats(hashtable, node->ps.plan->plan_node_id);
@@ -167,6 +201,93 @@ Node* MultiExecHash(HashState* node)
     return NULL;
 }
 
+/* ----------------------------------------------------------------
+ *		MultiExecParallelHash
+ *
+ *		parallel-aware version of MultiExecHash: insert our share of the
+ *		inner relation into the shared hash table, then wait until every
+ *		attached participant has done the same.
+ * ----------------------------------------------------------------
+ */
+static void MultiExecParallelHash(HashState* node)
+{
+    ParallelHashJoinState* pstate = node->parallel_state;
+    HashJoinTable hashtable = node->hashtable;
+    Barrier* build_barrier = &pstate->build_barrier;
+    PlanState* outerNode = outerPlanState(node);
+    ExprContext* econtext = node->ps.ps_ExprContext;
+    TupleTableSlot* slot = NULL;
+    uint32 hashvalue;
+    double ntuples = 0;
+
+    /* must provide our own instrumentation support */
+    if (node->ps.instrument) {
+        InstrStartNode(node->ps.instrument);
+        hashtable->spill_size = &node->ps.instrument->sorthashinfo.spill_size;
+    } else {
+        hashtable->spill_size = &node->spill_size;
+    }
+
+    /*
+     * ExecHashTableCreate already attached us to the build barrier and, if
+     * we were there from the start, took part in the election.  Synchronize
+     * with whatever phase the other participants have reached.
+     */
+    WaitState oldStatus = pgstat_report_waitstatus(STATE_EXEC_HASHJOIN_BUILD_HASH);
+    switch (BarrierPhase(build_barrier)) {
+        case PHJ_BUILD_ALLOCATING:
+            /* wait for the elected participant to allocate the buckets */
+            (void)BarrierArriveAndWait(build_barrier);
+            /* fall through */
+        case PHJ_BUILD_HASHING_INNER:
+            hashtable->buckets = pstate->buckets;
+            for (;;) {
+                slot = ExecProcNode(outerNode);
+                if (TupIsNull(slot))
+                    break;
+                econtext->ecxt_innertuple = slot;
+                if (ExecHashGetHashValue(
+                        hashtable, econtext, node->hashkeys, false, hashtable->keepNulls, &hashvalue)) {
+                    ExecParallelHashTableInsert(hashtable, slot, hashvalue);
+                    ntuples += 1;
+                }
+            }
+
+            /* publish our share before the others may start probing */
+            SpinLockAcquire(&pstate->mutex);
+            pstate->totalTuples += ntuples;
+            pstate->spaceUsed += hashtable->spaceUsed;
+            SpinLockRelease(&pstate->mutex);
+
+            (void)BarrierArriveAndWait(build_barrier);
+            break;
+        default:
+            /* the table was completed before we attached */
+            break;
+    }
+    (void)pgstat_report_waitstatus(oldStatus);
+
+    /*
+     * The table is complete.  There are no later phases to synchronize, so
+     * detach right away rather than holding up anybody else.
+     */
+    Assert(BarrierPhase(build_barrier) == PHJ_BUILD_DONE);
+    (void)BarrierDetach(build_barrier);
+
+    hashtable->buckets = pstate->buckets;
+    hashtable->totalTuples = pstate->totalTuples;
+    hashtable->spacePeak = pstate->spaceUsed;
+
+    /* must provide our own instrumentation support */
+    if (node->ps.instrument) {
+        InstrStopNode(node->ps.instrument, ntuples);
+        node->ps.instrument->sorthashinfo.nbatch = hashtable->nbatch;
+        node->ps.instrument->sorthashinfo.nbuckets = hashtable->nbuckets;
+        node->ps.instrument->sorthashinfo.nbatch_original = hashtable->nbatch_original;
+        node->ps.instrument->sorthashinfo.spacePeak = hashtable->spacePeak;
+    }
+}
+
 /* ----------------------------------------------------------------
  *		ExecInitHash
  *
@@ -188,6 +309,9 @@ HashState* ExecInitHash(Hash* node, EState* estate, int eflags)
     hashstate->ps.state = estate;
     hashstate->hashtable = NULL;
     hashstate->hashkeys = NIL; /* will be set by parent HashJoin */
+    hashstate->parallel_state = NULL; /* will be set by parent HashJoin */
+    hashstate->bf_var_list = NIL;     /* will be set by parent HashJoin */
+    hashstate->bf_filter_index = NIL;
 
     /*
      * Miscellaneous initialization
@@ -248,9 +372,13 @@ void ExecEndHash(HashState* node)
  *		ExecHashTableCreate
  *
  *		create an empty hashtable data structure for hashjoin.
+ *
+ *		If pstate is given, the buckets live in the shared table described
+ *		by it; we attach to its build barrier here and, if elected,
+ *		allocate them.
  * ----------------------------------------------------------------
  */
-HashJoinTable ExecHashTableCreate(Hash* node, List* hashOperators, bool keepNulls)
+HashJoinTable ExecHashTableCreate(Hash* node, List* hashOperators, bool keepNulls, ParallelHashJoinState* pstate)
 {
     HashJoinTable hashtable;
     Plan* outerNode = NULL;
@@ -280,6 +408,16 @@ HashJoinTable ExecHashTableCreate(Hash* node, List* hashOperators, bool keepNull
         &num_skew_mcvs,
         local_work_mem);
 
+    /*
+     * The shared table was sized for the whole inner relation when the
+     * parallel context was set up, and it is never split into batches.
+     */
+    if (pstate != NULL) {
+        nbuckets = pstate->nbuckets;
+        nbatch = 1;
+        max_mem = 0;
+    }
+
     /*
      * If we allows mem auto spread, we should set nbatch to 1 to avoid disk
      * spill if estimation from optimizer differs from that from executor
@@ -336,6 +474,7 @@ HashJoinTable ExecHashTableCreate(Hash* node, List* hashOperators, bool keepNull
     /* should we allow auto mem spread in query mem mode? */
     hashtable->maxMem = max_mem * 1024L;
     hashtable->spreadNum = 0;
+    hashtable->parallel_state = pstate;
 
     /*
      * Get info about the hash functions to be used for each hash key. Also
@@ -396,6 +535,30 @@ HashJoinTable ExecHashTableCreate(Hash* node, List* hashOperators, bool keepNull
         PrepareTempTablespaces();
     }
 
+    if (pstate != NULL) {
+        Barrier* build_barrier = &pstate->build_barrier;
+
+        MemoryContextSwitchTo(oldcxt);
+
+        /*
+         * The shared table never grows a batch, so there is nothing for the
+         * skew optimization to save.
+         */
+        hashtable->growEnabled = false;
+
+        /*
+         * Attach to the build barrier.  If the build hasn't started yet, take
+         * part in electing the participant that allocates the shared bucket
+         * array; everybody else picks it up in MultiExecParallelHash.
+         */
+        if (BarrierAttach(build_barrier) == PHJ_BUILD_ELECTING && BarrierArriveAndWait(build_barrier)) {
+            pstate->buckets =
+                (HashJoinTuple*)MemoryContextAllocZero(pstate->cxt, (Size)pstate->nbuckets * sizeof(HashJoinTuple));
+        }
+
+        return hashtable;
+    }
+
     /*
      * Prepare context for the first-scan space allocations; allocate the
      * hashbucket array therein, and set each bucket "empty".
@@ -1040,6 +1203,46 @@ void ExecHashTableInsert(
     }
 }
 
+/*
+ * ExecParallelHashTableInsert
+ *		insert a tuple into the shared hash table
+ *
+ * Several participants insert concurrently, so the tuple is pushed onto its
+ * bucket with compare-and-swap.  The shared table has only one batch, and
+ * going over the memory budget doesn't change that; the planner avoids a
+ * parallel hash when it expects the inner relation not to fit.
+ */
+static void ExecParallelHashTableInsert(HashJoinTable hashtable, TupleTableSlot* slot, uint32 hashvalue)
+{
+    MinimalTuple tuple = ExecFetchSlotMinimalTuple(slot);
+    HashJoinTuple hashTuple;
+    HashJoinTuple head;
+    int hashTupleSize;
+    int bucketno;
+    int batchno;
+    errno_t errorno = EOK;
+
+    ExecHashGetBucketAndBatch(hashtable, hashvalue, &bucketno, &batchno);
+    Assert(batchno == 0);
+
+    /* Create the HashJoinTuple */
+    hashTupleSize = HJTUPLE_OVERHEAD + tuple->t_len;
+    hashTuple = (HashJoinTuple)parallel_dense_alloc(hashtable, hashTupleSize);
+    hashTuple->hashvalue = hashvalue;
+    errorno = memcpy_s(HJTUPLE_MINTUPLE(hashTuple), tuple->t_len, tuple, tuple->t_len);
+    securec_check(errorno, "\0", "\0");
+    HeapTupleHeaderClearMatch(HJTUPLE_MINTUPLE(hashTuple));
+
+    /* Push it onto the front of the shared bucket's list */
+    do {
+        head = hashtable->buckets[bucketno];
+        hashTuple->next = head;
+    } while (!gs_compare_and_swap_64((int64*)&hashtable->buckets[bucketno], (int64)head, (int64)hashTuple));
+
+    /* Account for our own share of the space; it is summed up at the end */
+    hashtable->spaceUsed += hashTupleSize;
+}
+
 /*
  * ExecHashGetHashValue
  *		Compute the hash value for a tuple
@@ -1369,6 +1572,106 @@ void ExecReScanHash(HashState* node)
         ExecReScan(node->ps.lefttree);
 }
 
+/*
+ * ExecHashResetRuntimeFilters
+ *
+ *		Withdraw the runtime bloom filters published by a previous build, so
+ *		that scans under the outer side do not probe them while the hash
+ *		table is being rebuilt for new inner rows.
+ */
+void ExecHashResetRuntimeFilters(HashState* node)
+{
+    filter::BloomFilter** bfarray = node->ps.state->es_bloom_filter.bfarray;
+    ListCell* lc = NULL;
+
+    foreach (lc, node->bf_filter_index) {
+        bfarray[lfirst_int(lc)] = NULL;
+    }
+}
+
+/*
+ * ExecHashCreateRuntimeFilters
+ *
+ *		Create the runtime bloom filters the planner asked us to build on the
+ *		inner join keys, one per bf_var_list entry.  A shared hash table only
+ *		sees part of the inner rows here, so it gets none.
+ */
+static filter::BloomFilter** ExecHashCreateRuntimeFilters(HashState* node)
+{
+    filter::BloomFilter** filters = NULL;
+    ListCell* lc = NULL;
+    int i = 0;
+
+    if (node->bf_var_list == NIL || node->parallel_state != NULL || !u_sess->attr.attr_sql.enable_bloom_filter) {
+        return NULL;
+    }
+
+    filters = (filter::BloomFilter**)palloc0(sizeof(filter::BloomFilter*) * list_length(node->bf_var_list));
+    foreach (lc, node->bf_var_list) {
+        Var* var = (Var*)lfirst(lc);
+
+        if (SATISFY_RUNTIME_FILTER(var->vartype)) {
+            filters[i] = filter::createBloomFilter(var->vartype,
+                var->vartypmod,
+                var->varcollid,
+                HASHJOIN_BLOOM_FILTER,
+                HASH_RUNTIME_FILTER_MAX_ROWS,
+                true);
+        }
+        i++;
+    }
+
+    return filters;
+}
+
+/*
+ * ExecHashAddRuntimeFilters
+ *
+ *		Add the join keys of one inner tuple to the runtime bloom filters.
+ *		NULL keys never join, so they are left out.
+ */
+static void ExecHashAddRuntimeFilters(HashState* node, filter::BloomFilter** filters, TupleTableSlot* slot)
+{
+    ListCell* lc = NULL;
+    int i = 0;
+
+    foreach (lc, node->bf_var_list) {
+        if (filters[i] != NULL) {
+            bool isnull = false;
+            Datum value = slot_getattr(slot, ((Var*)lfirst(lc))->varattno, &isnull);
+
+            if (!isnull) {
+                filters[i]->addDatum(value);
+            }
+        }
+        i++;
+    }
+}
+
+/*
+ * ExecHashPublishRuntimeFilters
+ *
+ *		Hand the finished runtime bloom filters to the scans under the outer
+ *		side, see ExecGetRuntimeFilter.
+ */
+static void ExecHashPublishRuntimeFilters(HashState* node, filter::BloomFilter** filters)
+{
+    filter::BloomFilter** bfarray = node->ps.state->es_bloom_filter.bfarray;
+    ListCell* lc = NULL;
+    int i = 0;
+
+    if (filters == NULL) {
+        return;
+    }
+
+    foreach (lc, node->bf_filter_index) {
+        if (filters[i] != NULL) {
+            bfarray[lfirst_int(lc)] = filters[i];
+        }
+        i++;
+    }
+}
+
 /*
  * ExecHashBuildSkewHash
  *
@@ -1927,3 +2230,47 @@ static void* dense_alloc(HashJoinTable hashtable, Size size)
     /* return pointer to the start of the tuple memory */
     return ptr;
 }
+
+/*
+ * Allocate 'size' bytes for a tuple of the shared hash table
+ *
+ * Like dense_alloc, but the chunks come from the shared context so that they
+ * outlive this participant, and are linked into the shared chunk list.
+ * hashtable->chunks is only our current chunk here, not a list.
+ */
+static void* parallel_dense_alloc(HashJoinTable hashtable, Size size)
+{
+    ParallelHashJoinState* pstate = hashtable->parallel_state;
+    HashMemoryChunk chunk = hashtable->chunks;
+    Size maxlen;
+    char* ptr = NULL;
+
+    /* just in case the size is not already aligned properly */
+    size = MAXALIGN(size);
+
+    /* There is enough space in the current chunk, let's add the tuple */
+    if (chunk != NULL && size <= HASH_CHUNK_THRESHOLD && (chunk->maxlen - chunk->used) >= size) {
+        ptr = chunk->data + chunk->used;
+        chunk->used += size;
+        chunk->ntuples += 1;
+        return ptr;
+    }
+
+    /* Tuples larger than 1/4 of the chunk size get a chunk of their own */
+    maxlen = (size > HASH_CHUNK_THRESHOLD) ? size : HASH_CHUNK_SIZE;
+    chunk = (HashMemoryChunk)MemoryContextAlloc(pstate->cxt, offsetof(HashMemoryChunkData, data) + maxlen);
+    chunk->maxlen = maxlen;
+    chunk->used = size;
+    chunk->ntuples = 1;
+
+    SpinLockAcquire(&pstate->mutex);
+    chunk->next = pstate->chunks;
+    pstate->chunks = chunk;
+    SpinLockRelease(&pstate->mutex);
+
+    /* keep filling the current chunk if the new one was a dedicated one */
+    if (size <= HASH_CHUNK_THRESHOLD)
+        hashtable->chunks = chunk;
+
+    return chunk->data;
+}
@@ -22,8 +22,11 @@
 #include "executor/nodeHash.h"
 #include "executor/nodeHashjoin.h"
 #include "miscadmin.h"
+#include "storage/spin.h"
 #include "utils/anls_opt.h"
+#include "utils/dynahash.h"
 #include "utils/memutils.h"
+#include "utils/selfuncs.h"
 
 /*
  * States of the ExecHashJoin state machine
@@ -113,6 +116,10 @@ TupleTableSlot* ExecHashJoin(HashJoinState* node)
                  * First time through: build hash table for inner relation.
                  */
                 Assert(hashtable == NULL);
+
+                /* Filters of a previous build must not be applied to outer rows fetched below. */
+                ExecHashResetRuntimeFilters(hashNode);
+
                 /*
                  * If the outer relation is completely empty, and it's not
                  * right/full join, we can quit without building the hash
@@ -173,7 +180,8 @@ TupleTableSlot* ExecHashJoin(HashJoinState* node)
                 oldcxt = MemoryContextSwitchTo(hashNode->ps.nodeContext);
                 hashtable = ExecHashTableCreate((Hash*)hashNode->ps.plan,
                     node->hj_HashOperators,
-                    HJ_FILL_INNER(node) || node->js.nulleqqual != NIL);
+                    HJ_FILL_INNER(node) || node->js.nulleqqual != NIL,
+                    hashNode->parallel_state);
                 MemoryContextSwitchTo(oldcxt);
                 node->hj_HashTable = hashtable;
 
@@ -604,6 +612,15 @@ HashJoinState* ExecInitHashJoin(HashJoin* node, EState* estate, int eflags)
     /* child Hash node needs to evaluate inner hash keys, too */
     ((HashState*)innerPlanState(hjstate))->hashkeys = rclauses;
 
+    /*
+     * It also builds the runtime bloom filters for scans under the outer side,
+     * unless NULL keys can match here and so must never be filtered out.
+     */
+    if (node->join.nulleqqual == NIL) {
+        ((HashState*)innerPlanState(hjstate))->bf_var_list = node->join.plan.var_list;
+        ((HashState*)innerPlanState(hjstate))->bf_filter_index = node->join.plan.filterIndexList;
+    }
+
     hjstate->js.ps.ps_TupFromTlist = false;
     hjstate->hj_JoinState = HJ_BUILD_HASHTABLE;
     hjstate->hj_MatchedOuter = false;
@@ -976,9 +993,13 @@ void ExecReScanHashJoin(HashJoinState* node)
      * rebuilding it.
      */
     if (node->hj_HashTable != NULL) {
+        /*
+         * A shared hash table has been reset by ExecHashJoinReInitializeDSM
+         * and must be built again by all participants.
+         */
         if (!node->js.ps.plan->ispwj && node->hj_HashTable->nbatch == 1 && node->js.ps.righttree->chgParam == NULL &&
             !node->hj_rebuildHashtable && node->js.jointype != JOIN_RIGHT_SEMI &&
-            node->js.jointype != JOIN_RIGHT_ANTI) {
+            node->js.jointype != JOIN_RIGHT_ANTI && node->hj_HashTable->parallel_state == NULL) {
             /*
              * Okay to reuse the hash table; needn't rescan inner, either.
              *
@@ -1130,3 +1151,103 @@ void ExecReSetHashJoin(HashJoinState* node)
     if (node->js.ps.lefttree->chgParam == NULL)
         ExecReSetRecursivePlanTree(node->js.ps.lefttree);
 }
+
+/* ----------------------------------------------------------------
+ *		ExecHashJoinInitializeDSM
+ *
+ *		Set up the shared hash table state for a parallel hash join.
+ * ----------------------------------------------------------------
+ */
+void ExecHashJoinInitializeDSM(HashJoinState* state, ParallelContext* pcxt, int nodeid)
+{
+    knl_u_parallel_context* cxt = (knl_u_parallel_context*)pcxt->seg;
+    HashState* hashNode = (HashState*)innerPlanState(state);
+    Hash* hash = (Hash*)hashNode->ps.plan;
+    Plan* innerNode = outerPlan(hash);
+    int nparticipants = pcxt->nworkers + 1;
+    ParallelHashJoinState* pstate = NULL;
+    int nbuckets;
+    int nbatch;
+    int num_skew_mcvs;
+
+    /*
+     * The inner plan is partial, so its row estimate covers one participant.
+     * Size the buckets for all of them together; each participant brings its
+     * own work_mem to the shared table.
+     */
+    ExecChooseHashTableSize(PLAN_LOCAL_ROWS(innerNode) * nparticipants,
+        innerNode->plan_width,
+        false,
+        &nbuckets,
+        &nbatch,
+        &num_skew_mcvs,
+        SET_NODEMEM(hash->plan.operatorMemKB[0], hash->plan.dop) * nparticipants);
+
+    /* Here we can't use palloc, cause we have switch to old memctx in ExecInitParallelPlan */
+    pstate = (ParallelHashJoinState*)MemoryContextAllocZero(cxt->memCtx, sizeof(ParallelHashJoinState));
+    pstate->plan_node_id = state->js.ps.plan->plan_node_id;
+    pstate->nbuckets = nbuckets;
+    pstate->log2_nbuckets = my_log2(nbuckets);
+    pstate->cxt = cxt->memCtx;
+    SpinLockInit(&pstate->mutex);
+    BarrierInit(&pstate->build_barrier, 0);
+
+    cxt->pwCtx->queryInfo.phjstate[nodeid] = pstate;
+    hashNode->parallel_state = pstate;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecHashJoinReInitializeDSM
+ *
+ *		Reset the shared hash table before the join is executed again.
+ *		The workers of the previous scan are gone, so nobody else can be
+ *		looking at it.
+ * ----------------------------------------------------------------
+ */
+void ExecHashJoinReInitializeDSM(HashJoinState* state, ParallelContext* pcxt)
+{
+    ParallelHashJoinState* pstate = ((HashState*)innerPlanState(state))->parallel_state;
+    HashMemoryChunk chunk = pstate->chunks;
+
+    while (chunk != NULL) {
+        HashMemoryChunk next = chunk->next;
+
+        pfree(chunk);
+        chunk = next;
+    }
+    pstate->chunks = NULL;
+
+    if (pstate->buckets != NULL) {
+        pfree(pstate->buckets);
+        pstate->buckets = NULL;
+    }
+
+    pstate->totalTuples = 0;
+    pstate->spaceUsed = 0;
+    BarrierInit(&pstate->build_barrier, 0);
+}
+
+/* ----------------------------------------------------------------
+ *		ExecHashJoinInitializeWorker
+ *
+ *		Attach to the shared hash table state set up by the leader.
+ * ----------------------------------------------------------------
+ */
+void ExecHashJoinInitializeWorker(HashJoinState* state, void* context)
+{
+    knl_u_parallel_context* cxt = (knl_u_parallel_context*)context;
+    ParallelHashJoinState* pstate = NULL;
+
+    for (int i = 0; i < cxt->pwCtx->queryInfo.phjstate_num; i++) {
+        if (state->js.ps.plan->plan_node_id == cxt->pwCtx->queryInfo.phjstate[i]->plan_node_id) {
+            pstate = cxt->pwCtx->queryInfo.phjstate[i];
+            break;
+        }
+    }
+
+    if (pstate == NULL) {
+        ereport(ERROR, (errmsg("could not find plan info, plan node id:%d", state->js.ps.plan->plan_node_id)));
+    }
+
+    ((HashState*)innerPlanState(state))->parallel_state = pstate;
+}
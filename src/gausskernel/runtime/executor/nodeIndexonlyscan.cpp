@@ -21,6 +21,12 @@
  *		ExecEndIndexOnlyScan		releases all storage.
  *		ExecIndexOnlyMarkPos		marks scan position.
  *		ExecIndexOnlyRestrPos		restores scan position.
+ *		ExecIndexOnlyScanEstimate	estimates DSM space needed for
+ *						parallel index-only scan
+ *		ExecIndexOnlyScanInitializeDSM	initialize DSM for parallel
+ *						index-only scan
+ *		ExecIndexOnlyScanReInitializeDSM	reinitialize DSM for fresh scan
+ *		ExecIndexOnlyScanInitializeWorker attach to DSM info in parallel worker
  */
 #include "postgres.h"
 #include "knl/knl_variable.h"
@@ -786,3 +792,97 @@ void ExecInitPartitionForIndexOnlyScan(IndexOnlyScanState* indexstate, EState* e
         }
     }
 }
+
+/*
+ * Replace the serial scan descriptor opened by ExecInitIndexOnlyScan with one
+ * attached to the shared parallel scan state.
+ */
+static void ExecIndexOnlyScanBeginParallel(IndexOnlyScanState* node, ParallelIndexScanDesc piscan)
+{
+    if (node->ioss_ScanDesc != NULL) {
+        abs_idx_endscan(node->ioss_ScanDesc);
+    }
+    node->ioss_ScanDesc = (AbsIdxScanDesc)index_beginscan_parallel(node->ss.ss_currentRelation,
+        node->ioss_RelationDesc, node->ioss_NumScanKeys, node->ioss_NumOrderByKeys, piscan);
+    GetIndexScanDesc(node->ioss_ScanDesc)->xs_want_itup = true;
+    node->ioss_VMBuffer = InvalidBuffer;
+
+    /*
+     * If no run-time keys to calculate or they are ready, go ahead and pass
+     * the scankeys to the index AM.
+     */
+    if (node->ioss_NumRuntimeKeys == 0 || node->ioss_RuntimeKeysReady) {
+        abs_idx_rescan(node->ioss_ScanDesc, node->ioss_ScanKeys, node->ioss_NumScanKeys, node->ioss_OrderByKeys,
+            node->ioss_NumOrderByKeys);
+    }
+}
+
+/* ----------------------------------------------------------------
+ *      ExecIndexOnlyScanEstimate
+ *
+ *      estimates the space required to serialize index-only scan node.
+ * ----------------------------------------------------------------
+ */
+void ExecIndexOnlyScanEstimate(IndexOnlyScanState* node, ParallelContext* pcxt)
+{
+    EState* estate = node->ss.ps.state;
+    node->ioss_PscanLen = index_parallelscan_estimate(node->ioss_RelationDesc, estate->es_snapshot);
+}
+
+/* ----------------------------------------------------------------
+ *      ExecIndexOnlyScanInitializeDSM
+ *
+ *      Set up a parallel index-only scan descriptor.
+ * ----------------------------------------------------------------
+ */
+void ExecIndexOnlyScanInitializeDSM(IndexOnlyScanState* node, ParallelContext* pcxt, int nodeid)
+{
+    EState* estate = node->ss.ps.state;
+    knl_u_parallel_context* cxt = (knl_u_parallel_context*)pcxt->seg;
+    ParallelIndexScanDesc piscan;
+
+    /* Here we can't use palloc, cause we have switch to old memctx in ExecInitParallelPlan */
+    piscan = (ParallelIndexScanDesc)MemoryContextAllocZero(cxt->memCtx, node->ioss_PscanLen);
+    index_parallelscan_initialize(
+        node->ss.ss_currentRelation, node->ioss_RelationDesc, estate->es_snapshot, piscan, node->ioss_PscanLen);
+    piscan->plan_node_id = node->ss.ps.plan->plan_node_id;
+    cxt->pwCtx->queryInfo.piscan[nodeid] = piscan;
+
+    ExecIndexOnlyScanBeginParallel(node, piscan);
+}
+
+/* ----------------------------------------------------------------
+ *      ExecIndexOnlyScanReInitializeDSM
+ *
+ *      Reset shared state before beginning a fresh scan.
+ * ----------------------------------------------------------------
+ */
+void ExecIndexOnlyScanReInitializeDSM(IndexOnlyScanState* node, ParallelContext* pcxt)
+{
+    index_parallelrescan(GetIndexScanDesc(node->ioss_ScanDesc));
+}
+
+/* ----------------------------------------------------------------
+ *      ExecIndexOnlyScanInitializeWorker
+ *
+ *      Copy relevant information from TOC into planstate.
+ * ----------------------------------------------------------------
+ */
+void ExecIndexOnlyScanInitializeWorker(IndexOnlyScanState* node, void* context)
+{
+    ParallelIndexScanDesc piscan = NULL;
+    knl_u_parallel_context* cxt = (knl_u_parallel_context*)context;
+
+    for (int i = 0; i < cxt->pwCtx->queryInfo.piscan_num; i++) {
+        if (node->ss.ps.plan->plan_node_id == cxt->pwCtx->queryInfo.piscan[i]->plan_node_id) {
+            piscan = cxt->pwCtx->queryInfo.piscan[i];
+            break;
+        }
+    }
+
+    if (piscan == NULL) {
+        ereport(ERROR, (errmsg("could not find plan info, plan node id:%d", node->ss.ps.plan->plan_node_id)));
+    }
+
+    ExecIndexOnlyScanBeginParallel(node, piscan);
+}
@@ -21,6 +21,10 @@
  *		ExecEndIndexScan		releases all storage.
  *		ExecIndexMarkPos		marks scan position.
  *		ExecIndexRestrPos		restores scan position.
+ *		ExecIndexScanEstimate	estimates DSM space needed for parallel index scan
+ *		ExecIndexScanInitializeDSM initialize DSM for parallel indexscan
+ *		ExecIndexScanReInitializeDSM reinitialize DSM for fresh scan
+ *		ExecIndexScanInitializeWorker attach to DSM info in parallel worker
  */
 #include "postgres.h"
 #include "knl/knl_variable.h"
@@ -1337,3 +1341,100 @@ void ExecInitPartitionForIndexScan(IndexScanState* index_state, EState* estate)
         }
     }
 }
+
+/* ----------------------------------------------------------------
+ *      ExecIndexScanEstimate
+ *
+ *      estimates the space required to serialize indexscan node.
+ * ----------------------------------------------------------------
+ */
+void ExecIndexScanEstimate(IndexScanState* node, ParallelContext* pcxt)
+{
+    EState* estate = node->ss.ps.state;
+    node->iss_PscanLen = index_parallelscan_estimate(node->iss_RelationDesc, estate->es_snapshot);
+}
+
+/* ----------------------------------------------------------------
+ *      ExecIndexScanInitializeDSM
+ *
+ *      Set up a parallel index scan descriptor.
+ * ----------------------------------------------------------------
+ */
+void ExecIndexScanInitializeDSM(IndexScanState* node, ParallelContext* pcxt, int nodeid)
+{
+    EState* estate = node->ss.ps.state;
+    knl_u_parallel_context* cxt = (knl_u_parallel_context*)pcxt->seg;
+    ParallelIndexScanDesc piscan;
+
+    /* Here we can't use palloc, cause we have switch to old memctx in ExecInitParallelPlan */
+    piscan = (ParallelIndexScanDesc)MemoryContextAllocZero(cxt->memCtx, node->iss_PscanLen);
+    index_parallelscan_initialize(
+        node->ss.ss_currentRelation, node->iss_RelationDesc, estate->es_snapshot, piscan, node->iss_PscanLen);
+    piscan->plan_node_id = node->ss.ps.plan->plan_node_id;
+    cxt->pwCtx->queryInfo.piscan[nodeid] = piscan;
+
+    /* replace the serial scan descriptor opened by ExecInitIndexScan */
+    if (node->iss_ScanDesc != NULL) {
+        abs_idx_endscan(node->iss_ScanDesc);
+    }
+    node->iss_ScanDesc = (AbsIdxScanDesc)index_beginscan_parallel(node->ss.ss_currentRelation,
+        node->iss_RelationDesc, node->iss_NumScanKeys, node->iss_NumOrderByKeys, piscan);
+
+    /*
+     * If no run-time keys to calculate or they are ready, go ahead and pass
+     * the scankeys to the index AM.
+     */
+    if (node->iss_NumRuntimeKeys == 0 || node->iss_RuntimeKeysReady) {
+        abs_idx_rescan(node->iss_ScanDesc, node->iss_ScanKeys, node->iss_NumScanKeys, node->iss_OrderByKeys,
+            node->iss_NumOrderByKeys);
+    }
+}
+
+/* ----------------------------------------------------------------
+ *      ExecIndexScanReInitializeDSM
+ *
+ *      Reset shared state before beginning a fresh scan.
+ * ----------------------------------------------------------------
+ */
+void ExecIndexScanReInitializeDSM(IndexScanState* node, ParallelContext* pcxt)
+{
+    index_parallelrescan(GetIndexScanDesc(node->iss_ScanDesc));
+}
+
+/* ----------------------------------------------------------------
+ *      ExecIndexScanInitializeWorker
+ *
+ *      Copy relevant information from TOC into planstate.
+ * ----------------------------------------------------------------
+ */
+void ExecIndexScanInitializeWorker(IndexScanState* node, void* context)
+{
+    ParallelIndexScanDesc piscan = NULL;
+    knl_u_parallel_context* cxt = (knl_u_parallel_context*)context;
+
+    for (int i = 0; i < cxt->pwCtx->queryInfo.piscan_num; i++) {
+        if (node->ss.ps.plan->plan_node_id == cxt->pwCtx->queryInfo.piscan[i]->plan_node_id) {
+            piscan = cxt->pwCtx->queryInfo.piscan[i];
+            break;
+        }
+    }
+
+    if (piscan == NULL) {
+        ereport(ERROR, (errmsg("could not find plan info, plan node id:%d", node->ss.ps.plan->plan_node_id)));
+    }
+
+    if (node->iss_ScanDesc != NULL) {
+        abs_idx_endscan(node->iss_ScanDesc);
+    }
+    node->iss_ScanDesc = (AbsIdxScanDesc)index_beginscan_parallel(node->ss.ss_currentRelation,
+        node->iss_RelationDesc, node->iss_NumScanKeys, node->iss_NumOrderByKeys, piscan);
+
+    /*
+     * If no run-time keys to calculate or they are ready, go ahead and pass
+     * the scankeys to the index AM.
+     */
+    if (node->iss_NumRuntimeKeys == 0 || node->iss_RuntimeKeysReady) {
+        abs_idx_rescan(node->iss_ScanDesc, node->iss_ScanKeys, node->iss_NumScanKeys, node->iss_OrderByKeys,
+            node->iss_NumOrderByKeys);
+    }
+}
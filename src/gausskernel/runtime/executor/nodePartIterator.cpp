@@ -24,10 +24,13 @@
 #include "postgres.h"
 #include "knl/knl_variable.h"
 
+#include "access/relscan.h"
 #include "executor/execdebug.h"
 #include "executor/nodePartIterator.h"
 #include "executor/tuptable.h"
 #include "utils/memutils.h"
+#include "utils/partcache.h"
+#include "utils/rel_gs.h"
 #include "nodes/execnodes.h"
 #include "nodes/plannodes.h"
 #include "vecexecutor/vecnodes.h"
@@ -55,10 +58,63 @@ PartIteratorState* ExecInitPartIterator(PartIterator* node, EState* estate, int
     state->ps.ps_TupFromTlist = false;
     state->ps.ps_ProjInfo = NULL;
     state->currentItr = -1;
+    state->pstate = NULL;
 
     return state;
 }
 
+/*
+ * Pick the partition to scan next and store it in node->currentItr.  Return
+ * false when there is none left.
+ *
+ * Without shared state that is simply the next one in line.  Participants of
+ * a parallel scan claim the next partition nobody has finished yet; see
+ * ParallelPartIteratorState.
+ */
+static bool choose_next_partition(PartIteratorState* node)
+{
+    PartIterator* pi_node = (PartIterator*)node->ps.plan;
+    ParallelPartIteratorState* pstate = node->pstate;
+    int itr;
+    int i;
+
+    if (pstate == NULL) {
+        if (node->currentItr + 1 >= pi_node->itrs) /* have scanned all partitions */
+            return false;
+        node->currentItr++;
+        return true;
+    }
+
+    SpinLockAcquire(&pstate->mutex);
+
+    /*
+     * Our scan of a partition shared in chunks ended, so all of its blocks
+     * have been handed out; nobody needs to join it any more.
+     */
+    if (node->currentItr >= 0)
+        pstate->finished[node->currentItr] = true;
+
+    /* Find the next unfinished partition, wrapping around to the shared ones */
+    itr = pstate->next_itr;
+    for (i = 0; i < pstate->nitrs && pstate->finished[itr]; i++)
+        itr = (itr + 1) % pstate->nitrs;
+
+    if (pstate->finished[itr]) {
+        SpinLockRelease(&pstate->mutex);
+        return false;
+    }
+
+    /* A partition claimed whole is finished as far as the others care */
+    if (pstate->pscans[itr] == NULL)
+        pstate->finished[itr] = true;
+    pstate->next_itr = (itr + 1) % pstate->nitrs;
+
+    SpinLockRelease(&pstate->mutex);
+
+    node->currentItr = itr;
+    return true;
+}
+
 static void init_scan_partition(PartIteratorState* node)
 {
     int paramno;
@@ -69,7 +125,6 @@ static void init_scan_partition(PartIteratorState* node)
     Assert(ForwardScanDirection == pi_node->direction || BackwardScanDirection == pi_node->direction);
 
     /* set iterator parameter */
-    node->currentItr++;
     itr_idx = node->currentItr;
     if (BackwardScanDirection == pi_node->direction)
         itr_idx = pi_node->itrs - itr_idx - 1;
@@ -106,8 +161,11 @@ TupleTableSlot* ExecPartIterator(PartIteratorState* node)
     }
 
     /* init first scanned partition */
-    if (node->currentItr == -1)
+    if (node->currentItr == -1) {
+        if (!choose_next_partition(node))
+            return NULL;
         init_scan_partition(node);
+    }
 
     /* For partition wise join, can not early free left tree's caching memory */
     state->es_skip_early_free = true;
@@ -119,7 +177,7 @@ TupleTableSlot* ExecPartIterator(PartIteratorState* node)
 
     /* switch to next partition until we get a unempty tuple */
     for (;;) {
-        if (node->currentItr + 1 >= pi_node->itrs) /* have scanned all partitions */
+        if (!choose_next_partition(node)) /* have scanned all partitions */
             return NULL;
 
         /* switch to next partiiton */
@@ -184,4 +242,124 @@ void ExecReScanPartIterator(PartIteratorState* node)
      * that its output can be re-scanned.
      */
     ExecReScan(node->ps.lefttree);
-}
\ No newline at end of file
+}
+
+/* ----------------------------------------------------------------
+ *		ExecPartIteratorInitializeDSM
+ *
+ *		Set up the shared state handing out the partitions.  This is
+ *		also where we decide which partitions are big enough to be
+ *		shared in chunks rather than claimed whole.
+ * ----------------------------------------------------------------
+ */
+void ExecPartIteratorInitializeDSM(PartIteratorState* node, ParallelContext* pcxt, int nodeid)
+{
+    knl_u_parallel_context* cxt = (knl_u_parallel_context*)pcxt->seg;
+    PartIterator* pi_node = (PartIterator*)node->ps.plan;
+    ParallelPartIteratorState* pstate = NULL;
+    int nitrs = pi_node->itrs;
+
+    Assert(pi_node->direction == ForwardScanDirection);
+
+    /* Here we can't use palloc, cause we have switch to old memctx in ExecInitParallelPlan */
+    pstate = (ParallelPartIteratorState*)MemoryContextAllocZero(
+        cxt->memCtx, offsetof(ParallelPartIteratorState, finished) + sizeof(bool) * Max(nitrs, 1));
+    pstate->plan_node_id = pi_node->plan.plan_node_id;
+    pstate->nitrs = nitrs;
+    pstate->pscans = (ParallelHeapScanDesc*)MemoryContextAllocZero(
+        cxt->memCtx, sizeof(ParallelHeapScanDesc) * Max(nitrs, 1));
+    SpinLockInit(&pstate->mutex);
+    pstate->next_itr = 0;
+
+    /*
+     * Only a plain seq scan can join the parallel heap scan of a partition;
+     * below anything else every partition is claimed whole.
+     */
+    if (nitrs > 0 && IsA(node->ps.lefttree, SeqScanState) && !((SeqScanState*)node->ps.lefttree)->isSampleScan &&
+        list_length(((SeqScanState*)node->ps.lefttree)->partitions) == nitrs) {
+        SeqScanState* scan = (SeqScanState*)node->ps.lefttree;
+        EState* estate = node->ps.state;
+        BlockNumber* nblocks = (BlockNumber*)palloc(sizeof(BlockNumber) * nitrs);
+        double totalblocks = 0;
+        double share;
+        ListCell* cell = NULL;
+        int i = 0;
+
+        foreach (cell, scan->partitions) {
+            Relation partrel = partitionGetRelation(scan->ss_currentRelation, (Partition)lfirst(cell));
+
+            nblocks[i] = RelationGetNumberOfBlocks(partrel);
+            totalblocks += nblocks[i];
+            releaseDummyRelation(&partrel);
+            i++;
+        }
+
+        /* What one participant would scan if the blocks split evenly */
+        share = totalblocks / (pcxt->nworkers + 1);
+
+        i = 0;
+        foreach (cell, scan->partitions) {
+            if (nblocks[i] > share) {
+                Relation partrel = partitionGetRelation(scan->ss_currentRelation, (Partition)lfirst(cell));
+                Size pscan_len = heap_parallelscan_estimate(estate->es_snapshot);
+
+                pstate->pscans[i] = (ParallelHeapScanDesc)MemoryContextAllocZero(cxt->memCtx, pscan_len);
+                heap_parallelscan_initialize(pstate->pscans[i], pscan_len, partrel, estate->es_snapshot);
+                releaseDummyRelation(&partrel);
+            }
+            i++;
+        }
+        pfree(nblocks);
+
+        scan->part_pscans = pstate->pscans;
+    }
+
+    cxt->pwCtx->queryInfo.ppiterator[nodeid] = pstate;
+    node->pstate = pstate;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecPartIteratorReInitializeDSM
+ *
+ *		Reset the shared state before beginning a fresh scan.
+ * ----------------------------------------------------------------
+ */
+void ExecPartIteratorReInitializeDSM(PartIteratorState* node, ParallelContext* pcxt)
+{
+    ParallelPartIteratorState* pstate = node->pstate;
+    int i;
+
+    pstate->next_itr = 0;
+    for (i = 0; i < pstate->nitrs; i++) {
+        pstate->finished[i] = false;
+        if (pstate->pscans[i] != NULL)
+            heap_parallelscan_reinitialize(pstate->pscans[i]);
+    }
+}
+
+/* ----------------------------------------------------------------
+ *		ExecPartIteratorInitializeWorker
+ *
+ *		Attach to the shared state set up by the leader.
+ * ----------------------------------------------------------------
+ */
+void ExecPartIteratorInitializeWorker(PartIteratorState* node, void* context)
+{
+    knl_u_parallel_context* cxt = (knl_u_parallel_context*)context;
+    ParallelPartIteratorState* pstate = NULL;
+
+    for (int i = 0; i < cxt->pwCtx->queryInfo.ppiterator_num; i++) {
+        if (node->ps.plan->plan_node_id == cxt->pwCtx->queryInfo.ppiterator[i]->plan_node_id) {
+            pstate = cxt->pwCtx->queryInfo.ppiterator[i];
+            break;
+        }
+    }
+
+    if (pstate == NULL) {
+        ereport(ERROR, (errmsg("could not find plan info, plan node id:%d", node->ps.plan->plan_node_id)));
+    }
+
+    node->pstate = pstate;
+    if (IsA(node->ps.lefttree, SeqScanState))
+        ((SeqScanState*)node->ps.lefttree)->part_pscans = pstate->pscans;
+}
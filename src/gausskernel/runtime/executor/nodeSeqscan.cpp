@@ -80,8 +80,9 @@ void Start_Prefetch(HeapScanDesc scan, SeqScanAccessor* p_accessor, ScanDirectio
     if (scan->rs_nblocks == 0)
         return;
 
-    quantity = p_accessor->sa_prefetch_quantity;
-    trigger = p_accessor->sa_prefetch_trigger;
+    /* both follow the adaptive distance, capped by the configured quantity and trigger */
+    quantity = Min((uint32)p_accessor->sa_distance.distance, p_accessor->sa_prefetch_quantity);
+    trigger = Min((uint32)p_accessor->sa_distance.distance, p_accessor->sa_prefetch_trigger);
     last = p_accessor->sa_last_prefbf;
     forward = ScanDirectionIsForward(dir);
 
@@ -240,6 +241,53 @@ static TupleTableSlot* SeqNext(SeqScanState* node)
     return ExecMakeTupleSlot(tuple, GetHeapScanDesc(scanDesc), slot);
 }
 
+/*
+ * SeqRuntimeFilterPass -- probe the runtime bloom filters a hash join above
+ * has published for our join key columns.  A tuple whose key is NULL or not
+ * in the filter can not join, so it is dropped before the quals are checked.
+ */
+static bool SeqRuntimeFilterPass(SeqScanState* node, TupleTableSlot* slot)
+{
+    Plan* plan = node->ps.plan;
+    ListCell* lc1 = NULL;
+    ListCell* lc2 = NULL;
+
+    forboth(lc1, plan->var_list, lc2, plan->filterIndexList) {
+        Var* var = (Var*)lfirst(lc1);
+        filter::BloomFilter* bf = ExecGetRuntimeFilter(node->ps.state, var, lfirst_int(lc2));
+        bool isnull = false;
+        Datum value;
+
+        if (bf == NULL) {
+            continue;
+        }
+
+        value = slot_getattr(slot, var->varattno, &isnull);
+        if (isnull || !bf->includeDatum(value)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * SeqNextRuntimeFilter -- SeqNext for scans with runtime join filters
+ */
+static TupleTableSlot* SeqNextRuntimeFilter(SeqScanState* node)
+{
+    TupleTableSlot* slot = NULL;
+
+    for (;;) {
+        slot = SeqNext(node);
+        if (TupIsNull(slot) || SeqRuntimeFilterPass(node, slot)) {
+            return slot;
+        }
+
+        InstrCountFiltered1(node, 1);
+    }
+}
+
 /*
  * SeqRecheck -- access method routine to recheck a tuple in EvalPlanQual
  */
@@ -271,8 +319,9 @@ TupleTableSlot* ExecSeqScan(SeqScanState* node)
  *
  *		1,do init prefetch quantity and prefetch trigger for adio
  *		2,prefetch quantity can not exceed NBuffers / 4
- *		3,we set prefetch trigger equal to prefetch quantity, later we can use smart preftch policy,
- *		  if used ring policy, we need check ring size and correct prefetch quantity and trigger
+ *		3,we set prefetch trigger equal to prefetch quantity, if used ring policy, we need check ring
+ *		  size and correct prefetch quantity and trigger
+ *		4,both are only upper bounds, the distance actually used adapts to the read latency
  * ----------------------------------------------------------------
  */
 void SeqScan_Pref_Quantity(AbsTblScanDesc scan, SeqScanAccessor* p_accessor)
@@ -283,14 +332,16 @@ void SeqScan_Pref_Quantity(AbsTblScanDesc scan, SeqScanAccessor* p_accessor)
     p_accessor->sa_prefetch_quantity = (uint32)rtl::min(threshold, prefetch_trigger);
     p_accessor->sa_prefetch_trigger = p_accessor->sa_prefetch_quantity;
 
-    if (scan == NULL) {
-        return;
-    }
-    BufferAccessStrategy bas = GetHeapScanDesc(scan)->rs_strategy;
-    if (bas != NULL) {
-        StrategyGetRingPrefetchQuantityAndTrigger(
-            bas, (int*)&p_accessor->sa_prefetch_quantity, (int*)&p_accessor->sa_prefetch_trigger);
+    if (scan != NULL) {
+        BufferAccessStrategy bas = GetHeapScanDesc(scan)->rs_strategy;
+        if (bas != NULL) {
+            StrategyGetRingPrefetchQuantityAndTrigger(
+                bas, (int*)&p_accessor->sa_prefetch_quantity, (int*)&p_accessor->sa_prefetch_trigger);
+        }
     }
+
+    /* start from a small distance, heapgetpage() grows it while reads still wait */
+    PrefetchDistanceInit(&p_accessor->sa_distance, (int)p_accessor->sa_prefetch_quantity);
 }
 
 /* ----------------------------------------------------------------
@@ -432,7 +483,11 @@ void InitScanRelation(SeqScanState* node, EState* estate)
 static inline void InitSeqNextMtd(SeqScan* node, SeqScanState* scanstate)
 {
     if (!node->tablesample) {
-        scanstate->ScanNextMtd = SeqNext;
+        if (node->plan.var_list != NIL) {
+            scanstate->ScanNextMtd = SeqNextRuntimeFilter;
+        } else {
+            scanstate->ScanNextMtd = SeqNext;
+        }
     } else {
         if (RELATION_OWN_BUCKET(scanstate->ss_currentRelation)) {
             scanstate->ScanNextMtd = HbktSeqSampleNext;
@@ -769,8 +824,16 @@ static void ExecInitNextPartitionForSeqScan(SeqScanState* node)
 
     /* add qual for redis */
 
-    /* update partition scan-related fileds in SeqScanState  */
-    node->ss_currentScanDesc = InitBeginScan(node, currentpartitionrel);
+    /*
+     * update partition scan-related fileds in SeqScanState.  Under a parallel
+     * PartIterator a big partition is scanned in chunks shared by everybody.
+     */
+    if (node->part_pscans != NULL && node->part_pscans[node->currentSlot] != NULL) {
+        node->ss_currentScanDesc =
+            (AbsTblScanDesc)heap_beginscan_parallel(currentpartitionrel, node->part_pscans[node->currentSlot]);
+    } else {
+        node->ss_currentScanDesc = InitBeginScan(node, currentpartitionrel);
+    }
     ADIO_RUN()
     {
         SeqScan_Init(node->ss_currentScanDesc, node->ss_scanaccessor);
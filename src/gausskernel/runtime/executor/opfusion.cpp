@@ -374,6 +374,9 @@ void* OpFusion::FusionFactory(
         case INSERT_FUSION:
             return New(context) InsertFusion(context, psrc, plantree_list, params);
 
+        case MULTI_INSERT_FUSION:
+            return New(context) MultiInsertFusion(context, psrc, plantree_list, params);
+
         case UPDATE_FUSION:
             return New(context) UpdateFusion(context, psrc, plantree_list, params);
 
@@ -1141,6 +1144,180 @@ bool InsertFusion::execute(long max_rows, char* completionTag)
     return success;
 }
 
+MultiInsertFusion::MultiInsertFusion(
+    MemoryContext context, CachedPlanSource* psrc, List* plantree_list, ParamListInfo params)
+    : OpFusion(context, psrc, plantree_list)
+{
+    MemoryContext old_context = MemoryContextSwitchTo(m_context);
+    ModifyTable* node = (ModifyTable*)m_planstmt->planTree;
+    ValuesScan* values_scan = (ValuesScan*)linitial(node->plans);
+    List* targetList = values_scan->scan.plan.targetlist;
+
+    m_reloid = getrelid(linitial_int(m_planstmt->resultRelations), m_planstmt->rtable);
+
+    m_estate = CreateExecutorState();
+    m_estate->es_range_table = m_planstmt->rtable;
+
+    m_tupDesc = ExecTypeFromTL(targetList, false);
+    m_reslot = MakeSingleTupleTableSlot(m_tupDesc);
+    m_values = (Datum*)palloc0(m_tupDesc->natts * sizeof(Datum));
+    m_isnull = (bool*)palloc0(m_tupDesc->natts * sizeof(bool));
+
+    m_valuesLists = values_scan->values_lists;
+    int ncolumns = list_length((List*)linitial(m_valuesLists));
+    m_rowValues = (Datum*)palloc0(ncolumns * sizeof(Datum));
+    m_rowIsnull = (bool*)palloc0(ncolumns * sizeof(bool));
+
+    m_valuesAttno = (AttrNumber*)palloc0(m_tupDesc->natts * sizeof(AttrNumber));
+    m_targetExprs = (Expr**)palloc0(m_tupDesc->natts * sizeof(Expr*));
+
+    ListCell* lc = NULL;
+    int i = 0;
+    foreach (lc, targetList) {
+        Expr* expr = ((TargetEntry*)lfirst(lc))->expr;
+        while (IsA(expr, RelabelType)) {
+            expr = ((RelabelType*)expr)->arg;
+        }
+
+        if (IsA(expr, Var)) {
+            Assert(((Var*)expr)->varno == values_scan->scan.scanrelid);
+            m_valuesAttno[i] = ((Var*)expr)->varattno;
+        } else {
+            m_targetExprs[i] = expr;
+        }
+        i++;
+    }
+
+    initParams(params);
+
+    m_receiver = NULL;
+    m_isInsideRec = true;
+
+    MemoryContextSwitchTo(old_context);
+}
+
+/* evaluate one cell of the VALUES list, checked to be Const, Param, FuncExpr or OpExpr */
+Datum MultiInsertFusion::evalValuesExpr(Expr* expr, bool* is_null)
+{
+    *is_null = false;
+    while (IsA(expr, RelabelType)) {
+        expr = ((RelabelType*)expr)->arg;
+    }
+
+    if (IsA(expr, FuncExpr)) {
+        return CalFuncNodeVal(((FuncExpr*)expr)->funcid, ((FuncExpr*)expr)->args, is_null);
+    } else if (IsA(expr, OpExpr)) {
+        return CalFuncNodeVal(((OpExpr*)expr)->opfuncid, ((OpExpr*)expr)->args, is_null);
+    }
+    return EvalSimpleArg((Node*)expr, is_null);
+}
+
+/* fill m_values/m_isnull with one row, the row independent columns are filled once by execute() */
+void MultiInsertFusion::formRow(List* row)
+{
+    ListCell* lc = NULL;
+    int col = 0;
+    foreach (lc, row) {
+        m_rowValues[col] = evalValuesExpr((Expr*)lfirst(lc), &m_rowIsnull[col]);
+        col++;
+    }
+
+    for (int i = 0; i < m_tupDesc->natts; i++) {
+        if (m_valuesAttno[i] > 0) {
+            m_values[i] = m_rowValues[m_valuesAttno[i] - 1];
+            m_isnull[i] = m_rowIsnull[m_valuesAttno[i] - 1];
+        }
+    }
+}
+
+bool MultiInsertFusion::execute(long max_rows, char* completionTag)
+{
+    bool success = false;
+
+    /*******************
+     * step 1: prepare *
+     *******************/
+    Relation rel = heap_open(m_reloid, RowExclusiveLock);
+
+    ResultRelInfo* result_rel_info = makeNode(ResultRelInfo);
+    InitResultRelInfo(result_rel_info, rel, 1, 0);
+    m_estate->es_result_relation_info = result_rel_info;
+
+    if (result_rel_info->ri_RelationDesc->rd_rel->relhasindex) {
+        ExecOpenIndices(result_rel_info, false);
+    }
+
+    CommandId mycid = GetCurrentCommandId(true);
+
+    init_gtt_storage(CMD_INSERT, result_rel_info);
+
+    for (int i = 0; i < m_tupDesc->natts; i++) {
+        if (m_valuesAttno[i] == 0) {
+            m_values[i] = evalValuesExpr(m_targetExprs[i], &m_isnull[i]);
+        }
+    }
+
+    /*************************
+     * step 2: form the rows *
+     *************************/
+    int ntuples = list_length(m_valuesLists);
+    HeapTuple* tuples = (HeapTuple*)palloc(ntuples * sizeof(HeapTuple));
+    int n = 0;
+    ListCell* lc = NULL;
+    foreach (lc, m_valuesLists) {
+        formRow((List*)lfirst(lc));
+        HeapTuple tuple = heap_form_tuple(m_tupDesc, m_values, m_isnull);
+        Assert(tuple != NULL);
+
+        if (rel->rd_att->constr) {
+            (void)ExecStoreTuple(tuple, m_reslot, InvalidBuffer, false);
+            ExecConstraints(result_rel_info, m_reslot, m_estate);
+        }
+        tuples[n++] = tuple;
+    }
+
+    /******************************
+     * step 3: begin multi insert *
+     ******************************/
+    /* rows landing on the same page share one buffer lock and one WAL record */
+    HeapMultiInsertExtraArgs args = {NULL, 0, false};
+    (void)heap_multi_insert(rel, rel, tuples, ntuples, mycid, 0, NULL, &args);
+
+    if (result_rel_info->ri_NumIndices > 0) {
+        for (int i = 0; i < ntuples; i++) {
+            (void)ExecStoreTuple(tuples[i], m_reslot, InvalidBuffer, false);
+            List* recheck_indexes =
+                ExecInsertIndexTuples(m_reslot, &(tuples[i]->t_self), m_estate, NULL, NULL, InvalidBktId, NULL);
+            list_free_ext(recheck_indexes);
+        }
+    }
+
+    for (int i = 0; i < ntuples; i++) {
+        heap_freetuple_ext(tuples[i]);
+    }
+    pfree_ext(tuples);
+
+    (void)ExecClearTuple(m_reslot);
+    success = true;
+    m_isCompleted = true;
+    /****************
+     * step 4: done *
+     ****************/
+    ExecCloseIndices(result_rel_info);
+
+    heap_close(rel, RowExclusiveLock);
+
+    if (m_estate->esfRelations) {
+        FakeRelationCacheDestroy(m_estate->esfRelations);
+    }
+
+    errno_t errorno =
+        snprintf_s(completionTag, COMPLETION_TAG_BUFSIZE, COMPLETION_TAG_BUFSIZE - 1, "INSERT 0 %d", ntuples);
+    securec_check_ss(errorno, "\0", "\0");
+
+    return success;
+}
+
 MotJitModifyFusion::MotJitModifyFusion(
     MemoryContext context, CachedPlanSource* psrc, List* plantree_list, ParamListInfo params)
     : OpFusion(context, psrc, plantree_list)
@@ -27,6 +27,7 @@
 #include "executor/nodeIndexscan.h"
 #include "optimizer/clauses.h"
 #include "parser/parsetree.h"
+#include "utils/array.h"
 #include "utils/lsyscache.h"
 #include "utils/snapmgr.h"
 #include "access/tableam.h"
@@ -171,18 +172,40 @@ void IndexFusion::IndexBuildScanKey(List* indexqual)
             continue;
         }
 
-        Assert(IsA(clause, OpExpr));
         /* indexkey op const or indexkey op expression */
         uint32 flags = 0;
         Datum scan_value;
+        List* args = NIL;
+        Oid inputcollid;
 
-        opno = ((OpExpr*)clause)->opno;
-        opfuncid = ((OpExpr*)clause)->opfuncid;
+        if (IsA(clause, ScalarArrayOpExpr)) {
+            /* indexkey = ANY(array), the index AM iterates over the array elements */
+            ScalarArrayOpExpr* saop = (ScalarArrayOpExpr*)clause;
+
+            Assert(saop->useOr);
+            if (!m_index->rd_am->amsearcharray) {
+                ereport(ERROR,
+                    (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                        errmsg("index \"%s\" does not support ScalarArrayOpExpr in bypass",
+                            RelationGetRelationName(m_index))));
+            }
+            flags |= SK_SEARCHARRAY;
+            opno = saop->opno;
+            opfuncid = saop->opfuncid;
+            inputcollid = saop->inputcollid;
+            args = saop->args;
+        } else {
+            Assert(IsA(clause, OpExpr));
+            opno = ((OpExpr*)clause)->opno;
+            opfuncid = ((OpExpr*)clause)->opfuncid;
+            inputcollid = ((OpExpr*)clause)->inputcollid;
+            args = ((OpExpr*)clause)->args;
+        }
 
         /*
          * leftop should be the index key Var, possibly relabeled
          */
-        leftop = (Expr*)get_leftop(clause);
+        leftop = (Expr*)linitial(args);
         if (leftop && IsA(leftop, RelabelType))
             leftop = ((RelabelType*)leftop)->arg;
 
@@ -208,7 +231,7 @@ void IndexFusion::IndexBuildScanKey(List* indexqual)
         /*
          * rightop is the constant or variable comparison value
          */
-        rightop = (Expr*)get_rightop(clause);
+        rightop = (Expr*)lsecond(args);
         if (rightop != NULL && IsA(rightop, RelabelType)) {
             rightop = ((RelabelType*)rightop)->arg;
         }
@@ -233,10 +256,35 @@ void IndexFusion::IndexBuildScanKey(List* indexqual)
             varattno,                       /* attribute number to scan */
             op_strategy,                    /* op's strategy */
             op_righttype,                   /* strategy subtype */
-            ((OpExpr*)clause)->inputcollid, /* collation */
+            inputcollid,                    /* collation */
             opfuncid,                       /* reg proc to use */
-            scan_value);                     /* constant */
+            scan_value);                    /* constant */
+    }
+}
+
+/* true if value matches any non-null element of the array, like "value = ANY(array)" */
+static bool EpqCheckArray(Oid opfuncid, Datum value, Datum array_datum)
+{
+    ArrayType* arr = DatumGetArrayTypeP(array_datum);
+    int16 elmlen;
+    bool elmbyval = false;
+    char elmalign;
+    Datum* elem_values = NULL;
+    bool* elem_nulls = NULL;
+    int num_elems = 0;
+    bool found = false;
+
+    get_typlenbyvalalign(ARR_ELEMTYPE(arr), &elmlen, &elmbyval, &elmalign);
+    deconstruct_array(arr, ARR_ELEMTYPE(arr), elmlen, elmbyval, elmalign, &elem_values, &elem_nulls, &num_elems);
+    for (int j = 0; j < num_elems && !found; j++) {
+        if (!elem_nulls[j] && DatumGetBool(OidFunctionCall2(opfuncid, value, elem_values[j]))) {
+            found = true;
+        }
     }
+
+    pfree(elem_values);
+    pfree(elem_nulls);
+    return found;
 }
 
 bool IndexFusion::EpqCheck(Datum* values, const bool* isnull)
@@ -283,6 +331,19 @@ bool IndexFusion::EpqCheck(Datum* values, const bool* isnull)
             if (OidFunctionCall2(opexpr->opfuncid, values[att_num], m_scanKeys[i].sk_argument) == false) {
                 return false;
             }
+        } else if (IsA(lfirst(lc), ScalarArrayOpExpr)) {
+            ScalarArrayOpExpr* saop = (ScalarArrayOpExpr*)lfirst(lc);
+            Expr* leftop = (Expr*)linitial(saop->args);
+            if (leftop != NULL && IsA(leftop, RelabelType))
+                leftop = ((RelabelType*)leftop)->arg;
+
+            Assert(IsA(leftop, Var));
+            att_num = ((Var*)leftop)->varattno - 1;
+
+            if (isnull[att_num] || (m_scanKeys[i].sk_flags & SK_ISNULL) ||
+                !EpqCheckArray(saop->opfuncid, values[att_num], m_scanKeys[i].sk_argument)) {
+                return false;
+            }
         } else {
             Assert(0);
             ereport(ERROR,
@@ -355,10 +416,11 @@ IndexScanFusion::IndexScanFusion(IndexScan* node, PlannedStmt* planstmt, ParamLi
                 continue;
             }
 
-            Assert(IsA(lfirst(lc), OpExpr));
+            Assert(IsA(lfirst(lc), OpExpr) || IsA(lfirst(lc), ScalarArrayOpExpr));
 
-            OpExpr* opexpr = (OpExpr*)lfirst(lc);
-            Expr* var = (Expr*)lsecond(opexpr->args);
+            List* args = IsA(lfirst(lc), OpExpr) ? ((OpExpr*)lfirst(lc))->args
+                                                 : ((ScalarArrayOpExpr*)lfirst(lc))->args;
+            Expr* var = (Expr*)lsecond(args);
 
             if (IsA(var, RelabelType)) {
                 var = ((RelabelType*)var)->arg;
@@ -514,10 +576,11 @@ IndexOnlyScanFusion::IndexOnlyScanFusion(IndexOnlyScan* node, PlannedStmt* plans
                 continue;
             }
 
-            Assert(IsA(lfirst(lc), OpExpr));
+            Assert(IsA(lfirst(lc), OpExpr) || IsA(lfirst(lc), ScalarArrayOpExpr));
 
-            OpExpr* opexpr = (OpExpr*)lfirst(lc);
-            Expr* var = (Expr*)lsecond(opexpr->args);
+            List* args = IsA(lfirst(lc), OpExpr) ? ((OpExpr*)lfirst(lc))->args
+                                                 : ((ScalarArrayOpExpr*)lfirst(lc))->args;
+            Expr* var = (Expr*)lsecond(args);
 
             if (IsA(var, RelabelType)) {
                 var = ((RelabelType*)var)->arg;
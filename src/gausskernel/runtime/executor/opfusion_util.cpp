@@ -34,6 +34,7 @@
 #include "mb/pg_wchar.h"
 #include "nodes/makefuncs.h"
 #include "optimizer/clauses.h"
+#include "optimizer/var.h"
 #include "parser/parsetree.h"
 #include "utils/dynahash.h"
 #include "utils/lsyscache.h"
@@ -58,6 +59,10 @@ const char *getBypassReason(FusionType result)
             return "Bypass executed through insert fusion";
         }
 
+        case MULTI_INSERT_FUSION: {
+            return "Bypass executed through multi-row insert fusion";
+        }
+
         case UPDATE_FUSION: {
             return "Bypass executed through update fusion";
         }
@@ -489,13 +494,20 @@ template <bool is_dml, bool isonlyindex> FusionType checkFusionIndexScan(Node *n
             continue;
         }
 
-        if (!IsA(lfirst(lc), OpExpr)) {
+        /*
+         * Besides "key op value" accept "key = ANY(array)", the index AM walks
+         * the array itself (SK_SEARCHARRAY), so IN-list lookups need no executor.
+         */
+        List *args = NIL;
+        if (IsA(lfirst(lc), OpExpr)) {
+            args = ((OpExpr *)lfirst(lc))->args;
+        } else if (IsA(lfirst(lc), ScalarArrayOpExpr) && ((ScalarArrayOpExpr *)lfirst(lc))->useOr) {
+            args = ((ScalarArrayOpExpr *)lfirst(lc))->args;
+        } else {
             return NOBYPASS_INDEXSCAN_CONDITION_INVALID;
         }
 
-        OpExpr *opexpr = (OpExpr *)lfirst(lc);
-
-        if (list_length(opexpr->args) != 2) {
+        if (list_length(args) != 2) {
             if (isonlyindex) {
                 return NOBYPASS_INDEXONLYSCAN_CONDITION_INVALID;
             } else {
@@ -506,12 +518,12 @@ template <bool is_dml, bool isonlyindex> FusionType checkFusionIndexScan(Node *n
         Expr *leftop = NULL;  /* expr on lhs of operator */
         Expr *rightop = NULL; /* expr on rhs ... */
 
-        leftop = (Expr *)linitial(opexpr->args);
+        leftop = (Expr *)linitial(args);
         if (leftop != NULL && IsA(leftop, RelabelType)) {
             leftop = ((RelabelType *)leftop)->arg;
         }
 
-        rightop = (Expr *)lsecond(opexpr->args);
+        rightop = (Expr *)lsecond(args);
         if (rightop != NULL && IsA(rightop, RelabelType)) {
             rightop = ((RelabelType *)rightop)->arg;
         }
@@ -726,6 +738,47 @@ FusionType checkTargetlist(List *targetList, FusionType ftype)
     return ftype;
 }
 
+/*
+ * For multi-row insert the targetlist of the values scan may only pick columns
+ * of the VALUES list by position or hold expressions that do not depend on the
+ * row (defaults of columns not given), and every cell of the VALUES list has to
+ * be as simple as the targetlist of a single row insert.
+ */
+static FusionType checkMultiInsertValues(ValuesScan *node, FusionType ftype)
+{
+    ListCell *lc = NULL;
+    foreach (lc, node->scan.plan.targetlist) {
+        TargetEntry *target = (TargetEntry *)lfirst(lc);
+        Expr *expr = target->expr;
+        while (IsA(expr, RelabelType)) {
+            expr = ((RelabelType *)expr)->arg;
+        }
+
+        if (IsA(expr, Var)) {
+            Var *var = (Var *)expr;
+            if (var->varno != node->scan.scanrelid || var->varattno <= 0) {
+                return NOBYPASS_EXP_NOT_SUPPORT;
+            }
+            continue;
+        }
+
+        if (contain_var_clause((Node *)expr) || !checkExpr((Node *)expr, true)) {
+            return NOBYPASS_EXP_NOT_SUPPORT;
+        }
+    }
+
+    ListCell *row = NULL;
+    foreach (row, node->values_lists) {
+        foreach (lc, (List *)lfirst(row)) {
+            Node *cell = (Node *)lfirst(lc);
+            if (contain_var_clause(cell) || !checkExpr(cell, true)) {
+                return NOBYPASS_EXP_NOT_SUPPORT;
+            }
+        }
+    }
+    return ftype;
+}
+
 bool checkDMLRelation(Relation rel, PlannedStmt *plannedstmt)
 {
     if (rel->rd_rel->relkind != RELKIND_RELATION || rel->rd_rel->relhasrules || rel->rd_rel->relhastriggers ||
@@ -755,11 +808,19 @@ FusionType getInsertFusionType(List *stmt_list, ParamListInfo params)
     if (list_length(node->plans) != 1) {
         return NOBYPASS_NO_SIMPLE_PLAN;
     }
-    if (!IsA(linitial(node->plans), BaseResult)) {
-        return NOBYPASS_NO_SIMPLE_INSERT;
-    }
-    BaseResult *base = (BaseResult *)linitial(node->plans);
-    if (base->plan.lefttree != NULL || base->plan.initPlan != NIL || base->resconstantqual != NULL) {
+    Plan *subplan = (Plan *)linitial(node->plans);
+    if (IsA(subplan, ValuesScan)) {
+        /* INSERT ... VALUES (...), (...) */
+        if (subplan->lefttree != NULL || subplan->initPlan != NIL || subplan->qual != NIL) {
+            return NOBYPASS_NO_SIMPLE_INSERT;
+        }
+        ftype = MULTI_INSERT_FUSION;
+    } else if (IsA(subplan, BaseResult)) {
+        BaseResult *base = (BaseResult *)subplan;
+        if (base->plan.lefttree != NULL || base->plan.initPlan != NIL || base->resconstantqual != NULL) {
+            return NOBYPASS_NO_SIMPLE_INSERT;
+        }
+    } else {
         return NOBYPASS_NO_SIMPLE_INSERT;
     }
     if (node->upsertAction != UPSERT_NONE) {
@@ -799,13 +860,22 @@ FusionType getInsertFusionType(List *stmt_list, ParamListInfo params)
         heap_close(rel, AccessShareLock);
         return NOBYPASS_DML_RELATION_NOT_SUPPORT;
     }
+    /* rows of one statement may hash to different buckets, keep those on the executor */
+    if (ftype == MULTI_INSERT_FUSION && RELATION_OWN_BUCKET(rel)) {
+        heap_close(rel, AccessShareLock);
+        return NOBYPASS_DML_RELATION_NOT_SUPPORT;
+    }
     heap_close(rel, AccessShareLock);
+
+    if (ftype == MULTI_INSERT_FUSION) {
+        return checkMultiInsertValues((ValuesScan *)subplan, ftype);
+    }
+
     /*
      * check targetlist
      * maybe expr type is FuncExpr because of type conversion.
      */
-    BaseResult *base_result = (BaseResult *)linitial(node->plans);
-    List *targetlist = base_result->plan.targetlist;
+    List *targetlist = subplan->targetlist;
     return checkTargetlist(targetlist, ftype);
 }
 
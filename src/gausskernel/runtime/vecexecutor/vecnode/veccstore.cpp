@@ -184,6 +184,51 @@ void OptimizeProjectionAndFilter(CStoreScanState* node)
     node->m_fSimpleMap = simple_map;
 }
 
+/*
+ * @Description: Drop the rows whose join key is NULL or misses the runtime bloom filter
+ *               a hash join above has built for it.
+ * @in node: CStoreScan state, whose plan var_list holds the filtered columns.
+ * @in p_scan_batch: Scan batch with all accessed columns filled.
+ * @return: false if no row is left.
+ */
+static bool ApplyRuntimeFilters(CStoreScanState* node, VectorBatch* p_scan_batch)
+{
+    Plan* plan = node->ps.plan;
+    bool* sel = p_scan_batch->m_sel;
+    bool need_pack = false;
+    ListCell* lc1 = NULL;
+    ListCell* lc2 = NULL;
+
+    forboth(lc1, plan->var_list, lc2, plan->filterIndexList) {
+        Var* var = (Var*)lfirst(lc1);
+        filter::BloomFilter* bf = ExecGetRuntimeFilter(node->ps.state, var, lfirst_int(lc2));
+
+        if (bf == NULL) {
+            continue;
+        }
+
+        if (!need_pack) {
+            for (int i = 0; i < p_scan_batch->m_rows; i++) {
+                sel[i] = true;
+            }
+            need_pack = true;
+        }
+
+        ScalarVector* vec = &p_scan_batch->m_arr[var->varattno - 1];
+        for (int i = 0; i < p_scan_batch->m_rows; i++) {
+            if (sel[i] && (IS_NULL(vec->m_flag[i]) || !bf->includeDatum(vec->m_vals[i]))) {
+                sel[i] = false;
+            }
+        }
+    }
+
+    if (need_pack) {
+        p_scan_batch->Pack(sel);
+    }
+
+    return p_scan_batch->m_rows > 0;
+}
+
 VectorBatch* ApplyProjectionAndFilter(CStoreScanState* node, VectorBatch* p_scan_batch, ExprDoneCond* done)
 {
     List* qual = NIL;
@@ -255,6 +300,13 @@ VectorBatch* ApplyProjectionAndFilter(CStoreScanState* node, VectorBatch* p_scan
             node->ss_deltaScan = false;
         }
 
+        // Drop rows that can not join the hash join above before projecting them
+        //
+        if (node->ps.plan->var_list != NIL && !ApplyRuntimeFilters(node, p_scan_batch)) {
+            p_out_batch->m_rows = 0;
+            goto done;
+        }
+
         // Project the final result
         //
         if (!simple_map) {
@@ -1793,13 +1793,23 @@ static void ValidateStrOptCompression(const char* val)
     if (pg_strcasecmp(val, COMPRESSION_NO) != 0 && pg_strcasecmp(val, COMPRESSION_YES) != 0 &&
         pg_strcasecmp(val, COMPRESSION_LOW) != 0 && pg_strcasecmp(val, COMPRESSION_MIDDLE) != 0 &&
         pg_strcasecmp(val, COMPRESSION_HIGH) != 0 && pg_strcasecmp(val, COMPRESSION_ZLIB) != 0 &&
-        pg_strcasecmp(val, COMPRESSION_SNAPPY) != 0 && pg_strcasecmp(val, COMPRESSION_LZ4) != 0)
+        pg_strcasecmp(val, COMPRESSION_SNAPPY) != 0 && pg_strcasecmp(val, COMPRESSION_LZ4) != 0 &&
+        pg_strcasecmp(val, COMPRESSION_ZSTD) != 0)
         ereport(ERROR,
             (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
                 errmsg("Invalid string for  \"COMPRESSION\" option."),
-                errdetail("Valid string are \"no\", \"yes\", \"low\", \"middle\", \"high\" for non-dfs table. "
+                errdetail("Valid string are \"no\", \"yes\", \"low\", \"middle\", \"high\", \"zstd\" for non-dfs "
+                          "table. "
                           "Valid string are \"no\", \"yes\", \"low\", \"middle\", \"high\", \"snappy\", \"zlib\", "
                           "\"lz4\" for dfs table.")));
+
+#ifndef USE_ZSTD
+    if (pg_strcasecmp(val, COMPRESSION_ZSTD) == 0)
+        ereport(ERROR,
+            (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                errmsg("unsupported \"COMPRESSION\" option \"%s\"", val),
+                errdetail("This functionality requires the server to be built with zstd support.")));
+#endif
 }
 
 /*
@@ -1885,6 +1895,12 @@ static OptCompress heap_get_compression(const char* compress_opt)
     if (pg_strcasecmp(compress_opt, COMPRESSION_LOW) == 0)
         return COMPRESS_LOW;
 
+#ifdef USE_ZSTD
+    /* COMPRESSION is 'zstd' */
+    if (pg_strcasecmp(compress_opt, COMPRESSION_ZSTD) == 0)
+        return COMPRESS_ZSTD;
+#endif
+
     /* COMPRESSION is 'high' */
     return COMPRESS_HIGH;
 }
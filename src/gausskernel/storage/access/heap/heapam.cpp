@@ -299,7 +299,22 @@ void heapgetpage(HeapScanDesc scan, BlockNumber page)
     CHECK_FOR_INTERRUPTS();
 
     /* read page using selected strategy */
-    scan->rs_cbuf = ReadBufferExtended(scan->rs_rd, MAIN_FORKNUM, page, RBM_NORMAL, scan->rs_strategy);
+    ADIO_RUN()
+    {
+        if (scan->rs_ss_accessor != NULL) {
+            /* time the read, so that the prefetch distance follows the read latency */
+            PrefetchDistanceReadStart(&scan->rs_ss_accessor->sa_distance);
+            scan->rs_cbuf = ReadBufferExtended(scan->rs_rd, MAIN_FORKNUM, page, RBM_NORMAL, scan->rs_strategy);
+            PrefetchDistanceReadDone(&scan->rs_ss_accessor->sa_distance);
+        } else {
+            scan->rs_cbuf = ReadBufferExtended(scan->rs_rd, MAIN_FORKNUM, page, RBM_NORMAL, scan->rs_strategy);
+        }
+    }
+    ADIO_ELSE()
+    {
+        scan->rs_cbuf = ReadBufferExtended(scan->rs_rd, MAIN_FORKNUM, page, RBM_NORMAL, scan->rs_strategy);
+    }
+    ADIO_END();
     scan->rs_cblock = page;
 
     /* We've pinned the buffer, nobody can prune this buffer, check whether snapshot is valid. */
@@ -1875,11 +1890,14 @@ HeapTuple heapGetNextForVerify(HeapScanDesc scan, ScanDirection direction, bool&
  * 		heap_parallelscan_estimate - estimate storage for ParallelHeapScanDesc
  *
  * 		Sadly, this doesn't reduce to a constant, because the size required
- * 		to serialize the snapshot can vary.
+ * 		to serialize the snapshot can vary.  SnapshotAny, which parallel
+ * 		index builds use, is not serialized at all.
  * ----------------
  */
 Size heap_parallelscan_estimate(Snapshot snapshot)
 {
+    if (snapshot == SnapshotAny)
+        return offsetof(ParallelHeapScanDescData, phs_snapshot_data);
     return add_size(offsetof(ParallelHeapScanDescData, phs_snapshot_data), EstimateSnapshotSpace(snapshot));
 }
 
@@ -1902,8 +1920,27 @@ void heap_parallelscan_initialize(ParallelHeapScanDesc target, Size pscan_len, R
     target->phs_startblock = InvalidBlockNumber;
     target->pscan_len = pscan_len;
     pg_atomic_write_u64(&target->phs_nallocated, 0);
-    SerializeSnapshot(snapshot, target->phs_snapshot_data,
-        pscan_len - offsetof(ParallelHeapScanDescData, phs_snapshot_data));
+    if (snapshot == SnapshotAny) {
+        target->phs_snapshot_any = true;
+    } else {
+        Assert(IsMVCCSnapshot(snapshot));
+        target->phs_snapshot_any = false;
+        SerializeSnapshot(snapshot, target->phs_snapshot_data,
+            pscan_len - offsetof(ParallelHeapScanDescData, phs_snapshot_data));
+    }
+}
+
+/* ----------------
+ * 		heap_parallelscan_reinitialize - reset a parallel scan
+ *
+ * 		Call this in the leader process.  Caller is responsible for
+ * 		making sure that all workers have finished the scan beforehand.
+ * ----------------
+ */
+void heap_parallelscan_reinitialize(ParallelHeapScanDesc parallel_scan)
+{
+    parallel_scan->phs_startblock = InvalidBlockNumber;
+    pg_atomic_write_u64(&parallel_scan->phs_nallocated, 0);
 }
 
 /* ----------------
@@ -1915,11 +1952,17 @@ void heap_parallelscan_initialize(ParallelHeapScanDesc target, Size pscan_len, R
 HeapScanDesc heap_beginscan_parallel(Relation relation, ParallelHeapScanDesc parallel_scan)
 {
     Assert(RelationGetRelid(relation) == parallel_scan->phs_relid);
-    Snapshot snapshot = RestoreSnapshot(parallel_scan->phs_snapshot_data,
-        parallel_scan->pscan_len - offsetof(ParallelHeapScanDescData, phs_snapshot_data));
-    RegisterSnapshot(snapshot);
+    Snapshot snapshot = SnapshotAny;
+    uint32 flag = SO_ALLOW_STRAT | SO_ALLOW_SYNC;
+
+    if (!parallel_scan->phs_snapshot_any) {
+        /* Snapshot was serialized -- restore it */
+        snapshot = RestoreSnapshot(parallel_scan->phs_snapshot_data,
+            parallel_scan->pscan_len - offsetof(ParallelHeapScanDescData, phs_snapshot_data));
+        RegisterSnapshot(snapshot);
+        flag |= SO_TEMP_SNAPSHOT;
+    }
 
-    uint32 flag = SO_ALLOW_STRAT | SO_ALLOW_SYNC | SO_TEMP_SNAPSHOT;
     return heap_beginscan_internal(relation, snapshot, 0, NULL, parallel_scan, flag);
 }
 
@@ -129,6 +129,9 @@ IndexScanDesc RelationGetIndexScan(Relation index_relation, int nkeys, int norde
     scan->xs_cbuf = InvalidBuffer;
     scan->xs_continue_hot = false;
 
+    scan->parallel_scan = NULL;
+    scan->xs_temp_snap = false;
+
     return scan;
 }
 
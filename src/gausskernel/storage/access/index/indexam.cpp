@@ -16,6 +16,10 @@
  *		index_close		- close an index relation
  *		index_beginscan - start a scan of an index with amgettuple
  *		index_beginscan_bitmap - start a scan of an index with amgetbitmap
+ *		index_parallelscan_estimate - estimate shared memory for parallel scan
+ *		index_parallelscan_initialize - initialize parallel scan
+ *		index_parallelrescan  - (re)start a parallel scan of an index
+ *		index_beginscan_parallel - join parallel index scan
  *		index_rescan	- restart a scan of an index
  *		index_endscan	- end a scan
  *		index_insert	- insert an index tuple into a relation
@@ -67,12 +71,14 @@
 #include "postgres.h"
 #include "knl/knl_variable.h"
 
+#include "access/nbtree.h"
 #include "access/relscan.h"
 #include "access/transam.h"
 #include "access/tableam.h"
 #include "access/xlog.h"
 #include "catalog/index.h"
 #include "catalog/catalog.h"
+#include "catalog/pg_am.h"
 #include "pgstat.h"
 #include "replication/bcm.h"
 #include "replication/dataqueue.h"
@@ -289,6 +295,116 @@ IndexScanDesc index_beginscan_bitmap(Relation index_relation, Snapshot snapshot,
     return scan;
 }
 
+/*
+ * Parallel index scans are only supported by btree, which keeps its shared
+ * state in BTParallelScanDescData.  pg_am has no entry points for parallel
+ * scans, so the btree routines are called directly.
+ */
+#define IndexSupportsParallelScan(index_relation) ((index_relation)->rd_rel->relam == BTREE_AM_OID)
+
+/*
+ * index_parallelscan_estimate - estimate shared memory for parallel scan
+ *
+ * Currently, we don't pass any information to the AM-specific estimator,
+ * so it can probably only return a constant.  In the future, we might need
+ * to pass more information.
+ */
+Size index_parallelscan_estimate(Relation index_relation, Snapshot snapshot)
+{
+    Size nbytes;
+
+    RELATION_CHECKS;
+
+    if (!IndexSupportsParallelScan(index_relation)) {
+        ereport(ERROR, (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+            errmsg("index \"%s\" does not support parallel scan", RelationGetRelationName(index_relation))));
+    }
+
+    nbytes = offsetof(ParallelIndexScanDescData, ps_snapshot_data);
+    nbytes = add_size(nbytes, EstimateSnapshotSpace(snapshot));
+    nbytes = MAXALIGN(nbytes);
+
+    /* add the btree specific shared state */
+    nbytes = add_size(nbytes, btestimateparallelscan());
+
+    return nbytes;
+}
+
+/*
+ * index_parallelscan_initialize - initialize parallel scan
+ *
+ * We initialize both the ParallelIndexScanDesc proper and the AM-specific
+ * information which follows it.
+ *
+ * This function calls access method specific initialization routine to
+ * initialize am specific information.  Call this just once in the leader
+ * process; then, individual workers attach via index_beginscan_parallel.
+ */
+void index_parallelscan_initialize(Relation heap_relation, Relation index_relation, Snapshot snapshot,
+    ParallelIndexScanDesc target, Size pscan_len)
+{
+    Size offset;
+
+    RELATION_CHECKS;
+
+    offset = add_size(offsetof(ParallelIndexScanDescData, ps_snapshot_data), EstimateSnapshotSpace(snapshot));
+    offset = MAXALIGN(offset);
+
+    target->ps_relid = RelationGetRelid(heap_relation);
+    target->ps_indexid = RelationGetRelid(index_relation);
+    target->ps_offset = offset;
+    target->pscan_len = pscan_len;
+    SerializeSnapshot(
+        snapshot, target->ps_snapshot_data, offset - offsetof(ParallelIndexScanDescData, ps_snapshot_data));
+
+    /* initialize the btree specific shared state */
+    btinitparallelscan(OffsetToPointer(target, offset));
+}
+
+/* ----------------
+ *		index_parallelrescan  - (re)start a parallel scan of an index
+ * ----------------
+ */
+void index_parallelrescan(IndexScanDesc scan)
+{
+    SCAN_CHECKS;
+
+    /* reset the btree specific shared state */
+    if (scan->parallel_scan != NULL) {
+        btparallelrescan(scan);
+    }
+}
+
+/*
+ * index_beginscan_parallel - join parallel index scan
+ *
+ * Caller must be holding suitable locks on the heap and the index.
+ */
+IndexScanDesc index_beginscan_parallel(
+    Relation heaprel, Relation indexrel, int nkeys, int norderbys, ParallelIndexScanDesc pscan)
+{
+    Snapshot snapshot;
+    IndexScanDesc scan;
+
+    Assert(RelationGetRelid(heaprel) == pscan->ps_relid);
+    Assert(RelationGetRelid(indexrel) == pscan->ps_indexid);
+    snapshot = RestoreSnapshot(
+        pscan->ps_snapshot_data, pscan->ps_offset - offsetof(ParallelIndexScanDescData, ps_snapshot_data));
+    RegisterSnapshot(snapshot);
+    scan = index_beginscan_internal(indexrel, nkeys, norderbys, snapshot);
+
+    /*
+     * Save additional parameters into the scandesc.  Everything else was set
+     * up by index_beginscan_internal.
+     */
+    scan->heapRelation = heaprel;
+    scan->xs_snapshot = snapshot;
+    scan->xs_temp_snap = true;
+    scan->parallel_scan = pscan;
+
+    return scan;
+}
+
 /*
  * index_beginscan_internal --- common code for index_beginscan variants
  */
@@ -386,6 +502,10 @@ void index_endscan(IndexScanDesc scan)
         GPIScanEnd(scan->xs_gpi_scan);
     }
 
+    if (scan->xs_temp_snap) {
+        UnregisterSnapshot(scan->xs_snapshot);
+    }
+
     /* Release the scan data structure itself */
     IndexScanEnd(scan);
 }
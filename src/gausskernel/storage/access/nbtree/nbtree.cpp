@@ -27,6 +27,7 @@
 #include "storage/indexfsm.h"
 #include "storage/ipc.h"
 #include "storage/lmgr.h"
+#include "storage/spin.h"
 #include "storage/smgr.h"
 #include "tcop/tcopprot.h"
 #include "utils/aiomem.h"
@@ -48,8 +49,6 @@ typedef struct {
     MemoryContext pagedelcontext;
 } BTVacState;
 
-static void btbuildCallback(
-    Relation index, HeapTuple htup, Datum* values, const bool* isnull, bool tupleIsAlive, void* state);
 static void btvacuumscan(IndexVacuumInfo* info, IndexBulkDeleteResult* stats, IndexBulkDeleteCallback callback,
     void* callback_state, BTCycleId cycleid);
 static void btvacuumpage(BTVacState* vstate, BlockNumber blkno, BlockNumber orig_blkno);
@@ -73,6 +72,7 @@ Datum btbuild(PG_FUNCTION_ARGS)
     buildstate.spool = NULL;
     buildstate.spool2 = NULL;
     buildstate.indtuples = 0;
+    buildstate.btleader = NULL;
 
 #ifdef BTREE_BUILD_STATS
     if (u_sess->attr.attr_resource.log_btree_build_stats) {
@@ -88,17 +88,35 @@ Datum btbuild(PG_FUNCTION_ARGS)
                 errmsg("index \"%s\" already contains data", RelationGetRelationName(index))));
     }
 
+    /*
+     * Attempt to launch parallel worker scan when required.  Worker threads
+     * scan and sort their part of the heap, leaving only the final merge to
+     * the spools created below.
+     */
+    if (indexInfo->ii_ParallelWorkers > 0 && !RelationIsGlobalIndex(index)) {
+        _bt_begin_parallel(&buildstate, index, indexInfo->ii_Concurrent, indexInfo->ii_ParallelWorkers);
+    }
+
     // If building a unique index, put dead tuples in a second spool to keep
     // them out of the uniqueness check.
     if (indexInfo->ii_Unique) {
-        buildstate.spool2 = _bt_spoolinit(index, false, true, &indexInfo->ii_desc);
+        buildstate.spool2 = _bt_spoolinit(index, false, true, &indexInfo->ii_desc, buildstate.btleader);
     }
 
-    buildstate.spool = _bt_spoolinit(index, indexInfo->ii_Unique, false, &indexInfo->ii_desc);
+    buildstate.spool = _bt_spoolinit(index, indexInfo->ii_Unique, false, &indexInfo->ii_desc, buildstate.btleader);
 
     /* do the heap scan */
     double* allPartTuples = NULL;
-    if (RelationIsGlobalIndex(index)) {
+    if (buildstate.btleader != NULL) {
+        bool brokenhotchain = false;
+
+        reltuples = _bt_parallel_heapscan(&buildstate, &brokenhotchain);
+
+        /* Report a broken HOT chain seen by any participant, as serial scan would */
+        if (brokenhotchain) {
+            indexInfo->ii_BrokenHotChain = true;
+        }
+    } else if (RelationIsGlobalIndex(index)) {
         allPartTuples = GlobalIndexBuildHeapScan(heap, index, indexInfo, btbuildCallback, (void*)&buildstate);
     } else {
         reltuples = IndexBuildHeapScan(heap, index, indexInfo, true, btbuildCallback, (void*)&buildstate);
@@ -121,6 +139,9 @@ Datum btbuild(PG_FUNCTION_ARGS)
     if (buildstate.spool2) {
         _bt_spooldestroy(buildstate.spool2);
     }
+    if (buildstate.btleader != NULL) {
+        _bt_end_parallel(buildstate.btleader);
+    }
 
 #ifdef BTREE_BUILD_STATS
     if (u_sess->attr.attr_resource.log_btree_build_stats) {
@@ -142,7 +163,7 @@ Datum btbuild(PG_FUNCTION_ARGS)
 /*
  * Per-tuple callback from IndexBuildHeapScan
  */
-static void btbuildCallback(
+void btbuildCallback(
     Relation index, HeapTuple htup, Datum* values, const bool* isnull, bool tupleIsAlive, void* state)
 {
     BTBuildState* buildstate = (BTBuildState*)state;
@@ -505,6 +526,166 @@ Datum btrescan(PG_FUNCTION_ARGS)
     PG_RETURN_VOID();
 }
 
+/*
+ * btestimateparallelscan -- estimate storage for BTParallelScanDescData
+ */
+Size btestimateparallelscan(void)
+{
+    return sizeof(BTParallelScanDescData);
+}
+
+/*
+ * btinitparallelscan -- initialize BTParallelScanDesc for parallel btree scan
+ */
+void btinitparallelscan(void* target)
+{
+    BTParallelScanDesc bt_target = (BTParallelScanDesc)target;
+
+    SpinLockInit(&bt_target->btps_mutex);
+    bt_target->btps_scanPage = InvalidBlockNumber;
+    bt_target->btps_pageStatus = BTPARALLEL_NOT_INITIALIZED;
+    ConditionVariableInit(&bt_target->btps_cv);
+}
+
+/*
+ *	btparallelrescan() -- reset parallel scan
+ */
+void btparallelrescan(IndexScanDesc scan)
+{
+    BTParallelScanDesc btscan;
+    ParallelIndexScanDesc parallel_scan = scan->parallel_scan;
+
+    Assert(parallel_scan);
+
+    btscan = (BTParallelScanDesc)OffsetToPointer(parallel_scan, parallel_scan->ps_offset);
+
+    /*
+     * In theory, we don't need to acquire the spinlock here, because there
+     * shouldn't be any other workers running at this point, but we do so for
+     * consistency.
+     */
+    SpinLockAcquire(&btscan->btps_mutex);
+    btscan->btps_scanPage = InvalidBlockNumber;
+    btscan->btps_pageStatus = BTPARALLEL_NOT_INITIALIZED;
+    SpinLockRelease(&btscan->btps_mutex);
+}
+
+/*
+ * _bt_parallel_seize() -- Begin the process of advancing the scan to a new
+ *		page.  Other scans must wait until we call _bt_parallel_release() or
+ *		_bt_parallel_done().
+ *
+ * The return value is true if we successfully seized the scan and false
+ * if we did not.  The latter case occurs if no pages remain.
+ *
+ * If the return value is true, *pageno returns the next or current page
+ * of the scan (depending on the scan direction).  An invalid block number
+ * means the scan hasn't yet started, and P_NONE means we've reached the end.
+ * The first time a participating process reaches the last page, it will return
+ * true and set *pageno to P_NONE; after that, further attempts to seize the
+ * scan will return false.
+ *
+ * Callers should ignore the value of pageno if the return value is false.
+ */
+bool _bt_parallel_seize(IndexScanDesc scan, BlockNumber* pageno)
+{
+    BTPS_State pageStatus;
+    bool exit_loop = false;
+    bool status = true;
+    ParallelIndexScanDesc parallel_scan = scan->parallel_scan;
+    BTParallelScanDesc btscan;
+
+    *pageno = P_NONE;
+
+    btscan = (BTParallelScanDesc)OffsetToPointer(parallel_scan, parallel_scan->ps_offset);
+
+    while (1) {
+        SpinLockAcquire(&btscan->btps_mutex);
+        pageStatus = btscan->btps_pageStatus;
+
+        if (pageStatus == BTPARALLEL_DONE) {
+            /*
+             * We're done with this set of scankeys.  This may be the end, or
+             * there could be more sets to try.
+             */
+            status = false;
+            exit_loop = true;
+        } else if (pageStatus != BTPARALLEL_ADVANCING) {
+            /*
+             * We have successfully seized control of the scan for the purpose
+             * of advancing it to a new page!
+             */
+            btscan->btps_pageStatus = BTPARALLEL_ADVANCING;
+            *pageno = btscan->btps_scanPage;
+            exit_loop = true;
+        }
+        SpinLockRelease(&btscan->btps_mutex);
+        if (exit_loop || !status) {
+            break;
+        }
+        ConditionVariableSleep(&btscan->btps_cv);
+    }
+    ConditionVariableCancelSleep();
+
+    return status;
+}
+
+/*
+ * _bt_parallel_release() -- Complete the process of advancing the scan to a
+ *		new page.  We now have the new value btps_scanPage; some other backend
+ *		can now begin advancing the scan.
+ */
+void _bt_parallel_release(IndexScanDesc scan, BlockNumber scan_page)
+{
+    ParallelIndexScanDesc parallel_scan = scan->parallel_scan;
+    BTParallelScanDesc btscan;
+
+    btscan = (BTParallelScanDesc)OffsetToPointer(parallel_scan, parallel_scan->ps_offset);
+
+    SpinLockAcquire(&btscan->btps_mutex);
+    btscan->btps_scanPage = scan_page;
+    btscan->btps_pageStatus = BTPARALLEL_IDLE;
+    SpinLockRelease(&btscan->btps_mutex);
+    ConditionVariableSignal(&btscan->btps_cv);
+}
+
+/*
+ * _bt_parallel_done() -- Mark the parallel scan as complete.
+ *
+ * When there are no pages left to scan, this function should be called to
+ * notify other workers.  Otherwise, they might wait forever for the scan to
+ * advance to the next page.
+ */
+void _bt_parallel_done(IndexScanDesc scan)
+{
+    ParallelIndexScanDesc parallel_scan = scan->parallel_scan;
+    BTParallelScanDesc btscan;
+    bool status_changed = false;
+
+    /* Do nothing, for non-parallel scans */
+    if (parallel_scan == NULL) {
+        return;
+    }
+
+    btscan = (BTParallelScanDesc)OffsetToPointer(parallel_scan, parallel_scan->ps_offset);
+
+    /*
+     * Mark the parallel scan as done, unless some other process did so
+     * already.
+     */
+    SpinLockAcquire(&btscan->btps_mutex);
+    if (btscan->btps_pageStatus != BTPARALLEL_DONE) {
+        btscan->btps_pageStatus = BTPARALLEL_DONE;
+        status_changed = true;
+    }
+    SpinLockRelease(&btscan->btps_mutex);
+
+    /* wake up all the workers associated with this parallel scan */
+    if (status_changed) {
+        ConditionVariableBroadcast(&btscan->btps_cv);
+    }
+}
+
 /*
  *	btendscan() -- close down a scan
  */
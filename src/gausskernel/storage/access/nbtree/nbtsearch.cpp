@@ -32,6 +32,8 @@
 static bool _bt_readpage(IndexScanDesc scan, ScanDirection dir, OffsetNumber offnum);
 static void _bt_saveitem(BTScanOpaque so, int itemIndex, OffsetNumber offnum, IndexTuple itup, Oid partOid);
 static bool _bt_steppage(IndexScanDesc scan, ScanDirection dir);
+static bool _bt_readnextpage(IndexScanDesc scan, BlockNumber blkno, ScanDirection dir);
+static bool _bt_parallel_readpage(IndexScanDesc scan, BlockNumber blkno, ScanDirection dir);
 static Buffer _bt_walk_left(Relation rel, Buffer buf);
 static bool _bt_endpoint(IndexScanDesc scan, ScanDirection dir);
 
@@ -473,6 +475,7 @@ bool _bt_first(IndexScanDesc scan, ScanDirection dir)
     int i;
     StrategyNumber strat_total;
     BTScanPosItem* currItem = NULL;
+    BlockNumber blkno;
 
     pgstat_count_index_scan(rel);
 
@@ -486,8 +489,32 @@ bool _bt_first(IndexScanDesc scan, ScanDirection dir)
      * Quit now if _bt_preprocess_keys() discovered that the scan keys can
      * never be satisfied (eg, x == 1 AND x > 2).
      */
-    if (!so->qual_ok)
+    if (!so->qual_ok) {
+        _bt_parallel_done(scan);
         return false;
+    }
+
+    /*
+     * For parallel scans, get the starting page from shared state. If the
+     * scan has not started, proceed to find out first leaf page in the usual
+     * way while keeping other participating processes waiting.  If the scan
+     * has already begun, use the page number from the shared structure.
+     * Only forward scans are ever planned as parallel.
+     */
+    if (scan->parallel_scan != NULL) {
+        Assert(ScanDirectionIsForward(dir));
+        if (!_bt_parallel_seize(scan, &blkno)) {
+            return false;
+        } else if (blkno == P_NONE) {
+            _bt_parallel_done(scan);
+            return false;
+        } else if (blkno != InvalidBlockNumber) {
+            if (!_bt_parallel_readpage(scan, blkno, dir)) {
+                return false;
+            }
+            goto readcomplete;
+        }
+    }
 
     /* ----------
      * Examine the scan keys to discover where we need to start the scan.
@@ -654,8 +681,14 @@ bool _bt_first(IndexScanDesc scan, ScanDirection dir)
      * the tree.  Walk down that edge to the first or last key, and scan from
      * there.
      */
-    if (keysCount == 0)
-        return _bt_endpoint(scan, dir);
+    if (keysCount == 0) {
+        bool match = _bt_endpoint(scan, dir);
+        if (!match) {
+            /* No match, so mark (parallel) scan finished */
+            _bt_parallel_done(scan);
+        }
+        return match;
+    }
 
     /*
      * We want to start the scan somewhere within the index.  Set up an
@@ -681,8 +714,10 @@ bool _bt_first(IndexScanDesc scan, ScanDirection dir)
              */
             ScanKey subkey = (ScanKey)DatumGetPointer(cur->sk_argument);
             Assert(subkey->sk_flags & SK_ROW_MEMBER);
-            if (subkey->sk_flags & SK_ISNULL)
+            if (subkey->sk_flags & SK_ISNULL) {
+                _bt_parallel_done(scan);
                 return false;
+            }
             scankeys[i] = *subkey;
 
             /*
@@ -892,6 +927,12 @@ bool _bt_first(IndexScanDesc scan, ScanDirection dir)
          * because nothing finer to lock exists.
          */
         PredicateLockRelation(rel, scan->xs_snapshot);
+
+        /*
+         * mark parallel scan as done, so that all the workers can finish
+         * their scan
+         */
+        _bt_parallel_done(scan);
         return false;
     } else
         PredicateLockPage(rel, BufferGetBlockNumber(buf), scan->xs_snapshot);
@@ -946,6 +987,7 @@ bool _bt_first(IndexScanDesc scan, ScanDirection dir)
     /* Drop the lock, but not pin, on the current page */
     LockBuffer(so->currPos.buf, BUFFER_LOCK_UNLOCK);
 
+readcomplete:
     /* OK, itemIndex says what to return */
     currItem = &so->currPos.items[so->currPos.itemIndex];
     scan->xs_ctup.t_self = currItem->heapTid;
@@ -1070,6 +1112,14 @@ static bool _bt_readpage(IndexScanDesc scan, ScanDirection dir, OffsetNumber off
      */
     so->currPos.nextPage = opaque->btpo_next;
 
+    /*
+     * In a parallel scan, hand the right-link to the other participants
+     * before we start checking keys, so that they can read the next page
+     * while we are busy with this one.
+     */
+    if (scan->parallel_scan != NULL && ScanDirectionIsForward(dir))
+        _bt_parallel_release(scan, opaque->btpo_next);
+
     /* initialize tuple workspace to empty */
     so->currPos.nextTupleOffset = 0;
 
@@ -1210,36 +1260,26 @@ static bool _bt_steppage(IndexScanDesc scan, ScanDirection dir)
 
     if (ScanDirectionIsForward(dir)) {
         /* Walk right to the next page with data */
-        /* We must rely on the previously saved nextPage link! */
-        BlockNumber blkno = so->currPos.nextPage;
+        BlockNumber blkno;
 
         /* Remember we left a page with data */
         so->currPos.moreLeft = true;
 
-        for (;;) {
-            /* release the previous buffer */
-            _bt_relbuf(rel, so->currPos.buf);
-            so->currPos.buf = InvalidBuffer;
-            /* if we're at end of scan, give up */
-            if (blkno == P_NONE || !so->currPos.moreRight)
+        /* release the previous buffer */
+        _bt_relbuf(rel, so->currPos.buf);
+        so->currPos.buf = InvalidBuffer;
+
+        if (scan->parallel_scan != NULL) {
+            /* the right-link was handed out in _bt_readpage; get ours */
+            if (!_bt_parallel_seize(scan, &blkno))
                 return false;
-            /* check for interrupts while we're not holding any buffer lock */
-            CHECK_FOR_INTERRUPTS();
-            /* step right one page */
-            so->currPos.buf = _bt_getbuf(rel, blkno, BT_READ);
-            /* check for deleted page */
-            page = BufferGetPage(so->currPos.buf);
-            opaque = (BTPageOpaqueInternal)PageGetSpecialPointer(page);
-            if (!P_IGNORE(opaque)) {
-                PredicateLockPage(rel, blkno, scan->xs_snapshot);
-                /* see if there are any matches on this page */
-                /* note that this will clear moreRight if we can stop */
-                if (_bt_readpage(scan, dir, P_FIRSTDATAKEY(opaque)))
-                    break;
-            }
-            /* nope, keep going */
-            blkno = opaque->btpo_next;
+        } else {
+            /* We must rely on the previously saved nextPage link! */
+            blkno = so->currPos.nextPage;
         }
+
+        if (!_bt_readnextpage(scan, blkno, dir))
+            return false;
     } else {
         /* Remember we left a page with data */
         so->currPos.moreRight = true;
@@ -1286,6 +1326,93 @@ static bool _bt_steppage(IndexScanDesc scan, ScanDirection dir)
     return true;
 }
 
+/*
+ *	_bt_readnextpage() -- Read the next page containing valid data for a
+ *		forward scan, starting at blkno.
+ *
+ * On entry, no buffer is pinned.  On success exit, we hold pin and
+ * read-lock on the next interesting page, and so->currPos is updated to
+ * contain data from that page.  For a parallel scan, every page we move to
+ * past blkno is seized from the shared state first.
+ *
+ * If there are no more matching records, we mark a parallel scan done,
+ * leave so->currPos.buf invalid and return FALSE.
+ */
+static bool _bt_readnextpage(IndexScanDesc scan, BlockNumber blkno, ScanDirection dir)
+{
+    BTScanOpaque so = (BTScanOpaque)scan->opaque;
+    Relation rel = scan->indexRelation;
+    Page page;
+    BTPageOpaqueInternal opaque;
+
+    Assert(ScanDirectionIsForward(dir));
+
+    for (;;) {
+        /* if we're at end of scan, give up */
+        if (blkno == P_NONE || !so->currPos.moreRight) {
+            _bt_parallel_done(scan);
+            return false;
+        }
+        /* check for interrupts while we're not holding any buffer lock */
+        CHECK_FOR_INTERRUPTS();
+        /* step right one page */
+        so->currPos.buf = _bt_getbuf(rel, blkno, BT_READ);
+        /* check for deleted page */
+        page = BufferGetPage(so->currPos.buf);
+        opaque = (BTPageOpaqueInternal)PageGetSpecialPointer(page);
+        if (!P_IGNORE(opaque)) {
+            PredicateLockPage(rel, blkno, scan->xs_snapshot);
+            /* see if there are any matches on this page */
+            /* note that this will clear moreRight if we can stop */
+            if (_bt_readpage(scan, dir, P_FIRSTDATAKEY(opaque)))
+                break;
+        } else if (scan->parallel_scan != NULL) {
+            /* allow next page be processed by parallel worker */
+            _bt_parallel_release(scan, opaque->btpo_next);
+        }
+
+        /* nope, keep going */
+        if (scan->parallel_scan != NULL) {
+            _bt_relbuf(rel, so->currPos.buf);
+            so->currPos.buf = InvalidBuffer;
+            if (!_bt_parallel_seize(scan, &blkno))
+                return false;
+        } else {
+            blkno = opaque->btpo_next;
+            _bt_relbuf(rel, so->currPos.buf);
+            so->currPos.buf = InvalidBuffer;
+        }
+    }
+
+    return true;
+}
+
+/*
+ *	_bt_parallel_readpage() -- Read current page containing valid data for
+ *		scan, when another participant has already seized it for us.
+ *
+ * On success, release lock and maybe pin on buffer.  We return TRUE to
+ * indicate success.
+ */
+static bool _bt_parallel_readpage(IndexScanDesc scan, BlockNumber blkno, ScanDirection dir)
+{
+    BTScanOpaque so = (BTScanOpaque)scan->opaque;
+
+    /* initialize moreLeft/moreRight appropriately for scan direction */
+    so->currPos.moreLeft = false;
+    so->currPos.moreRight = true;
+    so->numKilled = 0;      /* just paranoia */
+    so->markItemIndex = -1; /* ditto */
+
+    if (!_bt_readnextpage(scan, blkno, dir))
+        return false;
+
+    /* Drop the lock, but not pin, on the current page */
+    LockBuffer(so->currPos.buf, BUFFER_LOCK_UNLOCK);
+
+    return true;
+}
+
 /*
  * _bt_walk_left() -- step left one page, if possible
  *
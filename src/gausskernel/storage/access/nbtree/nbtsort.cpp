@@ -55,6 +55,13 @@
  * This code isn't concerned about the FSM at all. The caller is responsible
  * for initializing that.
  *
+ * A build may also be performed in parallel: worker threads (and the leader,
+ * if parallel_leader_participation is on) each scan a portion of the heap
+ * through a parallel heap scan and sort what they found into a run of their
+ * own; the leader then merges those runs while it loads the leaf pages, so
+ * that the page-building part of the build stays serial.  See
+ * _bt_begin_parallel().
+ *
  * Portions Copyright (c) 2020 Huawei Technologies Co.,Ltd.
  * Portions Copyright (c) 1996-2012, PostgreSQL Global Development Group
  * Portions Copyright (c) 1994, Regents of the University of California
@@ -67,15 +74,25 @@
 #include "postgres.h"
 #include "knl/knl_variable.h"
 
+#include "access/heapam.h"
 #include "access/nbtree.h"
+#include "access/parallel.h"
+#include "access/relscan.h"
+#include "access/xact.h"
 #include "access/xlog.h"
 #include "access/xloginsert.h"
+#include "catalog/index.h"
 #include "miscadmin.h"
+#include "pgstat.h"
+#include "storage/condition_variable.h"
 #include "storage/smgr.h"
+#include "storage/spin.h"
 #include "tcop/tcopprot.h"
 #include "utils/aiomem.h"
 #include "utils/rel.h"
 #include "utils/rel_gs.h"
+#include "utils/snapmgr.h"
+#include "utils/tqual.h"
 #include "utils/tuplesort.h"
 #include "commands/tablespace.h"
 #include "access/transam.h"
@@ -92,22 +109,115 @@ struct BTSpool {
     bool isunique;
 };
 
+/*
+ * Status for index builds performed in parallel.  This is allocated in the
+ * memory of the parallel context, and is shared by the leader and all the
+ * worker threads.
+ */
+typedef struct BTShared {
+    /*
+     * These fields are not modified during the sort.  They primarily exist
+     * for the benefit of worker threads, that need to open the relations
+     * and create their own tuplesort states.
+     */
+    Oid heaprelid;
+    Oid indexrelid;
+    bool isunique;
+    bool isconcurrent;
+    int scantuplesortstates; /* number of tuplesort states the leader budgeted for */
+    int sortmem;             /* work memory of each participant's main sort, in KB */
+
+    /*
+     * workersdonecv is used to monitor the progress of workers.  All parallel
+     * participants must indicate that they are done before leader can use
+     * mutable state that workers maintain during scan (and before leader can
+     * proceed to tuplesort_performsort()).
+     */
+    ConditionVariable workersdonecv;
+
+    /*
+     * mutex protects all fields before heapdesc.
+     *
+     * These fields contain status information of interest to B-Tree index
+     * builds that must work just the same when an index is built in parallel.
+     */
+    slock_t mutex;
+
+    /*
+     * Mutable state that is maintained by workers, and reported back to
+     * leader at end of parallel scan.
+     *
+     * nparticipantsdone is number of participants finished.
+     *
+     * reltuples is the total number of input heap tuples.
+     *
+     * havedead indicates if RECENTLY_DEAD tuples were encountered during
+     * build.
+     *
+     * indtuples is the total number of tuples that made it into the index.
+     *
+     * brokenhotchain indicates if any worker detected a broken HOT chain
+     * during build.
+     */
+    int nparticipantsdone;
+    double reltuples;
+    bool havedead;
+    double indtuples;
+    bool brokenhotchain;
+
+    /*
+     * This variable-sized field must come last.
+     *
+     * See _bt_parallel_estimate_shared().
+     */
+    ParallelHeapScanDescData heapdesc;
+} BTShared;
+
+/*
+ * Status for leader in parallel index build.
+ */
+typedef struct BTLeader {
+    /* parallel context itself */
+    ParallelContext* pcxt;
+
+    /*
+     * nparticipanttuplesorts is the exact number of worker threads
+     * successfully launched, plus one leader thread if it participates as a
+     * worker.
+     */
+    int nparticipanttuplesorts;
+
+    /*
+     * Leader thread convenience pointers to shared state (leader avoids
+     * going through the parallel context to get them).
+     */
+    BTShared* btshared;
+    SharedSort* sharedsort;
+    SharedSort* sharedsort2;
+    Snapshot snapshot;
+} BTLeader;
+
 static Page _bt_blnewpage(uint32 level);
 static void _bt_slideleft(Page page);
 static void _bt_sortaddtup(Page page, Size itemsize, IndexTuple itup, OffsetNumber itup_off);
 static void _bt_load(BTWriteState* wstate, BTSpool* btspool, BTSpool* btspool2);
+static Size _bt_parallel_estimate_shared(Snapshot snapshot);
+static void _bt_leader_participate_as_worker(BTBuildState* buildstate, Relation index);
+static void _bt_parallel_scan_and_sort(BTSpool* btspool, BTSpool* btspool2, Relation heapRel, BTShared* btshared,
+    SharedSort* sharedsort, SharedSort* sharedsort2, int sortmem);
 
 /*
  * Interface routines
  *
  * create and initialize a spool structure
  */
-BTSpool* _bt_spoolinit(Relation index, bool isunique, bool isdead, void* meminfo)
+BTSpool* _bt_spoolinit(Relation index, bool isunique, bool isdead, void* meminfo, BTLeader* btleader)
 {
     BTSpool* btspool = (BTSpool*)palloc0(sizeof(BTSpool));
     int btKbytes;
     UtilityDesc* desc = (UtilityDesc*)meminfo;
     int maxKbytes = isdead ? 0 : desc->query_mem[1];
+    SortCoordinate coordinate = NULL;
 
     btspool->index = index;
     btspool->isunique = isunique;
@@ -124,7 +234,18 @@ BTSpool* _bt_spoolinit(Relation index, bool isunique, bool isdead, void* meminfo
         btKbytes = isdead ? SIMPLE_THRESHOLD : desc->query_mem[0];
     else
         btKbytes = isdead ? u_sess->attr.attr_memory.work_mem : u_sess->attr.attr_memory.maintenance_work_mem;
-    btspool->sortstate = tuplesort_begin_index_btree(index, isunique, btKbytes, false, maxKbytes);
+
+    /*
+     * In a parallel build, the leader's tuplesort only merges the runs the
+     * participants produced, so it never spills anything itself.
+     */
+    if (btleader != NULL) {
+        coordinate = (SortCoordinate)palloc0(sizeof(SortCoordinateData));
+        coordinate->isWorker = false;
+        coordinate->nParticipants = btleader->nparticipanttuplesorts;
+        coordinate->sharedsort = isdead ? btleader->sharedsort2 : btleader->sharedsort;
+    }
+    btspool->sortstate = tuplesort_begin_index_btree(index, isunique, btKbytes, false, maxKbytes, coordinate);
 
     /* We seperate 32MB for spool2, so cut this from the estimation */
     if (isdead) {
@@ -916,3 +1037,410 @@ List* insert_ordered_index(List* list, TupleDesc tupdes, ScanKey indexScanKey, i
     return list;
 }
 
+
+/*
+ * Create parallel context, and launch workers for leader.
+ *
+ * buildstate argument should be initialized (with the exception of the
+ * tuplesort state in spools, which may later be created based on shared
+ * state initially set up here).
+ *
+ * request is the target number of parallel worker threads to launch.
+ *
+ * Sets buildstate's BTLeader, which caller must use to shut down parallel
+ * mode by passing it to _bt_end_parallel() at the very end of its index
+ * build.  If not even a single worker thread can be launched, this is
+ * never set, and caller should proceed with a serial index build.
+ */
+void _bt_begin_parallel(BTBuildState* buildstate, Relation index, bool isconcurrent, int request)
+{
+    ParallelContext* pcxt = NULL;
+    int scantuplesortstates;
+    Snapshot snapshot;
+    Size estbtshared;
+    Size estsort;
+    BTShared* btshared = NULL;
+    SharedSort* sharedsort = NULL;
+    SharedSort* sharedsort2 = NULL;
+    BTLeader* btleader = NULL;
+    knl_u_parallel_context* cxt = NULL;
+    MemoryContext oldcontext;
+    bool leaderparticipates = u_sess->attr.attr_sql.parallel_leader_participation;
+
+    Assert(request > 0);
+    Assert(buildstate->btleader == NULL);
+
+    /* The parallel context serializes the active snapshot for the workers */
+    if (!ActiveSnapshotSet()) {
+        return;
+    }
+
+    EnterParallelMode();
+    pcxt = CreateParallelContext("postgres", "_bt_parallel_build_main", request);
+    scantuplesortstates = leaderparticipates ? request + 1 : request;
+
+    /*
+     * Prepare for scan of the base relation.  In a normal index build, we use
+     * SnapshotAny because we must retrieve all tuples and do our own time qual
+     * checks (because we have to index RECENTLY_DEAD tuples).  In a concurrent
+     * build, we take a regular MVCC snapshot and index whatever's live
+     * according to that.
+     */
+    if (!isconcurrent) {
+        snapshot = SnapshotAny;
+    } else {
+        snapshot = RegisterSnapshot(GetTransactionSnapshot());
+    }
+
+    /* Everyone's had a chance to ask for space, so now create the DSM */
+    InitializeParallelDSM(pcxt, isconcurrent ? snapshot : GetActiveSnapshot());
+
+    /* If no DSM segment was available, back out (do serial build) */
+    if (pcxt->nworkers == 0) {
+        if (IsMVCCSnapshot(snapshot)) {
+            UnregisterSnapshot(snapshot);
+        }
+        DestroyParallelContext(pcxt);
+        ExitParallelMode();
+        return;
+    }
+
+    cxt = (knl_u_parallel_context*)pcxt->seg;
+    oldcontext = MemoryContextSwitchTo(cxt->memCtx);
+
+    /* Store shared build state, for which we reserved space */
+    estbtshared = _bt_parallel_estimate_shared(snapshot);
+    btshared = (BTShared*)palloc0(estbtshared);
+    btshared->heaprelid = RelationGetRelid(buildstate->heapRel);
+    btshared->indexrelid = RelationGetRelid(index);
+    btshared->isunique = buildstate->isUnique;
+    btshared->isconcurrent = isconcurrent;
+    btshared->scantuplesortstates = scantuplesortstates;
+    btshared->sortmem = u_sess->attr.attr_memory.maintenance_work_mem / scantuplesortstates;
+    ConditionVariableInit(&btshared->workersdonecv);
+    SpinLockInit(&btshared->mutex);
+    /* Initialize mutable state */
+    btshared->nparticipantsdone = 0;
+    btshared->reltuples = 0.0;
+    btshared->havedead = false;
+    btshared->indtuples = 0.0;
+    btshared->brokenhotchain = false;
+    heap_parallelscan_initialize(&btshared->heapdesc, estbtshared - offsetof(BTShared, heapdesc),
+        buildstate->heapRel, snapshot);
+
+    /*
+     * Store shared tuplesort-private state, for which we reserved space.
+     * Then, initialize opaque state using tuplesort routine.
+     */
+    estsort = tuplesort_estimate_shared(scantuplesortstates);
+    sharedsort = (SharedSort*)palloc0(estsort);
+    tuplesort_initialize_shared(sharedsort, scantuplesortstates, pcxt->seg);
+
+    /* Unique case requires a second spool, and associated shared state */
+    if (btshared->isunique) {
+        sharedsort2 = (SharedSort*)palloc0(estsort);
+        tuplesort_initialize_shared(sharedsort2, scantuplesortstates, pcxt->seg);
+    }
+
+    /* Store query string for workers */
+    if (t_thrd.postgres_cxt.debug_query_string != NULL) {
+        cxt->pwCtx->btreeInfo.queryText = pstrdup(t_thrd.postgres_cxt.debug_query_string);
+    } else {
+        cxt->pwCtx->btreeInfo.queryText = NULL;
+    }
+    cxt->pwCtx->btreeInfo.btShared = btshared;
+    cxt->pwCtx->btreeInfo.sharedSort = sharedsort;
+    cxt->pwCtx->btreeInfo.sharedSort2 = sharedsort2;
+
+    (void)MemoryContextSwitchTo(oldcontext);
+
+    /* Launch workers, saving status for leader/caller */
+    LaunchParallelWorkers(pcxt);
+    btleader = (BTLeader*)palloc0(sizeof(BTLeader));
+    btleader->pcxt = pcxt;
+    btleader->nparticipanttuplesorts = pcxt->nworkers_launched;
+    if (leaderparticipates) {
+        btleader->nparticipanttuplesorts++;
+    }
+    btleader->btshared = btshared;
+    btleader->sharedsort = sharedsort;
+    btleader->sharedsort2 = sharedsort2;
+    btleader->snapshot = snapshot;
+
+    /* If no workers were successfully launched, back out (do serial build) */
+    if (pcxt->nworkers_launched == 0) {
+        _bt_end_parallel(btleader);
+        return;
+    }
+
+    /* Save leader state now that it's clear build will be parallel */
+    buildstate->btleader = btleader;
+
+    /* Join heap scan ourselves */
+    if (leaderparticipates) {
+        _bt_leader_participate_as_worker(buildstate, index);
+    }
+
+    /*
+     * Caller needs to wait for all launched workers when we return.  Make
+     * sure that the failure-to-start case will not hang forever.
+     */
+    WaitForParallelWorkersToAttach(pcxt);
+}
+
+/*
+ * Shut down workers, destroy parallel context, and end parallel mode.
+ */
+void _bt_end_parallel(BTLeader* btleader)
+{
+    /* Shutdown worker threads */
+    WaitForParallelWorkersToFinish(btleader->pcxt);
+    /* Free last reference to MVCC snapshot, if one was used */
+    if (IsMVCCSnapshot(btleader->snapshot)) {
+        UnregisterSnapshot(btleader->snapshot);
+    }
+    DestroyParallelContext(btleader->pcxt);
+    ExitParallelMode();
+}
+
+/*
+ * Returns size of shared memory required to store state for a parallel
+ * btree index build based on the snapshot its parallel scan will use.
+ */
+static Size _bt_parallel_estimate_shared(Snapshot snapshot)
+{
+    return add_size(offsetof(BTShared, heapdesc), heap_parallelscan_estimate(snapshot));
+}
+
+/*
+ * Within leader, wait for end of heap scan.
+ *
+ * When called, parallel heap scan started by _bt_begin_parallel() will
+ * already be underway within worker threads (when leader participates
+ * as a worker, we should end up here just as workers are finishing).
+ *
+ * Fills in fields needed for ambuild statistics, and lets caller set
+ * field indicating that some worker encountered a broken HOT chain.
+ *
+ * Returns the total number of heap tuples scanned.
+ */
+double _bt_parallel_heapscan(BTBuildState* buildstate, bool* brokenhotchain)
+{
+    BTShared* btshared = buildstate->btleader->btshared;
+    int nparticipanttuplesorts;
+    double reltuples;
+
+    nparticipanttuplesorts = buildstate->btleader->nparticipanttuplesorts;
+    for (;;) {
+        SpinLockAcquire(&btshared->mutex);
+        if (btshared->nparticipantsdone == nparticipanttuplesorts) {
+            buildstate->haveDead = btshared->havedead;
+            buildstate->indtuples = btshared->indtuples;
+            *brokenhotchain = btshared->brokenhotchain;
+            reltuples = btshared->reltuples;
+            SpinLockRelease(&btshared->mutex);
+            break;
+        }
+        SpinLockRelease(&btshared->mutex);
+
+        ConditionVariableSleep(&btshared->workersdonecv);
+    }
+
+    ConditionVariableCancelSleep();
+
+    return reltuples;
+}
+
+/*
+ * Within leader, participate as a parallel worker.
+ */
+static void _bt_leader_participate_as_worker(BTBuildState* buildstate, Relation index)
+{
+    BTLeader* btleader = buildstate->btleader;
+    BTSpool* leaderworker = NULL;
+    BTSpool* leaderworker2 = NULL;
+
+    /* Allocate memory and initialize private spool */
+    leaderworker = (BTSpool*)palloc0(sizeof(BTSpool));
+    leaderworker->index = index;
+    leaderworker->isunique = btleader->btshared->isunique;
+
+    /* Initialize second spool, if required */
+    if (btleader->btshared->isunique) {
+        /* Allocate memory for worker's own private secondary spool */
+        leaderworker2 = (BTSpool*)palloc0(sizeof(BTSpool));
+
+        /* Initialize worker's own secondary spool */
+        leaderworker2->index = leaderworker->index;
+        leaderworker2->isunique = false;
+    }
+
+    /* Perform work common to all participants */
+    _bt_parallel_scan_and_sort(leaderworker, leaderworker2, buildstate->heapRel, btleader->btshared,
+        btleader->sharedsort, btleader->sharedsort2, btleader->btshared->sortmem);
+
+    pfree(leaderworker);
+    if (leaderworker2 != NULL) {
+        pfree(leaderworker2);
+    }
+}
+
+/*
+ * Perform work within a launched parallel thread.
+ */
+void _bt_parallel_build_main(void* seg)
+{
+    knl_u_parallel_context* cxt = (knl_u_parallel_context*)seg;
+    BTSpool* btspool = NULL;
+    BTSpool* btspool2 = NULL;
+    BTShared* btshared = NULL;
+    SharedSort* sharedsort = NULL;
+    SharedSort* sharedsort2 = NULL;
+    Relation heapRel;
+    Relation indexRel;
+
+    /* Set debug_query_string for individual workers first */
+    t_thrd.postgres_cxt.debug_query_string = cxt->pwCtx->btreeInfo.queryText;
+
+    /* Report the query string from leader */
+    pgstat_report_activity(STATE_RUNNING, t_thrd.postgres_cxt.debug_query_string);
+
+    /* Look up shared state */
+    btshared = cxt->pwCtx->btreeInfo.btShared;
+    sharedsort = cxt->pwCtx->btreeInfo.sharedSort;
+    sharedsort2 = cxt->pwCtx->btreeInfo.sharedSort2;
+
+    /*
+     * Open relations.  The leader holds the locks the build needs on both
+     * of them until the workers have finished, so there is nothing to lock
+     * here.
+     */
+    heapRel = heap_open(btshared->heaprelid, NoLock);
+    indexRel = index_open(btshared->indexrelid, NoLock);
+
+    /* Initialize worker's own spool */
+    btspool = (BTSpool*)palloc0(sizeof(BTSpool));
+    btspool->index = indexRel;
+    btspool->isunique = btshared->isunique;
+
+    if (btshared->isunique) {
+        /* Allocate memory for worker's own private secondary spool */
+        btspool2 = (BTSpool*)palloc0(sizeof(BTSpool));
+
+        /* Initialize worker's own secondary spool */
+        btspool2->index = btspool->index;
+        btspool2->isunique = false;
+    }
+
+    /* Perform sorting of spool, and possibly a spool2 */
+    _bt_parallel_scan_and_sort(btspool, btspool2, heapRel, btshared, sharedsort, sharedsort2, btshared->sortmem);
+
+    index_close(indexRel, NoLock);
+    heap_close(heapRel, NoLock);
+}
+
+/*
+ * Perform a worker's portion of a parallel sort.
+ *
+ * This generates a tuplesort for passed btspool, and a second tuplesort
+ * state if a second btspool is need (i.e. for unique index builds).  All
+ * other spool fields should already be set when this is called.
+ *
+ * sortmem is the amount of working memory to use within each worker,
+ * expressed in KBs.
+ *
+ * When this returns, workers are done, and need only release resources.
+ */
+static void _bt_parallel_scan_and_sort(BTSpool* btspool, BTSpool* btspool2, Relation heapRel, BTShared* btshared,
+    SharedSort* sharedsort, SharedSort* sharedsort2, int sortmem)
+{
+    SortCoordinate coordinate;
+    BTBuildState buildstate;
+    HeapScanDesc scan;
+    double reltuples;
+    IndexInfo* indexInfo = NULL;
+
+    /* Initialize local tuplesort coordination state */
+    coordinate = (SortCoordinate)palloc0(sizeof(SortCoordinateData));
+    coordinate->isWorker = true;
+    coordinate->nParticipants = -1;
+    coordinate->sharedsort = sharedsort;
+
+    /* Begin "partial" tuplesort */
+    btspool->sortstate = tuplesort_begin_index_btree(btspool->index, btspool->isunique, sortmem, false, 0,
+        coordinate);
+
+    /*
+     * Just as with serial case, there may be a second spool.  If so, a
+     * second, dedicated spool2 partial tuplesort is required.
+     */
+    if (btspool2 != NULL) {
+        SortCoordinate coordinate2;
+
+        /*
+         * We expect that the second one (for dead tuples) won't get very
+         * full, so we give it only work_mem (unless sortmem is less for
+         * worker).  Worker threads are generally permitted to allocate
+         * work_mem independently.
+         */
+        coordinate2 = (SortCoordinate)palloc0(sizeof(SortCoordinateData));
+        coordinate2->isWorker = true;
+        coordinate2->nParticipants = -1;
+        coordinate2->sharedsort = sharedsort2;
+        btspool2->sortstate = tuplesort_begin_index_btree(btspool->index, false,
+            Min(sortmem, u_sess->attr.attr_memory.work_mem), false, 0, coordinate2);
+    }
+
+    /* Fill in buildstate for btbuildCallback() */
+    buildstate.isUnique = btshared->isunique;
+    buildstate.haveDead = false;
+    buildstate.heapRel = heapRel;
+    buildstate.spool = btspool;
+    buildstate.spool2 = btspool2;
+    buildstate.indtuples = 0;
+    buildstate.btleader = NULL;
+
+    /* Join parallel scan */
+    indexInfo = BuildIndexInfo(btspool->index);
+    indexInfo->ii_Concurrent = btshared->isconcurrent;
+    scan = heap_beginscan_parallel(heapRel, &btshared->heapdesc);
+    reltuples = IndexBuildHeapScan(heapRel, btspool->index, indexInfo, true, btbuildCallback, (void*)&buildstate,
+        scan);
+
+    /*
+     * Execute this worker's part of the sort.
+     *
+     * Unlike leader and serial cases, we cannot avoid calling
+     * tuplesort_performsort() for spool2 if it ends up containing no dead
+     * tuples (this is disallowed for workers by tuplesort).
+     */
+    tuplesort_performsort(btspool->sortstate);
+    if (btspool2 != NULL) {
+        tuplesort_performsort(btspool2->sortstate);
+    }
+
+    /*
+     * Done.  Record ambuild statistics, and whether we encountered a broken
+     * HOT chain.
+     */
+    SpinLockAcquire(&btshared->mutex);
+    btshared->nparticipantsdone++;
+    btshared->reltuples += reltuples;
+    if (buildstate.haveDead) {
+        btshared->havedead = true;
+    }
+    btshared->indtuples += buildstate.indtuples;
+    if (indexInfo->ii_BrokenHotChain) {
+        btshared->brokenhotchain = true;
+    }
+    SpinLockRelease(&btshared->mutex);
+
+    /* Notify leader */
+    ConditionVariableSignal(&btshared->workersdonecv);
+
+    /* We can end tuplesorts immediately */
+    tuplesort_end(btspool->sortstate);
+    if (btspool2 != NULL) {
+        tuplesort_end(btspool2->sortstate);
+    }
+}
@@ -65,6 +65,9 @@ static const struct {
 }   InternalParallelWorkers[] = {
     {
         "ParallelQueryMain", ParallelQueryMain
+    },
+    {
+        "_bt_parallel_build_main", _bt_parallel_build_main
     }
 };
 
@@ -7,10 +7,13 @@
  * buffers.  Under ordinary circumstances we expect that write
  * traffic will occur mostly to the latest page (and to the just-prior
  * page, soon after a page transition).  Read traffic will probably touch
- * a larger span of pages, but in any case a fairly small number of page
- * buffers should be sufficient.  So, we just search the buffers using plain
- * linear search; there's no need for a hashtable or anything fancy.
- * The management algorithm is straight LRU except that we will never swap
+ * a larger span of pages, and workloads with long-running transactions
+ * want many page buffers to keep old status pages around.  So the buffers
+ * are divided into banks of about SLRU_BANK_SIZE slots, and a page can only
+ * be held by the bank its page number hashes to.  Finding a page or a victim
+ * slot is then a plain linear search of one bank, whose length doesn't depend
+ * on the number of buffers.  Each bank has its own LRU clock, and the management
+ * algorithm is straight LRU within the bank except that we will never swap
  * out the latest page (since we know it's going to be hit again eventually).
  *
  * We use a control LWLock to protect the shared data structures, plus
@@ -81,18 +84,35 @@ typedef struct SlruFlushData {
 typedef struct SlruFlushData* SlruFlush;
 
 /*
- * Macro to mark a buffer slot "most recently used".  Note multiple evaluation
- * of arguments!
+ * The bank a page must be held by.  The page number is hashed first: CLOG and
+ * CSNLOG spread their pages over partitions by page number modulo the number
+ * of partitions, so within one partition a plain modulo by the number of banks
+ * would put every page in the same bank.
+ */
+#define SlruBankOf(shared, pageno) \
+    ((int)((((uint64)(pageno) * UINT64CONST(0x9E3779B97F4A7C15)) >> 32) % (uint64)(shared)->num_banks))
+
+/* The first slot of a bank; passing num_banks gives the end of the last bank */
+#define SlruBankStart(shared, bankno) ((int)((int64)(bankno) * (shared)->num_slots / (shared)->num_banks))
+
+/* Whether a slot belongs to the bank a page must be held by */
+#define SlruSlotInPageBank(shared, slotno, pageno)                      \
+    ((slotno) >= SlruBankStart(shared, SlruBankOf(shared, pageno)) && \
+        (slotno) < SlruBankStart(shared, SlruBankOf(shared, pageno) + 1))
+
+/*
+ * Macro to mark a buffer slot "most recently used" on its bank's LRU clock.
+ * Note multiple evaluation of arguments!
  *
  * The reason for the if-test is that there are often many consecutive
  * accesses to the same page (particularly the latest page).  By suppressing
- * useless increments of cur_lru_count, we reduce the probability that old
+ * useless increments of the bank's clock, we reduce the probability that old
  * pages' counts will "wrap around" and make them appear recently used.
  *
  * We allow this code to be executed concurrently by multiple processes within
  * SimpleLruReadPage_ReadOnly().  As long as int reads and writes are atomic,
  * this should not cause any completely-bogus values to enter the computation.
- * However, it is possible for either cur_lru_count or individual
+ * However, it is possible for either bank_cur_lru_count or individual
  * page_lru_count entries to be "reset" to lower values than they should have,
  * in case a process is delayed while it executes this macro.  With care in
  * SlruSelectLRUPage(), this does little harm, and in any case the absolute
@@ -100,9 +120,11 @@ typedef struct SlruFlushData* SlruFlush;
  * gain from allowing concurrent reads of SLRU pages seems worth it.
  */
 #define SlruRecentlyUsed(shared, slotno) do { \
-    int new_lru_count = (shared)->cur_lru_count;             \
+    int* bank_lru_count =                                    \
+        &(shared)->bank_cur_lru_count[SlruBankOf(shared, (shared)->page_number[slotno])]; \
+    int new_lru_count = *bank_lru_count;                     \
     if (new_lru_count != (shared)->page_lru_count[slotno]) { \
-        (shared)->cur_lru_count = ++new_lru_count;           \
+        *bank_lru_count = ++new_lru_count;                   \
         (shared)->page_lru_count[slotno] = new_lru_count;    \
     }                                                        \
 } while (0)
@@ -117,10 +139,12 @@ static int SlruSelectLRUPage(SlruCtl ctl, int64 pageno);
 static inline int execSimpleLruReadPageReadOnly(SlruCtl ctl, int64 pageno, TransactionId xid)
 {
     SlruShared shared = ctl->shared;
+    int bankno = SlruBankOf(shared, pageno);
+    int bankend = SlruBankStart(shared, bankno + 1);
     int slotno;
 
     /* See if page is already in a buffer */
-    for (slotno = 0; slotno < shared->num_slots; slotno++) {
+    for (slotno = SlruBankStart(shared, bankno); slotno < bankend; slotno++) {
         if (shared->page_number[slotno] == pageno && shared->page_status[slotno] != SLRU_PAGE_EMPTY &&
             shared->page_status[slotno] != SLRU_PAGE_READ_IN_PROGRESS) {
             /* See comments for SlruRecentlyUsed macro */
@@ -134,6 +158,12 @@ static inline int execSimpleLruReadPageReadOnly(SlruCtl ctl, int64 pageno, Trans
     return SimpleLruReadPage(ctl, pageno, true, xid);
 }
 
+/* Number of banks for nslots buffers, each bank gets at least SLRU_BANK_SIZE slots */
+static inline int SlruNumBanks(int nslots)
+{
+    return Max(1, nslots / SLRU_BANK_SIZE);
+}
+
 /* Initialization of shared memory */
 Size SimpleLruShmemSize(int nslots, int nlsns)
 {
@@ -141,12 +171,13 @@ Size SimpleLruShmemSize(int nslots, int nlsns)
 
     /* we assume nslots isn't so large as to risk overflow */
     sz = MAXALIGN(sizeof(SlruSharedData));
-    sz += MAXALIGN(nslots * sizeof(char*));          /* page_buffer[] */
-    sz += MAXALIGN(nslots * sizeof(SlruPageStatus)); /* page_status[] */
-    sz += MAXALIGN(nslots * sizeof(bool));           /* page_dirty[] */
-    sz += MAXALIGN(nslots * sizeof(int64));          /* page_number[] */
-    sz += MAXALIGN(nslots * sizeof(int));            /* page_lru_count[] */
-    sz += MAXALIGN(nslots * sizeof(LWLock*));        /* buffer_locks[] */
+    sz += MAXALIGN(nslots * sizeof(char*));             /* page_buffer[] */
+    sz += MAXALIGN(nslots * sizeof(SlruPageStatus));    /* page_status[] */
+    sz += MAXALIGN(nslots * sizeof(bool));              /* page_dirty[] */
+    sz += MAXALIGN(nslots * sizeof(int64));             /* page_number[] */
+    sz += MAXALIGN(nslots * sizeof(int));               /* page_lru_count[] */
+    sz += MAXALIGN(nslots * sizeof(LWLock*));           /* buffer_locks[] */
+    sz += MAXALIGN(SlruNumBanks(nslots) * sizeof(int)); /* bank_cur_lru_count[] */
 
     if (nlsns > 0)
         sz += MAXALIGN(nslots * nlsns * sizeof(XLogRecPtr)); /* group_lsn[] */
@@ -176,8 +207,8 @@ void SimpleLruInit(
 
         shared->control_lock = ctllock;
         shared->num_slots = nslots;
+        shared->num_banks = SlruNumBanks(nslots);
         shared->lsn_groups_per_page = nlsns;
-        shared->cur_lru_count = 0;
         shared->force_check_first_xid = false;
 
         /* shared->latest_page_number will be set later */
@@ -195,6 +226,8 @@ void SimpleLruInit(
         offset += MAXALIGN(nslots * sizeof(int));
         shared->buffer_locks = (LWLock**)(ptr + offset);
         offset += MAXALIGN(nslots * sizeof(LWLock*));
+        shared->bank_cur_lru_count = (int*)(ptr + offset);
+        offset += MAXALIGN(shared->num_banks * sizeof(int));
 
         if (nlsns > 0) {
             shared->group_lsn = (XLogRecPtr*)(ptr + offset);
@@ -211,6 +244,10 @@ void SimpleLruInit(
             shared->buffer_locks[slotno] = LWLockAssign(trancheId);
             ptr += BLCKSZ;
         }
+
+        for (int bankno = 0; bankno < shared->num_banks; bankno++) {
+            shared->bank_cur_lru_count[bankno] = 0;
+        }
     } else
         Assert(found);
 
@@ -394,6 +431,7 @@ int SimpleLruReadPage(SlruCtl ctl, int64 pageno, bool write_ok, TransactionId xi
 
         /* See if page already is in memory; if not, pick victim slot */
         slotno = SlruSelectLRUPage(ctl, pageno);
+        Assert(SlruSlotInPageBank(shared, slotno, pageno));
         /* Did we find the page in memory? */
         if (shared->page_number[slotno] == pageno && shared->page_status[slotno] != SLRU_PAGE_EMPTY) {
             /*
@@ -940,7 +978,8 @@ static void SlruReportIOError(SlruCtl ctl, int64 pageno, TransactionId xid)
 }
 
 /*
- * Select the slot to re-use when we need a free slot.
+ * Select the slot to re-use when we need a free slot.  Only the slots of the
+ * bank the page belongs to are considered.
  *
  * The target page number is passed because we need to consider the
  * possibility that some other process reads in the target page while
@@ -955,6 +994,9 @@ static void SlruReportIOError(SlruCtl ctl, int64 pageno, TransactionId xid)
 static int SlruSelectLRUPage(SlruCtl ctl, int64 pageno)
 {
     SlruShared shared = ctl->shared;
+    int bankno = SlruBankOf(shared, pageno);
+    int bankstart = SlruBankStart(shared, bankno);
+    int bankend = SlruBankStart(shared, bankno + 1);
 
     /* Outer loop handles restart after I/O */
     for (;;) {
@@ -968,7 +1010,7 @@ static int SlruSelectLRUPage(SlruCtl ctl, int64 pageno)
         int64 best_invalid_page_number = 0; /* keep compiler quiet */
 
         /* See if page already has a buffer assigned */
-        for (slotno = 0; slotno < shared->num_slots; slotno++) {
+        for (slotno = bankstart; slotno < bankend; slotno++) {
             if (shared->page_number[slotno] == pageno && shared->page_status[slotno] != SLRU_PAGE_EMPTY)
                 return slotno;
         }
@@ -992,16 +1034,16 @@ static int SlruSelectLRUPage(SlruCtl ctl, int64 pageno)
          * acquire the same lru_count values.  In that case we break ties by
          * choosing the furthest-back page.
          *
-         * Notice that this next line forcibly advances cur_lru_count to a
-         * value that is certainly beyond any value that will be in the
-         * page_lru_count array after the loop finishes.  This ensures that
-         * the next execution of SlruRecentlyUsed will mark the page newly
-         * used, even if it's for a page that has the current counter value.
-         * That gets us back on the path to having good data when there are
-         * multiple pages with the same lru_count.
+         * Notice that this next line forcibly advances the bank's LRU clock
+         * to a value that is certainly beyond any value that will be in the
+         * bank's page_lru_count entries after the loop finishes.  This
+         * ensures that the next execution of SlruRecentlyUsed will mark the
+         * page newly used, even if it's for a page that has the current
+         * counter value.  That gets us back on the path to having good data
+         * when there are multiple pages with the same lru_count.
          */
-        cur_count = (shared->cur_lru_count)++;
-        for (slotno = 0; slotno < shared->num_slots; slotno++) {
+        cur_count = (shared->bank_cur_lru_count[bankno])++;
+        for (slotno = bankstart; slotno < bankend; slotno++) {
             int this_delta;
             int64 this_page_number;
 
@@ -67,6 +67,7 @@
 #include "replication/dataqueue.h"
 #include "replication/walsender.h"
 #include "replication/syncrep.h"
+#include "storage/condition_variable.h"
 #include "storage/lmgr.h"
 #include "storage/predicate.h"
 #include "storage/procarray.h"
@@ -3658,6 +3659,9 @@ static void AbortTransaction(bool PerfectRollback, bool stpRollback)
      */
     LWLockReleaseAll();
 
+    /* Cancel condition variable sleep */
+    ConditionVariableCancelSleep();
+
     RESUME_INTERRUPTS();
 
     /* Clean node group status cache */
@@ -6282,6 +6286,9 @@ static void AbortSubTransaction(bool stpRollback)
      */
     LWLockReleaseAll();
 
+    /* Cancel condition variable sleep */
+    ConditionVariableCancelSleep();
+
     /* Clear wait information */
     pgstat_report_waitevent(WAIT_EVENT_END);
 
@@ -794,6 +794,78 @@ void PageRangePrefetch(
     return;
 }
 
+/* a page read that waits longer than this did not find its page prefetched in time */
+#define PREFETCH_STALL_USEC 50
+/* distance an adaptive scan starts from, unless its maximum is smaller */
+#define PREFETCH_MIN_DISTANCE 16
+
+/*
+ * @Description: init the adaptive read-ahead distance of a scan
+ * @Param[IN] pd: distance to init
+ * @Param[IN] max_distance: the largest distance the scan may use, in pages
+ * @See also: PrefetchDistanceReadDone
+ */
+void PrefetchDistanceInit(PrefetchDistance* pd, int max_distance)
+{
+    pd->max_distance = Max(max_distance, 1);
+    pd->min_distance = Min(PREFETCH_MIN_DISTANCE, pd->max_distance);
+    pd->distance = pd->min_distance;
+    pd->window_pages = 0;
+    pd->window_stalls = 0;
+    pd->avg_wait_us = 0;
+    INSTR_TIME_SET_ZERO(pd->read_start);
+}
+
+void PrefetchDistanceReadStart(PrefetchDistance* pd)
+{
+    INSTR_TIME_SET_CURRENT(pd->read_start);
+}
+
+/*
+ * @Description: account the page read timed since PrefetchDistanceReadStart,
+ * and adjust the distance once per window of `distance' pages.  If more than
+ * one read in eight of the window had to wait for the device, the prefetcher
+ * is not far enough ahead of the scan and the distance doubles.  If none had
+ * to, it shrinks by a quarter, so a scan that keeps up does not hold more
+ * buffers in flight than it needs.
+ * @Param[IN] pd: distance of the scan
+ */
+void PrefetchDistanceReadDone(PrefetchDistance* pd)
+{
+    instr_time wait;
+    uint64 wait_us;
+
+    INSTR_TIME_SET_CURRENT(wait);
+    INSTR_TIME_SUBTRACT(wait, pd->read_start);
+    wait_us = INSTR_TIME_GET_MICROSEC(wait);
+
+    pd->avg_wait_us = (pd->avg_wait_us * 7 + wait_us) / 8;
+    pd->window_pages++;
+    if (wait_us > PREFETCH_STALL_USEC) {
+        pd->window_stalls++;
+    }
+
+    if (pd->window_pages < pd->distance) {
+        return;
+    }
+
+    int old_distance = pd->distance;
+    if (pd->window_stalls * 8 > pd->window_pages) {
+        pd->distance = Min(pd->distance * 2, pd->max_distance);
+    } else if (pd->window_stalls == 0) {
+        pd->distance = Max(pd->distance - pd->distance / 4, pd->min_distance);
+    }
+    pd->window_pages = 0;
+    pd->window_stalls = 0;
+
+    if (pd->distance != old_distance) {
+        ereport(DEBUG1,
+            (errmodule(MOD_ADIO),
+                errmsg("prefetch distance %d -> %d, average read wait %lu us",
+                    old_distance, pd->distance, pd->avg_wait_us)));
+    }
+}
+
 /*
  * @Description: PageListPrefetch
  * The dispatch list of AioDispatchDesc_t structures is released
@@ -25,30 +25,59 @@
 #include "postmaster/pagewriter.h"
 #include "postmaster/postmaster.h"
 #include "access/double_write.h"
+#include "threadpool/threadpool.h"
 #include "gstrace/gstrace_infra.h"
 #include "gstrace/storage_gstrace.h"
 
 #define INT_ACCESS_ONCE(var) ((int)(*((volatile int*)&(var))))
 
 /*
- * The shared freelist control information.
+ * The clock sweep is split into partitions, each owning a contiguous range of
+ * buffer ids with its own clock hand on its own cache line.  A backend sweeps
+ * its home partition first and only falls back to the other partitions when
+ * its own one has nothing to give.  Partitions only spread the backends over
+ * several hands; they are ranges of buffer ids, not of NUMA-local memory.
+ * When the bgwriter threads maintain candidate lists, partition i covers
+ * exactly the buffers of bgwriter i, so that the candidate list of the home
+ * partition is tried first as well.
  */
-typedef struct BufferStrategyControl {
-    /* Spinlock: protects the values below */
-    slock_t buffer_strategy_lock;
+#define STRATEGY_MAX_PARTITIONS 16
+#define STRATEGY_MIN_PARTITION_BUFFERS 16384
 
+typedef struct BufferStrategyPartition {
     /*
-     * Clock sweep hand: index of next buffer to consider grabbing. Note that
-     * this isn't a concrete buffer - we only ever increase the value. So, to
-     * get an actual buffer, it needs to be used modulo NBuffers.
+     * Clock sweep hand of this partition, relative to buf_id_start.  Like the
+     * old global hand we only ever increase it, so it needs to be used modulo
+     * the number of buffers the partition may use.
      */
     pg_atomic_uint32 nextVictimBuffer;
+    uint32 completePasses; /* Complete cycles of this partition's sweep */
+
+    int buf_id_start; /* first buffer id of the partition */
+    int num_buffers;  /* number of buffers in the partition */
+
+    /* Statistics, see StrategyGetPartitionStats() */
+    pg_atomic_uint64 numCandidateAllocs; /* victims popped from the candidate list */
+    pg_atomic_uint64 numSweepAllocs;     /* victims found by the clock sweep */
+    pg_atomic_uint64 numStolenAllocs;    /* victims taken by backends homed elsewhere */
+} BufferStrategyPartition;
+
+typedef union BufferStrategyPartitionPadded {
+    BufferStrategyPartition part;
+    char pad[PG_CACHE_LINE_SIZE];
+} BufferStrategyPartitionPadded;
+
+/*
+ * The shared freelist control information.
+ */
+typedef struct BufferStrategyControl {
+    /* Spinlock: protects the values below, and the pass counts of the partitions */
+    slock_t buffer_strategy_lock;
 
     /*
      * Statistics.	These counters should be wide enough that they can't
      * overflow during a single bgwriter cycle.
      */
-    uint32 completePasses;            /* Complete cycles of the clock sweep */
     pg_atomic_uint32 numBufferAllocs; /* Buffers allocated since last reset */
 
     /*
@@ -56,6 +85,12 @@ typedef struct BufferStrategyControl {
      * StrategyNotifyBgWriter.
      */
     int bgwprocno;
+
+    /* Seed of the home partition of threads that are not thread pool workers */
+    pg_atomic_uint32 nextHomePartition;
+
+    int num_partitions;
+    BufferStrategyPartitionPadded* partitions;
 } BufferStrategyControl;
 
 typedef struct
@@ -98,13 +133,98 @@ static void perform_delay(StrategyDelayStatus *status)
     return;
 }
 
+/*
+ * StrategyNumPartitions - number of clock sweep partitions
+ *
+ * One per bgwriter thread when they maintain candidate lists, so that the
+ * partitions line up with the candidate lists, otherwise one per
+ * STRATEGY_MIN_PARTITION_BUFFERS buffers, capped at STRATEGY_MAX_PARTITIONS.
+ * Without incremental checkpoint the bgwriter paces its LRU scan on the
+ * position of the clock hand, see BgBufferSync(), and a single linear scan
+ * cannot keep ahead of several hands, so there the clock is not partitioned.
+ */
+static int StrategyNumPartitions(void)
+{
+    if (!g_instance.attr.attr_storage.enableIncrementalCheckpoint) {
+        return 1;
+    }
+    if (g_instance.attr.attr_storage.bgwriter_thread_num > 0) {
+        return g_instance.attr.attr_storage.bgwriter_thread_num;
+    }
+
+    int num = g_instance.attr.attr_storage.NBuffers / STRATEGY_MIN_PARTITION_BUFFERS;
+    return Max(1, Min(num, STRATEGY_MAX_PARTITIONS));
+}
+
+/*
+ * StrategyHomePartition - the partition this thread evicts from first
+ *
+ * Thread pool workers share the home partition of their group, which spreads
+ * the groups over the hands.  Any other thread gets one round robin on its
+ * first allocation.
+ */
+static inline int StrategyHomePartition(void)
+{
+    BufferStrategyControl* ctl = t_thrd.storage_cxt.StrategyControl;
+
+    if (t_thrd.storage_cxt.StrategyHomePartition < 0) {
+        uint32 seed;
+
+        if (t_thrd.threadpool_cxt.worker != NULL && t_thrd.threadpool_cxt.worker->GetGroup() != NULL) {
+            seed = (uint32)t_thrd.threadpool_cxt.worker->GetGroup()->GetGroupId();
+        } else {
+            seed = pg_atomic_fetch_add_u32(&ctl->nextHomePartition, 1);
+        }
+        t_thrd.storage_cxt.StrategyHomePartition = (int)(seed % (uint32)ctl->num_partitions);
+    }
+
+    return t_thrd.storage_cxt.StrategyHomePartition;
+}
+
+/*
+ * Number of buffers of the partition the clock sweep may use.  A standby
+ * restricts each partition to shared_buffers_fraction of it, the same way
+ * the bgwriter restricts its candidate scan.
+ */
+static inline int StrategyPartitionUsable(BufferStrategyPartition* part, bool am_standby)
+{
+    if (!am_standby) {
+        return part->num_buffers;
+    }
+    return Max(1, (int)(part->num_buffers * u_sess->attr.attr_storage.shared_buffers_fraction));
+}
+
+/* the partition holding buf_id, which StrategyInitialize() lays out in equal ranges but the last */
+static inline int StrategyPartitionOf(int buf_id)
+{
+    BufferStrategyControl* ctl = t_thrd.storage_cxt.StrategyControl;
+    int part_id = buf_id / Max(1, ctl->partitions[0].part.num_buffers);
+
+    return Min(part_id, ctl->num_partitions - 1);
+}
+
+static inline void StrategyCountAlloc(int part_id, bool from_candidate)
+{
+    BufferStrategyPartition* part = &t_thrd.storage_cxt.StrategyControl->partitions[part_id].part;
+
+    if (from_candidate) {
+        (void)pg_atomic_fetch_add_u64(&part->numCandidateAllocs, 1);
+    } else {
+        (void)pg_atomic_fetch_add_u64(&part->numSweepAllocs, 1);
+    }
+    if (part_id != StrategyHomePartition()) {
+        (void)pg_atomic_fetch_add_u64(&part->numStolenAllocs, 1);
+    }
+}
+
 /*
  * ClockSweepTick - Helper routine for StrategyGetBuffer()
  *
- * Move the clock hand one buffer ahead of its current position and return the
- * id of the buffer now under the hand.
+ * Move the clock hand of the partition one buffer ahead of its current
+ * position and return the offset, within the partition, of the buffer now
+ * under the hand.
  */
-static inline uint32 ClockSweepTick(int max_nbuffer_can_use)
+static inline uint32 ClockSweepTick(BufferStrategyPartition* part, int max_nbuffer_can_use)
 {
     uint32 victim;
 
@@ -113,7 +233,7 @@ static inline uint32 ClockSweepTick(int max_nbuffer_can_use)
      * doing this, this can lead to buffers being returned slightly out of
      * apparent order.
      */
-    victim = pg_atomic_fetch_add_u32(&t_thrd.storage_cxt.StrategyControl->nextVictimBuffer, 1);
+    victim = pg_atomic_fetch_add_u32(&part->nextVictimBuffer, 1);
     if (victim >= (uint32)max_nbuffer_can_use) {
         uint32 original_victim = victim;
 
@@ -146,10 +266,9 @@ static inline uint32 ClockSweepTick(int max_nbuffer_can_use)
 
                 wrapped = expected % max_nbuffer_can_use;
 
-                success = pg_atomic_compare_exchange_u32(
-                    &t_thrd.storage_cxt.StrategyControl->nextVictimBuffer, &expected, wrapped);
+                success = pg_atomic_compare_exchange_u32(&part->nextVictimBuffer, &expected, wrapped);
                 if (success)
-                    t_thrd.storage_cxt.StrategyControl->completePasses++;
+                    part->completePasses++;
                 SpinLockRelease(&t_thrd.storage_cxt.StrategyControl->buffer_strategy_lock);
             }
         }
@@ -249,70 +368,85 @@ retry:
             int(g_instance.attr.attr_storage.NBuffers * u_sess->attr.attr_storage.shared_buffers_fraction);
     else
         max_buffer_can_use = g_instance.attr.attr_storage.NBuffers;
-    try_counter = max_buffer_can_use;
     int try_get_loc_times = max_buffer_can_use;
-    for (;;) {
-        buf = GetBufferDescriptor(ClockSweepTick(max_buffer_can_use));
-        /*
-         * If the buffer is pinned, we cannot use it.
-         */
-        if (!retryLockBufHdr(buf, &local_buf_state)) {
-            if (--try_get_loc_times == 0) {
-                ereport(
-                    WARNING, (errmsg("try get buf headr lock times equal to maxNBufferCanUse when StrategyGetBuffer")));
-                try_get_loc_times = max_buffer_can_use;
-            }
-            perform_delay(&retry_lock_status);
-            continue;
-        }
+    int num_partitions = t_thrd.storage_cxt.StrategyControl->num_partitions;
+    int home = StrategyHomePartition();
 
-        retry_lock_status.retry_times = 0;
-        if (BUF_STATE_GET_REFCOUNT(local_buf_state) == 0 &&
-            (!dw_page_writer_running() || !(local_buf_state & BM_DIRTY))) {
-            /* Found a usable buffer */
-            if (strategy != NULL)
-                AddBufferToRing(strategy, buf);
-            *buf_state = local_buf_state;
-            (void)pg_atomic_fetch_add_u64(&g_instance.bgwriter_cxt.get_buf_num_clock_sweep, 1);
-            return buf;
-        } else if (--try_counter == 0) {
+    /*
+     * Sweep the home partition first.  Only once a whole pass over it found
+     * nothing usable do we move on to the next partition.
+     */
+    for (int i = 0; i < num_partitions; i++) {
+        int part_id = (home + i) % num_partitions;
+        BufferStrategyPartition* part = &t_thrd.storage_cxt.StrategyControl->partitions[part_id].part;
+        int part_can_use = StrategyPartitionUsable(part, am_standby);
+
+        try_counter = part_can_use;
+        for (;;) {
+            buf = GetBufferDescriptor(part->buf_id_start + ClockSweepTick(part, part_can_use));
             /*
-             * We've scanned all the buffers without making any state changes,
-             * so all the buffers are pinned (or were when we looked at them).
-             * We could hope that someone will free one eventually, but it's
-             * probably better to fail than to risk getting stuck in an
-             * infinite loop.
+             * If the buffer is pinned, we cannot use it.
              */
-            UnlockBufHdr(buf, local_buf_state);
+            if (!retryLockBufHdr(buf, &local_buf_state)) {
+                if (--try_get_loc_times == 0) {
+                    ereport(WARNING,
+                        (errmsg("try get buf headr lock times equal to maxNBufferCanUse when StrategyGetBuffer")));
+                    try_get_loc_times = max_buffer_can_use;
+                }
+                perform_delay(&retry_lock_status);
+                continue;
+            }
 
-            if (am_standby && u_sess->attr.attr_storage.shared_buffers_fraction < 1.0) {
-                ereport(WARNING, (errmsg("no unpinned buffers available")));
-                u_sess->attr.attr_storage.shared_buffers_fraction =
-                    Min(u_sess->attr.attr_storage.shared_buffers_fraction + 0.1, 1.0);
-                goto retry;
-            } else if (dw_page_writer_running()) {
-                /*
-                 * If the page_writer is still able to flush some buffers, we better
-                 * retry (instead of giving up and throwing error).
-                 */
-                ereport(DEBUG3,
-                    (errmsg("double writer is on, no buffer available, this buffer dirty is %u, "
-                            "this buffer refcount is %u, now dirty page num is %ld",
-                        (local_buf_state & BM_DIRTY),
-                        BUF_STATE_GET_REFCOUNT(local_buf_state),
-                        get_dirty_page_num())));
-                perform_delay(&retry_buf_status);
-                goto retry;
-            } else if (t_thrd.storage_cxt.is_btree_split) {
-                ereport(WARNING, (errmsg("no unpinned buffers available when btree insert parent")));
-                goto retry;
-            } else
-                ereport(ERROR, (errcode(ERRCODE_INVALID_BUFFER), (errmsg("no unpinned buffers available"))));
+            retry_lock_status.retry_times = 0;
+            if (BUF_STATE_GET_REFCOUNT(local_buf_state) == 0 &&
+                (!dw_page_writer_running() || !(local_buf_state & BM_DIRTY))) {
+                /* Found a usable buffer */
+                if (strategy != NULL)
+                    AddBufferToRing(strategy, buf);
+                *buf_state = local_buf_state;
+                (void)pg_atomic_fetch_add_u64(&g_instance.bgwriter_cxt.get_buf_num_clock_sweep, 1);
+                StrategyCountAlloc(part_id, false);
+                return buf;
+            }
+            UnlockBufHdr(buf, local_buf_state);
+            if (--try_counter == 0) {
+                /* nothing usable in this partition, fall back to the next one */
+                break;
+            }
+            perform_delay(&retry_buf_status);
         }
-        UnlockBufHdr(buf, local_buf_state);
-        perform_delay(&retry_buf_status);
     }
 
+    /*
+     * We've scanned all the buffers of every partition without making any
+     * state changes, so all the buffers are pinned (or were when we looked at
+     * them).  We could hope that someone will free one eventually, but it's
+     * probably better to fail than to risk getting stuck in an infinite loop.
+     */
+    if (am_standby && u_sess->attr.attr_storage.shared_buffers_fraction < 1.0) {
+        ereport(WARNING, (errmsg("no unpinned buffers available")));
+        u_sess->attr.attr_storage.shared_buffers_fraction =
+            Min(u_sess->attr.attr_storage.shared_buffers_fraction + 0.1, 1.0);
+        goto retry;
+    } else if (dw_page_writer_running()) {
+        /*
+         * If the page_writer is still able to flush some buffers, we better
+         * retry (instead of giving up and throwing error).
+         */
+        ereport(DEBUG3,
+            (errmsg("double writer is on, no buffer available, this buffer dirty is %u, "
+                    "this buffer refcount is %u, now dirty page num is %ld",
+                (local_buf_state & BM_DIRTY),
+                BUF_STATE_GET_REFCOUNT(local_buf_state),
+                get_dirty_page_num())));
+        perform_delay(&retry_buf_status);
+        goto retry;
+    } else if (t_thrd.storage_cxt.is_btree_split) {
+        ereport(WARNING, (errmsg("no unpinned buffers available when btree insert parent")));
+        goto retry;
+    } else
+        ereport(ERROR, (errcode(ERRCODE_INVALID_BUFFER), (errmsg("no unpinned buffers available"))));
+
     /* not reached */
     gstrace_exit(GS_TRC_ID_StrategyGetBuffer);
     return NULL;
@@ -328,32 +462,66 @@ retry:
  * the higher-order bits of nextVictimBuffer) and the count of recent buffer
  * allocs if non-NULL pointers are passed.	The alloc count is reset after
  * being read.
+ *
+ * The clock is only partitioned with incremental checkpoint, when the
+ * bgwriter does not call this, so this is the single hand of partition 0.
+ * Should it ever be called with several partitions, it reports the total
+ * number of buffers they have swept, folded onto the buffer array: that keeps
+ * the allocation rate right, but the position then is only approximate.
  */
 int StrategySyncStart(uint32* complete_passes, uint32* num_buf_alloc)
 {
-    uint32 next_victim_buffer;
+    BufferStrategyControl* ctl = t_thrd.storage_cxt.StrategyControl;
+    uint64 swept = 0;
     int result;
 
-    SpinLockAcquire(&t_thrd.storage_cxt.StrategyControl->buffer_strategy_lock);
-    next_victim_buffer = pg_atomic_read_u32(&t_thrd.storage_cxt.StrategyControl->nextVictimBuffer);
-    result = next_victim_buffer % g_instance.attr.attr_storage.NBuffers;
+    SpinLockAcquire(&ctl->buffer_strategy_lock);
+    for (int i = 0; i < ctl->num_partitions; i++) {
+        BufferStrategyPartition* part = &ctl->partitions[i].part;
+
+        swept += (uint64)part->completePasses * (uint64)part->num_buffers;
+        swept += pg_atomic_read_u32(&part->nextVictimBuffer);
+    }
+    result = (int)(swept % (uint64)g_instance.attr.attr_storage.NBuffers);
 
     if (complete_passes != NULL) {
-        *complete_passes = t_thrd.storage_cxt.StrategyControl->completePasses;
-        /*
-         * Additionally add the number of wraparounds that happened before
-         * completePasses could be incremented. C.f. ClockSweepTick().
-         */
-        *complete_passes += next_victim_buffer / (unsigned int)g_instance.attr.attr_storage.NBuffers;
+        *complete_passes = (uint32)(swept / (uint64)g_instance.attr.attr_storage.NBuffers);
     }
 
     if (num_buf_alloc != NULL) {
-        *num_buf_alloc = pg_atomic_exchange_u32(&t_thrd.storage_cxt.StrategyControl->numBufferAllocs, 0);
+        *num_buf_alloc = pg_atomic_exchange_u32(&ctl->numBufferAllocs, 0);
     }
-    SpinLockRelease(&t_thrd.storage_cxt.StrategyControl->buffer_strategy_lock);
+    SpinLockRelease(&ctl->buffer_strategy_lock);
     return result;
 }
 
+/*
+ * StrategyGetPartitionStats -- report the state of every clock partition
+ *
+ * Returns the number of partitions and a palloc'd array describing them.
+ */
+int StrategyGetPartitionStats(BufferStrategyPartitionStat** stats)
+{
+    BufferStrategyControl* ctl = t_thrd.storage_cxt.StrategyControl;
+    BufferStrategyPartitionStat* result =
+        (BufferStrategyPartitionStat*)palloc0(ctl->num_partitions * sizeof(BufferStrategyPartitionStat));
+
+    for (int i = 0; i < ctl->num_partitions; i++) {
+        BufferStrategyPartition* part = &ctl->partitions[i].part;
+
+        result[i].partition_id = i;
+        result[i].buf_id_start = part->buf_id_start;
+        result[i].num_buffers = part->num_buffers;
+        result[i].complete_passes = part->completePasses;
+        result[i].candidate_allocs = pg_atomic_read_u64(&part->numCandidateAllocs);
+        result[i].sweep_allocs = pg_atomic_read_u64(&part->numSweepAllocs);
+        result[i].stolen_allocs = pg_atomic_read_u64(&part->numStolenAllocs);
+    }
+
+    *stats = result;
+    return ctl->num_partitions;
+}
+
 /*
  * StrategyNotifyBgWriter -- set or clear allocation notification latch
  *
@@ -392,6 +560,10 @@ Size StrategyShmemSize(void)
     /* size of the shared replacement strategy control block */
     size = add_size(size, MAXALIGN(sizeof(BufferStrategyControl)));
 
+    /* size of the clock sweep partitions, plus room to align them */
+    size = add_size(size, mul_size(StrategyNumPartitions(), sizeof(BufferStrategyPartitionPadded)));
+    size = add_size(size, PG_CACHE_LINE_SIZE);
+
     return size;
 }
 
@@ -421,25 +593,54 @@ void StrategyInitialize(bool init)
     /*
      * Get or create the shared strategy control block
      */
+    int num_partitions = StrategyNumPartitions();
+    Size ctl_size = MAXALIGN(sizeof(BufferStrategyControl)) +
+                    num_partitions * sizeof(BufferStrategyPartitionPadded) + PG_CACHE_LINE_SIZE;
+
     t_thrd.storage_cxt.StrategyControl =
-        (BufferStrategyControl*)ShmemInitStruct("Buffer Strategy Status", sizeof(BufferStrategyControl), &found);
+        (BufferStrategyControl*)ShmemInitStruct("Buffer Strategy Status", ctl_size, &found);
 
     if (!found) {
+        BufferStrategyControl* ctl = t_thrd.storage_cxt.StrategyControl;
+
         /*
          * Only done once, usually in postmaster
          */
         Assert(init);
-        SpinLockInit(&t_thrd.storage_cxt.StrategyControl->buffer_strategy_lock);
-
-        /* Initialize the clock sweep pointer */
-        pg_atomic_init_u32(&t_thrd.storage_cxt.StrategyControl->nextVictimBuffer, 0);
+        SpinLockInit(&ctl->buffer_strategy_lock);
 
         /* Clear statistics */
-        t_thrd.storage_cxt.StrategyControl->completePasses = 0;
-        pg_atomic_init_u32(&t_thrd.storage_cxt.StrategyControl->numBufferAllocs, 0);
+        pg_atomic_init_u32(&ctl->numBufferAllocs, 0);
 
         /* No pending notification */
-        t_thrd.storage_cxt.StrategyControl->bgwprocno = -1;
+        ctl->bgwprocno = -1;
+
+        /*
+         * Lay out the clock sweep partitions, splitting the buffers the same
+         * way candidate_buf_init() splits them among the bgwriter threads.
+         */
+        pg_atomic_init_u32(&ctl->nextHomePartition, 0);
+        ctl->num_partitions = num_partitions;
+        ctl->partitions = (BufferStrategyPartitionPadded*)TYPEALIGN(
+            PG_CACHE_LINE_SIZE, (char*)ctl + MAXALIGN(sizeof(BufferStrategyControl)));
+
+        int avg_num = g_instance.attr.attr_storage.NBuffers / num_partitions;
+        for (int i = 0; i < num_partitions; i++) {
+            BufferStrategyPartition* part = &ctl->partitions[i].part;
+
+            part->buf_id_start = avg_num * i;
+            part->num_buffers = avg_num;
+            if (i == num_partitions - 1) {
+                part->num_buffers += g_instance.attr.attr_storage.NBuffers % num_partitions;
+            }
+
+            /* Initialize the clock sweep pointer */
+            pg_atomic_init_u32(&part->nextVictimBuffer, 0);
+            part->completePasses = 0;
+            pg_atomic_init_u64(&part->numCandidateAllocs, 0);
+            pg_atomic_init_u64(&part->numSweepAllocs, 0);
+            pg_atomic_init_u64(&part->numStolenAllocs, 0);
+        }
     } else {
         Assert(!init);
     }
@@ -677,8 +878,18 @@ static BufferDesc* get_buf_from_candidate_list(BufferAccessStrategy strategy, ui
     int bgwriter_num = g_instance.bgwriter_cxt.bgwriter_num;
     uint32 local_buf_state;
 
+    /*
+     * Candidate list i holds the buffers of clock partition i, so start with
+     * our own.  Should the lists not line up with the partitions, which were
+     * laid out for bgwriter_thread_num threads, start at a random one.
+     */
     int list_num = bgwriter_num;
-    int list_id = random() % list_num;
+    int list_id;
+    if (list_num == t_thrd.storage_cxt.StrategyControl->num_partitions) {
+        list_id = StrategyHomePartition();
+    } else {
+        list_id = random() % list_num;
+    }
     for (int i = 0; i < list_num; i++) {
         int thread_id = (list_id + i) % list_num;
         int buf_id = 0;
@@ -695,6 +906,7 @@ static BufferDesc* get_buf_from_candidate_list(BufferAccessStrategy strategy, ui
                         AddBufferToRing(strategy, buf);
                     }
                     *buf_state = local_buf_state;
+                    StrategyCountAlloc(StrategyPartitionOf(buf_id), true);
                     return buf;
                 }
             }
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ *  bitpack_avx2.cpp
+ *        Bit unpacking kernel using AVX2, see BitpackCoder in storage/compress_kits.h.
+ *
+ * IDENTIFICATION
+ *        src/gausskernel/storage/cstore/compression/bitpack_avx2.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "storage/compress_kits.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+
+/* each 64-bit lane holds one value while unpacking */
+#define AVX2_LANES 4
+
+/* widths up to this are unpacked 8 values at a time from one 32 bytes load */
+#define AVX2_PERMUTE_MAX_BITS 31
+
+/* store 4 unpacked values, narrowing them to outValSize bytes */
+template <short outValSize>
+static FORCE_INLINE void BitUnpackAVX2Store4(char* outbuf, __m256i vals)
+{
+    /* move the low halves of the 64-bit lanes into the low 128 bits */
+    const __m256i narrow32 = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    /* then the low halves of those 32-bit values into the low 64 bits */
+    const __m128i narrow16 = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+
+    if (outValSize == sizeof(int64)) {
+        _mm256_storeu_si256((__m256i*)outbuf, vals);
+    } else {
+        __m128i vals32 = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(vals, narrow32));
+        if (outValSize == sizeof(int32)) {
+            _mm_storeu_si128((__m128i*)outbuf, vals32);
+        } else {
+            _mm_storel_epi64((__m128i*)outbuf, _mm_shuffle_epi8(vals32, narrow16));
+        }
+    }
+}
+
+/*
+ * 8 values take exactly <bits> bytes, so every group of 8 values starts at a byte
+ * boundary and the same permutation and shifts apply to all of them. value k of
+ * a group starts at bit (k * bits), and the two dwords from dword ((k * bits) / 32)
+ * on hold it all, because bits + 31 <= 64.
+ */
+template <short outValSize>
+static int BitUnpackAVX2Permute(const char* inbuf, int insize, short bits, int64 mindata, char* outbuf, int nValues)
+{
+    const __m256i mask = _mm256_set1_epi64x((int64)((((uint64)1) << bits) - 1));
+    const __m256i minv = _mm256_set1_epi64x(mindata);
+    int dwords[2 * AVX2_LANES * 2];
+    int64 shifts[2 * AVX2_LANES];
+
+    for (int k = 0; k < 2 * AVX2_LANES; k++) {
+        dwords[2 * k] = (k * bits) / 32;
+        dwords[2 * k + 1] = (k * bits) / 32 + 1;
+        shifts[k] = (k * bits) % 32;
+    }
+    const __m256i permLow = _mm256_loadu_si256((const __m256i*)dwords);
+    const __m256i permHigh = _mm256_loadu_si256((const __m256i*)(dwords + 2 * AVX2_LANES));
+    const __m256i shiftLow = _mm256_loadu_si256((const __m256i*)shifts);
+    const __m256i shiftHigh = _mm256_loadu_si256((const __m256i*)(shifts + AVX2_LANES));
+    const char* inptr = inbuf;
+    int i = 0;
+
+    for (; i + 2 * AVX2_LANES <= nValues && (inptr - inbuf) + (int)sizeof(__m256i) <= insize; i += 2 * AVX2_LANES) {
+        __m256i words = _mm256_loadu_si256((const __m256i*)inptr);
+        __m256i low = _mm256_srlv_epi64(_mm256_permutevar8x32_epi32(words, permLow), shiftLow);
+        __m256i high = _mm256_srlv_epi64(_mm256_permutevar8x32_epi32(words, permHigh), shiftHigh);
+
+        BitUnpackAVX2Store4<outValSize>(outbuf + i * outValSize, _mm256_add_epi64(_mm256_and_si256(low, mask), minv));
+        BitUnpackAVX2Store4<outValSize>(
+            outbuf + (i + AVX2_LANES) * outValSize, _mm256_add_epi64(_mm256_and_si256(high, mask), minv));
+        inptr += bits;
+    }
+
+    return i;
+}
+
+/*
+ * wider values don't fit the scheme above, so each lane gathers the 8 bytes its
+ * value starts in.
+ */
+template <short outValSize>
+static int BitUnpackAVX2Gather(const char* inbuf, int insize, short bits, int64 mindata, char* outbuf, int nValues)
+{
+    const __m256i mask = _mm256_set1_epi64x((int64)((((uint64)1) << bits) - 1));
+    const __m256i minv = _mm256_set1_epi64x(mindata);
+    const __m256i seven = _mm256_set1_epi64x(7);
+    const __m256i step = _mm256_set1_epi64x((int64)bits * AVX2_LANES);
+    __m256i bitpos = _mm256_setr_epi64x(0, bits, 2 * bits, 3 * bits);
+    int i = 0;
+
+    for (; i + AVX2_LANES <= nValues && ((int64)(i + AVX2_LANES - 1) * bits) / 8 + (int)sizeof(int64) <= insize;
+         i += AVX2_LANES) {
+        __m256i offsets = _mm256_srli_epi64(bitpos, 3);
+        __m256i words = _mm256_i64gather_epi64((const long long*)inbuf, offsets, 1);
+        __m256i vals = _mm256_srlv_epi64(words, _mm256_and_si256(bitpos, seven));
+
+        BitUnpackAVX2Store4<outValSize>(outbuf + i * outValSize, _mm256_add_epi64(_mm256_and_si256(vals, mask), minv));
+        bitpos = _mm256_add_epi64(bitpos, step);
+    }
+
+    return i;
+}
+
+template <short outValSize>
+static FORCE_INLINE int BitUnpackAVX2Impl(
+    const char* inbuf, int insize, short bits, int64 mindata, char* outbuf, int nValues)
+{
+    if (bits <= AVX2_PERMUTE_MAX_BITS) {
+        return BitUnpackAVX2Permute<outValSize>(inbuf, insize, bits, mindata, outbuf, nValues);
+    }
+    return BitUnpackAVX2Gather<outValSize>(inbuf, insize, bits, mindata, outbuf, nValues);
+}
+
+int BitUnpackAVX2(const char* inbuf, int insize, short bits, int64 mindata, char* outbuf, short outValSize, int nValues)
+{
+    switch (outValSize) {
+        case sizeof(int16):
+            return BitUnpackAVX2Impl<sizeof(int16)>(inbuf, insize, bits, mindata, outbuf, nValues);
+        case sizeof(int32):
+            return BitUnpackAVX2Impl<sizeof(int32)>(inbuf, insize, bits, mindata, outbuf, nValues);
+        case sizeof(int64):
+            return BitUnpackAVX2Impl<sizeof(int64)>(inbuf, insize, bits, mindata, outbuf, nValues);
+        default:
+            /* odd sizes are left for the portable code */
+            return 0;
+    }
+}
+#endif /* __x86_64__ */
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ *  bitpack_neon.cpp
+ *        Bit unpacking kernel using NEON, see BitpackCoder in storage/compress_kits.h.
+ *
+ * IDENTIFICATION
+ *        src/gausskernel/storage/cstore/compression/bitpack_neon.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "storage/compress_kits.h"
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+
+/*
+ * NEON has no gather, so the two 64-bit lanes are loaded one by one. shifting,
+ * masking, adding the min value and narrowing are done in vector registers.
+ */
+template <short outValSize>
+static int BitUnpackNEONImpl(const char* inbuf, int insize, short bits, int64 mindata, char* outbuf, int nValues)
+{
+    const uint64x2_t mask = vdupq_n_u64((((uint64)1) << bits) - 1);
+    const uint64x2_t minv = vdupq_n_u64((uint64)mindata);
+    uint64 bitpos = 0;
+    int i = 0;
+
+    for (; i + 4 <= nValues && (bitpos + 3 * bits) / 8 + sizeof(uint64) <= (uint64)insize; i += 4) {
+        uint64 pos0 = bitpos;
+        uint64 pos1 = pos0 + bits;
+        uint64 pos2 = pos1 + bits;
+        uint64 pos3 = pos2 + bits;
+        uint64x2_t words01 = vcombine_u64(
+            vld1_u64((const uint64_t*)(inbuf + (pos0 >> 3))), vld1_u64((const uint64_t*)(inbuf + (pos1 >> 3))));
+        uint64x2_t words23 = vcombine_u64(
+            vld1_u64((const uint64_t*)(inbuf + (pos2 >> 3))), vld1_u64((const uint64_t*)(inbuf + (pos3 >> 3))));
+        /* a negative shift count shifts right */
+        int64x2_t shifts01 = vcombine_s64(vcreate_s64(-(int64)(pos0 & 7)), vcreate_s64(-(int64)(pos1 & 7)));
+        int64x2_t shifts23 = vcombine_s64(vcreate_s64(-(int64)(pos2 & 7)), vcreate_s64(-(int64)(pos3 & 7)));
+        uint64x2_t vals01 = vaddq_u64(vandq_u64(vshlq_u64(words01, shifts01), mask), minv);
+        uint64x2_t vals23 = vaddq_u64(vandq_u64(vshlq_u64(words23, shifts23), mask), minv);
+
+        if (outValSize == sizeof(int64)) {
+            vst1q_u64((uint64_t*)(outbuf + i * sizeof(int64)), vals01);
+            vst1q_u64((uint64_t*)(outbuf + (i + 2) * sizeof(int64)), vals23);
+        } else {
+            uint32x4_t vals32 = vcombine_u32(vmovn_u64(vals01), vmovn_u64(vals23));
+            if (outValSize == sizeof(int32)) {
+                vst1q_u32((uint32_t*)(outbuf + i * sizeof(int32)), vals32);
+            } else {
+                vst1_u16((uint16_t*)(outbuf + i * sizeof(int16)), vmovn_u32(vals32));
+            }
+        }
+        bitpos = pos3 + bits;
+    }
+
+    return i;
+}
+
+int BitUnpackNEON(const char* inbuf, int insize, short bits, int64 mindata, char* outbuf, short outValSize, int nValues)
+{
+    switch (outValSize) {
+        case sizeof(int16):
+            return BitUnpackNEONImpl<sizeof(int16)>(inbuf, insize, bits, mindata, outbuf, nValues);
+        case sizeof(int32):
+            return BitUnpackNEONImpl<sizeof(int32)>(inbuf, insize, bits, mindata, outbuf, nValues);
+        case sizeof(int64):
+            return BitUnpackNEONImpl<sizeof(int64)>(inbuf, insize, bits, mindata, outbuf, nValues);
+        default:
+            /* odd sizes are left for the portable code */
+            return 0;
+    }
+}
+#endif /* __aarch64__ */
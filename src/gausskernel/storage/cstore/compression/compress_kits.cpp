@@ -28,6 +28,12 @@
 #include "nodes/memnodes.h"
 #include "lz4.h"
 #include "lz4hc.h"
+#ifdef USE_ZSTD
+#include "zstd.h"
+#define ZDICT_STATIC_LINKING_ONLY
+#include "zdict.h"
+#endif
+#include "port/pg_cpu_features.h"
 
 /* The macro to validate if the return value is available */
 #define MEMPROT_ALLOC_VALID(buf, size)                                                                               \
@@ -156,6 +162,11 @@ static void DeltaCheckCompressedData(_in_ char* rawData, _in_ int rawDataSize, _
 static void Lz4CheckCompressedData(
     _in_ const char* rawData, _in_ int rawDataSize, _in_ const char* cmprBuf, _in_ int cmprBufSize);
 
+#ifdef USE_ZSTD
+static void ZstdCheckCompressedData(_in_ const char* rawData, _in_ int rawDataSize, _in_ const char* cmprBuf,
+    _in_ int cmprBufSize, _in_ const ZstdDict* dict);
+#endif
+
 static void ZlibCheckCompressedData(_in_ char* rawData, _in_ int rawDataSize, _in_ char* cmprBuf, _in_ int cmprBufSize);
 
 static void DictCheckCompressedData(
@@ -926,6 +937,213 @@ int64 DeltaCoder::Decompress(
     return ret;
 }
 
+/*************************************************************************
+ *                   Bitpack (Frame Of Reference) Compression             *
+ *************************************************************************/
+#define BitpackMask(_bits) ((((uint64)1) << (_bits)) - 1)
+
+BitpackCoder::BitpackCoder(int64 mindata, int64 maxdata) : m_mindata(mindata)
+{
+    m_bits = BitpackGetBitsNum(mindata, maxdata);
+}
+
+template <short inValSize>
+int BitpackCoder::DoPack(_in_ char* inbuf, _out_ char* outbuf, _in_ int nValues)
+{
+    unsigned int inpos = 0;
+    unsigned char* outptr = (unsigned char*)outbuf;
+    const uint64 mask = BitpackMask(m_bits);
+    uint64 acc = 0;
+    int accBits = 0;
+
+    for (int i = 0; i < nValues; ++i) {
+        // readData() doesn't extend the sign, but the low bits of the difference
+        // are the same, and m_bits is never above the bits of each value.
+        uint64 diff = ((uint64)readData<inValSize>(inbuf, &inpos) - (uint64)m_mindata) & mask;
+
+        // accBits is below 8 here, so no bit of diff is shifted out.
+        acc |= diff << accBits;
+        accBits += m_bits;
+        while (accBits >= 8) {
+            *outptr++ = (unsigned char)acc;
+            acc >>= 8;
+            accBits -= 8;
+        }
+    }
+    if (accBits > 0) {
+        *outptr++ = (unsigned char)acc;
+    }
+    return (int)(outptr - (unsigned char*)outbuf);
+}
+
+int BitpackCoder::Compress(_in_ char* inbuf, _out_ char* outbuf, _in_ int insize, _in_ int outsize, _in_ short inDataSize)
+{
+    Assert(insize > 0);
+    Assert(insize == ((insize / inDataSize) * inDataSize));
+    Assert(m_bits <= BITPACK_MAX_BITS && m_bits < inDataSize * 8);
+
+    int nValues = insize / inDataSize;
+    if (unlikely(outsize < GetBound(nValues)))
+        return 0;
+
+    switch (inDataSize) {
+        case sizeof(char):
+            return DoPack<sizeof(char)>(inbuf, outbuf, nValues);
+        case sizeof(int16):
+            return DoPack<sizeof(int16)>(inbuf, outbuf, nValues);
+        case sizeof(int32):
+            return DoPack<sizeof(int32)>(inbuf, outbuf, nValues);
+        case sizeof(int64):
+            return DoPack<sizeof(int64)>(inbuf, outbuf, nValues);
+        case 3:
+            return DoPack<3>(inbuf, outbuf, nValues);
+        case 5:
+            return DoPack<5>(inbuf, outbuf, nValues);
+        case 6:
+            return DoPack<6>(inbuf, outbuf, nValues);
+        case 7:
+            return DoPack<7>(inbuf, outbuf, nValues);
+        default:
+            Assert(false);
+            break;
+    }
+    return 0;
+}
+
+/// load 8 bytes of the bit stream, starting at byte *offset*.
+static FORCE_INLINE uint64 BitpackLoadWord(const char* inbuf, uint64 offset)
+{
+    uint64 word = *(const uint64*)(inbuf + offset);
+#ifdef WORDS_BIGENDIAN
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+/// the same to BitpackLoadWord(), but never reads beyond *insize*.
+static FORCE_INLINE uint64 BitpackLoadTailWord(const char* inbuf, int insize, uint64 offset)
+{
+    uint64 word = 0;
+    for (int i = 0; i < (int)sizeof(uint64) && offset + i < (uint64)insize; ++i) {
+        word |= ((uint64)(unsigned char)inbuf[offset + i]) << (8 * i);
+    }
+    return word;
+}
+
+template <short outValSize, bool boundCheck>
+static void BitUnpackPortable(
+    const char* inbuf, int insize, short bits, int64 mindata, char* outbuf, int first, int last)
+{
+    const uint64 mask = BitpackMask(bits);
+    unsigned int outpos = (unsigned int)first * outValSize;
+    uint64 bitpos = (uint64)first * bits;
+
+    for (int i = first; i < last; ++i, bitpos += bits) {
+        uint64 word = boundCheck ? BitpackLoadTailWord(inbuf, insize, bitpos >> 3) : BitpackLoadWord(inbuf, bitpos >> 3);
+        uint64 val = ((word >> (bitpos & 7)) & mask) + (uint64)mindata;
+        writeData<outValSize>(outbuf, &outpos, (int64)val);
+    }
+}
+
+/// unpack values [first, nValues), and the values before *safeNum*
+/// can be read with one 8 bytes load.
+template <short outValSize>
+static void BitUnpackRemain(
+    const char* inbuf, int insize, short bits, int64 mindata, char* outbuf, int first, int safeNum, int nValues)
+{
+    BitUnpackPortable<outValSize, false>(inbuf, insize, bits, mindata, outbuf, first, safeNum);
+    BitUnpackPortable<outValSize, true>(inbuf, insize, bits, mindata, outbuf, Max(first, safeNum), nValues);
+}
+
+typedef int (*BitUnpackFunc)(
+    const char* inbuf, int insize, short bits, int64 mindata, char* outbuf, short outValSize, int nValues);
+
+static int BitUnpackNone(
+    const char* inbuf, int insize, short bits, int64 mindata, char* outbuf, short outValSize, int nValues)
+{
+    return 0;
+}
+
+static int BitUnpackChoose(
+    const char* inbuf, int insize, short bits, int64 mindata, char* outbuf, short outValSize, int nValues);
+
+static BitUnpackFunc BitUnpackSIMD = BitUnpackChoose;
+
+/*
+ * This gets called on the first call, and replaces the function pointer so that
+ * subsequent calls go directly to the kernel the CPU supports. With assertions
+ * enabled every compressed CU is decoded once and compared with its raw data,
+ * so a kernel disagreeing with the portable code doesn't go unnoticed.
+ */
+static int BitUnpackChoose(
+    const char* inbuf, int insize, short bits, int64 mindata, char* outbuf, short outValSize, int nValues)
+{
+    BitUnpackFunc chosen = BitUnpackNone;
+
+#if defined(USE_X86_CPU_FEATURES)
+    if (pg_cpu_has_avx2()) {
+        chosen = BitUnpackAVX2;
+    }
+#elif defined(__aarch64__)
+    chosen = BitUnpackNEON;
+#endif
+
+    BitUnpackSIMD = chosen;
+    return chosen(inbuf, insize, bits, mindata, outbuf, outValSize, nValues);
+}
+
+int BitpackCoder::Decompress(
+    _in_ char* inbuf, _out_ char* outbuf, _in_ int insize, _in_ int outsize, _in_ short outDataSize)
+{
+    Assert(outsize > 0);
+    Assert(outsize == ((outsize / outDataSize) * outDataSize));
+
+    int nValues = outsize / outDataSize;
+    if (unlikely(insize < GetBound(nValues)))
+        return 0;
+
+    // value i can be read with one 8 bytes load if ((i * m_bits) / 8 + 8) <= insize.
+    int safeNum = 0;
+    if (insize >= (int)sizeof(uint64)) {
+        safeNum = (int)Min((int64)nValues, ((int64)(insize - 7) * 8 - 1) / m_bits + 1);
+    }
+
+    // the SIMD kernel unpacks as many as it can, and the rest is done here.
+    int first = BitUnpackSIMD(inbuf, insize, m_bits, m_mindata, outbuf, outDataSize, nValues);
+    Assert(first >= 0 && first <= nValues);
+
+    switch (outDataSize) {
+        case sizeof(char):
+            BitUnpackRemain<sizeof(char)>(inbuf, insize, m_bits, m_mindata, outbuf, first, safeNum, nValues);
+            break;
+        case sizeof(int16):
+            BitUnpackRemain<sizeof(int16)>(inbuf, insize, m_bits, m_mindata, outbuf, first, safeNum, nValues);
+            break;
+        case sizeof(int32):
+            BitUnpackRemain<sizeof(int32)>(inbuf, insize, m_bits, m_mindata, outbuf, first, safeNum, nValues);
+            break;
+        case sizeof(int64):
+            BitUnpackRemain<sizeof(int64)>(inbuf, insize, m_bits, m_mindata, outbuf, first, safeNum, nValues);
+            break;
+        case 3:
+            BitUnpackRemain<3>(inbuf, insize, m_bits, m_mindata, outbuf, first, safeNum, nValues);
+            break;
+        case 5:
+            BitUnpackRemain<5>(inbuf, insize, m_bits, m_mindata, outbuf, first, safeNum, nValues);
+            break;
+        case 6:
+            BitUnpackRemain<6>(inbuf, insize, m_bits, m_mindata, outbuf, first, safeNum, nValues);
+            break;
+        case 7:
+            BitUnpackRemain<7>(inbuf, insize, m_bits, m_mindata, outbuf, first, safeNum, nValues);
+            break;
+        default:
+            Assert(false);
+            return 0;
+    }
+    return outsize;
+}
+
 /*************************************************************************
  *                         Dictionary Compression                         *
  *************************************************************************/
@@ -1222,6 +1440,157 @@ int LZ4Wrapper::Decompress(const char* source, char* dest, int sourceSize) const
     return LZ4_decompress_safe(header->data, dest, header->compressLen, destSize);
 }
 
+/*
+ * @Description: find the dictionary whose id is 'dictId' in the set.
+ * @Return: NULL if it's not found.
+ */
+const ZstdDict* ZstdDictSetLookup(const ZstdDictSet* dictSet, uint32 dictId)
+{
+    if (dictSet == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < dictSet->num; ++i) {
+        if (dictSet->dicts[i].dictId == dictId) {
+            return dictSet->dicts + i;
+        }
+    }
+    return NULL;
+}
+
+#ifdef USE_ZSTD
+/*************************************************************************
+ *                             ZstdWrapper                               *
+ *************************************************************************/
+void ZstdWrapper::SetCompressionLevel(int8 level)
+{
+    Assert(level >= ZstdWrapper::zstd_min_level && level <= ZstdWrapper::zstd_max_level);
+    m_compressionLevel = level;
+}
+
+int ZstdWrapper::CompressGetBound(int insize) const
+{
+    return (int)ZSTD_compressBound((size_t)insize);
+}
+
+/*
+ * @Description: compress input data 'source', whose size is 'sourceSize',
+ *      into one zstd frame and write it to 'dest'. The frame header records
+ *      the raw data size and the id of the dictionary, so no extra header
+ *      is needed. Must call CompressGetBound() to ensure that 'dest' buffer
+ *      is large enough.
+ * @OUT dest: output data buffer
+ * @IN source: input data buffer
+ * @IN sourceSize: input data size
+ * @IN destSize: output buffer size
+ * @IN dict: the dictionary to compress with, or NULL
+ * @Return: return 0 if compress fails or makes no benefit; otherwise return
+ *      compressed data size.
+ * @See also:
+ */
+int ZstdWrapper::Compress(const char* source, char* dest, int sourceSize, int destSize, const ZstdDict* dict) const
+{
+    size_t outsize = 0;
+
+    if (dict == NULL) {
+        outsize = ZSTD_compress(dest, (size_t)destSize, source, (size_t)sourceSize, m_compressionLevel);
+    } else {
+        ZSTD_CCtx* cctx = ZSTD_createCCtx();
+        if (cctx == NULL) {
+            ereport(ERROR, (errcode(ERRCODE_OUT_OF_MEMORY), errmsg("out of memory when creating zstd context")));
+        }
+        outsize = ZSTD_compress_usingDict(cctx, dest, (size_t)destSize, source, (size_t)sourceSize, dict->data,
+            (size_t)dict->size, m_compressionLevel);
+        (void)ZSTD_freeCCtx(cctx);
+    }
+    if (ZSTD_isError(outsize) || outsize >= (size_t)sourceSize) {
+        return 0;
+    }
+
+#ifdef USE_ASSERT_CHECKING
+    ZstdCheckCompressedData(source, sourceSize, dest, (int)outsize, dict);
+#endif
+    return (int)outsize;
+}
+
+/*
+ * @Description: get the raw data size recorded in the zstd frame header.
+ * @Return: raw data size, or -1 if the frame header is broken.
+ */
+int ZstdWrapper::DecompressGetBound(const char* source, int sourceSize) const
+{
+    unsigned long long rawSize = ZSTD_getFrameContentSize(source, (size_t)sourceSize);
+    if (rawSize == ZSTD_CONTENTSIZE_UNKNOWN || rawSize == ZSTD_CONTENTSIZE_ERROR ||
+        rawSize > (unsigned long long)INT_MAX) {
+        return -1;
+    }
+    return (int)rawSize;
+}
+
+// Make dest buffer's size is enough to hold uncompressed data.
+// To make it, call DecompressGetBound() to get the raw data size
+// before calling Decompress(). 'dict' must be the dictionary whose
+// id GetDictID() reads from the frame. -1 is returned if the frame is broken.
+int ZstdWrapper::Decompress(const char* source, char* dest, int sourceSize, int destSize, const ZstdDict* dict) const
+{
+    size_t outsize = 0;
+
+    if (dict == NULL) {
+        outsize = ZSTD_decompress(dest, (size_t)destSize, source, (size_t)sourceSize);
+    } else {
+        ZSTD_DCtx* dctx = ZSTD_createDCtx();
+        if (dctx == NULL) {
+            ereport(ERROR, (errcode(ERRCODE_OUT_OF_MEMORY), errmsg("out of memory when creating zstd context")));
+        }
+        outsize = ZSTD_decompress_usingDict(
+            dctx, dest, (size_t)destSize, source, (size_t)sourceSize, dict->data, (size_t)dict->size);
+        (void)ZSTD_freeDCtx(dctx);
+    }
+    if (ZSTD_isError(outsize)) {
+        return -1;
+    }
+    return (int)outsize;
+}
+
+/*
+ * @Description: get the id of the dictionary the zstd frame is compressed with.
+ * @Return: 0 if no dictionary is used.
+ */
+uint32 ZstdWrapper::GetDictID(const char* source, int sourceSize)
+{
+    return (uint32)ZSTD_getDictID_fromFrame(source, (size_t)sourceSize);
+}
+
+/*
+ * @Description: train a dictionary from the samples, which are stored one
+ *      after another in 'samples'. zstd records 'dictId' in the dictionary
+ *      and in every frame compressed with it.
+ * @OUT dest: dictionary buffer
+ * @IN destSize: dictionary buffer size, which limits the dictionary size
+ * @Return: the dictionary size, or 0 if there isn't enough to learn from
+ *      the samples.
+ */
+int ZstdWrapper::TrainDictionary(const char* samples, const size_t* sampleSizes, int nSamples, uint32 dictId,
+    char* dest, int destSize)
+{
+    ZDICT_fastCover_params_t params;
+    errno_t rc = memset_s(&params, sizeof(params), 0, sizeof(params));
+    securec_check(rc, "", "");
+
+    /* let zstd search the segment size within a few steps */
+    params.d = 8;
+    params.steps = 4;
+    params.zParams.dictID = dictId;
+
+    size_t dictSize = ZDICT_optimizeTrainFromBuffer_fastCover(
+        dest, (size_t)destSize, samples, sampleSizes, (unsigned)nSamples, &params);
+    if (ZDICT_isError(dictSize)) {
+        return 0;
+    }
+    Assert(dictSize <= (size_t)destSize);
+    return (int)dictSize;
+}
+#endif /* USE_ZSTD */
+
 /*************************************************************************
  *                           ZLIB Compression                             *
  *************************************************************************/
@@ -1457,6 +1826,26 @@ static void Lz4CheckCompressedData(
     BufferHelperFree(&uncmprBuf);
 }
 
+#ifdef USE_ZSTD
+static void ZstdCheckCompressedData(_in_ const char* rawData, _in_ int rawDataSize, _in_ const char* cmprBuf,
+    _in_ int cmprBufSize, _in_ const ZstdDict* dict)
+{
+    ZstdWrapper zstd;
+    int uncmprSize = zstd.DecompressGetBound(cmprBuf, cmprBufSize);
+    Assert(uncmprSize > 0 && uncmprSize == rawDataSize);
+    Assert(ZstdWrapper::GetDictID(cmprBuf, cmprBufSize) == ((dict != NULL) ? dict->dictId : 0));
+
+    BufferHelper uncmprBuf = {NULL, 0, Unknown};
+    BufferHelperMalloc(&uncmprBuf, uncmprSize);
+
+    int realDataSize = zstd.Decompress(cmprBuf, uncmprBuf.buf, cmprBufSize, uncmprSize, dict);
+    Assert(realDataSize > 0 && realDataSize == rawDataSize);
+    Assert(memcmp(uncmprBuf.buf, rawData, rawDataSize) == 0);
+
+    BufferHelperFree(&uncmprBuf);
+}
+#endif
+
 static void ZlibCheckCompressedData(_in_ char* rawData, _in_ int rawDataSize, _in_ char* cmprBuf, _in_ int cmprBufSize)
 {
     BufferHelper uncmprBuf = {NULL, 0, Unknown};
@@ -42,7 +42,7 @@ extern int8 heaprel_get_compression_from_modes(int16 modes);
 #endif
 
 /* compress level table for different compression values */
-static const int8 compresslevel_tables[COMPRESS_HIGH + 1][REL_MAX_COMPRESSLEVEL + 1] = {
+static const int8 compresslevel_tables[CU_MAX_COMPRESSION + 1][REL_MAX_COMPRESSLEVEL + 1] = {
     /* COMPRESS_NO */
     {0, 0, 0, 0},
     /* COMPRESS_LOW :: LZ4 */
@@ -59,7 +59,15 @@ static const int8 compresslevel_tables[COMPRESS_HIGH + 1][REL_MAX_COMPRESSLEVEL
     {ZlibEncoder::zlib_recommend_level,
         ZlibEncoder::zlib_recommend_level + ZlibEncoder::zlib_level_step,
         ZlibEncoder::zlib_recommend_level + ZlibEncoder::zlib_level_step * 2,
-        ZlibEncoder::zlib_max_level}};
+        ZlibEncoder::zlib_max_level},
+#ifdef USE_ZSTD
+    /* COMPRESS_ZSTD :: ZSTD */
+    {ZstdWrapper::zstd_recommend_level,
+        ZstdWrapper::zstd_recommend_level + ZstdWrapper::zstd_level_step,
+        ZstdWrapper::zstd_recommend_level + ZstdWrapper::zstd_level_step * 2,
+        ZstdWrapper::zstd_recommend_level + ZstdWrapper::zstd_level_step * 3},
+#endif
+};
 
 // FUTURE CASE: add other types in ascending order
 // all types in this table needn't to compute the min/max value.
@@ -297,7 +305,7 @@ static FORCE_INLINE void swapBuf(char *&buf1, char *&buf2, int &sz1, int &sz2)
 }
 
 IntegerCoder::IntegerCoder(short valSize)
-    : m_adopt_rle(true), m_minVal(0), m_maxVal(0), m_isValid(false), m_eachValSize(valSize)
+    : m_adopt_rle(true), m_adopt_bitpack(true), m_minVal(0), m_maxVal(0), m_isValid(false), m_eachValSize(valSize)
 {}
 
 void IntegerCoder::SetMinMaxVal(int64 min, int64 max)
@@ -329,7 +337,7 @@ int IntegerCoder::CompressInner(const CompressionArg1& in, CompressionArg2& out)
     int8 compresslevel = heaprel_get_compresslevel_from_modes(in.mode);
 
     Assert(in.globalDict == NULL && in.useDict == false);
-    Assert(compression >= COMPRESS_LOW && compression <= COMPRESS_HIGH);
+    Assert(compression >= COMPRESS_LOW && compression <= CU_MAX_COMPRESSION);
     Assert((in.sz % this->m_eachValSize) == 0);
 
     Size boundSize = 0;
@@ -401,12 +409,36 @@ int IntegerCoder::CompressInner(const CompressionArg1& in, CompressionArg2& out)
         }
     }
 
-    // Step3: try to apply LZ4 or Zlib according to CompressLevel
+    // Step3: try to do BITPACK compression
+    // it stores the same differences as delta compression, but with just the bits needed
+    // instead of whole bytes. RLE isn't applied upon it, so it takes the place of both delta
+    // and RLE only when its result is smaller. min/max value is needed by both of them.
+    if (this->m_adopt_bitpack && BitpackCanBeApplied(this->m_minVal, this->m_maxVal)) {
+        BitpackCoder bitpack(this->m_minVal, this->m_maxVal);
+        int bitpackSize = bitpack.GetBound(in.sz / this->m_eachValSize);
+        int currSize = currInBufSize + ((out.modes & CU_DeltaCompressed) ? 0 : (this->m_eachValSize * 2));
+
+        if (bitpackSize + (this->m_eachValSize * 2) < currSize) {
+            Assert((Size)bitpackSize < tempOutBuf.bufSize);
+            cmprSize = bitpack.Compress(in.buf, tempOutBuf.buf, in.sz, tempOutBuf.bufSize, this->m_eachValSize);
+            Assert(cmprSize == bitpackSize);
+            rc = memcpy_s(out.buf, cmprSize, tempOutBuf.buf, cmprSize);
+            securec_check(rc, "", "");
+            out.sz = cmprSize;
+            out.modes = (out.modes & ~CU_RLECompressed) | CU_DeltaCompressed | CU_BitpackCompressed;
+
+            currInBuf = out.buf;
+            currInBufSize = cmprSize;
+        }
+    }
+
+    // Step4: try to apply LZ4, Zlib or Zstd according to CompressLevel
     // Apply different compression method for compressionLevel
-    // COMPRESS_LOW:    delta compression | RleCoder
-    // COMPRESS_MIDDLE: delta compression | RleCoder | LZ4
-    // COMPRESS_HIGH:   delta compression | RleCoder | Zlib
-    // We can skip LZ4/Zlib compression when level is COMPRESS_MIDDLE or COMPRESS_HIGH
+    // COMPRESS_LOW:    delta compression | RleCoder, or bitpack compression
+    // COMPRESS_MIDDLE: delta compression | RleCoder, or bitpack compression | LZ4
+    // COMPRESS_HIGH:   delta compression | RleCoder, or bitpack compression | Zlib
+    // COMPRESS_ZSTD:   delta compression | RleCoder, or bitpack compression | Zstd
+    // We can skip LZ4/Zlib/Zstd compression when level is COMPRESS_LOW
     if (compression == COMPRESS_LOW) {
         BufferHelperFree(&tempOutBuf);
 
@@ -447,6 +479,17 @@ int IntegerCoder::CompressInner(const CompressionArg1& in, CompressionArg2& out)
             cmprSize = 0;
         }
     }
+#ifdef USE_ZSTD
+    else if (compression == COMPRESS_ZSTD) {
+        ZstdWrapper zstd;
+        zstd.SetCompressionLevel(compresslevel_tables[compression][compresslevel]);
+        boundSize = zstd.CompressGetBound(currInBufSize);
+        if (boundSize > tempOutBuf.bufSize) {
+            BufferHelperRemalloc(&tempOutBuf, boundSize);
+        }
+        cmprSize = zstd.Compress(currInBuf, tempOutBuf.buf, currInBufSize, (int)tempOutBuf.bufSize);
+    }
+#endif
 
     // if cmprSize is 0, we have to read data from input buffer.
     // if cmprSize > 0, check whether compression make benefits.
@@ -456,7 +499,13 @@ int IntegerCoder::CompressInner(const CompressionArg1& in, CompressionArg2& out)
         rc = memcpy_s(out.buf, cmprSize, tempOutBuf.buf, cmprSize);
         securec_check(rc, "", "");
         out.sz = cmprSize;
-        out.modes |= ((compression == COMPRESS_MIDDLE) ? CU_LzCompressed : CU_ZlibCompressed);
+        if (compression == COMPRESS_MIDDLE) {
+            out.modes |= CU_LzCompressed;
+        } else if (compression == COMPRESS_HIGH) {
+            out.modes |= CU_ZlibCompressed;
+        } else {
+            out.modes |= CU_ZstdCompressed;
+        }
     }
 
     BufferHelperFree(&tempOutBuf);
@@ -529,7 +578,25 @@ int IntegerCoder::Decompress(_in_ const CompressionArg2& in, _out_ CompressionAr
     // but first, the two buffers must be set rightly.
     bool preparedOk = false;
 
-    if ((modes & CU_LzCompressed) != 0) {
+    if (CUIsZstdCompressed(modes)) {
+#ifdef USE_ZSTD
+        ZstdWrapper zstdDecoder;
+        Assert(zstdDecoder.DecompressGetBound(nextInBuf, nextInSize) > 0 &&
+               zstdDecoder.DecompressGetBound(nextInBuf, nextInSize) <= out.sz);
+        nextOutSize = zstdDecoder.Decompress(nextInBuf, nextOutBuf, nextInSize, out.sz);
+        if (nextOutSize <= 0) {
+            // zstd only fails when the frame is broken
+            BufferHelperFree(&tmpBuf);
+            return -1;
+        }
+
+        // prepare input buffer and output buffer for the next compression method
+        prepareSwapBuf(nextInBuf, nextOutBuf, nextInSize, nextOutSize, tmpBuf.buf, out.sz, preparedOk);
+#else
+        BufferHelperFree(&tmpBuf);
+        NO_ZSTD_SUPPORT();
+#endif
+    } else if ((modes & CU_LzCompressed) != 0) {
         // either LZ4 or ZLIB compression is applied to INTEGER data.
         Assert(0 == (modes & CU_ZlibCompressed));
 
@@ -578,7 +645,24 @@ int IntegerCoder::Decompress(_in_ const CompressionArg2& in, _out_ CompressionAr
         }
     }
 
-    if ((modes & CU_DeltaCompressed) != 0) {
+    if ((modes & CU_BitpackCompressed) != 0) {
+        // bitpack compression remembers the differences from the min value, and adds it back
+        // while unpacking. so it takes the place of delta decompression.
+        Assert((modes & CU_DeltaCompressed) != 0 && (modes & CU_RLECompressed) == 0);
+
+        BitpackCoder bitpack(m_minVal, m_maxVal);
+        nextOutSize = bitpack.Decompress(nextInBuf, nextOutBuf, nextInSize, out.sz, m_eachValSize);
+        if (unlikely(nextOutSize != out.sz)) {
+            BufferHelperFree(&tmpBuf);
+            return 0;
+        }
+
+        if (preparedOk) {
+            swapBuf(nextInBuf, nextOutBuf, nextInSize, nextOutSize);
+        } else {
+            prepareSwapBuf(nextInBuf, nextOutBuf, nextInSize, nextOutSize, tmpBuf.buf, out.sz, preparedOk);
+        }
+    } else if ((modes & CU_DeltaCompressed) != 0) {
         DeltaCoder delta(m_minVal, m_eachValSize, false);
         nextOutSize = delta.Decompress(nextInBuf, nextOutBuf, nextInSize, out.sz, inValSize);
         Assert(nextOutSize > nextInSize && nextOutSize <= out.sz);
@@ -627,6 +711,8 @@ int StringCoder::CompressNumbers(
     intCoder.SetMinMaxVal(0, max);
     /* input a hint about RLE encoding */
     intCoder.m_adopt_rle = m_adopt_rle;
+    /* bit packing needs the number of values, which DecompressNumbers() doesn't know */
+    intCoder.m_adopt_bitpack = false;
     int cmprSize = intCoder.Compress(input, output);
     if (cmprSize > 0) {
         // compress successfull, and set the compression mode.
@@ -677,7 +763,7 @@ template <bool adopt_dict>
 int StringCoder::CompressInner(CompressionArg1& in, CompressionArg2& out)
 {
     Assert(heaprel_get_compression_from_modes(in.mode) >= COMPRESS_LOW);
-    Assert(heaprel_get_compression_from_modes(in.mode) <= COMPRESS_HIGH);
+    Assert(heaprel_get_compression_from_modes(in.mode) <= CU_MAX_COMPRESSION);
     Assert((in.buildGlobalDict && in.globalDict != NULL) || // case 1: to build global dictionary
         (in.useGlobalDict && in.globalDict != NULL) ||      // case 2: to compress by global dictionary
         (in.useDict && !in.useGlobalDict) ||                // case 3: to compress by local dictionary
@@ -750,7 +836,7 @@ int StringCoder::CompressInner(CompressionArg1& in, CompressionArg2& out)
 template int StringCoder::CompressInner<true>(CompressionArg1&, CompressionArg2&);
 template int StringCoder::CompressInner<false>(CompressionArg1&, CompressionArg2&);
 
-// compress directly using zlib/lz4 methods
+// compress directly using zlib/lz4/zstd methods
 int StringCoder::CompressWithoutDict(_in_ char* inBuf, _in_ int inBufSize, _in_ int compressing_modes,
     _out_ char* outBuf, _in_ int outBufSize, _out_ int& mode)
 {
@@ -795,6 +881,22 @@ int StringCoder::CompressWithoutDict(_in_ char* inBuf, _in_ int inBufSize, _in_
         outSize = lz4.Compress(inBuf, tempOutBuf.buf, inBufSize);
         tempMode = CU_LzCompressed;
     }
+#ifdef USE_ZSTD
+    else if (compression == COMPRESS_ZSTD) {
+        ZstdWrapper zstd;
+        zstd.SetCompressionLevel(compresslevel_tables[compression][compresslevel]);
+
+        boundSize = zstd.CompressGetBound(inBufSize);
+        if (boundSize <= outBufSize) {
+            tempOutBuf.buf = outBuf;
+            tempOutBuf.bufSize = outBufSize;
+        } else {
+            BufferHelperMalloc(&tempOutBuf, boundSize);
+        }
+        outSize = zstd.Compress(inBuf, tempOutBuf.buf, inBufSize, (int)tempOutBuf.bufSize, m_zstd_dict);
+        tempMode = CU_ZstdCompressed;
+    }
+#endif
 
     // compress successfully, compressed data' size is returned.
     // rewrite the compressed data into output buffer if necessary.
@@ -817,7 +919,32 @@ int StringCoder::DecompressWithoutDict(
     _in_ char* inBuf, _in_ int inBufSize, _in_ uint16 mode, _out_ char* outBuf, _out_ int outBufSize)
 {
     int outSize = 0;
-    if (mode & CU_ZlibCompressed) {
+    if (CUIsZstdCompressed(mode)) {
+#ifdef USE_ZSTD
+        ZstdWrapper zstdDecoder;
+        Assert(zstdDecoder.DecompressGetBound(inBuf, inBufSize) > 0 &&
+               zstdDecoder.DecompressGetBound(inBuf, inBufSize) <= outBufSize);
+
+        // the frame records the id of the column dictionary it's compressed with
+        const ZstdDict* dict = NULL;
+        uint32 dictId = ZstdWrapper::GetDictID(inBuf, inBufSize);
+        if (dictId != 0) {
+            dict = ZstdDictSetLookup(m_zstd_dicts, dictId);
+            if (dict == NULL) {
+                ereport(ERROR,
+                    (errcode(ERRCODE_DATA_CORRUPTED),
+                        errmsg("zstd dictionary %u of the CU is not found", dictId)));
+            }
+        }
+        outSize = zstdDecoder.Decompress(inBuf, outBuf, inBufSize, outBufSize, dict);
+        if (outSize <= 0) {
+            // zstd only fails when the frame is broken
+            return -1;
+        }
+#else
+        NO_ZSTD_SUPPORT();
+#endif
+    } else if (mode & CU_ZlibCompressed) {
         Assert((mode & CU_LzCompressed) == 0);
 
         ZlibDecoder zlibDecoder;
@@ -852,11 +979,12 @@ int StringCoder::Decompress(_in_ const CompressionArg2& in, _out_ CompressionArg
     // case 2: dictionary method is first applied to, so read and parse the dictionary
     DicCoder* dict = New(CurrentMemoryContext) DicCoder(in.buf);
     DictHeader* dictHeader = dict->GetHeader();
+    m_dicItemsNum = (int)dictHeader->m_itemsCount;
     DecompressNumbers(in.buf + dictHeader->m_totalSize, in.sz - dictHeader->m_totalSize, in.modes, out.buf, out.sz);
     int outSize = dict->Decompress((char*)m_dicCodes, m_dicCodesNum * sizeof(DicCodeType), out.buf, out.sz);
     delete dict;
 
-    if (m_dicCodes) {
+    if (m_dicCodes && !m_keep_dic_codes) {
         pfree(m_dicCodes);
         m_dicCodes = NULL;
     }
@@ -864,6 +992,16 @@ int StringCoder::Decompress(_in_ const CompressionArg2& in, _out_ CompressionArg
     return outSize;
 }
 
+DicCodeType* StringCoder::TakeDicCodes(_out_ int* codesNum, _out_ int* itemsNum)
+{
+    DicCodeType* codes = m_dicCodes;
+
+    *codesNum = (codes != NULL) ? (int)m_dicCodesNum : 0;
+    *itemsNum = (codes != NULL) ? m_dicItemsNum : 0;
+    m_dicCodes = NULL;
+    return codes;
+}
+
 ///
 /// DeltaPlusRLEv2 Implements
 ///
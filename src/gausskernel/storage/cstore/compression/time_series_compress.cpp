@@ -58,7 +58,7 @@ static const Delta2KeyMap g_keyMap[DELTA2_KEY_MAX + 1] = {{0, 0, 0x1, 0x0},
     {0xFFFFFFFFFFFF, 0xFFFFFFFFFFFFFF, 0x7, 0x7},
     {0xFFFFFFFFFFFFFF, 0x7FFFFFFFFFFFFFFF, 0x8, 0x8}};
 
-static const int8 g_compresslevel_tables[COMPRESS_HIGH + 1][MAX_COMPRESSLEVEL + 1] = {
+static const int8 g_compresslevel_tables[CU_MAX_COMPRESSION + 1][MAX_COMPRESSLEVEL + 1] = {
     /* COMPRESS_NO */
     {0, 0, 0, 0},
     /* COMPRESS_LOW :: LZ4 */
@@ -75,7 +75,15 @@ static const int8 g_compresslevel_tables[COMPRESS_HIGH + 1][MAX_COMPRESSLEVEL +
     {ZlibEncoder::zlib_recommend_level,
         ZlibEncoder::zlib_recommend_level + ZlibEncoder::zlib_level_step,
         ZlibEncoder::zlib_recommend_level + ZlibEncoder::zlib_level_step * LZ4_STEP,
-        ZlibEncoder::zlib_max_level}};
+        ZlibEncoder::zlib_max_level},
+#ifdef USE_ZSTD
+    /* COMPRESS_ZSTD :: ZSTD */
+    {ZstdWrapper::zstd_recommend_level,
+        ZstdWrapper::zstd_recommend_level + ZstdWrapper::zstd_level_step,
+        ZstdWrapper::zstd_recommend_level + ZstdWrapper::zstd_level_step * LZ4_STEP,
+        ZstdWrapper::zstd_recommend_level + ZstdWrapper::zstd_level_step * MAX_COMPRESSLEVEL},
+#endif
+};
 
 static FORCE_INLINE void prepare_swap_buf(
     char*& buf1, char*& buf2, int& sz1, int& sz2, char* newbuf2, int newsz2, bool& prepared)
@@ -332,6 +340,20 @@ int SequenceCodec::zlib_compress(
     return (done == false ? 0 : compress_size);
 }
 
+#ifdef USE_ZSTD
+int SequenceCodec::zstd_compress(
+    int8 compression, int8 compress_level, Size bound_size, BufferHelper* tmpOutBuf, _out_ CompressionArg2& out)
+{
+    ZstdWrapper zstd;
+    zstd.SetCompressionLevel(g_compresslevel_tables[compression][compress_level]);
+    bound_size = zstd.CompressGetBound(out.sz);
+    if (bound_size > tmpOutBuf->bufSize) {
+        BufferHelperRemalloc(tmpOutBuf, bound_size);
+    }
+    return zstd.Compress(out.buf, tmpOutBuf->buf, out.sz, (int)tmpOutBuf->bufSize);
+}
+#endif
+
 /**
  * @time_series_compress.cpp
  * @Description: Do Sequence compression
@@ -349,7 +371,7 @@ int SequenceCodec::compress(_in_ const CompressionArg1& in, _out_ CompressionArg
         return -1;
     }
     Assert(compression >= COMPRESS_LOW);
-    Assert(compression <= COMPRESS_HIGH);
+    Assert(compression <= CU_MAX_COMPRESSION);
     Assert((in.sz % this->value_size) == 0);
 
     ereport(DEBUG1,
@@ -390,13 +412,24 @@ int SequenceCodec::compress(_in_ const CompressionArg1& in, _out_ CompressionArg
     } else if (COMPRESS_HIGH == compression) {
         compress_size = zlib_compress(compression, compress_level, bound_size, &tmpOutBuf, out);
     }
+#ifdef USE_ZSTD
+    else if (COMPRESS_ZSTD == compression) {
+        compress_size = zstd_compress(compression, compress_level, bound_size, &tmpOutBuf, out);
+    }
+#endif
     if (compress_size > 0 && compress_size < out.sz) {
         rc = memset_s(out.buf, out.sz, 0, out.sz);
         securec_check(rc, "", "");
         rc = memcpy_s(out.buf, out.sz, tmpOutBuf.buf, compress_size);
         securec_check(rc, "", "");
         out.sz = compress_size;
-        out.modes |= ((COMPRESS_MIDDLE == compression) ? CU_LzCompressed : CU_ZlibCompressed);
+        if (COMPRESS_MIDDLE == compression) {
+            out.modes |= CU_LzCompressed;
+        } else if (COMPRESS_HIGH == compression) {
+            out.modes |= CU_ZlibCompressed;
+        } else {
+            out.modes |= CU_ZstdCompressed;
+        }
     }
 
     BufferHelperFree(&tmpOutBuf);
@@ -421,7 +454,22 @@ int SequenceCodec::decompress(_in_ const CompressionArg2& in, _out_ CompressionA
     int next_in_size = in.sz;
     bool is_prepared = false;
 
-    if (0 != (in.modes & CU_LzCompressed)) {
+    if (CUIsZstdCompressed(in.modes)) {
+#ifdef USE_ZSTD
+        ZstdWrapper zstdDecoder;
+        Assert(zstdDecoder.DecompressGetBound(next_in_buf, next_in_size) > 0 &&
+               zstdDecoder.DecompressGetBound(next_in_buf, next_in_size) <= out.sz);
+        next_out_size = zstdDecoder.Decompress(next_in_buf, next_out_buf, next_in_size, out.sz);
+        if (next_out_size <= 0) {
+            BufferHelperFree(&tmpBuf);
+            return -1;
+        }
+        prepare_swap_buf(next_in_buf, next_out_buf, next_in_size, next_out_size, tmpBuf.buf, out.sz, is_prepared);
+#else
+        BufferHelperFree(&tmpBuf);
+        NO_ZSTD_SUPPORT();
+#endif
+    } else if (0 != (in.modes & CU_LzCompressed)) {
         LZ4Wrapper lzDecoder;
         Assert(lzDecoder.DecompressGetBound(next_in_buf) > 0 && lzDecoder.DecompressGetBound(next_in_buf) <= out.sz);
         next_out_size = lzDecoder.Decompress(next_in_buf, next_out_buf, next_in_size);
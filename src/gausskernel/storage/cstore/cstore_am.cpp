@@ -35,6 +35,7 @@
 #include "utils/datum.h"
 #include "utils/relcache.h"
 #include "pgstat.h"
+#include "catalog/pg_proc.h"
 #include "catalog/pg_type.h"
 #include "access/cstore_am.h"
 #include "storage/custorage.h"
@@ -47,8 +48,11 @@
 #include "storage/cstore_compress.h"
 #include "utils/tqual.h"
 #include "access/sysattr.h"
+#include "executor/executor.h"
 #include "executor/instrument.h"
+#include "utils/array.h"
 #include "utils/date.h"
+#include "utils/lsyscache.h"
 #include "utils/rel.h"
 #include "utils/rel_gs.h"
 #include "access/heapam.h"
@@ -113,6 +117,12 @@ CStore::CStore()
       m_load_finish(false),
       m_scanPosInCU(NULL),
       m_RCFuncs(NULL),
+      m_RTFilters(NULL),
+      m_RTFilterNum(0),
+      m_dictFilters(NULL),
+      m_dictFilterNum(0),
+      m_dictFilterCUId(InValidCUID),
+      m_zstdDicts(NULL),
       m_fillVectorByTids(NULL),
       m_fillVectorLateRead(NULL),
       m_colFillFunArrary(NULL),
@@ -313,6 +323,140 @@ void CStore::InitRoughCheckEnv(CStoreScanState* state)
             m_RCFuncs[i] = GetRoughCheckFunc(attrs[colIdx]->atttypid, scanKey[i].cs_strategy, scanKey[i].cs_collation);
         }
     }
+
+    // Initialize min/max check of runtime join filters on accessed columns
+    Plan* plan = state->ps.plan;
+    if (plan->var_list != NIL) {
+        ListCell* lc1 = NULL;
+        ListCell* lc2 = NULL;
+
+        m_RTFilters = (RuntimeFilterRCInfo*)palloc(sizeof(RuntimeFilterRCInfo) * list_length(plan->var_list));
+        forboth(lc1, plan->var_list, lc2, plan->filterIndexList) {
+            Var* var = (Var*)lfirst(lc1);
+
+            for (int seq = 0; seq < m_colNum; seq++) {
+                if (m_colId[seq] == var->varattno - 1) {
+                    RuntimeFilterRCInfo* rtf = &m_RTFilters[m_RTFilterNum++];
+                    rtf->var = var;
+                    rtf->bfIndex = lfirst_int(lc2);
+                    rtf->seq = seq;
+                    rtf->geFunc = GetRoughCheckFunc(var->vartype, CStoreGreaterEqualStrategyNumber, var->varcollid);
+                    rtf->leFunc = GetRoughCheckFunc(var->vartype, CStoreLessEqualStrategyNumber, var->varcollid);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/*
+ * @Description: get the column of a dictionary filter operand
+ * @Param[IN] node: operand of the qual
+ * @Return: the Var, or NULL if the operand isn't a user column
+ */
+static Var* GetDictFilterVar(Node* node)
+{
+    if (node != NULL && IsA(node, RelabelType))
+        node = (Node*)((RelabelType*)node)->arg;
+    if (node != NULL && IsA(node, Var) && ((Var*)node)->varattno > 0)
+        return (Var*)node;
+    return NULL;
+}
+
+void CStore::InitDictFilterEnv(CStoreScanState* state)
+{
+    List* quals = state->ps.plan->qual;
+    if (quals == NIL || m_colNum == 0)
+        return;
+
+    // the following spaces will live until deconstructor is called.
+    // so use m_scanMemContext which is not freed at all until the end.
+    AutoContextSwitch newMemCnxt(m_scanMemContext);
+
+    Form_pg_attribute* attrs = m_relation->rd_att->attrs;
+    ListCell* lc = NULL;
+
+    m_dictFilters = (DictFilterInfo*)palloc(sizeof(DictFilterInfo) * list_length(quals));
+    foreach (lc, quals) {
+        Node* clause = (Node*)lfirst(lc);
+        Var* var = NULL;
+        Const* con = NULL;
+        Oid opfuncid = InvalidOid;
+        Oid collation = InvalidOid;
+        bool constFirst = false;
+        bool isArray = false;
+
+        if (IsA(clause, OpExpr) && list_length(((OpExpr*)clause)->args) == 2) {
+            OpExpr* op = (OpExpr*)clause;
+            Node* leftop = (Node*)linitial(op->args);
+            Node* rightop = (Node*)lsecond(op->args);
+
+            var = GetDictFilterVar(leftop);
+            if (var == NULL) {
+                var = GetDictFilterVar(rightop);
+                rightop = leftop;
+                constFirst = true;
+            }
+            if (rightop != NULL && IsA(rightop, Const))
+                con = (Const*)rightop;
+            opfuncid = op->opfuncid;
+            collation = op->inputcollid;
+        } else if (IsA(clause, ScalarArrayOpExpr) && ((ScalarArrayOpExpr*)clause)->useOr) {
+            ScalarArrayOpExpr* saop = (ScalarArrayOpExpr*)clause;
+            Node* rightop = (Node*)lsecond(saop->args);
+
+            var = GetDictFilterVar((Node*)linitial(saop->args));
+            if (rightop != NULL && IsA(rightop, Const))
+                con = (Const*)rightop;
+            opfuncid = saop->opfuncid;
+            collation = saop->inputcollid;
+            isArray = true;
+        }
+
+        // rows whose column is NULL are rejected without calling the operator,
+        // so only strict operators whose result is stable within the scan qualify.
+        if (var == NULL || con == NULL || con->constisnull || !OidIsValid(opfuncid) ||
+            attrs[var->varattno - 1]->attlen != -1 || !func_strict(opfuncid) ||
+            func_volatile(opfuncid) == PROVOLATILE_VOLATILE)
+            continue;
+
+        int seq = 0;
+        while (seq < m_colNum && m_colId[seq] != var->varattno - 1)
+            seq++;
+        if (seq == m_colNum)
+            continue;
+
+        DictFilterInfo* filter = &m_dictFilters[m_dictFilterNum];
+        filter->seq = seq;
+        fmgr_info(opfuncid, &filter->opFunc);
+        filter->collation = collation;
+        filter->constFirst = constFirst;
+        if (!isArray) {
+            filter->args = (Datum*)palloc(sizeof(Datum));
+            filter->args[0] = con->constvalue;
+            filter->nargs = 1;
+        } else {
+            ArrayType* arr = DatumGetArrayTypeP(con->constvalue);
+            int16 elmlen;
+            bool elmbyval = false;
+            char elmalign;
+            Datum* elems = NULL;
+            bool* nulls = NULL;
+            int nelems = 0;
+
+            get_typlenbyvalalign(ARR_ELEMTYPE(arr), &elmlen, &elmbyval, &elmalign);
+            deconstruct_array(arr, ARR_ELEMTYPE(arr), elmlen, elmbyval, elmalign, &elems, &nulls, &nelems);
+
+            // NULL elements never make "column = ANY(array)" true
+            filter->args = (Datum*)palloc(sizeof(Datum) * Max(nelems, 1));
+            filter->nargs = 0;
+            for (int i = 0; i < nelems; i++) {
+                if (!nulls[i])
+                    filter->args[filter->nargs++] = elems[i];
+            }
+        }
+        m_dictFilterNum++;
+    }
 }
 
 void CStore::InitScan(CStoreScanState* state, Snapshot snapshot)
@@ -374,6 +518,8 @@ void CStore::InitScan(CStoreScanState* state, Snapshot snapshot)
 
     InitRoughCheckEnv(state);
 
+    InitDictFilterEnv(state);
+
     /* remember node id of this plan */
     m_plan_node_id = state->ps.plan->plan_node_id;
 }
@@ -391,6 +537,9 @@ CStore::~CStore()
     m_CUDescInfo = NULL;
     m_perScanMemCnxt = NULL;
     m_RCFuncs = NULL;
+    m_RTFilters = NULL;
+    m_dictFilters = NULL;
+    m_zstdDicts = NULL;
     m_CUDescIdx = NULL;
     m_colFillFunArrary = NULL;
     m_cuStorage = NULL;
@@ -878,7 +1027,9 @@ void CStore::CStoreScan(_in_ CStoreScanState* state, _out_ VectorBatch* vecBatch
     ADIO_END();
 
     // step4: Fill VecBatch
+    // rows rejected by the dictionary filters are skipped like deleted rows
     CSTORESCAN_TRACE_START(FILL_BATCH);
+    ApplyDictFiltersIfNeed(m_CUDescIdx[m_cursor]);
     int deadRows = FillVecBatch(vecBatchOut);
     CSTORESCAN_TRACE_END(FILL_BATCH);
 
@@ -1174,6 +1325,32 @@ bool CStore::RoughCheck(CStoreScanKey scanKey, int nkeys, int cuDescIdx)
     return hitCU;
 }
 
+/*
+ * @Description: check a CU against the min/max of the runtime join filters built so far
+ * @Param[IN] state: cstore scan state
+ * @Param[IN] cuDescIdx: index of load cudesc info
+ * @Return: true--hit, false--not hit
+ */
+bool CStore::RoughCheckRuntimeFilters(CStoreScanState* state, int cuDescIdx)
+{
+    for (int j = 0; j < m_RTFilterNum; j++) {
+        RuntimeFilterRCInfo* rtf = &m_RTFilters[j];
+        filter::BloomFilter* bf = ExecGetRuntimeFilter(state->ps.state, rtf->var, rtf->bfIndex);
+        if (bf == NULL || !bf->hasMinMax())
+            continue;
+
+        CUDesc* cudesc = &(m_CUDescInfo[rtf->seq]->cuDescArray[cuDescIdx]);
+        // NULL never joins, so a CU of NULLs only can not match either
+        if (cudesc->IsNullCU())
+            return false;
+        if (cudesc->IsNoMinMaxCU())
+            continue;
+        if (!rtf->geFunc(cudesc, bf->getMin()) || !rtf->leFunc(cudesc, bf->getMax()))
+            return false;
+    }
+    return true;
+}
+
 void CStore::RoughCheckIfNeed(_in_ CStoreScanState* state)
 {
     int nkeys = state->csss_NumScanKeys;
@@ -1188,7 +1365,7 @@ void CStore::RoughCheckIfNeed(_in_ CStoreScanState* state)
         return;
     }
 
-    if (likely(nkeys == 0 || scanKey == NULL || m_colNum == 0)) {
+    if (likely(((nkeys == 0 || scanKey == NULL) && m_RTFilterNum == 0) || m_colNum == 0)) {
         /* when no where condition, we also need set m_lastNumCUDescIdx and m_NumCUDescIdx for prefetch once */
         ADIO_RUN()
         {
@@ -1214,7 +1391,7 @@ void CStore::RoughCheckIfNeed(_in_ CStoreScanState* state)
     lastLoadNum = m_CUDescInfo[0]->lastLoadNum;
     curLoadNum = m_CUDescInfo[0]->curLoadNum;
     for (int i = (int)lastLoadNum; i != (int)curLoadNum; IncLoadCuDescIdx(i), IncLoadCuDescIdx(cudesc_idx_tmp)) {
-        hitCU = RoughCheck(scanKey, nkeys, i);
+        hitCU = (scanKey == NULL || RoughCheck(scanKey, nkeys, i)) && RoughCheckRuntimeFilters(state, i);
         if (hitCU) {
             // fliter CU not hit
             ADIO_RUN()
@@ -1261,6 +1438,109 @@ void CStore::RoughCheckIfNeed(_in_ CStoreScanState* state)
     m_needRCheck = false;
 }
 
+/*
+ * @Description: does an item of a dictionary encoded CU pass a dictionary filter
+ * @Param[IN] opFunc/collation/constFirst: the operator and how to call it
+ * @Param[IN] args/nargs: the const operands, any of them may match
+ * @Param[IN] value: the dictionary item
+ * @Return: true--pass, false--rejected
+ */
+static bool DictFilterPass(const FmgrInfo* opFunc, Oid collation, bool constFirst, const Datum* args, int nargs,
+    Datum value)
+{
+    for (int i = 0; i < nargs; i++) {
+        Datum result = constFirst ? FunctionCall2Coll((FmgrInfo*)opFunc, collation, args[i], value)
+                                  : FunctionCall2Coll((FmgrInfo*)opFunc, collation, value, args[i]);
+        if (DatumGetBool(result))
+            return true;
+    }
+    return false;
+}
+
+/*
+ * @Description: mask out the rows of the current CU rejected by the dictionary
+ *     filters. Each filter is evaluated once per dictionary item of the CU and
+ *     the rows are looked up by their codes, so neither the evaluation nor the
+ *     materialization is paid for rows which can't qualify. It's only a
+ *     prefilter, the quals still run on the rows left.
+ * @Param[IN] cuDescIdx: index of load cudesc info
+ * @See also: InitDictFilterEnv
+ */
+void CStore::ApplyDictFiltersIfNeed(int cuDescIdx)
+{
+    if (likely(m_dictFilterNum == 0))
+        return;
+
+    uint32 cuid = m_CUDescInfo[0]->cuDescArray[cuDescIdx].cu_id;
+    if (m_dictFilterCUId == cuid)
+        return;
+    m_dictFilterCUId = cuid;
+
+    GetCUDeleteMaskIfNeed(cuid, m_snapshot);
+
+    // the delete mask is reloaded for every batch, so the rows masked out
+    // here would be lost again
+    if (m_delMaskCUId != cuid)
+        return;
+
+    AutoContextSwitch newMemCnxt(m_perScanMemCnxt);
+
+    for (int i = 0; i < m_dictFilterNum; i++) {
+        DictFilterInfo* filter = &m_dictFilters[i];
+        CUDesc* cuDescPtr = m_CUDescInfo[filter->seq]->cuDescArray + cuDescIdx;
+        int rowCount = cuDescPtr->row_count;
+
+        // NULL CU and the same value CU are not stored, rough check covers them
+        if (cuDescPtr->IsNullCU() || cuDescPtr->IsSameValCU())
+            continue;
+
+        int colIdx = m_colId[filter->seq];
+        int slotId = CACHE_BLOCK_INVALID_IDX;
+        CU* cuPtr = GetCUData(cuDescPtr, colIdx, m_relation->rd_att->attrs[colIdx]->attlen, slotId);
+
+        if (cuPtr->m_dicCodes != NULL) {
+            // 0: not evaluated yet, 1: passes, 2: rejected
+            uint8* itemResults = (uint8*)palloc0(cuPtr->m_dicItemsNum);
+            bool masked = false;
+
+            if (!m_hasDeadRow) {
+                errno_t rc = memset_s(m_cuDelMask, MaxDelBitmapSize, 0, MaxDelBitmapSize);
+                securec_check(rc, "", "");
+            }
+
+            for (int row = 0; row < rowCount; row++) {
+                if ((m_cuDelMask[row >> 3] & (1 << (row % 8))) != 0)
+                    continue;
+
+                // NULL rows hold m_dicItemsNum, strict operators never pass them
+                int code = cuPtr->m_dicCodes[row];
+                if (code < cuPtr->m_dicItemsNum) {
+                    if (itemResults[code] == 0) {
+                        Datum item = PointerGetDatum(cuPtr->m_srcData + cuPtr->m_offset[row]);
+                        itemResults[code] =
+                            DictFilterPass(&filter->opFunc, filter->collation, filter->constFirst, filter->args,
+                                filter->nargs, item) ? 1 : 2;
+                    }
+                    if (itemResults[code] == 1)
+                        continue;
+                }
+
+                m_cuDelMask[row >> 3] |= (1 << (row % 8));
+                masked = true;
+            }
+
+            m_hasDeadRow = m_hasDeadRow || masked;
+            pfree(itemResults);
+        }
+
+        if (IsValidCacheSlotID(slotId)) {
+            // CU is pinned
+            CUCache->UnPinDataBlock(slotId);
+        } else
+            Assert(false);
+    }
+}
+
 void CStore::InitReScan()
 {
     /* Set scan cu range */
@@ -1279,6 +1559,7 @@ void CStore::InitReScan()
     }
 
     m_delMaskCUId = InValidCUID;
+    m_dictFilterCUId = InValidCUID;
     m_hasDeadRow = false;
     m_prefetch_quantity = 0;
 
@@ -1333,6 +1614,12 @@ void CStore::InitPartReScan(Relation rel)
         // Here we must use physical column id
         CFileNode cFileNode(m_relation->rd_node, m_relation->rd_att->attrs[i]->attnum, MAIN_FORKNUM);
         m_cuStorage[i] = New(CurrentMemoryContext) CUStorage(cFileNode);
+
+        // the new partition has its own zstd dictionaries.
+        if (m_zstdDicts != NULL && m_zstdDicts[i] != NULL) {
+            FreeZstdDicts(m_zstdDicts[i]);
+            m_zstdDicts[i] = NULL;
+        }
     }
 }
 
@@ -1930,6 +2217,119 @@ void CStore::SaveVCCUDesc(Oid cudescOid, uint32 cuId, int rowCount, uint32 magic
     }
 }
 
+// Save the zstd dictionary trained for column attnum. The dictionary id goes
+// into cu_id, so that the unique index of CUDesc table rejects a duplicate.
+void CStore::SaveZstdDict(Relation rel, int attnum, const ZstdDict* dict)
+{
+    Relation cudescHeapRel = heap_open(rel->rd_rel->relcudescrelid, RowExclusiveLock);
+    Relation cudescIndexRel = index_open(cudescHeapRel->rd_rel->relcudescidx, RowExclusiveLock);
+    TupleDesc tupdesc = RelationGetDescr(cudescHeapRel);
+
+    Datum values[CUDescMaxAttrNum];
+    bool nulls[CUDescMaxAttrNum];
+
+    errno_t rc = memset_s(nulls, CUDescMaxAttrNum, true, CUDescMaxAttrNum);
+    securec_check(rc, "\0", "\0");
+
+    values[CUDescColIDAttr - 1] = Int32GetDatum(ZstdDictColID(attnum));
+    nulls[CUDescColIDAttr - 1] = false;
+
+    values[CUDescCUIDAttr - 1] = UInt32GetDatum(dict->dictId);
+    nulls[CUDescCUIDAttr - 1] = false;
+
+    values[CUDescSizeAttr - 1] = Int32GetDatum(dict->size);
+    nulls[CUDescSizeAttr - 1] = false;
+
+    values[CUDescCUMagicAttr - 1] = UInt32GetDatum((uint32)GetCurrentTransactionId());
+    nulls[CUDescCUMagicAttr - 1] = false;
+
+    text* dictData = cstring_to_text_with_len(dict->data, dict->size);
+    values[CUDescCUPointerAttr - 1] = PointerGetDatum(dictData);
+    nulls[CUDescCUPointerAttr - 1] = false;
+
+    HeapTuple tup = heap_form_tuple(tupdesc, values, nulls);
+
+    // We always generate xlog for cudesc tuple
+    heap_insert(cudescHeapRel, tup, GetCurrentCommandId(true), 0, NULL);
+    (void)index_insert(cudescIndexRel,
+        values,
+        nulls,
+        &(tup->t_self),
+        cudescHeapRel,
+        cudescIndexRel->rd_index->indisunique ? UNIQUE_CHECK_YES : UNIQUE_CHECK_NO);
+
+    heap_freetuple(tup);
+    tup = NULL;
+
+    index_close(cudescIndexRel, RowExclusiveLock);
+    heap_close(cudescHeapRel, RowExclusiveLock);
+
+    pfree_ext(dictData);
+}
+
+// Load all the zstd dictionaries of column attnum, in the order of their ids.
+// SnapshotSelf lets an inserter find the dictionary it has just saved, and a
+// reader the dictionary of every committed CU. A dictionary is never updated,
+// and it's deleted only together with its column.
+ZstdDictSet* CStore::LoadZstdDicts(Relation rel, int attnum)
+{
+    Relation cudescHeapRel = heap_open(rel->rd_rel->relcudescrelid, AccessShareLock);
+    TupleDesc cudescTupDesc = RelationGetDescr(cudescHeapRel);
+    Relation cudescIndexRel = index_open(cudescHeapRel->rd_rel->relcudescidx, AccessShareLock);
+    ZstdDictSet* dictSet = (ZstdDictSet*)palloc0(sizeof(ZstdDictSet));
+    int maxDicts = 0;
+
+    ScanKeyData key;
+    ScanKeyInit(
+        &key, (AttrNumber)CUDescColIDAttr, BTEqualStrategyNumber, F_INT4EQ, Int32GetDatum(ZstdDictColID(attnum)));
+
+    SysScanDesc cudesc_scan = systable_beginscan_ordered(cudescHeapRel, cudescIndexRel, SnapshotSelf, 1, &key);
+    HeapTuple tup = NULL;
+    while ((tup = systable_getnext_ordered(cudesc_scan, ForwardScanDirection)) != NULL) {
+        bool isnull = false;
+
+        if (dictSet->num == maxDicts) {
+            maxDicts = (maxDicts == 0) ? 4 : (maxDicts * 2);
+            dictSet->dicts = (dictSet->dicts == NULL) ? (ZstdDict*)palloc(sizeof(ZstdDict) * maxDicts)
+                                                      : (ZstdDict*)repalloc(dictSet->dicts, sizeof(ZstdDict) * maxDicts);
+        }
+        ZstdDict* dict = dictSet->dicts + dictSet->num;
+
+        dict->dictId = DatumGetUInt32(fastgetattr(tup, CUDescCUIDAttr, cudescTupDesc, &isnull));
+        Assert(!isnull);
+
+        Datum dictDatum = fastgetattr(tup, CUDescCUPointerAttr, cudescTupDesc, &isnull);
+        Assert(!isnull);
+        text* dictData = DatumGetTextP(dictDatum);
+        dict->size = (int)VARSIZE(dictData) - VARHDRSZ;
+        dict->data = (char*)palloc(dict->size);
+        errno_t rc = memcpy_s(dict->data, dict->size, VARDATA(dictData), dict->size);
+        securec_check(rc, "\0", "\0");
+        if (PointerGetDatum(dictData) != dictDatum) {
+            pfree(dictData);
+        }
+
+        ++dictSet->num;
+    }
+
+    systable_endscan_ordered(cudesc_scan);
+    index_close(cudescIndexRel, AccessShareLock);
+    heap_close(cudescHeapRel, AccessShareLock);
+
+    return dictSet;
+}
+
+void CStore::FreeZstdDicts(ZstdDictSet* dictSet)
+{
+    for (int i = 0; i < dictSet->num; ++i) {
+        pfree(dictSet->dicts[i].data);
+    }
+    if (dictSet->dicts != NULL) {
+        pfree(dictSet->dicts);
+    }
+    pfree(dictSet);
+}
+
 uint32 CStore::GetMaxCUID(Oid cudescHeap, TupleDesc cstoreRelTupDesc, Snapshot snapshotArg)
 {
     ScanKeyData key;
@@ -3424,6 +3824,9 @@ CU* CStore::GetCUData(CUDesc* cuDescPtr, int colIdx, int valSize, int& slotId)
                     RelationGetRelationName(m_relation)))));
     }
 
+    /* load the zstd dictionaries before any cache slot is held */
+    const ZstdDictSet* zstdDicts = GetZstdDicts(colIdx);
+
     AutoContextSwitch newMemCnxt(this->m_perScanMemCnxt);
 
     CU* cuPtr = NULL;
@@ -3492,7 +3895,8 @@ RETRY_LOAD_CU:
             return cuPtr;
         }
         if (cuPtr->m_cache_compressed) {
-            retCode = CUCache->StartUncompressCU(cuDescPtr, slotId, this->m_plan_node_id, this->m_timing_on);
+            retCode = CUCache->StartUncompressCU(
+                cuDescPtr, slotId, this->m_plan_node_id, this->m_timing_on, zstdDicts);
             if (retCode == CU_RELOADING) {
                 CUCache->UnPinDataBlock(slotId);
                 ereport(LOG, (errmodule(MOD_CACHE),
@@ -3593,7 +3997,7 @@ RETRY_LOAD_CU:
     // Mark the CU as no longer io busy, and wake any waiters
     CUCache->DataBlockCompleteIO(slotId);
 
-    retCode = CUCache->StartUncompressCU(cuDescPtr, slotId, this->m_plan_node_id, this->m_timing_on);
+    retCode = CUCache->StartUncompressCU(cuDescPtr, slotId, this->m_plan_node_id, this->m_timing_on, zstdDicts);
     if (retCode == CU_RELOADING) {
         CUCache->UnPinDataBlock(slotId);
         ereport(LOG,
@@ -3664,6 +4068,32 @@ RETRY_LOAD_CU:
     return cuPtr;
 }
 
+/*
+ * @Description: get the zstd dictionaries of column colIdx, loading them from
+ *      the CUDesc table the first time. Only var-length columns have them.
+ * @Return: NULL if the column has none.
+ */
+const ZstdDictSet* CStore::GetZstdDicts(int colIdx)
+{
+#ifdef USE_ZSTD
+    if (m_relation->rd_att->attrs[colIdx]->attlen != -1) {
+        return NULL;
+    }
+
+    if (m_zstdDicts == NULL) {
+        m_zstdDicts = (ZstdDictSet**)MemoryContextAllocZero(
+            m_scanMemContext, sizeof(ZstdDictSet*) * m_relation->rd_att->natts);
+    }
+    if (m_zstdDicts[colIdx] == NULL) {
+        AutoContextSwitch newMemCnxt(m_scanMemContext);
+        m_zstdDicts[colIdx] = LoadZstdDicts(m_relation, m_relation->rd_att->attrs[colIdx]->attnum);
+    }
+    return m_zstdDicts[colIdx];
+#else
+    return NULL;
+#endif
+}
+
 /*
  * @Description:  Only call by CStore::GetCUData(),  for remote load cu
  * @IN/OUT cuDescPtr: cu desc ptr
@@ -3723,7 +4153,9 @@ CUUncompressedRetCode CStore::GetCUDataFromRemote(
         }
     }
 
-    retCode = CUCache->StartUncompressCU(cuDescPtr, slotId, this->m_plan_node_id, this->m_timing_on);
+    /* GetCUData() has loaded the zstd dictionaries already */
+    retCode = CUCache->StartUncompressCU(
+        cuDescPtr, slotId, this->m_plan_node_id, this->m_timing_on, GetZstdDicts(colIdx));
     if (retCode == CU_ERR_CRC || retCode == CU_ERR_MAGIC) {
         /* remote load crc error */
         CUCache->TerminateCU(true);
@@ -4625,16 +5057,20 @@ void CStoreDropColumnInCuDesc(Relation rel, AttrNumber attrnum)
     Oid cudescOid = rel->rd_rel->relcudescrelid;
     Relation cudescHeap = heap_open(cudescOid, RowExclusiveLock);
 
-    int attrno = attrnum;
-    ScanKeyInit(&key[0], (AttrNumber)CUDescColIDAttr, BTEqualStrategyNumber, F_INT4EQ, Int32GetDatum(attrno));
+    /* the zstd dictionaries of the column go together with its CUs */
+    int colIds[] = {attrnum, ZstdDictColID(attrnum)};
 
-    scan = systable_beginscan(cudescHeap, rel->rd_rel->relcudescidx, false, SnapshotNow, 1, key);
+    for (size_t i = 0; i < lengthof(colIds); ++i) {
+        ScanKeyInit(&key[0], (AttrNumber)CUDescColIDAttr, BTEqualStrategyNumber, F_INT4EQ, Int32GetDatum(colIds[i]));
 
-    while (HeapTupleIsValid(tup = systable_getnext(scan))) {
-        simple_heap_delete(cudescHeap, &tup->t_self);
-    }
+        scan = systable_beginscan(cudescHeap, rel->rd_rel->relcudescidx, false, SnapshotNow, 1, key);
 
-    systable_endscan(scan);
+        while (HeapTupleIsValid(tup = systable_getnext(scan))) {
+            simple_heap_delete(cudescHeap, &tup->t_self);
+        }
+
+        systable_endscan(scan);
+    }
 
     heap_close(cudescHeap, RowExclusiveLock);
 }
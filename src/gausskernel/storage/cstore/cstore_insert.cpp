@@ -210,6 +210,17 @@ CStoreInsert::CStoreInsert(_in_ Relation relation, _in_ const InsertArg& args, _
     m_compress_modes = 0;
     heaprel_set_compressing_modes(m_relation, &m_compress_modes);
 
+    m_zstdDicts = NULL;
+    m_zstdDictLoaded = NULL;
+    m_zstdDictUntrained = NULL;
+#ifdef USE_ZSTD
+    if (COMPRESS_ZSTD == heaprel_get_compression_from_modes(m_compress_modes)) {
+        m_zstdDicts = (ZstdDictSet**)palloc0(sizeof(ZstdDictSet*) * attNo);
+        m_zstdDictLoaded = (bool*)palloc0(sizeof(bool) * attNo);
+        m_zstdDictUntrained = (bool*)palloc0(sizeof(bool) * attNo);
+    }
+#endif
+
     /* set update flag */
     m_isUpdate = is_update_cu;
 
@@ -228,6 +239,9 @@ CStoreInsert::~CStoreInsert()
     m_fake_values = NULL;
     m_delta_relation = NULL;
     m_cuCmprsOptions = NULL;
+    m_zstdDicts = NULL;
+    m_zstdDictLoaded = NULL;
+    m_zstdDictUntrained = NULL;
     m_estate = NULL;
     m_cuDescPPtr = NULL;
     m_delta_desc = NULL;
@@ -411,6 +425,9 @@ void CStoreInsert::Destroy()
     m_idxKeyNum = NULL;
     m_idxRelation = NULL;
     m_cuCmprsOptions = NULL;
+    m_zstdDicts = NULL;
+    m_zstdDictLoaded = NULL;
+    m_zstdDictUntrained = NULL;
     m_fake_values = NULL;
     m_fake_isnull = NULL;
 
@@ -1463,6 +1480,12 @@ CU* CStoreInsert::FormCU(int col, bulkload_rows* batchRowPtr, CUDesc* cuDescPtr)
             m_cuTempInfo.m_max_value = ConvertToInt64Data(cuDescPtr->cu_max, attlen);
         }
         m_cuTempInfo.m_options = (m_cuCmprsOptions + col);
+        m_cuTempInfo.m_zstd_dict = NULL;
+#ifdef USE_ZSTD
+        if (m_zstdDicts != NULL && attlen == -1 && (cuPtr->m_infoMode & CU_IntLikeCompressed) == 0) {
+            m_cuTempInfo.m_zstd_dict = GetZstdDict(col, cuPtr);
+        }
+#endif
         cuPtr->m_tmpinfo = &m_cuTempInfo;
 
         // Magic number is for checking CU data
@@ -1475,6 +1498,67 @@ CU* CStoreInsert::FormCU(int col, bulkload_rows* batchRowPtr, CUDesc* cuDescPtr)
     return cuPtr;
 }
 
+#ifdef USE_ZSTD
+/*
+ * @Description: get the zstd dictionary to compress CUs of string column col
+ *     with. The dictionary already saved for the column with the highest id is
+ *     reused. Otherwise one is trained from the values of this CU and saved,
+ *     and its id is the transaction id, which no concurrent inserter shares.
+ * @IN col: which column to handle
+ * @IN cuPtr: CU object before compressing
+ * @Return: NULL if the column has no dictionary yet.
+ */
+const ZstdDict* CStoreInsert::GetZstdDict(int col, const CU* cuPtr)
+{
+    ZstdDictSet* dictSet = m_zstdDicts[col];
+    if (dictSet != NULL) {
+        return dictSet->dicts + (dictSet->num - 1);
+    }
+    if (m_zstdDictUntrained[col]) {
+        return NULL;
+    }
+
+    AutoContextSwitch memContext(m_batchInsertCnxt);
+    int attnum = m_relation->rd_att->attrs[col]->attnum;
+
+    if (!m_zstdDictLoaded[col]) {
+        m_zstdDictLoaded[col] = true;
+        dictSet = CStore::LoadZstdDicts(m_relation, attnum);
+        if (dictSet->num > 0) {
+            m_zstdDicts[col] = dictSet;
+            return dictSet->dicts + (dictSet->num - 1);
+        }
+        CStore::FreeZstdDicts(dictSet);
+    }
+
+    /* zstd takes dictionary id 0 as no dictionary */
+    uint32 dictId = (uint32)GetCurrentTransactionId();
+    if (dictId == 0) {
+        return NULL;
+    }
+
+    char* dictBuf = (char*)palloc(ZstdWrapper::zstd_dict_max_size);
+    int dictSize = cuPtr->TrainZstdDict(dictId, dictBuf, ZstdWrapper::zstd_dict_max_size);
+    if (dictSize <= 0) {
+        /* retry with a fuller CU, but give up once the training fails */
+        m_zstdDictUntrained[col] = (dictSize < 0);
+        pfree(dictBuf);
+        return NULL;
+    }
+
+    dictSet = (ZstdDictSet*)palloc(sizeof(ZstdDictSet));
+    dictSet->num = 1;
+    dictSet->dicts = (ZstdDict*)palloc(sizeof(ZstdDict));
+    dictSet->dicts[0].dictId = dictId;
+    dictSet->dicts[0].size = dictSize;
+    dictSet->dicts[0].data = dictBuf;
+    CStore::SaveZstdDict(m_relation, attnum, dictSet->dicts);
+
+    m_zstdDicts[col] = dictSet;
+    return dictSet->dicts;
+}
+#endif
+
 /*
  * @Description: encode numeric values
  * @IN batchRowPtr: batch values about numeric
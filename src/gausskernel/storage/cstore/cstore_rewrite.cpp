@@ -218,6 +218,7 @@ CStoreRewriter::CStoreRewriter(Relation oldHeapRel, TupleDesc oldTupDesc, TupleD
       m_SDTColsNum(0),
       m_SDTColsInfo(NULL),
       m_SDTColsReader(NULL),
+      m_SDTColsZstdDicts(NULL),
       m_SDTColsMinMaxFunc(NULL),
       m_SDTColsWriter(NULL),
       m_SDTColValues(NULL),
@@ -560,6 +561,22 @@ void CStoreRewriter::RewriteColsData()
         ++nextCuId;
     }
 
+    // the copied CUs of the other columns may be compressed with zstd
+    // dictionaries, so copy them too. the rewritten CUs don't use any.
+    for (int i = 0; i < nOldAttrs; ++i) {
+        if (m_OldTupDesc->attrs[i]->attisdropped || m_NewTupDesc->attrs[i]->attisdropped || m_ColsRewriteFlag[i])
+            continue;
+
+        ScanKeyData dictKey;
+        ScanKeyInit(
+            &dictKey, (AttrNumber)CUDescColIDAttr, BTEqualStrategyNumber, F_INT4EQ, Int32GetDatum(ZstdDictColID(i + 1)));
+        SysScanDesc dictScan = systable_beginscan_ordered(oldCudescHeap, oldCudescIndex, SnapshotNow, 1, &dictKey);
+        while ((tup = systable_getnext_ordered(dictScan, ForwardScanDirection)) != NULL) {
+            m_NewCudescBulkInsert->BulkInsertCopy(tup);
+        }
+        systable_endscan_ordered(dictScan);
+    }
+
     FlushAllCUData();
 
     m_NewCudescBulkInsert->Finish();
@@ -861,6 +878,7 @@ void CStoreRewriter::CompressCuData(CU* cuPtr, CUDesc* cuDesc, Form_pg_attribute
 
     cu_tmp_compress_info cu_temp_info;
     cu_temp_info.m_options = &tmp_filter;
+    cu_temp_info.m_zstd_dict = NULL;
     cu_temp_info.m_valid_minmax = !NeedToRecomputeMinMax(newColAttr->atttypid);
     if (cu_temp_info.m_valid_minmax) {
         cu_temp_info.m_min_value = ConvertToInt64Data(cuDesc->cu_min, newColAttr->attlen);
@@ -930,6 +948,7 @@ void CStoreRewriter::SetDataTypeInitPhase1()
 
     m_SDTColsInfo = (CStoreRewriteColumn**)palloc(sizeof(CStoreRewriteColumn*) * m_SDTColsNum);
     m_SDTColsReader = (CUStorage**)palloc(sizeof(CUStorage*) * m_SDTColsNum);
+    m_SDTColsZstdDicts = (ZstdDictSet**)palloc0(sizeof(ZstdDictSet*) * m_SDTColsNum);
     m_SDTColsMinMaxFunc = (FuncSetMinMax*)palloc(sizeof(FuncSetMinMax) * m_SDTColsNum);
     m_SDTColsWriter = (CUStorage**)palloc(sizeof(CUStorage*) * m_SDTColsNum);
 
@@ -950,6 +969,11 @@ void CStoreRewriter::SetDataTypeInitPhase2(_in_ CStoreRewriteColumn* sdtColInfo,
 
     CFileNode cFileNode(m_OldHeapRel->rd_node, (int)sdtColInfo->attrno, MAIN_FORKNUM);
     m_SDTColsReader[idx] = New(CurrentMemoryContext) CUStorage(cFileNode);
+#ifdef USE_ZSTD
+    if (m_OldTupDesc->attrs[sdtColInfo->attrno - 1]->attlen == -1) {
+        m_SDTColsZstdDicts[idx] = CStore::LoadZstdDicts(m_OldHeapRel, sdtColInfo->attrno);
+    }
+#endif
 
     /* when tablespace is not change:
      * 1. don't create new cu file, and just reuse the existing cu file.
@@ -1012,10 +1036,14 @@ void CStoreRewriter::SetDataTypeDestroy()
         for (int i = 0; i < m_SDTColsNum; ++i) {
             DELETE_EX(m_SDTColsReader[i]);
             DELETE_EX(m_SDTColsWriter[i]);
+            if (m_SDTColsZstdDicts[i] != NULL) {
+                CStore::FreeZstdDicts(m_SDTColsZstdDicts[i]);
+            }
         }
 
         pfree_ext(m_SDTColsInfo);
         pfree_ext(m_SDTColsReader);
+        pfree_ext(m_SDTColsZstdDicts);
         pfree_ext(m_SDTColsMinMaxFunc);
         pfree_ext(m_SDTColsWriter);
         pfree_ext(m_SDTColValues);
@@ -1211,7 +1239,8 @@ void CStoreRewriter::SetDataTypeHandleNormalCu(
         pColOldAttr->atttypmod,
         pColOldAttr->atttypid,
         m_OldHeapRel,
-        m_SDTColsReader[sdtIndex]);
+        m_SDTColsReader[sdtIndex],
+        m_SDTColsZstdDicts[sdtIndex]);
 
     GetValFunc getValFuncPtr[1];
     InitGetValFunc(pColOldAttr->attlen, getValFuncPtr, 0);
@@ -1366,7 +1395,7 @@ void CStoreRewriter::InsertNewCudescTup(
 }
 
 CU* LoadSingleCu::LoadSingleCuData(_in_ CUDesc* pCuDesc, _in_ int colIdx, _in_ int colAttrLen, _in_ int colTypeMode,
-    _in_ uint32 colAtttyPid, _in_ Relation rel, __inout CUStorage* pCuStorage)
+    _in_ uint32 colAtttyPid, _in_ Relation rel, __inout CUStorage* pCuStorage, _in_ const ZstdDictSet* zstdDicts)
 {
     CU* cu = New(CurrentMemoryContext) CU(colAttrLen, colTypeMode, colAtttyPid);
 
@@ -1406,7 +1435,7 @@ CU* LoadSingleCu::LoadSingleCuData(_in_ CUDesc* pCuDesc, _in_ int colIdx, _in_ i
         }
     }
 
-    cu->UnCompress(pCuDesc->row_count, pCuDesc->magic);
+    cu->UnCompress(pCuDesc->row_count, pCuDesc->magic, zstdDicts);
     return cu;
 }
 
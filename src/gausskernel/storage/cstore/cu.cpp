@@ -171,6 +171,9 @@ void CU::Reset()
     m_bpNullCompressedSize = 0;
     m_offset = NULL;
     m_offsetSize = 0;
+    m_dicCodes = NULL;
+    m_dicCodesSize = 0;
+    m_dicItemsNum = 0;
     m_cuSizeExcludePadding = 0;
 
     m_tmpinfo = NULL;
@@ -681,6 +684,7 @@ bool CU::CompressData(_out_ char* outBuf, _in_ int nVals, _in_ int16 compress_mo
             /* input hints about both RLE and DICTIONARY encoding */
             strCoder.m_adopt_rle = ref_filter->m_adopt_rle;
             strCoder.m_adopt_dict = ref_filter->m_adopt_dict;
+            strCoder.m_zstd_dict = m_tmpinfo->m_zstd_dict;
             compressOutSize = strCoder.Compress(input, output);
         }
     }
@@ -707,7 +711,47 @@ bool CU::CompressData(_out_ char* outBuf, _in_ int nVals, _in_ int16 compress_mo
     return false;
 }
 
-void CU::UnCompress(_in_ int rowCount, _in_ uint32 magic)
+#ifdef USE_ZSTD
+/*
+ * @Description: train a zstd dictionary from the values of this var-length
+ *      CU before it's compressed. Each value is one sample.
+ * @IN dictId: id of the dictionary
+ * @OUT dictBuf: dictionary buffer
+ * @IN dictBufSize: dictionary buffer size
+ * @Return: the dictionary size, 0 if there are too few values, or -1 if
+ *      nothing can be learned from them.
+ */
+int CU::TrainZstdDict(_in_ uint32 dictId, _out_ char* dictBuf, _in_ int dictBufSize) const
+{
+    Assert(m_eachValSize == -1 && (m_infoMode & CU_IntLikeCompressed) == 0);
+
+    int nValues = 0;
+    for (uint32 offset = 0; offset < m_srcDataSize; offset += VARSIZE_ANY(m_srcData + offset)) {
+        ++nValues;
+    }
+    if (nValues < ZstdWrapper::zstd_dict_min_samples) {
+        return 0;
+    }
+
+    size_t* sampleSizes = (size_t*)palloc(sizeof(size_t) * nValues);
+    uint32 offset = 0;
+    for (int i = 0; i < nValues; ++i) {
+        sampleSizes[i] = VARSIZE_ANY(m_srcData + offset);
+        offset += sampleSizes[i];
+    }
+    Assert(offset == m_srcDataSize);
+
+    int dictSize = ZstdWrapper::TrainDictionary(m_srcData, sampleSizes, nValues, dictId, dictBuf, dictBufSize);
+    pfree(sampleSizes);
+    return (dictSize > 0) ? dictSize : -1;
+}
+#endif
+
+/*
+ * @Description: uncompress the CU loaded from disk.
+ * @IN zstdDicts: the zstd dictionaries of the column, or NULL if it has none.
+ */
+void CU::UnCompress(_in_ int rowCount, _in_ uint32 magic, _in_ const ZstdDictSet* zstdDicts)
 {
     Assert(m_compressedBuf && m_compressedBufSize > 0);
     Assert(m_cuSize > 0);
@@ -737,7 +781,7 @@ void CU::UnCompress(_in_ int rowCount, _in_ uint32 magic)
     CUDataDecrypt(buf);
 
     // Step 4: UnCompress data
-    UnCompressData(buf, rowCount);
+    UnCompressData(buf, rowCount, zstdDicts);
 
     // Step 5: generate offset array to prepare for accessing randomly if need
     if (!HasNullValue()) {
@@ -929,7 +973,7 @@ void CU::UncompressNumeric(char* inBuf, int nNotNulls, int typmode)
     }
 }
 
-void CU::UnCompressData(char* buf, int rowCount)
+void CU::UnCompressData(char* buf, int rowCount, const ZstdDictSet* zstdDicts)
 {
     if ((m_infoMode & CU_IntLikeCompressed) && ATT_IS_NUMERIC_TYPE(m_atttypid)) {
         /// compute the number of not-null values.
@@ -994,7 +1038,19 @@ void CU::UnCompressData(char* buf, int rowCount)
             } else {
                 // String Type Decompress
                 StringCoder strDecoder;
+                strDecoder.m_keep_dic_codes = (m_eachValSize == -1);
+                strDecoder.m_zstd_dicts = zstdDicts;
                 err_code = strDecoder.Decompress(in, out);
+
+                int codesNum = 0;
+                int itemsNum = 0;
+                DicCodeType* codes = strDecoder.TakeDicCodes(&codesNum, &itemsNum);
+                if (codes != NULL) {
+                    if (err_code > 0) {
+                        FormDicCodes(codes, codesNum, itemsNum, rowCount);
+                    }
+                    pfree(codes);
+                }
             }
         }
 
@@ -1037,6 +1093,35 @@ void CU::UnCompressData(char* buf, int rowCount)
     return;
 }
 
+/*
+ * @Description: spread the dictionary codes of the not-null values over
+ *               all the rows of this CU. NULL rows get code *itemsNum*.
+ * @IN codes: dictionary codes of the not-null values
+ * @IN codesNum: number of codes
+ * @IN itemsNum: number of dictionary items
+ * @IN rowCount: number of rows in this CU
+ */
+void CU::FormDicCodes(uint16* codes, int codesNum, int itemsNum, int rowCount)
+{
+    Assert(m_dicCodes == NULL);
+    Assert(itemsNum > 0 && itemsNum <= PG_UINT16_MAX);
+
+    m_dicCodesSize = (int32)(sizeof(uint16) * rowCount);
+    m_dicCodes = (uint16*)CStoreMemAlloc::Palloc(m_dicCodesSize, !m_inCUCache);
+    m_dicItemsNum = itemsNum;
+
+    int pos = 0;
+    for (int row = 0; row < rowCount; ++row) {
+        if (HasNullValue() && IsNull(row)) {
+            m_dicCodes[row] = (uint16)itemsNum;
+        } else {
+            Assert(pos < codesNum && codes[pos] < itemsNum);
+            m_dicCodes[row] = codes[pos++];
+        }
+    }
+    Assert(pos == codesNum);
+}
+
 template <bool bpcharType>
 void CU::DeFormNumberStringCU()
 {
@@ -1600,6 +1685,13 @@ void CU::FreeSrcBuf()
     }
     m_offset = NULL;
     m_offsetSize = 0;
+
+    if (m_dicCodes) {
+        CStoreMemAlloc::Pfree(m_dicCodes, !m_inCUCache);
+    }
+    m_dicCodes = NULL;
+    m_dicCodesSize = 0;
+    m_dicItemsNum = 0;
 }
 
 FORCE_INLINE
@@ -1625,7 +1717,7 @@ int CU::GetCompressBufSize() const
 FORCE_INLINE
 int CU::GetUncompressBufSize() const
 {
-    return m_srcBufSize + m_offsetSize;
+    return m_srcBufSize + m_offsetSize + m_dicCodesSize;
 }
 
 FORCE_INLINE
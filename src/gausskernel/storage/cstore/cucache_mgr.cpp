@@ -411,11 +411,13 @@ void DataCacheMgr::TerminateVerifyCU()
  * @Description: CU cache will uncompress CU raw data.
  * @Param[IN] cuDescPtr: CU desc info
  * @Param[IN] slotId: CU slot id
+ * @Param[IN] zstdDicts: zstd dictionaries of the column, loaded by the caller
+ *     because no catalog may be read under the compress lock
  * @Return: CUUncompressedRetCode value
  * @See also:
  */
 CUUncompressedRetCode DataCacheMgr::StartUncompressCU(
-    CUDesc* cuDescPtr, CacheSlotId_t slotId, int planNodeId, bool timing)
+    CUDesc* cuDescPtr, CacheSlotId_t slotId, int planNodeId, bool timing, const ZstdDictSet* zstdDicts)
 {
     CU* cuPtr = GetCUBuf(slotId);
 
@@ -472,7 +474,7 @@ CUUncompressedRetCode DataCacheMgr::StartUncompressCU(
 
     /* Always presume compressed disk and uncompressed cache. */
     UNCOMPRESS_TRACE(TRACK_START(planNodeId, UNCOMPRESS_CU));
-    cuPtr->UnCompress(cuDescPtr->row_count, cuDescPtr->magic);
+    cuPtr->UnCompress(cuDescPtr->row_count, cuDescPtr->magic, zstdDicts);
     UNCOMPRESS_TRACE(TRACK_END(planNodeId, UNCOMPRESS_CU));
 
     /* Do not put the compressedBuf in the cache
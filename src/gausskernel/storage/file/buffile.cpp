@@ -135,8 +135,7 @@ static BufFile *makeBufFileCommon(int nfiles)
     ADIO_END();
 
     file->numFiles = nfiles;
-    file->offsets = (off_t *)palloc(sizeof(off_t));
-    file->offsets[0] = 0L;
+    file->offsets = (off_t *)palloc0(sizeof(off_t) * nfiles);
     file->isTemp = false;
     file->isInterXact = false;
     file->dirty = false;
@@ -805,6 +804,52 @@ int BufFileSeekBlock(BufFile* file, long blknum)
     return BufFileSeek(file, (int)(blknum / BUFFILE_SEG_SIZE), (off_t)(blknum % BUFFILE_SEG_SIZE) * BLCKSZ, SEEK_SET);
 }
 
+/*
+ * Append the contents of source file (managed within shared fileset) to
+ * end of target file (managed within same shared fileset).
+ *
+ * Note that operation subsumes ownership of underlying resources from
+ * "source".  Caller should never call BufFileClose against source having
+ * called here first.  Resource owners for source and target must match,
+ * too.
+ *
+ * This operation works by manipulating lists of segment files, so the
+ * file content is always appended at a MAX_PHYSICAL_FILESIZE-aligned
+ * boundary, typically creating empty holes before the boundary.  These
+ * areas do not contain any interesting data, and cannot be read from by
+ * caller.
+ *
+ * Returns the block number within target where the contents of source
+ * begins.  Caller should apply this as an offset when working off block
+ * positions that are in terms of the original BufFile space.
+ */
+long BufFileAppend(BufFile* target, BufFile* source)
+{
+    long startBlock = target->numFiles * BUFFILE_SEG_SIZE;
+    int newNumFiles = target->numFiles + source->numFiles;
+    int i;
+
+    Assert(target->fileset != NULL);
+    Assert(source->readOnly);
+    Assert(!source->dirty);
+    Assert(source->fileset != NULL);
+
+    if (target->resowner != source->resowner) {
+        ereport(ERROR, (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+            errmsg("could not append BufFile with non-matching resource owner")));
+    }
+
+    target->files = (File*)repalloc(target->files, sizeof(File) * newNumFiles);
+    target->offsets = (off_t*)repalloc(target->offsets, sizeof(off_t) * newNumFiles);
+    for (i = target->numFiles; i < newNumFiles; i++) {
+        target->files[i] = source->files[i - target->numFiles];
+        target->offsets[i] = source->offsets[i - target->numFiles];
+    }
+    target->numFiles = newNumFiles;
+
+    return startBlock;
+}
+
 #ifdef NOT_USED
 /*
  * BufFileTellBlock --- block-oriented tell
@@ -0,0 +1,303 @@
+/* -------------------------------------------------------------------------
+ *
+ * condition_variable.cpp
+ *	  Implementation of condition variables.  Condition variables provide
+ *	  a way for one thread to wait until a specific condition occurs,
+ *	  without needing to know the specific identity of the thread for
+ *	  which they are waiting.  Waits for condition variables can be
+ *	  interrupted, unlike LWLock waits.  Condition variables are safe
+ *	  to use within the memory shared by a parallel context.
+ *
+ * Portions Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ * Portions Copyright (c) 1996-2019, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *	  src/gausskernel/storage/lmgr/condition_variable.cpp
+ *
+ * -------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "knl/knl_variable.h"
+
+#include "miscadmin.h"
+#include "storage/condition_variable.h"
+#include "storage/proc.h"
+#include "storage/spin.h"
+
+/* Initially, we are not prepared to sleep on any condition variable. */
+static THR_LOCAL ConditionVariable* cv_sleep_target = NULL;
+
+/* A PGPROC is on some wakeup list iff its cvWaitLink is linked. */
+#define CVWaitLinkInUse(proc) ((proc)->cvWaitLink.next != NULL)
+
+static inline void CVWaitLinkDelete(PGPROC* proc)
+{
+    dlist_delete(&proc->cvWaitLink);
+    proc->cvWaitLink.next = proc->cvWaitLink.prev = NULL;
+}
+
+static inline PGPROC* CVWaitListPopHead(ConditionVariable* cv)
+{
+    PGPROC* proc = dlist_container(PGPROC, cvWaitLink, dlist_head_node(&cv->wakeup));
+
+    CVWaitLinkDelete(proc);
+    return proc;
+}
+
+/*
+ * Initialize a condition variable.
+ */
+void ConditionVariableInit(ConditionVariable* cv)
+{
+    SpinLockInit(&cv->mutex);
+    dlist_init(&cv->wakeup);
+}
+
+/*
+ * Prepare to wait on a given condition variable.
+ *
+ * This can optionally be called before entering a test/sleep loop.
+ * Doing so is more efficient if we'll need to sleep at least once.
+ * However, if the first test of the exit condition is likely to succeed,
+ * it's more efficient to omit the ConditionVariablePrepareToSleep call.
+ * See comments in ConditionVariableSleep for more detail.
+ *
+ * Caution: "before entering the loop" means you *must* test the exit
+ * condition between calling ConditionVariablePrepareToSleep and calling
+ * ConditionVariableSleep.  If that is inconvenient, omit calling
+ * ConditionVariablePrepareToSleep.
+ */
+void ConditionVariablePrepareToSleep(ConditionVariable* cv)
+{
+    /*
+     * If some other sleep is already prepared, cancel it; this is necessary
+     * because we have just one static variable tracking the prepared sleep,
+     * and also only one cvWaitLink in our PGPROC.  It's okay to do this
+     * because whenever control does return to the other test-and-sleep loop,
+     * its ConditionVariableSleep call will just re-establish that sleep as
+     * the prepared one.
+     */
+    if (cv_sleep_target != NULL) {
+        ConditionVariableCancelSleep();
+    }
+
+    /* Record the condition variable on which we will sleep. */
+    cv_sleep_target = cv;
+
+    /*
+     * Reset my latch before adding myself to the queue, to ensure that we
+     * don't miss a wakeup that occurs immediately.
+     */
+    ResetLatch(&t_thrd.proc->procLatch);
+
+    /* Add myself to the wait queue. */
+    SpinLockAcquire(&cv->mutex);
+    dlist_push_tail(&cv->wakeup, &t_thrd.proc->cvWaitLink);
+    SpinLockRelease(&cv->mutex);
+}
+
+/*
+ * Wait for the given condition variable to be signaled.
+ *
+ * This should be called in a predicate loop that tests for a specific exit
+ * condition and otherwise sleeps, like so:
+ *
+ *	 ConditionVariablePrepareToSleep(cv);  // optional
+ *	 while (condition for which we are waiting is not true)
+ *		 ConditionVariableSleep(cv);
+ *	 ConditionVariableCancelSleep();
+ */
+void ConditionVariableSleep(ConditionVariable* cv)
+{
+    bool done = false;
+
+    /*
+     * If the caller didn't prepare to sleep explicitly, then do so now and
+     * return immediately.  The caller's predicate loop should immediately
+     * call again if its exit condition is not yet met.  This will result in
+     * the exit condition being tested twice before we first sleep.  The extra
+     * test can be prevented by calling ConditionVariablePrepareToSleep(cv)
+     * first.  Whether it's worth doing that depends on whether you expect the
+     * exit condition to be met initially, in which case skipping the prepare
+     * is recommended because it avoids manipulations of the wait list, or not
+     * met initially, in which case preparing first is better because it
+     * avoids one extra test of the exit condition.
+     *
+     * If we are currently prepared to sleep on some other CV, we just cancel
+     * that and prepare this one; see ConditionVariablePrepareToSleep.
+     */
+    if (cv_sleep_target != cv) {
+        ConditionVariablePrepareToSleep(cv);
+        return;
+    }
+
+    do {
+        CHECK_FOR_INTERRUPTS();
+
+        /*
+         * Wait for latch to be set.  (If we're awakened for some other
+         * reason, the code below will cope anyway.)
+         */
+        (void)WaitLatch(&t_thrd.proc->procLatch, WL_LATCH_SET | WL_POSTMASTER_DEATH, -1);
+
+        /* Reset latch before examining the state of the wait list. */
+        ResetLatch(&t_thrd.proc->procLatch);
+
+        /*
+         * If this thread has been taken out of the wait list, then we know
+         * that it has been signaled by ConditionVariableSignal (or
+         * ConditionVariableBroadcast), so we should return to the caller. But
+         * that doesn't guarantee that the exit condition is met, only that we
+         * ought to check it.  So we must put the thread back into the wait
+         * list, to ensure we don't miss any additional wakeup occurring while
+         * the caller checks its exit condition.  We can take ourselves out of
+         * the wait list only when the caller calls
+         * ConditionVariableCancelSleep.
+         *
+         * If we're still in the wait list, then the latch must have been set
+         * by something other than ConditionVariableSignal; though we don't
+         * guarantee not to return spuriously, we'll avoid this obvious case.
+         */
+        SpinLockAcquire(&cv->mutex);
+        if (!CVWaitLinkInUse(t_thrd.proc)) {
+            done = true;
+            dlist_push_tail(&cv->wakeup, &t_thrd.proc->cvWaitLink);
+        }
+        SpinLockRelease(&cv->mutex);
+    } while (!done);
+}
+
+/*
+ * Cancel any pending sleep operation.
+ *
+ * We just need to remove ourselves from the wait queue of any condition
+ * variable for which we have previously prepared a sleep.
+ *
+ * Do nothing if nothing is pending; this allows this function to be called
+ * during transaction abort to clean up any unfinished CV sleep.
+ */
+void ConditionVariableCancelSleep(void)
+{
+    ConditionVariable* cv = cv_sleep_target;
+
+    if (cv == NULL) {
+        return;
+    }
+
+    SpinLockAcquire(&cv->mutex);
+    if (CVWaitLinkInUse(t_thrd.proc)) {
+        CVWaitLinkDelete(t_thrd.proc);
+    }
+    SpinLockRelease(&cv->mutex);
+
+    cv_sleep_target = NULL;
+}
+
+/*
+ * Wake up the oldest thread sleeping on the CV, if there is any.
+ *
+ * Note: it's difficult to tell whether this has any real effect: we know
+ * whether we took a thread off the list, but not whether it was already
+ * done waiting.  So we don't try to report that.
+ */
+void ConditionVariableSignal(ConditionVariable* cv)
+{
+    PGPROC* proc = NULL;
+
+    /* Remove the first thread from the wakeup queue (if any). */
+    SpinLockAcquire(&cv->mutex);
+    if (!dlist_is_empty(&cv->wakeup)) {
+        proc = CVWaitListPopHead(cv);
+    }
+    SpinLockRelease(&cv->mutex);
+
+    /* If we found someone sleeping, set their latch to wake them up. */
+    if (proc != NULL) {
+        SetLatch(&proc->procLatch);
+    }
+}
+
+/*
+ * Wake up all threads sleeping on the given CV.
+ *
+ * This guarantees to wake all threads that were sleeping on the CV
+ * at time of call, but threads that add themselves to the list mid-call
+ * will typically not get awakened.
+ */
+void ConditionVariableBroadcast(ConditionVariable* cv)
+{
+    PGPROC* proc = NULL;
+    bool have_sentinel = false;
+
+    /*
+     * In some use-cases, it is common for awakened threads to immediately
+     * re-queue themselves.  If we just naively try to reduce the wakeup list
+     * to empty, we'll get into a potentially-indefinite loop against such a
+     * thread.  The semantics we really want are just to be sure that we
+     * have wakened all threads that were in the list at entry.  We can use
+     * our own cvWaitLink as a sentinel to detect when we've finished.
+     *
+     * A seeming flaw in this approach is that someone else might signal the
+     * CV and in doing so remove our sentinel entry.  But that's fine: since
+     * CV waiters are always added and removed in order, that must mean that
+     * every previous waiter has been wakened, so we're done.  We'll get an
+     * extra "set" on our latch from the someone else's signal, which is
+     * slightly inefficient but harmless.
+     *
+     * We can't insert our cvWaitLink as a sentinel if it's already in use in
+     * some other list.  We deal with that by simply canceling any prepared CV
+     * sleep.  The next call to ConditionVariableSleep will take care of
+     * re-establishing the lost state.
+     */
+    if (cv_sleep_target != NULL) {
+        ConditionVariableCancelSleep();
+    }
+
+    /*
+     * Inspect the state of the queue.  If it's empty, we have nothing to do.
+     * If there's exactly one entry, we need only remove and signal that
+     * entry.  Otherwise, remove the first entry and insert our sentinel.
+     */
+    SpinLockAcquire(&cv->mutex);
+    Assert(!CVWaitLinkInUse(t_thrd.proc));
+    if (!dlist_is_empty(&cv->wakeup)) {
+        proc = CVWaitListPopHead(cv);
+        if (!dlist_is_empty(&cv->wakeup)) {
+            dlist_push_tail(&cv->wakeup, &t_thrd.proc->cvWaitLink);
+            have_sentinel = true;
+        }
+    }
+    SpinLockRelease(&cv->mutex);
+
+    /* Awaken first waiter, if there was one. */
+    if (proc != NULL) {
+        SetLatch(&proc->procLatch);
+    }
+
+    while (have_sentinel) {
+        /*
+         * Each time through the loop, remove the first wakeup list entry, and
+         * signal it unless it's our sentinel.  Repeat as long as the sentinel
+         * remains in the list.
+         *
+         * Notice that if someone else removes our sentinel, we will waken one
+         * additional thread before exiting.  That's intentional, because if
+         * someone else signals the CV, they may be intending to waken some
+         * third thread that added itself to the list after we added the
+         * sentinel.  Better to give a spurious wakeup (which should be
+         * harmless beyond wasting some cycles) than to lose a wakeup.
+         */
+        proc = NULL;
+        SpinLockAcquire(&cv->mutex);
+        if (!dlist_is_empty(&cv->wakeup)) {
+            proc = CVWaitListPopHead(cv);
+        }
+        have_sentinel = CVWaitLinkInUse(t_thrd.proc);
+        SpinLockRelease(&cv->mutex);
+
+        if (proc != NULL && proc != t_thrd.proc) {
+            SetLatch(&proc->procLatch);
+        }
+    }
+}
@@ -665,6 +665,9 @@ void InitProcess(void)
      */
     OwnLatch(&t_thrd.proc->procLatch);
 
+    /* Not waiting on any condition variable yet. */
+    t_thrd.proc->cvWaitLink.next = t_thrd.proc->cvWaitLink.prev = NULL;
+
     /*
      * We might be reusing a semaphore that belonged to a failed process. So
      * be careful and reinitialize its value here.	(This is not strictly
@@ -841,6 +844,9 @@ void InitAuxiliaryProcess(void)
      */
     OwnLatch(&t_thrd.proc->procLatch);
 
+    /* Not waiting on any condition variable yet. */
+    t_thrd.proc->cvWaitLink.next = t_thrd.proc->cvWaitLink.prev = NULL;
+
     /*
      * We might be reusing a semaphore that belonged to a failed process. So
      * be careful and reinitialize its value here.	(This is not strictly
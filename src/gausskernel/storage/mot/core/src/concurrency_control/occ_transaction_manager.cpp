@@ -238,6 +238,12 @@ RC OccTransactionManager::ValidateOcc(TxnManager* txMan)
     m_insertSetSize = 0;
     m_txnCounter++;
 
+    // A snapshot reader does not record its reads, but it may have missed keys deleted after its snapshot
+    if (txMan->IsSnapshotRead() && !txMan->ValidateSnapshotRead()) {
+        m_abortsCounter++;
+        return RC_ABORT;
+    }
+
     if (rowCount == 0) {
         // READONLY
         return rc;
@@ -327,6 +333,13 @@ bool OccTransactionManager::WriteChanges(TxnManager* txMan)
     LockRows(txMan, m_rowsSetSize);
     MOTConfiguration& cfg = GetGlobalConfiguration();
 
+    // Keep the committed rows before they are overwritten, for snapshot readers (MVCC)
+    if (cfg.m_enableMvcc && !MOTEngine::GetInstance()->IsRecovering()) {
+        if (!KeepRowVersions(txMan)) {
+            return false;
+        }
+    }
+
     TxnOrderedSet_t& orderedSet = txMan->m_accessMgr->GetOrderedRowSet();
     // Update CSN with all relevant information on global rows
     // For deletes invalidate sentinels - rows still locked!
@@ -420,6 +433,42 @@ bool OccTransactionManager::WriteChanges(TxnManager* txMan)
     return true;
 }
 
+bool OccTransactionManager::KeepRowVersions(TxnManager* txMan)
+{
+    TxnOrderedSet_t& orderedSet = txMan->m_accessMgr->GetOrderedRowSet();
+    for (const auto& raPair : orderedSet) {
+        const Access* access = raPair.second;
+        if (!access->m_params.IsPrimarySentinel()) {
+            continue;
+        }
+        bool isUpgrade = (access->m_type == INS && access->m_params.IsUpgradeInsert());
+        if (access->m_type != WR && access->m_type != DEL && !isUpgrade) {
+            continue;
+        }
+        Row* row = access->GetRowFromHeader();
+        Table* table = row->GetTable();
+        Row* version = table->CreateNewRow();
+        if (version == nullptr) {
+            MOT_REPORT_ERROR(MOT_ERROR_OOM, "Commit", "Failed to allocate row version for snapshot readers");
+            return false;
+        }
+        // The version is never written, so it is kept unlocked with the CSN of the overwritten row
+        version->Copy(row);
+        version->m_rowHeader.m_csnWord = (row->m_rowHeader.m_csnWord & ~LOCK_BIT);
+        version->m_prevVersion = row->m_prevVersion;
+        COMPILER_BARRIER
+        row->m_prevVersion = version;
+        if (isUpgrade) {
+            access->m_auxRow->m_prevVersion = version;
+        }
+        // The version is reclaimed only after all the transactions that are currently active end. Any later
+        // snapshot reader finds a newer version first, so it never follows the link to a reclaimed version
+        txMan->GetGcSession()->GcRecordObject(
+            table->GetPrimaryIndex()->GetIndexId(), version, nullptr, Row::RowDtor, ROW_SIZE_FROM_POOL(table));
+    }
+    return true;
+}
+
 void OccTransactionManager::CleanRowsFromIndexes(TxnManager* txMan)
 {
     if (m_deleteSetSize == 0) {
@@ -429,12 +478,19 @@ void OccTransactionManager::CleanRowsFromIndexes(TxnManager* txMan)
     TxnAccess* tx = txMan->m_accessMgr.Get();
     TxnOrderedSet_t& orderedSet = tx->GetOrderedRowSet();
     uint32_t numOfDeletes = m_deleteSetSize;
+    bool enableMvcc = GetGlobalConfiguration().m_enableMvcc;
     // use local counter to optimize
     for (const auto& raPair : orderedSet) {
         const Access* access = raPair.second;
         if (access->m_type == DEL) {
             numOfDeletes--;
-            access->GetTxnRow()->GetTable()->UpdateRowCount(-1);
+            Table* table = access->GetTxnRow()->GetTable();
+            table->UpdateRowCount(-1);
+            // Snapshot readers of the table that might miss the removed key are aborted on commit (MVCC),
+            // so the delete is published before the key is removed
+            if (enableMvcc) {
+                table->SetLastDeleteCsn(txMan->GetCommitSequenceNumber());
+            }
             MOT_ASSERT(access->m_params.IsUpgradeInsert() == false);
             // Use Txn Row as row may change INSERT after DELETE leaves residue
             txMan->RemoveKeyFromIndex(access->GetTxnRow(), access->m_origSentinel);
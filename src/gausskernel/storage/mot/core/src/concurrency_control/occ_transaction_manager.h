@@ -169,6 +169,8 @@ private:
     bool ValidateReadSet(TxnManager* txMan);
     /** @brief validate the write set   */
     bool ValidateWriteSet(TxnManager* txMan);
+    /** @brief keep the committed rows that are overwritten for snapshot readers (MVCC) */
+    bool KeepRowVersions(TxnManager* txMan);
 
     // Configuration of OCC behavior
     /** @var transaction counter   */
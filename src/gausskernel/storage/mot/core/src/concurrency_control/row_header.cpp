@@ -85,6 +85,55 @@ RC RowHeader::GetLocalCopy(
     return RC_OK;
 }
 
+RC RowHeader::GetSnapshotCopy(Row* localRow, const Row* origRow, uint64_t snapshotCsn) const
+{
+    uint64_t sleepTime = 1;
+    uint64_t v = 0;
+    uint64_t v2 = 1;
+    const Row* version = nullptr;
+
+    while (v2 != v) {
+        // wait for a concurrent commit to finish writing the row
+        v = m_csnWord;
+        while (v & LOCK_BIT) {
+            if (sleepTime > LOCK_TIME_OUT) {
+                sleepTime = LOCK_TIME_OUT;
+                struct timespec ts = {0, 5000};
+                (void)nanosleep(&ts, NULL);
+            } else {
+                CpuCyclesLevelTime::Sleep(1);
+                sleepTime = sleepTime << 1;
+            }
+
+            v = m_csnWord;
+        }
+        if ((v & CSN_BITS) <= snapshotCsn) {
+            localRow->Copy(origRow);
+        } else {
+            // the previous version is linked before the row is overwritten
+            version = origRow->GetPrevVersion();
+        }
+        COMPILER_BARRIER
+        v2 = m_csnWord;
+    }
+
+    if ((v & CSN_BITS) <= snapshotCsn) {
+        // deleted, or inserted but not committed yet
+        return (v & ABSENT_BIT) ? RC_LOCAL_ROW_NOT_FOUND : RC_OK;
+    }
+
+    // versions are immutable, and reclaimed only after all the transactions that could read them ended
+    while (version != nullptr && version->GetCommitSequenceNumber() > snapshotCsn) {
+        version = version->GetPrevVersion();
+    }
+    if (version == nullptr || version->IsAbsentRow()) {
+        // the row was inserted after the snapshot, or deleted before it
+        return RC_LOCAL_ROW_NOT_FOUND;
+    }
+    localRow->Copy(version);
+    return RC_OK;
+}
+
 bool RowHeader::ValidateWrite(TransactionId tid) const
 {
     return (tid == GetCSN());
@@ -99,6 +99,16 @@ private:
      */
     RC GetLocalCopy(TxnAccess* txn, AccessType type, Row* localRow, const Row* origRow, TransactionId& lastTid) const;
 
+    /**
+     * @brief Gets a consistent copy of the row version committed at a snapshot. If the row
+     * changed after the snapshot, the copy is taken from the row's previous versions.
+     * @param[out] localRow Receives the row version contents.
+     * @param origRow The managed row.
+     * @param snapshotCsn The snapshot commit sequence number.
+     * @return RC_OK if the row was visible at the snapshot, otherwise RC_LOCAL_ROW_NOT_FOUND.
+     */
+    RC GetSnapshotCopy(Row* localRow, const Row* origRow, uint64_t snapshotCsn) const;
+
     /**
      * @brief Validates the row was not changed by a concurrent transaction
      * @param tid The transaction identifier.
@@ -0,0 +1,509 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ *
+ * hash_index.cpp
+ *    Primary index implementation using a lock-free split-ordered hash table.
+ *
+ * IDENTIFICATION
+ *    src/gausskernel/storage/mot/core/src/storage/index/hash_index.cpp
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "hash_index.h"
+#include "mot_engine.h"
+#include "mm_global_api.h"
+
+namespace MOT {
+IMPLEMENT_CLASS_LOGGER(HashPrimaryIndex, Storage);
+
+constexpr uint32_t HashPrimaryIndex::INITIAL_BUCKET_BITS;
+constexpr uint32_t HashPrimaryIndex::MAX_SEGMENTS;
+constexpr uint32_t HashPrimaryIndex::MAX_BUCKET_BITS;
+constexpr uint64_t HashPrimaryIndex::MAX_LOAD_FACTOR;
+
+static inline uint64_t HashKeyBuf(const uint8_t* buf, uint32_t len)
+{
+    // MurmurHash64A mixing, reading the key 8 bytes at a time
+    const uint64_t m = 0xc6a4a7935bd1e995ULL;
+    const int r = 47;
+    uint64_t h = len * m;
+    uint32_t i = 0;
+
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t k;
+        errno_t erc = memcpy_s(&k, sizeof(k), buf + i, sizeof(k));
+        securec_check(erc, "\0", "\0");
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+        h ^= k;
+        h *= m;
+    }
+
+    if (i < len) {
+        uint64_t k = 0;
+        errno_t erc = memcpy_s(&k, sizeof(k), buf + i, len - i);
+        securec_check(erc, "\0", "\0");
+        h ^= k;
+        h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+    return h;
+}
+
+static inline uint64_t ReverseBits(uint64_t value)
+{
+    value = ((value >> 1) & 0x5555555555555555ULL) | ((value & 0x5555555555555555ULL) << 1);
+    value = ((value >> 2) & 0x3333333333333333ULL) | ((value & 0x3333333333333333ULL) << 2);
+    value = ((value >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((value & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    return __builtin_bswap64(value);
+}
+
+static inline uint32_t HighestBit(uint64_t value)
+{
+    return 63 - __builtin_clzll(value);
+}
+
+bool HashPrimaryIndex::InitPools()
+{
+    m_nodePool = ObjAllocInterface::GetObjPool(sizeof(HashNode) + sizeof(Key) + ALIGN8(m_keyLength), false);
+    if (m_nodePool == nullptr) {
+        MOT_REPORT_ERROR(MOT_ERROR_OOM, "Initialize Index", "Failed to create hash node pool");
+        return false;  // safe cleanup in DestroyPools()
+    }
+
+    m_bucketNodePool = ObjAllocInterface::GetObjPool(sizeof(HashNode), false);
+    if (m_bucketNodePool == nullptr) {
+        MOT_REPORT_ERROR(MOT_ERROR_OOM, "Initialize Index", "Failed to create hash bucket node pool");
+        return false;  // safe cleanup in DestroyPools()
+    }
+
+    return true;
+}
+
+void HashPrimaryIndex::DestroyPools()
+{
+    for (uint32_t i = 0; i < MAX_SEGMENTS; i++) {
+        Bucket* segment = m_segments[i].load();
+        if (segment != nullptr) {
+            MemGlobalFree(segment);
+            m_segments[i] = nullptr;
+        }
+    }
+
+    if (m_nodePool != nullptr) {
+        ObjAllocInterface::FreeObjPool(&m_nodePool);
+        m_nodePool = nullptr;
+    }
+
+    if (m_bucketNodePool != nullptr) {
+        ObjAllocInterface::FreeObjPool(&m_bucketNodePool);
+        m_bucketNodePool = nullptr;
+    }
+}
+
+RC HashPrimaryIndex::IndexInitImpl(void** args)
+{
+    if (!InitPools()) {
+        DestroyPools();
+        MOT_REPORT_ERROR(MOT_ERROR_OOM, "Initialize Index", "Failed to initialize hash index pools");
+        return RC_MEMORY_ALLOCATION_ERROR;
+    }
+
+    m_bucketBits = INITIAL_BUCKET_BITS;
+    m_count = 0;
+
+    // bucket 0 is the head of the list, all other buckets are linked lazily
+    Bucket* slot = GetBucketSlot(0);
+    HashNode* head = reinterpret_cast<HashNode*>(m_bucketNodePool->Alloc());
+    if (slot == nullptr || head == nullptr) {
+        DestroyPools();
+        MOT_REPORT_ERROR(MOT_ERROR_OOM, "Initialize Index", "Failed to initialize hash index buckets");
+        return RC_MEMORY_ALLOCATION_ERROR;
+    }
+    head->m_next = 0;
+    head->m_orderKey = 0;
+    head->m_sentinel = nullptr;
+    slot->store(head);
+
+    m_initialized = true;
+    return RC_OK;
+}
+
+HashPrimaryIndex::Bucket* HashPrimaryIndex::GetBucketSlot(uint64_t bucket) const
+{
+    uint32_t segmentId = 0;
+    uint64_t segmentSize = (1ULL << INITIAL_BUCKET_BITS);
+    uint64_t offset = bucket;
+    if (bucket >= segmentSize) {
+        uint32_t bit = HighestBit(bucket);
+        segmentId = bit - INITIAL_BUCKET_BITS + 1;
+        segmentSize = (1ULL << bit);
+        offset = bucket - segmentSize;
+    }
+
+    Bucket* segment = m_segments[segmentId].load(std::memory_order_acquire);
+    if (unlikely(segment == nullptr)) {
+        size_t allocSize = segmentSize * sizeof(Bucket);
+        Bucket* newSegment = reinterpret_cast<Bucket*>(MemGlobalAllocAligned(allocSize, CACHE_LINE_SIZE));
+        if (newSegment == nullptr) {
+            MOT_REPORT_ERROR(MOT_ERROR_OOM,
+                "Hash Index",
+                "Failed to allocate %" PRIu64 " bytes for hash index %s bucket segment %u",
+                (uint64_t)allocSize,
+                m_name.c_str(),
+                segmentId);
+            return nullptr;
+        }
+        for (uint64_t i = 0; i < segmentSize; i++) {
+            new (&newSegment[i]) Bucket(nullptr);
+        }
+        if (m_segments[segmentId].compare_exchange_strong(segment, newSegment)) {
+            segment = newSegment;
+        } else {
+            // another thread allocated the segment first
+            MemGlobalFree(newSegment);
+        }
+    }
+
+    return &segment[offset];
+}
+
+HashPrimaryIndex::HashNode* HashPrimaryIndex::InitBucket(uint64_t bucket) const
+{
+    Bucket* slot = GetBucketSlot(bucket);
+    if (slot == nullptr) {
+        return nullptr;
+    }
+
+    HashNode* node = slot->load(std::memory_order_acquire);
+    if (node != nullptr) {
+        return node;
+    }
+
+    // the parent bucket is the bucket without the highest bit, it precedes this bucket in the list
+    HashNode* parent = InitBucket(bucket & ~(1ULL << HighestBit(bucket)));
+    if (parent == nullptr) {
+        return nullptr;
+    }
+
+    HashNode* bucketNode = reinterpret_cast<HashNode*>(m_bucketNodePool->Alloc());
+    if (bucketNode == nullptr) {
+        MOT_REPORT_ERROR(MOT_ERROR_OOM, "Hash Index", "Failed to allocate bucket node for hash index %s", m_name.c_str());
+        return nullptr;
+    }
+    bucketNode->m_orderKey = ReverseBits(bucket);
+    bucketNode->m_sentinel = nullptr;
+    bucketNode->m_insertSeq = 0;
+
+    std::atomic<uintptr_t>* prev = nullptr;
+    HashNode* curr = nullptr;
+    while (true) {
+        if (ListFind(parent, bucketNode->m_orderKey, nullptr, prev, curr)) {
+            // another thread linked the bucket node first, bucket nodes are never removed
+            m_bucketNodePool->Release(bucketNode);
+            bucketNode = curr;
+            break;
+        }
+        bucketNode->m_next.store((uintptr_t)curr, std::memory_order_relaxed);
+        uintptr_t expected = (uintptr_t)curr;
+        if (prev->compare_exchange_strong(expected, (uintptr_t)bucketNode)) {
+            break;
+        }
+    }
+
+    HashNode* expectedNode = nullptr;
+    (void)slot->compare_exchange_strong(expectedNode, bucketNode);
+    return bucketNode;
+}
+
+HashPrimaryIndex::HashNode* HashPrimaryIndex::GetBucketNode(uint64_t hash) const
+{
+    uint64_t bucket = hash & ((1ULL << m_bucketBits.load(std::memory_order_relaxed)) - 1);
+    Bucket* slot = GetBucketSlot(bucket);
+    if (slot != nullptr) {
+        HashNode* node = slot->load(std::memory_order_acquire);
+        if (likely(node != nullptr)) {
+            return node;
+        }
+    }
+    return InitBucket(bucket);
+}
+
+bool HashPrimaryIndex::ListFind(HashNode* head, uint64_t orderKey, const uint8_t* keyBuf,
+    std::atomic<uintptr_t>*& prev, HashNode*& curr) const
+{
+retry:
+    prev = &head->m_next;
+    curr = NodePtr(prev->load(std::memory_order_acquire));
+    while (curr != nullptr) {
+        uintptr_t next = curr->m_next.load(std::memory_order_acquire);
+        if (prev->load(std::memory_order_acquire) != (uintptr_t)curr) {
+            goto retry;
+        }
+
+        if (IsMarked(next)) {
+            // help unlinking the removed node, the thread that unlinks the node retires it
+            uintptr_t expected = (uintptr_t)curr;
+            if (!prev->compare_exchange_strong(expected, next & ~(uintptr_t)1)) {
+                goto retry;
+            }
+            RetireNode(curr);
+            curr = NodePtr(next);
+            continue;
+        }
+
+        int cmp = CompareNode(curr, orderKey, keyBuf);
+        if (cmp >= 0) {
+            return (cmp == 0);
+        }
+        prev = &curr->m_next;
+        curr = NodePtr(next);
+    }
+    return false;
+}
+
+HashPrimaryIndex::HashNode* HashPrimaryIndex::NextDataNode(HashNode* node, uint64_t scanSeq)
+{
+    HashNode* curr = NodePtr(node->m_next.load(std::memory_order_acquire));
+    while (curr != nullptr) {
+        uintptr_t next = curr->m_next.load(std::memory_order_acquire);
+        if (!curr->IsBucket() && !IsMarked(next) && curr->m_insertSeq <= scanSeq) {
+            break;
+        }
+        curr = NodePtr(next);
+    }
+    return curr;
+}
+
+void HashPrimaryIndex::RetireNode(HashNode* node) const
+{
+    GcManager* gcSession = MOTEngine::GetInstance()->GetCurrentGcSession();
+    if (gcSession != nullptr) {
+        gcSession->GcRecordObject(
+            GetIndexId(), (void*)m_nodePool, (void*)node, DeallocateNodeCallBack, m_nodePool->m_size);
+    } else {
+        // no concurrent readers outside of a session (e.g. recovery replay)
+        m_nodePool->Release(node);
+    }
+}
+
+uint32_t HashPrimaryIndex::DeallocateNodeCallBack(void* pool, void* ptr, bool dropIndex)
+{
+    // If dropIndex == true, all index's pools are going to be cleaned, so we skip the release here
+    ObjAllocInterface* localPoolPtr = (ObjAllocInterface*)pool;
+    if (dropIndex == false) {
+        localPoolPtr->Release(ptr);
+    }
+    return localPoolPtr->m_size;
+}
+
+void HashPrimaryIndex::TryGrow(uint64_t count)
+{
+    uint32_t bits = m_bucketBits.load(std::memory_order_relaxed);
+    if (bits < MAX_BUCKET_BITS && count > (MAX_LOAD_FACTOR << bits)) {
+        // the new buckets are linked lazily, losing this race means another thread grew the table
+        (void)m_bucketBits.compare_exchange_strong(bits, bits + 1);
+    }
+}
+
+Sentinel* HashPrimaryIndex::IndexInsertImpl(const Key* key, Sentinel* sentinel, bool& inserted, uint32_t pid)
+{
+    const uint8_t* keyBuf = key->GetKeyBuf();
+    uint64_t hash = HashKeyBuf(keyBuf, m_keyLength);
+    uint64_t orderKey = ReverseBits(hash) | 1;
+
+    inserted = false;
+    HashNode* head = GetBucketNode(hash);
+    if (head == nullptr) {
+        return nullptr;
+    }
+
+    HashNode* node = reinterpret_cast<HashNode*>(m_nodePool->Alloc());
+    if (node == nullptr) {
+        MOT_REPORT_ERROR(MOT_ERROR_OOM, "Index Insert", "Failed to allocate hash node for index %s", m_name.c_str());
+        return nullptr;
+    }
+    node->m_orderKey = orderKey;
+    node->m_sentinel = sentinel;
+    node->m_insertSeq = m_insertSeq.fetch_add(1, std::memory_order_relaxed) + 1;
+    Key* nodeKey = new (node->GetKey()) Key(m_keyLength, KeyType::PRIMARY_KEY);
+    errno_t erc = memcpy_s(nodeKey->GetKeyBuf(), ALIGN8(m_keyLength), keyBuf, m_keyLength);
+    securec_check(erc, "\0", "\0");
+
+    std::atomic<uintptr_t>* prev = nullptr;
+    HashNode* curr = nullptr;
+    while (true) {
+        if (ListFind(head, orderKey, keyBuf, prev, curr)) {
+            // key mapping already exists, the node was never published
+            m_nodePool->Release(node);
+            return curr->m_sentinel;
+        }
+        node->m_next.store((uintptr_t)curr, std::memory_order_relaxed);
+        uintptr_t expected = (uintptr_t)curr;
+        if (prev->compare_exchange_strong(expected, (uintptr_t)node)) {
+            break;
+        }
+    }
+
+    inserted = true;
+    TryGrow(m_count.fetch_add(1, std::memory_order_relaxed) + 1);
+    return nullptr;
+}
+
+Sentinel* HashPrimaryIndex::IndexReadImpl(const Key* key, uint32_t pid) const
+{
+    const uint8_t* keyBuf = key->GetKeyBuf();
+    uint64_t hash = HashKeyBuf(keyBuf, m_keyLength);
+    uint64_t orderKey = ReverseBits(hash) | 1;
+
+    HashNode* head = GetBucketNode(hash);
+    if (head == nullptr) {
+        return nullptr;
+    }
+
+    // readers only skip removed nodes, they never help unlinking them
+    HashNode* curr = NodePtr(head->m_next.load(std::memory_order_acquire));
+    while (curr != nullptr) {
+        uintptr_t next = curr->m_next.load(std::memory_order_acquire);
+        int cmp = CompareNode(curr, orderKey, keyBuf);
+        if (cmp > 0) {
+            break;
+        }
+        if (cmp == 0 && !IsMarked(next)) {
+            return curr->m_sentinel;
+        }
+        curr = NodePtr(next);
+    }
+
+    return nullptr;
+}
+
+Sentinel* HashPrimaryIndex::IndexRemoveImpl(const Key* key, uint32_t pid)
+{
+    const uint8_t* keyBuf = key->GetKeyBuf();
+    uint64_t hash = HashKeyBuf(keyBuf, m_keyLength);
+    uint64_t orderKey = ReverseBits(hash) | 1;
+
+    HashNode* head = GetBucketNode(hash);
+    if (head == nullptr) {
+        return nullptr;
+    }
+
+    std::atomic<uintptr_t>* prev = nullptr;
+    HashNode* curr = nullptr;
+    while (true) {
+        if (!ListFind(head, orderKey, keyBuf, prev, curr)) {
+            return nullptr;
+        }
+
+        // logical removal
+        uintptr_t next = curr->m_next.load(std::memory_order_acquire);
+        if (IsMarked(next) || !curr->m_next.compare_exchange_strong(next, next | 1)) {
+            continue;
+        }
+
+        // physical removal, otherwise let ListFind() unlink it
+        uintptr_t expected = (uintptr_t)curr;
+        Sentinel* sentinel = curr->m_sentinel;
+        if (prev->compare_exchange_strong(expected, next)) {
+            RetireNode(curr);
+        } else {
+            (void)ListFind(head, orderKey, keyBuf, prev, curr);
+        }
+        m_count.fetch_sub(1, std::memory_order_relaxed);
+        return sentinel;
+    }
+}
+
+uint64_t HashPrimaryIndex::GetIndexSize()
+{
+    PoolStatsSt stats;
+    ObjAllocInterface* pools[] = {m_keyPool, m_sentinelPool, m_nodePool, m_bucketNodePool};
+    uint64_t res = 0;
+    uint64_t netto = 0;
+
+    for (ObjAllocInterface* pool : pools) {
+        errno_t erc = memset_s(&stats, sizeof(PoolStatsSt), 0, sizeof(PoolStatsSt));
+        securec_check(erc, "\0", "\0");
+        stats.m_type = PoolStatsT::POOL_STATS_ALL;
+        pool->GetStats(stats);
+        res += stats.m_poolCount * stats.m_poolGrossSize;
+        netto += (stats.m_totalObjCount - stats.m_freeObjCount) * stats.m_objSize;
+    }
+
+    for (uint32_t i = 0; i < MAX_SEGMENTS; i++) {
+        if (m_segments[i].load() != nullptr) {
+            uint64_t segmentSize = (i == 0) ? (1ULL << INITIAL_BUCKET_BITS) : (1ULL << (INITIAL_BUCKET_BITS + i - 1));
+            res += segmentSize * sizeof(Bucket);
+            netto += segmentSize * sizeof(Bucket);
+        }
+    }
+
+    MOT_LOG_INFO("Index %s memory size: gross: %lu, netto: %lu", m_name.c_str(), res, netto);
+    return res;
+}
+
+// Iterator API
+IndexIterator* HashPrimaryIndex::Begin(uint32_t pid, bool passive) const
+{
+    // keys inserted from now on are not visited by the scan
+    uint64_t scanSeq = m_insertSeq.load(std::memory_order_acquire);
+    HashNode* head = m_segments[0].load()[0].load();
+    IndexIterator* itr = new (std::nothrow) HashIterator(NextDataNode(head, scanSeq), true, scanSeq);
+    if (itr == nullptr) {
+        MOT_REPORT_ERROR(MOT_ERROR_OOM, "Index Begin", "Failed to create hash index iterator");
+    }
+    return itr;
+}
+
+IndexIterator* HashPrimaryIndex::Search(
+    const Key* key, bool matchKey, bool forward, uint32_t pid, bool& found, bool passive) const
+{
+    // only exact matches are supported, the result iterator has at most one item
+    HashNode* node = nullptr;
+    found = false;
+    if (matchKey) {
+        const uint8_t* keyBuf = key->GetKeyBuf();
+        uint64_t hash = HashKeyBuf(keyBuf, m_keyLength);
+        uint64_t orderKey = ReverseBits(hash) | 1;
+        HashNode* curr = GetBucketNode(hash);
+        curr = (curr != nullptr) ? NodePtr(curr->m_next.load(std::memory_order_acquire)) : nullptr;
+        while (curr != nullptr) {
+            uintptr_t next = curr->m_next.load(std::memory_order_acquire);
+            int cmp = CompareNode(curr, orderKey, keyBuf);
+            if (cmp > 0) {
+                break;
+            }
+            if (cmp == 0 && !IsMarked(next)) {
+                node = curr;
+                found = true;
+                break;
+            }
+            curr = NodePtr(next);
+        }
+    }
+
+    IndexIterator* itr = new (std::nothrow) HashIterator(node, false);
+    if (itr == nullptr) {
+        MOT_REPORT_ERROR(MOT_ERROR_OOM, "Index Search", "Failed to create hash index iterator");
+    }
+    return itr;
+}
+}  // namespace MOT
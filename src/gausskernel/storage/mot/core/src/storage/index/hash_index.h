@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * -------------------------------------------------------------------------
+ *
+ * hash_index.h
+ *    Primary index implementation using a lock-free split-ordered hash table.
+ *
+ * IDENTIFICATION
+ *    src/gausskernel/storage/mot/core/src/storage/index/hash_index.h
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#ifndef HASH_PRIMARY_INDEX_H
+#define HASH_PRIMARY_INDEX_H
+
+#include <atomic>
+#include "index.h"
+#include "utilities.h"
+#include "mm_gc_manager.h"
+
+namespace MOT {
+/**
+ * @class HashPrimaryIndex.
+ * @brief Primary index implementation using a lock-free, resizable hash table.
+ * @detail All the keys are kept in a single lock-free linked list (Harris-Michael), sorted by the
+ * bit-reversed hash code of the key (split-ordered list, Shalev and Shavit). Each bucket points to
+ * a bucket node in the list, so growing the table only doubles the number of buckets, and the new
+ * buckets are lazily linked to the list on first access. No key is ever moved. Removed nodes are
+ * reclaimed through the GC epochs, so readers never take a lock nor write to shared memory.
+ * The index supports only point lookups and unordered full scans, so it is never used for range
+ * scans or ordered scans.
+ */
+class HashPrimaryIndex : public Index {
+private:
+    /**
+     * @struct HashNode
+     * @brief A node in the split-ordered list. Data nodes are followed by the key.
+     */
+    struct HashNode {
+        /** @var The next node in the list. The lowest bit marks a logically removed node. */
+        std::atomic<uintptr_t> m_next;
+
+        /** @var The bit-reversed hash code. The lowest bit is set in data nodes only. */
+        uint64_t m_orderKey;
+
+        /** @var The sentinel mapped to the key (null in bucket nodes). */
+        Sentinel* m_sentinel;
+
+        /** @var The insertion sequence number of the key (zero in bucket nodes). */
+        uint64_t m_insertSeq;
+
+        inline bool IsBucket() const
+        {
+            return (m_orderKey & 1) == 0;
+        }
+
+        inline Key* GetKey()
+        {
+            return reinterpret_cast<Key*>(this + 1);
+        }
+    };
+
+    /** @typedef A bucket points to its bucket node in the list. */
+    typedef std::atomic<HashNode*> Bucket;
+
+    /**
+     * @class HashIterator
+     * @brief An index iterator implementation for a primary hash index. The iterator either points to a
+     * single key (point query), or scans all the keys in no particular order (full scan).
+     * @detail The keys are not ordered, so a full scan cannot end at the last key it should visit.
+     * Instead, it skips the keys inserted after it started, which also prevents an infinite scan in
+     * case of "insert into table A ... as select * from table A".
+     */
+    class HashIterator : public IndexIterator {
+    public:
+        /**
+         * @brief Constructor.
+         * @param node The node of the first item, or null for an exhausted iterator.
+         * @param scan Specifies whether this is a full scan iterator.
+         * @param scanSeq The last insertion sequence number visited by a full scan.
+         */
+        HashIterator(HashNode* node, bool scan, uint64_t scanSeq = 0)
+            : IndexIterator(IteratorType::ITERATOR_TYPE_FORWARD, false, node != nullptr),
+              m_node(node),
+              m_scan(scan),
+              m_scanSeq(scanSeq)
+        {}
+
+        /**
+         * @brief Destructor.
+         */
+        virtual ~HashIterator()
+        {
+            m_node = nullptr;
+        }
+
+        /**
+         * @brief Invalidates the iterator such that subsequent calls to isValid() return false.
+         */
+        virtual void Invalidate()
+        {
+            m_valid = false;
+            m_node = nullptr;
+        }
+
+        /**
+         * @brief Retrieves the key of the currently iterated item.
+         * @return A pointer to the key of the currently iterated item.
+         */
+        virtual const void* GetKey() const
+        {
+            return (m_node != nullptr) ? m_node->GetKey() : nullptr;
+        }
+
+        /**
+         * @brief Retrieves the row of the currently iterated item.
+         * @return A pointer to the row of the currently iterated item.
+         */
+        virtual Row* GetRow() const
+        {
+            return m_node->m_sentinel->GetData();
+        }
+
+        /**
+         * @brief Retrieves the currently iterated primary sentinel.
+         * @return The primary sentinel.
+         */
+        virtual Sentinel* GetPrimarySentinel() const
+        {
+            return m_node->m_sentinel;
+        }
+
+        /**
+         * @brief Moves forwards the iterator to the next item.
+         */
+        virtual void Next()
+        {
+            if (m_node != nullptr) {
+                m_node = m_scan ? NextDataNode(m_node, m_scanSeq) : nullptr;
+            }
+            if (m_node == nullptr) {
+                m_valid = false;
+            }
+        }
+
+        /**
+         * @brief Moves backwards the iterator to the previous item.
+         * @detail Not supported.
+         */
+        virtual void Prev()
+        {
+            MOT_ASSERT(false);
+        }
+
+        /**
+         * @brief Queries whether this index iterator equals to another index iterator.
+         * @param rhs The index iterator with which to compare this iterator.
+         * @return True if iterators point to the same index item, otherwise false.
+         */
+        virtual bool Equals(const IndexIterator* rhs) const
+        {
+            return m_node == static_cast<const HashIterator*>(rhs)->m_node;
+        }
+
+        /**
+         * Serializes the iterator into a buffer.
+         * @detail Not implemented
+         * @param serializeFunc The serialization function.
+         * @param buff The buffer into which the iterator is to be serialized.
+         */
+        virtual void Serialize(serialize_func_t serializeFunc, unsigned char* buff) const
+        {}
+
+        /**
+         * Deserializes the iterator from a buffer.
+         * @detail Not implemented
+         * @param deserializeFunc The deserialization function.
+         * @param buff The buffer from which the iterator is to be deserialized.
+         */
+        virtual void Deserialize(deserialize_func_t deserializeFunc, unsigned char* buff)
+        {}
+
+    private:
+        /** @var The currently iterated node. */
+        HashNode* m_node;
+
+        /** @var Specifies whether this is a full scan iterator. */
+        bool m_scan;
+
+        /** @var Keys inserted after this sequence number are skipped by a full scan. */
+        uint64_t m_scanSeq;
+    };
+
+public:
+    /**
+     * @brief Default constructor.
+     */
+    HashPrimaryIndex()
+        : Index(MOT::IndexOrder::INDEX_ORDER_PRIMARY, IndexingMethod::INDEXING_METHOD_HASH),
+          m_nodePool(nullptr),
+          m_bucketNodePool(nullptr),
+          m_bucketBits(0),
+          m_count(0),
+          m_insertSeq(0),
+          m_initialized(false)
+    {
+        for (uint32_t i = 0; i < MAX_SEGMENTS; i++) {
+            m_segments[i] = nullptr;
+        }
+    }
+
+    /**
+     * @brief Destructor.
+     */
+    virtual ~HashPrimaryIndex()
+    {
+        if (m_initialized) {
+            m_initialized = false;
+            DestroyPools();
+        }
+    }
+
+    /**
+     * @brief Calculate the Index memory consumption.
+     * @return The amount of memory the Index consumes.
+     */
+    virtual uint64_t GetIndexSize() override;
+
+    /**
+     * @brief Retrieves the number of rows stored in the index.
+     * @return The number of rows stored in the index.
+     */
+    virtual uint64_t GetSize() const
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Destroy all memory pools and init index again.
+     */
+    virtual RC ReInitIndex()
+    {
+        m_initialized = false;
+        DestroyPools();
+
+        return IndexInitImpl(NULL);
+    }
+
+    // Iterator API
+    virtual IndexIterator* Begin(uint32_t pid, bool passive = false) const;
+
+    virtual IndexIterator* Search(
+        const Key* key, bool matchKey, bool forward, uint32_t pid, bool& found, bool passive = false) const;
+
+protected:
+    /**
+     * @brief Implements index initialization.
+     * @param args Null-terminated list of any additional arguments.
+     * @return Return code denoting success or error.
+     */
+    virtual RC IndexInitImpl(void** args);
+
+    virtual Sentinel* IndexInsertImpl(const Key* key, Sentinel* sentinel, bool& inserted, uint32_t pid);
+
+    virtual Sentinel* IndexReadImpl(const Key* key, uint32_t pid) const;
+
+    virtual Sentinel* IndexRemoveImpl(const Key* key, uint32_t pid);
+
+private:
+    /** @var The first segment holds 2^INITIAL_BUCKET_BITS buckets, each following segment doubles the table. */
+    static constexpr uint32_t INITIAL_BUCKET_BITS = 6;
+
+    /** @var Maximum number of bucket segments (up to 2^31 buckets). */
+    static constexpr uint32_t MAX_SEGMENTS = 26;
+
+    /** @var Maximum number of bits in a bucket index. */
+    static constexpr uint32_t MAX_BUCKET_BITS = INITIAL_BUCKET_BITS + MAX_SEGMENTS - 1;
+
+    /** @var The table grows when the average number of keys per bucket exceeds this value. */
+    static constexpr uint64_t MAX_LOAD_FACTOR = 2;
+
+    /** @var Memory pool for data nodes (node and key). */
+    ObjAllocInterface* m_nodePool;
+
+    /** @var Memory pool for bucket nodes. */
+    ObjAllocInterface* m_bucketNodePool;
+
+    /** @var Lazily allocated bucket segments (also allocated by lookups). */
+    mutable std::atomic<Bucket*> m_segments[MAX_SEGMENTS];
+
+    /** @var The current number of buckets is 2^m_bucketBits. */
+    std::atomic<uint32_t> m_bucketBits;
+
+    /** @var The number of keys in the index. */
+    std::atomic<uint64_t> m_count;
+
+    /** @var The insertion sequence number of the last inserted key. */
+    std::atomic<uint64_t> m_insertSeq;
+
+    /** @var Determine if object is initialized or not. */
+    bool m_initialized;
+
+    /** @brief Init the node pools. */
+    bool InitPools();
+
+    /** @brief Destroy the node pools and the bucket segments. */
+    void DestroyPools();
+
+    static inline HashNode* NodePtr(uintptr_t link)
+    {
+        return reinterpret_cast<HashNode*>(link & ~(uintptr_t)1);
+    }
+
+    static inline bool IsMarked(uintptr_t link)
+    {
+        return (link & 1) != 0;
+    }
+
+    /**
+     * @brief Retrieves the next data node that was not removed, or null at the end of the list.
+     * @param node The node to start from.
+     * @param scanSeq Data nodes inserted after this sequence number are skipped.
+     */
+    static HashNode* NextDataNode(HashNode* node, uint64_t scanSeq);
+
+    /** @brief Compares a node with a search key, first by order key then by key bytes. */
+    inline int CompareNode(HashNode* node, uint64_t orderKey, const uint8_t* keyBuf) const
+    {
+        if (node->m_orderKey != orderKey) {
+            return (node->m_orderKey < orderKey) ? -1 : 1;
+        }
+        return (keyBuf == nullptr) ? 0 : memcmp(node->GetKey()->GetKeyBuf(), keyBuf, m_keyLength);
+    }
+
+    /** @brief Retrieves the bucket node of the bucket of a hash code, linking it on first access. */
+    HashNode* GetBucketNode(uint64_t hash) const;
+
+    /** @brief Retrieves the slot of a bucket, allocating its segment on first access. */
+    Bucket* GetBucketSlot(uint64_t bucket) const;
+
+    /** @brief Links the bucket node of a bucket to the list (after the bucket node of its parent). */
+    HashNode* InitBucket(uint64_t bucket) const;
+
+    /**
+     * @brief Searches the list starting at a bucket node, unlinking any removed node on the way.
+     * @param head The bucket node to start from.
+     * @param orderKey The order key to search.
+     * @param keyBuf The key to search (null when searching a bucket node).
+     * @param[out] prev The link pointing to the resulting node.
+     * @param[out] curr The first node not smaller than the searched key, or null.
+     * @return True if the key was found.
+     */
+    bool ListFind(HashNode* head, uint64_t orderKey, const uint8_t* keyBuf, std::atomic<uintptr_t>*& prev,
+        HashNode*& curr) const;
+
+    /** @brief Hands an unlinked node to the GC for deferred reclamation. */
+    void RetireNode(HashNode* node) const;
+
+    /** @brief Doubles the number of buckets if the table is overloaded. */
+    void TryGrow(uint64_t count);
+
+    /**
+     * @brief Static callback function for deallocate nodes from pools.
+     * @param pool Pool to deallocate from.
+     * @param ptr Pointer to allocated memory.
+     * @param dropIndex Indicates if this callback is part of drop index process.
+     * @return Size of memory that was deallocated.
+     */
+    static uint32_t DeallocateNodeCallBack(void* pool, void* ptr, bool dropIndex);
+
+    DECLARE_CLASS_LOGGER()
+};
+}  // namespace MOT
+
+#endif /* HASH_PRIMARY_INDEX_H */
@@ -204,6 +204,15 @@ public:
         return m_indexingMethod;
     }
 
+    /**
+     * @brief Queries whether the index keeps its keys ordered, and therefore supports range scans.
+     * @return True if the index is ordered.
+     */
+    inline bool IsOrdered() const
+    {
+        return m_indexingMethod == IndexingMethod::INDEXING_METHOD_TREE;
+    }
+
     /**
      * @brief Retrieves the number of rows stored in the index. This may be an estimation.
      * @return The number of rows stored in the index.
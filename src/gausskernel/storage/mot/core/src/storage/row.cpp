@@ -39,6 +39,7 @@ Row::Row(const Row& src)
       m_table(src.m_table),
       m_surrogateKey(src.m_surrogateKey),
       m_pSentinel(src.m_pSentinel),
+      m_prevVersion(nullptr),
       m_rowId(src.m_rowId),
       m_keyType(src.m_keyType),
       m_twoPhaseRecoverMode(src.m_twoPhaseRecoverMode)
@@ -67,6 +68,12 @@ RC Row::GetRow(AccessType type, TxnAccess* txn, Row* row, TransactionId& lastTid
     return this->m_rowHeader.GetLocalCopy(txn, type, row, this, lastTid);
 }
 
+RC Row::GetSnapshotRow(Row* row, uint64_t snapshotCsn) const
+{
+    row->m_table = GetTable();
+    return this->m_rowHeader.GetSnapshotCopy(row, this, snapshotCsn);
+}
+
 Row* Row::CreateCopy()
 {
     Row* row = m_table->CreateNewRow();
@@ -255,6 +255,23 @@ public:
      */
     RC GetRow(AccessType type, TxnAccess* txn, Row* row, TransactionId& lastTid) const;
 
+    /**
+     * @brief Reads the version of the row that was committed at a snapshot (MVCC).
+     * @param[out] row Receives a copy of the row version.
+     * @param snapshotCsn The snapshot commit sequence number.
+     * @return RC_OK if the row was visible at the snapshot, otherwise RC_LOCAL_ROW_NOT_FOUND.
+     */
+    RC GetSnapshotRow(Row* row, uint64_t snapshotCsn) const;
+
+    /**
+     * @brief Retrieves the previous committed version of the row (MVCC).
+     * @return The previous version, or null if older versions are not kept.
+     */
+    inline Row* GetPrevVersion() const
+    {
+        return m_prevVersion;
+    }
+
     /**
      * @brief Class specific in-place new operator.
      * @param size Object size in bytes.
@@ -562,6 +579,9 @@ protected:
     /** @var The reference to the sentinel that points to this row. */
     Sentinel* m_pSentinel = nullptr;
 
+    /** @var The previous committed version of the row, kept for snapshot reads (MVCC). */
+    Row* volatile m_prevVersion = nullptr;
+
     /** @var the row id. */
     uint64_t m_rowId;
 
@@ -774,6 +774,25 @@ public:
         return m_rowCount;
     }
 
+    /**
+     * @brief Records the commit sequence number of a transaction that deleted rows from the table (MVCC).
+     * @param csn The commit sequence number of the deleting transaction.
+     */
+    inline void SetLastDeleteCsn(uint64_t csn)
+    {
+        uint64_t lastCsn = m_lastDeleteCsn.load();
+        while (lastCsn < csn && !m_lastDeleteCsn.compare_exchange_weak(lastCsn, csn)) {
+        }
+    }
+
+    /**
+     * @brief Retrieves the highest commit sequence number of a transaction that deleted rows from the table.
+     */
+    inline uint64_t GetLastDeleteCsn() const
+    {
+        return m_lastDeleteCsn.load();
+    }
+
     /**
      * @brief Returns table size in memory
      */
@@ -931,6 +950,9 @@ private:
 
     uint32_t m_rowCount = 0;
 
+    /** @var The highest commit sequence number of a transaction that deleted rows (MVCC). */
+    std::atomic<uint64_t> m_lastDeleteCsn{0};
+
     DECLARE_CLASS_LOGGER();
 
 public:
@@ -57,7 +57,15 @@ CheckpointManager::CheckpointManager()
       m_id(0),
       m_inProgressId(0),
       m_lastReplayLsn(0),
-      m_emptyCheckpoint(false)
+      m_emptyCheckpoint(false),
+      m_maxDeltaChainLength(GetGlobalConfiguration().m_checkpointDeltaChainLength),
+      m_deltaChainLength(0),
+      m_isDelta(false),
+      m_deltaCapable(false),
+      m_deltaReady(false),
+      m_captureCsn(0),
+      m_lateCsn(UINT64_MAX),
+      m_deltaCsn(0)
 {}
 
 bool CheckpointManager::Initialize()
@@ -105,10 +113,22 @@ bool CheckpointManager::CreateSnapShot()
 
     ResetFlags();
 
+    // Write only the rows changed since the last checkpoint, unless the delta chain
+    // grew long enough to be compacted into a new full checkpoint
+    m_isDelta = (m_deltaReady && m_deltaChainLength < m_maxDeltaChainLength &&
+                 !MOTEngine::GetInstance()->IsRecovering());
+
     // Ensure that there are no transactions that started in Checkpoint COMPLETE
     // phase that are not yet completed
     WaitPrevPhaseCommittedTxnComplete();
 
+    // Parallel redo may complete transactions out of LSN order, so redo is held until the
+    // snapshot is taken to keep the last replay LSN consistent with the captured rows
+    bool isRecovering = MOTEngine::GetInstance()->IsRecovering();
+    if (isRecovering) {
+        GetRecoveryManager()->PauseRedo();
+    }
+
     // Move to PREPARE phase
     m_lock.WrLock();
     MoveToNextPhase();
@@ -131,6 +151,10 @@ bool CheckpointManager::CreateSnapShot()
     MoveToNextPhase();
     m_lock.WrUnlock();
 
+    if (isRecovering) {
+        GetRecoveryManager()->ResumeRedo();
+    }
+
     return !m_errorSet;
 }
 
@@ -176,6 +200,7 @@ bool CheckpointManager::BeginCheckpoint()
     if (!m_errorSet) {
         CompleteCheckpoint();
     }
+    EndDeltaCheckpoint(!m_errorSet);
 
     // No locking required here, as the checkpoint workers have already exited.
     UnlockAndClearTables(m_tasksList);
@@ -218,6 +243,7 @@ bool CheckpointManager::Abort()
         UnlockAndClearTables(m_tasksList);
         UnlockAndClearTables(m_finishedTasks);
         m_numCpTasks = 0;
+        EndDeltaCheckpoint(false);
 
         // Move to rest
         m_lock.WrLock();
@@ -245,6 +271,14 @@ void CheckpointManager::BeginTransaction(TxnManager* txn)
     }
     txn->m_checkpointPhase = m_phase;
     txn->m_checkpointNABit = !m_availableBit;
+    if (m_maxDeltaChainLength > 0) {
+        // A transaction that obtained its CSN before the capture point but commits after it
+        // is not part of the checkpoint, so the next delta checkpoint must not skip its rows
+        uint64_t csn = txn->GetCommitSequenceNumber();
+        uint64_t lateCsn = m_lateCsn;
+        while (csn <= m_captureCsn && csn < lateCsn && !m_lateCsn.compare_exchange_weak(lateCsn, csn)) {
+        }
+    }
     m_counters[m_cntBit].fetch_add(1);
     m_lock.RdUnlock();
 }
@@ -360,6 +394,15 @@ void CheckpointManager::MoveToNextPhase()
             // it is safe to ignore any redo replay before this LSN.
             SetLastReplayLsn(GetRecoveryManager()->GetLastReplayLsn());
         }
+
+        // Rows committed after this point are not part of this checkpoint. The delta checkpoint
+        // writes the rows committed after the previous capture point, including those of late
+        // transactions that committed after it with a lower CSN.
+        uint64_t lateCsn = m_lateCsn.exchange(UINT64_MAX);
+        m_deltaCsn = std::min(m_captureCsn, lateCsn - 1);
+        m_captureCsn = GetCSNManager().GetCurrentCSN();
+        m_deltaCapable = !MOTEngine::GetInstance()->IsRecovering();
+        m_deltaReady = false;
     }
 
     // there are no open transactions from previous phase, we can move forward to next phase
@@ -436,9 +479,68 @@ bool CheckpointManager::ApplyWrite(TxnManager* txnMan, Row* origRow, AccessType
             MOT_LOG_ERROR("Unknown transaction start phase: %s", CheckpointManager::PhaseToString(startPhase));
     }
 
+    if (type == DEL && m_maxDeltaChainLength > 0 && !MOTEngine::GetInstance()->IsRecovering()) {
+        return RecordTombstone(txnMan, origRow);
+    }
+
+    return true;
+}
+
+bool CheckpointManager::RecordTombstone(TxnManager* txn, Row* origRow)
+{
+    MaxKey key;
+    Table* table = origRow->GetTable();
+    Index* index = table->GetPrimaryIndex();
+    key.InitKey(index->GetKeyLength());
+    index->BuildKey(table, origRow, &key);
+
+    // Same as the stable rows: deletes of transactions that started in the CAPTURE or COMPLETE
+    // phases belong to the next checkpoint, all others to the current one (if any).
+    bool bit = txn->m_checkpointNABit;
+    if (txn->m_checkpointPhase == CAPTURE || txn->m_checkpointPhase == COMPLETE) {
+        bit = !bit;
+    }
+
+    Tombstone tombstone;
+    tombstone.m_tableId = table->GetTableId();
+    tombstone.m_csn = txn->GetCommitSequenceNumber();
+    tombstone.m_key.assign((const char*)key.GetKeyBuf(), key.GetKeyLength());
+
+    m_tombstonesLock.lock();
+    m_tombstones[bit].push_back(std::move(tombstone));
+    m_tombstonesLock.unlock();
     return true;
 }
 
+uint64_t CheckpointManager::GetDeltaCsn(Table* table) const
+{
+    if (!m_isDelta || m_fullTables.find(table->GetTableId()) != m_fullTables.end()) {
+        return 0;
+    }
+    return m_deltaCsn;
+}
+
+void CheckpointManager::EndDeltaCheckpoint(bool success)
+{
+    if (success) {
+        m_deltaChainLength = (m_isDelta ? m_deltaChainLength + 1 : 0);
+        m_deltaReady = (m_maxDeltaChainLength > 0 && m_deltaCapable);
+        m_primaryIndexIds.swap(m_curPrimaryIndexIds);
+    } else {
+        // the next checkpoint is a full one
+        m_deltaReady = false;
+    }
+    m_curPrimaryIndexIds.clear();
+    m_fullTables.clear();
+    m_isDelta = false;
+
+    // The deletes of the transactions that are part of this checkpoint are no longer needed,
+    // they were either written to the delta file or the next checkpoint is a full one
+    m_tombstonesLock.lock();
+    std::vector<Tombstone>().swap(m_tombstones[!m_availableBit]);
+    m_tombstonesLock.unlock();
+}
+
 void CheckpointManager::FillTasksQueue()
 {
     if (!m_tasksList.empty()) {
@@ -448,6 +550,23 @@ void CheckpointManager::FillTasksQueue()
     }
     GetTableManager()->AddTablesToList(m_tasksList);
     m_numCpTasks = m_tasksList.size();
+
+    // Tables created or truncated since the last checkpoint have a new primary index,
+    // they are written in full even in a delta checkpoint
+    m_curPrimaryIndexIds.clear();
+    m_fullTables.clear();
+    for (Table* table : m_tasksList) {
+        Index* index = table->GetPrimaryIndex();
+        if (index == nullptr) {
+            continue;
+        }
+        uint32_t tableId = table->GetTableId();
+        m_curPrimaryIndexIds[tableId] = index->GetIndexId();
+        std::map<uint32_t, uint32_t>::iterator it = m_primaryIndexIds.find(tableId);
+        if (it == m_primaryIndexIds.end() || it->second != index->GetIndexId()) {
+            (void)m_fullTables.insert(tableId);
+        }
+    }
     m_mapfileInfo.clear();
     MOT_LOG_DEBUG("CheckpointManager::fillTasksQueue:: got %d tasks", m_tasksList.size());
 }
@@ -514,6 +633,11 @@ void CheckpointManager::CompleteCheckpoint()
         return;
     }
 
+    if (m_isDelta && !CreateDeltaFile()) {
+        OnError(CheckpointWorkerPool::ErrCodes::FILE_IO, "Failed to create delta file");
+        return;
+    }
+
     if (!ctrlFile->IsValid()) {
         OnError(CheckpointWorkerPool::ErrCodes::FILE_IO, "Invalid control file");
         return;
@@ -544,7 +668,7 @@ void CheckpointManager::CompleteCheckpoint()
     }
 
     RemoveOldCheckpoints(m_inProgressId);
-    MOT_LOG_INFO("Checkpoint [%lu] completed", m_inProgressId);
+    MOT_LOG_INFO("Checkpoint [%lu] completed (%s)", m_inProgressId, m_isDelta ? "delta" : "full");
 }
 
 void CheckpointManager::DestroyCheckpointers()
@@ -568,6 +692,7 @@ void CheckpointManager::Capture()
     if (m_numCpTasks == 0) {
         MOT_LOG_INFO("No tasks in queue - empty checkpoint");
         m_emptyCheckpoint = true;
+        m_isDelta = false;
         m_checkpointEnded = true;
     } else {
         DestroyCheckpointers();
@@ -581,6 +706,13 @@ void CheckpointManager::Capture()
 
 void CheckpointManager::RemoveOldCheckpoints(uint64_t curCheckcpointId)
 {
+    // A delta checkpoint needs all its parents up to the last full checkpoint
+    std::vector<uint64_t> chain;
+    if (!CheckpointUtils::GetCheckpointChain(curCheckcpointId, chain)) {
+        MOT_LOG_ERROR("RemoveOldCheckpoints: failed to resolve the delta chain of checkpoint %lu", curCheckcpointId);
+        return;
+    }
+
     std::string workingDir = "";
     if (CheckpointUtils::GetWorkingDir(workingDir) == false) {
         MOT_LOG_ERROR("RemoveOldCheckpoints: failed to get the working dir");
@@ -604,7 +736,7 @@ void CheckpointManager::RemoveOldCheckpoints(uint64_t curCheckcpointId)
             }
 
             uint64_t chkptId = strtoll(p->d_name + strlen(CheckpointUtils::dirPrefix), NULL, 10);
-            if (chkptId == curCheckcpointId) {
+            if (std::find(chain.begin(), chain.end(), chkptId) != chain.end()) {
                 MOT_LOG_DEBUG("RemoveOldCheckpoints: exclude %lu", chkptId);
                 continue;
             }
@@ -789,6 +921,22 @@ bool CheckpointManager::GetCheckpointDirName(std::string& dirName)
     return true;
 }
 
+bool CheckpointManager::GetCheckpointParentDirNames(std::vector<std::string>& dirNames)
+{
+    std::vector<uint64_t> chain;
+    uint64_t checkpointId = GetRecoveryManager()->GetCheckpointId();
+    if (!CheckpointUtils::GetCheckpointChain(checkpointId, chain)) {
+        MOT_LOG_ERROR("GetCheckpointChain failed");
+        return false;
+    }
+    for (size_t i = 1; i < chain.size(); i++) {
+        std::string dirName;
+        (void)CheckpointUtils::SetDirName(dirName, chain[i]);
+        dirNames.push_back(dirName);
+    }
+    return true;
+}
+
 bool CheckpointManager::GetCheckpointWorkingDir(std::string& workingDir)
 {
     if (!CheckpointUtils::GetWorkingDir(workingDir)) {
@@ -864,6 +1012,112 @@ bool CheckpointManager::CreateTpcRecoveryFile()
     return ret;
 }
 
+bool CheckpointManager::CreateDeltaFile()
+{
+    int fd = -1;
+    std::string fileName;
+    std::string workingDir;
+    bool ret = false;
+    Buffer buffer;
+
+    // No locking required, transactions record their deletes in the other tombstones list
+    // until the next checkpoint starts
+    std::vector<Tombstone>& tombstones = m_tombstones[!m_availableBit];
+
+    do {
+        if (!buffer.Initialize()) {
+            MOT_LOG_ERROR("CreateDeltaFile: failed to initialize buffer");
+            break;
+        }
+
+        if (!CheckpointUtils::SetWorkingDir(workingDir, m_inProgressId)) {
+            break;
+        }
+
+        CheckpointUtils::MakeDeltaFilename(fileName, workingDir, m_inProgressId);
+        if (!CheckpointUtils::OpenFileWrite(fileName, fd)) {
+            MOT_LOG_ERROR(
+                "CreateDeltaFile: failed to create file '%s' - %d - %s", fileName.c_str(), errno, gs_strerror(errno));
+            break;
+        }
+
+        // deletes from tables that were dropped or are written in full are not needed
+        uint64_t numTombstones = 0;
+        for (const Tombstone& tombstone : tombstones) {
+            if (m_curPrimaryIndexIds.count(tombstone.m_tableId) != 0 && m_fullTables.count(tombstone.m_tableId) == 0) {
+                numTombstones++;
+            }
+        }
+
+        CheckpointUtils::DeltaFileHeader deltaFileHeader{CP_MGR_MAGIC, m_id, m_fullTables.size(), numTombstones};
+        if (!buffer.Append(&deltaFileHeader, sizeof(CheckpointUtils::DeltaFileHeader))) {
+            MOT_LOG_ERROR("CreateDeltaFile: failed to write delta file's header");
+            break;
+        }
+
+        bool writeSucceeded = true;
+        for (uint32_t tableId : m_fullTables) {
+            if (!buffer.Append(tableId)) {
+                writeSucceeded = false;
+                break;
+            }
+        }
+
+        for (const Tombstone& tombstone : tombstones) {
+            if (!writeSucceeded) {
+                break;
+            }
+            if (m_curPrimaryIndexIds.count(tombstone.m_tableId) == 0 || m_fullTables.count(tombstone.m_tableId) != 0) {
+                continue;
+            }
+            CheckpointUtils::TombstoneHeader tombstoneHeader;
+            tombstoneHeader.m_csn = tombstone.m_csn;
+            tombstoneHeader.m_tableId = tombstone.m_tableId;
+            tombstoneHeader.m_keyLen = tombstone.m_key.length();
+            if (buffer.FreeSize() < sizeof(CheckpointUtils::TombstoneHeader) + tombstoneHeader.m_keyLen) {
+                if (CheckpointUtils::WriteFile(fd, (char*)buffer.Data(), buffer.Size()) != buffer.Size()) {
+                    writeSucceeded = false;
+                    break;
+                }
+                buffer.Reset();
+            }
+            if (!buffer.Append(&tombstoneHeader, sizeof(CheckpointUtils::TombstoneHeader)) ||
+                !buffer.Append(tombstone.m_key.data(), tombstoneHeader.m_keyLen)) {
+                writeSucceeded = false;
+            }
+        }
+
+        if (!writeSucceeded || (buffer.Size() > 0 && CheckpointUtils::WriteFile(fd, (char*)buffer.Data(),
+                                                         buffer.Size()) != buffer.Size())) {
+            MOT_LOG_ERROR("CreateDeltaFile: failed to write delta file (%d %s)", errno, gs_strerror(errno));
+            break;
+        }
+
+        if (CheckpointUtils::FlushFile(fd)) {
+            MOT_LOG_ERROR("CreateDeltaFile: failed to flush delta file");
+            break;
+        }
+
+        if (CheckpointUtils::CloseFile(fd)) {
+            MOT_LOG_ERROR("CreateDeltaFile: failed to close delta file");
+            break;
+        }
+        fd = -1;
+
+        MOT_LOG_INFO("CreateDeltaFile: checkpoint %lu is a delta of %lu (%lu tables written in full, %lu deletes)",
+            m_inProgressId,
+            m_id,
+            m_fullTables.size(),
+            numTombstones);
+        ret = true;
+    } while (0);
+
+    if (fd != -1) {
+        (void)CheckpointUtils::CloseFile(fd);
+    }
+    return ret;
+}
+
 bool CheckpointManager::CreateEndFile()
 {
     int fd = -1;
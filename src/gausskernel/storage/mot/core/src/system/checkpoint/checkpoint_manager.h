@@ -33,6 +33,9 @@
 #include "txn.h"
 #include "txn_access.h"
 #include <queue>
+#include <map>
+#include <set>
+#include <vector>
 #include "checkpoint_worker.h"
 #include "checkpoint_ctrlfile.h"
 #include "spin_lock.h"
@@ -121,6 +124,14 @@ public:
         return m_stopFlag;
     }
 
+    /**
+     * @brief Returns the CSN above which rows of a table are written in the
+     * current checkpoint.
+     * @param table The table's pointer.
+     * @return The delta CSN, or 0 if the table is written in full.
+     */
+    virtual uint64_t GetDeltaCsn(Table* table) const;
+
     /**
      * @brief Checkpoint task error callback
      * @param errCode The error's code.
@@ -181,6 +192,14 @@ public:
 
     bool GetCheckpointDirName(std::string& dirName);
 
+    /**
+     * @brief Returns the directory names of the parent checkpoints needed to
+     * recover the current checkpoint, if it is a delta checkpoint.
+     * @param dirNames The returned directory names.
+     * @return Boolean value denoting success or failure.
+     */
+    bool GetCheckpointParentDirNames(std::vector<std::string>& dirNames);
+
     bool GetCheckpointWorkingDir(std::string& workingDir);
 
     CheckpointManager(const CheckpointManager& orig) = delete;
@@ -192,6 +211,17 @@ public:
         uint32_t m_numSegs;
     };
 
+    /**
+     * @struct Tombstone
+     * @brief Describes a row deleted since the last checkpoint by its table id,
+     * primary key and the CSN of the deleting transaction.
+     */
+    struct Tombstone {
+        uint32_t m_tableId;
+        uint64_t m_csn;
+        std::string m_key;
+    };
+
 private:
     RwLock m_lock;
 
@@ -263,6 +293,45 @@ private:
 
     bool m_emptyCheckpoint;
 
+    // Maximum number of delta checkpoints on top of a full one (0 disables delta checkpoints)
+    uint32_t m_maxDeltaChainLength;
+
+    // Number of delta checkpoints taken since the last full checkpoint
+    uint32_t m_deltaChainLength;
+
+    // Indicates the in-progress checkpoint is a delta checkpoint
+    bool m_isDelta;
+
+    // Indicates the in-progress checkpoint may serve as the parent of a delta checkpoint
+    bool m_deltaCapable;
+
+    // Indicates the last completed checkpoint may serve as the parent of a delta checkpoint
+    bool m_deltaReady;
+
+    // The CSN at the capture point of the last checkpoint
+    uint64_t m_captureCsn;
+
+    // The lowest CSN lower than m_captureCsn of transactions that committed after the capture point
+    std::atomic<uint64_t> m_lateCsn;
+
+    // Rows with a higher CSN are written by the in-progress delta checkpoint
+    uint64_t m_deltaCsn;
+
+    // Primary index ids of the tables at the last checkpoint, used to detect truncated tables
+    std::map<uint32_t, uint32_t> m_primaryIndexIds;
+
+    // Primary index ids of the tables in the in-progress checkpoint
+    std::map<uint32_t, uint32_t> m_curPrimaryIndexIds;
+
+    // Tables that are written in full by the in-progress delta checkpoint
+    std::set<uint32_t> m_fullTables;
+
+    // Rows deleted since the last checkpoint, zigzagged by the checkpoint NA bit like the CALC stable rows
+    std::vector<Tombstone> m_tombstones[2];
+
+    // Spinlock for tombstones recording
+    spin_lock m_tombstonesLock;
+
     // this lock guards gs_ctl checkpoint fetching
     pthread_rwlock_t m_fetchLock;
 
@@ -377,6 +446,28 @@ private:
      */
     bool CreateTpcRecoveryFile();
 
+    /**
+     * @brief Creates the delta checkpoint descriptor file: the parent checkpoint
+     * id, the tables written in full and the rows deleted since the parent.
+     * @return Boolean value denoting success or failure.
+     */
+    bool CreateDeltaFile();
+
+    /**
+     * @brief Records the primary key of a row deleted by a committing transaction
+     * for the next delta checkpoint.
+     * @param txn Transaction's TxnManger pointer.
+     * @param origRow The deleted row.
+     * @return Boolean value denoting success or failure.
+     */
+    bool RecordTombstone(TxnManager* txn, Row* origRow);
+
+    /**
+     * @brief Concludes the delta checkpoint state at the end of a checkpoint.
+     * @param success Indicates whether the checkpoint completed successfully.
+     */
+    void EndDeltaCheckpoint(bool success);
+
     /**
      * @brief Creates a file that indicates checkpoint completion.
      * @return Boolean value denoting success or failure.
@@ -146,6 +146,62 @@ extern bool GetWorkingDir(std::string& dir)
     return true;
 }
 
+extern bool ReadDeltaFileHeader(uint64_t cpId, DeltaFileHeader& header, bool& isDelta)
+{
+    int fd = -1;
+    std::string fileName;
+    std::string workingDir;
+
+    isDelta = false;
+    if (!SetWorkingDir(workingDir, cpId)) {
+        return false;
+    }
+
+    MakeDeltaFilename(fileName, workingDir, cpId);
+    if (!FileExists(fileName)) {
+        return true; /* a full checkpoint */
+    }
+
+    if (!OpenFileRead(fileName, fd)) {
+        MOT_LOG_ERROR("ReadDeltaFileHeader: failed to open file '%s'", fileName.c_str());
+        return false;
+    }
+
+    if (ReadFile(fd, (char*)&header, sizeof(DeltaFileHeader)) != sizeof(DeltaFileHeader) ||
+        header.m_magic != CP_MGR_MAGIC) {
+        MOT_LOG_ERROR("ReadDeltaFileHeader: file '%s' is corrupted", fileName.c_str());
+        (void)CloseFile(fd);
+        return false;
+    }
+
+    (void)CloseFile(fd);
+    isDelta = true;
+    return true;
+}
+
+extern bool GetCheckpointChain(uint64_t cpId, std::vector<uint64_t>& chain)
+{
+    uint32_t maxLen = MOTConfiguration::MAX_CHECKPOINT_DELTA_CHAIN_LENGTH;
+    chain.clear();
+    chain.push_back(cpId);
+    while (true) {
+        DeltaFileHeader header;
+        bool isDelta = false;
+        if (!ReadDeltaFileHeader(chain.back(), header, isDelta)) {
+            return false;
+        }
+        if (!isDelta) {
+            break;
+        }
+        if (chain.size() > maxLen) {
+            MOT_LOG_ERROR("GetCheckpointChain: delta chain of checkpoint %lu is too long", cpId);
+            return false;
+        }
+        chain.push_back(header.m_parentId);
+    }
+    return true;
+}
+
 extern void Hexdump(const char* msg, char* b, uint32_t buflen)
 {
     unsigned char* buf = (unsigned char*)b;
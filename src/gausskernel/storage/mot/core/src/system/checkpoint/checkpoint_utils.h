@@ -32,6 +32,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <vector>
 
 const uint64_t CP_MGR_MAGIC = 0xaabbccdd;
 
@@ -172,6 +173,9 @@ static const char* tpcFileSuffix = ".tpc";
 // End file suffix
 static const char* validFileSuffix = ".end";
 
+// Delta file suffix
+static const char* deltaFileSuffix = ".dlt";
+
 // Max path len
 static const size_t maxPath = 1024;
 
@@ -292,6 +296,19 @@ inline void MakeEndFilename(std::string& fileName, std::string& workingDir, uint
     fileName.append(validFileSuffix);
 }
 
+/**
+ * @brief Creates a delta checkpoint descriptor filename
+ * @param fileName The returned filename string.
+ * @param workingDir The directory in which the file should be located.
+ * @param cpId The checkpoint id.
+ */
+inline void MakeDeltaFilename(std::string& fileName, std::string& workingDir, uint64_t cpId)
+{
+    MakeFilename(fileName, workingDir);
+    fileName.append(std::to_string(cpId));
+    fileName.append(deltaFileSuffix);
+}
+
 /**
  * @brief Sets the cpu affinity for a given thread
  * @param cpu The cpu that the thread should run on.
@@ -340,6 +357,42 @@ struct TpcEntryHeader {
     uint64_t m_len;
 };
 
+/*
+ * A delta checkpoint holds only the rows changed since its parent checkpoint. Its descriptor
+ * file lists the tables that were nevertheless written in full (new or truncated tables),
+ * followed by the primary keys of the rows deleted since the parent.
+ */
+struct DeltaFileHeader {
+    uint64_t m_magic;
+    uint64_t m_parentId;
+    uint64_t m_numFullTables;
+    uint64_t m_numTombstones;
+};
+
+struct TombstoneHeader {
+    uint64_t m_csn;
+    uint32_t m_tableId;
+    uint16_t m_keyLen;
+};
+
+/**
+ * @brief Reads the header of a checkpoint's delta descriptor file, if there is one.
+ * @param cpId The checkpoint id.
+ * @param header The returned header.
+ * @param isDelta Set to false if the checkpoint is a full one.
+ * @return Boolean value denoting success or failure.
+ */
+extern bool ReadDeltaFileHeader(uint64_t cpId, DeltaFileHeader& header, bool& isDelta);
+
+/**
+ * @brief Resolves the chain of checkpoints needed to restore a checkpoint: the
+ * checkpoint itself followed by its delta parents, ending with a full checkpoint.
+ * @param cpId The checkpoint id.
+ * @param chain The returned checkpoint ids, newest first.
+ * @return Boolean value denoting success or failure.
+ */
+extern bool GetCheckpointChain(uint64_t cpId, std::vector<uint64_t>& chain);
+
 /**
  * @brief Produces a pretty hex printout of a given buffer to stderr
  * @param msg A text the will be displayed before the hex data printout.
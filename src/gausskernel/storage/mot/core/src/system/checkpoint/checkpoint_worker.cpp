@@ -123,7 +123,13 @@ bool CheckpointWorkerPool::Write(Buffer* buffer, Row* row, int fd)
     return true;
 }
 
-int CheckpointWorkerPool::Checkpoint(Buffer* buffer, Sentinel* sentinel, int fd, int tid, bool& isDeleted)
+bool CheckpointWorkerPool::IsChangedRow(const Row* row, uint64_t deltaCsn)
+{
+    return (deltaCsn == 0 || row->GetCommitSequenceNumber() > deltaCsn);
+}
+
+int CheckpointWorkerPool::Checkpoint(
+    Buffer* buffer, Sentinel* sentinel, int fd, int tid, bool& isDeleted, uint64_t deltaCsn)
 {
     Row* mainRow = sentinel->GetData();
     Row* stableRow = nullptr;
@@ -165,15 +171,17 @@ int CheckpointWorkerPool::Checkpoint(Buffer* buffer, Sentinel* sentinel, int fd,
             if (stableRow == nullptr) {
                 break;
             } else {
-                if (!Write(buffer, stableRow, fd)) {
-                    wrote = -1;
-                } else {
-                    if (isDeleted == false) {
-                        CheckpointUtils::DestroyStableRow(stableRow);
-                        sentinel->SetStable(nullptr);
+                if (IsChangedRow(stableRow, deltaCsn)) {
+                    if (!Write(buffer, stableRow, fd)) {
+                        wrote = -1;
+                        break;
                     }
                     wrote = 1;
                 }
+                if (isDeleted == false) {
+                    CheckpointUtils::DestroyStableRow(stableRow);
+                    sentinel->SetStable(nullptr);
+                }
                 break;
             }
         } else { /* no stable version */
@@ -188,7 +196,9 @@ int CheckpointWorkerPool::Checkpoint(Buffer* buffer, Sentinel* sentinel, int fd,
                     break;
                 }
                 sentinel->SetStableStatus(!m_na);
-                if (!Write(buffer, mainRow, fd)) {
+                if (!IsChangedRow(mainRow, deltaCsn)) {
+                    wrote = 0;  // unchanged since the parent checkpoint
+                } else if (!Write(buffer, mainRow, fd)) {
                     wrote = -1;  // we failed to write, set error
                 } else {
                     wrote = 1;
@@ -291,6 +301,7 @@ void CheckpointWorkerPool::WorkerFunc()
                 uint32_t overallOps = 0;
                 tableId = table->GetTableId();
                 exId = table->GetTableExId();
+                uint64_t deltaCsn = m_cpManager.GetDeltaCsn(table);
                 size_t tableSize = table->SerializeSize();
                 char* tableBuf = new (std::nothrow) char[tableSize];
                 if (tableBuf == nullptr) {
@@ -384,7 +395,7 @@ void CheckpointWorkerPool::WorkerFunc()
                         it->Next();
                         continue;
                     }
-                    int ckptStatus = Checkpoint(&buffer, Sentinel, fd, threadId, isDeleted);
+                    int ckptStatus = Checkpoint(&buffer, Sentinel, fd, threadId, isDeleted, deltaCsn);
                     if (isDeleted) {
                         deletedList[deletedListLocation++] = Sentinel;
                         ExecuteMicroGcTransaction(deletedList, gcSession, table, deletedListLocation, DELETE_LIST_SIZE);
@@ -470,8 +481,9 @@ void CheckpointWorkerPool::WorkerFunc()
                  * (/1000) is to convert nano seconds to micro seconds
                  */
                 uint64_t deltaUs = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
-                MOT_LOG_DEBUG(
-                    "CheckpointWorkerPool::workerFunc: checkpoint of table %u completed in %luus, (%lu elements)",
+                MOT_LOG_DEBUG("CheckpointWorkerPool::workerFunc: %s checkpoint of table %u completed in %luus, (%lu "
+                              "elements)",
+                    deltaCsn != 0 ? "delta" : "full",
                     tableId,
                     deltaUs,
                     overallOps);
@@ -59,6 +59,14 @@ public:
      */
     virtual bool ShouldStop() const = 0;
 
+    /**
+     * @brief Returns the CSN of the parent checkpoint when the table is written
+     * as part of a delta checkpoint. Only rows with a higher CSN are written.
+     * @param table The table's pointer.
+     * @return The delta CSN, or 0 if the table should be written in full.
+     */
+    virtual uint64_t GetDeltaCsn(Table* table) const = 0;
+
     /**
      * @brief Checkpoint task error callback
      * @param errCode The error's code.
@@ -115,9 +123,18 @@ private:
      * @param fd The file descriptor to write to.
      * @param tid The thread id.
      * @param isDeleted The row delete status.
+     * @param deltaCsn Rows with a lower or equal CSN are unchanged and are not written (0 writes all rows).
      * @return Int equal to -1 on error, 0 if nothing was written and 1 if the row was written.
      */
-    int Checkpoint(Buffer* buffer, Sentinel* sentinel, int fd, int tid, bool& isDeleted);
+    int Checkpoint(Buffer* buffer, Sentinel* sentinel, int fd, int tid, bool& isDeleted, uint64_t deltaCsn);
+
+    /**
+     * @brief Checks if a row changed since the parent of a delta checkpoint.
+     * @param row The row to check.
+     * @param deltaCsn The delta CSN, 0 if all rows are considered changed.
+     * @return Boolean value denoting whether the row should be written.
+     */
+    static bool IsChangedRow(const Row* row, uint64_t deltaCsn);
 
     /**
      * @brief Pops a task (table pointer) from the tasks queue.
@@ -69,10 +69,16 @@ constexpr uint64_t MOTConfiguration::MAX_CHECKPOINT_SEGSIZE_BYTES;
 constexpr uint32_t MOTConfiguration::DEFAULT_CHECKPOINT_WORKERS;
 constexpr uint32_t MOTConfiguration::MIN_CHECKPOINT_WORKERS;
 constexpr uint32_t MOTConfiguration::MAX_CHECKPOINT_WORKERS;
+constexpr uint32_t MOTConfiguration::DEFAULT_CHECKPOINT_DELTA_CHAIN_LENGTH;
+constexpr uint32_t MOTConfiguration::MIN_CHECKPOINT_DELTA_CHAIN_LENGTH;
+constexpr uint32_t MOTConfiguration::MAX_CHECKPOINT_DELTA_CHAIN_LENGTH;
 // recovery configuration members
 constexpr uint32_t MOTConfiguration::DEFAULT_CHECKPOINT_RECOVERY_WORKERS;
 constexpr uint32_t MOTConfiguration::MIN_CHECKPOINT_RECOVERY_WORKERS;
 constexpr uint32_t MOTConfiguration::MAX_CHECKPOINT_RECOVERY_WORKERS;
+constexpr uint32_t MOTConfiguration::DEFAULT_REDO_RECOVERY_WORKERS;
+constexpr uint32_t MOTConfiguration::MIN_REDO_RECOVERY_WORKERS;
+constexpr uint32_t MOTConfiguration::MAX_REDO_RECOVERY_WORKERS;
 constexpr bool MOTConfiguration::DEFAULT_ENABLE_LOG_RECOVERY_STATS;
 // machine configuration members
 constexpr uint16_t MOTConfiguration::DEFAULT_NUMA_NODES;
@@ -158,6 +164,7 @@ constexpr uint64_t MOTConfiguration::MIN_SESSION_MAX_HUGE_OBJECT_SIZE_MB;
 constexpr uint64_t MOTConfiguration::MAX_SESSION_MAX_HUGE_OBJECT_SIZE_MB;
 // GC configuration members
 constexpr bool MOTConfiguration::DEFAULT_GC_ENABLE;
+constexpr bool MOTConfiguration::DEFAULT_ENABLE_MVCC;
 constexpr const char* MOTConfiguration::DEFAULT_GC_RECLAIM_THRESHOLD;
 constexpr uint64_t MOTConfiguration::DEFAULT_GC_RECLAIM_THRESHOLD_BYTES;
 constexpr uint64_t MOTConfiguration::MIN_GC_RECLAIM_THRESHOLD_BYTES;
@@ -451,7 +458,9 @@ MOTConfiguration::MOTConfiguration()
       m_checkpointDir(DEFAULT_CHECKPOINT_DIR),
       m_checkpointSegThreshold(DEFAULT_CHECKPOINT_SEGSIZE_BYTES),
       m_checkpointWorkers(DEFAULT_CHECKPOINT_WORKERS),
+      m_checkpointDeltaChainLength(DEFAULT_CHECKPOINT_DELTA_CHAIN_LENGTH),
       m_checkpointRecoveryWorkers(DEFAULT_CHECKPOINT_RECOVERY_WORKERS),
+      m_redoRecoveryWorkers(DEFAULT_REDO_RECOVERY_WORKERS),
       m_abortBufferEnable(true),
       m_preAbort(true),
       m_validationLock(TxnValidation::TXN_VALIDATION_NO_WAIT),
@@ -499,6 +508,7 @@ MOTConfiguration::MOTConfiguration()
       m_gcReclaimThresholdBytes(DEFAULT_GC_RECLAIM_THRESHOLD_BYTES),
       m_gcReclaimBatchSize(DEFAULT_GC_RECLAIM_BATCH_SIZE),
       m_gcHighReclaimThresholdBytes(DEFAULT_GC_HIGH_RECLAIM_THRESHOLD_BYTES),
+      m_enableMvcc(DEFAULT_ENABLE_MVCC),
       m_enableCodegen(DEFAULT_ENABLE_MOT_CODEGEN),
       m_forcePseudoCodegen(DEFAULT_FORCE_MOT_PSEUDO_CODEGEN),
       m_enableCodegenPrint(DEFAULT_ENABLE_MOT_CODEGEN_PRINT),
@@ -556,7 +566,9 @@ bool MOTConfiguration::SetFlag(const std::string& name, const std::string& value
     } else if (ParseString(name, "checkpoint_dir", value, &m_checkpointDir)) {
     } else if (ParseUint64(name, "checkpoint_segsize", value, &m_checkpointSegThreshold)) {
     } else if (ParseUint32(name, "checkpoint_workers", value, &m_checkpointWorkers)) {
+    } else if (ParseUint32(name, "checkpoint_delta_chain_length", value, &m_checkpointDeltaChainLength)) {
     } else if (ParseUint32(name, "checkpoint_recovery_workers", value, &m_checkpointRecoveryWorkers)) {
+    } else if (ParseUint32(name, "redo_recovery_workers", value, &m_redoRecoveryWorkers)) {
     } else if (ParseBool(name, "abort_buffer_enable", value, &m_abortBufferEnable)) {
     } else if (ParseBool(name, "pre_abort", value, &m_preAbort)) {
     } else if (ParseValidation(name, "validation_lock", value, &m_validationLock)) {
@@ -745,6 +757,11 @@ void MOTConfiguration::LoadConfig()
         DEFAULT_CHECKPOINT_WORKERS,
         MIN_CHECKPOINT_WORKERS,
         MAX_CHECKPOINT_WORKERS);
+    UPDATE_INT_CFG(m_checkpointDeltaChainLength,
+        "checkpoint_delta_chain_length",
+        DEFAULT_CHECKPOINT_DELTA_CHAIN_LENGTH,
+        MIN_CHECKPOINT_DELTA_CHAIN_LENGTH,
+        MAX_CHECKPOINT_DELTA_CHAIN_LENGTH);
 
     // Recovery configuration
     UPDATE_INT_CFG(m_checkpointRecoveryWorkers,
@@ -752,6 +769,11 @@ void MOTConfiguration::LoadConfig()
         DEFAULT_CHECKPOINT_RECOVERY_WORKERS,
         MIN_CHECKPOINT_RECOVERY_WORKERS,
         MAX_CHECKPOINT_RECOVERY_WORKERS);
+    UPDATE_INT_CFG(m_redoRecoveryWorkers,
+        "redo_recovery_workers",
+        DEFAULT_REDO_RECOVERY_WORKERS,
+        MIN_REDO_RECOVERY_WORKERS,
+        MAX_REDO_RECOVERY_WORKERS);
 
     // Tx configuration - not configurable yet
     if (m_loadExtraParams) {
@@ -993,6 +1015,14 @@ void MOTConfiguration::LoadConfig()
         SCALE_BYTES,
         MIN_GC_HIGH_RECLAIM_THRESHOLD_BYTES,
         MAX_GC_HIGH_RECLAIM_THRESHOLD_BYTES);
+    UPDATE_BOOL_CFG(m_enableMvcc, "enable_mvcc", DEFAULT_ENABLE_MVCC);
+
+    if (m_enableMvcc && !m_gcEnable) {
+        if (m_suppressLog == 0) {
+            MOT_LOG_WARN("Disabling enable_mvcc forcibly as the garbage collector is disabled");
+        }
+        UpdateBoolConfigItem(m_enableMvcc, false, "enable_mvcc");
+    }
 
     // JIT configuration
     UPDATE_BOOL_CFG(m_enableCodegen, "enable_mot_codegen", DEFAULT_ENABLE_MOT_CODEGEN);
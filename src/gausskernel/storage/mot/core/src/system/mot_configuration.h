@@ -178,6 +178,9 @@ public:
     /** @var number of worker threads to spawn to perform checkpoint. */
     uint32_t m_checkpointWorkers;
 
+    /** @var Maximum number of delta checkpoints taken on top of a full checkpoint (0 disables delta checkpoints). */
+    uint32_t m_checkpointDeltaChainLength;
+
     /**********************************************************************/
     // Recovery configuration
     /**********************************************************************/
@@ -185,6 +188,9 @@ public:
     /** @var Specifies the number of workers used to recover from checkpoint. */
     uint32_t m_checkpointRecoveryWorkers;
 
+    /** @var Specifies the number of workers used to replay the redo log during recovery (1 for serial replay). */
+    uint32_t m_redoRecoveryWorkers;
+
     /**********************************************************************/
     // Transaction management variables (not configurable)
     /**********************************************************************/
@@ -340,6 +346,9 @@ public:
     /** @var The high threshold in bytes for reclamation to be triggered (per-thread). */
     uint64_t m_gcHighReclaimThresholdBytes;
 
+    /** @var Keep older row versions so that read-only transactions read a CSN snapshot (requires GC). */
+    bool m_enableMvcc;
+
     /**********************************************************************/
     // JIT configuration
     /**********************************************************************/
@@ -465,12 +474,22 @@ public:
     static constexpr uint32_t MIN_CHECKPOINT_WORKERS = 1;
     static constexpr uint32_t MAX_CHECKPOINT_WORKERS = 1024;
 
+    /** @var Default maximum length of a delta checkpoint chain */
+    static constexpr uint32_t DEFAULT_CHECKPOINT_DELTA_CHAIN_LENGTH = 0;
+    static constexpr uint32_t MIN_CHECKPOINT_DELTA_CHAIN_LENGTH = 0;
+    static constexpr uint32_t MAX_CHECKPOINT_DELTA_CHAIN_LENGTH = 64;
+
     /** ------------------ Default Recovery Configuration ------------ */
     /** @var Default number of workers used in recovery from checkpoint. */
     static constexpr uint32_t DEFAULT_CHECKPOINT_RECOVERY_WORKERS = 3;
     static constexpr uint32_t MIN_CHECKPOINT_RECOVERY_WORKERS = 1;
     static constexpr uint32_t MAX_CHECKPOINT_RECOVERY_WORKERS = 1024;
 
+    /** @var Default number of workers used to replay the redo log during recovery. */
+    static constexpr uint32_t DEFAULT_REDO_RECOVERY_WORKERS = 1;
+    static constexpr uint32_t MIN_REDO_RECOVERY_WORKERS = 1;
+    static constexpr uint32_t MAX_REDO_RECOVERY_WORKERS = 64;
+
     /** @var Default enable log recovery statistics. */
     static constexpr bool DEFAULT_ENABLE_LOG_RECOVERY_STATS = false;
 
@@ -656,6 +675,9 @@ public:
     static constexpr uint64_t MIN_GC_HIGH_RECLAIM_THRESHOLD_BYTES = 1 * MEGA_BYTE;      // 1 MB
     static constexpr uint64_t MAX_GC_HIGH_RECLAIM_THRESHOLD_BYTES = 64 * MEGA_BYTE;     // 64 MB
 
+    /** @var Default enable multi-version snapshot reads. */
+    static constexpr bool DEFAULT_ENABLE_MVCC = false;
+
     /** ------------------ Default JIT Configuration ------------ */
     /** @var Default enable JIT compilation and execution. */
     static constexpr bool DEFAULT_ENABLE_MOT_CODEGEN = true;
@@ -32,6 +32,7 @@
 #include "spin_lock.h"
 #include "transaction_buffer_iterator.h"
 #include "mot_engine.h"
+#include "bitmapset.h"
 
 namespace MOT {
 DECLARE_LOGGER(RecoveryManager, Recovery);
@@ -83,14 +84,14 @@ void RecoveryManager::OnError(int errCode, const char* errMsg, const char* optio
     m_errorLock.unlock();
 }
 
-int RecoveryManager::FillTasksFromMapFile()
+int RecoveryManager::FillTasksFromMapFile(uint64_t checkpointId)
 {
-    if (m_checkpointId == CheckpointControlFile::invalidId) {
+    if (checkpointId == CheckpointControlFile::invalidId) {
         return 0;  // fresh install probably. no error
     }
 
     std::string mapFile;
-    CheckpointUtils::MakeMapFilename(mapFile, m_workingDir, m_checkpointId);
+    CheckpointUtils::MakeMapFilename(mapFile, m_workingDir, checkpointId);
     int fd = -1;
     if (!CheckpointUtils::OpenFileRead(mapFile, fd)) {
         MOT_LOG_ERROR("RecoveryManager::fillTasksFromMapFile: failed to open map file '%s'", mapFile.c_str());
@@ -133,8 +134,19 @@ int RecoveryManager::FillTasksFromMapFile()
             return -1;
         }
 
-        if (m_tableIds.find(entry.m_id) == m_tableIds.end()) {
-            m_tableIds.insert(entry.m_id);
+        if (m_chainPos == 0) {
+            if (m_tableIds.find(entry.m_id) == m_tableIds.end()) {
+                m_tableIds.insert(entry.m_id);
+            }
+        } else {
+            // skip tables that were dropped since, or that a later checkpoint of the chain holds in full
+            if (m_tableIds.find(entry.m_id) == m_tableIds.end()) {
+                continue;
+            }
+            std::map<uint32_t, uint32_t>::iterator it = m_tableFullPos.find(entry.m_id);
+            if (it != m_tableFullPos.end() && it->second < m_chainPos) {
+                continue;
+            }
         }
 
         for (uint32_t i = 0; i <= entry.m_numSegs; i++) {
@@ -275,6 +287,7 @@ bool RecoveryManager::RecoverTableRows(uint32_t tableId, uint32_t seg, uint32_t
         return false;
     }
 
+    bool isDeltaChain = (m_checkpointChain.size() > 1);
     CheckpointUtils::EntryHeader entry;
     for (uint64_t i = 0; i < fileHeader.m_numOps; i++) {
         if (IsRecoveryMemoryLimitReached(m_numWorkers)) {
@@ -323,6 +336,14 @@ bool RecoveryManager::RecoverTableRows(uint32_t tableId, uint32_t seg, uint32_t
             break;
         }
 
+        if (isDeltaChain && IsSupersededRow(table, keyData, entry.m_keyLen, entry.m_csn, tid)) {
+            if (table->GetPrimaryIndex()->IsFakePrimary()) {
+                sState.UpdateMaxKey(entry.m_rowId);
+            }
+            MOT_LOG_DEBUG("Skipped superseded row in table %u with CSN %" PRIu64, tableId, entry.m_csn);
+            continue;
+        }
+
         InsertRowFromCheckpoint(table,
             keyData,
             entry.m_keyLen,
@@ -354,6 +375,122 @@ bool RecoveryManager::RecoverTableRows(uint32_t tableId, uint32_t seg, uint32_t
     return (status == RC_OK);
 }
 
+bool RecoveryManager::IsSupersededRow(Table* table, char* keyData, uint16_t keyLen, uint64_t csn, uint32_t tid)
+{
+    // deleted after the row was checkpointed
+    std::map<uint32_t, std::unordered_map<std::string, uint64_t>>::iterator tableIt =
+        m_tombstones.find(table->GetTableId());
+    if (tableIt != m_tombstones.end()) {
+        std::unordered_map<std::string, uint64_t>::iterator it = tableIt->second.find(std::string(keyData, keyLen));
+        if (it != tableIt->second.end() && it->second >= csn) {
+            return true;
+        }
+    }
+
+    // a newer version was recovered already from a later checkpoint of the chain
+    if (m_chainPos > 0) {
+        MaxKey key;
+        key.CpKey((const uint8_t*)keyData, keyLen);
+        if (table->GetPrimaryIndex()->IndexRead(&key, tid) != nullptr) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RecoveryManager::RecoverDeltaFile(uint32_t chainPos)
+{
+    int fd = -1;
+    std::string fileName;
+    std::string workingDir;
+    bool ret = false;
+    char* keyData = nullptr;
+    uint64_t checkpointId = m_checkpointChain[chainPos];
+
+    do {
+        if (!CheckpointUtils::SetWorkingDir(workingDir, checkpointId)) {
+            break;
+        }
+
+        CheckpointUtils::MakeDeltaFilename(fileName, workingDir, checkpointId);
+        if (!CheckpointUtils::OpenFileRead(fileName, fd)) {
+            MOT_LOG_ERROR("RecoveryManager::recoverDeltaFile: failed to open file '%s'", fileName.c_str());
+            break;
+        }
+
+        CheckpointUtils::DeltaFileHeader deltaFileHeader;
+        if (CheckpointUtils::ReadFile(fd, (char*)&deltaFileHeader, sizeof(CheckpointUtils::DeltaFileHeader)) !=
+                sizeof(CheckpointUtils::DeltaFileHeader) ||
+            deltaFileHeader.m_magic != CP_MGR_MAGIC) {
+            MOT_LOG_ERROR("RecoveryManager::recoverDeltaFile: file: %s is corrupted", fileName.c_str());
+            break;
+        }
+
+        bool readSucceeded = true;
+        for (uint64_t i = 0; i < deltaFileHeader.m_numFullTables; i++) {
+            uint32_t tableId = 0;
+            if (CheckpointUtils::ReadFile(fd, (char*)&tableId, sizeof(uint32_t)) != sizeof(uint32_t)) {
+                readSucceeded = false;
+                break;
+            }
+            // the newest checkpoint that holds the table in full is the first one seen
+            (void)m_tableFullPos.insert(std::make_pair(tableId, chainPos));
+        }
+
+        keyData = (char*)malloc(MAX_KEY_SIZE);
+        if (keyData == nullptr) {
+            MOT_LOG_ERROR("RecoveryManager::recoverDeltaFile: failed to allocate key buffer");
+            break;
+        }
+
+        for (uint64_t i = 0; readSucceeded && i < deltaFileHeader.m_numTombstones; i++) {
+            CheckpointUtils::TombstoneHeader tombstoneHeader;
+            if (CheckpointUtils::ReadFile(fd, (char*)&tombstoneHeader, sizeof(CheckpointUtils::TombstoneHeader)) !=
+                    sizeof(CheckpointUtils::TombstoneHeader) ||
+                tombstoneHeader.m_keyLen > MAX_KEY_SIZE ||
+                CheckpointUtils::ReadFile(fd, keyData, tombstoneHeader.m_keyLen) != tombstoneHeader.m_keyLen) {
+                readSucceeded = false;
+                break;
+            }
+
+            // skip tables that were dropped since, or that a later checkpoint of the chain holds in full
+            uint32_t tableId = tombstoneHeader.m_tableId;
+            if (m_tableIds.find(tableId) == m_tableIds.end()) {
+                continue;
+            }
+            std::map<uint32_t, uint32_t>::iterator it = m_tableFullPos.find(tableId);
+            if (it != m_tableFullPos.end() && it->second < chainPos) {
+                continue;
+            }
+
+            uint64_t& csn = m_tombstones[tableId][std::string(keyData, tombstoneHeader.m_keyLen)];
+            if (csn < tombstoneHeader.m_csn) {
+                csn = tombstoneHeader.m_csn;
+            }
+        }
+
+        if (!readSucceeded) {
+            MOT_LOG_ERROR("RecoveryManager::recoverDeltaFile: failed to read file: %s", fileName.c_str());
+            break;
+        }
+
+        MOT_LOG_INFO("RecoverDeltaFile: checkpoint %lu is a delta of %lu (%lu tables in full, %lu deletes)",
+            checkpointId,
+            deltaFileHeader.m_parentId,
+            deltaFileHeader.m_numFullTables,
+            deltaFileHeader.m_numTombstones);
+        ret = true;
+    } while (0);
+
+    if (fd != -1) {
+        CheckpointUtils::CloseFile(fd);
+    }
+    if (keyData != nullptr) {
+        free(keyData);
+    }
+    return ret;
+}
+
 void RecoveryManager::CpWorkerFunc()
 {
     // since this is a non-kernel thread we must set-up our own u_sess struct for the current thread
@@ -453,16 +590,35 @@ bool RecoveryManager::RecoverFromCheckpoint()
 
     if (m_checkpointId != CheckpointControlFile::invalidId) {
         if (m_lsn >= m_lastReplayLsn) {
-            MOT_LOG_INFO(
-                "Recovery LSN Check will use the LSN (%lu), ignoring the lastReplayLSN (%lu)", m_lsn, m_lastReplayLsn);
+            MOT_LOG_INFO("Recovery LSN Check will use the LSN (%lu), ignoring the lastReplayLSN (%lu)",
+                m_lsn,
+                m_lastReplayLsn.load());
         } else {
-            MOT_LOG_WARN(
-                "Recovery LSN Check will use the lastReplayLSN (%lu), ignoring the LSN (%lu)", m_lastReplayLsn, m_lsn);
+            MOT_LOG_WARN("Recovery LSN Check will use the lastReplayLSN (%lu), ignoring the LSN (%lu)",
+                m_lastReplayLsn.load(),
+                m_lsn);
             m_lsn = m_lastReplayLsn;
         }
     }
 
-    int taskFillStat = FillTasksFromMapFile();
+    if (m_checkpointId != CheckpointControlFile::invalidId) {
+        // a delta checkpoint is recovered together with its parents, up to the last full checkpoint
+        if (!CheckpointUtils::GetCheckpointChain(m_checkpointId, m_checkpointChain)) {
+            MOT_LOG_ERROR("RecoveryManager:: failed to resolve the delta chain of checkpoint %lu", m_checkpointId);
+            OnError(RecoveryManager::ErrCodes::CP_SETUP, "RecoveryManager:: failed to resolve the delta chain");
+            return false;
+        }
+        for (uint32_t i = 1; i < m_checkpointChain.size(); i++) {
+            if (!IsCheckpointValid(m_checkpointChain[i])) {
+                MOT_LOG_ERROR("RecoveryManager:: delta parent checkpoint %lu is invalid", m_checkpointChain[i]);
+                OnError(RecoveryManager::ErrCodes::CP_SETUP, "RecoveryManager:: delta parent checkpoint is invalid");
+                return false;
+            }
+        }
+    }
+
+    m_chainPos = 0;
+    int taskFillStat = FillTasksFromMapFile(m_checkpointId);
     if (taskFillStat < 0) {
         MOT_LOG_INFO("RecoveryManager:: failed to read map file");
         return false;                // error was already set
@@ -497,27 +653,56 @@ bool RecoveryManager::RecoverFromCheckpoint()
         }
     }
 
-    std::vector<std::thread> recoveryThreadPool;
-    for (uint32_t i = 0; i < m_numWorkers; ++i) {
-        recoveryThreadPool.push_back(std::thread(&RecoveryManager::CpWorkerFunc, this));
+    // the last checkpoint of the chain is a full one
+    for (uint32_t i = 0; i + 1 < m_checkpointChain.size(); i++) {
+        if (!RecoverDeltaFile(i)) {
+            OnError(RecoveryManager::ErrCodes::CP_SETUP,
+                "RecoveryManager:: failed to read delta file of checkpoint: ",
+                std::to_string(m_checkpointChain[i]).c_str());
+            return false;
+        }
     }
 
-    MOT_LOG_DEBUG("RecoveryManager:: waiting for all tasks to finish");
-    while (HaveTasks() && m_checkpointWorkerStop == false) {
-        sleep(1);
-    }
+    // Recover the chain from the newest checkpoint to the full one. Older checkpoints only
+    // restore the rows that were neither restored already nor deleted later on.
+    for (m_chainPos = 0; m_chainPos < m_checkpointChain.size(); m_chainPos++) {
+        if (m_chainPos > 0) {
+            if (!CheckpointUtils::SetWorkingDir(m_workingDir, m_checkpointChain[m_chainPos]) ||
+                FillTasksFromMapFile(m_checkpointChain[m_chainPos]) < 0) {
+                MOT_LOG_ERROR("RecoveryManager:: failed to read map file of checkpoint %lu",
+                    m_checkpointChain[m_chainPos]);
+                OnError(RecoveryManager::ErrCodes::CP_SETUP, "RecoveryManager:: failed to read map file");
+                return false;
+            }
+            MOT_LOG_INFO("RecoverFromCheckpoint: recovering delta parent checkpoint id: %lu",
+                m_checkpointChain[m_chainPos]);
+        }
 
-    MOT_LOG_DEBUG("RecoveryManager:: tasks finished (%s)", m_errorSet ? "error" : "ok");
-    for (auto& worker : recoveryThreadPool) {
-        if (worker.joinable()) {
-            worker.join();
+        std::vector<std::thread> recoveryThreadPool;
+        for (uint32_t i = 0; i < m_numWorkers; ++i) {
+            recoveryThreadPool.push_back(std::thread(&RecoveryManager::CpWorkerFunc, this));
         }
-    }
 
-    if (m_errorSet) {
-        MOT_LOG_ERROR("RecoveryManager:: failed to recover from checkpoint, tasks finished with error");
-        return false;
+        MOT_LOG_DEBUG("RecoveryManager:: waiting for all tasks to finish");
+        while (HaveTasks() && m_checkpointWorkerStop == false) {
+            sleep(1);
+        }
+
+        MOT_LOG_DEBUG("RecoveryManager:: tasks finished (%s)", m_errorSet ? "error" : "ok");
+        for (auto& worker : recoveryThreadPool) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+
+        if (m_errorSet) {
+            MOT_LOG_ERROR("RecoveryManager:: failed to recover from checkpoint, tasks finished with error");
+            return false;
+        }
     }
+    m_chainPos = 0;
+    m_tableFullPos.clear();
+    m_tombstones.clear();
 
     if (!RecoverTpcFromCheckpoint()) {
         MOT_LOG_ERROR("RecoveryManager:: failed to recover in-process transactions from checkpoint");
@@ -551,6 +736,9 @@ bool RecoveryManager::RecoverDbStart()
 
 bool RecoveryManager::RecoverDbEnd()
 {
+    // all the committed transactions must be replayed before the in-process ones
+    StopRedoWorkers();
+
     if (ApplyInProcessTransactions() != RC_OK) {
         MOT_LOG_ERROR("applyInProcessTransactions failed!");
         return false;
@@ -582,6 +770,8 @@ void RecoveryManager::CleanUp()
         return;
     }
 
+    StopRedoWorkers();
+
     if (m_logStats != nullptr) {
         delete m_logStats;
         m_logStats = nullptr;
@@ -719,16 +909,15 @@ bool RecoveryManager::OperateOnRecoveredTransaction(
         RedoTransactionSegments* segments = it->second;
         m_inProcessTransactionMap.erase(it);
         if (rState != RecoveryOpState::ABORT) {
-            LogSegment* segment = segments->GetSegment(segments->GetCount() - 1);
-            uint64_t csn = segment->m_controlBlock.m_csn;
-            for (uint32_t i = 0; i < segments->GetCount(); i++) {
-                segment = segments->GetSegment(i);
-                status = RedoSegment(segment, csn, internalTransactionId, rState);
-                if (status != RC_OK) {
-                    OnError(RecoveryManager::ErrCodes::XLOG_RECOVERY,
-                        "RecoveryManager::commitRecoveredTransaction: wal recovery failed");
-                    return false;
-                }
+            if (IsParallelRedo()) {
+                // the redo workers own the segments from now on
+                return DispatchRedoTransaction(segments, internalTransactionId);
+            }
+            status = RedoTransaction(segments, internalTransactionId, rState, m_sState);
+            if (status != RC_OK) {
+                OnError(RecoveryManager::ErrCodes::XLOG_RECOVERY,
+                    "RecoveryManager::commitRecoveredTransaction: wal recovery failed");
+                return false;
             }
         }
         delete segments;
@@ -741,7 +930,24 @@ bool RecoveryManager::OperateOnRecoveredTransaction(
     return true;
 }
 
-RC RecoveryManager::RedoSegment(LogSegment* segment, uint64_t csn, uint64_t transactionId, RecoveryOpState rState)
+RC RecoveryManager::RedoTransaction(
+    RedoTransactionSegments* segments, uint64_t transactionId, RecoveryOpState rState, SurrogateState& sState)
+{
+    RC status = RC_OK;
+    LogSegment* segment = segments->GetSegment(segments->GetCount() - 1);
+    uint64_t csn = segment->m_controlBlock.m_csn;
+    for (uint32_t i = 0; i < segments->GetCount(); i++) {
+        segment = segments->GetSegment(i);
+        status = RedoSegment(segment, csn, transactionId, rState, sState);
+        if (status != RC_OK) {
+            break;
+        }
+    }
+    return status;
+}
+
+RC RecoveryManager::RedoSegment(
+    LogSegment* segment, uint64_t csn, uint64_t transactionId, RecoveryOpState rState, SurrogateState& sState)
 {
     RC status = RC_OK;
     bool is2pcRecovery = !MOTEngine::GetInstance()->IsRecovering();
@@ -749,10 +955,10 @@ RC RecoveryManager::RedoSegment(LogSegment* segment, uint64_t csn, uint64_t tran
     uint8_t* operationData = (uint8_t*)(segment->m_data);
     bool txnStarted = false;
     bool wasCommit = false;
+    uint32_t numRedoThreads = IsParallelRedo() ? m_numRedoWorkers : NUM_REDO_RECOVERY_THREADS;
 
     while (operationData < endPosition) {
-        // redo log recovery - single threaded
-        if (IsRecoveryMemoryLimitReached(NUM_REDO_RECOVERY_THREADS)) {
+        if (IsRecoveryMemoryLimitReached(numRedoThreads)) {
             status = RC_ERROR;
             MOT_LOG_ERROR("Memory hard limit reached. Cannot recover datanode");
             break;
@@ -770,7 +976,7 @@ RC RecoveryManager::RedoSegment(LogSegment* segment, uint64_t csn, uint64_t tran
 
         if (!is2pcRecovery) {
             operationData +=
-                RecoverLogOperation(operationData, csn, transactionId, MOTCurrThreadId, m_sState, status, wasCommit);
+                RecoverLogOperation(operationData, csn, transactionId, MOTCurrThreadId, sState, status, wasCommit);
             // check operation result status
             if (status != RC_OK) {
                 MOT_REPORT_ERROR(MOT_ERROR_RESOURCE_LIMIT, "Recover Redo Segment", "Failed to recover redo segment");
@@ -782,16 +988,16 @@ RC RecoveryManager::RedoSegment(LogSegment* segment, uint64_t csn, uint64_t tran
             }
         } else {
             operationData +=
-                TwoPhaseRecoverOp(rState, operationData, csn, transactionId, MOTCurrThreadId, m_sState, status);
+                TwoPhaseRecoverOp(rState, operationData, csn, transactionId, MOTCurrThreadId, sState, status);
         }
         if (status != RC_OK) {
             break;
         }
     }
 
-    // single threaded, no need for locking or CAS
-    if (!is2pcRecovery && csn > m_maxRecoveredCsn) {
-        m_maxRecoveredCsn = csn;
+    // segments may be replayed concurrently by the parallel redo workers
+    if (!is2pcRecovery) {
+        SetCsnIfGreater(csn);
     }
     if (status != RC_OK) {
         MOT_LOG_ERROR("RecoveryManager::redoSegment: got error %d on tid %lu", status, transactionId);
@@ -799,6 +1005,318 @@ RC RecoveryManager::RedoSegment(LogSegment* segment, uint64_t csn, uint64_t tran
     return status;
 }
 
+bool RecoveryManager::IsParallelRedo() const
+{
+    return m_numRedoWorkers > 1 && MOTEngine::GetInstance()->IsRecovering();
+}
+
+bool RecoveryManager::DispatchRedoTransaction(RedoTransactionSegments* segments, uint64_t transactionId)
+{
+    if (m_errorSet) {
+        delete segments;
+        return false;
+    }
+
+    if (m_redoPartitions == nullptr && !StartRedoWorkers()) {
+        delete segments;
+        return false;
+    }
+
+    uint64_t partitions = 0;
+    if (!GetRedoPartitions(segments, partitions)) {
+        // transactions that cannot be partitioned are replayed after all the preceding ones
+        WaitRedoWorkers();
+        if (m_errorSet) {
+            delete segments;
+            return false;
+        }
+        RC status = RedoTransaction(segments, transactionId, RecoveryOpState::COMMIT, m_sState);
+        delete segments;
+        if (status != RC_OK) {
+            OnError(RecoveryManager::ErrCodes::XLOG_RECOVERY,
+                "RecoveryManager::dispatchRedoTransaction: wal recovery failed");
+            return false;
+        }
+        if (m_logStats != nullptr) {
+            m_logStats->m_serialTxns++;
+        }
+    } else {
+        uint32_t numPartitions = (uint32_t)__builtin_popcountll(partitions);
+        RedoTask* task = new (std::nothrow) RedoTask(segments, transactionId, numPartitions);
+        if (task == nullptr) {
+            delete segments;
+            OnError(RecoveryManager::ErrCodes::XLOG_RECOVERY,
+                "RecoveryManager::dispatchRedoTransaction: failed to allocate redo task");
+            return false;
+        }
+
+        std::unique_lock<std::mutex> dispatchLock(m_redoDispatchLock);
+        while (m_redoPaused) {
+            dispatchLock.unlock();
+            usleep(1000);
+            dispatchLock.lock();
+        }
+        m_redoPending++;
+        dispatchLock.unlock();
+
+        for (uint32_t i = 0; i < m_numRedoWorkers; i++) {
+            if (partitions & (1ULL << i)) {
+                RedoPartition& partition = m_redoPartitions[i];
+                {
+                    std::lock_guard<std::mutex> lock(partition.m_lock);
+                    partition.m_queue.push_back(task);
+                }
+                partition.m_cv.notify_one();
+            }
+        }
+        if (m_logStats != nullptr) {
+            if (numPartitions > 1) {
+                m_logStats->m_crossPartitionTxns++;
+            } else {
+                m_logStats->m_parallelTxns++;
+            }
+        }
+    }
+
+    if (m_logStats != nullptr) {
+        uint64_t dispatched =
+            m_logStats->m_parallelTxns + m_logStats->m_crossPartitionTxns + m_logStats->m_serialTxns;
+        if (dispatched % REDO_PROGRESS_INTERVAL == 0) {
+            m_logStats->PrintRedoProgress();
+        }
+    }
+    return true;
+}
+
+bool RecoveryManager::GetRedoPartitions(RedoTransactionSegments* segments, uint64_t& partitions)
+{
+    partitions = 0;
+    for (uint32_t i = 0; i < segments->GetCount(); i++) {
+        LogSegment* segment = segments->GetSegment(i);
+        uint8_t* endPosition = (uint8_t*)(segment->m_data + segment->m_len);
+        uint8_t* data = (uint8_t*)(segment->m_data);
+        while (data < endPosition) {
+            OperationCode opCode = *(OperationCode*)data;
+            uint8_t* opData = data + sizeof(OperationCode);
+            uint64_t tableId = 0;
+            uint64_t exId = 0;
+            uint64_t rowId = 0;
+            uint64_t rowLength = 0;
+            uint16_t keyLength = 0;
+            uint8_t* keyData = nullptr;
+            Table* table = nullptr;
+            switch (opCode) {
+                case CREATE_ROW:
+                case UPDATE_ROW:
+                case OVERWRITE_ROW:
+                case REMOVE_ROW:
+                    Extract(opData, tableId);
+                    Extract(opData, exId);
+                    if (opCode == CREATE_ROW) {
+                        Extract(opData, rowId);
+                    }
+                    Extract(opData, keyLength);
+                    keyData = ExtractPtr(opData, keyLength);
+                    table = GetTableManager()->GetTableByExternal(exId);
+                    if (table == nullptr) {
+                        // let the serial path report the error
+                        return false;
+                    }
+                    break;
+                case COMMIT_TX:
+                case COMMIT_PREPARED_TX:
+                case PARTIAL_REDO_TX:
+                case PREPARE_TX:
+                case ROLLBACK_TX:
+                case ROLLBACK_PREPARED_TX:
+                    data += sizeof(EndSegmentBlock);
+                    continue;
+                default:
+                    // DDL (or unknown op-codes) are replayed serially
+                    return false;
+            }
+
+            if (opCode == CREATE_ROW || opCode == OVERWRITE_ROW) {
+                Extract(opData, rowLength);
+                opData += rowLength;
+            } else if (opCode == UPDATE_ROW) {
+                uint16_t numColumns = table->GetFieldCount() - 1;
+                BitmapSet updatedColumns(ExtractPtr(opData, BitmapSet::GetLength(numColumns)), numColumns);
+                BitmapSet validColumns(ExtractPtr(opData, BitmapSet::GetLength(numColumns)), numColumns);
+                BitmapSet::BitmapSetIterator updatedColumnsIt(updatedColumns);
+                BitmapSet::BitmapSetIterator validColumnsIt(validColumns);
+                while (!updatedColumnsIt.End()) {
+                    if (updatedColumnsIt.IsSet() && validColumnsIt.IsSet()) {
+                        opData += table->GetField(updatedColumnsIt.GetPosition() + 1)->m_size;
+                    }
+                    validColumnsIt.Next();
+                    updatedColumnsIt.Next();
+                }
+            }
+
+            // rows of a table with a unique secondary index may conflict on other keys than the
+            // primary key, so all the rows of such a table are replayed by the same worker
+            bool partitionByTable = false;
+            for (uint16_t j = 1; j < table->GetNumIndexes(); j++) {
+                if (table->GetSecondaryIndex(j)->GetUnique()) {
+                    partitionByTable = true;
+                    break;
+                }
+            }
+
+            // FNV-1a hash of the table id and the primary key
+            uint64_t hash = 14695981039346656037ULL;
+            for (uint32_t k = 0; k < sizeof(tableId); k++) {
+                hash = (hash ^ ((tableId >> (k * 8)) & 0xFF)) * 1099511628211ULL;
+            }
+            if (!partitionByTable) {
+                for (uint16_t k = 0; k < keyLength; k++) {
+                    hash = (hash ^ keyData[k]) * 1099511628211ULL;
+                }
+            }
+            partitions |= (1ULL << (hash % m_numRedoWorkers));
+            data = opData;
+        }
+    }
+
+    if (partitions == 0) {
+        partitions = (1ULL << (segments->GetSegment(0)->m_controlBlock.m_internalTransactionId % m_numRedoWorkers));
+    }
+    return true;
+}
+
+bool RecoveryManager::StartRedoWorkers()
+{
+    m_redoPartitions = new (std::nothrow) RedoPartition[m_numRedoWorkers];
+    if (m_redoPartitions == nullptr) {
+        OnError(RecoveryManager::ErrCodes::XLOG_SETUP,
+            "RecoveryManager::startRedoWorkers: failed to allocate redo partitions");
+        return false;
+    }
+
+    MOT_LOG_INFO("Starting %u redo recovery workers", m_numRedoWorkers);
+    m_redoWorkersStop = false;
+    for (uint32_t i = 0; i < m_numRedoWorkers; ++i) {
+        m_redoWorkers.push_back(std::thread(&RecoveryManager::RedoWorkerFunc, this, i));
+    }
+    return true;
+}
+
+void RecoveryManager::WaitRedoWorkers()
+{
+    while (m_redoPending != 0) {
+        usleep(100);
+    }
+}
+
+void RecoveryManager::StopRedoWorkers()
+{
+    if (m_redoPartitions == nullptr) {
+        return;
+    }
+
+    WaitRedoWorkers();
+    m_redoWorkersStop = true;
+    for (uint32_t i = 0; i < m_numRedoWorkers; ++i) {
+        std::lock_guard<std::mutex> lock(m_redoPartitions[i].m_lock);
+        m_redoPartitions[i].m_cv.notify_one();
+    }
+    for (auto& worker : m_redoWorkers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    m_redoWorkers.clear();
+    delete[] m_redoPartitions;
+    m_redoPartitions = nullptr;
+    MOT_LOG_INFO("Redo recovery workers stopped");
+}
+
+void RecoveryManager::PauseRedo()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_redoDispatchLock);
+        m_redoPaused = true;
+    }
+    WaitRedoWorkers();
+}
+
+void RecoveryManager::ResumeRedo()
+{
+    std::lock_guard<std::mutex> lock(m_redoDispatchLock);
+    m_redoPaused = false;
+}
+
+void RecoveryManager::ReleaseRedoTask(RedoTask* task)
+{
+    if (task->m_refCount.fetch_sub(1) == 1) {
+        delete task;
+    }
+}
+
+void RecoveryManager::RedoWorkerFunc(uint32_t partitionId)
+{
+    // since this is a non-kernel thread we must set-up our own u_sess struct for the current thread
+    MOT_DECLARE_NON_KERNEL_THREAD();
+
+    MOT::MOTEngine* engine = MOT::MOTEngine::GetInstance();
+    SessionContext* sessionContext = GetSessionManager()->CreateSessionContext();
+    int threadId = MOTCurrThreadId;
+
+    // in a thread-pooled envelope the affinity could be disabled, so we use task affinity here
+    if (GetGlobalConfiguration().m_enableNuma && !GetTaskAffinity().SetAffinity(threadId)) {
+        MOT_LOG_WARN("Failed to set affinity of redo recovery worker, redo recovery performance may be affected");
+    }
+
+    SurrogateState sState;
+    if (sState.IsValid() == false) {
+        OnError(MOT::RecoveryManager::ErrCodes::SURROGATE,
+            "RecoveryManager::redoWorkerFunc failed to allocate surrogate state");
+    }
+    MOT_LOG_DEBUG("RecoveryManager::redoWorkerFunc start [%u] on cpu %lu", (unsigned)MOTCurrThreadId, sched_getcpu());
+
+    RedoPartition& partition = m_redoPartitions[partitionId];
+    while (true) {
+        RedoTask* task = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(partition.m_lock);
+            partition.m_cv.wait(lock, [&]() { return m_redoWorkersStop || !partition.m_queue.empty(); });
+            if (partition.m_queue.empty()) {
+                break;
+            }
+            task = partition.m_queue.front();
+            partition.m_queue.pop_front();
+        }
+
+        // a transaction shared with other workers is replayed by the last worker to reach it,
+        // when all the conflicting transactions preceding it were replayed
+        if (task->m_arrived.fetch_add(1) + 1 == task->m_numPartitions) {
+            if (!m_errorSet) {
+                RC status = RedoTransaction(task->m_segments, task->m_transactionId, RecoveryOpState::COMMIT, sState);
+                if (status != RC_OK) {
+                    OnError(RecoveryManager::ErrCodes::XLOG_RECOVERY,
+                        "RecoveryManager::redoWorkerFunc: wal recovery failed");
+                }
+            }
+            task->m_done = true;
+            m_redoPending--;
+        } else {
+            while (!task->m_done) {
+                std::this_thread::yield();
+            }
+        }
+        ReleaseRedoTask(task);
+    }
+
+    if (!sState.IsEmpty()) {
+        AddSurrogateArrayToList(sState);
+    }
+
+    GetSessionManager()->DestroySessionContext(sessionContext);
+    engine->OnCurrentThreadEnding();
+    MOT_LOG_DEBUG("RecoveryManager::redoWorkerFunc end [%u] on cpu %lu", (unsigned)MOTCurrThreadId, sched_getcpu());
+}
+
 bool RecoveryManager::LogStats::FindIdx(uint64_t tableId, uint64_t& id)
 {
     id = m_numEntries;
@@ -831,6 +1349,22 @@ void RecoveryManager::LogStats::Print()
             m_tableStats[i]->m_deletes.load());
     }
     MOT_LOG_ERROR("Overall tcls: %lu", m_tcls.load());
+    PrintRedoProgress();
+}
+
+void RecoveryManager::LogStats::PrintRedoProgress()
+{
+    uint64_t parallelTxns = m_parallelTxns.load();
+    uint64_t crossPartitionTxns = m_crossPartitionTxns.load();
+    uint64_t serialTxns = m_serialTxns.load();
+    uint64_t totalTxns = parallelTxns + crossPartitionTxns + serialTxns;
+    double seconds = CpuCyclesLevelTime::CyclesToSeconds(GetSysClock() - m_startClock);
+    MOT_LOG_ERROR("Redo transactions: %lu (parallel: %lu, cross-partition: %lu, serial: %lu), %.0f transactions/sec",
+        totalTxns,
+        parallelTxns,
+        crossPartitionTxns,
+        serialTxns,
+        (seconds > 0) ? totalTxns / seconds : 0.0);
 }
 
 void RecoveryManager::SetCsnIfGreater(uint64_t csn)
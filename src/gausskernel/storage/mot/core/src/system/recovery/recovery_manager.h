@@ -27,12 +27,18 @@
 
 #include <set>
 #include <vector>
+#include <map>
+#include <deque>
+#include <thread>
+#include <condition_variable>
+#include <unordered_map>
 #include "checkpoint_ctrlfile.h"
 #include "redo_log_global.h"
 #include "transaction_buffer_iterator.h"
 #include "txn.h"
 #include "global.h"
 #include "mot_configuration.h"
+#include "cycles.h"
 
 namespace MOT {
 typedef TxnCommitStatus (*commitLogStatusCallback)(uint64_t);
@@ -177,9 +183,15 @@ public:
           m_initialized(false),
           m_recoverFromCkptDone(false),
           m_checkpointId(0),
+          m_chainPos(0),
           m_lsn(0),
           m_lastReplayLsn(0),
           m_numWorkers(GetGlobalConfiguration().m_checkpointRecoveryWorkers),
+          m_numRedoWorkers(GetGlobalConfiguration().m_redoRecoveryWorkers),
+          m_redoPartitions(nullptr),
+          m_redoWorkersStop(false),
+          m_redoPaused(false),
+          m_redoPending(0),
           m_tid(0),
           m_maxRecoveredCsn(0),
           m_enableLogStats(GetGlobalConfiguration().m_enableLogRecoveryStats),
@@ -222,6 +234,27 @@ private:
     bool RecoverTableRows(uint32_t tableId, uint32_t seg, uint32_t tid, char* keyData, char* entryData,
         uint64_t& maxCsn, SurrogateState& sState);
 
+    /**
+     * @brief Checks if a checkpointed row is superseded when recovering a delta
+     * checkpoint chain: it was either deleted or restored already from a later
+     * checkpoint of the chain.
+     * @param table The row's table.
+     * @param keyData The row's primary key buffer.
+     * @param keyLen The row's primary key length.
+     * @param csn The row's csn.
+     * @param tid The current thread id
+     * @return Boolean value denoting whether the row should be skipped.
+     */
+    bool IsSupersededRow(Table* table, char* keyData, uint16_t keyLen, uint64_t csn, uint32_t tid);
+
+    /**
+     * @brief Reads a delta checkpoint descriptor file of the checkpoint chain: the
+     * tables it holds in full and the rows deleted since its parent checkpoint.
+     * @param chainPos The checkpoint position in the chain.
+     * @return Boolean value denoting success or failure.
+     */
+    bool RecoverDeltaFile(uint32_t chainPos);
+
     /**
      * @brief Reads and creates a table's defenition from a checkpoint
      * metadata file
@@ -242,10 +275,11 @@ private:
     /**
      * @brief Reads the checkpoint map file and fills the tasks queue
      * with the relevant information.
+     * @param checkpointId The checkpoint id, the current chain position checkpoint.
      * @return Int value where 0 indicates no tasks (empty checkpoint),
      * -1 denotes an error has occured and 1 means a sucess.
      */
-    int FillTasksFromMapFile();
+    int FillTasksFromMapFile(uint64_t checkpointId);
 
     /**
      * @brief Checks if there are any more tasks left in the queue
@@ -402,7 +436,13 @@ private:
             uint64_t m_id;
         };
 
-        LogStats() : m_tcls(0), m_numEntries(0)
+        LogStats()
+            : m_tcls(0),
+              m_parallelTxns(0),
+              m_crossPartitionTxns(0),
+              m_serialTxns(0),
+              m_startClock(GetSysClock()),
+              m_numEntries(0)
         {}
 
         ~LogStats()
@@ -447,12 +487,29 @@ private:
          */
         void Print();
 
+        /**
+         * @brief Prints the redo replay progress and throughput to the log
+         */
+        void PrintRedoProgress();
+
         std::map<uint64_t, int> m_idToIdx;
 
         std::vector<Entry*> m_tableStats;
 
         std::atomic<uint64_t> m_tcls;
 
+        /** @var Transactions replayed by a single redo worker. */
+        std::atomic<uint64_t> m_parallelTxns;
+
+        /** @var Transactions that touched rows of several redo workers. */
+        std::atomic<uint64_t> m_crossPartitionTxns;
+
+        /** @var Transactions replayed after draining all the redo workers (DDL). */
+        std::atomic<uint64_t> m_serialTxns;
+
+        /** @var The clock when the stats collection started. */
+        uint64_t m_startClock;
+
     private:
         spin_lock m_slock;
 
@@ -617,8 +674,9 @@ public:
 
     inline void SetLastReplayLsn(uint64_t lastReplayLsn)
     {
-        if (m_lastReplayLsn < lastReplayLsn) {
-            m_lastReplayLsn = lastReplayLsn;
+        // transactions may complete concurrently when redo is parallel
+        uint64_t currentLsn = m_lastReplayLsn;
+        while (currentLsn < lastReplayLsn && !m_lastReplayLsn.compare_exchange_weak(currentLsn, lastReplayLsn)) {
         }
     }
 
@@ -627,6 +685,18 @@ public:
         return m_lastReplayLsn;
     }
 
+    /**
+     * @brief Stops dispatching transactions to the parallel redo workers and waits until
+     * all the dispatched transactions were replayed, so that the replayed transactions are
+     * a prefix of the redo log. Used by checkpoint during recovery before taking a snapshot.
+     */
+    void PauseRedo();
+
+    /**
+     * @brief Resumes dispatching transactions to the parallel redo workers.
+     */
+    void ResumeRedo();
+
     LogStats* m_logStats;
 
     std::map<uint64_t, TableInfo*> m_preCommitedTables;
@@ -634,6 +704,58 @@ public:
 private:
     static constexpr uint32_t NUM_REDO_RECOVERY_THREADS = 1;
 
+    /** @var Print the redo progress every this number of transactions (when log stats are enabled). */
+    static constexpr uint64_t REDO_PROGRESS_INTERVAL = 100000;
+
+    /**
+     * @struct RedoTask
+     * @brief A committed transaction queued to the parallel redo workers. A transaction
+     * touching the rows of several workers is queued to all of them, and replayed by the
+     * last one that reaches it, after all the preceding transactions of these workers.
+     */
+    struct RedoTask {
+        RedoTask(RedoTransactionSegments* segments, uint64_t transactionId, uint32_t numPartitions)
+            : m_segments(segments),
+              m_transactionId(transactionId),
+              m_numPartitions(numPartitions),
+              m_arrived(0),
+              m_refCount(numPartitions),
+              m_done(false)
+        {}
+
+        ~RedoTask()
+        {
+            delete m_segments;
+        }
+
+        RedoTransactionSegments* m_segments;
+
+        uint64_t m_transactionId;
+
+        uint32_t m_numPartitions;
+
+        /** @var The number of workers that reached this task. */
+        std::atomic<uint32_t> m_arrived;
+
+        /** @var The number of workers still holding this task. */
+        std::atomic<uint32_t> m_refCount;
+
+        /** @var Set when the transaction was replayed. */
+        std::atomic<bool> m_done;
+    };
+
+    /**
+     * @struct RedoPartition
+     * @brief The queue of transactions of a single parallel redo worker, in commit order.
+     */
+    struct RedoPartition {
+        std::mutex m_lock;
+
+        std::condition_variable m_cv;
+
+        std::deque<RedoTask*> m_queue;
+    };
+
     /**
      * @brief performs a redo on a segment, which is either a recovery op
      * or a segment that belongs to a 2pc recovered transaction.
@@ -641,9 +763,65 @@ private:
      * @param csn the segment's csn
      * @param transactionId the transaction id of the segment
      * @param rState the operation to perform on the segment.
+     * @param sState the surrogate state of the redoing thread.
      * @return RC value denoting the operation's status
      */
-    RC RedoSegment(LogSegment* segment, uint64_t csn, uint64_t transactionId, RecoveryOpState rState);
+    RC RedoSegment(
+        LogSegment* segment, uint64_t csn, uint64_t transactionId, RecoveryOpState rState, SurrogateState& sState);
+
+    /**
+     * @brief performs a redo on all the segments of a transaction.
+     * @param segments the transaction's segments.
+     * @param transactionId the transaction id.
+     * @param rState the operation to perform on the segments.
+     * @param sState the surrogate state of the redoing thread.
+     * @return RC value denoting the operation's status
+     */
+    RC RedoTransaction(RedoTransactionSegments* segments, uint64_t transactionId, RecoveryOpState rState,
+        SurrogateState& sState);
+
+    /**
+     * @brief Checks whether committed transactions are replayed by the parallel redo workers.
+     */
+    bool IsParallelRedo() const;
+
+    /**
+     * @brief Hands a committed transaction to the parallel redo workers. Transactions
+     * that cannot be partitioned (DDL) are replayed by the caller after all the workers
+     * are drained.
+     * @param segments the transaction's segments, owned by the redo workers from now on.
+     * @param transactionId the transaction id.
+     * @return Boolean value denoting success or failure.
+     */
+    bool DispatchRedoTransaction(RedoTransactionSegments* segments, uint64_t transactionId);
+
+    /**
+     * @brief Computes the redo workers a transaction must be replayed by. Rows are
+     * partitioned by table and primary key hash, or by table only if the table has a
+     * unique secondary index (so that unique key conflicts replay in commit order).
+     * @param segments the transaction's segments.
+     * @param[out] partitions the bitmap of the redo workers.
+     * @return False if the transaction cannot be partitioned (DDL).
+     */
+    bool GetRedoPartitions(RedoTransactionSegments* segments, uint64_t& partitions);
+
+    /** @brief Starts the parallel redo workers. */
+    bool StartRedoWorkers();
+
+    /** @brief Waits until all the dispatched transactions were replayed. */
+    void WaitRedoWorkers();
+
+    /** @brief Drains and stops the parallel redo workers. */
+    void StopRedoWorkers();
+
+    /**
+     * @brief Implements a parallel redo worker.
+     * @param partition the worker's partition.
+     */
+    void RedoWorkerFunc(uint32_t partition);
+
+    /** @brief Releases a worker's reference to a redo task. */
+    static void ReleaseRedoTask(RedoTask* task);
 
     /**
      * @brief inserts a segment in to the in-process transactions map
@@ -1056,9 +1234,21 @@ private:
 
     uint64_t m_checkpointId;
 
+    // The checkpoints to recover from, newest first: the checkpoint and its delta parents
+    std::vector<uint64_t> m_checkpointChain;
+
+    // The position in the checkpoint chain being recovered
+    uint32_t m_chainPos;
+
+    // Per table, the chain position of the newest checkpoint that holds it in full
+    std::map<uint32_t, uint32_t> m_tableFullPos;
+
+    // Per table, the primary keys deleted in the delta checkpoints with the csn of the delete
+    std::map<uint32_t, std::unordered_map<std::string, uint64_t>> m_tombstones;
+
     uint64_t m_lsn;
 
-    uint64_t m_lastReplayLsn;
+    std::atomic<uint64_t> m_lastReplayLsn;
 
     std::string m_workingDir;
 
@@ -1070,6 +1260,23 @@ private:
 
     uint32_t m_numWorkers;
 
+    // The number of parallel redo workers, redo is serial if it is 1
+    uint32_t m_numRedoWorkers;
+
+    std::vector<std::thread> m_redoWorkers;
+
+    RedoPartition* m_redoPartitions;
+
+    std::atomic<bool> m_redoWorkersStop;
+
+    // Protects the dispatching of transactions against PauseRedo()
+    std::mutex m_redoDispatchLock;
+
+    bool m_redoPaused;
+
+    // The number of dispatched transactions that were not replayed yet
+    std::atomic<uint64_t> m_redoPending;
+
     std::atomic<uint32_t> m_tid;
 
     std::atomic<uint64_t> m_maxRecoveredCsn;
@@ -95,6 +95,10 @@ Row* TxnManager::RowLookup(const AccessType type, Sentinel* const& originalSenti
     // if txn not started, tag as started and take global epoch
     GcSessionStart();
 
+    if (m_snapshotCsn != 0 && type == AccessType::RD) {
+        return m_accessMgr->GetSnapshotRow(originalSentinel, m_snapshotCsn);
+    }
+
     RC res = AccessLookup(type, originalSentinel, local_row);
 
     switch (res) {
@@ -391,6 +395,8 @@ void TxnManager::Cleanup()
     m_txnDdlAccess->Reset();
     m_checkpointPhase = CheckpointPhase::NONE;
     m_csn = 0;
+    m_snapshotCsn = 0;
+    m_snapshotTables.clear();
     m_occManager.CleanUp();
     m_err = RC_OK;
     m_errIx = nullptr;
@@ -683,6 +689,7 @@ TxnManager::TxnManager(SessionContext* session_context)
       m_csn(0),
       m_transactionId(INVALID_TRANSACTIOIN_ID),
       m_replayLsn(0),
+      m_snapshotCsn(0),
       m_surrogateGen(0),
       m_flushDone(false),
       m_internalTransactionId(((uint64_t)m_sessionContext->GetSessionId()) << SESSION_ID_BITS),
@@ -796,6 +803,42 @@ void TxnManager::SetTxnIsoLevel(int envelopeIsoLevel)
     m_isolationLevel = envelopeIsoLevel;
 }
 
+bool TxnManager::StartSnapshotRead(Table* table)
+{
+    if (m_snapshotCsn == 0) {
+        if (!GetGlobalConfiguration().m_enableMvcc || MOTEngine::GetInstance()->IsRecovering()) {
+            return false;
+        }
+        if (m_accessMgr->m_rowCnt > 0 || m_txnDdlAccess->Size() > 0) {
+            return false;
+        }
+
+        // The GC epoch must be taken before the snapshot, so that the row versions overwritten after
+        // the snapshot are not reclaimed until the transaction ends
+        GcSessionStart();
+        m_snapshotCsn = GetCSNManager().GetCurrentCSN();
+    }
+
+    if (table != nullptr &&
+        std::find(m_snapshotTables.begin(), m_snapshotTables.end(), table) == m_snapshotTables.end()) {
+        m_snapshotTables.push_back(table);
+    }
+    return true;
+}
+
+bool TxnManager::ValidateSnapshotRead() const
+{
+    for (const Table* table : m_snapshotTables) {
+        if (table->GetLastDeleteCsn() > m_snapshotCsn) {
+            MOT_LOG_DEBUG("Snapshot read aborted: rows deleted from table %s after snapshot %lu",
+                table->GetLongTableName().c_str(),
+                m_snapshotCsn);
+            return false;
+        }
+    }
+    return true;
+}
+
 void TxnManager::GcSessionRecordRcu(
     uint32_t index_id, void* object_ptr, void* object_pool, DestroyValueCbFunc cb, uint32_t obj_size)
 {
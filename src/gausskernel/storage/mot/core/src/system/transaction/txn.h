@@ -31,6 +31,7 @@
 #include <cstring>
 #include <functional>
 #include <unordered_map>
+#include <vector>
 
 #include "global.h"
 #include "redo_log.h"
@@ -391,6 +392,31 @@ public:
      */
     void SetTxnIsoLevel(int envelopeIsoLevel);
 
+    /**
+     * @brief Makes a read-only transaction read a snapshot of the committed rows (MVCC), so it is
+     * not validated against concurrent updates on commit. Has no effect unless MVCC is enabled, or if
+     * the transaction already accessed any row.
+     * @param table The table about to be scanned with the snapshot.
+     * @return True if the transaction reads a snapshot.
+     */
+    bool StartSnapshotRead(Table* table);
+
+    /**
+     * @brief Validates a snapshot read on commit. Deleted keys are removed from the indexes right
+     * away, so a snapshot reader of a table with rows deleted after its snapshot might have missed
+     * them, and is aborted like a validated reader.
+     * @return True if no rows were deleted after the snapshot from the tables the transaction read.
+     */
+    bool ValidateSnapshotRead() const;
+
+    /**
+     * @brief Queries whether the transaction reads a snapshot of the committed rows (MVCC).
+     */
+    inline bool IsSnapshotRead() const
+    {
+        return m_snapshotCsn != 0;
+    }
+
     inline void IncStmtCount()
     {
         m_internalStmtCount++;
@@ -566,6 +592,12 @@ private:
     /** @var Replay LSN for this transaction, used only during replay in standby. */
     uint64_t m_replayLsn;
 
+    /** @var The snapshot CSN of a read-only transaction reading older row versions (0 if none). */
+    uint64_t m_snapshotCsn;
+
+    /** @var The tables scanned with the snapshot, validated on commit. */
+    std::vector<Table*> m_snapshotTables;
+
     /** @var surrogate_counter Promotes every insert transaction. */
     SurrogateKeyGenerator m_surrogateGen;
 
@@ -29,6 +29,7 @@
 #include "txn.h"
 #include "txn_access.h"
 #include "txn_insert_action.h"
+#include "cycles.h"
 
 namespace MOT {
 IMPLEMENT_CLASS_LOGGER(TxnInsertAction, TxMan);
@@ -707,6 +708,38 @@ Row* TxnAccess::GetReadCommitedRow(Sentinel* sentinel)
     } else
         return nullptr;
 }
+
+Row* TxnAccess::GetSnapshotRow(Sentinel* sentinel, uint64_t snapshotCsn)
+{
+    if (unlikely(sentinel->IsCommited() == false)) {
+        return nullptr;
+    }
+    Sentinel* primarySentinel = reinterpret_cast<Sentinel*>(sentinel->GetPrimarySentinel());
+    if (primarySentinel == nullptr) {
+        return nullptr;
+    }
+
+    // A locked primary sentinel belongs to a transaction in its commit phase, whose CSN may precede
+    // the snapshot. Wait for it, so that either all of its changes are visible or none of them.
+    uint64_t sleepTime = 1;
+    while (primarySentinel->IsLocked()) {
+        if (sleepTime > LOCK_TIME_OUT) {
+            sleepTime = LOCK_TIME_OUT;
+            struct timespec ts = {0, 5000};
+            (void)nanosleep(&ts, NULL);
+        } else {
+            CpuCyclesLevelTime::Sleep(1);
+            sleepTime = sleepTime << 1;
+        }
+    }
+
+    Row* row = primarySentinel->GetData();
+    if (row == nullptr || row->GetSnapshotRow(m_rowZero, snapshotCsn) != RC_OK) {
+        return nullptr;
+    }
+    return m_rowZero;
+}
+
 RC TxnAccess::GenerateDeletes(Access* element)
 {
     RC rc = RC_OK;
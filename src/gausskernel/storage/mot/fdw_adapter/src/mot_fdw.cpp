@@ -109,6 +109,7 @@ static const struct MOTFdwOption valid_options[] = {
     {"null", ForeignTableRelationId},
     {"encoding", ForeignTableRelationId},
     {"force_not_null", AttributeRelationId},
+    {"primary_index_method", ForeignTableRelationId},
 
     /* Sentinel */
     {NULL, InvalidOid}};
@@ -445,6 +446,16 @@ Datum mot_fdw_validator(PG_FUNCTION_ARGS)
                     buf.len > 0 ? errhint("Valid options in this context are: %s", buf.data)
                                 : errhint("There are no valid options in this context.")));
         }
+
+        if (strcmp(def->defname, "primary_index_method") == 0) {
+            char* method = defGetString(def);
+            if (strcmp(method, "btree") != 0 && strcmp(method, "hash") != 0) {
+                ereport(ERROR,
+                    (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                        errmsg("invalid value for option \"primary_index_method\": \"%s\"", method),
+                        errhint("Valid values are: btree, hash")));
+            }
+        }
     }
 
     /*
@@ -653,7 +664,7 @@ static void MOTGetForeignPaths(PlannerInfo* root, RelOptInfo* baserel, Oid forei
             usablePathkeys = nullptr;
         }
         best = nullptr;
-    } else if (list_length(root->query_pathkeys) > 0) {
+    } else if (list_length(root->query_pathkeys) > 0 && planstate->m_table->GetPrimaryIndex()->IsOrdered()) {
         OrderSt ord;
         ord.init();
         MOT::Index* ix = planstate->m_table->GetPrimaryIndex();
@@ -945,6 +956,10 @@ static void MOTBeginForeignScan(ForeignScanState* node, int eflags)
             RelationGetRelid(node->ss.ss_currentRelation))
         node->ss.ps.state->es_result_relation_info->ri_FdwState = festate;
     festate->m_currTxn->SetTxnIsoLevel(u_sess->utils_cxt.XactIsoLevel);
+    // read-only transactions read a snapshot of the committed rows if MVCC is enabled
+    if (u_sess->attr.attr_common.XactReadOnly) {
+        (void)festate->m_currTxn->StartSnapshotRead(festate->m_table);
+    }
 
     foreach (t, node->ss.ps.plan->targetlist) {
         TargetEntry* tle = (TargetEntry*)lfirst(t);
@@ -2145,6 +2160,21 @@ char* MOTCheckpointFetchDirName()
     return nullptr;
 }
 
+List* MOTCheckpointFetchParentDirNames()
+{
+    List* dirNames = NIL;
+    MOT::MOTEngine* engine = MOT::MOTEngine::GetInstance();
+    if (engine != nullptr) {
+        std::vector<std::string> parentDirNames;
+        if (engine->GetCheckpointManager()->GetCheckpointParentDirNames(parentDirNames) == true) {
+            for (const std::string& dirName : parentDirNames) {
+                dirNames = lappend(dirNames, pstrdup(dirName.c_str()));
+            }
+        }
+    }
+    return dirNames;
+}
+
 char* MOTCheckpointFetchWorkingDir()
 {
     MOT::MOTEngine* engine = MOT::MOTEngine::GetInstance();
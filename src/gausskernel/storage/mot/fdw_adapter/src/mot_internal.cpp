@@ -43,6 +43,8 @@
 #include "executor/executor.h"
 #include "storage/ipc.h"
 #include "commands/dbcommands.h"
+#include "commands/defrem.h"
+#include "foreign/foreign.h"
 #include "knl/knl_session.h"
 
 #include "log_statistics.h"
@@ -1341,6 +1343,12 @@ void MOTAdaptor::OpenCursor(Relation rel, MOTFdwStateSt* festate)
 
             festate->m_cursor[fIx] = festate->m_table->Begin(festate->m_currTxn->GetThdId());
 
+            // an unordered index has no maximal key, instead its scan iterator skips the keys inserted after it
+            // was opened, so it cannot scan rows inserted by the same statement either
+            if (!ix->IsOrdered()) {
+                break;
+            }
+
             festate->m_stateKey[bIx].InitKey(keyLength);
             buf = festate->m_stateKey[bIx].GetKeyBuf();
             FILL_KEY_MAX(INT8OID, buf, keyLength);
@@ -1351,7 +1359,10 @@ void MOTAdaptor::OpenCursor(Relation rel, MOTFdwStateSt* festate)
 
         for (int i = 0; i < 2; i++) {
             if (i == 1 && festate->m_bestIx->m_end < 0) {
-                if (festate->m_forwardDirectionScan) {
+                if (!festate->m_bestIx->m_ix->IsOrdered()) {
+                    // point lookup in an unordered index, the start cursor holds at most one item
+                    festate->m_cursor[1] = nullptr;
+                } else if (festate->m_forwardDirectionScan) {
                     uint8_t* buf = nullptr;
                     MOT::Index* ix = festate->m_bestIx->m_ix;
                     uint16_t keyLength = ix->GetKeyLength();
@@ -1539,6 +1550,21 @@ static MOT::RC TableFieldType(const ColumnDef* colDef, MOT::MOT_CATALOG_FIELD_TY
     return res;
 }
 
+// Checks whether the primary_index_method option of a foreign table selects a hash primary index
+static bool IsPrimaryIndexMethodHash(Oid relid)
+{
+    ForeignTable* foreignTable = GetForeignTable(relid);
+    ListCell* lc = nullptr;
+
+    foreach (lc, foreignTable->options) {
+        DefElem* def = (DefElem*)lfirst(lc);
+        if (strcmp(def->defname, "primary_index_method") == 0) {
+            return (strcmp(defGetString(def), "hash") == 0);
+        }
+    }
+    return false;
+}
+
 MOT::RC MOTAdaptor::CreateIndex(IndexStmt* index, ::TransactionId tid)
 {
     MOT::RC res;
@@ -1588,6 +1614,10 @@ MOT::RC MOTAdaptor::CreateIndex(IndexStmt* index, ::TransactionId tid)
         // Use the default index tree flavor from configuration file
         indexing_method = MOT::IndexingMethod::INDEXING_METHOD_TREE;
         flavor = MOT::GetGlobalConfiguration().m_indexTreeFlavor;
+        if (index->primary && IsPrimaryIndexMethodHash(index->relation->foreignOid)) {
+            // point-lookup table, the primary key is kept in a hash index
+            indexing_method = MOT::IndexingMethod::INDEXING_METHOD_HASH;
+        }
     } else {
         ereport(ERROR, (errmodule(MOD_MOT), errmsg("MOT supports indexes of type BTREE only (btree or btree_art)")));
         return MOT::RC_ERROR;
@@ -2831,6 +2861,11 @@ inline double MatchIndex::GetCost(int numClauses)
         return INT_MAX;
     }
 
+    // unordered (hash) indexes can only serve a lookup of the full unique key
+    if (!m_ix->IsOrdered() && !(m_end == -1 && m_ixOpers[m_start] == KEY_OPER::READ_KEY_EXACT)) {
+        return INT_MAX;
+    }
+
     return m_cost;
 }
 
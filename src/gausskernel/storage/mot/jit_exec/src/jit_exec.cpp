@@ -383,6 +383,17 @@ extern int JitExecQuery(
         report_pg_error(MOT::RC_MEMORY_ALLOCATION_ERROR, NULL);  // execution control ends, calls ereport(error,...)
     }
 
+    // read-only transactions read a snapshot of the committed rows if MVCC is enabled
+    if (u_sess->attr.attr_common.XactReadOnly) {
+        MOT::TxnManager* txn = u_sess->mot_cxt.jit_txn;
+        if (txn->StartSnapshotRead(jitContext->m_table)) {
+            (void)txn->StartSnapshotRead(jitContext->m_innerTable);
+            for (uint64_t i = 0; i < jitContext->m_subQueryCount; ++i) {
+                (void)txn->StartSnapshotRead(jitContext->m_subQueryData[i].m_table);
+            }
+        }
+    }
+
     // during the very first invocation of the query we need to setup the reusable search keys
     // This is also true after TRUNCATE TABLE, in which case we also need to re-fetch all index objects
     if ((jitContext->m_argIsNull == nullptr) ||
@@ -2525,6 +2525,10 @@ static JitRangeScanPlan* JitPrepareRangeScanPlan(Query* query, MOT::Table* table
         table->GetTableName().c_str(),
         index_id,
         index->GetName().c_str());
+    if (!index->IsOrdered()) {
+        MOT_LOG_TRACE("Disqualifying range scan plan - index %s is unordered", index->GetName().c_str());
+        return nullptr;
+    }
     JitRangeScanPlan* plan = (JitRangeScanPlan*)MOT::MemSessionAlloc(alloc_size);
     if (plan == nullptr) {
         MOT_REPORT_ERROR(MOT_ERROR_OOM,
@@ -2600,6 +2604,10 @@ static JitPlan* JitPrepareRangeSelectPlan(Query* query, MOT::Table* table, JoinC
     size_t alloc_size = sizeof(JitRangeSelectPlan);
 
     for (int index_id = 0; index_id < (int)table->GetNumIndexes(); ++index_id) {
+        if (!table->GetIndex(index_id)->IsOrdered()) {
+            MOT_LOG_TRACE("Skipping unordered index %d", index_id);
+            continue;
+        }
         MOT_LOG_TRACE("Attempting to prepare plan with index %d", index_id);
         JitRangeSelectPlan* next_plan = (JitRangeSelectPlan*)JitPrepareRangeScanPlan(
             query, table, index_id, alloc_size, JIT_COMMAND_SELECT, join_clause_type);
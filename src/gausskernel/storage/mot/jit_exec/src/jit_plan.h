@@ -386,7 +386,10 @@ struct JitFilterArray {
 
 /** @struct The data required to plan a point query. */
 struct JitPointQuery {
-    /** @var The table being used (always using primary index). */
+    /**
+     * @var The table being used (always using primary index). The row is looked up directly through the
+     * primary index, so a point query on a table with a hash primary index never touches a tree.
+     */
     MOT::Table* _table;
 
     /**
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ *  checksum_avx2.cpp
+ *        Page checksum kernel using AVX2, see storage/checksum_impl.h.
+ *
+ * IDENTIFICATION
+ *        src/gausskernel/storage/page/checksum_avx2.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "storage/checksum_impl.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+
+/* 8 lanes per register, 4 registers hold the N_SUMS partial checksums */
+#define AVX2_LANES 8
+#define AVX2_REGS (N_SUMS / AVX2_LANES)
+
+#define CHECKSUM_COMP_AVX2(checksum, value, prime)                                                       \
+    do {                                                                                                 \
+        __m256i __tmp = _mm256_xor_si256((checksum), (value));                                           \
+        (checksum) = _mm256_xor_si256(_mm256_mullo_epi32(__tmp, (prime)), _mm256_srli_epi32(__tmp, 17)); \
+    } while (0)
+
+uint32 pg_checksum_block_avx2(char* data, uint32 size)
+{
+    const __m256i prime = _mm256_set1_epi32(FNV_PRIME);
+    const __m256i zero = _mm256_setzero_si256();
+    const uint32* dataArr = (const uint32*)data;
+    __m256i sums[AVX2_REGS];
+    __m256i fold;
+    uint32 lanes[AVX2_LANES];
+    uint32 result = 0;
+    uint32 i, j;
+
+    /* ensure that the size is compatible with the algorithm */
+    Assert((size % (sizeof(uint32) * N_SUMS)) == 0);
+
+    for (j = 0; j < AVX2_REGS; j++) {
+        sums[j] = _mm256_loadu_si256((const __m256i*)&g_checksumBaseOffsets[j * AVX2_LANES]);
+    }
+
+    /* the first row turns the offsets into the initial partial checksums */
+    for (i = 0; i < size / (sizeof(uint32) * N_SUMS); i++) {
+        for (j = 0; j < AVX2_REGS; j++) {
+            CHECKSUM_COMP_AVX2(sums[j], _mm256_loadu_si256((const __m256i*)(dataArr + j * AVX2_LANES)), prime);
+        }
+        dataArr += N_SUMS;
+    }
+
+    /* finally add in two rounds of zeroes for additional mixing */
+    fold = zero;
+    for (j = 0; j < AVX2_REGS; j++) {
+        CHECKSUM_COMP_AVX2(sums[j], zero, prime);
+        CHECKSUM_COMP_AVX2(sums[j], zero, prime);
+        fold = _mm256_xor_si256(fold, sums[j]);
+    }
+
+    /* xor fold partial checksums together */
+    _mm256_storeu_si256((__m256i*)lanes, fold);
+    for (j = 0; j < AVX2_LANES; j++) {
+        result ^= lanes[j];
+    }
+
+    return result;
+}
+#endif /* __x86_64__ */
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ *  checksum_avx512.cpp
+ *        Page checksum kernel using AVX-512, see storage/checksum_impl.h.
+ *
+ * IDENTIFICATION
+ *        src/gausskernel/storage/page/checksum_avx512.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "storage/checksum_impl.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+
+/* 16 lanes per register, 2 registers hold the N_SUMS partial checksums */
+#define AVX512_LANES 16
+#define AVX512_REGS (N_SUMS / AVX512_LANES)
+
+#define CHECKSUM_COMP_AVX512(checksum, value, prime)                                                     \
+    do {                                                                                                 \
+        __m512i __tmp = _mm512_xor_si512((checksum), (value));                                           \
+        (checksum) = _mm512_xor_si512(_mm512_mullo_epi32(__tmp, (prime)), _mm512_srli_epi32(__tmp, 17)); \
+    } while (0)
+
+uint32 pg_checksum_block_avx512(char* data, uint32 size)
+{
+    const __m512i prime = _mm512_set1_epi32(FNV_PRIME);
+    const __m512i zero = _mm512_setzero_si512();
+    const uint32* dataArr = (const uint32*)data;
+    __m512i sums[AVX512_REGS];
+    __m512i fold;
+    uint32 lanes[AVX512_LANES];
+    uint32 result = 0;
+    uint32 i, j;
+
+    /* ensure that the size is compatible with the algorithm */
+    Assert((size % (sizeof(uint32) * N_SUMS)) == 0);
+
+    for (j = 0; j < AVX512_REGS; j++) {
+        sums[j] = _mm512_loadu_si512((const void*)&g_checksumBaseOffsets[j * AVX512_LANES]);
+    }
+
+    /* the first row turns the offsets into the initial partial checksums */
+    for (i = 0; i < size / (sizeof(uint32) * N_SUMS); i++) {
+        for (j = 0; j < AVX512_REGS; j++) {
+            CHECKSUM_COMP_AVX512(sums[j], _mm512_loadu_si512((const void*)(dataArr + j * AVX512_LANES)), prime);
+        }
+        dataArr += N_SUMS;
+    }
+
+    /* finally add in two rounds of zeroes for additional mixing */
+    fold = zero;
+    for (j = 0; j < AVX512_REGS; j++) {
+        CHECKSUM_COMP_AVX512(sums[j], zero, prime);
+        CHECKSUM_COMP_AVX512(sums[j], zero, prime);
+        fold = _mm512_xor_si512(fold, sums[j]);
+    }
+
+    /* xor fold partial checksums together */
+    _mm512_storeu_si512((void*)lanes, fold);
+    for (j = 0; j < AVX512_LANES; j++) {
+        result ^= lanes[j];
+    }
+
+    return result;
+}
+#endif /* __x86_64__ */
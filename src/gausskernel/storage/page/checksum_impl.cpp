@@ -26,6 +26,7 @@
 #include "postgres.h"
 #include "knl/knl_variable.h"
 #include "storage/checksum_impl.h"
+#include "port/pg_cpu_features.h"
 
 static inline uint32 pg_checksum_init(uint32 seed, uint32 value)
 {
@@ -33,7 +34,10 @@ static inline uint32 pg_checksum_init(uint32 seed, uint32 value)
     return seed;
 }
 
-uint32 pg_checksum_block(char* data, uint32 size)
+/*
+ * Portable implementation, relying on the compiler to vectorize the lanes.
+ */
+uint32 pg_checksum_block_generic(char* data, uint32 size)
 {
     uint32 sums[N_SUMS];
     uint32* dataArr = (uint32*)data;
@@ -71,6 +75,49 @@ uint32 pg_checksum_block(char* data, uint32 size)
     return result;
 }
 
+static uint32 pg_checksum_block_choose(char* data, uint32 size);
+
+static uint32 (*pg_checksum_block_impl)(char* data, uint32 size) = pg_checksum_block_choose;
+
+/*
+ * This gets called on the first call.  It picks the widest kernel the CPU
+ * supports, makes sure it agrees with the generic code, and replaces the
+ * function pointer so that subsequent calls go directly to it.
+ */
+static uint32 pg_checksum_block_choose(char* data, uint32 size)
+{
+    uint32 (*chosen)(char* data, uint32 size) = pg_checksum_block_generic;
+
+#if defined(USE_X86_CPU_FEATURES)
+    if (pg_cpu_has_avx512f()) {
+        chosen = pg_checksum_block_avx512;
+    } else if (pg_cpu_has_avx2()) {
+        chosen = pg_checksum_block_avx2;
+    }
+#elif defined(__aarch64__)
+    chosen = pg_checksum_block_neon;
+#endif
+
+    if (chosen != pg_checksum_block_generic) {
+        uint32 probe[N_SUMS * 4];
+
+        for (uint32 i = 0; i < lengthof(probe); i++) {
+            probe[i] = i * FNV_PRIME + g_checksumBaseOffsets[i % N_SUMS];
+        }
+        if (chosen((char*)probe, sizeof(probe)) != pg_checksum_block_generic((char*)probe, sizeof(probe))) {
+            chosen = pg_checksum_block_generic;
+        }
+    }
+
+    pg_checksum_block_impl = chosen;
+    return chosen(data, size);
+}
+
+uint32 pg_checksum_block(char* data, uint32 size)
+{
+    return pg_checksum_block_impl(data, size);
+}
+
 /*
  * Compute the checksum for a Postgres page.  The page must be aligned on a
  * 4-byte boundary.
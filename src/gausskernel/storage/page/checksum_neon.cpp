@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ * openGauss is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *
+ *          http://license.coscl.org.cn/MulanPSL2
+ *
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ * ---------------------------------------------------------------------------------------
+ *
+ *  checksum_neon.cpp
+ *        Page checksum kernel using NEON, see storage/checksum_impl.h.
+ *
+ * IDENTIFICATION
+ *        src/gausskernel/storage/page/checksum_neon.cpp
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#include "postgres.h"
+#include "storage/checksum_impl.h"
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+
+/* 4 lanes per register, 8 registers hold the N_SUMS partial checksums */
+#define NEON_LANES 4
+#define NEON_REGS (N_SUMS / NEON_LANES)
+
+#define CHECKSUM_COMP_NEON(checksum, value, prime)                                  \
+    do {                                                                            \
+        uint32x4_t __tmp = veorq_u32((checksum), (value));                          \
+        (checksum) = veorq_u32(vmulq_u32(__tmp, (prime)), vshrq_n_u32(__tmp, 17)); \
+    } while (0)
+
+uint32 pg_checksum_block_neon(char* data, uint32 size)
+{
+    const uint32x4_t prime = vdupq_n_u32(FNV_PRIME);
+    const uint32x4_t zero = vdupq_n_u32(0);
+    const uint32* dataArr = (const uint32*)data;
+    uint32x4_t sums[NEON_REGS];
+    uint32x4_t fold;
+    uint32 result;
+    uint32 i, j;
+
+    /* ensure that the size is compatible with the algorithm */
+    Assert((size % (sizeof(uint32) * N_SUMS)) == 0);
+
+    for (j = 0; j < NEON_REGS; j++) {
+        sums[j] = vld1q_u32(&g_checksumBaseOffsets[j * NEON_LANES]);
+    }
+
+    /* the first row turns the offsets into the initial partial checksums */
+    for (i = 0; i < size / (sizeof(uint32) * N_SUMS); i++) {
+        for (j = 0; j < NEON_REGS; j++) {
+            CHECKSUM_COMP_NEON(sums[j], vld1q_u32(dataArr + j * NEON_LANES), prime);
+        }
+        dataArr += N_SUMS;
+    }
+
+    /* finally add in two rounds of zeroes for additional mixing */
+    fold = zero;
+    for (j = 0; j < NEON_REGS; j++) {
+        CHECKSUM_COMP_NEON(sums[j], zero, prime);
+        CHECKSUM_COMP_NEON(sums[j], zero, prime);
+        fold = veorq_u32(fold, sums[j]);
+    }
+
+    /* xor fold partial checksums together */
+    result = vgetq_lane_u32(fold, 0) ^ vgetq_lane_u32(fold, 1) ^ vgetq_lane_u32(fold, 2) ^ vgetq_lane_u32(fold, 3);
+
+    return result;
+}
+#endif /* __aarch64__ */
@@ -584,6 +584,9 @@ void PerformMotCheckpointFetch()
     char ctrlFilePath[MAXPGPATH] = {0};
     char cwd[MAXPGPATH] = {0};
     const char* motControlFile = "mot.ctrl";
+    List* parentDirs = NIL;
+    List* fullParentDirs = NIL;
+    ListCell* lc = NULL;
     uint64_t id = 0;
     int rc = 0;
 
@@ -625,6 +628,20 @@ void PerformMotCheckpointFetch()
             securec_check_ss(rc, "", "");
         }
         securec_check_ss(rc, "", "");
+
+        /* a delta checkpoint is sent together with its parents, up to the last full checkpoint */
+        parentDirs = MOTCheckpointFetchParentDirNames();
+        foreach (lc, parentDirs) {
+            char* fullParentDir = (char*)palloc0(MAXPGPATH);
+            if (strncmp(cwd, workingDir, strlen(workingDir) - 1) == 0) {
+                rc = snprintf_s(fullParentDir, MAXPGPATH, MAXPGPATH - 1, "./%s", (char*)lfirst(lc));
+            } else {
+                rc = snprintf_s(fullParentDir, MAXPGPATH, MAXPGPATH - 1, "//%s%s", workingDir, (char*)lfirst(lc));
+            }
+            securec_check_ss(rc, "", "");
+            fullParentDirs = lappend(fullParentDirs, fullParentDir);
+        }
+        list_free_deep(parentDirs);
         pfree(chkptDir);
         pfree(workingDir);
 
@@ -649,6 +666,10 @@ void PerformMotCheckpointFetch()
 
             /* send the checkpoint dir */
             sendDir(fullChkptDir, 1, false, NIL, false, false);
+            foreach (lc, fullParentDirs) {
+                sendDir((char*)lfirst(lc), 1, false, NIL, false, false);
+            }
+            list_free_deep(fullParentDirs);
 
             /* CopyDone */
             pq_putemptymessage_noblock('c');
@@ -37,6 +37,13 @@
  *	contents of individual (sub-)transactions will be read from disk in
  *	chunks.
  *
+ *	The changes kept in memory by all transactions are accounted against
+ *	logical_decoding_work_mem. Once the budget is exceeded the largest
+ *	transaction is evicted: if the output plugin supports streaming, its
+ *	toplevel transaction is streamed to the plugin while still in progress
+ *	(c.f. ReorderBufferStreamTXN()) and the streamed changes are discarded,
+ *	otherwise the transaction is spooled to disk as above.
+ *
  *	This module also has to deal with reassembling toast records from the
  *	individual chunks stored in WAL. When a new (or initial) version of a
  *	tuple is stored in WAL it will always be preceded by the toast chunks
@@ -152,6 +159,24 @@ static ReorderBufferTXN* ReorderBufferGetTXN(ReorderBuffer* rb);
 static void ReorderBufferReturnTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
 static ReorderBufferTXN* ReorderBufferTXNByXid(
     ReorderBuffer* rb, TransactionId xid, bool create, bool* is_new, XLogRecPtr lsn, bool create_as_top);
+static void ReorderBufferCleanupTXN(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr lsn = InvalidXLogRecPtr);
+static void ReorderBufferProcessTXN(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr commit_lsn, bool streaming);
+static void ReorderBufferExecuteInvalidationsInSnapshot(ReorderBuffer* rb, ReorderBufferTXN* txn);
+
+/* ---------------------------------------
+ * memory accounting and streaming of in-progress transactions
+ * ---------------------------------------
+ */
+static Size ReorderBufferChangeSize(ReorderBufferChange* change);
+static void ReorderBufferChangeMemoryUpdate(
+    ReorderBuffer* rb, ReorderBufferTXN* txn, ReorderBufferChange* change, bool addition);
+static void ReorderBufferTXNMemoryRelease(ReorderBuffer* rb, ReorderBufferTXN* txn);
+static ReorderBufferTXN* ReorderBufferLargestTXN(ReorderBuffer* rb);
+static bool ReorderBufferCanStream(ReorderBuffer* rb);
+static bool ReorderBufferTXNCanStream(ReorderBufferTXN* txn);
+static bool ReorderBufferTXNIsStreamed(ReorderBuffer* rb, ReorderBufferTXN* txn);
+static void ReorderBufferStreamTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
+static void ReorderBufferTruncateTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
 
 static void AssertTXNLsnOrder(ReorderBuffer* rb);
 static void ReorderBufferTransferSnapToParent(ReorderBufferTXN* txn, ReorderBufferTXN* subtxn);
@@ -174,12 +199,12 @@ static void ReorderBufferExecuteInvalidations(ReorderBuffer* rb, ReorderBufferTX
  * Disk serialization support functions
  * ---------------------------------------
  */
-static void ReorderBufferCheckSerializeTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
+static void ReorderBufferCheckMemoryLimit(ReorderBuffer* rb);
 static void ReorderBufferSerializeTXN(ReorderBuffer* rb, ReorderBufferTXN* txn);
 static void ReorderBufferSerializeChange(ReorderBuffer* rb, ReorderBufferTXN* txn, int fd, ReorderBufferChange* change);
 static Size ReorderBufferRestoreChanges(ReorderBuffer* rb, ReorderBufferTXN* txn, int* fd, XLogSegNo* segno);
 static void ReorderBufferRestoreChange(ReorderBuffer* rb, ReorderBufferTXN* txn, char* change);
-static void ReorderBufferRestoreCleanup(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr lsn);
+static void ReorderBufferRestoreCleanup(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr lsn = InvalidXLogRecPtr);
 
 static void ReorderBufferFreeSnap(ReorderBuffer* rb, Snapshot snap);
 static Snapshot ReorderBufferCopySnap(ReorderBuffer* rb, Snapshot orig_snap, ReorderBufferTXN* txn, CommandId cid);
@@ -234,6 +259,7 @@ ReorderBuffer* ReorderBufferAllocate(void)
 
     buffer->outbuf = NULL;
     buffer->outbufsize = 0;
+    buffer->size = 0;
 
     buffer->current_restart_decoding_lsn = InvalidXLogRecPtr;
 
@@ -529,12 +555,14 @@ void ReorderBufferQueueChange(ReorderBuffer* rb, TransactionId xid, XLogRecPtr l
     txn = ReorderBufferTXNByXid(rb, xid, true, NULL, lsn, true);
 
     change->lsn = lsn;
+    change->txn = txn;
     Assert(!XLByteEQ(InvalidXLogRecPtr, lsn));
     dlist_push_tail(&txn->changes, &change->node);
     txn->nentries++;
     txn->nentries_mem++;
 
-    ReorderBufferCheckSerializeTXN(rb, txn);
+    ReorderBufferChangeMemoryUpdate(rb, txn, change, true);
+    ReorderBufferCheckMemoryLimit(rb);
 }
 
 /*
@@ -1011,7 +1039,7 @@ static void ReorderBufferIterTXNFinish(ReorderBuffer* rb, ReorderBufferIterTXNSt
  * Cleanup the contents of a transaction, usually after the transaction
  * committed or aborted.
  */
-static void ReorderBufferCleanupTXN(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr lsn = InvalidXLogRecPtr)
+static void ReorderBufferCleanupTXN(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr lsn)
 {
     bool found = false;
     dlist_mutable_iter iter;
@@ -1064,6 +1092,17 @@ static void ReorderBufferCleanupTXN(ReorderBuffer* rb, ReorderBufferTXN* txn, XL
         dlist_delete(&txn->base_snapshot_node);
     }
 
+    /* cleanup the snapshot a streamed transaction continues with, if set */
+    if (txn->snapshot_now != NULL) {
+        ReorderBufferFreeSnap(rb, txn->snapshot_now);
+        txn->snapshot_now = NULL;
+    }
+
+    /* toast chunks of a streamed transaction still waiting for their tuple */
+    ReorderBufferToastReset(rb, txn);
+
+    ReorderBufferTXNMemoryRelease(rb, txn);
+
     /*
      * Remove TXN from its containing list.
      *
@@ -1226,55 +1265,33 @@ static void ReorderBufferFreeSnap(ReorderBuffer* rb, Snapshot snap)
 }
 
 /*
- * Perform the replay of a transaction and its non-aborted subtransactions.
- *
- * Subtransactions previously have to be processed by
- * ReorderBufferCommitChild(), even if previously assigned to the toplevel
- * transaction with ReorderBufferAssignChild.
+ * Replay the changes of a transaction and its non-aborted subtransactions to
+ * the output plugin, in lsn order.
  *
- * We currently can only decode a transaction's contents when its commit
- * record is read because that's the only place where we know about cache
- * invalidations. Thus, once a toplevel commit is read, we iterate over the top
- * and subtransactions (using a k-way merge) and replay the changes in lsn
- * order.
+ * Without streaming, this is done once the toplevel commit is read: the
+ * changes are passed between the begin and commit callbacks, and the
+ * transaction is cleaned up. When streaming, the changes decoded so far are
+ * passed between the stream_start and stream_stop callbacks, then discarded,
+ * while the transaction itself is kept until it ends.
  */
-void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit_lsn, XLogRecPtr end_lsn,
-    RepOriginId origin_id, CommitSeqNo csn, TimestampTz commit_time)
+static void ReorderBufferProcessTXN(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr commit_lsn, bool streaming)
 {
-    ReorderBufferTXN* txn = NULL;
     ReorderBufferIterTXNState* volatile iterstate = NULL;
     ReorderBufferChange* change = NULL;
 
-    volatile CommandId command_id = FirstCommandId;
+    volatile CommandId command_id = txn->command_id;
     volatile Snapshot snapshot_now = NULL;
     volatile bool txn_started = false;
     volatile bool subtxn_started = false;
 
-    txn = ReorderBufferTXNByXid(rb, xid, false, NULL, InvalidXLogRecPtr, false);
-    /* unknown transaction, nothing to replay */
-    if (txn == NULL)
-        return;
-
-    txn->final_lsn = commit_lsn;
-    txn->end_lsn = end_lsn;
-    txn->origin_id = origin_id;
-    txn->csn = csn;
-    txn->commit_time = commit_time;
-
-    /*
-     * If this transaction has no snapshot, it didn't make any changes to the
-     * database, so there's nothing to decode.  Note that
-     * ReorderBufferCommitChild will have transferred any snapshots from
-     * subtransactions if there were any.
-     */
-    if (txn->base_snapshot == NULL) {
-        Assert(txn->ninvalidations == 0);
-        ReorderBufferCleanupTXN(rb, txn);
-        return;
+    /* a streamed transaction continues with the snapshot its last stream ended with */
+    if (txn->snapshot_now != NULL) {
+        snapshot_now = txn->snapshot_now;
+        txn->snapshot_now = NULL;
+    } else {
+        snapshot_now = txn->base_snapshot;
     }
 
-    snapshot_now = txn->base_snapshot;
-
     /* build data to be able to lookup the CommandIds of catalog tuples */
     ReorderBufferBuildTupleCidHash(rb, txn);
 
@@ -1303,7 +1320,11 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
             txn_started = true;
         }
 
-        rb->begin(rb, txn);
+        if (streaming) {
+            rb->stream_start(rb, txn);
+        } else {
+            rb->begin(rb, txn);
+        }
 
         iterstate = ReorderBufferIterTXNInit(rb, txn);
         while ((change = ReorderBufferIterTXNNext(rb, iterstate))) {
@@ -1363,7 +1384,12 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
                         if (relation->rd_rel->relkind == RELKIND_SEQUENCE) {
                         } else if (!IsToastRelation(relation)) { /* user-triggered change */
                             ReorderBufferToastReplace(rb, txn, relation, change, partitionReltoastrelid);
-                            rb->apply_change(rb, txn, relation, change);
+                            if (streaming) {
+                                /* streamed changes are tagged with the (sub)transaction they belong to */
+                                rb->stream_change(rb, change->txn, relation, change);
+                            } else {
+                                rb->apply_change(rb, txn, relation, change);
+                            }
                             /*
                              * Only clear reassembled toast chunks if we're
                              * sure they're not required anymore. The creator
@@ -1379,7 +1405,8 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
                              * till we're done remove it from the list of this
                              * transaction's changes. Otherwise it will get
                              * freed/reused while restoring spooled data from
-                             * disk.
+                             * disk. When streaming, the chunks of a tuple not
+                             * decoded yet are kept for the next stream.
                              */
                             dlist_delete(&change->node);
                             ReorderBufferToastAppendChunk(rb, txn, relation, change);
@@ -1445,8 +1472,12 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
         ReorderBufferIterTXNFinish(rb, iterstate);
         iterstate = NULL;
 
-        /* call commit callback */
-        rb->commit(rb, txn, commit_lsn);
+        /* call commit or stream stop callback */
+        if (streaming) {
+            rb->stream_stop(rb, txn);
+        } else {
+            rb->commit(rb, txn, commit_lsn);
+        }
 
         /* this is just a sanity check against bad output plugin behaviour */
         if (GetCurrentTransactionIdIfAny() != InvalidTransactionId)
@@ -1471,11 +1502,27 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
         else if (txn_started)
             AbortCurrentTransaction();
 
-        if (snapshot_now->copied)
-            ReorderBufferFreeSnap(rb, snapshot_now);
+        if (streaming) {
+            /*
+             * Keep the current snapshot for the next stream, the change that
+             * installed it is discarded with the streamed changes.
+             */
+            if (snapshot_now->copied) {
+                txn->snapshot_now = snapshot_now;
+            } else if (snapshot_now != txn->base_snapshot) {
+                txn->snapshot_now = ReorderBufferCopySnap(rb, snapshot_now, txn, command_id);
+            }
+            txn->command_id = command_id;
 
-        /* remove potential on-disk data, and deallocate */
-        ReorderBufferCleanupTXN(rb, txn);
+            /* remove the streamed changes from memory and disk, keep the transaction */
+            ReorderBufferTruncateTXN(rb, txn);
+        } else {
+            if (snapshot_now->copied)
+                ReorderBufferFreeSnap(rb, snapshot_now);
+
+            /* remove potential on-disk data, and deallocate */
+            ReorderBufferCleanupTXN(rb, txn);
+        }
     }
     PG_CATCH();
     {
@@ -1507,6 +1554,92 @@ void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit
     PG_END_TRY();
 }
 
+/*
+ * Perform the replay of a transaction and its non-aborted subtransactions.
+ *
+ * Subtransactions previously have to be processed by
+ * ReorderBufferCommitChild(), even if previously assigned to the toplevel
+ * transaction with ReorderBufferAssignChild.
+ *
+ * We currently can only decode a transaction's contents when its commit
+ * record is read because that's the only place where we know about cache
+ * invalidations. Thus, once a toplevel commit is read, we iterate over the top
+ * and subtransactions (using a k-way merge) and replay the changes in lsn
+ * order. The exception are transactions already streamed while in progress,
+ * for which only the changes decoded since the last stream are streamed
+ * before the commit is reported.
+ */
+void ReorderBufferCommit(ReorderBuffer* rb, TransactionId xid, XLogRecPtr commit_lsn, XLogRecPtr end_lsn,
+    RepOriginId origin_id, CommitSeqNo csn, TimestampTz commit_time)
+{
+    ReorderBufferTXN* txn = NULL;
+    dlist_iter iter;
+
+    txn = ReorderBufferTXNByXid(rb, xid, false, NULL, InvalidXLogRecPtr, false);
+    /* unknown transaction, nothing to replay */
+    if (txn == NULL)
+        return;
+
+    txn->final_lsn = commit_lsn;
+    txn->end_lsn = end_lsn;
+    txn->origin_id = origin_id;
+    txn->csn = csn;
+    txn->commit_time = commit_time;
+
+    /*
+     * If this transaction has no snapshot, it didn't make any changes to the
+     * database, so there's nothing to decode.  Note that
+     * ReorderBufferCommitChild will have transferred any snapshots from
+     * subtransactions if there were any.
+     */
+    if (txn->base_snapshot == NULL) {
+        Assert(txn->ninvalidations == 0);
+        ReorderBufferCleanupTXN(rb, txn);
+        return;
+    }
+
+    /*
+     * A subtransaction streamed before it was known to be one was streamed as
+     * a transaction of its own, so it has to be committed as well.
+     */
+    dlist_foreach(iter, &txn->subtxns)
+    {
+        ReorderBufferTXN* subtxn = dlist_container(ReorderBufferTXN, node, iter.cur);
+
+        if (subtxn->streamed) {
+            subtxn->origin_id = origin_id;
+            subtxn->csn = csn;
+            subtxn->commit_time = commit_time;
+            rb->stream_commit(rb, subtxn, commit_lsn);
+        }
+    }
+
+    if (!txn->streamed) {
+        ReorderBufferProcessTXN(rb, txn, commit_lsn, false);
+        return;
+    }
+
+    /* stream the changes decoded since the last stream, then commit */
+    bool has_changes = txn->nentries > 0;
+    dlist_foreach(iter, &txn->subtxns)
+    {
+        ReorderBufferTXN* subtxn = dlist_container(ReorderBufferTXN, node, iter.cur);
+
+        if (subtxn->nentries > 0)
+            has_changes = true;
+    }
+
+    if (has_changes) {
+        ReorderBufferProcessTXN(rb, txn, commit_lsn, true);
+    } else {
+        ReorderBufferExecuteInvalidationsInSnapshot(rb, txn);
+    }
+    rb->stream_commit(rb, txn, commit_lsn);
+
+    /* remove potential on-disk data, and deallocate */
+    ReorderBufferCleanupTXN(rb, txn);
+}
+
 /*
  * Abort a transaction that possibly has previous changes. Needs to be first
  * called for subtransactions and then for the toplevel xid.
@@ -1531,6 +1664,10 @@ void ReorderBufferAbort(ReorderBuffer* rb, TransactionId xid, XLogRecPtr lsn)
     /* cosmetic... */
     txn->final_lsn = lsn;
 
+    /* let the output plugin discard what it has been streamed so far */
+    if (ReorderBufferTXNIsStreamed(rb, txn))
+        rb->stream_abort(rb, txn, lsn);
+
     /* remove potential on-disk data, and deallocate */
     ReorderBufferCleanupTXN(rb, txn);
 }
@@ -1562,6 +1699,9 @@ void ReorderBufferAbortOld(ReorderBuffer* rb, TransactionId oldestRunningXid, XL
             if (!RecoveryInProgress())
                 ereport(DEBUG2, (errmsg("aborting old transaction %lu", txn->xid)));
 
+            if (txn->streamed)
+                rb->stream_abort(rb, txn, lsn);
+
             /* remove potential on-disk data, and deallocate this tx */
             ReorderBufferCleanupTXN(rb, txn, lsn);
         } else
@@ -1599,28 +1739,40 @@ void ReorderBufferForget(ReorderBuffer* rb, TransactionId xid, XLogRecPtr lsn)
      * not interested in the transaction's contents, it could have manipulated
      * the catalog and we need to update the caches according to that.
      */
-    if (txn->base_snapshot != NULL && txn->ninvalidations > 0) {
-        /* setup snapshot to perform the invalidations in */
-        SetupHistoricSnapshot(txn->base_snapshot, txn->tuplecid_hash);
-        PG_TRY();
-        {
-            ReorderBufferExecuteInvalidations(rb, txn);
-            TeardownHistoricSnapshot(false);
-        }
-        PG_CATCH();
-        {
-            /* cleanup */
-            TeardownHistoricSnapshot(true);
-            PG_RE_THROW();
-        }
-        PG_END_TRY();
-    } else
+    if (txn->base_snapshot != NULL && txn->ninvalidations > 0)
+        ReorderBufferExecuteInvalidationsInSnapshot(rb, txn);
+    else
         Assert(txn->ninvalidations == 0);
 
     /* remove potential on-disk data, and deallocate */
     ReorderBufferCleanupTXN(rb, txn);
 }
 
+/*
+ * Execute the invalidations of a transaction whose changes are not replayed,
+ * in its base snapshot.
+ */
+static void ReorderBufferExecuteInvalidationsInSnapshot(ReorderBuffer* rb, ReorderBufferTXN* txn)
+{
+    if (txn->ninvalidations == 0)
+        return;
+
+    /* setup snapshot to perform the invalidations in */
+    SetupHistoricSnapshot(txn->base_snapshot, txn->tuplecid_hash);
+    PG_TRY();
+    {
+        ReorderBufferExecuteInvalidations(rb, txn);
+        TeardownHistoricSnapshot(false);
+    }
+    PG_CATCH();
+    {
+        /* cleanup */
+        TeardownHistoricSnapshot(true);
+        PG_RE_THROW();
+    }
+    PG_END_TRY();
+}
+
 /*
  * Tell reorderbuffer about an xid seen in the WAL stream. Has to be called at
  * least once for every xid in XLogRecord->xl_xid (other places in records
@@ -1834,18 +1986,243 @@ static void ReorderBufferSerializeReserve(ReorderBuffer* rb, Size sz)
 }
 
 /*
- * Check whether the transaction tx should spill its data to disk.
+ * Size of a change in memory, as accounted against logical_decoding_work_mem.
  */
-static void ReorderBufferCheckSerializeTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
+static Size ReorderBufferChangeSize(ReorderBufferChange* change)
 {
+    Size sz = sizeof(ReorderBufferChange);
+
+    switch (change->action) {
+        case REORDER_BUFFER_CHANGE_INSERT:
+        case REORDER_BUFFER_CHANGE_UPDATE:
+        case REORDER_BUFFER_CHANGE_DELETE:
+            if (change->data.tp.oldtuple != NULL)
+                sz += sizeof(ReorderBufferTupleBuf) + change->data.tp.oldtuple->alloc_tuple_size;
+            if (change->data.tp.newtuple != NULL)
+                sz += sizeof(ReorderBufferTupleBuf) + change->data.tp.newtuple->alloc_tuple_size;
+            break;
+        case REORDER_BUFFER_CHANGE_INTERNAL_SNAPSHOT: {
+            Snapshot snap = change->data.snapshot;
+
+            sz += sizeof(SnapshotData) + sizeof(TransactionId) * snap->xcnt + sizeof(TransactionId) * snap->subxcnt;
+            break;
+        }
+        case REORDER_BUFFER_CHANGE_INTERNAL_COMMAND_ID:
+        case REORDER_BUFFER_CHANGE_INTERNAL_TUPLECID:
+            break;
+    }
+
+    return sz;
+}
+
+/*
+ * Account for a change added to (or removed from) the in-memory changes of a
+ * transaction.
+ */
+static void ReorderBufferChangeMemoryUpdate(
+    ReorderBuffer* rb, ReorderBufferTXN* txn, ReorderBufferChange* change, bool addition)
+{
+    Size sz = ReorderBufferChangeSize(change);
+
+    if (addition) {
+        txn->size += sz;
+        rb->size += sz;
+    } else {
+        Assert(txn->size >= sz && rb->size >= sz);
+        txn->size -= sz;
+        rb->size -= sz;
+    }
+}
+
+/*
+ * Release all the memory accounted to a transaction, once its in-memory
+ * changes are gone.
+ */
+static void ReorderBufferTXNMemoryRelease(ReorderBuffer* rb, ReorderBufferTXN* txn)
+{
+    Assert(rb->size >= txn->size);
+    rb->size -= txn->size;
+    txn->size = 0;
+}
+
+/*
+ * Find the (sub)transaction using the most memory. Subtransactions are
+ * accounted separately, they are looked up by xid as well.
+ */
+static ReorderBufferTXN* ReorderBufferLargestTXN(ReorderBuffer* rb)
+{
+    HASH_SEQ_STATUS hash_seq;
+    ReorderBufferTXNByIdEnt* ent = NULL;
+    ReorderBufferTXN* largest = NULL;
+
+    hash_seq_init(&hash_seq, rb->by_txn);
+    while ((ent = (ReorderBufferTXNByIdEnt*)hash_seq_search(&hash_seq)) != NULL) {
+        ReorderBufferTXN* txn = ent->txn;
+
+        if (largest == NULL || txn->size > largest->size)
+            largest = txn;
+    }
+
+    return largest;
+}
+
+/*
+ * Check whether the output plugin can stream in-progress transactions at this
+ * point of the decoding.
+ */
+static bool ReorderBufferCanStream(ReorderBuffer* rb)
+{
+    LogicalDecodingContext* ctx = (LogicalDecodingContext*)rb->private_data;
+
+    if (ctx == NULL || !ctx->streaming)
+        return false;
+
     /*
-     * description: improve accounting so we cheaply can take subtransactions into
-     * account here.
+     * Before the snapshot is consistent we may not even know all the running
+     * transactions, and changes before the start point are not sent at all.
      */
-    if (txn->nentries_mem >= (unsigned)g_instance.attr.attr_common.max_changes_in_memory) {
-        ReorderBufferSerializeTXN(rb, txn);
-        Assert(txn->nentries_mem == 0);
+    return SnapBuildCurrentState(ctx->snapshot_builder) == SNAPBUILD_CONSISTENT &&
+           !SnapBuildXactNeedsSkip(ctx->snapshot_builder, ctx->reader->EndRecPtr);
+}
+
+/*
+ * Check whether a toplevel transaction can be streamed. Changes are decoded
+ * with the catalog as of the last stream, so a transaction that modified the
+ * catalog is spilled to disk and decoded at commit instead.
+ */
+static bool ReorderBufferTXNCanStream(ReorderBufferTXN* txn)
+{
+    dlist_iter iter;
+
+    if (txn->is_known_as_subxact || txn->base_snapshot == NULL || txn->has_catalog_changes)
+        return false;
+
+    dlist_foreach(iter, &txn->subtxns)
+    {
+        ReorderBufferTXN* subtxn = dlist_container(ReorderBufferTXN, node, iter.cur);
+
+        if (subtxn->has_catalog_changes)
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * Check whether part of a (sub)transaction has already been sent to the
+ * output plugin.
+ */
+static bool ReorderBufferTXNIsStreamed(ReorderBuffer* rb, ReorderBufferTXN* txn)
+{
+    ReorderBufferTXN* toptxn = NULL;
+
+    if (txn->streamed)
+        return true;
+    if (!txn->is_known_as_subxact)
+        return false;
+
+    toptxn = ReorderBufferTXNByXid(rb, txn->toplevel_xid, false, NULL, InvalidXLogRecPtr, false);
+    return toptxn != NULL && toptxn->streamed;
+}
+
+/*
+ * Check whether the changes kept in memory exceed logical_decoding_work_mem,
+ * and if so evict the largest transactions, by streaming them to the output
+ * plugin when possible and spilling them to disk otherwise, until they don't.
+ */
+static void ReorderBufferCheckMemoryLimit(ReorderBuffer* rb)
+{
+    Size limit = (Size)g_instance.attr.attr_common.logical_decoding_work_mem * 1024L;
+
+    while (rb->size >= limit) {
+        ReorderBufferTXN* largest = ReorderBufferLargestTXN(rb);
+        ReorderBufferTXN* toptxn = largest;
+
+        if (largest == NULL || largest->size == 0)
+            break;
+
+        if (largest->is_known_as_subxact)
+            toptxn = ReorderBufferTXNByXid(rb, largest->toplevel_xid, false, NULL, InvalidXLogRecPtr, false);
+
+        if (toptxn != NULL && ReorderBufferCanStream(rb) && ReorderBufferTXNCanStream(toptxn)) {
+            /* the toplevel is streamed along with all its known subtransactions */
+            ReorderBufferStreamTXN(rb, toptxn);
+        } else {
+            ReorderBufferSerializeTXN(rb, largest);
+            Assert(largest->nentries_mem == 0);
+        }
+    }
+}
+
+/*
+ * Send the changes of an in-progress transaction (and its subtransactions)
+ * decoded so far to the output plugin, and release them.
+ */
+static void ReorderBufferStreamTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
+{
+    dlist_iter iter;
+
+    /*
+     * The transaction is still running, so final_lsn is only the last change
+     * decoded so far; it bounds the spill files removed after the stream.
+     */
+    if (!dlist_is_empty(&txn->changes)) {
+        ReorderBufferChange* last = dlist_tail_element(ReorderBufferChange, node, &txn->changes);
+
+        if (XLByteLT(txn->final_lsn, last->lsn))
+            txn->final_lsn = last->lsn;
+    }
+    dlist_foreach(iter, &txn->subtxns)
+    {
+        ReorderBufferTXN* subtxn = dlist_container(ReorderBufferTXN, node, iter.cur);
+
+        if (!dlist_is_empty(&subtxn->changes)) {
+            ReorderBufferChange* last = dlist_tail_element(ReorderBufferChange, node, &subtxn->changes);
+
+            if (XLByteLT(txn->final_lsn, last->lsn))
+                txn->final_lsn = last->lsn;
+        }
+    }
+
+    if (!RecoveryInProgress()) {
+        ereport(DEBUG2, (errmsg("stream %u changes in tx %lu", (uint32)txn->nentries, txn->xid)));
+    }
+
+    txn->streamed = true;
+    ReorderBufferProcessTXN(rb, txn, InvalidXLogRecPtr, true);
+}
+
+/*
+ * Discard the changes of a streamed transaction and its subtransactions, from
+ * memory and disk. The transactions themselves are kept until they end.
+ */
+static void ReorderBufferTruncateTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
+{
+    dlist_mutable_iter iter;
+
+    dlist_foreach_modify(iter, &txn->subtxns)
+    {
+        ReorderBufferTXN* subtxn = dlist_container(ReorderBufferTXN, node, iter.cur);
+
+        ReorderBufferTruncateTXN(rb, subtxn);
     }
+
+    dlist_foreach_modify(iter, &txn->changes)
+    {
+        ReorderBufferChange* change = dlist_container(ReorderBufferChange, node, iter.cur);
+
+        dlist_delete(&change->node);
+        ReorderBufferReturnChange(rb, change);
+    }
+
+    if (txn->serialized) {
+        ReorderBufferRestoreCleanup(rb, txn);
+        txn->serialized = false;
+    }
+
+    ReorderBufferTXNMemoryRelease(rb, txn);
+    txn->nentries = 0;
+    txn->nentries_mem = 0;
 }
 
 /*
@@ -1917,7 +2294,12 @@ static void ReorderBufferSerializeTXN(ReorderBuffer* rb, ReorderBufferTXN* txn)
             }
         }
 
+        /* the spilled changes are restored by final_lsn, keep it past them */
+        if (XLByteLT(txn->final_lsn, change->lsn))
+            txn->final_lsn = change->lsn;
+
         ReorderBufferSerializeChange(rb, txn, fd, change);
+        ReorderBufferChangeMemoryUpdate(rb, txn, change, false);
         dlist_delete(&change->node);
         ReorderBufferReturnChange(rb, change);
 
@@ -2186,6 +2568,7 @@ static void ReorderBufferRestoreChange(ReorderBuffer* rb, ReorderBufferTXN* txn,
     /* copy static part */
     rc = memcpy_s(change, sizeof(ReorderBufferChange), &ondisk->change, sizeof(ReorderBufferChange));
     securec_check(rc, "", "");
+    change->txn = txn;
 
     data += sizeof(ReorderBufferDiskChange);
 
@@ -2263,7 +2646,7 @@ static void ReorderBufferRestoreChange(ReorderBuffer* rb, ReorderBufferTXN* txn,
 /*
  * Remove all on-disk stored for the passed in transaction.
  */
-static void ReorderBufferRestoreCleanup(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr lsn = InvalidXLogRecPtr)
+static void ReorderBufferRestoreCleanup(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr lsn)
 {
     XLogSegNo first;
     XLogSegNo cur;
@@ -144,6 +144,12 @@ public:
 
     static CUPointer GetMaxCUPointer(_in_ int attrno, _in_ Relation rel);
 
+    // save and load the zstd dictionaries trained for column *attnum*.
+    // they are kept in the CUDesc table, see ZstdDictColID().
+    static void SaveZstdDict(_in_ Relation rel, _in_ int attnum, _in_ const ZstdDict *dict);
+    static ZstdDictSet *LoadZstdDicts(_in_ Relation rel, _in_ int attnum);
+    static void FreeZstdDicts(_in_ ZstdDictSet *dictSet);
+
 public:
     CStore();
     virtual ~CStore();
@@ -273,6 +279,10 @@ private:  // private methods.
     bool NeedLoadCUDesc(int32 &cudesc_idx);
     void IncLoadCuDescIdx(int &idx) const;
     bool RoughCheck(CStoreScanKey scanKey, int nkeys, int cuDescIdx);
+    bool RoughCheckRuntimeFilters(CStoreScanState *state, int cuDescIdx);
+
+    void InitDictFilterEnv(CStoreScanState *state);
+    void ApplyDictFiltersIfNeed(int cuDescIdx);
 
     void FillColMinMax(CUDesc *cuDescPtr, ScalarVector *vec, int pos);
 
@@ -281,6 +291,9 @@ private:  // private methods.
     // only called by GetCUData()
     CUUncompressedRetCode GetCUDataFromRemote(CUDesc *cuDescPtr, CU *cuPtr, int colIdx, int valSize, const int &slotId);
 
+    // the zstd dictionaries to uncompress CUs of column *colIdx* with
+    const ZstdDictSet *GetZstdDicts(int colIdx);
+
     /* defence functions */
     void CheckConsistenceOfCUDescCtl(void);
     void CheckConsistenceOfCUDesc(int cudescIdx) const;
@@ -330,6 +343,43 @@ private:
     // 
     RoughCheckFunc *m_RCFuncs;
 
+    // Runtime join filters planned on accessed columns. Once the hash join
+    // has built one, CUs whose min/max miss the filter's range are skipped.
+    // 
+    typedef struct {
+        Var *var;               // the filtered column
+        int bfIndex;            // its slot in es_bloom_filter
+        int seq;                // its position in m_colId
+        RoughCheckFunc geFunc;  // does the CU hold a value >= filter min
+        RoughCheckFunc leFunc;  // does the CU hold a value <= filter max
+    } RuntimeFilterRCInfo;
+
+    RuntimeFilterRCInfo *m_RTFilters;
+    int m_RTFilterNum;
+
+    // Quals "column op const" and "column = ANY(const array)" on varlena
+    // columns. On dictionary encoded CUs they are evaluated once per item,
+    // and the rows they reject are masked out like deleted rows before any
+    // column of the batch is materialized.
+    // 
+    typedef struct {
+        int seq;            // position of the column in m_colId
+        FmgrInfo opFunc;    // strict and not volatile operator function
+        Oid collation;      // input collation of the operator
+        bool constFirst;    // the const is the left operand
+        Datum *args;        // the const, or the not-null elements of the array
+        int nargs;
+    } DictFilterInfo;
+
+    DictFilterInfo *m_dictFilters;
+    int m_dictFilterNum;
+    uint32 m_dictFilterCUId;  // the CU m_dictFilters have been applied to
+
+    // zstd dictionaries of each column, loaded by GetZstdDicts() when
+    // the first CU of the column is read.
+    // 
+    ZstdDictSet **m_zstdDicts;
+
     typedef int (CStore::*m_colFillFun)(int seq, CUDesc *cuDescPtr, ScalarVector *vec);
 
     typedef struct {
@@ -138,6 +138,9 @@ private:
     // Get min/max of CU
     // 
     CU *FormCU(int col, bulkload_rows *batchRowPtr, CUDesc *cuDescPtr);
+#ifdef USE_ZSTD
+    const ZstdDict *GetZstdDict(int col, const CU *cuPtr);
+#endif
     Size FormCUTInitMem(CU *cuPtr, bulkload_rows *batchRowPtr, int col, bool hasNull);
     void FormCUTCopyMem(CU *cuPtr, bulkload_rows *batchRowPtr, CUDesc *cuDescPtr, Size dtSize, int col, bool hasNull);
     template <bool hasNull>
@@ -196,6 +199,11 @@ private:
     compression_options *m_cuCmprsOptions; /* compression filter */
     cu_tmp_compress_info m_cuTempInfo;     /* temp info for CU compression */
 
+    /* zstd dictionary of each string column, see GetZstdDict() */
+    ZstdDictSet **m_zstdDicts;
+    bool *m_zstdDictLoaded;    /* looked up in CUDesc table */
+    bool *m_zstdDictUntrained; /* the values of the column taught nothing */
+
     /* buffered batchrows for many VectorBatch values */
     bulkload_rows *m_bufferedBatchRows;
 
@@ -133,7 +133,8 @@ public:
     // load data for single cu.
     // caller should delete CU object returned.
     static CU *LoadSingleCuData(_in_ CUDesc *pCuDesc, _in_ int colIdx, _in_ int colAttrLen, _in_ int colTypeMode,
-                                _in_ uint32 colAtttyPid, _in_ Relation rel, __inout CUStorage *pCuStorage);
+                                _in_ uint32 colAtttyPid, _in_ Relation rel, __inout CUStorage *pCuStorage,
+                                _in_ const ZstdDictSet *zstdDicts);
 };
 
 // remember those relation oids
@@ -251,6 +252,7 @@ private:
     int m_SDTColsNum;
     CStoreRewriteColumn **m_SDTColsInfo;
     CUStorage **m_SDTColsReader;
+    ZstdDictSet **m_SDTColsZstdDicts;
     FuncSetMinMax *m_SDTColsMinMaxFunc;
     CUStorage **m_SDTColsWriter;
     Datum *m_SDTColValues;
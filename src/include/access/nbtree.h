@@ -21,6 +21,7 @@
 #include "catalog/pg_index.h"
 #include "lib/stringinfo.h"
 #include "storage/bufmgr.h"
+#include "storage/condition_variable.h"
 
 /* There's room for a 16-bit vacuum cycle ID in BTPageOpaqueData */
 typedef uint16 BTCycleId;
@@ -610,6 +611,41 @@ typedef struct BTScanOpaqueData {
 
 typedef BTScanOpaqueData* BTScanOpaque;
 
+/*
+ * Below flags are used to indicate the state of a parallel scan.
+ *
+ * BTPARALLEL_NOT_INITIALIZED indicates that the scan has not started.
+ *
+ * BTPARALLEL_ADVANCING indicates that some process is advancing the scan to
+ * a new page; others must wait.
+ *
+ * BTPARALLEL_IDLE indicates that no backend is currently advancing the scan
+ * to a new page; some process can start doing that.
+ *
+ * BTPARALLEL_DONE indicates that the scan is complete (including error exit).
+ */
+typedef enum {
+    BTPARALLEL_NOT_INITIALIZED,
+    BTPARALLEL_ADVANCING,
+    BTPARALLEL_IDLE,
+    BTPARALLEL_DONE
+} BTPS_State;
+
+/*
+ * BTParallelScanDescData contains btree specific shared information required
+ * for parallel scan.  It lives at ParallelIndexScanDesc->ps_offset.
+ */
+typedef struct BTParallelScanDescData {
+    BlockNumber btps_scanPage;  /* latest or next page to be scanned */
+    BTPS_State btps_pageStatus; /* indicates whether next page is available
+                                 * for scan. see above for possible states of
+                                 * parallel scan. */
+    slock_t btps_mutex;         /* protects above variables */
+    ConditionVariable btps_cv;  /* used to synchronize parallel scan */
+} BTParallelScanDescData;
+
+typedef struct BTParallelScanDescData* BTParallelScanDesc;
+
 /*
  * We use some private sk_flags bits in preprocessed scan keys.  We're allowed
  * to use bits 16-31 (see skey.h).	The uppermost bits are copied from the
@@ -680,6 +716,9 @@ extern Datum btbulkdelete(PG_FUNCTION_ARGS);
 extern Datum btvacuumcleanup(PG_FUNCTION_ARGS);
 extern Datum btcanreturn(PG_FUNCTION_ARGS);
 extern Datum btoptions(PG_FUNCTION_ARGS);
+extern Size btestimateparallelscan(void);
+extern void btinitparallelscan(void* target);
+extern void btparallelrescan(IndexScanDesc scan);
 /* 
  * this is the interface of merge 2 or more index for btree index
  * we also have similar interfaces for other kind of indexes, like hash/gist/gin
@@ -687,6 +726,13 @@ extern Datum btoptions(PG_FUNCTION_ARGS);
  */
 extern Datum btmerge(PG_FUNCTION_ARGS);
 
+/*
+ * prototypes for internal functions in nbtree.c
+ */
+extern bool _bt_parallel_seize(IndexScanDesc scan, BlockNumber* pageno);
+extern void _bt_parallel_release(IndexScanDesc scan, BlockNumber scan_page);
+extern void _bt_parallel_done(IndexScanDesc scan);
+
 /*
  * prototypes for functions in nbtinsert.c
  */
@@ -753,6 +799,7 @@ extern IndexTuple _bt_nonkey_truncate(Relation idxrel, IndexTuple olditup);
  * prototypes for functions in nbtsort.c
  */
 typedef struct BTSpool BTSpool; /* opaque type known only within nbtsort.c */
+typedef struct BTLeader BTLeader; /* parallel build leader state, likewise */
 
 /* Working state for btbuild and its callback */
 typedef struct {
@@ -768,12 +815,26 @@ typedef struct {
      */
     BTSpool* spool2;
     double indtuples;
+
+    /*
+     * btleader is only present when a parallel index build is performed, and
+     * only in the leader thread.  Each participant fills in a BTBuildState
+     * of its own for btbuildCallback, with btleader left NULL.
+     */
+    BTLeader* btleader;
 } BTBuildState;
 
-extern BTSpool* _bt_spoolinit(Relation index, bool isunique, bool isdead, void* meminfo);
+extern void btbuildCallback(
+    Relation index, HeapTuple htup, Datum* values, const bool* isnull, bool tupleIsAlive, void* state);
+
+extern BTSpool* _bt_spoolinit(Relation index, bool isunique, bool isdead, void* meminfo, BTLeader* btleader = NULL);
 extern void _bt_spooldestroy(BTSpool* btspool);
 extern void _bt_spool(BTSpool* btspool, ItemPointer self, Datum* values, const bool* isnull);
 extern void _bt_leafbuild(BTSpool* btspool, BTSpool* spool2);
+extern void _bt_begin_parallel(BTBuildState* buildstate, Relation index, bool isconcurrent, int request);
+extern double _bt_parallel_heapscan(BTBuildState* buildstate, bool* brokenhotchain);
+extern void _bt_end_parallel(BTLeader* btleader);
+extern void _bt_parallel_build_main(void* seg);
 /* these 4 functions are move here from nbtsearch.cpp(static functions) */
 extern void _bt_buildadd(BTWriteState* wstate, BTPageState* state, IndexTuple itup);
 extern void _bt_uppershutdown(BTWriteState* wstate, BTPageState* state);
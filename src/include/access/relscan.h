@@ -18,6 +18,7 @@
 #include "access/heapam.h"
 #include "access/itup.h"
 #include "access/tupdesc.h"
+#include "storage/bufmgr.h"
 
 #define PARALLEL_SCAN_GAP 100
 
@@ -38,10 +39,30 @@ typedef struct ParallelHeapScanDescData {
     slock_t phs_mutex;               /* mutual exclusion for setting startblock */
     BlockNumber phs_startblock;      /* starting block number */
     pg_atomic_uint64 phs_nallocated; /* number of blocks allocated to workers so far. */
+    bool phs_snapshot_any;           /* SnapshotAny, not phs_snapshot_data? */
     uint32 pscan_len;                /* total size of this struct, including phs_snapshot_data */
     char phs_snapshot_data[FLEXIBLE_ARRAY_MEMBER];
 } ParallelHeapScanDescData;
 
+/*
+ * Shared state for parallel index scan.
+ *
+ * The leader lays this out once in the parallel context memory; every
+ * participant's IndexScanDesc points at it.  The serialized snapshot comes
+ * first and the index AM's own shared state starts at ps_offset, so that
+ * the AM can hand out leaf pages without knowing about the snapshot.
+ */
+typedef struct ParallelIndexScanDescData {
+    int plan_node_id;                            /* used to identify speicific plan */
+    Oid ps_relid;                                /* OID of the heap relation */
+    Oid ps_indexid;                              /* OID of the index relation */
+    Size ps_offset;                              /* offset in bytes of the AM specific structure */
+    Size pscan_len;                              /* total size of this struct, including AM state */
+    char ps_snapshot_data[FLEXIBLE_ARRAY_MEMBER];
+} ParallelIndexScanDescData;
+
+#define OffsetToPointer(base, offset) ((void*)((char*)(base) + (offset)))
+
 /* ----------------------------------------------------------------
  *				 Scan State Information
  * ----------------------------------------------------------------
@@ -52,6 +73,7 @@ typedef struct SeqScanAccessor {
     uint32 sa_prefetch_quantity; /* preftch quantity*/
     uint32 sa_prefetch_trigger;  /*the prefetch-trigger distance bewteen last prefetched buffer and currently accessed
                                     buffer */
+    PrefetchDistance sa_distance; /* adaptive prefetch distance, at most sa_prefetch_quantity */
 } SeqScanAccessor;
 
 struct TableAm;
@@ -177,6 +199,11 @@ typedef struct IndexScanDescData {
 
     /* state data for traversing HOT chains in index_getnext */
     bool xs_continue_hot; /* T if must keep walking HOT chain */
+
+    /* parallel index scan information, in parallel context memory */
+    ParallelIndexScanDesc parallel_scan;
+    bool xs_temp_snap; /* unregister snapshot at scan end? */
+
     /* put decompressed heap tuple data into xs_ctbuf_hdr be careful! when malloc memory  should give extra mem for
      *xs_ctbuf_hdr. t_bits which is varlength arr
      */
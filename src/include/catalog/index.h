@@ -116,7 +116,8 @@ extern void index_build(Relation heapRelation, Partition heapPartition, Relation
                          bool isreindex, IndexCreatePartitionType partitionType);
 
 extern double IndexBuildHeapScan(Relation heapRelation, Relation indexRelation, IndexInfo *indexInfo,
-                                 bool allow_sync, IndexBuildCallback callback, void *callback_state);
+                                 bool allow_sync, IndexBuildCallback callback, void *callback_state,
+                                 HeapScanDesc scan = NULL);
 extern double* GlobalIndexBuildHeapScan(Relation heapRelation, Relation indexRelation, IndexInfo* indexInfo,
                                  IndexBuildCallback callback, void* callbackState);
 
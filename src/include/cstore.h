@@ -61,6 +61,12 @@ const int VitrualDelColID = -10;
 
 const int VirtualSpaceCacheColID = -11;
 
+/* The zstd dictionaries trained for column attnum are kept in the CUDesc table
+ * under col_id (VirtualZstdDictColIDBase - attnum), one row per dictionary.
+ */
+const int VirtualZstdDictColIDBase = -100;
+#define ZstdDictColID(attnum) (VirtualZstdDictColIDBase - (int)(attnum))
+
 /* The attribute number of CUDesc table */
 const int CUDescColIDAttr = 1;
 const int CUDescCUIDAttr = 2;
@@ -381,6 +381,7 @@ extern bool check_exclusion_constraint(Relation heap, Relation index, IndexInfo*
 extern void RegisterExprContextCallback(ExprContext* econtext, ExprContextCallbackFunction function, Datum arg);
 extern void UnregisterExprContextCallback(ExprContext* econtext, ExprContextCallbackFunction function, Datum arg);
 extern List* GetAccessedVarnoList(List* targetList, List* qual);
+extern filter::BloomFilter* ExecGetRuntimeFilter(EState* estate, Var* var, int idx);
 extern ProjectionInfo* ExecBuildVecProjectionInfo(
     List* targetList, List* nt_qual, ExprContext* econtext, TupleTableSlot* slot, TupleDesc inputDesc);
 extern bool tlist_matches_tupdesc(PlanState* ps, List* tlist, Index varno, TupleDesc tupdesc);
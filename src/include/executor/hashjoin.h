@@ -16,6 +16,7 @@
 
 #include "nodes/execnodes.h"
 #include "storage/buffile.h"
+#include "storage/parallel_barrier.h"
 
 /* ----------------------------------------------------------------
  *				hash-join hash table structures
@@ -118,6 +119,49 @@ typedef struct HashMemoryChunkData* HashMemoryChunk;
 #define HASH_CHUNK_SIZE (32 * 1024L)
 #define HASH_CHUNK_THRESHOLD (HASH_CHUNK_SIZE / 4)
 
+/*
+ * Parallel hash join.
+ *
+ * A parallel-aware HashJoin keeps a single hash table in the memory of the
+ * parallel context instead of one private table per participant.  Every
+ * participant pulls tuples from its share of the (partial) inner plan and
+ * pushes them onto the shared buckets with compare-and-swap; tuples are
+ * packed into HashMemoryChunks allocated from the shared context and linked
+ * into one list so they can be released when the join is rescanned.
+ *
+ * The build is coordinated by build_barrier, whose phases are:
+ *
+ *   PHJ_BUILD_ELECTING       -- initial state, one participant is elected
+ *   PHJ_BUILD_ALLOCATING     -- the elected participant allocates the buckets
+ *   PHJ_BUILD_HASHING_INNER  -- all participants hash the inner relation
+ *   PHJ_BUILD_DONE           -- the table is complete and may be probed
+ *
+ * A participant that attaches late joins whatever phase is in progress, so
+ * it never waits for work that has already been done.  Once the build is
+ * done participants detach and probe without further synchronization.
+ *
+ * The shared table never spills: the planner only chooses a parallel hash
+ * when the whole inner relation is expected to fit in the combined work_mem
+ * of the participants.
+ */
+typedef struct ParallelHashJoinState {
+    int plan_node_id;       /* plan node id of the owning HashJoin */
+    int nbuckets;           /* # buckets in the shared hash table */
+    int log2_nbuckets;      /* its log2 */
+    HashJoinTuple* buckets; /* shared bucket array, NULL until allocated */
+    HashMemoryChunk chunks; /* chunks of all participants */
+    double totalTuples;     /* # inner tuples hashed by all participants */
+    int64 spaceUsed;        /* tuple space used by all participants */
+    MemoryContext cxt;      /* shared context holding buckets and chunks */
+    slock_t mutex;          /* protects chunks, totalTuples and spaceUsed */
+    Barrier build_barrier;  /* synchronizes the build phases */
+} ParallelHashJoinState;
+
+#define PHJ_BUILD_ELECTING 0
+#define PHJ_BUILD_ALLOCATING 1
+#define PHJ_BUILD_HASHING_INNER 2
+#define PHJ_BUILD_DONE 3
+
 typedef struct HashJoinTableData {
     int nbuckets;      /* # buckets in the in-memory hash table */
     int log2_nbuckets; /* its log2 (nbuckets must be a power of 2) */
@@ -179,6 +223,9 @@ typedef struct HashJoinTableData {
     int64 maxMem;           /* batch auto spread mem */
     int spreadNum;          /* auto spread times */
     int64* spill_size;
+
+    /* shared state when this participant works on a parallel hash join */
+    ParallelHashJoinState* parallel_state;
 } HashJoinTableData;
 
 #endif /* HASHJOIN_H */
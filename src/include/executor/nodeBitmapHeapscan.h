@@ -14,11 +14,48 @@
 #ifndef NODEBITMAPHEAPSCAN_H
 #define NODEBITMAPHEAPSCAN_H
 
+#include "access/parallel.h"
 #include "nodes/execnodes.h"
+#include "storage/condition_variable.h"
+
+/*
+ * Parallel bitmap heap scan.
+ *
+ * The first participant to reach a parallel-aware BitmapHeapScan runs the
+ * bitmap index scans below it and publishes the resulting TIDBitmap for a
+ * shared iteration; the others wait on cv until that is done.  From then on
+ * each participant claims the next heap page from the shared iterator.
+ *
+ * Prefetching follows the serial scan, except that the prefetch iterator and
+ * the prefetch distance are shared too, so the participants together keep
+ * prefetch_target pages ahead of the pages claimed so far.
+ */
+typedef enum {
+    BM_INITIAL,    /* nobody has started building the bitmap */
+    BM_INPROGRESS, /* one participant is building it */
+    BM_FINISHED    /* the shared iterators are ready */
+} SharedBitmapState;
+
+typedef struct ParallelBitmapHeapState {
+    int plan_node_id;                          /* plan node id of the owning BitmapHeapScan */
+    MemoryContext cxt;                         /* shared context holding the bitmap pages */
+    TBMSharedIteratorState* tbmiterator;       /* iterator handing out heap pages */
+    TBMSharedIteratorState* prefetch_iterator; /* iterator for prefetching, or NULL */
+    slock_t mutex;                             /* protects the fields below */
+    int prefetch_pages;                        /* # pages prefetch iterator is ahead of main */
+    int prefetch_target;                       /* current target prefetch distance */
+    SharedBitmapState state;                   /* progress of building the bitmap */
+    ConditionVariable cv;                      /* to wait for the bitmap to be built */
+} ParallelBitmapHeapState;
 
 extern BitmapHeapScanState* ExecInitBitmapHeapScan(BitmapHeapScan* node, EState* estate, int eflags);
 extern TupleTableSlot* ExecBitmapHeapScan(BitmapHeapScanState* node);
 extern void ExecEndBitmapHeapScan(BitmapHeapScanState* node);
 extern void ExecReScanBitmapHeapScan(BitmapHeapScanState* node);
 
+/* parallel scan support */
+extern void ExecBitmapHeapInitializeDSM(BitmapHeapScanState* node, ParallelContext* pcxt, int nodeid);
+extern void ExecBitmapHeapReInitializeDSM(BitmapHeapScanState* node, ParallelContext* pcxt);
+extern void ExecBitmapHeapInitializeWorker(BitmapHeapScanState* node, void* context);
+
 #endif /* NODEBITMAPHEAPSCAN_H */
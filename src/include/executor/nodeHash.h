@@ -25,8 +25,10 @@ extern TupleTableSlot* ExecHash(void);
 extern Node* MultiExecHash(HashState* node);
 extern void ExecEndHash(HashState* node);
 extern void ExecReScanHash(HashState* node);
+extern void ExecHashResetRuntimeFilters(HashState* node);
 
-extern HashJoinTable ExecHashTableCreate(Hash* node, List* hashOperators, bool keepNulls);
+extern HashJoinTable ExecHashTableCreate(
+    Hash* node, List* hashOperators, bool keepNulls, struct ParallelHashJoinState* pstate = NULL);
 extern void ExecHashTableDestroy(HashJoinTable hashtable);
 extern void ExecHashTableInsert(HashJoinTable hashtable, TupleTableSlot* slot, uint32 hashvalue, int planid, int dop,
     Instrumentation* instrument = NULL);
@@ -14,6 +14,7 @@
 #ifndef NODEINDEXSCAN_H
 #define NODEINDEXSCAN_H
 
+#include "access/parallel.h"
 #include "nodes/execnodes.h"
 
 extern IndexScanState* ExecInitIndexScan(IndexScan* node, EState* estate, int eflags);
@@ -23,6 +24,12 @@ extern void ExecIndexMarkPos(IndexScanState* node);
 extern void ExecIndexRestrPos(IndexScanState* node);
 extern void ExecReScanIndexScan(IndexScanState* node);
 
+/* parallel scan support */
+extern void ExecIndexScanEstimate(IndexScanState* node, ParallelContext* pcxt);
+extern void ExecIndexScanInitializeDSM(IndexScanState* node, ParallelContext* pcxt, int nodeid);
+extern void ExecIndexScanReInitializeDSM(IndexScanState* node, ParallelContext* pcxt);
+extern void ExecIndexScanInitializeWorker(IndexScanState* node, void* context);
+
 /*
  * These routines are exported to share code with nodeIndexonlyscan.c and
  * nodeBitmapIndexscan.c
@@ -28,11 +28,40 @@
 #ifndef NODEPARTITERATOR_H
 #define NODEPARTITERATOR_H
 
+#include "access/heapam.h"
+#include "access/parallel.h"
 #include "nodes/execnodes.h"
+#include "storage/spin.h"
+
+/*
+ * Parallel partition iteration.
+ *
+ * Below a Gather, the participants of a parallel-aware PartIterator claim
+ * partitions from next_itr, so that each partition is scanned by exactly one
+ * of them.  A partition much larger than the others would leave a single
+ * participant working long after the rest are done, so the partitions holding
+ * more than one participant's share of the blocks get a parallel heap scan
+ * in pscans[] instead: they are not finished when claimed, every participant
+ * that comes across one joins its scan, and the first one to run out of
+ * blocks marks it finished.
+ */
+typedef struct ParallelPartIteratorState {
+    int plan_node_id;                          /* plan node id of the owning PartIterator */
+    int nitrs;                                 /* number of partitions to scan */
+    ParallelHeapScanDesc* pscans;              /* shared scan per partition, or NULL if claimed whole */
+    slock_t mutex;                             /* protects the fields below */
+    int next_itr;                              /* next partition to hand out */
+    bool finished[FLEXIBLE_ARRAY_MEMBER];      /* partitions that need no more participants */
+} ParallelPartIteratorState;
 
 extern PartIteratorState* ExecInitPartIterator(PartIterator* node, EState* estate, int eflags);
 extern TupleTableSlot* ExecPartIterator(PartIteratorState* node);
 extern void ExecEndPartIterator(PartIteratorState* node);
 extern void ExecReScanPartIterator(PartIteratorState* node);
 
+/* parallel scan support */
+extern void ExecPartIteratorInitializeDSM(PartIteratorState* node, ParallelContext* pcxt, int nodeid);
+extern void ExecPartIteratorReInitializeDSM(PartIteratorState* node, ParallelContext* pcxt);
+extern void ExecPartIteratorInitializeWorker(PartIteratorState* node, void* context);
+
 #endif /* NODEPARTITERATOR_H */
@@ -56,6 +56,8 @@ typedef struct knl_instance_attr_common {
     int MaxDataNodes;
     int max_changes_in_memory;
     int max_cached_tuplebufs;
+    int logical_decoding_work_mem;
+    int thread_pool_queue_wait_target;
 #ifdef USE_BONJOUR
     char* bonjour_name;
 #endif
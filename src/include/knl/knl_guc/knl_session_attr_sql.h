@@ -48,6 +48,7 @@ typedef struct knl_session_attr_sql {
     bool enable_valuepartition_pruning;
     bool enable_constraint_optimization;
     bool enable_bloom_filter;
+    bool enable_scan_runtime_filter;
     bool enable_codegen;
     bool enable_codegen_print;
     bool enable_sonic_optspill;
@@ -70,6 +71,7 @@ typedef struct knl_session_attr_sql {
     bool enable_nestloop;
     bool enable_mergejoin;
     bool enable_hashjoin;
+    bool enable_parallel_hash;
     bool enable_index_nestloop;
     bool enable_nodegroup_debug;
     bool enable_partitionwise;
@@ -155,6 +157,7 @@ typedef struct knl_session_attr_sql {
     int max_cn_temp_file_size;
     int default_statistics_target;
     int min_parallel_table_scan_size;
+    int min_parallel_index_scan_size;
     /* Memory Limit user could set in session */
     int FencedUDFMemoryLimit;
     int64 g_default_expthresh;
@@ -205,7 +208,9 @@ typedef struct knl_session_attr_sql {
     int opfusion_debug_mode;
     int single_shard_stmt;
     int force_parallel_mode;
+    int vector_engine_strategy;
     int max_parallel_workers_per_gather;
+    int max_parallel_maintenance_workers;
 } knl_session_attr_sql;
 
 #endif /* SRC_INCLUDE_KNL_KNL_SESSION_ATTR_SQL */
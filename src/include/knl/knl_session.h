@@ -2035,6 +2035,10 @@ typedef struct knl_u_ext_fdw_context {
 
 /* Info need to pass from leader to worker */
 struct ParallelHeapScanDescData;
+struct ParallelIndexScanDescData;
+struct ParallelHashJoinState;
+struct ParallelBitmapHeapState;
+struct ParallelPartIteratorState;
 typedef uint64 XLogRecPtr;
 typedef struct ParallelQueryInfo {
     struct SharedExecutorInstrumentation *instrumentation;
@@ -2047,6 +2051,14 @@ typedef struct ParallelQueryInfo {
     int eflags;
     int pscan_num;
     ParallelHeapScanDescData **pscan;
+    int piscan_num;
+    ParallelIndexScanDescData **piscan;
+    int phjstate_num;
+    ParallelHashJoinState **phjstate;
+    int pbmscan_num;
+    ParallelBitmapHeapState **pbmscan;
+    int ppiterator_num;
+    ParallelPartIteratorState **ppiterator;
 } ParallelQueryInfo;
 
 struct BTShared;
@@ -2138,6 +2150,7 @@ typedef struct knl_session_context {
     Dlelem elem;
 
     ThreadId attachPid;
+    TimestampTz queue_wait_start; /* when the listener queued us for a worker, 0 if not queued */
 
     MemoryContext top_mem_cxt;
     MemoryContext cache_mem_cxt;
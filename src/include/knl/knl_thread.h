@@ -2322,6 +2322,8 @@ typedef struct knl_t_storage_context {
 
     /* Pointers to shared state */
     struct BufferStrategyControl* StrategyControl;
+    /* clock sweep partition this thread evicts from first, -1 until chosen */
+    int StrategyHomePartition;
     /* remember global block slot in progress */
     CacheSlotId_t CacheBlockInProgressIO;
     CacheSlotId_t CacheBlockInProgressUncompress;
@@ -69,9 +69,10 @@ typedef struct UtilityDesc {
  *		ReadyForInserts		is it valid for inserts?
  *		Concurrent			are we doing a concurrent index build?
  *		BrokenHotChain		did we detect any broken HOT chains?
+ *		ParallelWorkers		# of workers requested (excludes leader)
  *
- * ii_Concurrent and ii_BrokenHotChain are used only during index build;
- * they're conventionally set to false otherwise.
+ * ii_Concurrent, ii_BrokenHotChain, and ii_ParallelWorkers are used only
+ * during index build; they're conventionally zeroed otherwise.
  * ----------------
  */
 typedef struct IndexInfo {
@@ -93,6 +94,7 @@ typedef struct IndexInfo {
     bool ii_ReadyForInserts;
     bool ii_Concurrent;
     bool ii_BrokenHotChain;
+    int ii_ParallelWorkers;
     short ii_PgClassAttrId;
     UtilityDesc ii_desc; /* meminfo for index create */
 } IndexInfo;
@@ -1547,6 +1549,7 @@ typedef struct ScanState {
     SampleScanParams sampleScanInfo; /* TABLESAMPLE params include type/seed/repeatable. */
     ExecScanAccessMtd ScanNextMtd;
     Size pscan_len; /* size of parallel heap scan descriptor */
+    struct ParallelHeapScanDescData** part_pscans; /* per-partition shared scans of a parallel PartIterator */
 } ScanState;
 
 /*
@@ -1589,6 +1592,7 @@ typedef struct {
  *		RuntimeContext	   expr context for evaling runtime Skeys
  *		RelationDesc	   index relation descriptor
  *		ScanDesc		   index scan descriptor
+ *		PscanLen		   size of parallel index scan descriptor
  * ----------------
  */
 typedef struct IndexScanState {
@@ -1607,6 +1611,7 @@ typedef struct IndexScanState {
     List* iss_IndexPartitionList;
     LOCKMODE lockMode;
     Relation iss_CurrentIndexPartition;
+    Size iss_PscanLen;
 } IndexScanState;
 
 /* ----------------
@@ -1625,6 +1630,7 @@ typedef struct IndexScanState {
  *		ScanDesc		   index scan descriptor
  *		VMBuffer		   buffer in use for visibility map testing, if any
  *		HeapFetches		   number of tuples we were forced to fetch from heap
+ *		PscanLen		   size of parallel index-only scan descriptor
  * ----------------
  */
 typedef struct IndexOnlyScanState {
@@ -1645,6 +1651,7 @@ typedef struct IndexOnlyScanState {
     List* ioss_IndexPartitionList;
     LOCKMODE lockMode;
     Relation ioss_CurrentIndexPartition;
+    Size ioss_PscanLen;
 } IndexOnlyScanState;
 
 /* ----------------
@@ -1691,6 +1698,11 @@ typedef struct BitmapIndexScanState {
  *		prefetch_iterator  iterator for prefetching ahead of current page
  *		prefetch_pages	   # pages prefetch iterator is ahead of current
  *		prefetch_target    target prefetch distance
+ *		prefetch_distance  read-latency driven ceiling of prefetch_target (ADIO)
+ *		initialized		   is the iteration over the bitmap set up?
+ *		pstate			   shared state for parallel bitmap scan
+ *		shared_tbmiterator	   shared iterator, for parallel scan
+ *		shared_prefetch_iterator shared prefetch iterator, for parallel scan
  * ----------------
  */
 typedef struct BitmapHeapScanState {
@@ -1702,7 +1714,12 @@ typedef struct BitmapHeapScanState {
     TBMIterator* prefetch_iterator;
     int prefetch_pages;
     int prefetch_target;
+    PrefetchDistance prefetch_distance;
     GPIScanDesc gpi_scan;  /* global partition index scan use information */
+    bool initialized;
+    struct ParallelBitmapHeapState* pstate;
+    TBMSharedIterator* shared_tbmiterator;
+    TBMSharedIterator* shared_prefetch_iterator;
 } BitmapHeapScanState;
 
 /* ----------------
@@ -2315,6 +2332,9 @@ typedef struct HashState {
     List* hashkeys;          /* list of ExprState nodes */
     int32 local_work_mem;    /* work_mem local for this hash join */
     int64 spill_size;
+    struct ParallelHashJoinState* parallel_state; /* shared table, for parallel hash */
+    List* bf_var_list;      /* inner keys to build runtime bloom filters on */
+    List* bf_filter_index;  /* their slots in es_bloom_filter */
 
     /* hashkeys is same as parent's hj_InnerHashKeys */
 } HashState;
@@ -2403,6 +2423,7 @@ typedef struct LimitState {
 typedef struct PartIteratorState {
     PlanState ps;   /* its first field is NodeTag */
     int currentItr; /* the sequence number for processing partition */
+    struct ParallelPartIteratorState* pstate; /* shared state of a parallel-aware iterator, or NULL */
 } PartIteratorState;
 
 struct VecLimitState : public LimitState {
@@ -1099,6 +1099,18 @@ typedef enum SAggMethod {
 
 #endif
 
+/*
+ * Parallel aggregation splits one aggregation into two Agg nodes: a Partial
+ * Agg run by every participant below a Gather, which emits transition values
+ * instead of final results, and a Finalize Agg above the Gather, which
+ * combines those values with the aggregates' collection functions.
+ */
+typedef enum AggParallelStage {
+    AGG_PARALLEL_NONE = 0, /* ordinary, unsplit aggregation */
+    AGG_PARALLEL_PARTIAL,  /* below Gather: skip the final functions */
+    AGG_PARALLEL_FINAL     /* above Gather: collect and finalize */
+} AggParallelStage;
+
 typedef struct Agg {
     Plan plan;
     AggStrategy aggstrategy;
@@ -1117,6 +1129,7 @@ typedef struct Agg {
     bool is_sonichash;    /* allowed to use sonic hash routine or not */
     bool is_dummy;        /* just for coop analysis, if true, agg node does nothing */
     uint32 skew_optimize; /* skew optimize method for agg */
+    AggParallelStage parallel_stage; /* role in a parallel aggregation */
 } Agg;
 
 /* ----------------
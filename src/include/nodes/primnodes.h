@@ -64,6 +64,9 @@ typedef enum OptCompress {
     COMPRESS_LOW,
     COMPRESS_MIDDLE,
     COMPRESS_HIGH,
+#ifdef USE_ZSTD
+    COMPRESS_ZSTD,
+#endif
 } OptCompress;
 
 /*
@@ -700,6 +700,7 @@ typedef struct IndexOptInfo {
     bool amsearchnulls;  /* can AM search for NULL/NOT NULL entries? */
     bool amhasgettuple;  /* does AM have amgettuple interface? */
     bool amhasgetbitmap; /* does AM have amgetbitmap interface? */
+    bool amcanparallel;  /* does AM support parallel scan? */
 } IndexOptInfo;
 
 /*
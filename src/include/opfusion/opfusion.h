@@ -200,6 +200,36 @@ private:
     bool m_is_bucket_rel;
 };
 
+class MultiInsertFusion : public OpFusion {
+public:
+    MultiInsertFusion(MemoryContext context, CachedPlanSource* psrc, List* plantree_list, ParamListInfo params);
+
+    ~MultiInsertFusion(){};
+
+    bool execute(long max_rows, char* completionTag);
+
+private:
+    Datum evalValuesExpr(Expr* expr, bool* is_null);
+
+    void formRow(List* row);
+
+    EState* m_estate;
+
+    /* rows of the VALUES list */
+    List* m_valuesLists;
+
+    /* attribute number in the VALUES list for each target column, 0 means use m_targetExprs */
+    AttrNumber* m_valuesAttno;
+
+    /* row independent target expressions, such as defaults of the omitted columns */
+    Expr** m_targetExprs;
+
+    /* one evaluated row of the VALUES list */
+    Datum* m_rowValues;
+
+    bool* m_rowIsnull;
+};
+
 class UpdateFusion : public OpFusion {
 public:
     UpdateFusion(MemoryContext context, CachedPlanSource* psrc, List* plantree_list, ParamListInfo params);
@@ -45,6 +45,7 @@ enum FusionType {
     SELECT_FUSION,
     SELECT_FOR_UPDATE_FUSION,
     INSERT_FUSION,
+    MULTI_INSERT_FUSION,
     UPDATE_FUSION,
     DELETE_FUSION,
     AGG_INDEX_FUSION,
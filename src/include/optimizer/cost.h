@@ -90,10 +90,13 @@ extern void cost_tsstorescan(Path *path, PlannerInfo *root, RelOptInfo *baserel)
 extern void cost_index(IndexPath* path, PlannerInfo* root, double loop_count);
 extern void cost_bitmap_heap_scan(
     Path* path, PlannerInfo* root, RelOptInfo* baserel, ParamPathInfo* param_info, Path* bitmapqual, double loop_count);
+extern double compute_bitmap_pages(
+    PlannerInfo* root, RelOptInfo* baserel, Path* bitmapqual, double loop_count, Cost* cost, double* tuple);
 extern void cost_bitmap_and_node(BitmapAndPath* path, PlannerInfo* root);
 extern void cost_bitmap_or_node(BitmapOrPath* path, PlannerInfo* root);
 extern void cost_bitmap_tree_node(Path* path, Cost* cost, Selectivity* selec);
 extern void cost_tidscan(Path* path, PlannerInfo* root, RelOptInfo* baserel, List* tidquals);
+extern void cost_parallel_partiterator(PartIteratorPath* path);
 extern void cost_subqueryscan(Path* path, PlannerInfo* root, RelOptInfo* baserel, ParamPathInfo* param_info);
 extern void cost_functionscan(Path* path, PlannerInfo* root, RelOptInfo* baserel);
 extern void cost_valuesscan(Path* path, PlannerInfo* root, RelOptInfo* baserel);
@@ -51,6 +51,13 @@ typedef enum {
     FORCE_PARALLEL_REGRESS
 } ForceParallelMode;
 
+/* possible values for try_vector_engine_strategy */
+typedef enum {
+    OFF_VECTOR_ENGINE,   /* only plans over column store relations are vectorized */
+    FORCE_VECTOR_ENGINE, /* also vectorize plans over row relations where supported */
+    OPT_VECTOR_ENGINE    /* as force, but only where the plan aggregates many rows */
+} TryVectorEngineStrategy;
+
 extern ExecNodes* getExecNodesByGroupName(const char* gname);
 extern PlannedStmt* planner(Query* parse, int cursorOptions, ParamListInfo boundParams);
 extern PlannedStmt* standard_planner(Query* parse, int cursorOptions, ParamListInfo boundParams);
@@ -67,6 +74,7 @@ extern bool is_single_baseresult_plan(Plan* plan);
 extern Expr* expression_planner(Expr* expr);
 
 extern bool plan_cluster_use_sort(Oid tableOid, Oid indexOid);
+extern int plan_create_index_workers(Oid tableOid, Oid indexOid);
 
 extern bool ContainRecursiveUnionSubplan(PlannedStmt* pstmt);
 
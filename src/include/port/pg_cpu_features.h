@@ -0,0 +1,28 @@
+/* ---------------------------------------------------------------------------------------
+ *
+ * pg_cpu_features.h
+ *        Runtime detection of the vector instruction sets of the CPU.
+ *
+ * Kernels built for a wider instruction set than the baseline are picked at
+ * runtime, once the CPU is known to support it.  On x86 that also takes the
+ * OS saving the wider register state across context switches.
+ *
+ * Portions Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ *
+ * IDENTIFICATION
+ *        src/include/port/pg_cpu_features.h
+ *
+ * ---------------------------------------------------------------------------------------
+ */
+#ifndef PG_CPU_FEATURES_H
+#define PG_CPU_FEATURES_H
+
+#if defined(__x86_64__) && defined(HAVE__GET_CPUID)
+#define USE_X86_CPU_FEATURES
+
+extern bool pg_cpu_has_avx2(void);
+extern bool pg_cpu_has_avx512f(void);
+#endif
+
+#endif /* PG_CPU_FEATURES_H */
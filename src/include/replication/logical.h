@@ -46,6 +46,13 @@ typedef struct LogicalDecodingContext {
     OutputPluginCallbacks callbacks;
     OutputPluginOptions options;
 
+    /*
+     * Does the output plugin support streaming of in-progress transactions?
+     * Set if it defines the stream callbacks, the plugin may clear it in
+     * its startup callback.
+     */
+    bool streaming;
+
     /*
      * User specified options
      */
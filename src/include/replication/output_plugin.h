@@ -73,8 +73,42 @@ typedef void (*LogicalDecodeShutdownCB)(struct LogicalDecodingContext* ctx);
  */
 typedef bool (*LogicalDecodeFilterByOriginCB)(struct LogicalDecodingContext* ctx, RepOriginId origin_id);
 
+/*
+ * Called when starting to stream a block of changes of an in-progress
+ * transaction, which may happen several times for the same transaction.
+ */
+typedef void (*LogicalDecodeStreamStartCB)(struct LogicalDecodingContext* ctx, ReorderBufferTXN* txn);
+
+/*
+ * Called when the current block of streamed changes ends.
+ */
+typedef void (*LogicalDecodeStreamStopCB)(struct LogicalDecodingContext* ctx, ReorderBufferTXN* txn);
+
+/*
+ * Called to discard the streamed changes of an aborted transaction, or of an
+ * aborted subtransaction of a streamed transaction.
+ */
+typedef void (*LogicalDecodeStreamAbortCB)(
+    struct LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr abort_lsn);
+
+/*
+ * Called to commit a streamed transaction, after its last block of changes.
+ */
+typedef void (*LogicalDecodeStreamCommitCB)(
+    struct LogicalDecodingContext* ctx, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
+
+/*
+ * Callback for every individual change streamed from an in-progress
+ * transaction. txn is the (sub)transaction the change belongs to.
+ */
+typedef void (*LogicalDecodeStreamChangeCB)(
+    struct LogicalDecodingContext* ctx, ReorderBufferTXN* txn, Relation relation, ReorderBufferChange* change);
+
 /*
  * Output plugin callbacks
+ *
+ * The stream callbacks are optional, in-progress transactions are streamed
+ * only to plugins that define all of them.
  */
 typedef struct OutputPluginCallbacks {
     LogicalDecodeStartupCB startup_cb;
@@ -83,6 +117,11 @@ typedef struct OutputPluginCallbacks {
     LogicalDecodeCommitCB commit_cb;
     LogicalDecodeShutdownCB shutdown_cb;
     LogicalDecodeFilterByOriginCB filter_by_origin_cb;
+    LogicalDecodeStreamStartCB stream_start_cb;
+    LogicalDecodeStreamStopCB stream_stop_cb;
+    LogicalDecodeStreamAbortCB stream_abort_cb;
+    LogicalDecodeStreamCommitCB stream_commit_cb;
+    LogicalDecodeStreamChangeCB stream_change_cb;
 } OutputPluginCallbacks;
 
 extern void OutputPluginPrepareWrite(struct LogicalDecodingContext* ctx, bool last_write);
@@ -69,6 +69,9 @@ typedef struct ReorderBufferChange {
 
     RepOriginId origin_id;
 
+    /* The (sub)transaction this change belongs to. */
+    struct ReorderBufferTXN* txn;
+
     /*
      * Context data for the change, which part of the union is valid depends
      * on action/action_internal.
@@ -205,6 +208,27 @@ typedef struct ReorderBufferTXN {
      */
     bool serialized;
 
+    /*
+     * Has this transaction been streamed to the output plugin while in
+     * progress?  The changes of a streamed transaction are discarded once
+     * streamed, so its end is reported through stream_commit/stream_abort.
+     */
+    bool streamed;
+
+    /*
+     * Snapshot and CommandId to continue decoding a streamed transaction
+     * with, as the changes that installed them are gone. NULL before the
+     * first stream or when the base snapshot is still current.
+     */
+    Snapshot snapshot_now;
+    CommandId command_id;
+
+    /*
+     * Memory used by the changes of this (sub)transaction that are kept in
+     * memory, accounted against logical_decoding_work_mem.
+     */
+    Size size;
+
     /*
      * List of ReorderBufferChange structs, including new Snapshots and new
      * CommandIds
@@ -267,6 +291,18 @@ typedef void (*ReorderBufferBeginCB)(ReorderBuffer* rb, ReorderBufferTXN* txn);
 /* commit callback signature */
 typedef void (*ReorderBufferCommitCB)(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
 
+/* start streaming a block of changes of an in-progress transaction */
+typedef void (*ReorderBufferStreamStartCB)(ReorderBuffer* rb, ReorderBufferTXN* txn);
+
+/* stop streaming a block of changes of an in-progress transaction */
+typedef void (*ReorderBufferStreamStopCB)(ReorderBuffer* rb, ReorderBufferTXN* txn);
+
+/* discard the streamed changes of an aborted (sub)transaction */
+typedef void (*ReorderBufferStreamAbortCB)(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr abort_lsn);
+
+/* commit a streamed transaction */
+typedef void (*ReorderBufferStreamCommitCB)(ReorderBuffer* rb, ReorderBufferTXN* txn, XLogRecPtr commit_lsn);
+
 struct ReorderBuffer {
     /*
      * xid => ReorderBufferTXN lookup table
@@ -302,6 +338,16 @@ struct ReorderBuffer {
     ReorderBufferApplyChangeCB apply_change;
     ReorderBufferCommitCB commit;
 
+    /*
+     * Callbacks to be called when streaming in-progress transactions, only
+     * used if the output plugin supports streaming.
+     */
+    ReorderBufferStreamStartCB stream_start;
+    ReorderBufferStreamStopCB stream_stop;
+    ReorderBufferStreamAbortCB stream_abort;
+    ReorderBufferStreamCommitCB stream_commit;
+    ReorderBufferApplyChangeCB stream_change;
+
     /*
      * Pointer that will be passed untouched to the callbacks.
      */
@@ -339,6 +385,9 @@ struct ReorderBuffer {
     /* buffer for disk<->memory conversions */
     char* outbuf;
     Size outbufsize;
+
+    /* memory used by the changes kept in memory, of all transactions */
+    Size size;
 };
 
 ReorderBuffer* ReorderBufferAllocate(void);
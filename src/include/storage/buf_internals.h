@@ -316,7 +316,19 @@ extern BufferDesc *StrategyGetBuffer(BufferAccessStrategy strategy, uint32 *buf_
 extern void StrategyFreeBuffer(volatile BufferDesc* buf);
 extern bool StrategyRejectBuffer(BufferAccessStrategy strategy, BufferDesc* buf);
 
+/* state of one clock sweep partition, as reported by StrategyGetPartitionStats */
+typedef struct BufferStrategyPartitionStat {
+    int partition_id;
+    int buf_id_start;
+    int num_buffers;
+    uint32 complete_passes;
+    uint64 candidate_allocs;
+    uint64 sweep_allocs;
+    uint64 stolen_allocs;
+} BufferStrategyPartitionStat;
+
 extern int StrategySyncStart(uint32* complete_passes, uint32* num_buf_alloc);
+extern int StrategyGetPartitionStats(BufferStrategyPartitionStat** stats);
 extern void StrategyNotifyBgWriter(int bgwprocno);
 
 extern Size StrategyShmemSize(void);
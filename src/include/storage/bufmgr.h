@@ -15,6 +15,7 @@
 #define BUFMGR_H
 
 #include "knl/knl_variable.h"
+#include "portability/instr_time.h"
 #include "storage/block.h"
 #include "storage/buf.h"
 #include "storage/bufpage.h"
@@ -202,6 +203,26 @@ extern void PageRangePrefetch(
     Relation reln, ForkNumber forkNum, BlockNumber blockNum, int32 n, uint32 flags, uint32 col);
 extern void PageListPrefetch(
     Relation reln, ForkNumber forkNum, BlockNumber* blockList, int32 n, uint32 flags, uint32 col);
+
+/*
+ * Adaptive read-ahead distance of a scan that prefetches through ADIO.  The
+ * scan times each page read with PrefetchDistanceReadStart/ReadDone, and the
+ * distance grows while reads still wait for the device and shrinks back once
+ * they no longer do.
+ */
+typedef struct PrefetchDistance {
+    int distance;      /* current read-ahead distance in pages */
+    int min_distance;
+    int max_distance;
+    int window_pages;  /* pages read since the distance was last adjusted */
+    int window_stalls; /* how many of them waited for I/O */
+    uint64 avg_wait_us; /* moving average of the read wait, for debugging */
+    instr_time read_start;
+} PrefetchDistance;
+
+extern void PrefetchDistanceInit(PrefetchDistance* pd, int max_distance);
+extern void PrefetchDistanceReadStart(PrefetchDistance* pd);
+extern void PrefetchDistanceReadDone(PrefetchDistance* pd);
 extern Buffer ReadBuffer(Relation reln, BlockNumber blockNum);
 extern Buffer ReadBufferExtended(
     Relation reln, ForkNumber forkNum, BlockNumber blockNum, ReadBufferMode mode, BufferAccessStrategy strategy);
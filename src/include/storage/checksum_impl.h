@@ -96,6 +96,12 @@
  * to unroll the inner loop to avoid loop overhead and minimize register
  * spilling. For less sophisticated compilers it might be beneficial to
  * manually unroll the inner loop.
+ *
+ * Rather than leave it all to the compiler, the server also carries explicit
+ * AVX2 and AVX-512 kernels for x86 and a NEON kernel for ARM.
+ * pg_checksum_block picks one on first use according to what the CPU supports,
+ * falling back to the portable code.  All of them compute exactly the same
+ * result.
  * ---------------------------------------------------------------------------------------
  */
 
@@ -161,4 +167,13 @@ static const uint32 g_checksumBaseOffsets[N_SUMS] = {0x5B1F36E9,
  */
 uint32 pg_checksum_block(char* data, uint32 size);
 
+/* Implementations pg_checksum_block chooses from at runtime */
+uint32 pg_checksum_block_generic(char* data, uint32 size);
+#if defined(__x86_64__)
+uint32 pg_checksum_block_avx2(char* data, uint32 size);
+uint32 pg_checksum_block_avx512(char* data, uint32 size);
+#elif defined(__aarch64__)
+uint32 pg_checksum_block_neon(char* data, uint32 size);
+#endif
+
 uint16 pg_checksum_page(char* page, BlockNumber blkno);
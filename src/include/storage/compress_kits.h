@@ -264,6 +264,92 @@ private:
     short m_outValSize;
 };
 
+/*
+ * Bit packing with frame of reference.
+ *
+ * Like delta, each value is replaced by its difference from the min value, but the
+ * difference takes just the bits needed by (max - min) instead of whole bytes. The
+ * values are packed LSB first into a little-endian bit stream, and the last byte is
+ * padded with zero bits. Bit widths above BITPACK_MAX_BITS are not packed, because
+ * they save nothing against delta, and one value plus its bit shift must fit into
+ * one 64-bit load while unpacking.
+ */
+#define BITPACK_MAX_BITS 56
+
+/// Given the min-value and max-value, return how many bits needed
+/// to remember their difference value.
+extern inline short BitpackGetBitsNum(_in_ int64 mindata, _in_ int64 maxdata)
+{
+    Assert(mindata <= maxdata);
+    uint64 diff = (uint64)maxdata - (uint64)mindata;
+
+    if (diff == 0)
+        return 1;
+    return (short)(64 - __builtin_clzll(diff));
+}
+
+/// judge whether bit packing can be applied to, that's, it
+/// saves some bits of each value against delta compression.
+extern inline bool BitpackCanBeApplied(int64 minVal, int64 maxVal)
+{
+    short bits = BitpackGetBitsNum(minVal, maxVal);
+    return (bits <= BITPACK_MAX_BITS) && (bits < DeltaGetBytesNum(minVal, maxVal) * 8);
+}
+
+/// get memory bound for Bitpack compression.
+extern inline int BitpackGetBound(int nValues, short bits)
+{
+    return (int)(((int64)nValues * bits + 7) / 8);
+}
+
+class BitpackCoder : public BaseObject {
+public:
+    // both Compress and Decompress need the min/max data, from which
+    // the bit width is computed.
+    //
+    BitpackCoder(int64 mindata, int64 maxdata);
+    virtual ~BitpackCoder()
+    {}
+
+    FORCE_INLINE short GetBitsNum(void)
+    {
+        return m_bits;
+    }
+
+    FORCE_INLINE int GetBound(int dataNum)
+    {
+        return BitpackGetBound(dataNum, m_bits);
+    }
+
+    // <inDataSize> is the size of each raw value. 0 is returned if outbuf is too small.
+    int Compress(char* inbuf, char* outbuf, int insize, int outsize, short inDataSize);
+
+    // the number of values is taken from <outsize>, and <outDataSize> is the size of
+    // each raw value. 0 is returned if inbuf is too small to hold all of them.
+    int Decompress(char* inbuf, char* outbuf, int insize, int outsize, short outDataSize);
+
+private:
+    template <short inValSize>
+    int DoPack(_in_ char* inbuf, _out_ char* outbuf, _in_ int nValues);
+
+    int64 m_mindata;
+    short m_bits;
+};
+
+/*
+ * Unpacking kernels using SIMD instructions. They never read beyond <insize> bytes
+ * of inbuf, and return how many values from the first one are unpacked. the rest,
+ * and all values of the sizes a kernel doesn't support, are left for the portable
+ * code in BitpackCoder::Decompress().
+ */
+#if defined(__x86_64__)
+extern int BitUnpackAVX2(
+    const char* inbuf, int insize, short bits, int64 mindata, char* outbuf, short outValSize, int nValues);
+#elif defined(__aarch64__)
+extern int BitUnpackNEON(
+    const char* inbuf, int insize, short bits, int64 mindata, char* outbuf, short outValSize, int nValues);
+#endif
+
 typedef uint16 DicCodeType;
 
 /* Dictionary Data In Disk
@@ -403,6 +489,69 @@ private:
     int8 m_compressionLevel;
 };
 
+// a zstd dictionary trained for one column. zstd records dictId in the
+// header of every frame compressed with it, so that the decompressing side
+// can find it again among all the dictionaries of the column.
+//
+typedef struct ZstdDict {
+    uint32 dictId;
+    int size;
+    char* data;
+} ZstdDict;
+
+typedef struct ZstdDictSet {
+    int num;
+    ZstdDict* dicts;
+} ZstdDictSet;
+
+extern const ZstdDict* ZstdDictSetLookup(const ZstdDictSet* dictSet, uint32 dictId);
+
+#ifdef USE_ZSTD
+// ZSTD compress && decompress, built with --with-zstd
+//
+class ZstdWrapper : public BaseObject {
+public:
+    /*
+     * compression level is [1, 19]. unlike LZ4HC and zlib, the decompression
+     * speed of zstd hardly depends on the compression level, so the higher
+     * levels only cost more CPU time when the data is loaded.
+     * we don't use the "ultra" levels 20~22, which need a much larger window.
+     */
+    static const int8 zstd_min_level = 1;
+    static const int8 zstd_recommend_level = 3;
+    static const int8 zstd_level_step = 3;
+    static const int8 zstd_max_level = 19;
+
+    /*
+     * a trained dictionary pays off for the small values of string columns,
+     * which the compressor alone cannot find repeated within one CU. it's
+     * loaded for every CU being (de)compressed, so keep it small.
+     */
+    static const int zstd_dict_max_size = 16 * 1024;
+    static const int zstd_dict_min_samples = 1000;
+
+public:
+    ZstdWrapper() : m_compressionLevel(ZstdWrapper::zstd_recommend_level)
+    {}
+    virtual ~ZstdWrapper()
+    {}
+
+    void SetCompressionLevel(int8 level);
+    int CompressGetBound(int insize) const;
+    int Compress(const char* source, char* dest, int sourceSize, int destSize, const ZstdDict* dict = NULL) const;
+
+    int DecompressGetBound(const char* source, int sourceSize) const;
+    int Decompress(const char* source, char* dest, int sourceSize, int destSize, const ZstdDict* dict = NULL) const;
+
+    static uint32 GetDictID(const char* source, int sourceSize);
+    static int TrainDictionary(const char* samples, const size_t* sampleSizes, int nSamples, uint32 dictId,
+        char* dest, int destSize);
+
+private:
+    int8 m_compressionLevel;
+};
+#endif /* USE_ZSTD */
+
 // ZLIB compress && decompress
 //
 class ZlibEncoder : public BaseObject {
@@ -41,6 +41,24 @@
 #define CU_ZlibCompressed 0x0020
 #define CU_BitpackCompressed 0x0040
 #define CU_IntLikeCompressed 0x0080
+// LZ4 and Zlib are never applied together, so their combination is free to
+// mean zstd. Check it before testing CU_LzCompressed or CU_ZlibCompressed alone.
+#define CU_ZstdCompressed (CU_LzCompressed | CU_ZlibCompressed)
+#define CUIsZstdCompressed(modes) (((modes) & CU_ZstdCompressed) == CU_ZstdCompressed)
+
+// the last OptCompress value a CU can be compressed with
+#ifdef USE_ZSTD
+#define CU_MAX_COMPRESSION COMPRESS_ZSTD
+#else
+#define CU_MAX_COMPRESSION COMPRESS_HIGH
+
+// CUs written by a server built with --with-zstd can't be read without it
+#define NO_ZSTD_SUPPORT()                                        \
+    ereport(ERROR,                                               \
+        (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),                 \
+            errmsg("zstd compressed CU is not supported"),       \
+            errdetail("This functionality requires the server to be built with zstd support.")))
+#endif
 
 extern bool NeedToRecomputeMinMax(Oid typeOid);
 extern int64 ConvertToInt64Data(_in_ const char* inBuf, _in_ const short eachValSize);
@@ -114,6 +132,7 @@ public:
 
     /* optimizing flags */
     bool m_adopt_rle;
+    bool m_adopt_bitpack;
 
 private:
     void InsertMinMaxVal(char* buf, int* usedSize);
@@ -137,16 +156,34 @@ public:
     virtual ~StringCoder()
     {}
 
-    StringCoder() : m_adopt_rle(true), m_adopt_dict(true), m_dicCodes(NULL), m_dicCodesNum(0)
+    StringCoder()
+        : m_adopt_rle(true), m_adopt_dict(true), m_keep_dic_codes(false), m_zstd_dict(NULL), m_zstd_dicts(NULL),
+          m_dicCodes(NULL), m_dicCodesNum(0), m_dicItemsNum(0)
     {}
 
     int Compress(_in_ CompressionArg1& in, _in_ CompressionArg2& out);
     int Decompress(_in_ const CompressionArg2& in, _out_ CompressionArg1& out);
 
+    /*
+     * hand the dictionary codes kept by the last Decompress() over to the caller,
+     * who must pfree them. NULL is returned if the data isn't dictionary encoded.
+     */
+    DicCodeType* TakeDicCodes(_out_ int* codesNum, _out_ int* itemsNum);
+
     /* optimizing flags */
     bool m_adopt_rle;
     bool m_adopt_dict;
 
+    /* keep the dictionary codes after decompressing, see TakeDicCodes() */
+    bool m_keep_dic_codes;
+
+    /*
+     * the trained zstd dictionary of this column to compress with, and all the
+     * ones to decompress with. zstd only uses them without local dictionary.
+     */
+    const ZstdDict* m_zstd_dict;
+    const ZstdDictSet* m_zstd_dicts;
+
 private:
     /* inner implement for compress api */
     template <bool adopt_dict>
@@ -167,6 +204,7 @@ private:
 private:
     DicCodeType* m_dicCodes;
     DicCodeType m_dicCodesNum;
+    int m_dicItemsNum;
 };
 
 /// light-weight implementation for Delta-RLE compression.
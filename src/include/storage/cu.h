@@ -29,6 +29,7 @@
 #include "vecexecutor/vectorbatch.h"
 #include "cstore.h"
 #include "storage/cstore_mem_alloc.h"
+#include "storage/compress_kits.h"
 #include "utils/datum.h"
 #include "storage/lwlock.h"
 
@@ -183,6 +184,9 @@ struct cu_tmp_compress_info {
     int64 m_min_value;
     int64 m_max_value;
     bool m_valid_minmax;
+
+    /* the trained zstd dictionary of the column, or NULL */
+    const ZstdDict* m_zstd_dict;
 };
 
 /* CU struct:
@@ -231,6 +235,16 @@ public:
     /* the number of m_offset items */
     int32 m_offsetSize;
 
+    /*
+     * dictionary code of each row, kept after decompressing a dictionary
+     * encoded varlena CU so that scans can evaluate quals once per dictionary
+     * item instead of once per row. NULL rows hold m_dicItemsNum.
+     * m_dicCodes is NULL if the CU isn't dictionary encoded.
+     */
+    uint16* m_dicCodes;
+    int32 m_dicCodesSize;
+    int32 m_dicItemsNum;
+
     /* source buffer size. */
     uint32 m_srcBufSize;
 
@@ -328,15 +342,19 @@ public:
     void FillCompressBufHeader(void);
     char* CompressNullBitmapIfNeed(_in_ char* buf);
     bool CompressData(_out_ char* outBuf, _in_ int nVals, _in_ int16 compressOption);
+#ifdef USE_ZSTD
+    int TrainZstdDict(_in_ uint32 dictId, _out_ char* dictBuf, _in_ int dictBufSize) const;
+#endif
 
     // Uncompress data
     //
     char* UnCompressHeader(_in_ uint32 magic);
-    void UnCompress(_in_ int rowCount, _in_ uint32 magic);
+    void UnCompress(_in_ int rowCount, _in_ uint32 magic, _in_ const ZstdDictSet* zstdDicts);
     char* UnCompressNullBitmapIfNeed(const char* buf, int rowCount);
-    void UnCompressData(_in_ char* buf, _in_ int rowCount);
+    void UnCompressData(_in_ char* buf, _in_ int rowCount, _in_ const ZstdDictSet* zstdDicts);
     template <bool DscaleFlag>
     void UncompressNumeric(char* inBuf, int nNotNulls, int typmode);
+    void FormDicCodes(uint16* codes, int codesNum, int itemsNum, int rowCount);
 
     // access datum randomly in CU
     //
@@ -524,6 +542,16 @@ void CU::FreeMem()
         this->m_offset = NULL;
         this->m_offsetSize = 0;
     }
+    if (this->m_dicCodes) {
+        if (!freeByCUCacheMgr) {
+            CStoreMemAlloc::Pfree(this->m_dicCodes, !this->m_inCUCache);
+        } else {
+            free(this->m_dicCodes);
+        }
+        this->m_dicCodes = NULL;
+        this->m_dicCodesSize = 0;
+        this->m_dicItemsNum = 0;
+    }
 }
 
 #endif
@@ -128,7 +128,8 @@ public:
     void TerminateVerifyCU();
     void InvalidateCU(RelFileNodeOld* rnode, int colId, uint32 cuId, CUPointer cuPtr);
     void DropRelationCUCache(const RelFileNode& rnode);
-    CUUncompressedRetCode StartUncompressCU(CUDesc* cuDescPtr, CacheSlotId_t slotId, int planNodeId, bool timing);
+    CUUncompressedRetCode StartUncompressCU(CUDesc* cuDescPtr, CacheSlotId_t slotId, int planNodeId, bool timing,
+        const ZstdDictSet* zstdDicts);
 
     // async lock used by adio
     bool CULWLockHeldByMe(CacheSlotId_t slotId);
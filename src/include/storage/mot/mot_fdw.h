@@ -27,6 +27,7 @@
 #define MOT_FDW_H
 
 #include <stdint.h>
+#include "nodes/pg_list.h"
 
 /** @brief Initializes MOT engine. */
 extern void InitMOT();
@@ -77,6 +78,7 @@ extern void MOTOnSessionClose();
 extern void MOTCheckpointFetchLock();
 extern void MOTCheckpointFetchUnlock();
 extern char* MOTCheckpointFetchDirName();
+extern List* MOTCheckpointFetchParentDirNames();
 extern char* MOTCheckpointFetchWorkingDir();
 extern uint64_t MOTCheckpointGetId();
 
@@ -0,0 +1,42 @@
+/* -------------------------------------------------------------------------
+ *
+ * parallel_barrier.h
+ *	  Barriers for synchronizing cooperating threads.
+ *
+ * Not to be confused with the memory barriers of storage/barrier.h: these
+ * barriers let a dynamic group of participants (for example the threads of
+ * a parallel query) advance through a series of numbered phases together.
+ *
+ * Portions Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ * Portions Copyright (c) 1996-2019, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/storage/parallel_barrier.h
+ *
+ * -------------------------------------------------------------------------
+ */
+#ifndef PARALLEL_BARRIER_H
+#define PARALLEL_BARRIER_H
+
+#include "storage/condition_variable.h"
+#include "storage/spin.h"
+
+typedef struct Barrier {
+    slock_t mutex;
+    int phase;              /* phase counter */
+    int participants;       /* the number of participants attached */
+    int arrived;            /* the number of participants that have arrived */
+    int elected;            /* highest phase elected */
+    bool static_party;      /* used only for assertions */
+    ConditionVariable condition_variable;
+} Barrier;
+
+extern void BarrierInit(Barrier* barrier, int num_workers);
+extern bool BarrierArriveAndWait(Barrier* barrier);
+extern bool BarrierArriveAndDetach(Barrier* barrier);
+extern int BarrierAttach(Barrier* barrier);
+extern bool BarrierDetach(Barrier* barrier);
+extern int BarrierPhase(Barrier* barrier);
+extern int BarrierParticipants(Barrier* barrier);
+
+#endif /* PARALLEL_BARRIER_H */
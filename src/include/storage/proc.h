@@ -17,6 +17,7 @@
 #include "access/clog.h"
 #include "access/xlog.h"
 #include "datatype/timestamp.h"
+#include "lib/ilist.h"
 #include "storage/latch.h"
 #include "storage/lock.h"
 #include "storage/pg_sema.h"
@@ -116,6 +117,8 @@ struct PGPROC {
 
     Latch procLatch; /* generic latch for process */
 
+    dlist_node cvWaitLink; /* link in a condition variable's wakeup list */
+
     LocalTransactionId lxid; /* local id of top-level transaction currently
                               * being executed by this proc, if running;
                               * else InvalidLocalTransactionId */
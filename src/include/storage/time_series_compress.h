@@ -85,6 +85,10 @@ public:
         _out_ CompressionArg2& out);
     int zlib_compress(
         int8 compression, int8 compress_level, Size bound_size, BufferHelper* tmpOutBuf, _out_ CompressionArg2& out);
+#ifdef USE_ZSTD
+    int zstd_compress(
+        int8 compression, int8 compress_level, Size bound_size, BufferHelper* tmpOutBuf, _out_ CompressionArg2& out);
+#endif
     int compress(_in_ const CompressionArg1& in, _out_ CompressionArg2& out);
     int decompress(_in_ const CompressionArg2& in, _out_ CompressionArg1& out);
 
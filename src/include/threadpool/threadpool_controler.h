@@ -68,6 +68,7 @@ public:
     void SetThreadPoolInfo();
     int GetThreadNum();
     ThreadPoolStat* GetThreadPoolStat(uint32* num);
+    QueueWaitSample* GetQueueWaitHistory(uint32* num);
     bool StayInAttachMode();
     void ReBindStreamThread(ThreadId tid) const;
     void CloseAllSessions();
@@ -31,8 +31,12 @@
 #include "knl/knl_variable.h"
 
 #define NUM_THREADPOOL_STATUS_ELEM 7
+#define NUM_QUEUE_WAIT_HISTORY_ELEM 7
 #define STATUS_INFO_SIZE 256
 
+/* Queue waits are counted in power-of-two buckets of microseconds */
+#define QUEUE_WAIT_BUCKETS 32
+
 typedef enum { WORKER_SLOT_UNUSE = 0, WORKER_SLOT_INUSE } WorkerSlotStatus;
 
 typedef struct WorkerStatus {
@@ -57,6 +61,16 @@ typedef struct ThreadPoolStat {
     char sessionInfo[STATUS_INFO_SIZE];
 } ThreadPoolStat;
 
+/* One scheduler pass over one group, see ThreadPoolScheduler */
+typedef struct QueueWaitSample {
+    TimestampTz sampleTime;
+    int groupId;
+    uint64 sessions;       /* sessions picked up since the previous pass */
+    int64 waitPercentile;  /* their 95th percentile queue wait in us */
+    int expectWorkerNum;   /* worker number the pass left the group with */
+    const char* action;    /* "enlarge", "reduce" or "none" */
+} QueueWaitSample;
+
 class ThreadPoolGroup : public BaseObject {
 public:
     ThreadPoolListener* m_listener;
@@ -76,6 +90,11 @@ public:
     float4 GetSessionPerThread();
     void GetThreadPoolGroupStat(ThreadPoolStat* stat);
     bool IsGroupHang();
+    void InitStealOrder(ThreadPoolGroup** groups, int groupNum);
+    bool StealSession(ThreadPoolWorker* worker);
+    void WakeUpStealer();
+    void RecordQueueWait(TimestampTz queueTime);
+    int64 ConsumeQueueWaitPercentile(double percentile, uint64* samples);
 
     inline ThreadPoolListener* GetListener()
     {
@@ -109,6 +128,7 @@ public:
 private:
     void AttachThreadToCPU(ThreadId thread, int cpu);
     void AttachThreadToNodeLevel(ThreadId thread) const;
+    int GetNumaDistance(const ThreadPoolGroup* other) const;
 
 private:
     /*
@@ -127,6 +147,9 @@ private:
     volatile int m_sessionCount;           // all session count;
     volatile int m_waitServeSessionCount;  // wait for worker to server
     volatile int m_processTaskCount;
+    volatile uint64 m_stealSessionCount;   // sessions our workers took from other groups
+    volatile uint64 m_stolenSessionCount;  // our sessions served by other groups
+    volatile uint32 m_queueWaitHist[QUEUE_WAIT_BUCKETS]; // queue waits since the scheduler last looked
 
     int m_groupId;
     int m_numaId;
@@ -134,6 +157,8 @@ private:
     int* m_groupCpuArr;
 
     ThreadWorkerSentry* m_workers;
+    ThreadPoolGroup** m_stealGroups; /* the other groups, nearest numa node first */
+    int m_stealGroupNum;
     MemoryContext m_context;
     pthread_mutex_t m_mutex;
     bool m_enableNumaDistribute;
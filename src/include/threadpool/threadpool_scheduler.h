@@ -30,10 +30,13 @@ public:
     ThreadPoolScheduler(int groupNum, ThreadPoolGroup** groups);
     int StartUp();
     void DynamicAdjustThreadPool();
+    QueueWaitSample* GetQueueWaitHistory(uint32* num);
 
 private:
     void ReduceWorkerIfNecessary(int groupIdx);
     void EnlargeWorkerIfNecessage(int groupIdx);
+    bool QueueWaitOverTarget(int64 waitPercentile, uint64 samples) const;
+    void AddQueueWaitSample(ThreadPoolGroup* group, uint64 samples, int64 waitPercentile, int oldExpectNum);
 
 private:
     ThreadId m_tid;
@@ -41,9 +44,16 @@ private:
     ThreadPoolGroup** m_groups;
     uint* m_hangTestCount;
     uint* m_freeTestCount;
+
+    /* ring buffer of the latest passes that saw sessions or resized a group */
+    QueueWaitSample* m_history;
+    uint32 m_historyNext;
+    uint32 m_historyNum;
+    pthread_mutex_t m_historyLock;
 };
 
 #define THREAD_SCHEDULER_STEP 8
+#define QUEUE_WAIT_HISTORY_SIZE 1024
 
 extern void TpoolSchedulerMain(ThreadPoolScheduler* scheduler);
 
@@ -88,6 +88,7 @@ public:
     void CleanUpSession(bool threadexit);
     void CleanUpSessionWithLock();
     bool WakeUpToWork(knl_session_context* session);
+    bool WakeUpToSteal();
     void WakeUpToUpdate(ThreadStatus status);
 
     friend class ThreadPoolListener;
@@ -107,9 +108,10 @@ public:
         return m_tid;
     }
 
-    inline void SetSession(knl_session_context* session)
+    inline void SetSession(knl_session_context* session, ThreadPoolGroup* group)
     {
         m_currentSession = session;
+        m_sessionGroup = group;
     }
 
     static Backend* CreateBackend();
@@ -140,6 +142,8 @@ private:
     ThreadStayReason m_reason;
     Dlelem m_elem;
     ThreadPoolGroup* m_group;
+    ThreadPoolGroup* m_sessionGroup; /* group whose listener owns m_currentSession */
+    bool m_wakeUpToSteal;            /* woken without a session, to look at the other groups */
     pthread_mutex_t* m_mutex;
     pthread_cond_t* m_cond;
 };
@@ -34,6 +34,13 @@
     (dataType == INT2OID || dataType == INT4OID || dataType == INT8OID || dataType == FLOAT4OID ||         \
         dataType == FLOAT8OID || dataType == VARCHAROID || dataType == BPCHAROID || dataType == TEXTOID || \
         dataType == CLOBOID)
+/*
+ * Runtime join filters handed from a hash join to a row or column store scan
+ * are probed with the scanned Datum as is, which is only cheap for by-value types.
+ */
+#define SATISFY_RUNTIME_FILTER(dataType)                                                                   \
+    (dataType == INT2OID || dataType == INT4OID || dataType == INT8OID || dataType == FLOAT4OID ||         \
+        dataType == FLOAT8OID)
 #define DEFAULT_ORC_BLOOM_FILTER_ENTRIES 10000
 #define MAX_HASH_FUNCTIONS 4
 #define LSB_IDENTIFY 6
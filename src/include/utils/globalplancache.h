@@ -32,6 +32,7 @@
 #define GPC_NUM_OF_BUCKETS (128)
 #define GLOBALPLANCACHEKEY_MAGIC (953717831)
 #define CAS_SLEEP_DURATION (2)
+#define GPC_NUM_OF_READER_SLOTS (64)
 
 #define ENABLE_GPC (g_instance.attr.attr_common.enable_global_plancache == true)
 #define ENABLE_CN_GPC (IS_PGXC_COORDINATOR && \
@@ -74,6 +75,23 @@ typedef struct GPCPreparedStatement
                                     * linked list instead of HTAB */
 } GPCPreparedStatement;
 
+/*
+ * Lock-free lookup index of a GPC bucket. Every published GPCEnv has one node
+ * in its bucket's singly linked list. Nodes are only linked and unlinked under
+ * the bucket's exclusive mapping lock, and are freed only after a grace period
+ * (see GlobalPlanCache::Synchronize), so PlanFetch can walk the list without
+ * taking any lock.
+ */
+typedef struct GPCReadNode
+{
+    struct GPCReadNode * volatile next;
+    uint32     hash_code;
+    uint32     query_length;
+    int        num_params;
+    struct GPCEnv *env;
+    char      *query_string;
+} GPCReadNode;
+
 typedef struct GPCBucketInfo
 {
     int64    bucket_size;
@@ -83,8 +101,19 @@ typedef struct GPCBucketInfo
     MemoryContext context;
     uint32     curr_hash_code;
     uint32    curr_cache_votes;
+    GPCReadNode * volatile read_list;
+    int64    fetch_hits;
+    int64    fetch_misses;
+    int64    contentions;
 } GPCBucketInfo;
 
+/* per-parity reader counter of the lock-free lookup, one cache line each */
+typedef struct GPCReaderSlot
+{
+    uint32    count;
+    char      padding[PG_CACHE_LINE_SIZE - sizeof(uint32)];
+} GPCReaderSlot;
+
 typedef struct GPCKey
 {
     uint32        query_length;
@@ -121,6 +150,7 @@ typedef struct GPCEnv
 {
     GPCEntry *globalplancacheentry;
     CachedPlanSource *plansource;
+    GPCReadNode *read_node;
     MemoryContext context;
     int64 memory_size;
     bool filled;
@@ -187,6 +217,15 @@ typedef struct GPCStatus
     int params_num;
 } GPCStatus;
 
+typedef struct GPCFetchStats
+{
+    uint32 bucket_id;
+    int entries_count;
+    int64 fetch_hits;
+    int64 fetch_misses;
+    int64 contentions;
+} GPCFetchStats;
+
 typedef struct GPCPrepareStatus
 {
     char *statement_name;
@@ -213,6 +252,11 @@ public:
     Datum PlanClean();
     uint32 GetBucket(uint32 hashvalue);
 
+    /* lock-free lookup index */
+    void ReadPublish(GPCEnv *env, uint32 hash_code, uint32 bucket_index);
+    void ReadUnpublish(GPCEnv *env, uint32 bucket_index);
+    bool Synchronize();
+
     /* global prepare stmt htab control */
     void PrepareInit();
     void PrepareStore(const char *stmt_name,
@@ -240,22 +284,34 @@ public:
     /* system function */
     void* GetStatus(uint32 *num);
     void* GetPrepareStatus(uint32 *num);
+    void* GetFetchStats(uint32 *num);
     void SendPrepareDestoryMsg();
 
 private:
+    uint32 ReadBegin();
+    void ReadEnd(uint32 epoch);
 
     HTAB* m_global_plan_cache;
     struct GPCBucketInfo *m_gpc_bucket_info_array;
     DList *m_gpc_invalid_plansource;
 
+    /* unlinked from the lookup lists, freed by InvalidPlanDrop after a grace period */
+    DList *m_gpc_retired_nodes;
+    DList *m_gpc_retired_envs;
+
     HTAB* m_global_prepared;
 
     HTAB* m_cn_timeline;
+
+    /* reader counters of the lock-free lookup, indexed by epoch parity and slot */
+    volatile uint32 m_read_epoch;
+    GPCReaderSlot *m_read_slots[2];
 };
 
 extern GlobalPlanCache *GPC;
 extern uint64 generate_global_sessid(uint64 local_id);
 
 extern Datum GPCPlanClean(PG_FUNCTION_ARGS);
+extern Datum GPCFetchStatus(PG_FUNCTION_ARGS);
 
 #endif   /* PLANCACHE_H */
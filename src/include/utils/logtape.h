@@ -16,21 +16,37 @@
 #ifndef LOGTAPE_H
 #define LOGTAPE_H
 
+#include "storage/sharedfileset.h"
+
 /* LogicalTapeSet is an opaque type whose details are not known outside logtape.c. */
 
 typedef struct LogicalTapeSet LogicalTapeSet;
 
+/*
+ * The approach tuplesort.c takes to parallel external sorts is that workers,
+ * whose state is almost the same as independent serial sorts, are made to
+ * produce a final materialized tape of sorted output in all cases.  This is
+ * frozen, and its size is recorded here for the leader, which imports the
+ * tape into a LogicalTapeSet of its own to merge it with the other workers'
+ * tapes.
+ */
+typedef struct TapeShare {
+    long numFullBlocks; /* number of complete blocks in the tape */
+    int lastBlockBytes; /* valid bytes in its last block */
+} TapeShare;
+
 /*
  * prototypes for functions in logtape.c
  */
 
-extern LogicalTapeSet* LogicalTapeSetCreate(int ntapes);
+extern LogicalTapeSet* LogicalTapeSetCreate(
+    int ntapes, TapeShare* shared = NULL, SharedFileSet* fileset = NULL, int worker = -1);
 extern void LogicalTapeSetClose(LogicalTapeSet* lts);
 extern void LogicalTapeSetForgetFreeSpace(LogicalTapeSet* lts);
 extern size_t LogicalTapeRead(LogicalTapeSet* lts, int tapenum, void* ptr, size_t size);
 extern void LogicalTapeWrite(LogicalTapeSet* lts, int tapenum, void* ptr, size_t size);
 extern void LogicalTapeRewind(LogicalTapeSet* lts, int tapenum, bool forWrite);
-extern void LogicalTapeFreeze(LogicalTapeSet* lts, int tapenum);
+extern void LogicalTapeFreeze(LogicalTapeSet* lts, int tapenum, TapeShare* share = NULL);
 extern bool LogicalTapeBackspace(LogicalTapeSet* lts, int tapenum, size_t size);
 extern bool LogicalTapeSeek(LogicalTapeSet* lts, int tapenum, long blocknum, int offset);
 extern void LogicalTapeTell(LogicalTapeSet* lts, int tapenum, long* blocknum, int* offset);
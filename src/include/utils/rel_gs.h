@@ -165,6 +165,7 @@ typedef struct RelationMetaData {
 #define COMPRESSION_ZLIB "zlib"
 #define COMPRESSION_SNAPPY "snappy"
 #define COMPRESSION_LZ4 "lz4"
+#define COMPRESSION_ZSTD "zstd"
 
 #define FILESYSTEM_GENERAL "general"
 #define FILESYSTEM_HDFS "hdfs"
@@ -31,6 +31,34 @@
  */
 typedef struct Tuplesortstate Tuplesortstate;
 
+/*
+ * SharedSort is an opaque type for the state of a parallel sort, which lives
+ * in the memory shared by the participants (see tuplesort.c).
+ */
+typedef struct SharedSort SharedSort;
+
+/*
+ * Tuplesort parallel coordination state, allocated by each participant in
+ * local memory.  Participant caller initializes everything.  See usage notes
+ * below.
+ */
+typedef struct SortCoordinateData {
+    /* Worker process?  If not, must be leader. */
+    bool isWorker;
+
+    /*
+     * Leader-process-passed number of participants known launched (workers
+     * set this to -1).  Includes state within leader needed for it to
+     * participate as a worker, if any.
+     */
+    int nParticipants;
+
+    /* Private opaque state (points to shared memory) */
+    SharedSort* sharedsort;
+} SortCoordinateData;
+
+typedef struct SortCoordinateData* SortCoordinate;
+
 /*
  * We provide multiple interfaces to what is essentially the same code,
  * since different callers have different data to be sorted and want to
@@ -56,6 +84,19 @@ typedef struct Tuplesortstate Tuplesortstate;
  *
  * The "index_hash" API is similar to index_btree, but the tuples are
  * actually sorted by their hash codes not the raw data.
+ *
+ * Parallel sort callers are required to coordinate multiple tuplesort states
+ * in a leader thread and one or more worker threads; only the index_btree
+ * API supports this at present.  The leader sizes and initializes the shared
+ * state with tuplesort_estimate_shared() and tuplesort_initialize_shared()
+ * before launching workers.  Each worker then begins a tuplesort with a
+ * SortCoordinate whose isWorker is true, feeds it the tuples it scanned,
+ * calls tuplesort_performsort() to export its sorted output, and ends the
+ * sort.  Once all workers have finished, the leader begins a tuplesort of
+ * its own, passing the number of workers that produced output, and calls
+ * tuplesort_performsort() without adding any tuples; the workers' sorted
+ * runs are then merged on-the-fly as the leader fetches tuples.  Random
+ * access to the result of a parallel sort is not supported.
  */
 
 extern Tuplesortstate* tuplesort_begin_heap(TupleDesc tupDesc, int nkeys, AttrNumber* attNums, Oid* sortOperators,
@@ -64,7 +105,7 @@ extern Tuplesortstate* tuplesort_begin_heap(TupleDesc tupDesc, int nkeys, AttrNu
 extern Tuplesortstate* tuplesort_begin_cluster(
     TupleDesc tupDesc, Relation indexRel, int workMem, bool randomAccess, int maxMem);
 extern Tuplesortstate* tuplesort_begin_index_btree(
-    Relation indexRel, bool enforceUnique, int workMem, bool randomAccess, int maxMem);
+    Relation indexRel, bool enforceUnique, int workMem, bool randomAccess, int maxMem, SortCoordinate coordinate = NULL);
 extern Tuplesortstate* tuplesort_begin_index_hash(
     Relation indexRel, uint32 hash_mask, int workMem, bool randomAccess, int maxMem);
 extern Tuplesortstate* tuplesort_begin_datum(
@@ -93,6 +134,9 @@ extern bool tuplesort_getdatum(Tuplesortstate* state, bool forward, Datum* val,
 
 extern void tuplesort_end(Tuplesortstate* state);
 
+extern Size tuplesort_estimate_shared(int nWorkers);
+extern void tuplesort_initialize_shared(SharedSort* shared, int nWorkers, void* seg);
+
 extern void tuplesort_get_stats(Tuplesortstate* state, int* sortMethodId, int* spaceTypeId, long* spaceUsed);
 
 extern int tuplesort_merge_order(double allowedMem);
@@ -0,0 +1,122 @@
+#!/bin/sh
+#stress the group xlog insert: many clients write records crossing xlog page and segment
+#boundaries while checkpoints force full-page writes, then check that both the standby and
+#the crash recovery of the primary replay all of them.
+#the group insert is only used on aarch64, elsewhere this is a plain xlog insert stress.
+
+source ./standby_env.sh
+
+client_num=32
+rows_per_client=500
+test_rows=`expr $client_num \* $rows_per_client`
+summary_sql="select count(1), sum(val), sum(length(payload)) from xlog_group_test;"
+
+function run_client()
+{
+#one transaction per statement, so that the clients keep joining each other's insert groups.
+#the payload is not compressed nor toasted, so records up to 6K cross the xlog pages.
+for((j=1;j<=$rows_per_client;j++)); do
+	echo "insert into xlog_group_test values($1, $j, 0, repeat('x', ($j % 5) * 1500 + 32));"
+	echo "update xlog_group_test set val = val + 1 where client = $1 and id = $j - 1;"
+done | gsql -d $db -p $dn1_primary_port > ./results/data_replication_single/datareplica_group_insert_$1.result 2>&1
+}
+
+function run_checkpoints()
+{
+#move the redo pointer under the running groups, so that their members redo full-page writes,
+#and switch xlog segments
+while [ -f ./results/data_replication_single/datareplica_group_insert.running ]
+do
+	gsql -d $db -p $dn1_primary_port -c "checkpoint;" > /dev/null 2>&1
+	gsql -d $db -p $dn1_primary_port -c "select pg_switch_xlog();" > /dev/null 2>&1
+	sleep 1
+done
+}
+
+function check_standby()
+{
+for((i=0;i<60;i++)); do
+	if [ "$(gsql -d $db -p $dn1_standby_port -m -t -A -c "$summary_sql")" == "$1" ]; then
+		echo "check data consistency success on dn1_standby"
+		return
+	fi
+	sleep 1
+done
+echo "check data consistency $failed_keyword on dn1_standby"
+gsql -d $db -p $dn1_standby_port -m -c "$summary_sql"
+exit 1
+}
+
+function test_1()
+{
+check_instance
+
+gs_guc reload -D $data_dir/datanode1 -c "wal_keep_segments=128"
+
+gsql -d $db -p $dn1_primary_port -c "DROP TABLE if exists xlog_group_test;
+							CREATE TABLE xlog_group_test(client INT, id INT, val INT, payload TEXT);
+							ALTER TABLE xlog_group_test ALTER COLUMN payload SET STORAGE PLAIN;"
+
+touch ./results/data_replication_single/datareplica_group_insert.running
+run_checkpoints &
+checkpoint_pid=$!
+for((i=1;i<=$client_num;i++)); do
+	run_client $i &
+	client_pids[$i]=$!
+done
+for((i=1;i<=$client_num;i++)); do
+	wait ${client_pids[$i]}
+done
+rm -f ./results/data_replication_single/datareplica_group_insert.running
+wait $checkpoint_pid
+
+if [ $(grep -l "ERROR" ./results/data_replication_single/datareplica_group_insert_*.result | wc -l) -ne 0 ]; then
+	echo "insert $failed_keyword on dn1_primary"
+	exit 1
+fi
+
+if [ "$(gsql -d $db -p $dn1_primary_port -t -A -c "select count(1) from xlog_group_test;")" == "$test_rows" ]; then
+	echo "insert success on dn1_primary"
+else
+	echo "insert $failed_keyword on dn1_primary"
+	exit 1
+fi
+
+#the first change of every page after the last checkpoint is a full-page write, left to crash recovery
+gsql -d $db -p $dn1_primary_port -c "checkpoint;"
+for((i=1;i<=$client_num;i++)); do
+	gsql -d $db -p $dn1_primary_port -c "update xlog_group_test set val = val + 1 where client = $i;" > /dev/null 2>&1 &
+	client_pids[$i]=$!
+done
+for((i=1;i<=$client_num;i++)); do
+	wait ${client_pids[$i]}
+done
+
+summary=$(gsql -d $db -p $dn1_primary_port -t -A -c "$summary_sql")
+echo "summary on dn1_primary: $summary"
+check_standby "$summary"
+
+kill_primary
+start_primary_as_pending
+notify_primary_as_primary
+sleep 3
+
+if [ "$(gsql -d $db -p $dn1_primary_port -t -A -c "$summary_sql")" == "$summary" ]; then
+	echo "check data consistency success on dn1_primary after recovery"
+else
+	echo "check data consistency $failed_keyword on dn1_primary after recovery"
+	gsql -d $db -p $dn1_primary_port -c "$summary_sql"
+	exit 1
+fi
+}
+
+function tear_down()
+{
+sleep 1
+gs_guc reload -D $data_dir/datanode1 -c "wal_keep_segments=16"
+gsql -d $db -p $dn1_primary_port -c "DROP TABLE if exists xlog_group_test;"
+rm -f ./results/data_replication_single/datareplica_group_insert_*.result
+}
+
+test_1
+tear_down
@@ -0,0 +1,166 @@
+#!/bin/sh
+# replay conflicting MOT transactions with redo_recovery_workers > 1 and compare with serial replay
+
+source ./util.sh
+
+client_num=4
+txn_num=400
+acct_num=200
+branch_num=5
+uniq_num=100
+
+function set_redo_workers()
+{
+  # $1 data dir, $2 number of redo workers
+  sed -i '/^redo_recovery_workers/d' $1/mot.conf
+  echo "redo_recovery_workers = $2" >> $1/mot.conf
+}
+
+function wait_replay_done()
+{
+  # $1 standby port
+  primary_lsn=`gsql -d $db -p $dn1_primary_port -t -A -c "select pg_current_xlog_location();"`
+  for i in $(seq 1 300)
+  do
+    if [ $(gsql -d $db -p $1 -m -t -A -c "select pg_xlog_location_diff(lsn, '$primary_lsn') >= 0 from pg_last_xlog_replay_location();") = "t" ]; then
+      return
+    fi
+    sleep 1
+  done
+  echo "replay not done on $1 $failed_keyword"
+  exit 1
+}
+
+function table_digest()
+{
+  # $1 port
+  gsql -d $db -p $1 -m -t -A -c "select count(*), sum(bal), sum(id::int8 * bal) from redo_acct;
+    select count(*), sum(bal), sum(id::int8 * bal) from redo_branch;
+    select count(*), sum(delta), sum(id::int8 * delta) from redo_hist;
+    select count(*), sum(code), sum(id::int8 * code), sum(code::int8 * v) from redo_uniq;"
+}
+
+function check_same_digest()
+{
+  # $1 port of parallel replay, $2 port of serial replay, $3 step
+  parallel_digest=`table_digest $1`
+  serial_digest=`table_digest $2`
+  primary_digest=`table_digest $dn1_primary_port`
+  if [ "$parallel_digest" = "$serial_digest" ] && [ "$parallel_digest" = "$primary_digest" ]; then
+    echo "$3: parallel replay matches serial replay"
+  else
+    echo "$3: parallel replay differs from serial replay $failed_keyword"
+    echo "primary: $primary_digest"
+    echo "parallel: $parallel_digest"
+    echo "serial: $serial_digest"
+    exit 1
+  fi
+}
+
+function gen_workload()
+{
+  # $1 round, $2 client id, $3 output file
+  RANDOM=`expr $1 \* $client_num + $2`
+  rm -f $3
+  for((t=1; t<=$txn_num; t++))
+  do
+    hist_id=`expr $1 \* 1000000 + $2 \* 100000 + $t`
+    acct=`expr $RANDOM % $acct_num + 1`
+    other=`expr $RANDOM % $acct_num + 1`
+    branch=`expr $RANDOM % $branch_num + 1`
+    delta=`expr $RANDOM % 1000 - 500`
+    case `expr $t % 4` in
+      0)
+        # crosses tables and partitions, and conflicts on the few branch rows
+        echo "begin; update redo_acct set bal = bal - $delta where id = $acct; update redo_branch set bal = bal + $delta where id = $branch; insert into redo_hist values ($hist_id, $acct, $delta); commit;" >> $3
+        ;;
+      1)
+        # two accounts that likely fall to different workers
+        echo "begin; update redo_acct set bal = bal - $delta where id = $acct; update redo_acct set bal = bal + $delta where id = $other; commit;" >> $3
+        ;;
+      2)
+        # the unique code moves to a new primary key, so the rows only conflict on the secondary index
+        code=`expr $RANDOM % $uniq_num + 1`
+        echo "begin; insert into redo_hist select $hist_id, id, $delta from redo_uniq where code = $code; delete from redo_uniq where code = $code; insert into redo_uniq values ($hist_id, $code, $delta); commit;" >> $3
+        ;;
+      *)
+        echo "begin; delete from redo_hist where id = `expr $hist_id - 3`; update redo_branch set bal = bal - $delta where id = $branch; commit;" >> $3
+        ;;
+    esac
+  done
+}
+
+function run_workload()
+{
+  # $1 round, so that the rounds insert different keys
+  for((c=1; c<=$client_num; c++))
+  do
+    gen_workload $1 $c $scripts_dir/results/parallel_redo_mot_$c.sql
+  done
+  for((c=1; c<=$client_num; c++))
+  do
+    gsql -d $db -p $dn1_primary_port -f $scripts_dir/results/parallel_redo_mot_$c.sql > /dev/null 2>&1 &
+  done
+
+  # checkpoints on the standby pause its redo workers until the snapshot is taken
+  for i in $(seq 1 3)
+  do
+    sleep 2
+    gsql -d $db -p $dn1_standby_port -m -c "checkpoint;"
+  done
+  wait
+}
+
+function test_1()
+{
+  set_default
+  check_detailed_instance
+
+  kill_cluster
+  set_redo_workers $primary_data_dir 4
+  set_redo_workers $standby_data_dir 4
+  set_redo_workers $standby2_data_dir 1
+  start_cluster
+
+  gsql -d $db -p $dn1_primary_port -c "DROP FOREIGN TABLE if exists redo_acct; DROP FOREIGN TABLE if exists redo_branch;
+    DROP FOREIGN TABLE if exists redo_hist; DROP FOREIGN TABLE if exists redo_uniq;
+    CREATE FOREIGN TABLE redo_acct(id int primary key, bal int) SERVER mot_server;
+    CREATE FOREIGN TABLE redo_branch(id int primary key, bal int) SERVER mot_server;
+    CREATE FOREIGN TABLE redo_hist(id int primary key, acct int, delta int) SERVER mot_server;
+    CREATE FOREIGN TABLE redo_uniq(id int primary key, code int not null, v int) SERVER mot_server;
+    CREATE UNIQUE INDEX redo_uniq_code on redo_uniq(code);
+    INSERT INTO redo_acct SELECT n, 0 FROM generate_series(1, $acct_num) n;
+    INSERT INTO redo_branch SELECT n, 0 FROM generate_series(1, $branch_num) n;
+    INSERT INTO redo_uniq SELECT n, n, 0 FROM generate_series(1, $uniq_num) n;"
+
+  # streaming replay on the standbys
+  run_workload 1
+  wait_replay_done $dn1_standby_port
+  wait_replay_done $standby2_port
+  check_same_digest $dn1_standby_port $standby2_port "streaming replay"
+
+  # crash recovery from the last checkpoint of the primary and of the standby
+  gsql -d $db -p $dn1_primary_port -c "checkpoint;"
+  run_workload 2
+  wait_replay_done $dn1_standby_port
+  wait_replay_done $standby2_port
+  kill_primary
+  kill_standby
+  start_primary
+  start_standby
+  wait_replay_done $dn1_standby_port
+  wait_replay_done $standby2_port
+  check_same_digest $dn1_standby_port $standby2_port "crash recovery"
+}
+
+function tear_down()
+{
+  kill_cluster
+  sed -i '/^redo_recovery_workers/d' $primary_data_dir/mot.conf $standby_data_dir/mot.conf $standby2_data_dir/mot.conf
+  start_cluster
+  gsql -d $db -p $dn1_primary_port -c "DROP FOREIGN TABLE if exists redo_acct; DROP FOREIGN TABLE if exists redo_branch;
+    DROP FOREIGN TABLE if exists redo_hist; DROP FOREIGN TABLE if exists redo_uniq;"
+}
+
+test_1
+tear_down
@@ -0,0 +1,209 @@
+/* -------------------------------------------------------------------------
+ *
+ * bitpack_bench.cpp
+ *		Microbenchmark of the bit unpacking kernels of BitpackCoder.
+ *
+ * Portions Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ *	src/test/microbench/bitpack_bench.cpp
+ *
+ *	A CU worth of values is bit packed at several widths, then unpacked into
+ *	int16, int32 and int64 arrays by the SIMD kernel this CPU supports and by
+ *	the scalar loop BitpackCoder uses for what the kernel leaves.  The program
+ *	fails if their output differs, and otherwise prints the time per value of
+ *	both.
+ *
+ *	usage: bitpack_bench [rounds]
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+#include "storage/compress_kits.h"
+#include "port/pg_cpu_features.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_DEFAULT_ROUNDS 2000
+#define BENCH_VALUES 60000 /* rows of a full CU */
+
+typedef int (*BitUnpackFunc)(
+    const char* inbuf, int insize, short bits, int64 mindata, char* outbuf, short outValSize, int nValues);
+
+#ifdef USE_ASSERT_CHECKING
+void ExceptionalCondition(const char* conditionName, const char* errorType, const char* fileName, int lineNumber)
+{
+    fprintf(stderr, "TRAP: %s(\"%s\", File: \"%s\", Line: %d)\n", errorType, conditionName, fileName, lineNumber);
+    abort();
+}
+#endif
+
+static double elapsed_seconds(const struct timespec* start, const struct timespec* stop)
+{
+    return (double)(stop->tv_sec - start->tv_sec) + (double)(stop->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/* pack the differences from mindata LSB first, as BitpackCoder::Compress() does */
+static int bench_pack(const uint64* diffs, int nValues, short bits, unsigned char* outbuf)
+{
+    unsigned char* outptr = outbuf;
+    uint64 acc = 0;
+    int accBits = 0;
+
+    for (int i = 0; i < nValues; i++) {
+        acc |= diffs[i] << accBits;
+        accBits += bits;
+        while (accBits >= 8) {
+            *outptr++ = (unsigned char)acc;
+            acc >>= 8;
+            accBits -= 8;
+        }
+    }
+    if (accBits > 0) {
+        *outptr++ = (unsigned char)acc;
+    }
+    return (int)(outptr - outbuf);
+}
+
+/* the scalar unpacking of BitpackCoder::Decompress(), reading the stream byte by byte near its end */
+static void bench_unpack_scalar(
+    const char* inbuf, int insize, short bits, int64 mindata, char* outbuf, short outValSize, int first, int nValues)
+{
+    const uint64 mask = (((uint64)1) << bits) - 1;
+    uint64 bitpos = (uint64)first * bits;
+
+    for (int i = first; i < nValues; i++, bitpos += bits) {
+        uint64 offset = bitpos >> 3;
+        uint64 word = 0;
+        int64 val;
+
+        if (offset + sizeof(uint64) <= (uint64)insize) {
+            memcpy(&word, inbuf + offset, sizeof(uint64));
+        } else {
+            for (int b = 0; offset + b < (uint64)insize; b++) {
+                word |= ((uint64)(unsigned char)inbuf[offset + b]) << (8 * b);
+            }
+        }
+        val = (int64)(((word >> (bitpos & 7)) & mask) + (uint64)mindata);
+        switch (outValSize) {
+            case sizeof(int16):
+                ((int16*)outbuf)[i] = (int16)val;
+                break;
+            case sizeof(int32):
+                ((int32*)outbuf)[i] = (int32)val;
+                break;
+            default:
+                ((int64*)outbuf)[i] = val;
+                break;
+        }
+    }
+}
+
+static BitUnpackFunc bench_choose_kernel(const char** name)
+{
+#if defined(__x86_64__)
+#ifdef USE_X86_CPU_FEATURES
+    if (pg_cpu_has_avx2()) {
+        *name = "avx2";
+        return BitUnpackAVX2;
+    }
+#endif
+#elif defined(__aarch64__)
+    *name = "neon";
+    return BitUnpackNEON;
+#endif
+    *name = NULL;
+    return NULL;
+}
+
+int main(int argc, char* argv[])
+{
+    const short widths[] = {1, 3, 7, 8, 12, 16, 21, 24, 31, 32, 40, 48, 56};
+    const short outSizes[] = {sizeof(int16), sizeof(int32), sizeof(int64)};
+    const int64 mindata = 1000;
+    long rounds = (argc > 1) ? atol(argv[1]) : BENCH_DEFAULT_ROUNDS;
+    const char* kernelName = NULL;
+    BitUnpackFunc kernel = bench_choose_kernel(&kernelName);
+    uint64* diffs = (uint64*)malloc(sizeof(uint64) * BENCH_VALUES);
+    unsigned char* packed = (unsigned char*)malloc(sizeof(uint64) * BENCH_VALUES + sizeof(uint64));
+    char* expected = (char*)malloc(sizeof(int64) * BENCH_VALUES);
+    char* unpacked = (char*)malloc(sizeof(int64) * BENCH_VALUES);
+    unsigned int seed = 1;
+
+    if (rounds <= 0) {
+        fprintf(stderr, "usage: %s [rounds]\n", argv[0]);
+        return 1;
+    }
+    if (diffs == NULL || packed == NULL || expected == NULL || unpacked == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    printf("kernel: %s\n", kernelName != NULL ? kernelName : "none");
+    printf("%6s %8s %14s %14s %10s\n", "bits", "outsize", "scalar ns/val", "kernel ns/val", "kernel %");
+    for (size_t w = 0; w < lengthof(widths); w++) {
+        short bits = widths[w];
+        uint64 mask = (((uint64)1) << bits) - 1;
+        int insize;
+
+        for (int i = 0; i < BENCH_VALUES; i++) {
+            diffs[i] = (((uint64)rand_r(&seed) << 32) ^ (uint64)rand_r(&seed)) & mask;
+        }
+        insize = bench_pack(diffs, BENCH_VALUES, bits, packed);
+
+        for (size_t o = 0; o < lengthof(outSizes); o++) {
+            short outValSize = outSizes[o];
+            struct timespec start, stop;
+            double scalarSecs;
+            double kernelSecs = 0;
+            int first = 0;
+
+            /* int16 values hold at most 15 bits above mindata */
+            if (bits + 1 >= outValSize * 8) {
+                continue;
+            }
+
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            for (long r = 0; r < rounds; r++) {
+                bench_unpack_scalar((const char*)packed, insize, bits, mindata, expected, outValSize, 0, BENCH_VALUES);
+            }
+            clock_gettime(CLOCK_MONOTONIC, &stop);
+            scalarSecs = elapsed_seconds(&start, &stop);
+
+            if (kernel != NULL) {
+                memset(unpacked, 0, sizeof(int64) * BENCH_VALUES);
+                first = kernel((const char*)packed, insize, bits, mindata, unpacked, outValSize, BENCH_VALUES);
+                bench_unpack_scalar((const char*)packed, insize, bits, mindata, unpacked, outValSize, first, BENCH_VALUES);
+                if (memcmp(unpacked, expected, (size_t)outValSize * BENCH_VALUES) != 0) {
+                    fprintf(stderr, "%s: wrong values unpacked, bits %d, outsize %d\n", kernelName, bits, outValSize);
+                    return 1;
+                }
+
+                clock_gettime(CLOCK_MONOTONIC, &start);
+                for (long r = 0; r < rounds; r++) {
+                    first = kernel((const char*)packed, insize, bits, mindata, unpacked, outValSize, BENCH_VALUES);
+                    bench_unpack_scalar(
+                        (const char*)packed, insize, bits, mindata, unpacked, outValSize, first, BENCH_VALUES);
+                }
+                clock_gettime(CLOCK_MONOTONIC, &stop);
+                kernelSecs = elapsed_seconds(&start, &stop);
+            }
+
+            printf("%6d %8d %14.3f %14.3f %10.1f\n",
+                bits,
+                outValSize,
+                scalarSecs * 1e9 / ((double)rounds * BENCH_VALUES),
+                kernelSecs * 1e9 / ((double)rounds * BENCH_VALUES),
+                100.0 * first / BENCH_VALUES);
+        }
+    }
+
+    free(diffs);
+    free(packed);
+    free(expected);
+    free(unpacked);
+    return 0;
+}
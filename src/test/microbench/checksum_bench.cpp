@@ -0,0 +1,114 @@
+/* -------------------------------------------------------------------------
+ *
+ * checksum_bench.cpp
+ *		Microbenchmark of the page checksum kernels.
+ *
+ * Portions Copyright (c) 2020 Huawei Technologies Co.,Ltd.
+ *
+ *	src/test/microbench/checksum_bench.cpp
+ *
+ *	Every kernel this CPU supports checksums the same pages as the generic
+ *	code.  The program fails if any of them disagrees, and otherwise prints
+ *	the time per page and the throughput of each one.
+ *
+ *	usage: checksum_bench [pages]
+ *
+ * -------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+#include "storage/checksum_impl.h"
+#include "port/pg_cpu_features.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_DEFAULT_PAGES 1000000
+#define BENCH_DISTINCT_PAGES 64 /* cycle through these, so that they stay in cache */
+
+typedef struct ChecksumKernel {
+    const char* name;
+    uint32 (*func)(char* data, uint32 size);
+    bool available;
+} ChecksumKernel;
+
+#ifdef USE_ASSERT_CHECKING
+void ExceptionalCondition(const char* conditionName, const char* errorType, const char* fileName, int lineNumber)
+{
+    fprintf(stderr, "TRAP: %s(\"%s\", File: \"%s\", Line: %d)\n", errorType, conditionName, fileName, lineNumber);
+    abort();
+}
+#endif
+
+static double elapsed_seconds(const struct timespec* start, const struct timespec* stop)
+{
+    return (double)(stop->tv_sec - start->tv_sec) + (double)(stop->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+int main(int argc, char* argv[])
+{
+    long pages = (argc > 1) ? atol(argv[1]) : BENCH_DEFAULT_PAGES;
+    ChecksumKernel kernels[] = {
+        {"generic", pg_checksum_block_generic, true},
+#if defined(__x86_64__)
+#ifdef USE_X86_CPU_FEATURES
+        {"avx2", pg_checksum_block_avx2, pg_cpu_has_avx2()},
+        {"avx512", pg_checksum_block_avx512, pg_cpu_has_avx512f()},
+#endif
+#elif defined(__aarch64__)
+        {"neon", pg_checksum_block_neon, true},
+#endif
+    };
+    uint32 expected[BENCH_DISTINCT_PAGES];
+    char* buf = NULL;
+    unsigned int seed = 1;
+
+    if (pages <= 0) {
+        fprintf(stderr, "usage: %s [pages]\n", argv[0]);
+        return 1;
+    }
+
+    /* the kernels need 4-byte aligned pages, keep them on cache lines as in shared buffers */
+    if (posix_memalign((void**)&buf, PG_CACHE_LINE_SIZE, (size_t)BLCKSZ * BENCH_DISTINCT_PAGES) != 0) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (size_t i = 0; i < (size_t)BLCKSZ * BENCH_DISTINCT_PAGES; i++) {
+        buf[i] = (char)rand_r(&seed);
+    }
+    for (int p = 0; p < BENCH_DISTINCT_PAGES; p++) {
+        expected[p] = pg_checksum_block_generic(buf + (size_t)p * BLCKSZ, BLCKSZ);
+    }
+
+    printf("%-10s %12s %12s\n", "kernel", "ns/page", "GB/s");
+    for (size_t k = 0; k < lengthof(kernels); k++) {
+        struct timespec start, stop;
+        volatile uint32 sink = 0;
+        double secs;
+
+        if (!kernels[k].available) {
+            printf("%-10s %12s %12s\n", kernels[k].name, "-", "-");
+            continue;
+        }
+        for (int p = 0; p < BENCH_DISTINCT_PAGES; p++) {
+            uint32 got = kernels[k].func(buf + (size_t)p * BLCKSZ, BLCKSZ);
+            if (got != expected[p]) {
+                fprintf(stderr, "%s: page %d checksum %08x, expected %08x\n", kernels[k].name, p, got, expected[p]);
+                return 1;
+            }
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (long i = 0; i < pages; i++) {
+            sink ^= kernels[k].func(buf + (size_t)(i % BENCH_DISTINCT_PAGES) * BLCKSZ, BLCKSZ);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &stop);
+
+        secs = elapsed_seconds(&start, &stop);
+        printf("%-10s %12.1f %12.2f\n", kernels[k].name, secs * 1e9 / pages, (double)pages * BLCKSZ / secs / 1e9);
+    }
+
+    free(buf);
+    return 0;
+}
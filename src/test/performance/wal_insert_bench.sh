@@ -0,0 +1,81 @@
+#!/bin/bash
+#
+# wal_insert_bench.sh
+#	Many-client WAL insertion microbenchmark.
+#
+# Every client commits small single-row inserts, so that nearly all of the
+# time goes to WAL insertion and flushing.  Each server given on the command
+# line is run at every client count, and the script reports the tps together
+# with how often the sampled backends were waiting on WALInsertLock.
+#
+# WAL group insert is only built on aarch64.  To compare it with the plain
+# insert path, run one server built with it and one built without it on the
+# same host and configuration, e.g.
+#
+#	wal_insert_bench.sh -c "64 128 256" group:5432 single:5433
+#
+# src/test/performance/wal_insert_bench.sh
+#
+
+dbname=postgres
+duration=60
+clients="16 64 128 256"
+runs=3
+samples_per_run=20
+
+usage()
+{
+	echo "usage: $0 [-d dbname] [-T seconds] [-c \"clients ...\"] [-r runs] label:port [label:port ...]"
+	exit 1
+}
+
+while getopts "d:T:c:r:" opt; do
+	case $opt in
+		d) dbname=$OPTARG ;;
+		T) duration=$OPTARG ;;
+		c) clients=$OPTARG ;;
+		r) runs=$OPTARG ;;
+		*) usage ;;
+	esac
+done
+shift $((OPTIND - 1))
+[ $# -ge 1 ] || usage
+
+script=$(mktemp /tmp/wal_insert_bench.XXXXXX)
+trap "rm -f $script $script.*" EXIT
+cat > $script <<EOF
+\setrandom aid 1 1000000
+insert into wal_insert_bench values (:aid, repeat('x', 200));
+EOF
+
+# sample the wait events of all backends while pgbench runs, one line per waiter
+sample_waits()
+{
+	local port=$1
+	local interval=$(( duration / samples_per_run ))
+	[ $interval -ge 1 ] || interval=1
+	for ((s = 0; s < samples_per_run; s++)); do
+		sleep $interval
+		gsql -d $dbname -p $port -t -A -c "select wait_event from pg_thread_wait_status where wait_status like 'acquire lwlock%';" 2>/dev/null
+	done
+}
+
+printf "%-10s %8s %4s %12s %14s\n" "server" "clients" "run" "tps" "walinsertlock"
+for server in "$@"; do
+	label=${server%%:*}
+	port=${server##*:}
+	gsql -d $dbname -p $port -q -c "drop table if exists wal_insert_bench; create table wal_insert_bench(aid int, filler text);" > /dev/null || exit 1
+	for c in $clients; do
+		for ((r = 1; r <= runs; r++)); do
+			gsql -d $dbname -p $port -q -c "truncate wal_insert_bench; checkpoint;" > /dev/null
+			sample_waits $port > $script.waits &
+			sampler=$!
+			tps=$(pgbench -n -M prepared -f $script -c $c -j $c -T $duration -p $port $dbname 2>/dev/null |
+				awk '/excluding connections/ { print $3 }')
+			wait $sampler
+			waits=$(grep -c "^WALInsertLock$" $script.waits)
+			printf "%-10s %8s %4s %12s %14s\n" "$label" "$c" "$r" "${tps:-failed}" "$waits"
+		done
+	done
+	gsql -d $dbname -p $port -q -c "drop table if exists wal_insert_bench;" > /dev/null
+done
@@ -0,0 +1,45 @@
+--
+--multi-row insert and IN-list index lookup support
+--
+set enable_opfusion=on;
+set enable_bitmapscan=off;
+set enable_seqscan=off;
+set enable_indexonlyscan=off;
+set opfusion_debug_mode = 'log';
+set max_parallel_workers_per_gather=0;
+-- create table
+drop table if exists test_bypass_mr1;
+create table test_bypass_mr1(col1 int, col2 int default 7, col3 text);
+create unique index itest_bypass_mr1 on test_bypass_mr1(col1);
+-- bypass multi-row insert
+explain (costs off) insert into test_bypass_mr1 values (1,1,'a'),(2,2,'b'),(3,3,'c');
+insert into test_bypass_mr1 values (1,1,'a'),(2,2,'b'),(3,3,'c');
+explain (costs off) insert into test_bypass_mr1(col1,col3) values (4,'d'),(5,null);
+insert into test_bypass_mr1(col1,col3) values (4,'d'),(5,null);
+insert into test_bypass_mr1 values (6,6,'f'),(7,null,'g'),(null,8,'h');
+-- unique violation in the middle of the rows rolls back the whole statement
+insert into test_bypass_mr1 values (9,9,'i'),(1,1,'j');
+select * from test_bypass_mr1 order by col1;
+-- bypass IN-list lookup
+explain (costs off) select * from test_bypass_mr1 where col1 in (2,4,9);
+select * from test_bypass_mr1 where col1 in (2,4,9) order by col1;
+explain (costs off) select * from test_bypass_mr1 where col1 = any(array[1,null,7]);
+select * from test_bypass_mr1 where col1 = any(array[1,null,7]) order by col1;
+-- update and delete through IN-list
+explain (costs off) update test_bypass_mr1 set col3 = 'x' where col1 in (1,3);
+update test_bypass_mr1 set col3 = 'x' where col1 in (1,3);
+explain (costs off) delete from test_bypass_mr1 where col1 in (2,5);
+delete from test_bypass_mr1 where col1 in (2,5);
+select * from test_bypass_mr1 order by col1;
+-- no bypass
+create table test_bypass_mr2(col1 int, col2 varchar(10));
+explain (costs off) insert into test_bypass_mr2 values (1,'a'),(2,'b');
+-- end
+reset enable_opfusion;
+reset enable_bitmapscan;
+reset enable_seqscan;
+reset enable_indexonlyscan;
+reset opfusion_debug_mode;
+reset max_parallel_workers_per_gather;
+drop table test_bypass_mr1;
+drop table test_bypass_mr2;
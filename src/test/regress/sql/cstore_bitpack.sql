@@ -0,0 +1,21 @@
+-- Integer CUs whose values take fewer bits than whole bytes are bit packed.
+create table cstore_bitpack_low (a int, b bigint, c smallint, d int) with (orientation = column, compression = low);
+create table cstore_bitpack_middle (a int, b bigint, c smallint, d int) with (orientation = column, compression = middle);
+create table cstore_bitpack_high (a int, b bigint, c smallint, d int) with (orientation = column, compression = high);
+create table cstore_bitpack_src (a int, b bigint, c smallint, d int);
+insert into cstore_bitpack_src
+    select n, n * 1000003 % 1099511627776 - 549755813888, (n % 2000) - 1000,
+           case when n % 10 = 0 then null else n % 777 end
+    from generate_series(1, 7000) n;
+insert into cstore_bitpack_low select * from cstore_bitpack_src;
+insert into cstore_bitpack_middle select * from cstore_bitpack_src;
+insert into cstore_bitpack_high select * from cstore_bitpack_src;
+select sum(a), min(b), max(b), sum(b), sum(c), min(c), max(c), count(d), sum(d) from cstore_bitpack_low;
+select count(*) from (select * from cstore_bitpack_low except all select * from cstore_bitpack_src) t;
+select count(*) from (select * from cstore_bitpack_middle except all select * from cstore_bitpack_src) t;
+select count(*) from (select * from cstore_bitpack_high except all select * from cstore_bitpack_src) t;
+select a, b, c, d from cstore_bitpack_low where a in (1, 10, 4321, 7000) order by a;
+drop table cstore_bitpack_low;
+drop table cstore_bitpack_middle;
+drop table cstore_bitpack_high;
+drop table cstore_bitpack_src;
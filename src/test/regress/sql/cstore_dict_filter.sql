@@ -0,0 +1,18 @@
+-- Quals evaluated on the dictionary items of dictionary encoded CUs.
+create table cstore_dict_filter (id int, city text, tag varchar(10)) with (orientation = column);
+insert into cstore_dict_filter
+    select n, case when n % 50 = 0 then null else 'city_' || (n % 7) end, 'tag_' || (n % 3)
+    from generate_series(1, 6000) n;
+analyze cstore_dict_filter;
+select count(*) from cstore_dict_filter where city = 'city_3';
+select count(*) from cstore_dict_filter where 'city_3' = city;
+select count(*) from cstore_dict_filter where city in ('city_1', 'city_5', null);
+select count(*) from cstore_dict_filter where city >= 'city_5';
+select count(*) from cstore_dict_filter where city < 'city_2' and tag = 'tag_0';
+select count(*) from cstore_dict_filter where city = 'city_9';
+select count(*) from cstore_dict_filter where city is null;
+select id, city, tag from cstore_dict_filter where city = 'city_4' and id < 40 order by id;
+delete from cstore_dict_filter where id % 2 = 0;
+select count(*) from cstore_dict_filter where city = 'city_3';
+select count(*) from cstore_dict_filter where city in ('city_1', 'city_5');
+drop table cstore_dict_filter;
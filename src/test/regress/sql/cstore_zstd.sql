@@ -0,0 +1,41 @@
+-- Column store tables compressed with zstd.
+create table cstore_zstd (a int, b bigint, c text, d numeric) with (orientation = column, compression = zstd);
+create table cstore_zstd_level3 (a int, b bigint, c text, d numeric) with (orientation = column, compression = zstd, compresslevel = 3);
+create table cstore_zstd_src (a int, b bigint, c text, d numeric);
+insert into cstore_zstd_src select n, n * 1000003, 'item ' || (n % 300), n * 0.25 from generate_series(1, 7000) n;
+insert into cstore_zstd select * from cstore_zstd_src;
+insert into cstore_zstd_level3 select * from cstore_zstd_src;
+select count(*), sum(a), sum(b), sum(d), count(distinct c) from cstore_zstd;
+select count(*) from (select * from cstore_zstd except all select * from cstore_zstd_src) t;
+select count(*) from (select * from cstore_zstd_level3 except all select * from cstore_zstd_src) t;
+select a, b, c, d from cstore_zstd where a in (1, 300, 7000) order by a;
+-- String columns are compressed with a zstd dictionary trained once per column,
+-- which is kept in the CUDesc table under col_id (-100 - attnum).
+create function cstore_zstd_dict_count(rel regclass, attnum int) returns bigint as $$
+declare
+    n bigint;
+begin
+    execute 'select count(*) from ' || (select relcudescrelid::regclass::text from pg_class where oid = rel)
+        || ' where col_id = ' || (-100 - attnum) into n;
+    return n;
+end;
+$$ language plpgsql;
+create table cstore_zstd_dict (a int, c text, v varchar(64)) with (orientation = column, compression = zstd);
+insert into cstore_zstd_dict select n, 'customer#' || md5(n::text), 'v' || (n * 7919 % 100003) from generate_series(1, 5000) n;
+insert into cstore_zstd_dict select n, 'customer#' || md5(n::text), 'v' || (n * 7919 % 100003) from generate_series(5001, 10000) n;
+select cstore_zstd_dict_count('cstore_zstd_dict', 2) as c_dicts, cstore_zstd_dict_count('cstore_zstd_dict', 3) as v_dicts;
+select count(*), sum(a), count(distinct c), count(distinct v) from cstore_zstd_dict;
+select count(*) from cstore_zstd_dict where c <> 'customer#' || md5(a::text) or v <> 'v' || (a * 7919 % 100003);
+-- rewriting another column keeps the dictionaries
+alter table cstore_zstd_dict alter column a type bigint;
+select cstore_zstd_dict_count('cstore_zstd_dict', 2) as c_dicts, cstore_zstd_dict_count('cstore_zstd_dict', 3) as v_dicts;
+select count(*) from cstore_zstd_dict where c <> 'customer#' || md5(a::text) or v <> 'v' || (a * 7919 % 100003);
+-- dropping the column drops its dictionaries
+alter table cstore_zstd_dict drop column v;
+select cstore_zstd_dict_count('cstore_zstd_dict', 2) as c_dicts, cstore_zstd_dict_count('cstore_zstd_dict', 3) as v_dicts;
+select count(*) from cstore_zstd_dict where c <> 'customer#' || md5(a::text);
+drop table cstore_zstd_dict;
+drop function cstore_zstd_dict_count(regclass, int);
+drop table cstore_zstd;
+drop table cstore_zstd_level3;
+drop table cstore_zstd_src;
@@ -0,0 +1,19 @@
+--
+-- Tests of local_buffer_partition_stat(), the clock sweep partitions of the shared buffers
+--
+
+-- the partitions are numbered from 0 and cover the buffers in contiguous ranges
+select min(partition_id) = 0 as first_id, max(partition_id) = count(*) - 1 as last_id,
+       min(buf_id_start) = 0 as first_buffer
+    from local_buffer_partition_stat();
+select count(*) from (
+    select buf_id_start, lag(buf_id_start + buffers) over (order by partition_id) as prev_end
+    from local_buffer_partition_stat()) t
+    where buf_id_start <> prev_end;
+select sum(buffers) = (select setting::bigint from pg_settings where name = 'shared_buffers') as all_buffers
+    from local_buffer_partition_stat();
+
+-- no counter goes below zero, and only allocations can be stolen
+select count(*) from local_buffer_partition_stat()
+    where buffers <= 0 or complete_passes < 0 or candidate_allocs < 0 or sweep_allocs < 0
+        or stolen_allocs < 0 or stolen_allocs > candidate_allocs + sweep_allocs;
@@ -0,0 +1,33 @@
+-- primary key in a hash index
+create foreign table hash_test (x integer primary key, y integer) options (primary_index_method 'hash');
+
+insert into hash_test values (generate_series(1, 100), generate_series(1, 100));
+
+-- point lookup
+select * from hash_test where x = 42;
+select * from hash_test where x = 1000;
+
+-- insert, update, delete
+insert into hash_test values (101, 101);
+select * from hash_test where x = 101;
+update hash_test set y = -42 where x = 42;
+select * from hash_test where x = 42;
+delete from hash_test where x = 101;
+select * from hash_test where x = 101;
+delete from hash_test where x > 90;
+
+-- full scan
+select count(*), sum(x), sum(y) from hash_test;
+select * from hash_test order by x limit 5;
+
+-- range quals cannot use the hash index, they fall back to a full scan
+select * from hash_test where x > 85 order by x;
+select * from hash_test where x between 10 and 13 order by x;
+select count(*) from hash_test where x < 50;
+
+-- the scan does not see the rows inserted by the same statement
+insert into hash_test select x + 1000, y from hash_test;
+select count(*) from hash_test;
+select * from hash_test where x > 1085 order by x;
+
+drop foreign table hash_test;
@@ -0,0 +1,47 @@
+create foreign table mvcc_test (x integer primary key, y integer);
+
+insert into mvcc_test values (generate_series(1, 5), generate_series(1, 5) * 10);
+
+create or replace procedure mvcc_update(k int, v int)
+AS
+DECLARE
+  PRAGMA AUTONOMOUS_TRANSACTION;
+BEGIN
+  update mvcc_test set y = v where x = k;
+end;
+/
+
+create or replace procedure mvcc_delete(k int)
+AS
+DECLARE
+  PRAGMA AUTONOMOUS_TRANSACTION;
+BEGIN
+  delete from mvcc_test where x = k;
+end;
+/
+
+-- update-then-read: a read-only transaction keeps reading the version of its snapshot
+start transaction read only;
+select * from mvcc_test order by x;
+select mvcc_update(1, 11);
+select * from mvcc_test where x = 1;
+select * from mvcc_test order by x;
+commit;
+select * from mvcc_test order by x;
+
+-- delete-then-read: the deleted key is gone from the index, so the reader is aborted on commit
+start transaction read only;
+select * from mvcc_test order by x;
+select mvcc_delete(2);
+select * from mvcc_test order by x;
+commit;
+select * from mvcc_test order by x;
+
+-- a snapshot taken after the delete commits
+start transaction read only;
+select * from mvcc_test where x = 3;
+commit;
+
+drop procedure mvcc_update;
+drop procedure mvcc_delete;
+drop foreign table mvcc_test;
@@ -0,0 +1,30 @@
+create table parallel_agg_t1 (a int, b int, c numeric(10,2));
+insert into parallel_agg_t1 select n, n % 10, n / 100.0 from generate_series(1, 100000) n;
+analyze parallel_agg_t1;
+
+set parallel_setup_cost=0;
+set parallel_tuple_cost=0.000005;
+set max_parallel_workers_per_gather=2;
+set min_parallel_table_scan_size=0;
+set parallel_leader_participation=on;
+
+--partial aggregation in the workers, finalized above the Gather
+explain (costs off) select count(*), sum(a), round(avg(a), 2), min(c), max(c), sum(c), round(avg(c), 2) from parallel_agg_t1;
+select count(*), sum(a), round(avg(a), 2), min(c), max(c), sum(c), round(avg(c), 2) from parallel_agg_t1;
+
+--grouped partial aggregation
+explain (costs off) select b, count(*), sum(a), round(avg(c), 2) from parallel_agg_t1 group by b order by b;
+select b, count(*), sum(a), round(avg(c), 2) from parallel_agg_t1 group by b order by b;
+
+--having is evaluated by the Finalize Aggregate
+select b, count(*) from parallel_agg_t1 group by b having sum(a) > 500000000 order by b;
+
+--distinct aggregates cannot be split
+explain (costs off) select count(distinct b) from parallel_agg_t1;
+
+drop table parallel_agg_t1;
+reset parallel_setup_cost;
+reset parallel_tuple_cost;
+reset max_parallel_workers_per_gather;
+reset min_parallel_table_scan_size;
+reset parallel_leader_participation;
@@ -18,6 +18,19 @@ select * from parallel_hashjoin_test_a left outer join parallel_hashjoin_test_b
 explain (costs off)select * from parallel_hashjoin_test_a right outer join parallel_hashjoin_test_b on parallel_hashjoin_test_a.id = parallel_hashjoin_test_b.id order by parallel_hashjoin_test_a.id;
 select * from parallel_hashjoin_test_a right outer join parallel_hashjoin_test_b on parallel_hashjoin_test_a.id = parallel_hashjoin_test_b.id order by parallel_hashjoin_test_a.id;
 
+-- Parallel-aware hash join: the participants build one shared hash table.
+create table parallel_hashjoin_test_c (id int);
+insert into parallel_hashjoin_test_c select n from generate_series(1,1000) n;
+analyse parallel_hashjoin_test_c;
+set enable_parallel_hash = on;
+explain (costs off) select count(*) from parallel_hashjoin_test_a join parallel_hashjoin_test_c on parallel_hashjoin_test_a.id = parallel_hashjoin_test_c.id;
+select count(*) from parallel_hashjoin_test_a join parallel_hashjoin_test_c on parallel_hashjoin_test_a.id = parallel_hashjoin_test_c.id;
+set enable_parallel_hash = off;
+explain (costs off) select count(*) from parallel_hashjoin_test_a join parallel_hashjoin_test_c on parallel_hashjoin_test_a.id = parallel_hashjoin_test_c.id;
+select count(*) from parallel_hashjoin_test_a join parallel_hashjoin_test_c on parallel_hashjoin_test_a.id = parallel_hashjoin_test_c.id;
+reset enable_parallel_hash;
+drop table parallel_hashjoin_test_c;
+
 reset parallel_setup_cost;
 reset min_parallel_table_scan_size;
 reset parallel_tuple_cost;
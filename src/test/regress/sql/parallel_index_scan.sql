@@ -0,0 +1,55 @@
+create table parallel_index_t1 (a int, b int);
+insert into parallel_index_t1 select n, n % 100 from generate_series(1, 100000) n;
+create index parallel_index_t1_a_idx on parallel_index_t1(a);
+analyze parallel_index_t1;
+
+set enable_seqscan=off;
+set enable_bitmapscan=off;
+set parallel_setup_cost=0;
+set parallel_tuple_cost=0.000005;
+set max_parallel_workers_per_gather=2;
+set min_parallel_table_scan_size=0;
+set min_parallel_index_scan_size=0;
+set parallel_leader_participation=on;
+
+--parallel plan for index scan
+explain (costs off) select count(b) from parallel_index_t1 where a < 50000;
+select count(b) from parallel_index_t1 where a < 50000;
+select sum(b) from parallel_index_t1 where a > 90000;
+
+--parallel plan for index only scan
+explain (costs off) select count(*) from parallel_index_t1 where a < 50000;
+select count(*) from parallel_index_t1 where a < 50000;
+
+--no parallel index scan below the size threshold
+set min_parallel_index_scan_size='1GB';
+explain (costs off) select count(b) from parallel_index_t1 where a < 50000;
+
+--parallel bitmap heap scan; only the heap pages count towards the workers
+set enable_indexscan=off;
+set enable_bitmapscan=on;
+explain (costs off) select count(b) from parallel_index_t1 where a < 10000 or a > 90000;
+select count(b) from parallel_index_t1 where a < 10000 or a > 90000;
+select sum(b) from parallel_index_t1 where a < 10000 or a > 90000;
+reset enable_indexscan;
+
+--parallel btree build; workers sort their part of the heap, the leader merges
+set max_parallel_maintenance_workers=2;
+create index parallel_index_t1_b_idx on parallel_index_t1(b, a);
+select count(*), sum(a) from parallel_index_t1 where b = 7;
+create unique index parallel_index_t1_a_uidx on parallel_index_t1(a);
+select a, b from parallel_index_t1 where a = 77777;
+drop index parallel_index_t1_a_uidx;
+insert into parallel_index_t1 values (100000, 0);
+create unique index parallel_index_t1_a_uidx on parallel_index_t1(a);
+reset max_parallel_maintenance_workers;
+
+drop table parallel_index_t1;
+reset enable_seqscan;
+reset enable_bitmapscan;
+reset parallel_setup_cost;
+reset parallel_tuple_cost;
+reset max_parallel_workers_per_gather;
+reset min_parallel_table_scan_size;
+reset min_parallel_index_scan_size;
+reset parallel_leader_participation;
@@ -32,6 +32,15 @@ select count(*) from parallel_t1 where a > 5000;
 select count(*) from parallel_t1 where a < 5000;
 select count(*) from parallel_t1 where a <> 5000;
 
+--parallel plan for partitioned table
+create table parallel_part_t1(a int, b int) partition by range(a) (partition p1 values less than(25001), partition p2 values less than(50001), partition p3 values less than(75001), partition p4 values less than(maxvalue));
+insert into parallel_part_t1 select generate_series(1,100000), generate_series(1,100000) % 10;
+explain (costs off) select count(*), sum(a) from parallel_part_t1;
+explain (costs off) select count(*), sum(b) from parallel_part_t1 where a > 60000;
+select count(*), sum(a) from parallel_part_t1;
+select count(*), sum(b) from parallel_part_t1 where a > 60000;
+drop table parallel_part_t1;
+
 --clean up
 drop table parallel_t1;
 reset force_parallel_mode;
@@ -0,0 +1,28 @@
+--
+-- Tests of plancache_fetch_status(), the lookup counters of the global plan cache
+--
+
+-- each bucket is listed once, and no counter goes below zero
+select count(*) = count(distinct bucket_id) as distinct_buckets from plancache_fetch_status();
+select count(*) from plancache_fetch_status()
+    where bucket_id < 0 or entries < 0 or fetch_hits < 0 or fetch_misses < 0 or contentions < 0;
+
+create table gpc_fetch_tbl (a int, b int);
+create table gpc_fetch_before as
+    select coalesce(sum(fetch_hits), 0) as hits, coalesce(sum(fetch_misses), 0) as misses
+    from plancache_fetch_status();
+
+-- the first commit misses and stores the plan, the second one finds it
+prepare gpc_fetch_p as select * from gpc_fetch_tbl where a = $1;
+deallocate gpc_fetch_p;
+prepare gpc_fetch_p as select * from gpc_fetch_tbl where a = $1;
+execute gpc_fetch_p(1);
+deallocate gpc_fetch_p;
+
+-- the counters are only kept while the global plan cache is on
+select coalesce(s.hits > b.hits, true) as hit, coalesce(s.misses > b.misses, true) as missed
+    from (select sum(fetch_hits) as hits, sum(fetch_misses) as misses from plancache_fetch_status()) s,
+         gpc_fetch_before b;
+
+drop table gpc_fetch_before;
+drop table gpc_fetch_tbl;
@@ -0,0 +1,22 @@
+-- Runtime bloom filters built by a hash join and probed in the outer scan.
+create table runtime_filter_fact (id int, val int);
+create table runtime_filter_dim (id int, name text);
+insert into runtime_filter_fact select n, n % 100 from generate_series(1,10000) n;
+insert into runtime_filter_fact values (null, 0);
+insert into runtime_filter_dim select n * 100, 'dim' || n from generate_series(1,5) n;
+insert into runtime_filter_dim values (null, 'null');
+analyze runtime_filter_fact;
+analyze runtime_filter_dim;
+set enable_scan_runtime_filter = on;
+select f.id, f.val, d.name from runtime_filter_fact f join runtime_filter_dim d on f.id = d.id order by f.id;
+select count(*) from runtime_filter_fact f where f.id in (select id from runtime_filter_dim);
+
+-- Column store scan: whole CUs outside the build keys' range are skipped.
+create table runtime_filter_fact_col (id int, val int) with (orientation = column);
+insert into runtime_filter_fact_col select * from runtime_filter_fact;
+select f.id, f.val, d.name from runtime_filter_fact_col f join runtime_filter_dim d on f.id = d.id order by f.id;
+select count(*) from runtime_filter_fact_col f where f.id in (select id from runtime_filter_dim);
+reset enable_scan_runtime_filter;
+drop table runtime_filter_fact_col;
+drop table runtime_filter_fact;
+drop table runtime_filter_dim;
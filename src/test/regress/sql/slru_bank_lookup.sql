@@ -0,0 +1,31 @@
+--
+-- Transaction status lookups over many CSNLOG pages.  Each subtransaction below
+-- takes its own xid, so the rows span about 20 CSNLOG pages, which are held by
+-- different partitions and banks of the status buffers.
+--
+create table slru_bank_test (id int);
+
+create or replace function slru_bank_fill(n int) returns void as $$
+begin
+    for i in 1..n loop
+        begin
+            insert into slru_bank_test values (i);
+            -- every third subtransaction is rolled back
+            if i % 3 = 0 then
+                raise exception 'rollback';
+            end if;
+        exception when raise_exception then
+            null;
+        end;
+    end loop;
+end;
+$$ language plpgsql;
+
+select slru_bank_fill(20000);
+
+-- the first scan looks up the status of every xid, the second reads the hint bits
+select count(*), sum(id) from slru_bank_test;
+select count(*) from slru_bank_test where id % 2 = 0;
+
+drop function slru_bank_fill(int);
+drop table slru_bank_test;
@@ -0,0 +1,31 @@
+--
+-- run plans over row tables in the vector engine
+--
+create schema vector_engine_strategy;
+set current_schema = vector_engine_strategy;
+create table row_table_01(a int, b int, c text);
+insert into row_table_01 select i, i * 2, 'row' || i from generate_series(1, 100) i;
+analyze row_table_01;
+-- off: row tables stay in the row engine
+set try_vector_engine_strategy = off;
+explain (costs off) select count(*), sum(b) from row_table_01 where a > 50;
+select count(*), sum(b) from row_table_01 where a > 50;
+-- optimal: too few rows to be worth it
+set try_vector_engine_strategy = optimal;
+explain (costs off) select count(*), sum(b) from row_table_01 where a > 50;
+-- force: the qual is evaluated over batches above the Vector Adapter
+set try_vector_engine_strategy = force;
+explain (costs off) select count(*), sum(b) from row_table_01 where a > 50;
+select count(*), sum(b) from row_table_01 where a > 50;
+select b % 3 as k, count(*), sum(a) from row_table_01 where a <= 10 group by 1 order by 1;
+select count(*) from row_table_01 where c like 'row1%' and a + b > 30;
+-- force: row marks and ctid junk columns stay in the row engine
+explain (costs off) update row_table_01 set b = b + 1 where a <= 10;
+explain (costs off) delete from row_table_01 where a > 90;
+explain (costs off) select a from row_table_01 where a <= 2 for update;
+update row_table_01 set b = b + 1 where a <= 10;
+delete from row_table_01 where a > 90;
+select count(*), sum(b) from row_table_01 where a <= 10;
+select count(*) from row_table_01;
+reset try_vector_engine_strategy;
+drop schema vector_engine_strategy cascade;